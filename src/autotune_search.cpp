@@ -0,0 +1,129 @@
+#include "autotune_search.h"
+
+AutotuneSearch::AutotuneSearch()
+    : runsPerSetting(1),
+      marginPercent(0),
+      phase(PHASE_IDLE),
+      candidate(0),
+      ceiling(0),
+      step(0),
+      runsLeft(0),
+      trials(0) {
+    best[0] = 0;
+    best[1] = 0;
+}
+
+void AutotuneSearch::begin(const Axis& speed, const Axis& accel, uint8_t runs, uint8_t margin) {
+    axes[0] = speed;
+    axes[1] = accel;
+    best[0] = 0;
+    best[1] = 0;
+    runsPerSetting = runs > 0 ? runs : 1;
+    marginPercent = margin < 100 ? margin : 99;
+    trials = 0;
+
+    phase = PHASE_SPEED;
+    startAxis(0);
+}
+
+void AutotuneSearch::startAxis(uint8_t axis) {
+    candidate = axes[axis].start;
+    ceiling = 0;
+    step = axes[axis].step;
+    runsLeft = runsPerSetting;
+}
+
+void AutotuneSearch::report(bool passed) {
+    if (phase != PHASE_SPEED && phase != PHASE_ACCEL) {
+        return;
+    }
+    trials++;
+
+    uint8_t axis = axisIndex();
+    const Axis& range = axes[axis];
+
+    if (passed) {
+        if (--runsLeft > 0) {
+            return;  // Same setting again
+        }
+        best[axis] = candidate;
+
+        if (ceiling == 0) {
+            // Still climbing
+            if (candidate >= range.limit) {
+                endAxis();
+                return;
+            }
+            candidate = candidate + step > range.limit ? range.limit : candidate + step;
+        } else if (!bisect(range)) {
+            return;
+        }
+    } else {
+        if (best[axis] == 0) {
+            phase = PHASE_FAILED;
+            return;
+        }
+
+        ceiling = candidate;
+        if (!bisect(range)) {
+            return;
+        }
+    }
+
+    runsLeft = runsPerSetting;
+}
+
+// Next candidate in the middle of the pass/fail gap; ends the axis (returns
+// false) once the gap is within minStep, so the best pass is at most
+// minStep below the stall edge
+bool AutotuneSearch::bisect(const Axis& range) {
+    float gap = ceiling - best[axisIndex()];
+    if (gap <= range.minStep) {
+        endAxis();
+        return false;
+    }
+    step = gap / 2;
+    candidate = best[axisIndex()] + step;
+    return true;
+}
+
+void AutotuneSearch::endAxis() {
+    if (phase == PHASE_SPEED) {
+        // The start acceleration already passed at a higher speed
+        phase = PHASE_ACCEL;
+        best[1] = axes[1].start;
+        startAxis(1);
+        if (axes[1].start >= axes[1].limit) {
+            phase = PHASE_DONE;
+            return;
+        }
+        candidate = axes[1].start + step > axes[1].limit ? axes[1].limit : axes[1].start + step;
+    } else {
+        phase = PHASE_DONE;
+    }
+}
+
+float AutotuneSearch::getTrialSpeed() const {
+    // Acceleration is tuned at the speed that will be used, not at the stall edge
+    return phase == PHASE_SPEED ? candidate : getResultSpeed();
+}
+
+float AutotuneSearch::getTrialAcceleration() const {
+    return phase == PHASE_ACCEL ? candidate : axes[1].start;
+}
+
+float AutotuneSearch::getSafeSpeed() const {
+    return best[0] > 0 ? best[0] : axes[0].start;
+}
+
+float AutotuneSearch::getSafeAcceleration() const {
+    return best[1] > 0 ? best[1] : axes[1].start;
+}
+
+float AutotuneSearch::getResultSpeed() const {
+    return best[0] * (100 - marginPercent) / 100.0f;
+}
+
+float AutotuneSearch::getResultAcceleration() const {
+    return best[1] * (100 - marginPercent) / 100.0f;
+}
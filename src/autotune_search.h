@@ -0,0 +1,118 @@
+#ifndef AUTOTUNE_SEARCH_H
+#define AUTOTUNE_SEARCH_H
+
+#include <stdint.h>
+
+/**
+ * Autotune Search
+ *
+ * Finds the fastest stepper speed and acceleration that still run without
+ * missed steps. The search only sees pass/fail trial results reported by
+ * the caller (MotorAutotune on the device), so it has no hardware
+ * dependencies and can be driven on the host with a stall model.
+ *
+ * Search per axis (speed first at the start acceleration, then
+ * acceleration at the tuned speed, i.e. with the margin applied):
+ * - Climb from the start value by step while trials pass
+ * - After the first failure, bisect between the last pass and the lowest
+ *   failure until they are at most minStep apart
+ * - A setting passes only if runsPerSetting trials in a row pass
+ *
+ * Result = best passing values minus the safety margin.
+ */
+class AutotuneSearch {
+public:
+    /**
+     * Search range of one axis
+     */
+    struct Axis {
+        float start;        // First value tried (must pass)
+        float limit;        // Highest value tried
+        float step;         // Climb increment
+        float minStep;      // Bisection resolution (final pass/fail gap)
+    };
+
+    /**
+     * Search progress
+     */
+    enum Phase : uint8_t {
+        PHASE_IDLE,
+        PHASE_SPEED,
+        PHASE_ACCEL,
+        PHASE_DONE,
+        PHASE_FAILED        // Start setting already missed steps
+    };
+
+    AutotuneSearch();
+
+    /**
+     * Start a new search
+     *
+     * @param speed: Speed axis in steps/second
+     * @param accel: Acceleration axis in steps/second²
+     * @param runsPerSetting: Consecutive passes required per setting
+     * @param marginPercent: Safety margin taken off the best passing values
+     */
+    void begin(const Axis& speed, const Axis& accel, uint8_t runsPerSetting, uint8_t marginPercent);
+
+    /**
+     * Record the result of the trial at getTrialSpeed()/getTrialAcceleration()
+     *
+     * @param passed: true if the trial ran without missed steps
+     */
+    void report(bool passed);
+
+    /**
+     * @return: Current phase
+     */
+    Phase getPhase() const { return phase; }
+
+    /**
+     * @return: true once the search ended (PHASE_DONE or PHASE_FAILED)
+     */
+    bool isFinished() const { return phase == PHASE_DONE || phase == PHASE_FAILED; }
+
+    /**
+     * @return: Setting for the next trial
+     */
+    float getTrialSpeed() const;
+    float getTrialAcceleration() const;
+
+    /**
+     * @return: Best setting that passed so far (start values before any pass),
+     *          for moves between trials
+     */
+    float getSafeSpeed() const;
+    float getSafeAcceleration() const;
+
+    /**
+     * @return: Tuned setting with the safety margin (valid in PHASE_DONE)
+     */
+    float getResultSpeed() const;
+    float getResultAcceleration() const;
+
+    /**
+     * @return: Trials reported since begin()
+     */
+    uint16_t getTrialCount() const { return trials; }
+
+private:
+    Axis axes[2];               // Speed, acceleration
+    float best[2];              // Best passing value per axis (0 = none yet)
+    uint8_t runsPerSetting;
+    uint8_t marginPercent;
+
+    Phase phase;
+    float candidate;            // Value of the current axis under test
+    float ceiling;              // Lowest failing value (0 = none yet)
+    float step;
+    uint8_t runsLeft;           // Passes still needed at the candidate
+    uint16_t trials;
+
+    uint8_t axisIndex() const { return phase == PHASE_SPEED ? 0 : 1; }
+    void startAxis(uint8_t axis);
+    bool bisect(const Axis& range);
+    void endAxis();
+};
+
+#endif // AUTOTUNE_SEARCH_H
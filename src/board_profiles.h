@@ -0,0 +1,104 @@
+#ifndef BOARD_PROFILES_H
+#define BOARD_PROFILES_H
+
+#include <Arduino.h>
+
+/**
+ * Board Pin Profiles
+ *
+ * GPIO assignments for each supported board, selected at build time with a
+ * build flag in platformio.ini (e.g. -D FEEDER_BOARD_DEVKITC_38PIN).
+ * Without a flag the ESP32 DevKit V1 30-pin profile is used.
+ *
+ * All pins are constexpr so drivers can use them as template arguments
+ * (StepperDriver<...>) and config.h can validate them with static_assert.
+ */
+
+#if defined(FEEDER_BOARD_DEVKITC_38PIN)
+
+// ============================================================================
+// ESP32 DevKitC 38-PIN
+// ============================================================================
+
+#define FEEDER_BOARD_NAME "ESP32 DevKitC 38-pin"
+
+// ULN2003 stepper driver inputs (IN1-IN4) on the contiguous GPIO 16-19 header block
+constexpr uint8_t STEPPER_IN1_PIN = 16;
+constexpr uint8_t STEPPER_IN2_PIN = 17;
+constexpr uint8_t STEPPER_IN3_PIN = 18;
+constexpr uint8_t STEPPER_IN4_PIN = 19;
+
+// Vibration motor PWM output (NPN base via 1kΩ)
+constexpr uint8_t VIBRATION_MOTOR_PIN = 26;
+
+// RGB LED channels (LEDC PWM capable)
+constexpr uint8_t RGB_LED_RED_PIN = 25;
+constexpr uint8_t RGB_LED_GREEN_PIN = 27;
+constexpr uint8_t RGB_LED_BLUE_PIN = 32;
+
+// TTP223 touch sensor output (input-only pin)
+constexpr uint8_t TOUCH_SENSOR_PIN = 34;
+
+// Auger index sensor (optical slot / hall switch, internal pull-up)
+constexpr uint8_t INDEX_SENSOR_PIN = 13;
+
+// DS3231 RTC I2C bus (Wire default pins)
+constexpr uint8_t RTC_SDA_PIN = 21;
+constexpr uint8_t RTC_SCL_PIN = 22;
+
+#else
+
+// ============================================================================
+// ESP32 DevKit V1 30-PIN CH9102X (DEFAULT)
+// ============================================================================
+
+#define FEEDER_BOARD_NAME "ESP32 DevKit V1 30-pin"
+
+// ULN2003 stepper driver inputs (IN1-IN4), chosen to avoid the RTC I2C pins
+constexpr uint8_t STEPPER_IN1_PIN = 15;
+constexpr uint8_t STEPPER_IN2_PIN = 4;
+constexpr uint8_t STEPPER_IN3_PIN = 5;
+constexpr uint8_t STEPPER_IN4_PIN = 18;
+
+// Vibration motor pin assignment: GPIO 26 (supports PWM/LEDC)
+// ESP32-WROOM-32 GPIO 26 SPECIFICATIONS:
+//   • Supports LEDC PWM output (LED Control peripheral)
+//   • Output-only pin, no input restrictions
+//   • Not connected to internal flash, safe for any use
+//   • Available on most ESP32 development boards
+//   • 3.3V logic level output (drives NPN transistor base through 1kΩ resistor)
+constexpr uint8_t VIBRATION_MOTOR_PIN = 26;
+
+// RGB LED pin assignments (ESP32-WROOM-32 GPIO pins with PWM support)
+// GPIO 25, 27, 32 chosen for their PWM/LEDC capabilities and availability
+// ESP32-WROOM-32 RGB LED PIN SPECIFICATIONS:
+//   • GPIO 25: Output-only, supports LEDC PWM, safe for any use
+//   • GPIO 27: Output-only, supports LEDC PWM, safe for any use
+//   • GPIO 32: ADC1_CH4, supports LEDC PWM, output capable
+//   • All pins use 3.3V logic level
+//   • Each channel requires 330Ω current-limiting resistor
+constexpr uint8_t RGB_LED_RED_PIN = 25;
+constexpr uint8_t RGB_LED_GREEN_PIN = 27;
+constexpr uint8_t RGB_LED_BLUE_PIN = 32;
+
+// Touch sensor pin assignment: GPIO 33 (input-only pin, suitable for sensors)
+// ESP32-WROOM-32 GPIO 33 SPECIFICATIONS:
+//   • Input-only pin (no output capability)
+//   • Internal pull-up/pull-down available
+//   • ADC1_CH5, RTC_GPIO8, TOUCH8
+//   • Ideal for sensor inputs and touch detection
+//   • Not connected to internal flash, safe for any use
+constexpr uint8_t TOUCH_SENSOR_PIN = 33;
+
+// Auger index sensor pin assignment: GPIO 13 (optical slot / hall switch)
+//   • Input with internal pull-up (open-collector sensor outputs)
+//   • Not a strapping pin, safe to be pulled LOW at boot
+constexpr uint8_t INDEX_SENSOR_PIN = 13;
+
+// DS3231 RTC I2C bus (Wire default pins)
+constexpr uint8_t RTC_SDA_PIN = 21;
+constexpr uint8_t RTC_SCL_PIN = 22;
+
+#endif
+
+#endif // BOARD_PROFILES_H
@@ -0,0 +1,79 @@
+#include "chunked_response.h"
+
+/**
+ * Constructor
+ */
+ChunkedResponse::ChunkedResponse(WebServer& server, char* buffer, size_t capacity)
+    : server(server),
+      buffer(buffer),
+      capacity(buffer ? capacity : 0),
+      length(0),
+      bytesWritten(0) {
+}
+
+void ChunkedResponse::begin(int code, const char* contentType) {
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(code, contentType, "");
+}
+
+void ChunkedResponse::end() {
+    flush();
+    // Zero-length chunk terminates the chunked body
+    server.sendContent("", 0);
+}
+
+// ============================================================================
+// PRINT INTERFACE
+// ============================================================================
+
+size_t ChunkedResponse::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t ChunkedResponse::write(const uint8_t* data, size_t size) {
+    size_t remaining = size;
+
+    // No buffer: send straight through (one chunk per write)
+    if (capacity == 0) {
+        if (size > 0) {
+            server.sendContent((const char*)data, size);
+            bytesWritten += size;
+        }
+        return size;
+    }
+
+    while (remaining > 0) {
+        size_t count = capacity - length;
+        if (count > remaining) {
+            count = remaining;
+        }
+        memcpy(buffer + length, data, count);
+        length += count;
+        data += count;
+        remaining -= count;
+        if (length == capacity) {
+            flush();
+        }
+    }
+    bytesWritten += size;
+    return size;
+}
+
+ChunkedResponse& ChunkedResponse::operator+=(const char* text) {
+    if (text) {
+        write((const uint8_t*)text, strlen(text));
+    }
+    return *this;
+}
+
+ChunkedResponse& ChunkedResponse::operator+=(const String& text) {
+    write((const uint8_t*)text.c_str(), text.length());
+    return *this;
+}
+
+void ChunkedResponse::flush() {
+    if (length > 0) {
+        server.sendContent(buffer, length);
+        length = 0;
+    }
+}
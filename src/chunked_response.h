@@ -0,0 +1,70 @@
+#ifndef CHUNKED_RESPONSE_H
+#define CHUNKED_RESPONSE_H
+
+#include <Arduino.h>
+#include <WiFiManager.h> // WebServer (via tzapu WiFiManager)
+
+/**
+ * ChunkedResponse Class
+ *
+ * Streams a large response (the schedule management page) with HTTP
+ * chunked transfer encoding through a small fixed buffer, instead of
+ * growing one String to the full page size.
+ *
+ * Usage:
+ *   ChunkedResponse html(server, buffer, size);
+ *   html.begin(200, "text/html; charset=utf-8");
+ *   html += "<html>...";
+ *   html.end();
+ *
+ * Print-compatible, so numbers can be written with html.print(value).
+ */
+class ChunkedResponse : public Print {
+public:
+    /**
+     * Constructor
+     *
+     * @param server: Web server handling the current request
+     * @param buffer: Chunk buffer (request arena or stack)
+     * @param capacity: Chunk buffer size in bytes
+     */
+    ChunkedResponse(WebServer& server, char* buffer, size_t capacity);
+
+    /**
+     * Send the status line and headers (length unknown, chunked body)
+     *
+     * @param code: HTTP status code
+     * @param contentType: MIME type
+     */
+    void begin(int code, const char* contentType);
+
+    /**
+     * Flush the last chunk and terminate the body
+     */
+    void end();
+
+    // Print interface
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t size) override;
+    using Print::write;
+
+    // String-style appends (keeps page templates readable)
+    ChunkedResponse& operator+=(const char* text);
+    ChunkedResponse& operator+=(const String& text);
+
+    /**
+     * @return: Body bytes written so far
+     */
+    size_t getBytesWritten() const { return bytesWritten; }
+
+private:
+    WebServer& server;
+    char* buffer;
+    size_t capacity;
+    size_t length;
+    size_t bytesWritten;
+
+    void flush();
+};
+
+#endif // CHUNKED_RESPONSE_H
@@ -1,4 +1,5 @@
 #include "command_listener.h"
+#include "string_builder.h"
 #include "module_manager.h"
 #include "rtc_module.h"
 #include "stepper_motor.h"
@@ -8,7 +9,18 @@
 #include "ntp_sync.h"
 #include "vibration_motor.h"
 #include "rgb_led.h"
+#include "led_status_compositor.h"
 #include "touch_sensor.h"
+#include "runtime_config.h"
+#include "motor_autotune.h"
+#include "cpu_governor.h"
+#include "sampling_profiler.h"
+#include "trace_buffer.h"
+#include "feed_latency.h"
+#include "input_recorder.h"
+#include "metrics_registry.h"
+#include "series_store.h"
+#include "loop_watchdog.h"
 #include "console_manager.h"
 
 // Forward declarations for task control functions (implemented in main.cpp)
@@ -20,7 +32,7 @@ extern void showTaskStatus();
 extern void enableFeedingMonitor();
 
 // Forward declarations for centralized feeding operations (implemented in main.cpp)
-extern bool startFeeding(uint8_t portions, bool recordInSchedule);
+extern bool startFeeding(uint8_t portions, bool recordInSchedule, const FeedLatencyTracker::Trigger& trigger);
 extern bool cancelFeeding();
 
 /**
@@ -34,14 +46,30 @@ CommandListener::CommandListener(ModuleManager* moduleManager)
  * Main command processing entry point
  */
 bool CommandListener::processCommand(const String& command) {
-    String cmd = command;
-    cmd.trim();
-    cmd.toUpperCase();
+    return processCommand(command.c_str());
+}
+
+/**
+ * Main command processing entry point (C string)
+ * Normalizes in a fixed buffer; the handler chain receives a single String
+ */
+bool CommandListener::processCommand(const char* command) {
+    FixedString<SERIAL_COMMAND_MAX_LENGTH> line(command);
+    if (line.overflowed()) {
+        Console::printlnR(F("Command too long."));
+        return false;
+    }
+    line.trim();
+    line.toUpperCase();
+    String cmd(line.c_str());
     
     // Process commands in order of priority/specificity
     if (processSystemCommands(cmd)) {
         return true;
     }
+    if (processConfigCommands(cmd)) {
+        return true;
+    }
     if (processTaskCommands(cmd)) {
         return true;
     }
@@ -96,6 +124,98 @@ bool CommandListener::processSystemCommands(const String& command) {
     return false;
 }
 
+/**
+ * Process runtime configuration commands (CONFIG GET/SET/RESET)
+ * Plain CONFIG (feeding configuration) is handled by processMotorCommands
+ */
+bool CommandListener::processConfigCommands(const String& command) {
+    if (!command.startsWith("CONFIG ")) {
+        return false;
+    }
+    
+    if (!modules || !modules->hasRuntimeConfig()) {
+        Console::printlnR(F("ERROR: Runtime configuration not available"));
+        return true;
+    }
+    
+    RuntimeConfig* config = modules->getRuntimeConfig();
+    String subCommand = command.substring(7); // Remove "CONFIG "
+    subCommand.trim();
+    
+    // CONFIG GET - List every setting
+    if (subCommand == "GET" || subCommand == "LIST") {
+        config->printAll();
+        return true;
+    }
+    
+    // CONFIG GET <name>
+    if (subCommand.startsWith("GET ")) {
+        String name = subCommand.substring(4);
+        name.trim();
+        RuntimeConfig::Id id;
+        if (!config->findByName(name, id)) {
+            Console::printlnR("ERROR: Unknown setting '" + name + "' (use CONFIG GET to list)");
+            return true;
+        }
+        Console::printlnR(String(RuntimeConfig::getEntry(id).name) + " = " + config->formatValue(id));
+        return true;
+    }
+    
+    // CONFIG SET <name> <value>
+    if (subCommand.startsWith("SET ")) {
+        String args = subCommand.substring(4);
+        args.trim();
+        int spaceIndex = args.indexOf(' ');
+        if (spaceIndex <= 0) {
+            Console::printlnR(F("Usage: CONFIG SET <name> <value>"));
+            return true;
+        }
+        
+        String name = args.substring(0, spaceIndex);
+        String value = args.substring(spaceIndex + 1);
+        RuntimeConfig::Id id;
+        if (!config->findByName(name, id)) {
+            Console::printlnR("ERROR: Unknown setting '" + name + "' (use CONFIG GET to list)");
+            return true;
+        }
+        
+        const RuntimeConfig::Entry& entry = RuntimeConfig::getEntry(id);
+        if (!config->setFromString(id, value)) {
+            if (entry.type == RuntimeConfig::TYPE_BOOL) {
+                Console::printlnR(F("ERROR: Value must be TRUE/FALSE, ON/OFF or 1/0"));
+            } else {
+                Console::printlnR("ERROR: Value must be " + String(entry.minValue) + "-" + String(entry.maxValue));
+            }
+            return true;
+        }
+        
+        Console::printlnR(String(entry.name) + " = " + config->formatValue(id) +
+                          (entry.persistent ? " (saved)" : " (session only)"));
+        return true;
+    }
+    
+    // CONFIG RESET <name>
+    if (subCommand.startsWith("RESET ")) {
+        String name = subCommand.substring(6);
+        name.trim();
+        RuntimeConfig::Id id;
+        if (!config->findByName(name, id)) {
+            Console::printlnR("ERROR: Unknown setting '" + name + "' (use CONFIG GET to list)");
+            return true;
+        }
+        config->resetToDefault(id);
+        Console::printlnR(String(RuntimeConfig::getEntry(id).name) + " = " + config->formatValue(id) + " (default)");
+        return true;
+    }
+    
+    Console::printlnR(F("Unknown CONFIG command. Available:"));
+    Console::printlnR(F("  CONFIG GET              - List runtime settings"));
+    Console::printlnR(F("  CONFIG GET <name>       - Show one setting"));
+    Console::printlnR(F("  CONFIG SET <name> <v>   - Change a setting"));
+    Console::printlnR(F("  CONFIG RESET <name>     - Restore default value"));
+    return true;
+}
+
 /**
  * Process task control commands
  */
@@ -124,6 +244,114 @@ bool CommandListener::processTaskCommands(const String& command) {
         Console::println(F("Motor maintenance task resumed"));
         return true;
     }
+    else if (command == "CPU" || command == "CPU STATUS") {
+        modules->getCpuGovernor()->printStatus(Serial);
+        return true;
+    }
+    else if (command == "CPU SCALING ON" || command == "CPU SCALING OFF") {
+        bool enabled = command.endsWith("ON");
+        modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_CPU_SCALING, enabled);
+        Console::printR(F("CPU frequency scaling "));
+        Console::printlnR(enabled ? F("ENABLED") : F("DISABLED"));
+        return true;
+    }
+    else if (command.startsWith("PROFILE SAMPLE")) {
+        SamplingProfiler* profiler = modules->getSamplingProfiler();
+        String action = command.substring(14);
+        action.trim();
+        
+        if (action.startsWith("START")) {
+            long hz = action.length() > 5 ? action.substring(6).toInt() : PROFILER_DEFAULT_HZ;
+            if (hz <= 0 || hz > PROFILER_MAX_HZ) {
+                Console::printR(F("Usage: PROFILE SAMPLE START [1-"));
+                Console::printR(String(PROFILER_MAX_HZ));
+                Console::printlnR(F(" Hz]"));
+            } else if (profiler->start((uint16_t)hz)) {
+                Console::printR(F("Sampling started at "));
+                Console::printR(String(hz));
+                Console::printlnR(F(" Hz - PROFILE SAMPLE STOP, then DUMP or GET /api/profile"));
+            } else {
+                Console::printlnR(F("✗ Profiler already running or out of memory"));
+            }
+        } else if (action == "STOP") {
+            profiler->stop();
+            profiler->printStatus(Serial);
+        } else if (action == "DUMP") {
+            // Dumping reads the ring, so sampling has to end first
+            profiler->stop();
+            profiler->printDumpBase64(Serial);
+            Console::printlnR(F("Symbolize with tools/profile_symbolize.py <log> --elf firmware.elf"));
+        } else {
+            profiler->printStatus(Serial);
+            Console::printlnR(F("Usage: PROFILE SAMPLE [START [hz]|STOP|DUMP]"));
+        }
+        return true;
+    }
+    else if (command == "TRACE" || command == "TRACE STATUS") {
+        TraceBuffer::printStatus(Serial);
+        return true;
+    }
+    else if (command == "TRACE ON" || command == "TRACE OFF") {
+        bool enabled = command.endsWith("ON");
+        TraceBuffer::setEnabled(enabled);
+        Console::printR(F("Trace recording "));
+        Console::printlnR(enabled ? F("ON - GET /api/trace for the timeline") : F("OFF"));
+        return true;
+    }
+    else if (command == "TRACE CLEAR") {
+        TraceBuffer::clear();
+        Console::printlnR(F("Trace cleared"));
+        return true;
+    }
+    else if (command == "INPUT" || command == "INPUT STATUS") {
+        InputRecorder::printStatus(Serial);
+        return true;
+    }
+    else if (command == "INPUT ON" || command == "INPUT OFF") {
+        bool enabled = command.endsWith("ON");
+        modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_INPUT_RECORD, enabled);
+        Console::printR(F("Input recording "));
+        Console::printlnR(enabled ? F("ON - GET /api/inputs, replay with tools/input_replay.py") : F("OFF"));
+        return true;
+    }
+    else if (command == "INPUT FLUSH") {
+        InputRecorder::flush();
+        Console::printlnR(F("Recorded inputs written to flash"));
+        return true;
+    }
+    else if (command == "INPUT CLEAR") {
+        Console::printlnR(F("Erasing input recording..."));
+        InputRecorder::clear();
+        Console::printlnR(F("Input recording cleared"));
+        return true;
+    }
+    else if (command == "METRICS") {
+        MetricsRegistry::writePrometheus(Serial);
+        return true;
+    }
+    else if (command == "SERIES" || command == "SERIES STATUS") {
+        modules->getSeriesStore()->printStatus(Serial);
+        return true;
+    }
+    else if (command == "SERIES SAVE") {
+        bool saved = modules->getSeriesStore()->checkpoint();
+        Console::printlnR(saved ? F("History written to flash") : F("History not saved (no store or flash area)"));
+        return true;
+    }
+    else if (command == "SERIES CLEAR") {
+        modules->getSeriesStore()->clear();
+        Console::printlnR(F("History cleared"));
+        return true;
+    }
+    else if (command == "STALLS" || command == "STALLS STATUS") {
+        LoopWatchdog::printStatus(Serial);
+        return true;
+    }
+    else if (command == "STALLS RESET") {
+        LoopWatchdog::reset();
+        Console::printlnR(F("Loop stall statistics reset"));
+        return true;
+    }
     return false;
 }
 
@@ -131,7 +359,41 @@ bool CommandListener::processTaskCommands(const String& command) {
  * Process motor and feeding commands
  */
 bool CommandListener::processMotorCommands(const String& command) {
-    if (command.startsWith("FEED")) {
+    // FEED LATENCY [RESET] - Trigger -> first step / complete histograms
+    if (command == "FEED LATENCY" || command == "FEED LATENCY RESET") {
+        FeedLatencyTracker* latency = modules->getFeedLatencyTracker();
+        if (command.endsWith("RESET")) {
+            latency->reset();
+            Console::printlnR(F("Feed latency histograms cleared"));
+        } else {
+            latency->printStatus(Serial);
+        }
+        return true;
+    }
+    
+    // FEED PROFILE [name] - Select the dispense profile (no name lists them)
+    if (command.startsWith("FEED PROFILE")) {
+        String name = command.substring(12);
+        name.trim();
+        
+        FeedingController* feeder = modules->getFeedingController();
+        int profile = FeedingController::findDispenseProfile(name);
+        if (profile < 0) {
+            if (name.length() > 0) {
+                Console::printR(F("ERROR: Unknown dispense profile: "));
+                Console::printlnR(name);
+            }
+            feeder->printDispenseProfiles();
+            Console::printlnR(F("Usage: FEED PROFILE [name]"));
+            return true;
+        }
+        
+        modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_DISPENSE_PROFILE, profile);
+        Console::printR(F("Dispense profile set to "));
+        Console::printlnR(DISPENSE_PROFILES[profile].name);
+        return true;
+    }
+    else if (command == "FEED" || command.startsWith("FEED ")) {
         // Parse number of portions (default 1)
         int portions = 1;
         int spaceIndex = command.indexOf(' ');
@@ -142,13 +404,24 @@ bool CommandListener::processMotorCommands(const String& command) {
         }
         
         // Use centralized feeding method
-        startFeeding(portions, true);
+        startFeeding(portions, true, FeedLatencyTracker::Trigger::now(FeedLatencyTracker::SOURCE_SERIAL));
         return true;
     }
     else if (command == "CALIBRATE") {
         modules->getFeedingController()->calibrateFeeder();
         return true;
     }
+    else if (command == "HOME") {
+        StepperMotor* motor = modules->getStepperMotor();
+        if (!motor->hasIndexSensor()) {
+            Console::printlnR(F("No index sensor fitted (INDEX_SENSOR_ENABLED in config.h)"));
+            return true;
+        }
+        if (motor->startHoming()) {
+            Console::printlnR(F("Homing started - check progress with MOTOR STATUS"));
+        }
+        return true;
+    }
     else if (command == "MOTOR STATUS") {
         modules->getStepperMotor()->printStatus();
         return true;
@@ -195,6 +468,40 @@ bool CommandListener::processMotorCommands(const String& command) {
         modules->getStepperMotor()->enablePowerSavingMode();
         return true;
     }
+    else if (command.startsWith("MOTOR BENCH")) {
+        uint32_t iterations = 1000;
+        int spaceIndex = command.lastIndexOf(' ');
+        if (spaceIndex > 0 && spaceIndex > command.indexOf("BENCH")) {
+            long value = command.substring(spaceIndex + 1).toInt();
+            if (value > 0) iterations = (uint32_t)value;
+        }
+        modules->getStepperMotor()->benchmarkStepUpdate(iterations);
+        return true;
+    }
+    else if (command.startsWith("MOTOR AUTOTUNE")) {
+        MotorAutotune* autotune = modules->getMotorAutotune();
+        String action = command.substring(14);
+        action.trim();
+        
+        if (action == "START") {
+            if (modules->getFeedingInProgress()) {
+                Console::printlnR(F("✗ Cannot autotune while feeding"));
+            } else {
+                autotune->start();
+            }
+        } else if (action == "STOP") {
+            if (autotune->isRunning()) {
+                autotune->cancel();
+            } else {
+                Console::printlnR(F("ℹ Autotune not running"));
+            }
+        } else {
+            autotune->printStatus(Serial);
+            Console::printlnR(F("WARNING: The auger turns at increasing speed and dispenses food"));
+            Console::printlnR(F("Usage: MOTOR AUTOTUNE [START|STOP]"));
+        }
+        return true;
+    }
     else if (command.startsWith("DIRECTION")) {
         int spaceIndex = command.indexOf(' ');
         if (spaceIndex > 0) {
@@ -202,12 +509,12 @@ bool CommandListener::processMotorCommands(const String& command) {
             directionStr.toUpperCase();
             
             if (directionStr == "CW" || directionStr == "CLOCKWISE") {
-                modules->getStepperMotor()->setMotorDirection(true);
+                modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_MOTOR_CLOCKWISE, true);
                 Console::printlnR(F("Motor direction set to CLOCKWISE (CW)"));
                 return true;
             }
             else if (directionStr == "CCW" || directionStr == "COUNTERCLOCKWISE" || directionStr == "COUNTER-CLOCKWISE") {
-                modules->getStepperMotor()->setMotorDirection(false);
+                modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_MOTOR_CLOCKWISE, false);
                 Console::printlnR(F("Motor direction set to COUNTER-CLOCKWISE (CCW)"));
                 return true;
             }
@@ -249,6 +556,9 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  HELP                    - Show this help message"));
     Console::printlnR(F("  INFO                    - Show system information"));
     Console::printlnR(F("  LOG                     - Toggle logging output"));
+    Console::printlnR(F("  CONFIG GET [name]       - Show runtime settings"));
+    Console::printlnR(F("  CONFIG SET <name> <v>   - Change a runtime setting"));
+    Console::printlnR(F("  CONFIG RESET <name>     - Restore setting default"));
     Console::printlnR(F(""));
     
     Console::printlnR(F("TASK CONTROL:"));
@@ -257,6 +567,14 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  RESUME DISPLAY          - Resume time display"));
     Console::printlnR(F("  PAUSE MOTOR             - Pause motor maintenance"));
     Console::printlnR(F("  RESUME MOTOR            - Resume motor maintenance"));
+    Console::printlnR(F("  CPU STATUS              - CPU frequency, time per frequency, energy saved"));
+    Console::printlnR(F("  CPU SCALING [ON|OFF]    - Idle at low clock, boost for web requests"));
+    Console::printlnR(F("  PROFILE SAMPLE [START [hz]|STOP|DUMP] - PC sampling profiler (flame graphs)"));
+    Console::printlnR(F("  TRACE [ON|OFF|CLEAR]    - Timeline trace status/control (GET /api/trace)"));
+    Console::printlnR(F("  INPUT [ON|OFF|FLUSH|CLEAR] - Input recording for replay (GET /api/inputs)"));
+    Console::printlnR(F("  METRICS                 - All metrics in Prometheus format (GET /metrics)"));
+    Console::printlnR(F("  SERIES [SAVE|CLEAR]     - Minute/hour/day history (GET /api/series)"));
+    Console::printlnR(F("  STALLS [RESET]          - Loop stalls by task and blocking call (GET /api/stalls)"));
     Console::printlnR(F(""));
     
     Console::printlnR(F("MOTOR & FEEDING:"));
@@ -265,7 +583,10 @@ void CommandListener::showHelp() {
     Console::printR(F("-"));
     Console::printR(String(MAX_FOOD_PORTIONS));
     Console::printlnR(F(" portions)"));
+    Console::printlnR(F("  FEED PROFILE [name]     - Set/list dispense profile (anti-clog strokes)"));
+    Console::printlnR(F("  FEED LATENCY [RESET]    - Trigger to first step/complete latency per source"));
     Console::printlnR(F("  CALIBRATE               - Full feeder calibration"));
+    Console::printlnR(F("  HOME                    - Home auger against the index sensor"));
     Console::printlnR(F("  MOTOR STATUS            - Show motor information"));
     Console::printlnR(F("  FEEDING STATUS          - Show feeding system status"));
     Console::printlnR(F("  CONFIG                  - Show feeding configuration"));
@@ -274,6 +595,8 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  DIRECTION [CW|CCW]      - Set/show motor rotation direction"));
     Console::printlnR(F("  MOTOR HIGH PERFORMANCE  - Enable max speed/torque mode"));
     Console::printlnR(F("  MOTOR POWER SAVING      - Enable power-efficient mode"));    
+    Console::printlnR(F("  MOTOR BENCH [n]         - Time coil update cost (CPU cycles)"));
+    Console::printlnR(F("  MOTOR AUTOTUNE [START|STOP] - Find max reliable speed/accel (needs index sensor)"));
     Console::printlnR(F(""));
     
     Console::printlnR(F("RTC COMMANDS:"));
@@ -305,6 +628,7 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  NTP SYNC                - Force immediate NTP synchronization"));
     Console::printlnR(F("  NTP FALLBACK            - Force HTTP time fallback test"));
     Console::printlnR(F("  NTP INTERVAL [minutes]  - Set sync interval in minutes"));
+    Console::printlnR(F("  NTP TZ [posix]          - Show or set time zone (POSIX TZ string)"));
     Console::printlnR(F(""));
     
     Console::printlnR(F("FEEDING SCHEDULE:"));
@@ -327,6 +651,7 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  VIB STOP                - Stop vibration"));
     Console::printlnR(F("  VIB TIMED <int> <ms>    - Timed vibration (intensity, duration)"));
     Console::printlnR(F("  VIB SET <intensity>     - Change intensity (0-100%)"));
+    Console::printlnR(F("  VIB PATTERN [name]      - Play haptic pattern (ack, long-press, error, feed-done)"));
     Console::printlnR(F("  VIB TEST                - Quick test pulse"));
     Console::printlnR(F(""));
     
@@ -343,7 +668,8 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  RGB FADE <color> <ms>   - Fade to color name"));
     Console::printlnR(F("  RGB FADE <r> <g> <b> <ms> - Fade to RGB color"));
     Console::printlnR(F("  RGB BLINK <int> [cnt]   - Blink LED (interval, count)"));
-    Console::printlnR(F("  RGB STOPBLINK           - Stop blinking"));
+    Console::printlnR(F("  RGB BREATHE <ms> [cnt]  - Breathe LED (period, count)"));
+    Console::printlnR(F("  RGB STOPBLINK           - Stop blinking/breathing"));
     Console::printlnR(F("  RGB TEST                - Run test sequence"));
     Console::printlnR(F(""));
     
@@ -354,6 +680,7 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  TOUCH LONGPRESS <ms>    - Set long press duration"));
     Console::printlnR(F("  TOUCH LONGPRESS ENABLE  - Enable long press"));
     Console::printlnR(F("  TOUCH LONGPRESS DISABLE - Disable long press"));
+    Console::printlnR(F("  TOUCH INJECT PRESS|RELEASE|OFF - Drive the input from serial (replay)"));
     Console::printlnR(F("  TOUCH TEST              - Test touch detection"));
     Console::printlnR(F(""));
     
@@ -366,6 +693,7 @@ void CommandListener::showHelp() {
     Console::printlnR(F("  WIFI PORTAL MyFeeder    - Start config portal as MyFeeder"));
     Console::printlnR(F("  NTP SYNC                - Sync time with internet"));
     Console::printlnR(F("  NTP INTERVAL 60         - Set sync every 60 minutes"));
+    Console::printlnR(F("  NTP TZ CET-1CEST,M3.5.0,M10.5.0/3 - Central European time"));
     Console::printlnR(F("  SCHEDULE STATUS         - Show schedule status"));
     Console::printlnR(F("  SCHEDULE DISABLE 1      - Disable schedule 1"));
     Console::printlnR(F("  SCHEDULE TOLERANCE 45   - Allow 45 minutes tolerance"));
@@ -409,6 +737,14 @@ void CommandListener::showSystemInfo() {
     Console::printlnR(modules->getWiFiController()->isWiFiConnected() ? F("Connected") : F("Disconnected"));
     Console::printR(F("Config Portal: "));
     Console::printlnR(modules->getWiFiController()->isConfigPortalActive() ? F("Active") : F("Inactive"));
+    
+    FixedString<80> line;
+    line.appendFormat("Heap: %lu free, %lu largest block, %lu minimum",
+                      (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxAllocHeap(),
+                      (unsigned long)ESP.getMinFreeHeap());
+    Console::printlnR(line.c_str());
+    modules->getWiFiController()->getRequestArena().printStats();
+    modules->getWiFiController()->getRateLimiter().printStats();
     Console::printlnR(F("=============================="));
 }
 
@@ -532,9 +868,7 @@ bool CommandListener::processScheduleCommands(const String& command) {
     if (subCommand.startsWith("TOLERANCE ")) {
         String toleranceStr = subCommand.substring(10);
         int tolerance = toleranceStr.toInt();
-        if (tolerance > 0 && tolerance <= 120) { // Max 2 hours
-            modules->getFeedingSchedule()->setTolerance(tolerance);
-        } else {
+        if (tolerance <= 0 || !modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_SCHEDULE_TOLERANCE, tolerance)) { // Max 2 hours
             Console::printlnR(F("ERROR: Tolerance must be 1-120 minutes"));
         }
         return true;
@@ -543,9 +877,7 @@ bool CommandListener::processScheduleCommands(const String& command) {
     if (subCommand.startsWith("RECOVERY ")) {
         String recoveryStr = subCommand.substring(9);
         int recovery = recoveryStr.toInt();
-        if (recovery > 0 && recovery <= 72) { // Max 72 hours
-            modules->getFeedingSchedule()->setMaxRecoveryHours(recovery);
-        } else {
+        if (recovery <= 0 || !modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_SCHEDULE_RECOVERY, recovery)) { // Max 72 hours
             Console::printlnR(F("ERROR: Recovery must be 1-72 hours"));
         }
         return true;
@@ -593,7 +925,7 @@ bool CommandListener::processVibrationCommands(const String& command) {
     
     // VIB STATUS - Show vibration motor status
     if (command == "VIB STATUS") {
-        Console::printlnR(modules->getVibrationMotor()->getStatus());
+        modules->getVibrationMotor()->printStatus(Serial);
         return true;
     }
     
@@ -652,8 +984,8 @@ bool CommandListener::processVibrationCommands(const String& command) {
             return true;
         }
         
-        if (duration == 0) {
-            Console::printlnR(F("ERROR: Duration must be > 0 milliseconds"));
+        if (duration == 0 || duration > 65535) {
+            Console::printlnR(F("ERROR: Duration must be 1-65535 milliseconds"));
             return true;
         }
         
@@ -689,6 +1021,28 @@ bool CommandListener::processVibrationCommands(const String& command) {
         return true;
     }
     
+    // VIB PATTERN [name] - Play a library haptic pattern (no name lists them)
+    if (command.startsWith("VIB PATTERN")) {
+        String name = command.substring(11);
+        name.trim();
+        
+        const VibrationMotor::HapticPattern* pattern = VibrationMotor::findPattern(name);
+        if (!pattern) {
+            if (name.length() > 0) {
+                Console::printR(F("ERROR: Unknown pattern: "));
+                Console::printlnR(name);
+            }
+            Console::printlnR(F("Haptic patterns (repeat x (intensity on/off)):"));
+            VibrationMotor::printPatterns(Serial);
+            return true;
+        }
+        
+        modules->getVibrationMotor()->play(*pattern);
+        Console::printR(F("Playing haptic pattern: "));
+        Console::printlnR(pattern->name);
+        return true;
+    }
+    
     // VIB TEST - Quick test vibration
     if (command == "VIB TEST") {
         Console::printlnR(F("Running vibration test..."));
@@ -703,6 +1057,7 @@ bool CommandListener::processVibrationCommands(const String& command) {
     Console::printlnR(F("  VIB STOP               - Stop vibration"));
     Console::printlnR(F("  VIB TIMED <int> <ms>   - Timed vibration"));
     Console::printlnR(F("  VIB SET <intensity>    - Change intensity (0-100%)"));
+    Console::printlnR(F("  VIB PATTERN [name]     - Play haptic pattern (no name = list)"));
     Console::printlnR(F("  VIB TEST               - Quick test pulse"));
     Console::printlnR(F("Examples:"));
     Console::printlnR(F("  VIB ON 75              - 75% continuous"));
@@ -720,7 +1075,10 @@ bool CommandListener::processRGBCommands(const String& command) {
     
     // RGB STATUS - Show RGB LED status
     if (command == "RGB STATUS") {
-        Console::printlnR(modules->getRGBLed()->getStatus());
+        modules->getRGBLed()->printStatus(Serial);
+        if (modules->hasLedStatus()) {
+            modules->getLedStatus()->printStatus(Serial);
+        }
         return true;
     }
     
@@ -1087,7 +1445,39 @@ bool CommandListener::processRGBCommands(const String& command) {
         return true;
     }
     
-    // RGB STOPBLINK - Stop blinking
+    // RGB BREATHE [period] [count] - Breathe LED (hardware fades)
+    if (command.startsWith("RGB BREATHE")) {
+        String params = command.substring(11);
+        params.trim();
+        
+        int spacePos = params.indexOf(' ');
+        String periodStr = spacePos < 0 ? params : params.substring(0, spacePos);
+        String countStr = spacePos < 0 ? String("0") : params.substring(spacePos + 1);
+        
+        unsigned long period = periodStr.toInt();
+        uint16_t count = countStr.toInt();
+        
+        if (period == 0) {
+            Console::printlnR(F("Usage: RGB BREATHE <period_ms> [count]"));
+            Console::printlnR(F("  count = 0 for infinite breathing"));
+            Console::printlnR(F("Example: RGB BREATHE 2000 3 - 3 breaths of 2s"));
+            return true;
+        }
+        
+        modules->getRGBLed()->breathe(period, count);
+        Console::printR(F("Breathing: "));
+        Console::printR(String(period));
+        Console::printR(F("ms, "));
+        if (count == 0) {
+            Console::printlnR(F("infinite"));
+        } else {
+            Console::printR(String(count));
+            Console::printlnR(F(" times"));
+        }
+        return true;
+    }
+    
+    // RGB STOPBLINK - Stop blinking or breathing
     if (command == "RGB STOPBLINK") {
         modules->getRGBLed()->stopBlink();
         Console::printlnR(F("Blinking stopped"));
@@ -1128,7 +1518,8 @@ bool CommandListener::processRGBCommands(const String& command) {
     Console::printlnR(F("  RGB FADE <color> <ms>       - Fade to color name"));
     Console::printlnR(F("  RGB FADE <r> <g> <b> <ms>   - Fade to RGB color"));
     Console::printlnR(F("  RGB BLINK <interval> [cnt]  - Blink LED"));
-    Console::printlnR(F("  RGB STOPBLINK               - Stop blinking"));
+    Console::printlnR(F("  RGB BREATHE <period> [cnt]  - Breathe LED"));
+    Console::printlnR(F("  RGB STOPBLINK               - Stop blinking/breathing"));
     Console::printlnR(F("  RGB TEST                    - Run test sequence"));
     return true;
 }
@@ -1148,7 +1539,7 @@ bool CommandListener::processTouchCommands(const String& command) {
     
     // TOUCH STATUS - Show sensor status
     if (command == "TOUCH STATUS") {
-        Console::printlnR(modules->getTouchSensor()->getStatus());
+        modules->getTouchSensor()->printStatus(Serial);
         return true;
     }
     
@@ -1173,13 +1564,12 @@ bool CommandListener::processTouchCommands(const String& command) {
             return true;
         }
         
-        unsigned long delay = delayStr.toInt();
-        if (delay < 10 || delay > 500) {
+        long delay = delayStr.toInt();
+        if (delay <= 0 || !modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_TOUCH_DEBOUNCE, delay)) {
             Console::printlnR(F("ERROR: Debounce delay must be 10-500ms"));
             return true;
         }
         
-        modules->getTouchSensor()->setDebounceDelay(delay);
         Console::printR(F("Debounce delay set to "));
         Console::printR(String(delay));
         Console::printlnR(F("ms"));
@@ -1200,13 +1590,12 @@ bool CommandListener::processTouchCommands(const String& command) {
             return true;
         }
         
-        unsigned long duration = durationStr.toInt();
-        if (duration < 100 || duration > 10000) {
+        long duration = durationStr.toInt();
+        if (duration <= 0 || !modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_TOUCH_LONG_PRESS, duration)) {
             Console::printlnR(F("ERROR: Long press duration must be 100-10000ms"));
             return true;
         }
         
-        modules->getTouchSensor()->setLongPressDuration(duration);
         Console::printR(F("Long press duration set to "));
         Console::printR(String(duration));
         Console::printlnR(F("ms"));
@@ -1227,6 +1616,24 @@ bool CommandListener::processTouchCommands(const String& command) {
         return true;
     }
     
+    // TOUCH INJECT PRESS|RELEASE|OFF - Drive the raw input from serial (input replay)
+    if (command.startsWith("TOUCH INJECT")) {
+        String state = command.substring(12);
+        state.trim();
+        
+        if (state == "PRESS" || state == "RELEASE") {
+            modules->getTouchSensor()->setRawOverride(state == "PRESS" ? 1 : 0);
+            Console::printR(F("Touch input injected: "));
+            Console::printlnR(state);
+        } else if (state == "OFF") {
+            modules->getTouchSensor()->setRawOverride(-1);
+            Console::printlnR(F("Touch input follows the sensor pin"));
+        } else {
+            Console::printlnR(F("Usage: TOUCH INJECT PRESS|RELEASE|OFF"));
+        }
+        return true;
+    }
+    
     // TOUCH TEST - Test touch detection
     if (command == "TOUCH TEST") {
         Console::printlnR(F("Touch Sensor Test Mode"));
@@ -1273,6 +1680,7 @@ bool CommandListener::processTouchCommands(const String& command) {
     Console::printlnR(F("  TOUCH LONGPRESS <ms>      - Set long press duration"));
     Console::printlnR(F("  TOUCH LONGPRESS ENABLE    - Enable long press"));
     Console::printlnR(F("  TOUCH LONGPRESS DISABLE   - Disable long press"));
+    Console::printlnR(F("  TOUCH INJECT PRESS|RELEASE|OFF - Drive the input from serial"));
     Console::printlnR(F("  TOUCH TEST                - Test touch detection"));
     return true;
 }
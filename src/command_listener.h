@@ -24,6 +24,7 @@ private:
     
     // Command processing methods
     bool processSystemCommands(const String& command);
+    bool processConfigCommands(const String& command);
     bool processMotorCommands(const String& command);
     bool processTaskCommands(const String& command);
     bool processRTCCommands(const String& command);
@@ -40,6 +41,7 @@ public:
     
     // Main command processing
     bool processCommand(const String& command);
+    bool processCommand(const char* command);
     
     // Help and status display
     void showHelp();
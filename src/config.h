@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <Arduino.h>
+#include "board_profiles.h"
 
 /**
  * Global Configuration File
@@ -9,6 +10,15 @@
  * This file contains all configurable parameters for the Fish Feeder system.
  * These constants can be easily modified to adjust system behavior without
  * changing the core logic in multiple files.
+ * 
+ * Layout:
+ * - Compile-time constants are constexpr here, so every module folds them
+ *   into immediates instead of loading them from flash
+ * - Board pins come from board_profiles.h (selected by build flag)
+ * - RUNTIME-OVERRIDABLE DEFAULTS (end of file) are defined in config.cpp;
+ *   they only seed values that commands, the web UI or NVRAM can change
+ * - User settings persisted in NVRAM are registered in RuntimeConfig
+ * - COMPILE-TIME VALIDATION rejects pin conflicts and out-of-range values
  */
 
 // ============================================================================
@@ -22,41 +32,196 @@
  * the valid range of portions that can be requested.
  */
 
-// Rotation per food portion (as fraction of full revolution)
-// Default: 1/8 revolution = 0.125 (256 steps for 2048 steps/revolution)
-extern const float FOOD_PORTION_ROTATION;
+// Rotation per food portion (1/8 revolution = 12.5% of full rotation)
+// FEEDING PORTION ROTATION OPTIONS:
+//   • 1/16 revolution (0.0625) = 128 steps = very small portion
+//   • 1/12 revolution (0.0833) = 171 steps = small portion
+//   • 1/8 revolution (0.125) = 256 steps = standard portion (CURRENT)
+//   • 1/6 revolution (0.167) = 341 steps = medium portion
+//   • 1/4 revolution (0.25) = 512 steps = large portion
+//   • 1/3 revolution (0.333) = 682 steps = very large portion
+//   • RECOMMENDED: 0.125 (1/8 revolution) for consistent aquarium feeding
+constexpr float FOOD_PORTION_ROTATION = 1.0f;
 
 // Minimum number of portions allowed per feeding
-extern const int MIN_FOOD_PORTIONS;
+constexpr int MIN_FOOD_PORTIONS = 1;
 
 // Maximum number of portions allowed per feeding  
-extern const int MAX_FOOD_PORTIONS;
+constexpr int MAX_FOOD_PORTIONS = 20;
+
+// Steps per revolution for 28BYJ-48 stepper motor in half-step mode
+// 28BYJ-48 RESOLUTION SPECIFICATIONS:
+//   • FULL-STEP MODE: 2048 steps/revolution (higher torque, lower precision)
+//   • HALF-STEP MODE: 4096 steps/revolution (higher precision, lower torque)
+//   • GEAR RATIO: 64:1 (internal gear reduction for high torque)
+//   • STEP ANGLE: 5.625°/64 = 0.087890625° per step (very high precision)
+//   • CURRENT CONFIGURATION: FULL4WIRE mode = 2048 steps/revolution
+constexpr int STEPS_PER_REVOLUTION = 2048;
+
+/**
+ * Hopper Agitation
+ * 
+ * During async feedings the vibration motor pulses while the stepper
+ * accelerates and cruises, shaking pellet bridges loose, and stops for the
+ * deceleration ramp. Enable and duty are runtime settings (feed.agitate,
+ * feed.agitate.duty). With a delivery sensor registered on FeedingController
+ * the duty is raised while delivery lags the commanded steps.
+ */
+
+// Agitation pulse timing (on/off) in milliseconds
+constexpr uint16_t AGITATION_PULSE_ON_MS = 120;
+constexpr uint16_t AGITATION_PULSE_OFF_MS = 80;
+
+// Delivery lag (percent of commanded steps) that raises the duty by one step
+constexpr uint8_t AGITATION_LAG_PERCENT = 10;
+
+// Duty change per feeding monitor tick (100ms) while lagging / recovering
+constexpr uint8_t AGITATION_DUTY_STEP = 10;
+
+// Power budget while dispensing
+// POWER BUDGET (USB 5V, 500mA):
+//   • ~240mA reserved for ESP32 WiFi TX peaks
+//   • 28BYJ-48 via ULN2003: 2 coils energized, ~100mA each
+//   • 1027 vibracall at 100% duty: ~85mA
+//   • Agitation duty is capped so stepper + vibration stay within the budget
+constexpr uint16_t FEEDING_POWER_BUDGET_MA = 260;
+constexpr uint16_t STEPPER_RUN_CURRENT_MA = 200;
+constexpr uint16_t VIBRATION_MOTOR_FULL_CURRENT_MA = 85;
+
+// Highest agitation duty (percent) the power budget allows
+constexpr uint8_t AGITATION_MAX_DUTY =
+    (FEEDING_POWER_BUDGET_MA - STEPPER_RUN_CURRENT_MA) * 100 / VIBRATION_MOTOR_FULL_CURRENT_MA > 100
+        ? 100
+        : (FEEDING_POWER_BUDGET_MA - STEPPER_RUN_CURRENT_MA) * 100 / VIBRATION_MOTOR_FULL_CURRENT_MA;
+
+/**
+ * Dispense Profiles (anti-clog oscillation)
+ * 
+ * Sticky food bridges over the auger when it turns in one long stroke.
+ * A profile splits each feeding into forward strokes with a short reverse
+ * stroke after each one (+stroke / -reverse); the last forward stroke is
+ * shortened so the net rotation is still portionsToSteps(portions).
+ * Selected per food type with the feed.profile setting (FEED PROFILE).
+ */
+struct DispenseProfile {
+    const char* name;         // Food type (FEED PROFILE <name>)
+    uint16_t strokeSteps;     // Forward stroke length (0 = single stroke)
+    uint16_t reverseSteps;    // Reverse stroke length, shorter than strokeSteps
+};
+
+constexpr uint8_t DISPENSE_PROFILE_COUNT = 4;
 
-// Steps per full revolution for 28BYJ-48 stepper motor
-extern const int STEPS_PER_REVOLUTION;
+// Profile table (index = feed.profile value)
+extern const DispenseProfile DISPENSE_PROFILES[];
 
 // ============================================================================
 // MOTOR CONFIGURATION
 // ============================================================================
 
 /**
- * Stepper Motor Default Settings
+ * Stepper Motor Settings
  * 
- * These values define the default speed and acceleration for the motor.
- * Can be overridden at runtime but provide good starting defaults.
+ * Pins come from the board profile (STEPPER_IN1_PIN..STEPPER_IN4_PIN).
+ * Speed, acceleration and direction defaults are runtime-overridable
+ * (see RUNTIME-OVERRIDABLE DEFAULTS).
  */
 
-// Default maximum speed in steps per second
-extern const float DEFAULT_MAX_SPEED;
+// Legacy NVRAM key for motor direction ("motor" namespace, migrated into the runtime config blob)
+constexpr const char* MOTOR_DIRECTION_NVRAM_KEY = "motor_direction";
 
-// Default acceleration in steps per second squared
-extern const float DEFAULT_ACCELERATION;
+// Hardware coil sequencing through the RMT peripheral
+// RMT BACKEND CONSIDERATIONS:
+//   • Software stepping takes at most one step per motor task run (10ms = 100 steps/sec)
+//   • RMT plays the whole acceleration ramp and cruise with 1µs timing resolution
+//   • Pulses stay jitter-free during WiFi bursts and long web requests
+//   • Only non-blocking moves (feeding) use RMT; blocking test moves use AccelStepper
+//   • Set to false to fall back to AccelStepper for every move
+constexpr bool STEPPER_RMT_BACKEND_ENABLED = true;
 
-// Default motor rotation direction (true = clockwise, false = counter-clockwise)
-extern const bool DEFAULT_MOTOR_CLOCKWISE;
+// RMT channels for the coil pairs (ESP32 has 8 channels: 0-7)
+// Each channel owns one 64-item memory block; IN3/IN4 reuse these signals inverted
+constexpr uint8_t STEPPER_RMT_CHANNEL_A = 0;
+constexpr uint8_t STEPPER_RMT_CHANNEL_B = 1;
+
+/**
+ * Auger Index Sensor (homing)
+ * 
+ * Optical slot or hall switch giving one pulse per auger revolution on
+ * INDEX_SENSOR_PIN (board profile). When enabled the auger homes against the
+ * index at boot (and before the first feed if that failed), its absolute
+ * angle is tracked modulo one revolution, portions end on an auger flight
+ * boundary, and every index pass checks the position for lost steps.
+ * 
+ * Homing sequence (non-blocking, driven by the motor task):
+ *   1. Search: move up to HOMING_SEARCH_STEPS in the feeding direction
+ *      until the index edge (RMT speed, coarse position)
+ *   2. Back off HOMING_BACKOFF_STEPS past the edge
+ *   3. Approach: step slowly forward (one step per motor task run) and
+ *      take the exact position at the edge
+ */
+
+// Enable once the sensor is fitted - homing without one turns the auger
+// a full search stroke (and dispenses food) on every boot
+constexpr bool INDEX_SENSOR_ENABLED = false;
+
+// Sensor output pulls LOW at the index (open-collector hall / phototransistor)
+constexpr bool INDEX_SENSOR_ACTIVE_LOW = true;
+
+// Edges closer than this are bounce (under 3 steps at full speed)
+constexpr uint32_t INDEX_SENSOR_DEBOUNCE_US = 2000;
+
+// Longest search move before homing gives up (1.25 revolutions)
+constexpr uint16_t HOMING_SEARCH_STEPS = STEPS_PER_REVOLUTION + STEPS_PER_REVOLUTION / 4;
+
+// Back-off before the slow approach; must exceed the search overshoot
+// (RMT position resolution plus one motor task period at full speed)
+constexpr uint16_t HOMING_BACKOFF_STEPS = 192;
+
+// Index error (steps) tolerated on each revolution before it counts as lost
+// steps and the position is re-synced; covers the RMT position resolution
+// and the sensor width when a reverse stroke crosses the index
+constexpr uint16_t INDEX_LOST_STEP_TOLERANCE = 128;
+
+// Auger flights per revolution and the first flight boundary after the index
+// Portions are rounded so every feeding stops on a flight boundary
+constexpr uint8_t AUGER_FLIGHTS = 2;
+constexpr uint16_t AUGER_FLIGHT_OFFSET_STEPS = 0;
+
+/**
+ * Motor Autotune (MOTOR AUTOTUNE command)
+ * 
+ * Finds the fastest speed/acceleration that still runs without missed
+ * steps (see AutotuneSearch). Needs the index sensor: each trial starts
+ * half a revolution from the index and turns whole revolutions, so a trial
+ * passes only if it crossed the index once per revolution and the
+ * lost-step check stayed quiet. The auger turns for real - empty the
+ * hopper or catch the food.
+ * 
+ * Speed is searched first at AUTOTUNE_START_ACCEL, then acceleration at the
+ * tuned speed. The result keeps AUTOTUNE_MARGIN_PERCENT below the best
+ * passing values and is saved as motor.speed / motor.accel.
+ */
+
+// Speed axis in steps/second (start must run on any healthy motor)
+constexpr uint16_t AUTOTUNE_START_SPEED = 400;
+constexpr uint16_t AUTOTUNE_MAX_SPEED = 2000;
+constexpr uint16_t AUTOTUNE_SPEED_STEP = 200;
+constexpr uint16_t AUTOTUNE_MIN_SPEED_STEP = 25;
+
+// Acceleration axis in steps/second²
+constexpr uint16_t AUTOTUNE_START_ACCEL = 400;
+constexpr uint16_t AUTOTUNE_MAX_ACCEL = 3000;
+constexpr uint16_t AUTOTUNE_ACCEL_STEP = 300;
+constexpr uint16_t AUTOTUNE_MIN_ACCEL_STEP = 50;
 
-// NVRAM key for storing motor direction preference
-extern const char* MOTOR_DIRECTION_NVRAM_KEY;
+// Consecutive clean trials required before a setting counts as passing
+constexpr uint8_t AUTOTUNE_RUNS_PER_SETTING = 2;
+
+// Safety margin taken off the best passing speed and acceleration (%)
+constexpr uint8_t AUTOTUNE_MARGIN_PERCENT = 20;
+
+// Shortest trial; longer when the ramps need more room to reach full speed
+constexpr uint8_t AUTOTUNE_MIN_TRIAL_REVOLUTIONS = 2;
 
 /**
  * Vibration Motor Configuration
@@ -65,20 +230,24 @@ extern const char* MOTOR_DIRECTION_NVRAM_KEY;
  * NPN 2N2222 transistor circuit with 1kΩ resistor, 1N4007 diode, and 100nF capacitor.
  */
 
-// GPIO pin for vibration motor PWM control
-extern const uint8_t VIBRATION_MOTOR_PIN;
-
-// PWM channel for vibration motor (0-15 on ESP32)
-extern const uint8_t VIBRATION_PWM_CHANNEL;
+// PWM channel for vibration motor (ESP32 has 16 LEDC channels: 0-15)
+// Using channel 5 to avoid conflict with RGB LED (channels 0, 1, 2)
+constexpr uint8_t VIBRATION_PWM_CHANNEL = 5;
 
-// PWM frequency in Hz (1000Hz is good for motor control)
-extern const uint32_t VIBRATION_PWM_FREQUENCY;
+// PWM frequency: 1000Hz (1kHz) - good balance for motor control
+// VIBRACALL MOTOR 1027 PWM FREQUENCY CONSIDERATIONS:
+//   • 100Hz: Audible whine, rough vibration
+//   • 500Hz: Slight audible tone, smooth vibration
+//   • 1000Hz: Inaudible, very smooth vibration (RECOMMENDED)
+//   • 5000Hz+: Silent, but may reduce motor torque
+constexpr uint32_t VIBRATION_PWM_FREQUENCY = 1000;
 
-// PWM resolution in bits (8 bits = 0-255 duty cycle range)
-extern const uint8_t VIBRATION_PWM_RESOLUTION;
+// PWM resolution: 8 bits (0-255 duty cycle range)
+// 8-bit resolution provides 256 intensity levels (0-100% maps to 0-255)
+constexpr uint8_t VIBRATION_PWM_RESOLUTION = 8;
 
-// Vibration motor maintenance task interval (milliseconds)
-extern const unsigned long VIBRATION_MAINTENANCE_INTERVAL;
+// Timed vibrations and haptic patterns run on an esp_timer one-shot
+// (see VibrationMotor pattern library) - no maintenance task
 
 /**
  * RGB LED Configuration
@@ -88,16 +257,18 @@ extern const unsigned long VIBRATION_MAINTENANCE_INTERVAL;
  * Hardware: 4-pin RGB LED + 3x 330Ω resistors
  */
 
-// GPIO pins for RGB LED channels
-extern const uint8_t RGB_LED_RED_PIN;
-extern const uint8_t RGB_LED_GREEN_PIN;
-extern const uint8_t RGB_LED_BLUE_PIN;
+// RGB LED type: 0 = common cathode (GND), 1 = common anode (VCC)
+// COMMON CATHODE: LED on when pin HIGH (most common type)
+// COMMON ANODE: LED on when pin LOW (inverts PWM signal)
+// Hardware note: 4th pin connects to GND (cathode) or VCC (anode)
+constexpr uint8_t RGB_LED_TYPE = 0;  // 0 = COMMON_CATHODE
 
-// RGB LED type (0 = common cathode, 1 = common anode)
-extern const uint8_t RGB_LED_TYPE;
-
-// RGB LED maintenance task interval (milliseconds)
-extern const unsigned long RGB_LED_MAINTENANCE_INTERVAL;
+// RGB LED maintenance task interval: 20ms
+// This task plays LED keyframe animations (the fade ramps themselves run in
+// the LEDC hardware). It reschedules itself for the next keyframe, is
+// disabled while the LED is static and re-enabled when an animation starts;
+// the interval only applies right after it is woken.
+constexpr unsigned long RGB_LED_MAINTENANCE_INTERVAL = 20;
 
 /**
  * Touch Sensor Configuration (TTP223)
@@ -107,36 +278,27 @@ extern const unsigned long RGB_LED_MAINTENANCE_INTERVAL;
  * Hardware: TTP223 module connected to GPIO pin
  */
 
-// GPIO pin for touch sensor input
-extern const uint8_t TOUCH_SENSOR_PIN;
-
-// Touch sensor active logic (false = active HIGH, true = active LOW)
-extern const bool TOUCH_SENSOR_ACTIVE_LOW;
-
-// Touch sensor debounce delay (milliseconds)
-extern const unsigned long TOUCH_SENSOR_DEBOUNCE_DELAY;
-
-// Touch sensor long press duration (milliseconds)
-extern const unsigned long TOUCH_SENSOR_LONG_PRESS_DURATION;
-
-// Touch sensor maintenance task interval (milliseconds)
-extern const unsigned long TOUCH_SENSOR_MAINTENANCE_INTERVAL;
-
-// Default number of portions to dispense on long press
-extern const uint8_t DEFAULT_TOUCH_LONG_PRESS_PORTIONS;
+// Touch sensor active logic: false = active HIGH (standard TTP223 behavior)
+// TTP223 MODULE OUTPUT BEHAVIOR:
+//   • Standard mode: OUTPUT = HIGH when touched, LOW when not touched
+//   • Inverted mode: OUTPUT = LOW when touched, HIGH when not touched (rare)
+//   • Most TTP223 modules use standard mode (active HIGH)
+constexpr bool TOUCH_SENSOR_ACTIVE_LOW = false;
 
-// NVRAM key for storing touch long press portions
-extern const char* TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY;
+// Touch sensor maintenance task interval: 5ms
+// This task calls update() to handle debouncing and callbacks
+// 5ms provides 200Hz update rate for highly responsive touch detection
+// OPTIMIZATION: Reduced from 20ms to 5ms for faster tactile feedback
+constexpr unsigned long TOUCH_SENSOR_MAINTENANCE_INTERVAL = 5;
 
-// Default touch sensor enabled state
-extern const bool DEFAULT_TOUCH_SENSOR_ENABLED;
+// Legacy NVRAM key for touch long press portions ("touch" namespace, migrated into the runtime config blob)
+constexpr const char* TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY = "touch_portions";
 
-// NVRAM key for storing touch sensor enabled/disabled state
-extern const char* TOUCH_SENSOR_ENABLED_NVRAM_KEY;
+// Legacy NVRAM key for touch sensor enabled state ("touch" namespace, migrated into the runtime config blob)
+constexpr const char* TOUCH_SENSOR_ENABLED_NVRAM_KEY = "touch_enabled";
 
-// Touch vibration feedback durations (milliseconds)
-extern const unsigned long TOUCH_VIBRATION_SHORT_DURATION;
-extern const unsigned long TOUCH_VIBRATION_LONG_DURATION;
+// Touch vibration feedback: VibrationMotor::PATTERN_ACK (50ms tick on touch)
+// and PATTERN_LONG_PRESS (200ms buzz on long press)
 
 // ============================================================================
 // SERIAL COMMUNICATION CONFIGURATION
@@ -146,8 +308,15 @@ extern const unsigned long TOUCH_VIBRATION_LONG_DURATION;
  * Serial Communication Settings
  */
 
-// Serial baud rate for communication
-extern const long SERIAL_BAUD_RATE;
+// Standard baud rate for ESP32 communication
+constexpr long SERIAL_BAUD_RATE = 115200;
+
+// Maximum command line length (fixed line buffer, longer lines are rejected)
+constexpr size_t SERIAL_COMMAND_MAX_LENGTH = 128;
+
+// Process a pending line without terminator after 1 second of silence
+// (terminals that send no line ending, same as the old readStringUntil timeout)
+constexpr unsigned long SERIAL_COMMAND_IDLE_FLUSH = 1000;
 
 // ============================================================================
 // TASK SCHEDULER CONFIGURATION
@@ -160,17 +329,188 @@ extern const long SERIAL_BAUD_RATE;
  * Adjust these to optimize system performance and responsiveness.
  */
 
-// Time display task interval (milliseconds)
-extern const unsigned long DISPLAY_TIME_INTERVAL;
+// Display time every 1 second (1000ms)
+constexpr unsigned long DISPLAY_TIME_INTERVAL = 1000;
+
+// Process serial commands every 50ms (responsive input)
+constexpr unsigned long SERIAL_PROCESS_INTERVAL = 50;
+
+// Motor maintenance every 10ms (smooth stepper operation)
+constexpr unsigned long MOTOR_MAINTENANCE_INTERVAL = 10;
+
+// Wait up to 3 seconds for serial connection
+constexpr unsigned long SERIAL_TIMEOUT = 3000;
+
+/**
+ * CPU Frequency Scaling (CpuGovernor)
+ * 
+ * The CPU idles at CPU_IDLE_FREQ_MHZ (touch/serial polling) and boosts to
+ * CPU_BOOST_FREQ_MHZ while web requests are served, holding the boost for
+ * CPU_BOOST_HOLD_MS after the last one (a page load is a burst of requests).
+ * 
+ * Frequencies must be 80, 160 or 240 MHz: below 80 MHz the APB clock drops
+ * with the CPU, which would change RMT step timing, UART baud and LEDC PWM
+ * and is too slow for WiFi. From 80 MHz up APB stays at 80 MHz, so step
+ * generation (RMT, esp_timer/micros()) is unaffected by switching.
+ */
+
+// Idle and boost CPU frequency in MHz
+constexpr uint32_t CPU_IDLE_FREQ_MHZ = 80;
+constexpr uint32_t CPU_BOOST_FREQ_MHZ = 240;
+
+// Boost kept after the last boost request
+constexpr unsigned long CPU_BOOST_HOLD_MS = 2000;
+
+// Governor task period (boost expiry and time accounting)
+constexpr unsigned long CPU_GOVERNOR_INTERVAL = 250;
+
+// Estimated module current per CPU frequency (ESP32 datasheet, dual core,
+// modem sleep, upper values) and supply voltage - for the energy estimate only
+constexpr uint16_t CPU_CURRENT_80MHZ_MA = 31;
+constexpr uint16_t CPU_CURRENT_160MHZ_MA = 44;
+constexpr uint16_t CPU_CURRENT_240MHZ_MA = 68;
+constexpr float CPU_SUPPLY_VOLTAGE = 3.3f;
+
+// ============================================================================
+// DIAGNOSTICS CONFIGURATION
+// ============================================================================
+
+/**
+ * Sampling Profiler (PROFILE SAMPLE command)
+ * 
+ * A hardware timer interrupt on the loop task's core records the
+ * interrupted PC and its caller into a RAM ring. The ring is dumped as a
+ * compact binary (/api/profile) or as base64 over serial, and
+ * tools/profile_symbolize.py turns it into folded stacks for flame graphs
+ * using the firmware ELF.
+ */
+
+// Default and maximum sample rate in Hz
+constexpr uint16_t PROFILER_DEFAULT_HZ = 1000;
+constexpr uint16_t PROFILER_MAX_HZ = 10000;
+
+// Ring capacity in samples (8 bytes each), allocated on the first start;
+// the oldest samples are overwritten when it is full
+constexpr uint16_t PROFILER_SAMPLE_CAPACITY = 2048;
+
+// Hardware timer used for sampling (0-3, none of them is used elsewhere)
+constexpr uint8_t PROFILER_TIMER = 3;
+
+/**
+ * Timeline Trace (TRACE command, /api/trace)
+ * 
+ * Task runs, web requests, feeds, NVS commits, WiFi state changes and time
+ * syncs are recorded as begin/end/instant events with microsecond
+ * timestamps into a fixed RAM ring. /api/trace streams the ring as Chrome
+ * trace-event JSON for Perfetto (ui.perfetto.dev) or chrome://tracing.
+ */
+
+// Ring capacity in events (12 bytes each, static); must be a power of two
+constexpr uint16_t TRACE_BUFFER_EVENTS = 2048;
+
+// Record from boot (TRACE ON/OFF switches it at runtime)
+constexpr bool TRACE_ENABLED_AT_BOOT = true;
+
+// Also trace the 5-50 ms polling tasks (touch, motor, LED, serial); they
+// fill the ring within seconds, so they are left out unless needed
+constexpr bool TRACE_FAST_TASKS = false;
+
+/**
+ * Feed Latency Tracking (/api/metrics, FEED LATENCY command)
+ * 
+ * Every feeding carries the time its trigger arrived (touch long press,
+ * /api/feed, serial FEED, schedule deadline). The step engine stamps the
+ * first step and the end of the move, and per-source histograms collect
+ * trigger -> first step and trigger -> complete latencies.
+ */
+
+// Histogram bucket upper bounds in ms (config.cpp), plus one overflow bucket
+constexpr uint8_t FEED_LATENCY_BUCKET_COUNT = 12;
+extern const uint32_t FEED_LATENCY_BUCKETS_MS[];
+
+// Alert when the first step comes later than this after the trigger
+constexpr uint32_t FEED_LATENCY_FIRST_STEP_ALERT_MS = 250;
+
+// Alert when the move takes this much longer than its estimated duration
+constexpr uint32_t FEED_LATENCY_COMPLETE_MARGIN_MS = 500;
+
+/**
+ * Input Recorder (INPUT command, /api/inputs, input.record setting)
+ * 
+ * Serial lines, raw touch edges, HTTP requests, WiFi status changes and
+ * RTC readings are staged in RAM with millisecond timestamps and flushed
+ * to a ring of flash sectors in the SPIFFS partition (unused otherwise).
+ * tools/input_replay.py decodes /api/inputs and replays a session against
+ * a bench unit with the original timing.
+ */
+
+// Flash used for the ring (capped at the partition size) and its erase unit
+constexpr uint32_t INPUT_RECORDER_FLASH_BYTES = 256 * 1024;
+constexpr uint16_t INPUT_RECORDER_SECTOR_SIZE = 4096;
+
+// RAM staging between flushes; records beyond it are dropped and counted
+constexpr size_t INPUT_RECORDER_BUFFER_BYTES = 2048;
+
+// Longest payload kept per record (serial lines, "METHOD /uri?args")
+constexpr uint8_t INPUT_RECORDER_MAX_PAYLOAD = 160;
+
+// Flush staged records to flash every 2 seconds (skipped while feeding)
+constexpr unsigned long INPUT_RECORDER_FLUSH_INTERVAL = 2000;
+
+/**
+ * Loop Stall Watchdog (STALLS command, /api/stalls, watchdog.* settings)
+ * 
+ * Every loop pass is timed against watchdog.budget. Passes over it are
+ * blamed on the task or web handler that used the most of the pass and on
+ * the known blocking call inside it (NTP wait, HTTP time, WiFi scan,
+ * blocking motor moves, RTC probe, flash writes), then logged and counted
+ * per site.
+ */
+
+// Scope nesting tracked per pass (task -> web handler, ...)
+constexpr uint8_t LOOP_WATCHDOG_MAX_DEPTH = 4;
+
+// Distinct stall sites counted (callback, URI, blocking call) and recent stalls kept
+constexpr uint8_t LOOP_WATCHDOG_SITES = 16;
+constexpr uint8_t LOOP_WATCHDOG_RECENT = 8;
+
+// Hardware task watchdog timeout with watchdog.hw on (the loop task is
+// fed between passes, so only a hang this long resets the feeder)
+constexpr uint32_t LOOP_WATCHDOG_HW_TIMEOUT_S = 30;
+
+/**
+ * Metrics Registry (/metrics, METRICS command)
+ * 
+ * Counters, gauges and histograms defined by the modules, served in
+ * Prometheus text format for fleet monitoring.
+ */
+
+// Most bucket bounds a histogram can have (plus the +Inf bucket)
+constexpr uint8_t METRICS_MAX_BUCKETS = 16;
+
+/**
+ * Time-Series Store (/api/series, SERIES command, charts on /custom)
+ * 
+ * Heap, loop latency, RSSI, RTC temperature, feedings and NTP offset are
+ * sampled once a minute into three round-robin tiers; the hour and day
+ * tiers keep min/avg/max, consolidated as each minute arrives. The whole
+ * store lives in RAM and is checkpointed to the SPIFFS partition, right
+ * after the input recorder ring.
+ */
+
+// Slots per tier: 1 minute for 24 hours, 1 hour for 30 days, 1 day for a year
+constexpr uint16_t SERIES_MINUTE_SLOTS = 1440;
+constexpr uint16_t SERIES_HOUR_SLOTS = 720;
+constexpr uint16_t SERIES_DAY_SLOTS = 365;
 
-// Serial processing task interval (milliseconds) 
-extern const unsigned long SERIAL_PROCESS_INTERVAL;
+// Minute rollover check (the sample itself is taken once per minute)
+constexpr unsigned long SERIES_SAMPLE_CHECK_INTERVAL = 5000;
 
-// Motor maintenance task interval (milliseconds)
-extern const unsigned long MOTOR_MAINTENANCE_INTERVAL;
+// Write the store to flash every hour (skipped while feeding)
+constexpr unsigned long SERIES_CHECKPOINT_INTERVAL = 3600000UL;
 
-// Serial connection timeout (milliseconds)
-extern const unsigned long SERIAL_TIMEOUT;
+// Checkpoint area in the SPIFFS partition (two alternating copies)
+constexpr uint32_t SERIES_FLASH_OFFSET = INPUT_RECORDER_FLASH_BYTES;
 
 // ============================================================================
 // WIFI & BLUETOOTH CONFIGURATION
@@ -182,20 +522,20 @@ extern const unsigned long SERIAL_TIMEOUT;
  * These values control wireless connectivity behavior and timeouts.
  */
 
-// WiFi connection timeout (milliseconds)
-extern const unsigned long WIFI_CONNECTION_TIMEOUT;
+// WiFi connection timeout: 10 seconds
+constexpr unsigned long WIFI_CONNECTION_TIMEOUT = 10000;
 
-// WiFi auto-reconnection interval (milliseconds)
-extern const unsigned long WIFI_RECONNECT_INTERVAL;
+// Auto-reconnection attempt every 30 seconds
+constexpr unsigned long WIFI_RECONNECT_INTERVAL = 30000;
 
-// Maximum number of saved WiFi networks
-extern const int MAX_SAVED_NETWORKS;
+// Maximum number of networks that can be saved
+constexpr int MAX_SAVED_NETWORKS = 10;
 
 // Default Bluetooth device name
-extern const char* DEFAULT_BLUETOOTH_NAME;
+constexpr const char* DEFAULT_BLUETOOTH_NAME = "ESP32-FishFeeder";
 
-// WiFi scan timeout (milliseconds)
-extern const unsigned long WIFI_SCAN_TIMEOUT;
+// WiFi network scan timeout: 10 seconds
+constexpr unsigned long WIFI_SCAN_TIMEOUT = 10000;
 
 // ============================================================================
 // WIFI PORTAL CONFIGURATION
@@ -208,23 +548,56 @@ extern const unsigned long WIFI_SCAN_TIMEOUT;
  * automatic startup, timeout settings, and access credentials.
  */
 
-// Enable WiFi portal auto-start on boot
-extern const bool WIFI_PORTAL_AUTO_START;
-
-// Enable WiFi portal on connection loss
-extern const bool WIFI_PORTAL_ON_DISCONNECT;
-
-// WiFi portal timeout (milliseconds) - 15 minutes
-extern const unsigned long WIFI_PORTAL_TIMEOUT;
-
-// Default WiFi portal access point name
-extern const char* WIFI_PORTAL_AP_NAME;
-
-// WiFi portal access password (empty = no password)
-extern const char* WIFI_PORTAL_AP_PASSWORD;
-
-// WiFi portal connection check interval (milliseconds)
-extern const unsigned long WIFI_CONNECTION_CHECK_INTERVAL;
+// Enable WiFi portal auto-start on system boot
+constexpr bool WIFI_PORTAL_AUTO_START = true;
+
+// Enable WiFi portal when connection is lost
+constexpr bool WIFI_PORTAL_ON_DISCONNECT = true;
+
+// WiFi portal timeout: 0 = never timeout (always active)
+constexpr unsigned long WIFI_PORTAL_TIMEOUT = 0;
+
+// Default access point name for configuration portal
+constexpr const char* WIFI_PORTAL_AP_NAME = "Fish Feeder";
+
+// WiFi portal access password (empty string = no password required)
+constexpr const char* WIFI_PORTAL_AP_PASSWORD = "0123456789";
+
+// Check WiFi connection every 10 seconds
+constexpr unsigned long WIFI_CONNECTION_CHECK_INTERVAL = 10000;
+
+// Per-request scratch memory for web handlers: 4KB
+// REQUEST ARENA SIZING:
+// - Holds the JSON body, copied arguments and the page chunk buffer of one request
+// - Reset after every request; allocations that do not fit fall back to the heap
+// - Check /api/memory (arena.peakRequestBytes, arena.fallbacks) before changing it
+constexpr size_t WEB_REQUEST_ARENA_SIZE = 4096;
+
+// Chunk size for streamed HTML pages (taken from the request arena)
+constexpr size_t WEB_RESPONSE_CHUNK_SIZE = 1024;
+
+// JSON response capacities (taken from the request arena)
+// Responses that do not fit are answered with HTTP 500 and counted as
+// StringBuilder overflows instead of growing a heap String
+constexpr size_t WEB_JSON_SMALL_CAPACITY = 160;
+constexpr size_t WEB_JSON_STATUS_CAPACITY = 256;
+constexpr size_t WEB_JSON_SCHEDULES_CAPACITY = 1536;
+constexpr size_t WEB_JSON_CONFIG_CAPACITY = 1536;
+
+// Web API admission control (WebRateLimiter), checked before any handler runs
+// - Per client IP and route class: burst size and one request per interval;
+//   the /custom page loads a handful of reads at once
+// - Globally: handler time the loop may spend per second, and the most it banks
+// Over the limit: 429 (client rate) or 503 (handler time), with Retry-After
+constexpr uint8_t WEB_RATE_LIMIT_CLIENTS = 8;
+constexpr uint32_t WEB_RATE_READ_BURST = 10;
+constexpr uint32_t WEB_RATE_READ_INTERVAL_MS = 500;
+constexpr uint32_t WEB_RATE_MUTATE_BURST = 5;
+constexpr uint32_t WEB_RATE_MUTATE_INTERVAL_MS = 2000;
+constexpr uint32_t WEB_RATE_FEED_BURST = 2;
+constexpr uint32_t WEB_RATE_FEED_INTERVAL_MS = 30000;
+constexpr uint32_t WEB_ADMISSION_BUSY_MS_PER_S = 200;
+constexpr uint32_t WEB_ADMISSION_BUSY_BURST_MS = 2000;
 
 // ============================================================================
 // NTP TIME SYNCHRONIZATION CONFIGURATION
@@ -237,9 +610,6 @@ extern const unsigned long WIFI_CONNECTION_CHECK_INTERVAL;
  * to keep the RTC module accurate.
  */
 
-// NTP synchronization interval (milliseconds) - 30 minutes
-extern const unsigned long NTP_SYNC_INTERVAL;
-
 /**
  * Time Server Entry Structure
  * 
@@ -259,23 +629,36 @@ extern const int TIME_SERVERS_COUNT;
 extern const char* DNS_SERVERS[];
 extern const int DNS_SERVERS_COUNT;
 
-// GMT offset in seconds (Brazil Standard Time: UTC-3 = -3 * 3600)
-extern const long GMT_OFFSET_SEC;
+// NTP synchronization timeout: 10 seconds (faster response, multiple servers available)
+constexpr unsigned long NTP_SYNC_TIMEOUT = 10000;
+
+// HTTP time fallback timeout: 8 seconds (quick HTTP response expected)
+constexpr unsigned long HTTP_TIME_TIMEOUT = 8000;
 
-// Daylight saving time offset in seconds (Brazil doesn't use DST consistently)
-extern const int DAYLIGHT_OFFSET_SEC;
+// Wait 5 seconds after WiFi connection before first NTP sync
+constexpr unsigned long NTP_INITIAL_SYNC_DELAY = 5000;
 
-// NTP timeout for synchronization attempts (milliseconds)
-extern const unsigned long NTP_SYNC_TIMEOUT;
+// NVRAM key for storing last NTP sync timestamp
+constexpr const char* NTP_LAST_SYNC_NVRAM_KEY = "ntp_last_sync";
+
+/**
+ * Time Zone Settings
+ * 
+ * The RTC keeps UTC; local time comes from a POSIX TZ string (NTP TZ
+ * command, /api/timezone) with DST transitions precomputed per year.
+ */
 
-// HTTP time fallback timeout (milliseconds)
-extern const unsigned long HTTP_TIME_TIMEOUT;
+// Longest accepted POSIX TZ string and zone abbreviation
+constexpr size_t TIMEZONE_POSIX_MAX_LENGTH = 48;
+constexpr size_t TIMEZONE_NAME_MAX_LENGTH = 10;
 
-// Delay after WiFi connection before first NTP sync (milliseconds)
-extern const unsigned long NTP_INITIAL_SYNC_DELAY;
+// Years of DST transitions kept in the lookup table (2 entries per year)
+constexpr uint8_t TIMEZONE_TABLE_YEARS = 8;
 
-// NVRAM key for storing last NTP sync timestamp (Unix time in seconds)
-extern const char* NTP_LAST_SYNC_NVRAM_KEY;
+// NVRAM namespace and keys for the time zone and the UTC migration flag
+constexpr const char* RTC_NVRAM_NAMESPACE = "rtc";
+constexpr const char* RTC_TIMEZONE_NVRAM_KEY = "tz";
+constexpr const char* RTC_UTC_NVRAM_KEY = "utc";
 
 // ============================================================================
 // FEEDING SCHEDULE CONFIGURATION
@@ -288,17 +671,15 @@ extern const char* NTP_LAST_SYNC_NVRAM_KEY;
  * tolerance for missed feedings, recovery periods, and task intervals.
  */
 
-// Schedule monitoring task interval (milliseconds) - 30 seconds
-extern const unsigned long FEEDING_SCHEDULE_MONITOR_INTERVAL;
-
-// Tolerance for missed feedings (minutes) - allow up to 30 minutes late
-extern const uint16_t FEEDING_SCHEDULE_TOLERANCE_MINUTES;
+// Schedule monitoring every 30 seconds (30,000 milliseconds)
+constexpr unsigned long FEEDING_SCHEDULE_MONITOR_INTERVAL = 30000;
 
-// Maximum recovery period after power loss (hours) - look back up to 12 hours
-extern const uint16_t FEEDING_SCHEDULE_MAX_RECOVERY_HOURS;
+// A scheduled feeding fires on the first monitor tick at or after its time,
+// at most this many seconds late (later ticks leave it to missed-feeding recovery)
+constexpr uint32_t FEEDING_SCHEDULE_TRIGGER_WINDOW = 60;
 
-// Maximum number of scheduled feedings
-extern const uint8_t MAX_SCHEDULED_FEEDINGS;
+// Maximum number of scheduled feedings that can be configured
+constexpr uint8_t MAX_SCHEDULED_FEEDINGS = 10;
 
 /**
  * Feeding Schedule Structure
@@ -326,17 +707,120 @@ struct ScheduledFeeding {
 extern ScheduledFeeding DEFAULT_FEEDING_SCHEDULE[];
 extern const uint8_t DEFAULT_SCHEDULE_COUNT;
 
+// ============================================================================
+// RUNTIME CONFIGURATION REGISTRY
+// ============================================================================
+
+/**
+ * Runtime Configuration Registry Settings
+ * 
+ * All user settings are stored as one packed blob in a single NVRAM key,
+ * read once at boot (see RuntimeConfig).
+ */
+
+// NVRAM namespace and key holding the settings blob
+constexpr const char* RUNTIME_CONFIG_NVRAM_NAMESPACE = "config";
+constexpr const char* RUNTIME_CONFIG_NVRAM_KEY = "values";
+
+// Blob layout version - bump when fields are appended to RuntimeConfig::Values
+// (older blobs are upgraded in place, see RuntimeConfig::begin())
+constexpr uint8_t RUNTIME_CONFIG_VERSION = 7;
+
+// Maximum number of change listeners
+constexpr uint8_t RUNTIME_CONFIG_MAX_LISTENERS = 4;
+
+// ============================================================================
+// RUNTIME-OVERRIDABLE DEFAULTS
+// ============================================================================
+
+/**
+ * Runtime-Overridable Defaults
+ * 
+ * Starting values for settings that can be changed while running (serial
+ * commands, web interface, NVRAM). Defined once in config.cpp; code must
+ * read the live setting from RuntimeConfig or its owning module, not
+ * these defaults.
+ */
+
+// Default maximum speed in steps per second (MOTOR commands, autotune)
+extern const float DEFAULT_MAX_SPEED;
+
+// Default acceleration in steps per second squared (MOTOR commands, autotune)
+extern const float DEFAULT_ACCELERATION;
+
+// Default motor rotation direction (DIRECTION command, web UI, NVRAM)
+extern const bool DEFAULT_MOTOR_CLOCKWISE;
+
+// Touch sensor debounce delay in milliseconds (TOUCH DEBOUNCE command)
+extern const unsigned long TOUCH_SENSOR_DEBOUNCE_DELAY;
+
+// Touch sensor long press duration in milliseconds (TOUCH LONGPRESS command)
+extern const unsigned long TOUCH_SENSOR_LONG_PRESS_DURATION;
+
+// Default number of portions to dispense on long press (web UI, NVRAM)
+extern const uint8_t DEFAULT_TOUCH_LONG_PRESS_PORTIONS;
+
+// Default touch sensor enabled state (web UI, NVRAM)
+extern const bool DEFAULT_TOUCH_SENSOR_ENABLED;
+
+// Default hopper agitation state and duty in percent (feed.agitate, feed.agitate.duty)
+extern const bool DEFAULT_AGITATION_ENABLED;
+extern const uint8_t DEFAULT_AGITATION_DUTY;
+
+// Default dispense profile index into DISPENSE_PROFILES (feed.profile)
+extern const uint8_t DEFAULT_DISPENSE_PROFILE;
+
+// Default CPU frequency scaling state (cpu.scaling, CPU SCALING command)
+extern const bool DEFAULT_CPU_SCALING_ENABLED;
+
+// Default input recording state (input.record, INPUT ON/OFF command)
+extern const bool DEFAULT_INPUT_RECORDING_ENABLED;
+
+// Default loop stall budget in ms and hardware watchdog escalation (watchdog.budget, watchdog.hw)
+extern const uint16_t DEFAULT_LOOP_STALL_BUDGET_MS;
+extern const bool DEFAULT_LOOP_WATCHDOG_HW;
+
+// NTP synchronization interval in milliseconds (NTP INTERVAL command)
+extern const unsigned long NTP_SYNC_INTERVAL;
+
+// Default POSIX TZ string (NTP TZ command, /api/timezone)
+extern const char* const DEFAULT_TIMEZONE;
+
+// Tolerance for missed feedings in minutes (SCHEDULE TOLERANCE command)
+extern const uint16_t FEEDING_SCHEDULE_TOLERANCE_MINUTES;
+
+// Maximum recovery period after power loss in hours (SCHEDULE RECOVERY command)
+extern const uint16_t FEEDING_SCHEDULE_MAX_RECOVERY_HOURS;
+
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
 
+// Steps per food portion, rounded once at compile time
+constexpr int STEPS_PER_PORTION = (int)(FOOD_PORTION_ROTATION * STEPS_PER_REVOLUTION + 0.5f);
+
+/**
+ * Clamp portion count to valid range
+ * 
+ * @param portions: Requested portions
+ * @return: Clamped value within MIN_FOOD_PORTIONS to MAX_FOOD_PORTIONS
+ */
+constexpr int clampPortions(int portions) {
+    return portions < MIN_FOOD_PORTIONS ? MIN_FOOD_PORTIONS
+         : portions > MAX_FOOD_PORTIONS ? MAX_FOOD_PORTIONS
+         : portions;
+}
+
 /**
  * Convert portions to motor steps
+ * Integer multiply by a folded constant (no float math at runtime)
  * 
  * @param portions: Number of food portions
  * @return: Number of steps needed
  */
-int portionsToSteps(int portions);
+constexpr int portionsToSteps(int portions) {
+    return clampPortions(portions) * STEPS_PER_PORTION;
+}
 
 /**
  * Validate if portion count is within allowed range
@@ -344,14 +828,113 @@ int portionsToSteps(int portions);
  * @param portions: Number of portions to validate
  * @return: true if valid, false otherwise
  */
-bool isValidPortionCount(int portions);
+constexpr bool isValidPortionCount(int portions) {
+    return portions >= MIN_FOOD_PORTIONS && portions <= MAX_FOOD_PORTIONS;
+}
+
+// ============================================================================
+// COMPILE-TIME VALIDATION
+// ============================================================================
 
 /**
- * Clamp portion count to valid range
- * 
- * @param portions: Requested portions
- * @return: Clamped value within MIN_FOOD_PORTIONS to MAX_FOOD_PORTIONS
+ * Pin conflict check: true if `pin` differs from every pin in the list
+ */
+constexpr bool pinIsUnique(uint8_t) {
+    return true;
+}
+
+template <typename... Pins>
+constexpr bool pinIsUnique(uint8_t pin, uint8_t first, Pins... rest) {
+    return pin != first && pinIsUnique(pin, rest...);
+}
+
+/**
+ * True if no pin appears twice in the list
  */
-int clampPortions(int portions);
+constexpr bool pinsAreDistinct() {
+    return true;
+}
+
+template <typename... Pins>
+constexpr bool pinsAreDistinct(uint8_t first, Pins... rest) {
+    return pinIsUnique(first, rest...) && pinsAreDistinct(rest...);
+}
+
+static_assert(pinsAreDistinct(STEPPER_IN1_PIN, STEPPER_IN2_PIN, STEPPER_IN3_PIN, STEPPER_IN4_PIN,
+                              VIBRATION_MOTOR_PIN,
+                              RGB_LED_RED_PIN, RGB_LED_GREEN_PIN, RGB_LED_BLUE_PIN,
+                              TOUCH_SENSOR_PIN, INDEX_SENSOR_PIN, RTC_SDA_PIN, RTC_SCL_PIN),
+              "Board profile assigns the same GPIO to more than one function");
+
+static_assert(STEPPER_IN1_PIN < 32 && STEPPER_IN2_PIN < 32 && STEPPER_IN3_PIN < 32 && STEPPER_IN4_PIN < 32,
+              "Stepper pins must be GPIO 0-31 (direct register driver)");
+static_assert(VIBRATION_MOTOR_PIN < 34 && RGB_LED_RED_PIN < 34 && RGB_LED_GREEN_PIN < 34 && RGB_LED_BLUE_PIN < 34,
+              "GPIO 34-39 are input-only and cannot drive outputs");
+static_assert(TOUCH_SENSOR_PIN < 40, "Touch sensor pin out of range");
+static_assert(INDEX_SENSOR_PIN < 34, "Index sensor needs a GPIO with internal pull-up (not 34-39)");
+static_assert(AUGER_FLIGHTS > 0 && AUGER_FLIGHT_OFFSET_STEPS < STEPS_PER_REVOLUTION / AUGER_FLIGHTS,
+              "Flight offset must be inside one flight");
+static_assert(HOMING_BACKOFF_STEPS > 0 && INDEX_LOST_STEP_TOLERANCE < STEPS_PER_REVOLUTION / 2,
+              "Invalid homing settings");
+static_assert(AUTOTUNE_START_SPEED > 0 && AUTOTUNE_START_SPEED <= AUTOTUNE_MAX_SPEED &&
+              AUTOTUNE_MIN_SPEED_STEP > 0 && AUTOTUNE_SPEED_STEP >= AUTOTUNE_MIN_SPEED_STEP,
+              "Invalid autotune speed range");
+static_assert(AUTOTUNE_START_ACCEL > 0 && AUTOTUNE_START_ACCEL <= AUTOTUNE_MAX_ACCEL &&
+              AUTOTUNE_MIN_ACCEL_STEP > 0 && AUTOTUNE_ACCEL_STEP >= AUTOTUNE_MIN_ACCEL_STEP,
+              "Invalid autotune acceleration range");
+static_assert(AUTOTUNE_RUNS_PER_SETTING > 0 && AUTOTUNE_MARGIN_PERCENT < 100 && AUTOTUNE_MIN_TRIAL_REVOLUTIONS > 0,
+              "Invalid autotune trial settings");
+
+static_assert(MIN_FOOD_PORTIONS >= 1 && MIN_FOOD_PORTIONS <= MAX_FOOD_PORTIONS, "Invalid portion range");
+static_assert(FOOD_PORTION_ROTATION > 0.0f, "FOOD_PORTION_ROTATION must be positive");
+static_assert(STEPS_PER_PORTION > 0, "A portion must be at least one step");
+static_assert(FEEDING_POWER_BUDGET_MA > STEPPER_RUN_CURRENT_MA && AGITATION_MAX_DUTY >= 10,
+              "FEEDING_POWER_BUDGET_MA leaves no headroom for hopper agitation");
+static_assert(AGITATION_PULSE_ON_MS > 0 && AGITATION_DUTY_STEP > 0, "Invalid agitation pulse settings");
+static_assert(DISPENSE_PROFILE_COUNT > 0, "At least one dispense profile is required");
+static_assert(STEPPER_RMT_CHANNEL_A < 8 && STEPPER_RMT_CHANNEL_B < 8 && STEPPER_RMT_CHANNEL_A != STEPPER_RMT_CHANNEL_B,
+              "Stepper RMT channels must be distinct channels 0-7");
+static_assert(VIBRATION_PWM_CHANNEL >= 3 && VIBRATION_PWM_CHANNEL < 16,
+              "Vibration PWM channel must be 3-15 (RGB LED uses LEDC channels 0-2)");
+static_assert(VIBRATION_PWM_RESOLUTION >= 1 && VIBRATION_PWM_RESOLUTION <= 16, "Invalid PWM resolution");
+static_assert(RGB_LED_TYPE <= 1, "RGB_LED_TYPE must be 0 (common cathode) or 1 (common anode)");
+static_assert((CPU_IDLE_FREQ_MHZ == 80 || CPU_IDLE_FREQ_MHZ == 160 || CPU_IDLE_FREQ_MHZ == 240) &&
+              (CPU_BOOST_FREQ_MHZ == 80 || CPU_BOOST_FREQ_MHZ == 160 || CPU_BOOST_FREQ_MHZ == 240) &&
+              CPU_IDLE_FREQ_MHZ <= CPU_BOOST_FREQ_MHZ,
+              "CPU frequencies must be 80/160/240 MHz (APB stays at 80 MHz), idle <= boost");
+static_assert(CPU_BOOST_HOLD_MS >= CPU_GOVERNOR_INTERVAL && CPU_GOVERNOR_INTERVAL > 0,
+              "CPU boost hold must cover at least one governor period");
+static_assert(PROFILER_DEFAULT_HZ > 0 && PROFILER_DEFAULT_HZ <= PROFILER_MAX_HZ && PROFILER_SAMPLE_CAPACITY > 0 &&
+              PROFILER_TIMER < 4, "Invalid sampling profiler settings");
+static_assert(FEED_LATENCY_FIRST_STEP_ALERT_MS > 0 && FEED_LATENCY_BUCKET_COUNT > 0,
+              "Invalid feed latency settings");
+static_assert(FEED_LATENCY_BUCKET_COUNT <= METRICS_MAX_BUCKETS, "Feed latency buckets exceed METRICS_MAX_BUCKETS");
+static_assert(LOOP_WATCHDOG_MAX_DEPTH >= 2 && LOOP_WATCHDOG_SITES > 0 && LOOP_WATCHDOG_RECENT > 0 &&
+              LOOP_WATCHDOG_HW_TIMEOUT_S > 0, "Invalid loop watchdog settings");
+static_assert(SERIES_MINUTE_SLOTS > 1 && SERIES_HOUR_SLOTS > 1 && SERIES_DAY_SLOTS > 1 &&
+              SERIES_FLASH_OFFSET % INPUT_RECORDER_SECTOR_SIZE == 0, "Invalid time-series store settings");
+static_assert(INPUT_RECORDER_FLASH_BYTES % INPUT_RECORDER_SECTOR_SIZE == 0 &&
+              INPUT_RECORDER_BUFFER_BYTES >= 6 + INPUT_RECORDER_MAX_PAYLOAD &&
+              INPUT_RECORDER_MAX_PAYLOAD >= SERIAL_COMMAND_MAX_LENGTH, "Invalid input recorder settings");
+static_assert(TRACE_BUFFER_EVENTS > 0 && (TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) == 0,
+              "TRACE_BUFFER_EVENTS must be a power of two");
+static_assert(MOTOR_MAINTENANCE_INTERVAL > 0 && SERIAL_PROCESS_INTERVAL > 0 &&
+              RGB_LED_MAINTENANCE_INTERVAL > 0 && TOUCH_SENSOR_MAINTENANCE_INTERVAL > 0 &&
+              FEEDING_SCHEDULE_MONITOR_INTERVAL > 0 && WIFI_CONNECTION_CHECK_INTERVAL > 0,
+              "Task intervals must be non-zero");
+static_assert(TIMEZONE_TABLE_YEARS >= 2 && TIMEZONE_TABLE_YEARS <= 64, "TIMEZONE_TABLE_YEARS must be 2-64");
+static_assert(MAX_SCHEDULED_FEEDINGS > 0, "At least one schedule slot is required");
+static_assert(FEEDING_SCHEDULE_TRIGGER_WINDOW * 1000UL > FEEDING_SCHEDULE_MONITOR_INTERVAL,
+              "FEEDING_SCHEDULE_TRIGGER_WINDOW must span at least one schedule monitor tick");
+static_assert(WEB_RATE_LIMIT_CLIENTS > 0 && WEB_RATE_READ_BURST > 0 && WEB_RATE_MUTATE_BURST > 0 &&
+              WEB_RATE_FEED_BURST > 0 && WEB_RATE_FEED_BURST * WEB_RATE_FEED_INTERVAL_MS < 0x7FFFFFFF,
+              "Invalid web rate limits");
+static_assert(WEB_ADMISSION_BUSY_MS_PER_S > 0 && WEB_ADMISSION_BUSY_MS_PER_S <= 1000 &&
+              WEB_ADMISSION_BUSY_BURST_MS > 0 && WEB_ADMISSION_BUSY_BURST_MS < 0x7FFFFFFF / 1000,
+              "Invalid web admission budget");
+static_assert(WEB_JSON_SCHEDULES_CAPACITY >= MAX_SCHEDULED_FEEDINGS * 140,
+              "WEB_JSON_SCHEDULES_CAPACITY too small for MAX_SCHEDULED_FEEDINGS entries");
+static_assert(WEB_REQUEST_ARENA_SIZE >= WEB_JSON_SCHEDULES_CAPACITY + 64 && WEB_REQUEST_ARENA_SIZE >= WEB_JSON_CONFIG_CAPACITY + 64,
+              "WEB_REQUEST_ARENA_SIZE must hold the largest JSON response");
 
 #endif // CONFIG_H
\ No newline at end of file
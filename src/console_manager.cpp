@@ -49,6 +49,12 @@ void ConsoleManager::Console::print(const __FlashStringHelper* message) {
     }
 }
 
+void ConsoleManager::Console::print(const char* message) {
+    if (ConsoleManager::isLoggingEnabled) {
+        Serial.print(message);
+    }
+}
+
 void ConsoleManager::Console::println(const String& message) {
     if (ConsoleManager::isLoggingEnabled) {
         Serial.println(message);
@@ -61,6 +67,12 @@ void ConsoleManager::Console::println(const __FlashStringHelper* message) {
     }
 }
 
+void ConsoleManager::Console::println(const char* message) {
+    if (ConsoleManager::isLoggingEnabled) {
+        Serial.println(message);
+    }
+}
+
 /**
  * Console::printR methods (always print - Response mode)
  */
@@ -72,10 +84,18 @@ void ConsoleManager::Console::printR(const __FlashStringHelper* message) {
     Serial.print(message);
 }
 
+void ConsoleManager::Console::printR(const char* message) {
+    Serial.print(message);
+}
+
 void ConsoleManager::Console::printlnR(const String& message) {
     Serial.println(message);
 }
 
 void ConsoleManager::Console::printlnR(const __FlashStringHelper* message) {
     Serial.println(message);
-}
\ No newline at end of file
+}
+
+void ConsoleManager::Console::printlnR(const char* message) {
+    Serial.println(message);
+}
@@ -27,14 +27,19 @@ public:
         // Standard output (respect logging state)
         static void print(const String& message);
         static void print(const __FlashStringHelper* message);
+        static void print(const char* message);
         static void println(const String& message);
         static void println(const __FlashStringHelper* message);
+        static void println(const char* message);
         
         // Response output (always print, regardless of logging state)
+        // const char* overloads take literals and FixedString::c_str() without a String copy
         static void printR(const String& message);
         static void printR(const __FlashStringHelper* message);
+        static void printR(const char* message);
         static void printlnR(const String& message);
         static void printlnR(const __FlashStringHelper* message);
+        static void printlnR(const char* message);
     };
 };
 
@@ -0,0 +1,214 @@
+#include "cpu_governor.h"
+#include "console_manager.h"
+
+/**
+ * CPU Frequency Governor Implementation
+ *
+ * Everything runs in the loop task (web handlers and the governor task),
+ * so no locking is needed. setCpuFrequencyMhz() itself keeps micros(),
+ * millis() and the UART baud correct.
+ */
+
+CpuGovernor::CpuGovernor()
+    : enabled(false),
+      isInitialized(false),
+      frequencyMhz(0),
+      boostUntil(0),
+      lastAccountMs(0),
+      switchCount(0),
+      boostCount(0),
+      chargeSavedMaMs(0) {
+    for (uint8_t i = 0; i < LEVEL_COUNT; i++) {
+        timeAtMs[i] = 0;
+    }
+}
+
+/**
+ * Start accounting and drop to the idle frequency if scaling is enabled
+ *
+ * @param enabled: Scaling state (cpu.scaling)
+ */
+void CpuGovernor::begin(bool enabled) {
+    frequencyMhz = getCpuFrequencyMhz();
+    lastAccountMs = millis();
+    isInitialized = true;
+
+    Console::printR(F("CPU governor: "));
+    Console::printR(String(frequencyMhz));
+    Console::printlnR(F(" MHz at boot"));
+
+    setEnabled(enabled);
+}
+
+/**
+ * Enable/disable scaling (disabled = fixed boost frequency)
+ */
+void CpuGovernor::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    if (!isInitialized) {
+        return;
+    }
+
+    // Disabled or still boosted: boost frequency, update() drops it later
+    if (!enabled || (long)(millis() - boostUntil) < 0) {
+        setFrequency(CPU_BOOST_FREQ_MHZ);
+    } else {
+        setFrequency(CPU_IDLE_FREQ_MHZ);
+    }
+}
+
+bool CpuGovernor::isEnabled() const {
+    return enabled;
+}
+
+/**
+ * Run at the boost frequency for at least holdMs from now
+ *
+ * @param holdMs: Boost duration after this call
+ */
+void CpuGovernor::boost(unsigned long holdMs) {
+    boostCount++;
+    unsigned long until = millis() + holdMs;
+    if ((long)(until - boostUntil) > 0) {
+        boostUntil = until;
+    }
+    if (isInitialized) {
+        setFrequency(CPU_BOOST_FREQ_MHZ);
+    }
+}
+
+/**
+ * Expire the boost and account time; call from the governor task
+ */
+void CpuGovernor::update() {
+    if (!isInitialized) {
+        return;
+    }
+    account();
+    if (enabled && frequencyMhz != CPU_IDLE_FREQ_MHZ && (long)(millis() - boostUntil) >= 0) {
+        setFrequency(CPU_IDLE_FREQ_MHZ);
+    }
+}
+
+/**
+ * Switch the CPU clock (no-op if already there)
+ *
+ * @param mhz: 80, 160 or 240
+ */
+void CpuGovernor::setFrequency(uint32_t mhz) {
+    if (mhz == frequencyMhz) {
+        return;
+    }
+    account();  // Charge the elapsed time to the old frequency
+    if (!setCpuFrequencyMhz(mhz)) {
+        Console::printlnR(F("CPU governor: ERROR - frequency change rejected"));
+        return;
+    }
+    frequencyMhz = mhz;
+    switchCount++;
+}
+
+/**
+ * Add the time since the last call to the current frequency
+ */
+void CpuGovernor::account() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - lastAccountMs;
+    lastAccountMs = now;
+
+    timeAtMs[levelIndex(frequencyMhz)] += elapsed;
+    int savedMa = (int)currentMa(CPU_BOOST_FREQ_MHZ) - (int)currentMa(frequencyMhz);
+    if (savedMa > 0) {
+        chargeSavedMaMs += (uint64_t)savedMa * elapsed;
+    }
+}
+
+/**
+ * @return: Current CPU frequency in MHz
+ */
+uint32_t CpuGovernor::getFrequencyMhz() const {
+    return frequencyMhz;
+}
+
+/**
+ * @return: Time spent at the given frequency (80/160/240 MHz) in seconds
+ */
+uint32_t CpuGovernor::getTimeAtSeconds(uint32_t mhz) const {
+    return (uint32_t)(timeAtMs[levelIndex(mhz)] / 1000);
+}
+
+/**
+ * @return: Frequency changes since begin()
+ */
+uint32_t CpuGovernor::getSwitchCount() const {
+    return switchCount;
+}
+
+/**
+ * @return: boost() calls since begin()
+ */
+uint32_t CpuGovernor::getBoostCount() const {
+    return boostCount;
+}
+
+/**
+ * @return: Estimated energy saved against a fixed CPU_BOOST_FREQ_MHZ in mWh
+ */
+float CpuGovernor::getEnergySavedMwh() const {
+    // mA x ms x V = uJ; 1 mWh = 3.6e6 uJ
+    return (float)chargeSavedMaMs * CPU_SUPPLY_VOLTAGE / 3600000.0f;
+}
+
+/**
+ * Map a frequency to its telemetry slot (unknown values count as 240)
+ */
+uint8_t CpuGovernor::levelIndex(uint32_t mhz) {
+    if (mhz <= 80) return 0;
+    if (mhz <= 160) return 1;
+    return 2;
+}
+
+/**
+ * Estimated module current at a frequency (config.h datasheet values)
+ */
+uint16_t CpuGovernor::currentMa(uint32_t mhz) {
+    static const uint16_t CURRENT_MA[LEVEL_COUNT] = {
+        CPU_CURRENT_80MHZ_MA, CPU_CURRENT_160MHZ_MA, CPU_CURRENT_240MHZ_MA };
+    return CURRENT_MA[levelIndex(mhz)];
+}
+
+/**
+ * Print frequency, time per frequency and the energy estimate
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void CpuGovernor::printStatus(Print& out) const {
+    static const uint32_t LEVEL_MHZ[LEVEL_COUNT] = { 80, 160, 240 };
+
+    out.println(F("CPU Governor Status:"));
+    out.print(F("  Scaling: "));
+    out.println(enabled ? "ENABLED" : "DISABLED");
+    out.print(F("  Frequency: "));
+    out.print(frequencyMhz);
+    out.print(F(" MHz (idle "));
+    out.print(CPU_IDLE_FREQ_MHZ);
+    out.print(F(", boost "));
+    out.print(CPU_BOOST_FREQ_MHZ);
+    out.println(F(")"));
+
+    for (uint8_t i = 0; i < LEVEL_COUNT; i++) {
+        out.print(F("  Time at "));
+        out.print(LEVEL_MHZ[i]);
+        out.print(F(" MHz: "));
+        out.print((uint32_t)(timeAtMs[i] / 1000));
+        out.println(F("s"));
+    }
+
+    out.print(F("  Switches: "));
+    out.print(switchCount);
+    out.print(F(", Boosts: "));
+    out.println(boostCount);
+    out.print(F("  Energy Saved (est.): "));
+    out.print(getEnergySavedMwh(), 1);
+    out.println(F(" mWh"));
+}
@@ -0,0 +1,105 @@
+#ifndef CPU_GOVERNOR_H
+#define CPU_GOVERNOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * CPU Frequency Governor
+ *
+ * Runs the CPU at CPU_IDLE_FREQ_MHZ while the feeder only polls touch and
+ * serial, and boosts to CPU_BOOST_FREQ_MHZ on demand (web requests call
+ * boost()). The boost expires CPU_BOOST_HOLD_MS after the last request;
+ * update() drops the frequency again and accounts the time per frequency.
+ *
+ * Only 80/160/240 MHz are used, so the APB clock stays at 80 MHz and the
+ * RMT step waveform, esp_timer, UART and LEDC keep their timing across
+ * switches (see config.h).
+ *
+ * Telemetry: time at each frequency, switch/boost counts and the energy
+ * saved against a fixed CPU_BOOST_FREQ_MHZ, estimated from the datasheet
+ * currents in config.h.
+ */
+class CpuGovernor {
+public:
+    CpuGovernor();
+
+    /**
+     * Start accounting and drop to the idle frequency if scaling is enabled
+     *
+     * @param enabled: Scaling state (cpu.scaling)
+     */
+    void begin(bool enabled);
+
+    /**
+     * Enable/disable scaling (disabled = fixed boost frequency)
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * Run at the boost frequency for at least holdMs from now
+     *
+     * @param holdMs: Boost duration after this call
+     */
+    void boost(unsigned long holdMs = CPU_BOOST_HOLD_MS);
+
+    /**
+     * Expire the boost and account time; call from the governor task
+     */
+    void update();
+
+    /**
+     * @return: Current CPU frequency in MHz
+     */
+    uint32_t getFrequencyMhz() const;
+
+    /**
+     * @return: Time spent at the given frequency (80/160/240 MHz) in seconds
+     */
+    uint32_t getTimeAtSeconds(uint32_t mhz) const;
+
+    /**
+     * @return: Frequency changes since begin()
+     */
+    uint32_t getSwitchCount() const;
+
+    /**
+     * @return: boost() calls since begin()
+     */
+    uint32_t getBoostCount() const;
+
+    /**
+     * @return: Estimated energy saved against a fixed CPU_BOOST_FREQ_MHZ in mWh
+     */
+    float getEnergySavedMwh() const;
+
+    /**
+     * Print frequency, time per frequency and the energy estimate
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    static const uint8_t LEVEL_COUNT = 3;    // 80, 160, 240 MHz
+
+    bool enabled;
+    bool isInitialized;
+    uint32_t frequencyMhz;
+    unsigned long boostUntil;
+    unsigned long lastAccountMs;
+
+    // Telemetry
+    uint64_t timeAtMs[LEVEL_COUNT];
+    uint32_t switchCount;
+    uint32_t boostCount;
+    uint64_t chargeSavedMaMs;               // Saved charge in mA x ms (x voltage = energy)
+
+    void setFrequency(uint32_t mhz);
+    void account();
+    static uint8_t levelIndex(uint32_t mhz);
+    static uint16_t currentMa(uint32_t mhz);
+};
+
+#endif // CPU_GOVERNOR_H
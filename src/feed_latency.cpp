@@ -0,0 +1,282 @@
+#include "feed_latency.h"
+#include "console_manager.h"
+#include "metrics_registry.h"
+
+/**
+ * Feed Latency Tracker Implementation
+ *
+ * Everything is recorded from the loop task (FeedingController), so plain
+ * counters are enough.
+ */
+
+namespace {
+
+const char* const SOURCE_NAMES[FeedLatencyTracker::SOURCE_COUNT] = {
+    "touch", "web", "serial", "schedule"
+};
+
+const char* const STAGE_NAMES[FeedLatencyTracker::STAGE_COUNT] = {
+    "firstStep", "complete"
+};
+
+// Same measurements for /metrics; never reset (FEED LATENCY RESET only
+// clears the tracker)
+#define FEED_LATENCY_SERIES(name, help, source) \
+    { name, help, "source=\"" source "\"", FEED_LATENCY_BUCKETS_MS, FEED_LATENCY_BUCKET_COUNT }
+
+MetricsRegistry::Histogram latencyMetrics[FeedLatencyTracker::STAGE_COUNT][FeedLatencyTracker::SOURCE_COUNT] = {
+    {
+        FEED_LATENCY_SERIES("feeder_feed_first_step_latency_ms", "Feed trigger to first step", "touch"),
+        FEED_LATENCY_SERIES("feeder_feed_first_step_latency_ms", "Feed trigger to first step", "web"),
+        FEED_LATENCY_SERIES("feeder_feed_first_step_latency_ms", "Feed trigger to first step", "serial"),
+        FEED_LATENCY_SERIES("feeder_feed_first_step_latency_ms", "Feed trigger to first step", "schedule")
+    },
+    {
+        FEED_LATENCY_SERIES("feeder_feed_complete_latency_ms", "Feed trigger to move complete", "touch"),
+        FEED_LATENCY_SERIES("feeder_feed_complete_latency_ms", "Feed trigger to move complete", "web"),
+        FEED_LATENCY_SERIES("feeder_feed_complete_latency_ms", "Feed trigger to move complete", "serial"),
+        FEED_LATENCY_SERIES("feeder_feed_complete_latency_ms", "Feed trigger to move complete", "schedule")
+    }
+};
+
+#undef FEED_LATENCY_SERIES
+
+MetricsRegistry::Counter alertMetrics[FeedLatencyTracker::STAGE_COUNT][FeedLatencyTracker::SOURCE_COUNT] = {
+    {
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"touch\",stage=\"firstStep\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"web\",stage=\"firstStep\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"serial\",stage=\"firstStep\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"schedule\",stage=\"firstStep\"" }
+    },
+    {
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"touch\",stage=\"complete\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"web\",stage=\"complete\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"serial\",stage=\"complete\"" },
+        { "feeder_feed_latency_alerts_total", "Feed latencies over their alert limit", "source=\"schedule\",stage=\"complete\"" }
+    }
+};
+
+MetricsRegistry::Counter cancelMetrics[FeedLatencyTracker::SOURCE_COUNT] = {
+    { "feeder_feed_cancelled_total", "Feedings cancelled before completion", "source=\"touch\"" },
+    { "feeder_feed_cancelled_total", "Feedings cancelled before completion", "source=\"web\"" },
+    { "feeder_feed_cancelled_total", "Feedings cancelled before completion", "source=\"serial\"" },
+    { "feeder_feed_cancelled_total", "Feedings cancelled before completion", "source=\"schedule\"" }
+};
+
+} // namespace
+
+FeedLatencyTracker::Trigger FeedLatencyTracker::Trigger::now(Source source) {
+    Trigger trigger;
+    trigger.source = source;
+    trigger.timeUs = micros();
+    return trigger;
+}
+
+FeedLatencyTracker::Trigger FeedLatencyTracker::Trigger::secondsAgo(Source source, uint32_t seconds) {
+    Trigger trigger = now(source);
+    trigger.timeUs -= seconds * 1000000UL;
+    return trigger;
+}
+
+FeedLatencyTracker::FeedLatencyTracker() {
+    reset();
+}
+
+/**
+ * Clear all histograms
+ */
+void FeedLatencyTracker::reset() {
+    memset(histograms, 0, sizeof(histograms));
+    memset(cancelCount, 0, sizeof(cancelCount));
+}
+
+/**
+ * Alert limit for trigger -> first step (without allowance)
+ */
+uint32_t FeedLatencyTracker::getFirstStepLimitMs(Source source) {
+    // Deadlines are polled by the schedule monitor with a 1 s RTC
+    if (source == SOURCE_SCHEDULE) {
+        return FEED_LATENCY_FIRST_STEP_ALERT_MS + FEEDING_SCHEDULE_MONITOR_INTERVAL + 1000;
+    }
+    return FEED_LATENCY_FIRST_STEP_ALERT_MS;
+}
+
+/**
+ * Record trigger -> first step
+ *
+ * @param source: Trigger source
+ * @param latencyMs: Measured latency
+ * @param allowanceMs: Expected extra delay (e.g. waiting for homing)
+ */
+void FeedLatencyTracker::recordFirstStep(Source source, uint32_t latencyMs, uint32_t allowanceMs) {
+    record(source, STAGE_FIRST_STEP, latencyMs, getFirstStepLimitMs(source) + allowanceMs);
+}
+
+/**
+ * Record trigger -> move complete
+ *
+ * @param source: Trigger source
+ * @param latencyMs: Measured latency
+ * @param allowanceMs: Expected move time plus any extra delay
+ */
+void FeedLatencyTracker::recordComplete(Source source, uint32_t latencyMs, uint32_t allowanceMs) {
+    record(source, STAGE_COMPLETE, latencyMs,
+           getFirstStepLimitMs(source) + allowanceMs + FEED_LATENCY_COMPLETE_MARGIN_MS);
+}
+
+/**
+ * Count a feeding cancelled before completion
+ */
+void FeedLatencyTracker::recordCancel(Source source) {
+    if (source < SOURCE_COUNT) {
+        cancelCount[source]++;
+        cancelMetrics[source].inc();
+    }
+}
+
+void FeedLatencyTracker::record(Source source, Stage stage, uint32_t latencyMs, uint32_t limitMs) {
+    if (source >= SOURCE_COUNT) {
+        return;
+    }
+    Histogram& histogram = histograms[source][stage];
+
+    uint8_t bucket = 0;
+    while (bucket < FEED_LATENCY_BUCKET_COUNT && latencyMs > FEED_LATENCY_BUCKETS_MS[bucket]) {
+        bucket++;
+    }
+    histogram.buckets[bucket]++;
+    histogram.count++;
+    histogram.sumMs += latencyMs;
+    histogram.lastMs = latencyMs;
+    if (latencyMs > histogram.maxMs) {
+        histogram.maxMs = latencyMs;
+    }
+
+    latencyMetrics[stage][source].observe(latencyMs);
+
+    histogram.lastAlerted = latencyMs > limitMs;
+    if (histogram.lastAlerted) {
+        histogram.alerts++;
+        alertMetrics[stage][source].inc();
+        Console::printR(F("⚠ Feed latency alert: "));
+        Console::printR(SOURCE_NAMES[source]);
+        Console::printR(F(" "));
+        Console::printR(STAGE_NAMES[stage]);
+        Console::printR(F(" took "));
+        Console::printR(String(latencyMs));
+        Console::printR(F(" ms (limit "));
+        Console::printR(String(limitMs));
+        Console::printlnR(F(" ms)"));
+    }
+}
+
+const FeedLatencyTracker::Histogram& FeedLatencyTracker::getHistogram(Source source, Stage stage) const {
+    return histograms[source][stage];
+}
+
+uint32_t FeedLatencyTracker::getCancelCount(Source source) const {
+    return cancelCount[source];
+}
+
+const char* FeedLatencyTracker::getSourceName(Source source) {
+    return source < SOURCE_COUNT ? SOURCE_NAMES[source] : "unknown";
+}
+
+/**
+ * Write the histograms as a JSON object
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void FeedLatencyTracker::writeJson(Print& out) const {
+    out.print(F("{\"bucketsMs\":["));
+    for (uint8_t i = 0; i < FEED_LATENCY_BUCKET_COUNT; i++) {
+        if (i > 0) {
+            out.print(',');
+        }
+        out.print(FEED_LATENCY_BUCKETS_MS[i]);
+    }
+    out.print(F("],\"firstStepAlertMs\":"));
+    out.print(FEED_LATENCY_FIRST_STEP_ALERT_MS);
+    out.print(F(",\"completeMarginMs\":"));
+    out.print(FEED_LATENCY_COMPLETE_MARGIN_MS);
+    out.print(F(",\"sources\":{"));
+
+    for (uint8_t source = 0; source < SOURCE_COUNT; source++) {
+        if (source > 0) {
+            out.print(',');
+        }
+        out.print('"');
+        out.print(SOURCE_NAMES[source]);
+        out.print(F("\":{\"cancelled\":"));
+        out.print(cancelCount[source]);
+        for (uint8_t stage = 0; stage < STAGE_COUNT; stage++) {
+            out.print(F(",\""));
+            out.print(STAGE_NAMES[stage]);
+            out.print(F("\":"));
+            writeHistogramJson(out, histograms[source][stage]);
+        }
+        out.print('}');
+    }
+    out.print(F("}}"));
+}
+
+void FeedLatencyTracker::writeHistogramJson(Print& out, const Histogram& histogram) {
+    out.print(F("{\"count\":"));
+    out.print(histogram.count);
+    out.print(F(",\"avgMs\":"));
+    out.print(histogram.count ? (uint32_t)(histogram.sumMs / histogram.count) : 0);
+    out.print(F(",\"maxMs\":"));
+    out.print(histogram.maxMs);
+    out.print(F(",\"lastMs\":"));
+    out.print(histogram.lastMs);
+    out.print(F(",\"alerts\":"));
+    out.print(histogram.alerts);
+    out.print(F(",\"alerting\":"));
+    out.print(histogram.lastAlerted ? "true" : "false");
+    out.print(F(",\"buckets\":["));
+    for (uint8_t i = 0; i <= FEED_LATENCY_BUCKET_COUNT; i++) {
+        if (i > 0) {
+            out.print(',');
+        }
+        out.print(histogram.buckets[i]);
+    }
+    out.print(F("]}"));
+}
+
+/**
+ * Print count/avg/max/last and alerts per source and stage
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void FeedLatencyTracker::printStatus(Print& out) const {
+    out.println(F("Feed Latency (trigger -> first step / complete):"));
+    for (uint8_t source = 0; source < SOURCE_COUNT; source++) {
+        out.print(F("  "));
+        out.print(SOURCE_NAMES[source]);
+        out.print(F(" (first step limit "));
+        out.print(getFirstStepLimitMs((Source)source));
+        out.print(F(" ms, cancelled "));
+        out.print(cancelCount[source]);
+        out.println(F("):"));
+
+        for (uint8_t stage = 0; stage < STAGE_COUNT; stage++) {
+            const Histogram& histogram = histograms[source][stage];
+            out.print(F("    "));
+            out.print(STAGE_NAMES[stage]);
+            out.print(F(": "));
+            if (histogram.count == 0) {
+                out.println(F("no samples"));
+                continue;
+            }
+            out.print(histogram.count);
+            out.print(F(" samples, avg "));
+            out.print((uint32_t)(histogram.sumMs / histogram.count));
+            out.print(F(" ms, max "));
+            out.print(histogram.maxMs);
+            out.print(F(" ms, last "));
+            out.print(histogram.lastMs);
+            out.print(F(" ms, alerts "));
+            out.println(histogram.alerts);
+        }
+    }
+}
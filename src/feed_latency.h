@@ -0,0 +1,128 @@
+#ifndef FEED_LATENCY_H
+#define FEED_LATENCY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Feed Latency Tracker
+ *
+ * Measures how long a feeding request takes to get food moving, per
+ * trigger source: trigger -> first step and trigger -> move complete.
+ * The trigger time travels with the request (startFeeding() ->
+ * FeedingController), the step engine stamps the first step and the end
+ * of the move, and FeedingController reports both here.
+ *
+ * Each source/stage pair keeps a fixed-bucket histogram
+ * (FEED_LATENCY_BUCKETS_MS) with count, average, max and last value.
+ * Latencies over the alert limit are counted and logged:
+ *   - first step: FEED_LATENCY_FIRST_STEP_ALERT_MS (schedule triggers also
+ *     get the schedule monitor period, they are measured from the deadline)
+ *   - complete: first step limit + estimated move time +
+ *     FEED_LATENCY_COMPLETE_MARGIN_MS
+ */
+class FeedLatencyTracker {
+public:
+    /**
+     * Where a feeding request came from
+     */
+    enum Source : uint8_t {
+        SOURCE_TOUCH,           // Long press
+        SOURCE_WEB,             // /api/feed, /api/feed-test
+        SOURCE_SERIAL,          // FEED command
+        SOURCE_SCHEDULE,        // Schedule deadline
+        SOURCE_COUNT
+    };
+
+    enum Stage : uint8_t {
+        STAGE_FIRST_STEP,
+        STAGE_COMPLETE,
+        STAGE_COUNT
+    };
+
+    /**
+     * Source and arrival time of a feeding request
+     */
+    struct Trigger {
+        Source source;
+        uint32_t timeUs;        // micros() when the request arrived
+
+        static Trigger now(Source source);
+        static Trigger secondsAgo(Source source, uint32_t seconds);
+    };
+
+    /**
+     * Latency distribution of one source/stage pair
+     */
+    struct Histogram {
+        uint32_t buckets[FEED_LATENCY_BUCKET_COUNT + 1];   // Last one: over the largest bound
+        uint32_t count;
+        uint32_t alerts;
+        uint32_t lastMs;
+        uint32_t maxMs;
+        uint64_t sumMs;
+        bool lastAlerted;       // Last sample was over its limit
+    };
+
+    FeedLatencyTracker();
+
+    /**
+     * Record trigger -> first step
+     *
+     * @param source: Trigger source
+     * @param latencyMs: Measured latency
+     * @param allowanceMs: Expected extra delay (e.g. waiting for homing)
+     */
+    void recordFirstStep(Source source, uint32_t latencyMs, uint32_t allowanceMs = 0);
+
+    /**
+     * Record trigger -> move complete
+     *
+     * @param source: Trigger source
+     * @param latencyMs: Measured latency
+     * @param allowanceMs: Expected move time plus any extra delay
+     */
+    void recordComplete(Source source, uint32_t latencyMs, uint32_t allowanceMs);
+
+    /**
+     * Count a feeding cancelled before completion
+     */
+    void recordCancel(Source source);
+
+    /**
+     * Clear all histograms
+     */
+    void reset();
+
+    const Histogram& getHistogram(Source source, Stage stage) const;
+    uint32_t getCancelCount(Source source) const;
+    static const char* getSourceName(Source source);
+
+    /**
+     * Alert limit for trigger -> first step (without allowance)
+     */
+    static uint32_t getFirstStepLimitMs(Source source);
+
+    /**
+     * Write the histograms as a JSON object
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    void writeJson(Print& out) const;
+
+    /**
+     * Print count/avg/max/last and alerts per source and stage
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    Histogram histograms[SOURCE_COUNT][STAGE_COUNT];
+    uint32_t cancelCount[SOURCE_COUNT];
+
+    void record(Source source, Stage stage, uint32_t latencyMs, uint32_t limitMs);
+    static void writeHistogramJson(Print& out, const Histogram& histogram);
+};
+
+#endif // FEED_LATENCY_H
@@ -1,4 +1,5 @@
 #include "feeding_controller.h"
+#include "trace_buffer.h"
 
 /**
  * Constructor: Initialize feeding controller with stepper motor reference
@@ -6,7 +7,20 @@
  * @param stepperMotor: Pointer to initialized StepperMotor instance
  */
 FeedingController::FeedingController(StepperMotor* stepperMotor) 
-    : motor(stepperMotor), isInitialized(false) {
+    : motor(stepperMotor), isInitialized(false), dispenseProfile(DEFAULT_DISPENSE_PROFILE),
+      pendingPortions(0), homingRequested(false),
+      vibration(nullptr), deliverySensor(nullptr),
+      agitationEnabled(DEFAULT_AGITATION_ENABLED), agitationDuty(DEFAULT_AGITATION_DUTY),
+      appliedDuty(0), agitating(false), tracedPhase(StepperMotor::MOTION_IDLE),
+      latencyTracker(nullptr), latencyPending(false), firstStepRecorded(false),
+      latencyAllowanceMs(0), expectedMoveMs(0) {
+    agitationSegment.intensity = 0;
+    agitationSegment.onMs = AGITATION_PULSE_ON_MS;
+    agitationSegment.offMs = AGITATION_PULSE_OFF_MS;
+    agitationSegment.repeat = 0;  // Until the deceleration ramp
+    agitationPattern.name = "agitate";
+    agitationPattern.segments = &agitationSegment;
+    agitationPattern.segmentCount = 1;
 }
 
 /**
@@ -79,9 +93,10 @@ bool FeedingController::dispenseFood(int portions) {
  * Dispense food portions (non-blocking operation)
  * 
  * @param portions: Number of portions to dispense
+ * @param trigger: Request source and arrival time for latency tracking (optional)
  * @return: true if movement started successfully, false if error
  */
-bool FeedingController::dispenseFoodAsync(int portions) {
+bool FeedingController::dispenseFoodAsync(int portions, const FeedLatencyTracker::Trigger* trigger) {
     if (!isInitialized || !motor) {
         Serial.println(F("ERROR: FeedingController not initialized"));
         return false;
@@ -102,16 +117,388 @@ bool FeedingController::dispenseFoodAsync(int portions) {
     Serial.print(portions);
     Serial.println(F(" food portion(s)..."));
     
+    latencyPending = trigger && latencyTracker;
+    if (latencyPending) {
+        latencyTrigger = *trigger;
+        firstStepRecorded = false;
+        latencyAllowanceMs = 0;
+    }
+    
+    // Home before the first feeding if boot homing did not succeed
+    if (motor->hasIndexSensor() && !motor->isHomed() && (motor->isHoming() || !homingRequested)) {
+        homingRequested = true;
+        if (motor->isHoming() || motor->startHoming()) {
+            Serial.println(F("Waiting for auger homing before dispensing"));
+            pendingPortions = portions;
+            agitating = false;
+            return true;
+        }
+    }
+    
+    startDispense(portions);
+    return true;
+}
+
+/**
+ * Drop a feeding that is still waiting for homing
+ * The caller stops the motor (which also ends homing)
+ */
+void FeedingController::cancel() {
+    // Homing cut short: the next feeding tries again
+    if (pendingPortions > 0) {
+        homingRequested = false;
+    }
+    pendingPortions = 0;
+    
+    if (latencyPending) {
+        latencyPending = false;
+        latencyTracker->recordCancel(latencyTrigger.source);
+    }
+}
+
+/**
+ * Async feeding completed: record trigger -> first step / complete
+ * Call once the motor stopped (feeding monitor)
+ */
+void FeedingController::finishFeeding() {
+    if (!latencyPending) {
+        return;
+    }
+    latencyPending = false;
+    
+    // A short move can end between two update() calls
+    recordFirstStep();
+    
+    uint32_t endUs;
+    if (!motor->getMoveEndMicros(endUs)) {
+        endUs = micros();
+    }
+    latencyTracker->recordComplete(latencyTrigger.source, (endUs - latencyTrigger.timeUs) / 1000,
+                                   latencyAllowanceMs + expectedMoveMs);
+}
+
+/**
+ * Report the first step of the dispense move once the step engine output it
+ */
+void FeedingController::recordFirstStep() {
+    uint32_t firstStepUs;
+    if (firstStepRecorded || pendingPortions > 0 || !motor->getMoveFirstStepMicros(firstStepUs)) {
+        return;
+    }
+    firstStepRecorded = true;
+    latencyTracker->recordFirstStep(latencyTrigger.source, (firstStepUs - latencyTrigger.timeUs) / 1000,
+                                    latencyAllowanceMs);
+}
+
+/**
+ * Set the tracker that receives feed trigger latencies
+ * 
+ * @param tracker: Latency tracker (nullptr disables tracking)
+ */
+void FeedingController::setLatencyTracker(FeedLatencyTracker* tracker) {
+    latencyTracker = tracker;
+}
+
+/**
+ * Start the dispensing move for validated portions
+ * 
+ * @param portions: Number of portions to dispense
+ */
+void FeedingController::startDispense(int portions) {
     // Calculate steps and apply direction configuration
-    int steps = portionsToSteps(portions);
+    long steps = portionsToSteps(portions);
+    if (motor->isHomed()) {
+        steps = alignToFlight(steps);
+    }
     long currentPos = motor->getCurrentPosition();
     
     // Apply motor direction: if CCW, steps should be negative
-    int adjustedSteps = motor->getMotorDirection() ? steps : -steps;
+    long adjustedSteps = motor->getMotorDirection() ? steps : -steps;
     
-    motor->moveToPositionAsync(currentPos + adjustedSteps);
+    const DispenseProfile& profile = DISPENSE_PROFILES[dispenseProfile];
+    if (profile.strokeSteps) {
+        Serial.print(F("Dispense profile: "));
+        Serial.print(profile.name);
+        Serial.print(F(" (+"));
+        Serial.print(profile.strokeSteps);
+        Serial.print(F("/-"));
+        Serial.print(profile.reverseSteps);
+        Serial.println(F(" steps)"));
+    }
     
-    return true;
+    motor->moveToPositionAsync(currentPos + adjustedSteps, profile.strokeSteps, profile.reverseSteps);
+    
+    // Completion alert limit; estimated after the start so it adds no latency
+    if (latencyPending) {
+        expectedMoveMs = motor->estimateMoveMs(adjustedSteps, profile.strokeSteps, profile.reverseSteps);
+    }
+    
+    // Agitation starts with the acceleration ramp (see update())
+    agitating = false;
+    appliedDuty = agitationDuty;
+}
+
+/**
+ * Round a feeding so it ends on an auger flight boundary
+ * Boundaries are every STEPS_PER_REVOLUTION / AUGER_FLIGHTS steps from the
+ * index (plus AUGER_FLIGHT_OFFSET_STEPS); the nearest one ahead is used
+ * 
+ * @param steps: Requested steps in the feeding direction
+ * @return: Adjusted steps (within half a flight of the request, > 0)
+ */
+long FeedingController::alignToFlight(long steps) const {
+    const long flight = STEPS_PER_REVOLUTION / AUGER_FLIGHTS;
+    
+    // Auger angle measured in the feeding direction
+    long angle = motor->getAbsolutePosition();
+    if (!motor->getMotorDirection()) {
+        angle = (STEPS_PER_REVOLUTION - angle) % STEPS_PER_REVOLUTION;
+    }
+    
+    long end = angle + steps - AUGER_FLIGHT_OFFSET_STEPS;
+    long boundary = ((end + flight / 2) / flight) * flight + AUGER_FLIGHT_OFFSET_STEPS;
+    long aligned = boundary - angle;
+    if (aligned <= 0) {
+        aligned += flight;
+    }
+    
+    if (aligned != steps) {
+        Serial.print(F("Aligned to auger flight: "));
+        Serial.print(aligned);
+        Serial.println(F(" steps"));
+    }
+    return aligned;
+}
+
+/**
+ * Set the vibration motor used as hopper agitator
+ * 
+ * @param vibrationMotor: Vibration motor (nullptr disables agitation)
+ */
+void FeedingController::setVibrationMotor(VibrationMotor* vibrationMotor) {
+    vibration = vibrationMotor;
+}
+
+/**
+ * Configure hopper agitation (feed.agitate, feed.agitate.duty)
+ * 
+ * @param enabled: Agitate during async feedings
+ * @param duty: Pulse intensity in percent (capped at AGITATION_MAX_DUTY)
+ */
+void FeedingController::setAgitation(bool enabled, uint8_t duty) {
+    agitationEnabled = enabled;
+    agitationDuty = duty > AGITATION_MAX_DUTY ? AGITATION_MAX_DUTY : duty;
+    
+    if (!enabled && agitating) {
+        stopAgitation();
+    } else if (agitating && (!deliverySensor || appliedDuty < agitationDuty)) {
+        // Open loop runs at the configured duty; closed loop relaxes down to it on its own
+        agitationSegment.intensity = agitationDuty;
+        appliedDuty = agitationDuty;
+    }
+}
+
+/**
+ * Register a delivery sensor for closed-loop agitation
+ * 
+ * @param sensor: Callback (nullptr = open loop, fixed duty)
+ */
+void FeedingController::setDeliverySensor(DeliverySensor sensor) {
+    deliverySensor = sensor;
+}
+
+/**
+ * Follow the stepper motion profile with the agitator
+ * Starts a feeding that waited for homing first.
+ * Pulses during acceleration and cruise, stops for deceleration and at the end.
+ * Called by the feeding monitor task (100ms) while a feeding runs.
+ */
+void FeedingController::update() {
+    if (!isInitialized || !motor) {
+        return;
+    }
+    
+    // Start a feeding that waited for homing (unaligned if homing failed)
+    if (pendingPortions > 0 && !motor->isHoming()) {
+        int portions = pendingPortions;
+        pendingPortions = 0;
+        if (!motor->isHomed()) {
+            // Homing failed: retry before the next feeding
+            homingRequested = false;
+        }
+        if (latencyPending) {
+            latencyAllowanceMs = (micros() - latencyTrigger.timeUs) / 1000;
+        }
+        startDispense(portions);
+    }
+    
+    if (latencyPending) {
+        recordFirstStep();
+    }
+    
+    if (motor->isHoming()) {
+        return;
+    }
+    
+    // Ramp segment changes go to the trace timeline
+    StepperMotor::MotionPhase phase = motor->getMotionPhase();
+    if (phase != tracedPhase) {
+        tracedPhase = phase;
+        TraceBuffer::instant(TraceBuffer::FEED_SEGMENT, phase);
+    }
+    
+    if (!vibration) {
+        return;
+    }
+    
+    if (!agitationEnabled ||
+        (phase != StepperMotor::MOTION_ACCELERATING && phase != StepperMotor::MOTION_CRUISING)) {
+        if (agitating) {
+            stopAgitation();
+        }
+        return;
+    }
+    
+    // Another pattern replaced agitation (e.g. touch feedback): restart once it ends
+    if (agitating && !vibration->isPlaying(agitationPattern)) {
+        agitating = false;
+    }
+    
+    // Let a haptic pattern (e.g. long press feedback) finish before agitating
+    if (!agitating && vibration->getIsVibrating()) {
+        return;
+    }
+    
+    uint8_t duty = appliedDuty;
+    
+    // Closed loop: raise duty while delivery lags the commanded steps, relax once it catches up
+    if (deliverySensor && phase == StepperMotor::MOTION_CRUISING) {
+        long delivered = deliverySensor();
+        long commanded = motor->getMoveStepsCompleted();
+        if (delivered >= 0 && commanded > 0) {
+            long lag = commanded - delivered;
+            if (lag * 100 > commanded * (long)AGITATION_LAG_PERCENT) {
+                duty = duty + AGITATION_DUTY_STEP > AGITATION_MAX_DUTY ? AGITATION_MAX_DUTY : duty + AGITATION_DUTY_STEP;
+            } else if (duty > agitationDuty) {
+                duty = duty - agitationDuty > AGITATION_DUTY_STEP ? duty - AGITATION_DUTY_STEP : agitationDuty;
+            }
+        }
+    }
+    
+    if (!agitating) {
+        startAgitation(duty);
+    } else if (duty != appliedDuty) {
+        // Takes effect at the next on phase; replaying would restart the pulse timing every tick
+        agitationSegment.intensity = duty;
+        appliedDuty = duty;
+    }
+}
+
+/**
+ * Check if the hopper agitator is running
+ * 
+ * @return: true while agitation pulses play
+ */
+bool FeedingController::isAgitating() const {
+    return agitating;
+}
+
+/**
+ * Start agitation pulses
+ * 
+ * @param duty: Pulse intensity in percent
+ */
+void FeedingController::startAgitation(uint8_t duty) {
+    // Detach a previous run from the vibration timer before restarting it
+    if (vibration->isPlaying(agitationPattern)) {
+        vibration->stop();
+    }
+    agitationSegment.intensity = duty;
+    vibration->play(agitationPattern);
+    appliedDuty = duty;
+    agitating = true;
+}
+
+/**
+ * Stop agitation pulses
+ */
+void FeedingController::stopAgitation() {
+    // Only stop our own pattern - another one may have replaced it (e.g. cancel feedback)
+    if (vibration->isPlaying(agitationPattern)) {
+        vibration->stop();
+    }
+    agitating = false;
+}
+
+/**
+ * Select the dispense profile for async feedings (feed.profile)
+ * Applies from the next feeding
+ * 
+ * @param profile: Index into DISPENSE_PROFILES (out of range = ignored)
+ */
+void FeedingController::setDispenseProfile(uint8_t profile) {
+    if (profile < DISPENSE_PROFILE_COUNT) {
+        dispenseProfile = profile;
+    }
+}
+
+/**
+ * Get the selected dispense profile
+ * 
+ * @return: Index into DISPENSE_PROFILES
+ */
+uint8_t FeedingController::getDispenseProfile() const {
+    return dispenseProfile;
+}
+
+/**
+ * Look up a dispense profile by food type name (case-insensitive)
+ * 
+ * @param name: Profile name (e.g. "pellets")
+ * @return: Index into DISPENSE_PROFILES, -1 if unknown
+ */
+int FeedingController::findDispenseProfile(const String& name) {
+    for (uint8_t i = 0; i < DISPENSE_PROFILE_COUNT; i++) {
+        if (name.equalsIgnoreCase(DISPENSE_PROFILES[i].name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Print every dispense profile with its estimated time for one portion
+ * Times come from the motor's current speed/acceleration ramp, so profiles
+ * can be compared before switching food types
+ */
+void FeedingController::printDispenseProfiles() const {
+    int steps = portionsToSteps(1);
+    
+    Serial.print(F("Dispense profiles ("));
+    Serial.print(steps);
+    Serial.println(F(" steps per portion):"));
+    
+    for (uint8_t i = 0; i < DISPENSE_PROFILE_COUNT; i++) {
+        const DispenseProfile& profile = DISPENSE_PROFILES[i];
+        Serial.print(i == dispenseProfile ? F("* ") : F("  "));
+        Serial.print(profile.name);
+        Serial.print(F(": "));
+        if (profile.strokeSteps) {
+            Serial.print(F("+"));
+            Serial.print(profile.strokeSteps);
+            Serial.print(F("/-"));
+            Serial.print(profile.reverseSteps);
+            Serial.print(F(" steps"));
+        } else {
+            Serial.print(F("single stroke"));
+        }
+        if (motor && motor->isReady()) {
+            Serial.print(F(", ~"));
+            Serial.print(motor->estimateMoveMs(steps, profile.strokeSteps, profile.reverseSteps));
+            Serial.print(F(" ms/portion"));
+        }
+        Serial.println();
+    }
 }
 
 /**
@@ -143,6 +530,16 @@ void FeedingController::calibrateFeeder() {
     Serial.print(F("Equivalent to approximately "));
     Serial.print(portions, 1);
     Serial.println(F(" food portions"));
+    
+    // A full turn passes the index once: any drift shows up as a lost-step event
+    if (motor->isHomed()) {
+        Serial.print(F("Auger angle from index: "));
+        Serial.print(motor->getAbsolutePosition());
+        Serial.print(F(" steps, lost-step events: "));
+        Serial.println(motor->getLostStepEvents());
+    } else if (motor->hasIndexSensor()) {
+        Serial.println(F("Auger not homed - run HOME for index-referenced calibration"));
+    }
 }
 
 /**
@@ -188,6 +585,19 @@ void FeedingController::printFeedingStatus() const {
         Serial.println(motor->isRunning() ? F("Yes") : F("No"));
     }
     
+    Serial.print(F("Dispense Profile: "));
+    Serial.println(DISPENSE_PROFILES[dispenseProfile].name);
+    
+    Serial.print(F("Agitation: "));
+    if (!vibration || !agitationEnabled) {
+        Serial.println(F("Off"));
+    } else {
+        Serial.print(agitating ? F("Running at ") : F("Idle, "));
+        Serial.print(agitating ? appliedDuty : agitationDuty);
+        Serial.print(F("% duty"));
+        Serial.println(deliverySensor ? F(" (closed loop)") : F(""));
+    }
+    
     Serial.println(F("================================"));
 }
 
@@ -244,5 +654,14 @@ void FeedingController::printFeedingConfiguration() {
     Serial.println(MAX_FOOD_PORTIONS);
     Serial.print(F("Steps per Revolution: "));
     Serial.println(STEPS_PER_REVOLUTION);
+    Serial.print(F("Agitation Pulse: "));
+    Serial.print(AGITATION_PULSE_ON_MS);
+    Serial.print(F("/"));
+    Serial.print(AGITATION_PULSE_OFF_MS);
+    Serial.print(F(" ms, max duty "));
+    Serial.print(AGITATION_MAX_DUTY);
+    Serial.print(F("% ("));
+    Serial.print(FEEDING_POWER_BUDGET_MA);
+    Serial.println(F(" mA budget)"));
     Serial.println(F("============================="));
 }
\ No newline at end of file
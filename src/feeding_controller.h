@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "stepper_motor.h"
+#include "vibration_motor.h"
+#include "feed_latency.h"
 #include "config.h"
 
 /**
@@ -13,11 +15,75 @@
  * making the system more modular and easier to maintain.
  * 
  * Uses global configuration from config.h for feeding parameters.
+ * 
+ * Hopper agitation: during async feedings the vibration motor pulses while
+ * the stepper accelerates and cruises and stops for deceleration (call
+ * update() while a feeding runs). With a delivery sensor the duty rises
+ * while measured delivery lags the commanded steps, up to the power-budget
+ * cap AGITATION_MAX_DUTY; main.cpp derives delivery from the auger index
+ * sensor, so without one agitation is open loop at feed.agitate.duty.
+ * The index gives one edge per revolution: a lag shows only after a
+ * revolution plus INDEX_LOST_STEP_TOLERANCE without an edge, so the closed
+ * loop acts on feeds longer than that and shorter ones stay at
+ * feed.agitate.duty. Duty changes apply from the next pulse, the pattern
+ * keeps running; agitation that another pattern replaced restarts once
+ * that pattern ends. Agitation is off by default (feed.agitate).
+ * 
+ * Dispense profiles: async feedings follow the selected DISPENSE_PROFILES
+ * entry (feed.profile), oscillating forward/reverse strokes with the same
+ * net rotation to keep sticky food from clogging the auger.
+ * 
+ * Index homing: with an index sensor on the motor, the first async feeding
+ * waits for homing (started here if boot homing did not succeed; a failed
+ * or cancelled attempt is retried by the next feeding), and every
+ * homed feeding is rounded to end on an auger flight boundary so portions
+ * start at the same auger angle.
+ * 
+ * Latency: an async feeding started with a trigger reports trigger -> first
+ * step (seen in update()) and trigger -> complete (finishFeeding()) to the
+ * FeedLatencyTracker, using the step engine's timestamps.
  */
 class FeedingController {
+public:
+    /**
+     * Delivery sensor callback (load cell, jam detector, ...)
+     * 
+     * @return: Delivery confirmed since the move started, in stepper steps
+     *          (sensor converts grams/pulses), or -1 if no reading
+     */
+    typedef long (*DeliverySensor)();
+    
 private:
     StepperMotor* motor;                // Reference to stepper motor
     bool isInitialized;                 // Initialization status
+    uint8_t dispenseProfile;            // Index into DISPENSE_PROFILES
+    int pendingPortions;                // Feeding waiting for homing (0 = none)
+    bool homingRequested;               // Pre-feed homing started (cleared if it fails or is cancelled)
+    
+    // Hopper agitation
+    VibrationMotor* vibration;          // Agitator (nullptr = no agitation)
+    DeliverySensor deliverySensor;      // Optional closed-loop feedback
+    bool agitationEnabled;
+    uint8_t agitationDuty;              // Configured duty (%)
+    uint8_t appliedDuty;                // Duty of the running pulse pattern (%)
+    bool agitating;                     // Agitation pulses currently playing
+    StepperMotor::MotionPhase tracedPhase;  // Last ramp segment sent to the trace
+    VibrationMotor::HapticSegment agitationSegment;
+    VibrationMotor::HapticPattern agitationPattern;
+    
+    // Feed latency tracking
+    FeedLatencyTracker* latencyTracker;
+    FeedLatencyTracker::Trigger latencyTrigger;
+    bool latencyPending;                // Feeding with a trigger in progress
+    bool firstStepRecorded;
+    uint32_t latencyAllowanceMs;        // Time spent waiting for homing
+    unsigned long expectedMoveMs;       // Estimated duration of the dispense move
+    
+    void startDispense(int portions);
+    long alignToFlight(long steps) const;
+    void startAgitation(uint8_t duty);
+    void stopAgitation();
+    void recordFirstStep();
     
 public:
     // Constructor and initialization
@@ -26,12 +92,28 @@ public:
     
     // Main feeding operations
     bool dispenseFood(int portions);
-    bool dispenseFoodAsync(int portions);
+    bool dispenseFoodAsync(int portions, const FeedLatencyTracker::Trigger* trigger = nullptr);
+    void cancel();                      // Drop a feeding waiting for homing
+    void finishFeeding();               // Async feeding completed (records latency)
+    void setLatencyTracker(FeedLatencyTracker* tracker);
     
     // Calibration and testing
     void calibrateFeeder();
     void testFeeder(int testPortions = 1);
     
+    // Hopper agitation
+    void setVibrationMotor(VibrationMotor* vibrationMotor);
+    void setAgitation(bool enabled, uint8_t duty);
+    void setDeliverySensor(DeliverySensor sensor);
+    void update();                      // Start pending feeding, follow the motion profile (call while feeding)
+    bool isAgitating() const;
+    
+    // Dispense profiles
+    void setDispenseProfile(uint8_t profile);
+    uint8_t getDispenseProfile() const;
+    static int findDispenseProfile(const String& name);
+    void printDispenseProfiles() const;     // Stroke plans with estimated time per portion
+    
     // Status and information
     void printFeedingStatus() const;
     bool isReady() const;
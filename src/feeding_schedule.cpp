@@ -2,10 +2,15 @@
 #include "module_manager.h"
 #include "feeding_controller.h"
 #include "rtc_module.h"
+#include "time_zone.h"
+#include "trace_buffer.h"
 #include "config.h"
 
 // External functions from main.cpp for centralized feeding operations
-extern bool startFeeding(uint8_t portions, bool recordInSchedule);
+extern bool startFeeding(uint8_t portions, bool recordInSchedule, const FeedLatencyTracker::Trigger& trigger);
+
+// 2000-01-01 00:00:00 - "no feeding yet" (also what the RTC fallback reports)
+static const uint32_t EPOCH_NEVER = 946684800UL;
 
 /**
  * Constructor
@@ -14,12 +19,12 @@ FeedingSchedule::FeedingSchedule() :
     schedules(scheduleStorage), // Point to internal storage
     scheduleCount(0),
     scheduleEnabled(true),
-    lastCompletedFeeding(DateTime(2000, 1, 1, 0, 0, 0)), // Default old date
+    lastCompletedEpoch(EPOCH_NEVER), // Default old date
     persistenceInitialized(false),
     modules(nullptr),
     enableMonitorCallback(nullptr),
     feedingInProgress(false),
-    nextScheduledTime(DateTime(2000, 1, 1, 0, 0, 0)),
+    nextScheduledEpoch(0),
     nextScheduleIndex(0),
     toleranceMinutes(FEEDING_SCHEDULE_TOLERANCE_MINUTES),
     maxRecoveryHours(FEEDING_SCHEDULE_MAX_RECOVERY_HOURS)
@@ -34,6 +39,7 @@ FeedingSchedule::FeedingSchedule() :
  */
 void FeedingSchedule::begin(ModuleManager* moduleManager) {
     modules = moduleManager;
+    calendar.setTimezone(getTimezone());
     initializePersistence();
     loadLastFeedingFromNVRAM();
     
@@ -41,7 +47,8 @@ void FeedingSchedule::begin(ModuleManager* moduleManager) {
     loadSchedulesFromNVRAM();
     
     Console::printlnR(F("FeedingSchedule: System initialized"));
-    Console::printlnR("Last feeding: " + formatTime(lastCompletedFeeding));
+    Console::printR(F("Last feeding: "));
+    Console::printlnR(formatTime(lastCompletedEpoch).c_str());
     Console::printlnR("Active schedules: " + String(scheduleCount));
 }
 
@@ -76,12 +83,23 @@ void FeedingSchedule::loadLastFeedingFromNVRAM() {
         return;
     }
     
-    // Load Unix timestamp from NVRAM
-    uint32_t lastFeedingUnix = preferences.getUInt("last_feeding", 0);
+    // Load UTC timestamp from NVRAM
+    uint32_t lastFeedingUnix = preferences.getUInt("last_feed_utc", 0);
+    
+    // Older firmware stored local time under "last_feeding" - convert once
+    if (lastFeedingUnix == 0) {
+        uint32_t legacyLocal = preferences.getUInt("last_feeding", 0);
+        if (legacyLocal > 0) {
+            lastFeedingUnix = calendar.toUtc(legacyLocal);
+            preferences.putUInt("last_feed_utc", lastFeedingUnix);
+            preferences.remove("last_feeding");
+        }
+    }
     
     if (lastFeedingUnix > 0) {
-        lastCompletedFeeding = DateTime(lastFeedingUnix);
-        Console::printlnR("FeedingSchedule: Loaded last feeding from NVRAM: " + formatTime(lastCompletedFeeding));
+        lastCompletedEpoch = lastFeedingUnix;
+        Console::printR(F("FeedingSchedule: Loaded last feeding from NVRAM: "));
+        Console::printlnR(formatTime(lastCompletedEpoch).c_str());
     } else {
         Console::printlnR(F("FeedingSchedule: No previous feeding record found in NVRAM"));
     }
@@ -90,15 +108,19 @@ void FeedingSchedule::loadLastFeedingFromNVRAM() {
 /**
  * Save last feeding time to NVRAM
  */
-void FeedingSchedule::saveLastFeedingToNVRAM(const DateTime& feedingTime) {
+void FeedingSchedule::saveLastFeedingToNVRAM(uint32_t feedingEpoch) {
     if (!persistenceInitialized) {
         Console::printlnR(F("FeedingSchedule: WARNING - Cannot save to NVRAM, not initialized"));
         return;
     }
     
-    uint32_t feedingUnix = feedingTime.unixtime();
-    if (preferences.putUInt("last_feeding", feedingUnix)) {
-        Console::printlnR("FeedingSchedule: Saved feeding time to NVRAM: " + formatTime(feedingTime));
+    TraceBuffer::begin(TraceBuffer::NVS_COMMIT, "schedule.lastFeed");
+    bool saved = preferences.putUInt("last_feed_utc", feedingEpoch);
+    TraceBuffer::end(TraceBuffer::NVS_COMMIT);
+    
+    if (saved) {
+        Console::printR(F("FeedingSchedule: Saved feeding time to NVRAM: "));
+        Console::printlnR(formatTime(feedingEpoch).c_str());
     } else {
         Console::printlnR(F("FeedingSchedule: ERROR - Failed to save feeding time to NVRAM"));
     }
@@ -110,9 +132,9 @@ void FeedingSchedule::saveLastFeedingToNVRAM(const DateTime& feedingTime) {
  * Normal operation should use loadSchedulesFromNVRAM()
  */
 void FeedingSchedule::setSchedules(ScheduledFeeding* scheduleArray, uint8_t count) {
-    if (count > 10) { // MAX_SCHEDULED_FEEDINGS
+    if (count > MAX_SCHEDULED_FEEDINGS) {
         Console::printlnR(F("FeedingSchedule: ERROR - Too many schedules (max 10)"));
-        count = 10;
+        count = MAX_SCHEDULED_FEEDINGS;
     }
     
     // Copy schedules to internal storage
@@ -134,7 +156,7 @@ void FeedingSchedule::setSchedules(ScheduledFeeding* scheduleArray, uint8_t coun
  * Add a single schedule
  */
 bool FeedingSchedule::addSchedule(uint8_t hour, uint8_t minute, uint8_t second, uint8_t portions, const char* description) {
-    if (scheduleCount >= 10) { // MAX_SCHEDULED_FEEDINGS
+    if (scheduleCount >= MAX_SCHEDULED_FEEDINGS) {
         Console::printlnR(F("FeedingSchedule: ERROR - Maximum schedules reached (10)"));
         return false;
     }
@@ -163,72 +185,70 @@ bool FeedingSchedule::addSchedule(uint8_t hour, uint8_t minute, uint8_t second,
     return true;
 }
 
+// ============================================================================
+// EPOCH TIME HELPERS
+// ============================================================================
+
 /**
- * Calculate next feeding time based on current schedules
+ * Current RTC time in UTC epoch seconds
+ *
+ * @return: RTC time, or EPOCH_NEVER if the RTC is not available
  */
-void FeedingSchedule::calculateNextFeeding() {
-    if (scheduleCount == 0 || !schedules) {
-        nextScheduledTime = DateTime(2099, 12, 31, 23, 59, 59); // Far future
-        nextScheduleIndex = 0;
-        return;
-    }
-    
-    // Get current time from RTC
-    DateTime now;
+uint32_t FeedingSchedule::currentEpoch() {
     if (modules && modules->hasRTCModule()) {
-        now = modules->getRTCModule()->now();
-    } else {
-        now = DateTime(); // Fallback to default if RTC not available
-    }
-    
-    DateTime todayBase = DateTime(now.year(), now.month(), now.day(), 0, 0, 0);
-    DateTime tomorrowBase = DateTime(now.year(), now.month(), now.day() + 1, 0, 0, 0);
-    
-    DateTime closestTime = DateTime(2099, 12, 31, 23, 59, 59); // Far future
-    uint8_t closestIndex = 0;
-    
-    // Check today's schedules
-    for (uint8_t i = 0; i < scheduleCount; i++) {
-        if (!schedules[i].enabled) continue;
-        
-        DateTime scheduleTime = getScheduleDateTime(schedules[i], todayBase);
-        
-        if (scheduleTime > now && scheduleTime < closestTime) {
-            closestTime = scheduleTime;
-            closestIndex = i;
-        }
+        return modules->getRTCModule()->nowUtc();
     }
-    
-    // If no schedule found for today, check tomorrow
-    if (closestTime.year() == 2099) {
-        for (uint8_t i = 0; i < scheduleCount; i++) {
-            if (!schedules[i].enabled) continue;
-            
-            DateTime scheduleTime = getScheduleDateTime(schedules[i], tomorrowBase);
-            
-            if (scheduleTime < closestTime) {
-                closestTime = scheduleTime;
-                closestIndex = i;
-            }
-        }
+    return EPOCH_NEVER;
+}
+
+/**
+ * @return: Configured time zone, or nullptr without RTC (times are UTC)
+ */
+TimeZone* FeedingSchedule::getTimezone() {
+    if (modules && modules->hasRTCModule()) {
+        return &modules->getRTCModule()->getTimezone();
     }
-    
-    nextScheduledTime = closestTime;
-    nextScheduleIndex = closestIndex;
+    return nullptr;
 }
 
+// ============================================================================
+// SCHEDULE EVALUATION
+// ============================================================================
+
 /**
- * Get DateTime from schedule and reference date
+ * Calculate next feeding time based on current schedules
  */
-DateTime FeedingSchedule::getScheduleDateTime(const ScheduledFeeding& schedule, const DateTime& referenceDate) {
-    return DateTime(referenceDate.year(), referenceDate.month(), referenceDate.day(),
-                   schedule.hour, schedule.minute, schedule.second);
+void FeedingSchedule::calculateNextFeeding() {
+    calculateNextFeeding(currentEpoch());
+}
+
+/**
+ * Calculate next feeding time relative to a given time
+ * Tomorrow is local midnight + 24h, so month and year ends need no
+ * calendar math; DST is handled by the local -> UTC conversion
+ *
+ * @param now: Current time in UTC epoch seconds
+ */
+void FeedingSchedule::calculateNextFeeding(uint32_t now) {
+    nextScheduledEpoch = 0;
+    nextScheduleIndex = 0;
+    
+    if (scheduleCount == 0 || !schedules) {
+        return;
+    }
+    
+    int8_t index = calendar.findNext(schedules, scheduleCount, now, nextScheduledEpoch);
+    if (index >= 0) {
+        nextScheduleIndex = index;
+    }
 }
 
 /**
  * Main processing method - NON-BLOCKING
+ *
+ * @param now: Current time in UTC epoch seconds
  */
-void FeedingSchedule::processSchedules(const DateTime& currentTime) {
+void FeedingSchedule::processSchedules(uint32_t now) {
     if (!scheduleEnabled || scheduleCount == 0 || !schedules || !modules || !modules->hasFeedingController()) {
         return;
     }
@@ -240,47 +260,47 @@ void FeedingSchedule::processSchedules(const DateTime& currentTime) {
         return;
     }
     
+    // Integer math only - no calendar conversion per tick
+    calendar.refreshAnchor(now);
+    
     // Check for missed feedings (power loss recovery)
-    recoverMissedFeedings(currentTime);
+    recoverMissedFeedings(now);
     
-    // Check if it's time for next scheduled feeding
-    if (isTimeForFeeding(currentTime, schedules[nextScheduleIndex])) {
-        executeFeeding(schedules[nextScheduleIndex]);
-        calculateNextFeeding(); // Recalculate next feeding
+    // Fire once the next feeding time is reached; never early. A tick that
+    // arrives too late leaves the feeding to recovery (tolerance applies).
+    if (!feedingInProgress && nextScheduledEpoch != 0 && now >= nextScheduledEpoch &&
+        now - nextScheduledEpoch <= FEEDING_SCHEDULE_TRIGGER_WINDOW) {
+        // Latency counts from the deadline (schedule monitor poll included)
+        executeFeeding(schedules[nextScheduleIndex],
+                       FeedLatencyTracker::Trigger::secondsAgo(FeedLatencyTracker::SOURCE_SCHEDULE, now - nextScheduledEpoch));
     }
     
-    // Update next scheduled time for web interface
-    updateNextScheduledTime(currentTime);
+    // Update next scheduled time for web interface (also follows RTC changes)
+    calculateNextFeeding(now);
 }
 
 /**
  * Check if current time matches scheduled feeding time
  */
-bool FeedingSchedule::isTimeForFeeding(const DateTime& currentTime, const ScheduledFeeding& schedule) {
+bool FeedingSchedule::isTimeForFeeding(uint32_t now, const ScheduledFeeding& schedule) {
     if (!schedule.enabled) return false;
     
-    DateTime scheduleTime = getScheduleDateTime(schedule, 
-        DateTime(currentTime.year(), currentTime.month(), currentTime.day(), 0, 0, 0));
-    
-    // Check if we're within 1 minute of scheduled time
-    long timeDiff = (long)(currentTime.unixtime() - scheduleTime.unixtime());
-    if (timeDiff < 0) timeDiff = -timeDiff; // Manual abs() to avoid ambiguity
-    return (timeDiff <= 60); // 60 seconds tolerance
+    uint32_t scheduleTime = calendar.scheduleEpoch(calendar.localMidnight(now), schedule);
+    return (now >= scheduleTime && now - scheduleTime <= FEEDING_SCHEDULE_TRIGGER_WINDOW);
 }
 
 /**
  * Check if a feeding was missed (for recovery)
  */
-bool FeedingSchedule::isFeedingMissed(const DateTime& currentTime, const ScheduledFeeding& schedule) {
+bool FeedingSchedule::isFeedingMissed(uint32_t now, const ScheduledFeeding& schedule) {
     if (!schedule.enabled) return false;
     
-    DateTime scheduleTime = getScheduleDateTime(schedule,
-        DateTime(currentTime.year(), currentTime.month(), currentTime.day(), 0, 0, 0));
+    uint32_t scheduleTime = calendar.scheduleEpoch(calendar.localMidnight(now), schedule);
     
     // If schedule time is in the past and beyond tolerance
-    if (scheduleTime < currentTime) {
-        long minutesPast = (currentTime.unixtime() - scheduleTime.unixtime()) / 60;
-        return (minutesPast > 1 && minutesPast <= (toleranceMinutes));
+    if (scheduleTime < now) {
+        uint32_t minutesPast = (now - scheduleTime) / 60;
+        return (minutesPast > 1 && minutesPast <= toleranceMinutes);
     }
     
     return false;
@@ -288,34 +308,32 @@ bool FeedingSchedule::isFeedingMissed(const DateTime& currentTime, const Schedul
 
 /**
  * Execute a scheduled feeding
+ * 
+ * @param schedule: Schedule entry to feed
+ * @param trigger: Latency reference (deadline, or now for recovery feedings)
  */
-void FeedingSchedule::executeFeeding(const ScheduledFeeding& schedule) {
-    Console::printlnR("FeedingSchedule: Executing scheduled feeding - " + 
-                     String(schedule.portions) + " portions at " + 
-                     String(schedule.hour) + ":" + 
-                     String(schedule.minute, DEC));
+void FeedingSchedule::executeFeeding(const ScheduledFeeding& schedule, const FeedLatencyTracker::Trigger& trigger) {
+    FixedString<64> line;
+    line.appendFormat("FeedingSchedule: Executing scheduled feeding - %u portions at %u:%u",
+                      schedule.portions, schedule.hour, schedule.minute);
+    Console::printlnR(line.c_str());
     
     if (strlen(schedule.description) > 0) {
-        Console::printlnR("Description: " + String(schedule.description));
+        Console::printR(F("Description: "));
+        Console::printlnR(schedule.description);
     }
     
     // Get current time from RTC BEFORE starting feeding
-    DateTime feedingTime;
-    if (modules && modules->hasRTCModule()) {
-        feedingTime = modules->getRTCModule()->now();
-    } else {
-        // Fallback if RTC not available
-        feedingTime = DateTime(2000, 1, 1, 0, 0, 0);
-    }
+    uint32_t feedingTime = currentEpoch();
     
     // Use centralized feeding method (with recordInSchedule = false since schedule handles it)
-    if (startFeeding(schedule.portions, false)) {
+    if (startFeeding(schedule.portions, false, trigger)) {
         feedingInProgress = true;
         
         Console::printlnR(F("FeedingSchedule: Feeding started successfully"));
         
         // Record this feeding time
-        lastCompletedFeeding = feedingTime;
+        lastCompletedEpoch = feedingTime;
         saveLastFeedingToNVRAM(feedingTime);
     } else {
         Console::printlnR(F("FeedingSchedule: ERROR - Failed to start feeding"));
@@ -324,49 +342,37 @@ void FeedingSchedule::executeFeeding(const ScheduledFeeding& schedule) {
     }
 }
 
+/**
+ * Find the earliest missed feeding that can still be recovered
+ *
+ * @param now: Current time in epoch seconds
+ * @param missedEpoch: Set to the missed schedule time when found
+ * @return: Schedule index, or -1 if nothing to recover
+ */
+int8_t FeedingSchedule::findMissedFeeding(uint32_t now, uint32_t& missedEpoch) {
+    return calendar.findMissed(schedules, scheduleCount, now, lastCompletedEpoch,
+                               toleranceMinutes, maxRecoveryHours, missedEpoch);
+}
+
 /**
  * Recover missed feedings after power loss
  */
-void FeedingSchedule::recoverMissedFeedings(const DateTime& currentTime) {
-    // Look back from last completed feeding to find missed schedules
-    DateTime searchStart = lastCompletedFeeding;
-    DateTime searchEnd = currentTime;
-    
-    // Limit search to maximum recovery hours
-    DateTime maxLookback = DateTime(currentTime.unixtime() - (maxRecoveryHours * 3600));
-    if (searchStart < maxLookback) {
-        searchStart = maxLookback;
-    }
-    
-    // Check each day between searchStart and searchEnd
-    DateTime checkDate = searchStart;
-    
-    while (checkDate < searchEnd) {
-        for (uint8_t i = 0; i < scheduleCount; i++) {
-            if (!schedules[i].enabled) continue;
-            
-            DateTime scheduleTime = getScheduleDateTime(schedules[i], checkDate);
-            
-            // Skip if this schedule is after current time
-            if (scheduleTime >= currentTime) continue;
-            
-            // Skip if this schedule is before or at last completed feeding
-            if (scheduleTime <= lastCompletedFeeding) continue;
-            
-            // Check if this feeding was missed and within tolerance
-            long minutesPast = (currentTime.unixtime() - scheduleTime.unixtime()) / 60;
-            if (minutesPast > 1 && minutesPast <= toleranceMinutes) {
-                Console::printlnR("FeedingSchedule: RECOVERY - Missed feeding detected: " +
-                                 formatTime(scheduleTime) + " (" + String(minutesPast) + " minutes ago)");
-                
-                executeFeeding(schedules[i]);
-                return; // Execute one recovery feeding at a time
-            }
-        }
-        
-        // Move to next day
-        checkDate = DateTime(checkDate.unixtime() + 86400); // +24 hours
+void FeedingSchedule::recoverMissedFeedings(uint32_t now) {
+    uint32_t missedEpoch = 0;
+    int8_t index = findMissedFeeding(now, missedEpoch);
+    if (index < 0) {
+        return;
     }
+    
+    FixedString<96> line;
+    line.append("FeedingSchedule: RECOVERY - Missed feeding detected: ")
+        .append(formatTime(missedEpoch).c_str())
+        .appendFormat(" (%lu minutes ago)", (unsigned long)((now - missedEpoch) / 60));
+    Console::printlnR(line.c_str());
+    
+    // Execute one recovery feeding at a time; latency counts from now, the
+    // outage before it is not feeder latency
+    executeFeeding(schedules[index], FeedLatencyTracker::Trigger::now(FeedLatencyTracker::SOURCE_SCHEDULE));
 }
 
 /**
@@ -426,18 +432,16 @@ void FeedingSchedule::printScheduleList() {
         return;
     }
     
+    FixedString<96> line;
     for (uint8_t i = 0; i < scheduleCount; i++) {
-        String status = schedules[i].enabled ? "ON " : "OFF";
-        String timeStr = String(schedules[i].hour, DEC) + ":" + 
-                        String(schedules[i].minute < 10 ? "0" : "") + String(schedules[i].minute, DEC);
-        
-        if (schedules[i].second > 0) {
-            timeStr += ":" + String(schedules[i].second < 10 ? "0" : "") + String(schedules[i].second, DEC);
+        line.clear();
+        line.appendFormat("%u: [%s] %s - %u portions",
+                          i, schedules[i].enabled ? "ON " : "OFF",
+                          formatSchedule(schedules[i]).c_str(), schedules[i].portions);
+        if (strlen(schedules[i].description) > 0) {
+            line.append(" (").append(schedules[i].description).append(')');
         }
-        
-        Console::printlnR(String(i) + ": [" + status + "] " + timeStr + 
-                         " - " + String(schedules[i].portions) + " portions" +
-                         (strlen(schedules[i].description) > 0 ? " (" + String(schedules[i].description) + ")" : ""));
+        Console::printlnR(line.c_str());
     }
 }
 
@@ -450,29 +454,34 @@ void FeedingSchedule::printNextFeeding() {
         return;
     }
     
-    if (nextScheduledTime.year() == 2099) {
+    if (nextScheduledEpoch == 0) {
         Console::printlnR(F("Next Feeding: No active schedules"));
         return;
     }
     
-    Console::printlnR("Next Feeding: " + formatTime(nextScheduledTime) + 
-                     " (" + String(schedules[nextScheduleIndex].portions) + " portions)");
+    FixedString<64> line;
+    line.append("Next Feeding: ")
+        .append(formatTime(nextScheduledEpoch).c_str())
+        .appendFormat(" (%u portions)", schedules[nextScheduleIndex].portions);
+    Console::printlnR(line.c_str());
 }
 
 /**
  * Print last feeding information
  */
 void FeedingSchedule::printLastFeeding() {
-    Console::printlnR("Last Feeding: " + formatTime(lastCompletedFeeding));
+    Console::printR(F("Last Feeding: "));
+    Console::printlnR(formatTime(lastCompletedEpoch).c_str());
 }
 
 /**
  * Record manual feeding (updates last feeding time)
  */
-void FeedingSchedule::recordManualFeeding(const DateTime& feedingTime) {
-    lastCompletedFeeding = feedingTime;
-    saveLastFeedingToNVRAM(feedingTime);
-    Console::printlnR("FeedingSchedule: Manual feeding recorded: " + formatTime(feedingTime));
+void FeedingSchedule::recordManualFeeding(uint32_t feedingEpoch) {
+    lastCompletedEpoch = feedingEpoch;
+    saveLastFeedingToNVRAM(lastCompletedEpoch);
+    Console::printR(F("FeedingSchedule: Manual feeding recorded: "));
+    Console::printlnR(formatTime(lastCompletedEpoch).c_str());
 }
 
 /**
@@ -497,43 +506,12 @@ bool FeedingSchedule::isScheduleEnabled(uint8_t index) {
     return schedules[index].enabled;
 }
 DateTime FeedingSchedule::getNextScheduledTime() {
-    // Return cached value if recently calculated
-    return nextScheduledTime;
+    // Year 2000 means no active schedules (display boundary)
+    return DateTime(nextScheduledEpoch != 0 ? calendar.toLocal(nextScheduledEpoch) : EPOCH_NEVER);
 }
-
-/**
- * Calculate and update the next scheduled feeding time
- */
-void FeedingSchedule::updateNextScheduledTime(const DateTime& currentTime) {
-    DateTime nextFeeding(2099, 1, 1, 0, 0, 0); // Far future date for comparison
-    
-    // Check all enabled schedules for the next one
-    for (int i = 0; i < scheduleCount; i++) {
-        if (!schedules[i].enabled) continue;
-        
-        // Calculate next occurrence for this schedule
-        DateTime candidateTime(currentTime.year(), currentTime.month(), currentTime.day(), 
-                              schedules[i].hour, schedules[i].minute, schedules[i].second);
-        
-        // If time already passed today, move to tomorrow
-        if (candidateTime <= currentTime) {
-            candidateTime = candidateTime + TimeSpan(1, 0, 0, 0); // Add 1 day
-        }
-        
-        // Keep the earliest next feeding
-        if (candidateTime < nextFeeding) {
-            nextFeeding = candidateTime;
-        }
-    }
-    
-    // Update internal state
-    if (nextFeeding.year() >= 2099) {
-        nextScheduledTime = DateTime(2000, 1, 1, 0, 0, 0); // No active schedules
-    } else {
-        nextScheduledTime = nextFeeding;
-    }
+DateTime FeedingSchedule::getLastCompletedFeeding() {
+    return DateTime(lastCompletedEpoch > EPOCH_NEVER ? calendar.toLocal(lastCompletedEpoch) : EPOCH_NEVER);
 }
-DateTime FeedingSchedule::getLastCompletedFeeding() { return lastCompletedFeeding; }
 uint8_t FeedingSchedule::getScheduleCount() { return scheduleCount; }
 uint16_t FeedingSchedule::getTolerance() { return toleranceMinutes; }
 uint16_t FeedingSchedule::getMaxRecoveryHours() { return maxRecoveryHours; }
@@ -549,21 +527,37 @@ ScheduledFeeding FeedingSchedule::getSchedule(uint8_t index) {
 /**
  * Utility methods
  */
-String FeedingSchedule::formatTime(const DateTime& dt) {
-    if (dt.year() == 2000) {
-        return "Never";
+FixedString<24> FeedingSchedule::formatTime(uint32_t epoch) {
+    DateTime dt(calendar.toLocal(epoch));
+    FixedString<24> text;
+    if (DateTime(epoch).year() == 2000) {
+        text.append("Never");
+        return text;
     }
     
-    return String(dt.day()) + "/" + String(dt.month()) + "/" + String(dt.year()) + " " +
-           String(dt.hour()) + ":" + 
-           String(dt.minute() < 10 ? "0" : "") + String(dt.minute()) + ":" +
-           String(dt.second() < 10 ? "0" : "") + String(dt.second());
+    text.appendFormat("%u/%u/%u %u:%02u:%02u",
+                      dt.day(), dt.month(), dt.year(),
+                      dt.hour(), dt.minute(), dt.second());
+    return text;
 }
 
-String FeedingSchedule::formatSchedule(const ScheduledFeeding& schedule) {
-    return String(schedule.hour) + ":" + 
-           String(schedule.minute < 10 ? "0" : "") + String(schedule.minute) +
-           (schedule.second > 0 ? ":" + String(schedule.second < 10 ? "0" : "") + String(schedule.second) : "");
+FixedString<12> FeedingSchedule::formatSchedule(const ScheduledFeeding& schedule) {
+    FixedString<12> text;
+    text.appendFormat("%u:%02u", schedule.hour, schedule.minute);
+    if (schedule.second > 0) {
+        text.appendFormat(":%02u", schedule.second);
+    }
+    return text;
+}
+
+/**
+ * Build the NVRAM key for one schedule field, e.g. "s3_desc"
+ * Keys stay well under the 15 character NVS limit
+ */
+FixedString<15> FeedingSchedule::nvramKey(uint8_t index, const char* field) {
+    FixedString<15> key;
+    key.appendFormat("s%u_%s", index, field);
+    return key;
 }
 
 /**
@@ -577,31 +571,51 @@ void FeedingSchedule::printDiagnostics() {
     Console::printlnR("State - feedingInProgress: " + String(feedingInProgress));
     Console::printlnR("State - persistenceInitialized: " + String(persistenceInitialized));
     Console::printlnR("Next Schedule Index: " + String(nextScheduleIndex));
+    Console::printlnR("Next Schedule Epoch: " + String(nextScheduledEpoch));
+    Console::printlnR("Day Anchor Epoch: " + String(calendar.getMidnightAnchor()));
     
     // NVRAM diagnostic
     if (persistenceInitialized) {
-        uint32_t storedTime = preferences.getUInt("last_feeding", 0);
+        uint32_t storedTime = preferences.getUInt("last_feed_utc", 0);
         Console::printlnR("NVRAM stored timestamp: " + String(storedTime));
     }
 }
 
 void FeedingSchedule::testScheduleCalculation() {
     Console::printlnR(F("\n=== SCHEDULE CALCULATION TEST ==="));
-    calculateNextFeeding();
+    uint32_t now = currentEpoch();
+    calculateNextFeeding(now);
     printNextFeeding();
     
     Console::printlnR(F("Testing with current time..."));
-    DateTime testTime = DateTime(); // Current time
+    FixedString<64> line;
     
     for (uint8_t i = 0; i < scheduleCount; i++) {
         if (!schedules) break;
         
-        bool timeMatch = isTimeForFeeding(testTime, schedules[i]);
-        bool missed = isFeedingMissed(testTime, schedules[i]);
-        
-        Console::printlnR("Schedule " + String(i) + ": Time match=" + String(timeMatch) + 
-                         ", Missed=" + String(missed));
+        line.clear();
+        line.appendFormat("Schedule %u: Time match=%d, Missed=%d",
+                          i, isTimeForFeeding(now, schedules[i]), isFeedingMissed(now, schedules[i]));
+        Console::printlnR(line.c_str());
+    }
+    
+    // Per-tick cost of the schedule evaluation (nothing is executed)
+    const uint16_t iterations = 1000;
+    uint32_t missedEpoch = 0;
+    volatile int8_t found = 0;
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < iterations; i++) {
+        calculateNextFeeding(now + i * 30UL);
+        found = findMissedFeeding(now + i * 30UL, missedEpoch);
     }
+    unsigned long elapsed = micros() - start;
+    (void)found;
+    calculateNextFeeding(now);
+    
+    line.clear();
+    line.appendFormat("Tick evaluation: %lu ns per tick (%u ticks)",
+                      (unsigned long)(elapsed * 1000UL / iterations), iterations);
+    Console::printlnR(line.c_str());
 }
 
 /**
@@ -681,7 +695,7 @@ void FeedingSchedule::loadSchedulesFromNVRAM() {
         return;
     }
     
-    if (storedCount > 10) { // MAX_SCHEDULED_FEEDINGS
+    if (storedCount > MAX_SCHEDULED_FEEDINGS) {
         Console::printlnR(F("FeedingSchedule: WARNING - Invalid schedule count in NVRAM, initializing with defaults"));
         initializeDefaultSchedules();
         return;
@@ -692,21 +706,23 @@ void FeedingSchedule::loadSchedulesFromNVRAM() {
     // Load each schedule from NVRAM
     scheduleCount = 0;
     for (uint8_t i = 0; i < storedCount; i++) {
-        String prefix = "s" + String(i) + "_";
-        
-        scheduleStorage[i].hour = preferences.getUChar((prefix + "h").c_str(), 0);
-        scheduleStorage[i].minute = preferences.getUChar((prefix + "m").c_str(), 0);
-        scheduleStorage[i].second = preferences.getUChar((prefix + "s").c_str(), 0);
-        scheduleStorage[i].portions = preferences.getUChar((prefix + "p").c_str(), 1);
-        scheduleStorage[i].enabled = preferences.getBool((prefix + "en").c_str(), true);
+        scheduleStorage[i].hour = preferences.getUChar(nvramKey(i, "h").c_str(), 0);
+        scheduleStorage[i].minute = preferences.getUChar(nvramKey(i, "m").c_str(), 0);
+        scheduleStorage[i].second = preferences.getUChar(nvramKey(i, "s").c_str(), 0);
+        scheduleStorage[i].portions = preferences.getUChar(nvramKey(i, "p").c_str(), 1);
+        scheduleStorage[i].enabled = preferences.getBool(nvramKey(i, "en").c_str(), true);
         
-        String desc = preferences.getString((prefix + "desc").c_str(), "");
-        strncpy(scheduleStorage[i].description, desc.c_str(), 49);
-        scheduleStorage[i].description[49] = '\0';
+        // Read the description straight into the schedule slot (no String copy)
+        scheduleStorage[i].description[0] = '\0';
+        preferences.getString(nvramKey(i, "desc").c_str(), scheduleStorage[i].description,
+                              sizeof(scheduleStorage[i].description));
+        scheduleStorage[i].description[sizeof(scheduleStorage[i].description) - 1] = '\0';
         
-        Console::printlnR("  Loaded: " + String(scheduleStorage[i].hour) + ":" + 
-                         String(scheduleStorage[i].minute) + " - " + 
-                         String(scheduleStorage[i].portions) + " portions");
+        FixedString<48> line;
+        line.appendFormat("  Loaded: %u:%u - %u portions",
+                          scheduleStorage[i].hour, scheduleStorage[i].minute,
+                          scheduleStorage[i].portions);
+        Console::printlnR(line.c_str());
         
         scheduleCount++;
     }
@@ -726,21 +742,22 @@ void FeedingSchedule::saveSchedulesToNVRAM() {
     
     Console::printlnR("FeedingSchedule: Saving " + String(scheduleCount) + " schedules to NVRAM");
     
+    TraceBuffer::begin(TraceBuffer::NVS_COMMIT, "schedule.entries");
+    
     // Save schedule count
     preferences.putUChar("sched_count", scheduleCount);
     
     // Save each schedule
     for (uint8_t i = 0; i < scheduleCount; i++) {
-        String prefix = "s" + String(i) + "_";
-        
-        preferences.putUChar((prefix + "h").c_str(), scheduleStorage[i].hour);
-        preferences.putUChar((prefix + "m").c_str(), scheduleStorage[i].minute);
-        preferences.putUChar((prefix + "s").c_str(), scheduleStorage[i].second);
-        preferences.putUChar((prefix + "p").c_str(), scheduleStorage[i].portions);
-        preferences.putBool((prefix + "en").c_str(), scheduleStorage[i].enabled);
-        preferences.putString((prefix + "desc").c_str(), String(scheduleStorage[i].description));
+        preferences.putUChar(nvramKey(i, "h").c_str(), scheduleStorage[i].hour);
+        preferences.putUChar(nvramKey(i, "m").c_str(), scheduleStorage[i].minute);
+        preferences.putUChar(nvramKey(i, "s").c_str(), scheduleStorage[i].second);
+        preferences.putUChar(nvramKey(i, "p").c_str(), scheduleStorage[i].portions);
+        preferences.putBool(nvramKey(i, "en").c_str(), scheduleStorage[i].enabled);
+        preferences.putString(nvramKey(i, "desc").c_str(), scheduleStorage[i].description);
     }
     
+    TraceBuffer::end(TraceBuffer::NVS_COMMIT);
     Console::printlnR(F("FeedingSchedule: Schedules saved to NVRAM successfully"));
 }
 
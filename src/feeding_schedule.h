@@ -4,12 +4,16 @@
 #include <RTClib.h>
 #include <Preferences.h>
 #include "console_manager.h"
+#include "string_builder.h"
 #include "config.h"
+#include "feed_latency.h"
+#include "schedule_calendar.h"
 
 // Forward declarations
 class ModuleManager;
 class FeedingController;
 class RTCModule;
+class TimeZone;
 
 // Callback type for feeding monitor
 typedef void (*FeedingMonitorCallback)();
@@ -24,6 +28,14 @@ typedef void (*FeedingMonitorCallback)();
  * - Integration with FeedingController for actual feeding
  * - Real-time schedule management
  * 
+ * Time handling:
+ * - All schedule arithmetic uses uint32_t UTC epoch seconds and seconds-of-day
+ * - Schedule times are local wall clock times: the start of the current
+ *   local day is cached (recomputed once per day or on a zone change) and
+ *   local -> UTC goes through the RTC time zone (DST aware)
+ * - Calendar (DateTime) conversion only happens for display and the web API
+ * - The arithmetic itself lives in ScheduleCalendar (hardware-free)
+ * 
  * Architecture:
  * - Uses ModuleManager for accessing FeedingController and RTCModule
  * - Reduces coupling between modules
@@ -31,14 +43,14 @@ typedef void (*FeedingMonitorCallback)();
 class FeedingSchedule {
 private:
     // Schedule management
-    ScheduledFeeding scheduleStorage[10]; // Fixed array storage (MAX_SCHEDULED_FEEDINGS = 10)
+    ScheduledFeeding scheduleStorage[MAX_SCHEDULED_FEEDINGS]; // Fixed array storage
     ScheduledFeeding* schedules;    // Pointer to current schedules (will point to scheduleStorage)
     uint8_t scheduleCount;          // Number of active schedules
     bool scheduleEnabled;           // Global enable/disable flag
     
     // Persistence and recovery
     Preferences preferences;        // NVRAM storage
-    DateTime lastCompletedFeeding; // Last successful feeding time
+    uint32_t lastCompletedEpoch;   // Last successful feeding time, UTC (EPOCH_NEVER if none)
     bool persistenceInitialized;   // NVRAM initialization status
     
     // Reference to ModuleManager
@@ -49,8 +61,9 @@ private:
     
     // State management
     bool feedingInProgress;         // Current feeding status
-    DateTime nextScheduledTime;     // Next calculated feeding time
+    uint32_t nextScheduledEpoch;    // Next calculated feeding time, UTC (0 if none)
     uint8_t nextScheduleIndex;      // Index of next schedule to execute
+    ScheduleCalendar calendar;      // Epoch arithmetic, cached start of the local day
     
     // Tolerance and recovery
     uint16_t toleranceMinutes;      // Minutes tolerance for missed feedings
@@ -59,15 +72,19 @@ private:
     // Private methods
     void initializePersistence();
     void loadLastFeedingFromNVRAM();
-    void saveLastFeedingToNVRAM(const DateTime& feedingTime);
+    void saveLastFeedingToNVRAM(uint32_t feedingEpoch);
+    uint32_t currentEpoch();
+    TimeZone* getTimezone();
     void calculateNextFeeding();
-    bool isTimeForFeeding(const DateTime& currentTime, const ScheduledFeeding& schedule);
-    bool isFeedingMissed(const DateTime& currentTime, const ScheduledFeeding& schedule);
-    void executeFeeding(const ScheduledFeeding& schedule);
-    void recoverMissedFeedings(const DateTime& currentTime);
-    DateTime getScheduleDateTime(const ScheduledFeeding& schedule, const DateTime& referenceDate);
-    String formatTime(const DateTime& dt);
-    String formatSchedule(const ScheduledFeeding& schedule);
+    void calculateNextFeeding(uint32_t now);
+    bool isTimeForFeeding(uint32_t now, const ScheduledFeeding& schedule);
+    bool isFeedingMissed(uint32_t now, const ScheduledFeeding& schedule);
+    int8_t findMissedFeeding(uint32_t now, uint32_t& missedEpoch);
+    void executeFeeding(const ScheduledFeeding& schedule, const FeedLatencyTracker::Trigger& trigger);
+    void recoverMissedFeedings(uint32_t now);
+    FixedString<24> formatTime(uint32_t epoch);
+    FixedString<12> formatSchedule(const ScheduledFeeding& schedule);
+    FixedString<15> nvramKey(uint8_t index, const char* field);
 
 public:
     // Constructor and initialization
@@ -95,17 +112,16 @@ public:
     bool isScheduleEnabled();
     bool isScheduleEnabled(uint8_t index);
     
-    // Main processing (non-blocking)
-    void processSchedules(const DateTime& currentTime);
+    // Main processing (non-blocking), now = UTC epoch seconds
+    void processSchedules(uint32_t now);
     
     // Status and information
     void printScheduleStatus();
     void printScheduleList();
     void printNextFeeding();
     void printLastFeeding();
-    DateTime getNextScheduledTime();
-    void updateNextScheduledTime(const DateTime& currentTime);
-    DateTime getLastCompletedFeeding();
+    DateTime getNextScheduledTime();      // Local time (year 2000 = none)
+    DateTime getLastCompletedFeeding();   // Local time (year 2000 = never)
     uint8_t getScheduleCount();
     ScheduledFeeding getSchedule(uint8_t index);
     
@@ -116,7 +132,7 @@ public:
     uint16_t getMaxRecoveryHours();
     
     // Manual feeding tracking
-    void recordManualFeeding(const DateTime& feedingTime);
+    void recordManualFeeding(uint32_t feedingEpoch);
     
     // Debug and diagnostics
     void printDiagnostics();
@@ -0,0 +1,122 @@
+#include "haptic_sequencer.h"
+
+// ============================================================================
+// PATTERN LIBRARY
+// ============================================================================
+
+// { intensity %, on ms, off ms, repeat }
+static const HapticSequencer::Segment ACK_SEGMENTS[] = {
+    {60, 50, 0, 1}
+};
+
+static const HapticSequencer::Segment LONG_PRESS_SEGMENTS[] = {
+    {60, 200, 0, 1}
+};
+
+static const HapticSequencer::Segment ERROR_SEGMENTS[] = {
+    {100, 80, 80, 3}
+};
+
+static const HapticSequencer::Segment FEED_DONE_SEGMENTS[] = {
+    {50, 100, 100, 2},
+    {70, 250, 0, 1}
+};
+
+const HapticSequencer::Pattern HapticSequencer::PATTERN_ACK = {"ack", ACK_SEGMENTS, 1};
+const HapticSequencer::Pattern HapticSequencer::PATTERN_LONG_PRESS = {"long-press", LONG_PRESS_SEGMENTS, 1};
+const HapticSequencer::Pattern HapticSequencer::PATTERN_ERROR = {"error", ERROR_SEGMENTS, 1};
+const HapticSequencer::Pattern HapticSequencer::PATTERN_FEED_DONE = {"feed-done", FEED_DONE_SEGMENTS, 2};
+
+const HapticSequencer::Pattern* const HapticSequencer::PATTERN_LIBRARY[] = {
+    &HapticSequencer::PATTERN_ACK,
+    &HapticSequencer::PATTERN_LONG_PRESS,
+    &HapticSequencer::PATTERN_ERROR,
+    &HapticSequencer::PATTERN_FEED_DONE
+};
+
+const uint8_t HapticSequencer::PATTERN_LIBRARY_SIZE = sizeof(PATTERN_LIBRARY) / sizeof(PATTERN_LIBRARY[0]);
+
+HapticSequencer::HapticSequencer()
+    : pattern(nullptr),
+      segmentIndex(0),
+      cycleIndex(0),
+      phaseOn(false),
+      phaseDeadlineUs(0),
+      patternEndUs(0) {
+}
+
+void HapticSequencer::start(const Pattern& newPattern, int64_t nowUs) {
+    // Total length (endless if any segment repeats forever)
+    int64_t totalMs = 0;
+    for (uint8_t i = 0; i < newPattern.segmentCount; i++) {
+        const Segment& seg = newPattern.segments[i];
+        if (seg.repeat == 0) {
+            totalMs = -1;
+            break;
+        }
+        totalMs += (int64_t)seg.repeat * (seg.onMs + seg.offMs);
+    }
+    if (totalMs > 0) {
+        totalMs -= newPattern.segments[newPattern.segmentCount - 1].offMs;  // Trailing pause skipped
+    }
+
+    pattern = &newPattern;
+    segmentIndex = 0;
+    cycleIndex = 0;
+    phaseDeadlineUs = nowUs;
+    patternEndUs = totalMs > 0 ? nowUs + totalMs * 1000 : 0;
+    startOnPhase();
+}
+
+void HapticSequencer::cancel() {
+    pattern = nullptr;
+    phaseOn = false;
+    patternEndUs = 0;
+}
+
+HapticSequencer::Edge HapticSequencer::advance(int64_t nowUs) {
+    // A callback already dispatched when the pattern was replaced comes
+    // early (a one-shot never fires before its deadline)
+    if (!pattern || nowUs < phaseDeadlineUs) {
+        return EDGE_NONE;
+    }
+
+    const Segment& seg = pattern->segments[segmentIndex];
+    bool lastCycle = seg.repeat != 0 && cycleIndex + 1 >= seg.repeat;
+    bool lastSegment = segmentIndex + 1 >= pattern->segmentCount;
+
+    if (phaseOn && seg.offMs > 0 && !(lastCycle && lastSegment)) {
+        // Pause between pulses
+        phaseOn = false;
+        phaseDeadlineUs += (int64_t)seg.offMs * 1000;
+        return EDGE_OFF;
+    }
+    if (!lastCycle) {
+        cycleIndex++;
+        startOnPhase();
+        return EDGE_ON;
+    }
+    if (!lastSegment) {
+        segmentIndex++;
+        cycleIndex = 0;
+        startOnPhase();
+        return EDGE_ON;
+    }
+
+    cancel();
+    return EDGE_DONE;
+}
+
+uint64_t HapticSequencer::getTimerDelayUs(int64_t nowUs) const {
+    int64_t delayUs = phaseDeadlineUs - nowUs;
+    return delayUs < 1 ? 1 : (uint64_t)delayUs;
+}
+
+uint8_t HapticSequencer::getIntensity() const {
+    return pattern ? pattern->segments[segmentIndex].intensity : 0;
+}
+
+void HapticSequencer::startOnPhase() {
+    phaseOn = true;
+    phaseDeadlineUs += (int64_t)pattern->segments[segmentIndex].onMs * 1000;
+}
@@ -0,0 +1,124 @@
+#ifndef HAPTIC_SEQUENCER_H
+#define HAPTIC_SEQUENCER_H
+
+#include <stdint.h>
+
+/**
+ * HapticSequencer Class
+ *
+ * Phase sequencing of a haptic pattern, without the timer or the PWM
+ * output: VibrationMotor calls advance() from its esp_timer callback,
+ * applies the returned edge and re-arms the one-shot with
+ * getTimerDelayUs(). Times are esp_timer microseconds passed in by the
+ * caller, so the sequence can be driven on the host with a simulated
+ * clock.
+ *
+ * Every phase ends at an absolute deadline (previous deadline + phase
+ * length), not at dispatch time + phase length: a late timer dispatch
+ * delays one edge but not the ones after it.
+ *
+ * Not thread-safe: VibrationMotor holds its spinlock around every call.
+ *
+ * The named pattern library lives here too (VibrationMotor::PATTERN_*
+ * refer to it), so host replays play the same patterns as the device.
+ */
+class HapticSequencer {
+public:
+    /**
+     * Pattern segment: vibrate at intensity for onMs, pause offMs, repeat
+     */
+    struct Segment {
+        uint8_t intensity;      // 0-100% (0 = silent step)
+        uint16_t onMs;
+        uint16_t offMs;
+        uint16_t repeat;        // Number of on/off cycles (0 = forever)
+    };
+
+    /**
+     * Haptic pattern (segments usually static const, i.e. in flash)
+     * The pattern ends with the last on phase (trailing pause is skipped)
+     */
+    struct Pattern {
+        const char* name;
+        const Segment* segments;
+        uint8_t segmentCount;
+    };
+
+    /**
+     * Output change at the end of a phase
+     */
+    enum Edge : uint8_t {
+        EDGE_NONE,              // Callback before the deadline (stale dispatch): ignore
+        EDGE_ON,                // Next on phase started at getIntensity()
+        EDGE_OFF,               // Pause started
+        EDGE_DONE               // Pattern complete, output off
+    };
+
+    // Pattern library
+    static const Pattern PATTERN_ACK;           // Touch acknowledge: short tick
+    static const Pattern PATTERN_LONG_PRESS;    // Long press accepted: extended buzz
+    static const Pattern PATTERN_ERROR;         // Error / cancel: three sharp pulses
+    static const Pattern PATTERN_FEED_DONE;     // Feeding complete: two soft pulses
+
+    static const Pattern* const PATTERN_LIBRARY[];
+    static const uint8_t PATTERN_LIBRARY_SIZE;
+
+    HapticSequencer();
+
+    /**
+     * Start a pattern with its first on phase at nowUs
+     *
+     * @param pattern: Pattern to play (segments must outlive playback, segmentCount > 0)
+     * @param nowUs: Current esp_timer time
+     */
+    void start(const Pattern& pattern, int64_t nowUs);
+
+    /**
+     * Forget the pattern (the caller stops the timer)
+     */
+    void cancel();
+
+    /**
+     * Move to the next phase if the current one has ended
+     *
+     * @param nowUs: Current esp_timer time
+     * @return: Edge to apply to the output
+     */
+    Edge advance(int64_t nowUs);
+
+    /**
+     * @return: One-shot delay to the end of the current phase (at least 1 µs)
+     */
+    uint64_t getTimerDelayUs(int64_t nowUs) const;
+
+    bool isActive() const { return pattern != nullptr; }
+    const Pattern* getPattern() const { return pattern; }
+    bool isPhaseOn() const { return phaseOn; }
+
+    /**
+     * @return: Intensity of the current segment
+     */
+    uint8_t getIntensity() const;
+
+    /**
+     * @return: esp_timer time the current phase ends
+     */
+    int64_t getPhaseDeadlineUs() const { return phaseDeadlineUs; }
+
+    /**
+     * @return: esp_timer time the pattern ends (0 = forever or not playing)
+     */
+    int64_t getPatternEndUs() const { return patternEndUs; }
+
+private:
+    const Pattern* pattern;
+    uint8_t segmentIndex;
+    uint16_t cycleIndex;
+    bool phaseOn;
+    int64_t phaseDeadlineUs;
+    int64_t patternEndUs;
+
+    void startOnPhase();
+};
+
+#endif // HAPTIC_SEQUENCER_H
@@ -0,0 +1,141 @@
+#include "index_sensor.h"
+#include "console_manager.h"
+#include "config.h"
+#include <esp_timer.h>
+
+/**
+ * Auger Index Sensor Implementation
+ *
+ * The ISR only timestamps the edge and bumps a counter; homing and lost-step
+ * checks run in StepperMotor::run() from the motor task.
+ */
+
+/**
+ * Constructor
+ *
+ * @param pin: GPIO connected to the sensor output
+ * @param activeLow: true if the output pulls LOW at the index (open collector)
+ */
+IndexSensor::IndexSensor(uint8_t pin, bool activeLow)
+    : pin(pin),
+      activeLow(activeLow),
+      isInitialized(false),
+      edgeCount(0),
+      lastEdgeUs(0),
+      edgePeriodUs(0) {
+}
+
+/**
+ * Configure the pin and attach the edge interrupt
+ * The pull-up keeps an unconnected or open-collector output idle
+ *
+ * @return: true if initialization successful
+ */
+bool IndexSensor::begin() {
+    pinMode(pin, INPUT_PULLUP);
+    attachInterruptArg(pin, &IndexSensor::onEdge, this, activeLow ? FALLING : RISING);
+    isInitialized = true;
+
+    Console::print(F("Index sensor ready on pin "));
+    Console::print(String(pin));
+    Console::print(F(" (active "));
+    Console::print(activeLow ? F("LOW") : F("HIGH"));
+    Console::println(F(")"));
+    return true;
+}
+
+/**
+ * Edge interrupt: timestamp the index pulse
+ *
+ * @param arg: IndexSensor instance
+ */
+void IRAM_ATTR IndexSensor::onEdge(void* arg) {
+    IndexSensor* sensor = static_cast<IndexSensor*>(arg);
+    int64_t now = esp_timer_get_time();
+    int64_t last = sensor->lastEdgeUs;
+
+    // Contact bounce / slow edges of the flag or magnet
+    if (last != 0 && now - last < INDEX_SENSOR_DEBOUNCE_US) {
+        return;
+    }
+
+    sensor->edgePeriodUs = last != 0 ? (uint32_t)(now - last) : 0;
+    sensor->lastEdgeUs = now;
+    sensor->edgeCount = sensor->edgeCount + 1;
+}
+
+/**
+ * Check if the index is under the sensor right now (raw level)
+ *
+ * @return: true at the index position
+ */
+bool IndexSensor::isActive() const {
+    bool level = digitalRead(pin) == HIGH;
+    return activeLow ? !level : level;
+}
+
+/**
+ * Get the number of index edges captured since begin()
+ *
+ * @return: Edge count (wraps at 2^32)
+ */
+uint32_t IndexSensor::getEdgeCount() const {
+    return edgeCount;
+}
+
+/**
+ * Get the capture time of the latest edge
+ * The 64-bit timestamp is not read atomically, so retry if an edge
+ * landed in between
+ *
+ * @return: esp_timer time in microseconds (0 if none yet)
+ */
+int64_t IndexSensor::getLastEdgeUs() const {
+    uint32_t count;
+    int64_t timeUs;
+    do {
+        count = edgeCount;
+        timeUs = lastEdgeUs;
+    } while (count != edgeCount);
+    return timeUs;
+}
+
+/**
+ * Get the time between the last two edges
+ *
+ * @return: Period in microseconds (0 until two edges were seen)
+ */
+uint32_t IndexSensor::getEdgePeriodUs() const {
+    return edgePeriodUs;
+}
+
+/**
+ * Check if begin() succeeded
+ */
+bool IndexSensor::isReady() const {
+    return isInitialized;
+}
+
+/**
+ * Print status report for debugging
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void IndexSensor::printStatus(Print& out) const {
+    out.println(F("Index Sensor Status:"));
+    out.print(F("  Pin: "));
+    out.println(pin);
+    out.print(F("  Active Logic: "));
+    out.println(activeLow ? "LOW" : "HIGH");
+    out.print(F("  At Index: "));
+    out.println(isActive() ? "YES" : "NO");
+    out.print(F("  Edges: "));
+    out.println(getEdgeCount());
+
+    uint32_t period = getEdgePeriodUs();
+    if (period > 0) {
+        out.print(F("  Last Revolution: "));
+        out.print(period / 1000);
+        out.println(F("ms"));
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef INDEX_SENSOR_H
+#define INDEX_SENSOR_H
+
+#include <Arduino.h>
+
+/**
+ * Auger Index Sensor (optical slot / hall switch)
+ *
+ * One pulse per auger revolution, used by StepperMotor to home the auger
+ * and to check for lost steps on every revolution.
+ *
+ * Hardware Requirements:
+ * - Slotted optical switch with a flag on the auger shaft, or a hall
+ *   switch (A3144 style, open collector) with a magnet on the shaft
+ * - ESP32 GPIO with internal pull-up (not GPIO 34-39)
+ *
+ * Features:
+ * - Active edge captured by a GPIO interrupt (esp_timer timestamp)
+ * - Edges closer than INDEX_SENSOR_DEBOUNCE_US are ignored in the ISR
+ * - Lock-free reads: consumers compare getEdgeCount() with the last
+ *   count they handled, so nothing is queued or lost between polls
+ * - Revolution period from consecutive edges
+ */
+class IndexSensor {
+public:
+    /**
+     * Constructor
+     *
+     * @param pin: GPIO connected to the sensor output
+     * @param activeLow: true if the output pulls LOW at the index (open collector)
+     */
+    IndexSensor(uint8_t pin, bool activeLow = true);
+
+    /**
+     * Configure the pin and attach the edge interrupt
+     *
+     * @return: true if initialization successful
+     */
+    bool begin();
+
+    /**
+     * Check if the index is under the sensor right now (raw level)
+     *
+     * @return: true at the index position
+     */
+    bool isActive() const;
+
+    /**
+     * Get the number of index edges captured since begin()
+     *
+     * @return: Edge count (wraps at 2^32)
+     */
+    uint32_t getEdgeCount() const;
+
+    /**
+     * Get the capture time of the latest edge
+     *
+     * @return: esp_timer time in microseconds (0 if none yet)
+     */
+    int64_t getLastEdgeUs() const;
+
+    /**
+     * Get the time between the last two edges
+     *
+     * @return: Period in microseconds (0 until two edges were seen)
+     */
+    uint32_t getEdgePeriodUs() const;
+
+    /**
+     * Check if begin() succeeded
+     */
+    bool isReady() const;
+
+    /**
+     * Print status report for debugging
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    uint8_t pin;
+    bool activeLow;
+    bool isInitialized;
+
+    // Written by the ISR only
+    volatile uint32_t edgeCount;
+    volatile int64_t lastEdgeUs;
+    volatile uint32_t edgePeriodUs;
+
+    static void onEdge(void* arg);
+};
+
+#endif // INDEX_SENSOR_H
@@ -0,0 +1,90 @@
+#include "input_log.h"
+
+namespace {
+
+const char SECTOR_MAGIC[4] = { 'F', 'F', 'I', 'R' };
+const uint8_t SECTOR_VERSION = 1;
+
+} // namespace
+
+void InputLog::initHeader(SectorHeader& header, uint32_t sequence) {
+    memcpy(header.magic, SECTOR_MAGIC, sizeof(SECTOR_MAGIC));
+    header.version = SECTOR_VERSION;
+    memset(header.reserved, 0xFF, sizeof(header.reserved));
+    header.sequence = sequence;
+}
+
+bool InputLog::isValidHeader(const SectorHeader& header) {
+    return memcmp(header.magic, SECTOR_MAGIC, sizeof(SECTOR_MAGIC)) == 0 && header.version == SECTOR_VERSION;
+}
+
+/**
+ * Encode one record
+ * Little-endian like the host tool expects (ESP32 is little-endian)
+ *
+ * @return: Bytes written
+ */
+size_t InputLog::writeRecord(uint8_t* out, Type type, uint32_t timeMs, const void* payload, uint8_t size) {
+    out[0] = type;
+    out[1] = size;
+    memcpy(out + 2, &timeMs, sizeof(timeMs));
+    if (size > 0) {
+        memcpy(out + RECORD_HEADER_SIZE, payload, size);
+    }
+    return RECORD_HEADER_SIZE + size;
+}
+
+InputLog::InputLog(const uint8_t* dump, size_t size)
+    : dump(dump), size(size), offset(0), inSector(false), damaged(false) {
+}
+
+/**
+ * Next record, crossing sector boundaries (header, records, NO_RECORD)
+ *
+ * @return: false at the end of the dump or at damaged data
+ */
+bool InputLog::next(Record& record) {
+    while (!damaged && offset < size) {
+        if (!inSector) {
+            SectorHeader header;
+            if (offset + sizeof(header) > size) {
+                damaged = true;
+                break;
+            }
+            memcpy(&header, dump + offset, sizeof(header));
+            if (!isValidHeader(header)) {
+                damaged = true;
+                break;
+            }
+            offset += sizeof(header);
+            inSector = true;
+            continue;
+        }
+
+        if (dump[offset] == NO_RECORD) {
+            offset++;
+            inSector = false;
+            continue;
+        }
+        if (offset + RECORD_HEADER_SIZE > size || offset + RECORD_HEADER_SIZE + dump[offset + 1] > size) {
+            damaged = true;
+            break;
+        }
+
+        record.type = (Type)dump[offset];
+        record.size = dump[offset + 1];
+        memcpy(&record.timeMs, dump + offset + 2, sizeof(record.timeMs));
+        record.payload = dump + offset + RECORD_HEADER_SIZE;
+        offset += RECORD_HEADER_SIZE + record.size;
+        return true;
+    }
+    return false;
+}
+
+uint32_t InputLog::readUint32(const Record& record) {
+    uint32_t value = 0;
+    if (record.size >= sizeof(value)) {
+        memcpy(&value, record.payload, sizeof(value));
+    }
+    return value;
+}
@@ -0,0 +1,107 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <Arduino.h>
+
+/**
+ * InputLog Class
+ *
+ * Record format of the input recorder, without the flash side: InputRecorder
+ * writes it to the SPIFFS sector ring, /api/inputs streams it, and
+ * tools/input_replay.py and InputReplay (host) read it back.
+ *
+ *   dump:   per sector, SectorHeader + records + one NO_RECORD byte
+ *   record: type (1), payload length (1), millis() (4, LE), payload
+ *
+ * The reader walks a dump held in memory; it needs no hardware, so
+ * recorded sessions are replayed in host tests (env:native).
+ */
+class InputLog {
+public:
+    /**
+     * Record types (payload in brackets)
+     */
+    enum Type : uint8_t {
+        TYPE_BOOT = 1,          // Recorder started after reset [reset reason (1)]
+        TYPE_START,             // Recording switched on at runtime
+        TYPE_SERIAL_LINE,       // Serial command line [text]
+        TYPE_TOUCH_EDGE,        // Raw touch input changed [1 = touched, 0 = released]
+        TYPE_HTTP_REQUEST,      // Web request [text "METHOD /uri?name=value&..."]
+        TYPE_WIFI_STATUS,       // WiFi.status() changed [wl_status_t (1)]
+        TYPE_RTC_READ,          // RTC read returned a new second [UTC epoch (4, LE)]
+        TYPE_DROPPED            // Records lost to a full staging buffer [count (4, LE)]
+    };
+
+    /**
+     * Header at the start of every used sector
+     */
+    struct SectorHeader {
+        char magic[4];          // "FFIR"
+        uint8_t version;
+        uint8_t reserved[3];
+        uint32_t sequence;      // Increases by one per sector written
+    };
+
+    /**
+     * One record of a dump (payload points into the dump)
+     */
+    struct Record {
+        Type type;
+        uint8_t size;
+        uint32_t timeMs;        // millis() when recorded
+        const uint8_t* payload;
+    };
+
+    static const uint8_t RECORD_HEADER_SIZE = 6;
+    static const uint8_t NO_RECORD = 0xFF;     // Erased flash, end of a sector's records
+
+    /**
+     * Fill in a sector header
+     */
+    static void initHeader(SectorHeader& header, uint32_t sequence);
+
+    /**
+     * @return: true if header starts a sector of this format version
+     */
+    static bool isValidHeader(const SectorHeader& header);
+
+    /**
+     * Encode one record (RECORD_HEADER_SIZE + size bytes at out)
+     *
+     * @return: Bytes written
+     */
+    static size_t writeRecord(uint8_t* out, Type type, uint32_t timeMs, const void* payload, uint8_t size);
+
+    /**
+     * Walk the records of a dump (sectors oldest first)
+     *
+     * @param dump: /api/inputs response
+     * @param size: Dump size in bytes
+     */
+    InputLog(const uint8_t* dump, size_t size);
+
+    /**
+     * @param record: Set to the next record
+     * @return: false at the end of the dump or at damaged data
+     */
+    bool next(Record& record);
+
+    /**
+     * @return: true if next() stopped at a bad sector header or a truncated record
+     */
+    bool isDamaged() const { return damaged; }
+
+    /**
+     * Little-endian 32-bit payload (RTC reads, drop counts)
+     */
+    static uint32_t readUint32(const Record& record);
+
+private:
+    const uint8_t* dump;
+    size_t size;
+    size_t offset;
+    bool inSector;
+    bool damaged;
+};
+
+#endif // INPUT_LOG_H
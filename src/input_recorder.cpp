@@ -0,0 +1,318 @@
+#include "input_recorder.h"
+#include "console_manager.h"
+#include "loop_watchdog.h"
+#include <esp_system.h>
+
+/**
+ * Input Recorder Implementation
+ *
+ * Flash is only touched from begin(), flush(), clear() and writeDump().
+ * The newest sector is found by its sequence number, so no position has to
+ * be stored anywhere else; a fresh or cleared ring starts at sector 0.
+ */
+
+const esp_partition_t* InputRecorder::partition = nullptr;
+uint16_t InputRecorder::sectorCount = 0;
+uint16_t InputRecorder::currentSector = 0;
+uint16_t InputRecorder::sectorOffset = 0;
+uint32_t InputRecorder::sequence = 0;
+bool InputRecorder::enabled = false;
+
+uint8_t InputRecorder::staging[INPUT_RECORDER_BUFFER_BYTES];
+size_t InputRecorder::stagedBytes = 0;
+uint32_t InputRecorder::droppedRecords = 0;
+uint32_t InputRecorder::totalDropped = 0;
+uint32_t InputRecorder::totalRecords = 0;
+
+/**
+ * Find the flash ring, continue after the newest record and, when
+ * recording, write the boot record
+ *
+ * @param enabled: Start recording (input.record)
+ * @return: false if the partition is missing (recorder stays off)
+ */
+bool InputRecorder::begin(bool enabled) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+    uint32_t bytes = partition ? partition->size : 0;
+    if (bytes > INPUT_RECORDER_FLASH_BYTES) {
+        bytes = INPUT_RECORDER_FLASH_BYTES;
+    }
+    sectorCount = bytes / INPUT_RECORDER_SECTOR_SIZE;
+    if (sectorCount < 2) {
+        partition = nullptr;
+        Console::printlnR(F("Input recorder: no SPIFFS partition - recording unavailable"));
+        return false;
+    }
+
+    // Continue in the newest sector; an empty ring starts at sector 0
+    bool found = false;
+    currentSector = sectorCount - 1;
+    sectorOffset = INPUT_RECORDER_SECTOR_SIZE;
+    sequence = 0xFFFFFFFF;
+    for (uint16_t sector = 0; sector < sectorCount; sector++) {
+        SectorHeader header;
+        if (readHeader(sector, header) && (!found || (int32_t)(header.sequence - sequence) > 0)) {
+            found = true;
+            currentSector = sector;
+            sequence = header.sequence;
+        }
+    }
+    if (found) {
+        sectorOffset = findSectorEnd(currentSector);
+    }
+
+    InputRecorder::enabled = enabled;
+    recordByte(TYPE_BOOT, (uint8_t)esp_reset_reason());
+
+    Console::printR(F("Input recorder: "));
+    Console::printR(String(sectorCount * INPUT_RECORDER_SECTOR_SIZE / 1024));
+    Console::printR(F(" KB flash ring, recording "));
+    Console::printlnR(enabled ? F("ON") : F("OFF"));
+    return true;
+}
+
+/**
+ * Start/stop recording (staged records are kept for the next flush)
+ */
+void InputRecorder::setEnabled(bool enabled) {
+    if (!partition) {
+        return;
+    }
+    bool starting = enabled && !InputRecorder::enabled;
+    InputRecorder::enabled = enabled;
+    if (starting) {
+        record(TYPE_START, nullptr, 0);
+    }
+}
+
+bool InputRecorder::isEnabled() {
+    return enabled;
+}
+
+/**
+ * Stage one record (dropped and counted if the staging buffer is full)
+ *
+ * @param type: Record type
+ * @param payload: Payload bytes (may be nullptr if size is 0)
+ * @param size: Payload size (truncated to INPUT_RECORDER_MAX_PAYLOAD)
+ */
+void InputRecorder::record(Type type, const void* payload, size_t size) {
+    if (!enabled) {
+        return;
+    }
+    if (size > INPUT_RECORDER_MAX_PAYLOAD) {
+        size = INPUT_RECORDER_MAX_PAYLOAD;
+    }
+    if (stagedBytes + RECORD_HEADER_SIZE + size > sizeof(staging)) {
+        droppedRecords++;
+        totalDropped++;
+        return;
+    }
+
+    stagedBytes += writeRecord(staging + stagedBytes, type, millis(), payload, (uint8_t)size);
+    totalRecords++;
+}
+
+/**
+ * Stage a text record (without the terminator)
+ */
+void InputRecorder::recordText(Type type, const char* text) {
+    record(type, text, strlen(text));
+}
+
+/**
+ * Stage a single-byte record
+ */
+void InputRecorder::recordByte(Type type, uint8_t value) {
+    record(type, &value, 1);
+}
+
+/**
+ * Write staged records to flash (erases the next sector when the
+ * current one is full)
+ */
+void InputRecorder::flush() {
+    if (!partition || (stagedBytes == 0 && droppedRecords == 0)) {
+        return;
+    }
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_FLASH_WRITE);
+
+    // Staged records go out as contiguous runs, split where a record would
+    // cross into the next sector
+    size_t runStart = 0;
+    size_t position = 0;
+    while (position < stagedBytes) {
+        size_t recordSize = RECORD_HEADER_SIZE + staging[position + 1];
+        if (sectorOffset + (position - runStart) + recordSize > INPUT_RECORDER_SECTOR_SIZE) {
+            writeRun(staging + runStart, position - runStart);
+            runStart = position;
+            if (!startSector((currentSector + 1) % sectorCount)) {
+                stagedBytes = 0;
+                return;
+            }
+        }
+        position += recordSize;
+    }
+    writeRun(staging + runStart, stagedBytes - runStart);
+    stagedBytes = 0;
+
+    // Drops happened after the staged records, so their count follows them
+    if (droppedRecords > 0) {
+        bool wasEnabled = enabled;
+        enabled = true;
+        record(TYPE_DROPPED, &droppedRecords, sizeof(droppedRecords));
+        enabled = wasEnabled;
+        droppedRecords = 0;
+        flush();
+    }
+}
+
+/**
+ * Erase the whole ring (blocks for a few seconds)
+ */
+void InputRecorder::clear() {
+    if (!partition) {
+        return;
+    }
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_FLASH_WRITE);
+    esp_partition_erase_range(partition, 0, (size_t)sectorCount * INPUT_RECORDER_SECTOR_SIZE);
+    currentSector = sectorCount - 1;
+    sectorOffset = INPUT_RECORDER_SECTOR_SIZE;
+    sequence = 0xFFFFFFFF;
+}
+
+/**
+ * Stream the used sectors, oldest first, as a binary dump
+ * (flushes first)
+ *
+ * Each sector is sent as its header and records followed by one 0xFF
+ * byte, without the erased tail.
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void InputRecorder::writeDump(Print& out) {
+    if (!partition) {
+        return;
+    }
+    flush();
+
+    uint8_t chunk[256];
+    for (uint16_t i = 1; i <= sectorCount; i++) {
+        uint16_t sector = (currentSector + i) % sectorCount;
+        SectorHeader header;
+        if (!readHeader(sector, header)) {
+            continue;
+        }
+        uint32_t base = (uint32_t)sector * INPUT_RECORDER_SECTOR_SIZE;
+        uint16_t end = sector == currentSector ? sectorOffset : findSectorEnd(sector);
+        for (uint16_t offset = 0; offset < end; offset += sizeof(chunk)) {
+            size_t size = end - offset;
+            if (size > sizeof(chunk)) {
+                size = sizeof(chunk);
+            }
+            if (esp_partition_read(partition, base + offset, chunk, size) != ESP_OK) {
+                break;
+            }
+            out.write(chunk, size);
+        }
+        out.write(NO_RECORD);
+    }
+}
+
+/**
+ * Print state, flash usage and drop count
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void InputRecorder::printStatus(Print& out) {
+    out.println(F("Input Recorder Status:"));
+    if (!partition) {
+        out.println(F("  Unavailable (no SPIFFS partition)"));
+        return;
+    }
+
+    uint16_t used = 0;
+    for (uint16_t sector = 0; sector < sectorCount; sector++) {
+        SectorHeader header;
+        if (readHeader(sector, header)) {
+            used++;
+        }
+    }
+
+    out.print(F("  Recording: "));
+    out.println(enabled ? "ON" : "OFF");
+    out.print(F("  Flash: "));
+    out.print(used);
+    out.print(F(" of "));
+    out.print(sectorCount);
+    out.print(F(" sectors used ("));
+    out.print(INPUT_RECORDER_SECTOR_SIZE);
+    out.println(F(" bytes each)"));
+    out.print(F("  Staged: "));
+    out.print((unsigned long)stagedBytes);
+    out.print(F(" of "));
+    out.print(INPUT_RECORDER_BUFFER_BYTES);
+    out.println(F(" bytes"));
+    out.print(F("  Records: "));
+    out.print(totalRecords);
+    out.print(F(" since boot, "));
+    out.print(totalDropped);
+    out.println(F(" dropped"));
+}
+
+bool InputRecorder::readHeader(uint16_t sector, SectorHeader& header) {
+    if (esp_partition_read(partition, (uint32_t)sector * INPUT_RECORDER_SECTOR_SIZE, &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    return isValidHeader(header);
+}
+
+/**
+ * Walk the records of a sector
+ *
+ * @return: Offset of the first free byte
+ */
+uint16_t InputRecorder::findSectorEnd(uint16_t sector) {
+    uint32_t base = (uint32_t)sector * INPUT_RECORDER_SECTOR_SIZE;
+    uint16_t offset = sizeof(SectorHeader);
+    while (offset + RECORD_HEADER_SIZE <= INPUT_RECORDER_SECTOR_SIZE) {
+        uint8_t head[2];
+        if (esp_partition_read(partition, base + offset, head, sizeof(head)) != ESP_OK ||
+            head[0] == NO_RECORD || head[0] == 0 ||
+            offset + RECORD_HEADER_SIZE + head[1] > INPUT_RECORDER_SECTOR_SIZE) {
+            break;
+        }
+        offset += RECORD_HEADER_SIZE + head[1];
+    }
+    return offset;
+}
+
+/**
+ * Erase a sector and make it the current one
+ *
+ * @return: false on a flash error (recording is switched off)
+ */
+bool InputRecorder::startSector(uint16_t sector) {
+    uint32_t base = (uint32_t)sector * INPUT_RECORDER_SECTOR_SIZE;
+    SectorHeader header;
+    initHeader(header, sequence + 1);
+
+    if (esp_partition_erase_range(partition, base, INPUT_RECORDER_SECTOR_SIZE) != ESP_OK ||
+        esp_partition_write(partition, base, &header, sizeof(header)) != ESP_OK) {
+        Console::printlnR(F("✗ Input recorder: flash write failed - recording OFF"));
+        enabled = false;
+        return false;
+    }
+    currentSector = sector;
+    sectorOffset = sizeof(header);
+    sequence = header.sequence;
+    return true;
+}
+
+void InputRecorder::writeRun(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    esp_partition_write(partition, (uint32_t)currentSector * INPUT_RECORDER_SECTOR_SIZE + sectorOffset, data, size);
+    sectorOffset += size;
+}
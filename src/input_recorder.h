@@ -0,0 +1,118 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+#include "input_log.h"
+
+/**
+ * Input Recorder
+ *
+ * Captures the external stimuli the firmware reacts to, with millisecond
+ * timestamps, into a ring of flash sectors that survives reboots: serial
+ * command lines, raw touch edges, HTTP requests (method, URI and
+ * arguments), WiFi status changes and RTC readings. A field unit that
+ * shows a timing problem can record for a while, and tools/input_replay.py
+ * replays the same sequence with the original timing against a bench unit
+ * (serial lines, touch edges via TOUCH INJECT, HTTP requests) while it is
+ * profiled or traced. InputReplay replays it on the host under a virtual
+ * clock through the hardware-free modules (test/test_input_replay).
+ *
+ * record() only appends to a RAM staging buffer; flush() (INPUT FLUSH task)
+ * moves it to flash, so nothing on the input paths waits for flash. Records
+ * arriving while the buffer is full are dropped and counted, and the count
+ * is written to the ring on the next flush.
+ *
+ * Flash layout (the first INPUT_RECORDER_FLASH_BYTES of the SPIFFS data
+ * partition, which this firmware does not otherwise use):
+ *   sector: SectorHeader, then records until the first 0xFF type byte
+ *   record: type (1), payload length (1), millis() (4, LE), payload
+ * Records never span sectors. When the ring is full the oldest sector is
+ * erased. Each boot starts with a TYPE_BOOT record.
+ *
+ * All inputs arrive on the loop task, so no locking is needed.
+ */
+class InputRecorder : public InputLog {
+public:
+    /**
+     * Find the flash ring, continue after the newest record and, when
+     * recording, write the boot record
+     *
+     * @param enabled: Start recording (input.record)
+     * @return: false if the partition is missing (recorder stays off)
+     */
+    static bool begin(bool enabled);
+
+    /**
+     * Start/stop recording (staged records are kept for the next flush)
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Stage one record (dropped and counted if the staging buffer is full)
+     *
+     * @param type: Record type
+     * @param payload: Payload bytes (may be nullptr if size is 0)
+     * @param size: Payload size (truncated to INPUT_RECORDER_MAX_PAYLOAD)
+     */
+    static void record(Type type, const void* payload, size_t size);
+
+    /**
+     * Stage a text record (without the terminator)
+     */
+    static void recordText(Type type, const char* text);
+
+    /**
+     * Stage a single-byte record
+     */
+    static void recordByte(Type type, uint8_t value);
+
+    /**
+     * Write staged records to flash (erases the next sector when the
+     * current one is full)
+     */
+    static void flush();
+
+    /**
+     * Erase the whole ring (blocks for a few seconds)
+     */
+    static void clear();
+
+    /**
+     * Stream the used sectors, oldest first, as a binary dump
+     * (flushes first)
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    static void writeDump(Print& out);
+
+    /**
+     * Print state, flash usage and drop count
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    static void printStatus(Print& out);
+
+private:
+    static const esp_partition_t* partition;
+    static uint16_t sectorCount;
+    static uint16_t currentSector;
+    static uint16_t sectorOffset;   // Next write position in the current sector
+    static uint32_t sequence;       // Sequence of the current sector
+    static bool enabled;
+
+    static uint8_t staging[INPUT_RECORDER_BUFFER_BYTES];
+    static size_t stagedBytes;
+    static uint32_t droppedRecords;     // Since the last flush
+    static uint32_t totalDropped;
+    static uint32_t totalRecords;
+
+    static bool readHeader(uint16_t sector, SectorHeader& header);
+    static uint16_t findSectorEnd(uint16_t sector);
+    static bool startSector(uint16_t sector);
+    static void writeRun(const uint8_t* data, size_t size);
+};
+
+#endif // INPUT_RECORDER_H
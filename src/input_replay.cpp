@@ -0,0 +1,482 @@
+#include "input_replay.h"
+#include "string_builder.h"
+#include "stroke_plan.h"
+
+/**
+ * Input Replay Implementation
+ *
+ * A discrete-event loop: advanceTo() runs every timed event due before the
+ * next record in deadline order, then the record is applied at its own
+ * time. Nothing here reads a real clock.
+ */
+
+namespace {
+
+// Serial lines and request lines are at most one record payload
+typedef FixedString<INPUT_RECORDER_MAX_PAYLOAD> InputLine;
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Value of one argument of a recorded request ("METHOD /uri?name=value&...")
+ *
+ * @return: false if the argument is missing
+ */
+bool findArg(const char* request, const char* name, InputLine& value) {
+    const char* query = strchr(request, '?');
+    size_t nameLength = strlen(name);
+    while (query) {
+        const char* arg = query + 1;
+        query = strchr(arg, '&');
+        if (strncmp(arg, name, nameLength) != 0 || arg[nameLength] != '=') {
+            continue;
+        }
+
+        // URL-decoded like WebServer::arg()
+        value.clear();
+        for (const char* c = arg + nameLength + 1; *c && *c != '&'; c++) {
+            if (*c == '+') {
+                value.append(' ');
+            } else if (*c == '%' && hexValue(c[1]) >= 0 && hexValue(c[2]) >= 0) {
+                value.append((char)(hexValue(c[1]) * 16 + hexValue(c[2])));
+                c += 2;
+            } else {
+                value.append(*c);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// Same rule as the FEED command: missing or invalid counts mean one portion
+int parsePortions(const char* text) {
+    int portions = atoi(text);
+    return portions > 0 ? portions : 1;
+}
+
+} // namespace
+
+InputReplay::InputReplay()
+    : schedules(nullptr), scheduleCount(0), lastCompleted(0), autotuneTrial(nullptr) {
+    calendar.setTimezone(&zone);
+    reset();
+}
+
+void InputReplay::setSchedules(const ScheduledFeeding* newSchedules, uint8_t count) {
+    schedules = newSchedules;
+    scheduleCount = count;
+}
+
+/**
+ * Replay a whole dump
+ * Events still pending after the last record (a feeding, a pattern) run to
+ * their end; the schedule monitor does not tick past it
+ *
+ * @return: false if the dump is damaged
+ */
+bool InputReplay::run(const uint8_t* dump, size_t size) {
+    reset();
+
+    InputLog log(dump, size);
+    InputLog::Record record;
+    while (log.next(record)) {
+        if (!sessionStarted || record.type == InputLog::TYPE_BOOT) {
+            if (sessionStarted) {
+                // The time between sessions is unknown: the reboot follows right away
+                reboot();
+            }
+            sessionBaseUs = nowUs;
+            sessionFirstMs = record.timeMs;
+            sessionStarted = true;
+        }
+
+        // millis() differences stay correct across its 49-day wrap
+        advanceTo(sessionBaseUs + (int64_t)(uint32_t)(record.timeMs - sessionFirstMs) * 1000);
+        handleRecord(record);
+    }
+
+    // Let the running feeding and patterns end
+    rtcValid = false;
+    while (feeding || tuning || haptic.isActive()) {
+        advanceTo(nextEventUs());
+    }
+    return !log.isDamaged();
+}
+
+/**
+ * Start a replay from power-on
+ */
+void InputReplay::reset() {
+    nowUs = 0;
+    sessionBaseUs = 0;
+    sessionFirstMs = 0;
+    sessionStarted = false;
+    feedingCount = 0;
+    memset(&stats, 0, sizeof(stats));
+    reboot();
+}
+
+/**
+ * Device reset: only the time zone and last feeding (NVRAM) survive
+ */
+void InputReplay::reboot() {
+    stopPattern();
+    if (feeding && feedingCount > 0) {
+        feedings[feedingCount - 1].cancelled = true;
+    }
+    feeding = false;
+    tuning = false;
+    motorDoneUs = 0;
+    autotune = AutotuneSearch();
+
+    rtcUtc = 0;
+    rtcAtUs = 0;
+    rtcValid = false;
+    nextEpoch = 0;
+    nextIndex = -1;
+    nextTickUs = nowUs + (int64_t)FEEDING_SCHEDULE_MONITOR_INTERVAL * 1000;
+
+    rawTouched = false;
+    pendingTouched = false;
+    touched = false;
+    longPressDone = false;
+    rawChangeUs = nowUs;
+    touchStartUs = nowUs;
+    vibrationOnUs = nowUs;
+    trialPassed = false;
+}
+
+/**
+ * Run every timed event due up to targetUs, earliest first
+ */
+void InputReplay::advanceTo(int64_t targetUs) {
+    while (true) {
+        int64_t dueUs = nextEventUs();
+        if (dueUs > targetUs) {
+            break;
+        }
+        nowUs = dueUs;
+
+        if (haptic.isActive() && haptic.getPhaseDeadlineUs() <= nowUs) {
+            advancePattern();
+        }
+        if ((feeding || tuning) && motorDoneUs <= nowUs) {
+            endMotorMove();
+        }
+        updateTouch();
+        if (rtcValid && nextTickUs <= nowUs) {
+            nextTickUs += (int64_t)FEEDING_SCHEDULE_MONITOR_INTERVAL * 1000;
+            tickSchedules();
+        }
+    }
+    if (targetUs > nowUs) {
+        nowUs = targetUs;
+    }
+}
+
+/**
+ * @return: Time of the earliest pending event (INT64_MAX if none)
+ */
+int64_t InputReplay::nextEventUs() const {
+    int64_t dueUs = INT64_MAX;
+    if (haptic.isActive() && haptic.getPhaseDeadlineUs() < dueUs) {
+        dueUs = haptic.getPhaseDeadlineUs();
+    }
+    if ((feeding || tuning) && motorDoneUs < dueUs) {
+        dueUs = motorDoneUs;
+    }
+    if (pendingTouched != touched) {
+        int64_t debouncedUs = rawChangeUs + (int64_t)TOUCH_SENSOR_DEBOUNCE_DELAY * 1000;
+        if (debouncedUs < dueUs) dueUs = debouncedUs;
+    }
+    if (touched && !longPressDone) {
+        int64_t longPressUs = touchStartUs + (int64_t)TOUCH_SENSOR_LONG_PRESS_DURATION * 1000;
+        if (longPressUs < dueUs) dueUs = longPressUs;
+    }
+    if (rtcValid && nextTickUs < dueUs) {
+        dueUs = nextTickUs;
+    }
+    return dueUs < nowUs ? nowUs : dueUs;
+}
+
+void InputReplay::handleRecord(const InputLog::Record& record) {
+    stats.records++;
+
+    InputLine text;
+    switch (record.type) {
+        case InputLog::TYPE_SERIAL_LINE:
+        case InputLog::TYPE_HTTP_REQUEST:
+            for (uint8_t i = 0; i < record.size; i++) {
+                text.append((char)record.payload[i]);
+            }
+            if (record.type == InputLog::TYPE_SERIAL_LINE) {
+                stats.serialLines++;
+                handleCommand(text.c_str());
+            } else {
+                stats.httpRequests++;
+                handleRequest(text.c_str());
+            }
+            break;
+
+        case InputLog::TYPE_TOUCH_EDGE:
+            // TouchSensor restarts the debounce on every raw change
+            rawTouched = record.size > 0 && record.payload[0] != 0;
+            if (rawTouched != pendingTouched) {
+                pendingTouched = rawTouched;
+                rawChangeUs = nowUs;
+            }
+            break;
+
+        case InputLog::TYPE_BOOT:
+            stats.boots++;
+            break;
+
+        case InputLog::TYPE_RTC_READ:
+            rtcUtc = InputLog::readUint32(record);
+            rtcAtUs = nowUs;
+            rtcValid = true;
+            break;
+
+        case InputLog::TYPE_WIFI_STATUS:
+            stats.wifiChanges++;
+            break;
+
+        case InputLog::TYPE_DROPPED:
+            stats.droppedRecords += InputLog::readUint32(record);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * Serial command, normalized like CommandListener (trimmed, upper case)
+ */
+void InputReplay::handleCommand(const char* line) {
+    InputLine command(line);
+    command.trim();
+    command.toUpperCase();
+
+    if (command.equals("FEED") || (command.startsWith("FEED ") && !command.startsWith("FEED PROFILE"))) {
+        startFeeding(SOURCE_SERIAL, -1, command.length() > 5 ? parsePortions(command.c_str() + 5) : 1);
+    } else if (command.startsWith("NTP TZ ")) {
+        // The POSIX string keeps its case in the recording
+        InputLine posix(line);
+        posix.trim();
+        setTimezone(posix.c_str() + 7);
+    } else if (command.equals("MOTOR AUTOTUNE START")) {
+        if (!autotuneTrial || feeding || tuning) {
+            stats.ignoredInputs++;
+            return;
+        }
+        autotune.begin(
+            AutotuneSearch::Axis { AUTOTUNE_START_SPEED, AUTOTUNE_MAX_SPEED, AUTOTUNE_SPEED_STEP, AUTOTUNE_MIN_SPEED_STEP },
+            AutotuneSearch::Axis { AUTOTUNE_START_ACCEL, AUTOTUNE_MAX_ACCEL, AUTOTUNE_ACCEL_STEP, AUTOTUNE_MIN_ACCEL_STEP },
+            AUTOTUNE_RUNS_PER_SETTING, AUTOTUNE_MARGIN_PERCENT);
+        startAutotuneTrial();
+    } else if (command.equals("MOTOR AUTOTUNE STOP")) {
+        tuning = false;
+        autotune = AutotuneSearch();
+    } else {
+        stats.ignoredInputs++;
+    }
+}
+
+/**
+ * Recorded web request ("METHOD /uri?name=value&...")
+ */
+void InputReplay::handleRequest(const char* request) {
+    InputLine value;
+    if (strncmp(request, "GET /api/feed?", 14) == 0 && findArg(request, "portions", value)) {
+        startFeeding(SOURCE_WEB, -1, atoi(value.c_str()));
+    } else if (strncmp(request, "GET /api/timezone/set?", 22) == 0 && findArg(request, "tz", value)) {
+        setTimezone(value.c_str());
+    } else {
+        stats.ignoredInputs++;
+    }
+}
+
+bool InputReplay::setTimezone(const char* posix) {
+    if (!zone.set(posix)) {
+        stats.ignoredInputs++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @return: Wall clock from the last RTC read plus the time since
+ */
+uint32_t InputReplay::currentUtc() const {
+    return rtcValid ? rtcUtc + (uint32_t)((nowUs - rtcAtUs) / 1000000) : 0;
+}
+
+/**
+ * One schedule monitor pass, in FeedingSchedule::processSchedules() order
+ */
+void InputReplay::tickSchedules() {
+    if (!schedules || scheduleCount == 0 || feeding) {
+        return;
+    }
+    uint32_t now = currentUtc();
+    calendar.refreshAnchor(now);
+
+    uint32_t missedEpoch = 0;
+    int8_t missed = calendar.findMissed(schedules, scheduleCount, now, lastCompleted,
+                                        FEEDING_SCHEDULE_TOLERANCE_MINUTES, FEEDING_SCHEDULE_MAX_RECOVERY_HOURS, missedEpoch);
+    if (missed >= 0) {
+        startFeeding(SOURCE_RECOVERY, missed, schedules[missed].portions);
+    }
+
+    if (!feeding && nextEpoch != 0 && now >= nextEpoch && now - nextEpoch <= FEEDING_SCHEDULE_TRIGGER_WINDOW) {
+        startFeeding(SOURCE_SCHEDULE, nextIndex, schedules[nextIndex].portions);
+    }
+
+    nextIndex = calendar.findNext(schedules, scheduleCount, now, nextEpoch);
+}
+
+/**
+ * TouchSensor::update() at the current time
+ */
+void InputReplay::updateTouch() {
+    if (pendingTouched != touched && nowUs - rawChangeUs >= (int64_t)TOUCH_SENSOR_DEBOUNCE_DELAY * 1000) {
+        touched = pendingTouched;
+        if (touched) {
+            touchStartUs = nowUs;
+            longPressDone = false;
+            stats.touchPresses++;
+            playPattern(HapticSequencer::PATTERN_ACK);
+        }
+    }
+
+    if (touched && !longPressDone && nowUs - touchStartUs >= (int64_t)TOUCH_SENSOR_LONG_PRESS_DURATION * 1000) {
+        longPressDone = true;
+        stats.longPresses++;
+
+        // onTouchEvent(): a long press cancels a running feeding, else starts one
+        if (feeding) {
+            cancelFeeding();
+        } else {
+            playPattern(HapticSequencer::PATTERN_LONG_PRESS);
+            startFeeding(SOURCE_TOUCH, -1, DEFAULT_TOUCH_LONG_PRESS_PORTIONS);
+        }
+    }
+}
+
+/**
+ * startFeeding() in main.cpp: one feeding at a time, last feeding time
+ * recorded for the schedule
+ *
+ * @return: true if the feeding started
+ */
+bool InputReplay::startFeeding(Source source, int8_t schedule, int portions) {
+    if (!isValidPortionCount(portions)) {
+        stats.ignoredInputs++;
+        return false;
+    }
+    if (feeding || tuning) {
+        stats.rejectedFeedings++;
+        return false;
+    }
+
+    const DispenseProfile& profile = DISPENSE_PROFILES[DEFAULT_DISPENSE_PROFILE];
+    feeding = true;
+    motorDoneUs = nowUs + StrokePlan::estimateDuration(portionsToSteps(portions), DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION,
+                                                       profile.strokeSteps, profile.reverseSteps);
+    if (rtcValid) {
+        lastCompleted = currentUtc();
+    }
+
+    if (feedingCount < MAX_FEEDINGS) {
+        Feeding& entry = feedings[feedingCount++];
+        entry.atMs = getNowMs();
+        entry.utc = currentUtc();
+        entry.source = source;
+        entry.schedule = schedule;
+        entry.portions = (uint8_t)portions;
+        entry.cancelled = false;
+    }
+    return true;
+}
+
+/**
+ * The running feeding or autotune trial reached its end
+ */
+void InputReplay::endMotorMove() {
+    if (feeding) {
+        feeding = false;
+        playPattern(HapticSequencer::PATTERN_FEED_DONE);
+        return;
+    }
+
+    tuning = false;
+    autotune.report(trialPassed);
+    if (!autotune.isFinished()) {
+        startAutotuneTrial();
+    }
+}
+
+/**
+ * cancelFeeding() in main.cpp: motor stops, error pattern
+ */
+void InputReplay::cancelFeeding() {
+    feeding = false;
+    if (feedingCount > 0) {
+        feedings[feedingCount - 1].cancelled = true;
+    }
+    playPattern(HapticSequencer::PATTERN_ERROR);
+}
+
+/**
+ * Next trial at the search's candidate, as long as MotorAutotune::startTrial() makes it
+ */
+void InputReplay::startAutotuneTrial() {
+    float speed = autotune.getTrialSpeed();
+    float accel = autotune.getTrialAcceleration();
+
+    uint16_t revolutions = (uint16_t)ceilf((speed * speed / accel) / STEPS_PER_REVOLUTION) + 1;
+    if (revolutions < AUTOTUNE_MIN_TRIAL_REVOLUTIONS) {
+        revolutions = AUTOTUNE_MIN_TRIAL_REVOLUTIONS;
+    }
+
+    tuning = true;
+    trialPassed = autotuneTrial(speed, accel);
+    motorDoneUs = nowUs + StrokePlan::estimateDuration((long)revolutions * STEPS_PER_REVOLUTION, speed, accel);
+    stats.autotuneTrials++;
+}
+
+void InputReplay::playPattern(const HapticSequencer::Pattern& pattern) {
+    stopPattern();
+    haptic.start(pattern, nowUs);
+    vibrationOnUs = nowUs;
+    stats.hapticPatterns++;
+}
+
+void InputReplay::stopPattern() {
+    if (haptic.isActive() && haptic.isPhaseOn()) {
+        stats.vibrationMs += (uint32_t)((nowUs - vibrationOnUs) / 1000);
+    }
+    haptic.cancel();
+}
+
+/**
+ * Phase end: the esp_timer callback of VibrationMotor
+ */
+void InputReplay::advancePattern() {
+    bool wasOn = haptic.isPhaseOn();
+    if (haptic.advance(nowUs) == HapticSequencer::EDGE_NONE) {
+        return;
+    }
+    // On phases without a pause between them count as one run
+    if (wasOn) {
+        stats.vibrationMs += (uint32_t)((nowUs - vibrationOnUs) / 1000);
+    }
+    vibrationOnUs = nowUs;
+}
@@ -0,0 +1,194 @@
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "input_log.h"
+#include "time_zone.h"
+#include "schedule_calendar.h"
+#include "haptic_sequencer.h"
+#include "autotune_search.h"
+
+/**
+ * InputReplay Class
+ *
+ * Host-side replay of an input recording (/api/inputs) under a virtual
+ * clock. The records drive the hardware-free modules the way the firmware
+ * glue does, and every timed event (touch debounce and long press, haptic
+ * phase ends, schedule monitor ticks, the end of a feeding or autotune
+ * trial) runs at its exact deadline, so the same recording always gives
+ * the same result and a day of inputs replays in milliseconds:
+ *
+ * - RTC reads set the wall clock; the schedule monitor ticks every
+ *   FEEDING_SCHEDULE_MONITOR_INTERVAL through ScheduleCalendar with the
+ *   recorded unit's schedules (setSchedules()), TimeZone and last feeding
+ * - Raw touch edges go through the TouchSensor debounce and long press
+ *   rules: press plays the ack pattern, a long press starts a feeding (or
+ *   cancels the one running) with the matching HapticSequencer pattern
+ * - Serial lines and HTTP requests that change this state are applied:
+ *   FEED [n], NTP TZ <posix>, MOTOR AUTOTUNE START|STOP, /api/feed,
+ *   /api/timezone/set; anything else is only counted
+ * - Feedings take StrokePlan::estimateDuration() of the default speed and
+ *   dispense profile and play the feed-done pattern when they end
+ * - MOTOR AUTOTUNE runs AutotuneSearch with trials judged by
+ *   setAutotuneTrial() (the host has no motor) and timed like the device
+ *
+ * Each TYPE_BOOT record is a reboot: millis() restarts, the wall clock is
+ * unknown until the next RTC read, and only the last feeding time (NVRAM)
+ * and the time zone survive. The replay clock keeps counting across boots.
+ *
+ * Host tests only (env:native); the firmware build excludes it.
+ */
+class InputReplay {
+public:
+    /**
+     * Stand-in for the motor and index sensor during MOTOR AUTOTUNE
+     *
+     * @return: true if the trial at this setting would run without missed steps
+     */
+    typedef bool (*AutotuneTrial)(float speed, float acceleration);
+
+    enum Source : uint8_t {
+        SOURCE_SCHEDULE,
+        SOURCE_RECOVERY,        // Missed schedule fed late
+        SOURCE_TOUCH,
+        SOURCE_SERIAL,
+        SOURCE_WEB
+    };
+
+    struct Feeding {
+        uint32_t atMs;          // Replay clock at the start
+        uint32_t utc;           // Replayed wall clock (0 = unknown)
+        Source source;
+        int8_t schedule;        // Schedule index (schedule, recovery), else -1
+        uint8_t portions;
+        bool cancelled;         // Stopped by a long press
+    };
+
+    struct Stats {
+        uint32_t records;
+        uint16_t boots;
+        uint32_t serialLines;
+        uint32_t httpRequests;
+        uint32_t ignoredInputs;         // Commands and requests the replay does not model
+        uint16_t touchPresses;
+        uint16_t longPresses;
+        uint16_t wifiChanges;
+        uint32_t droppedRecords;        // Lost on the device (TYPE_DROPPED)
+        uint16_t hapticPatterns;
+        uint32_t vibrationMs;           // Time the vibration motor was on
+        uint16_t rejectedFeedings;      // Refused while another feeding ran
+        uint16_t autotuneTrials;
+    };
+
+    static const uint8_t MAX_FEEDINGS = 64;
+
+    InputReplay();
+
+    /**
+     * Schedule table of the recorded unit (NVRAM is not in the recording)
+     *
+     * @param schedules: Entries (must outlive the replay)
+     * @param count: Number of entries
+     */
+    void setSchedules(const ScheduledFeeding* schedules, uint8_t count);
+
+    /**
+     * Last feeding time stored in NVRAM when the recording started
+     */
+    void setLastCompleted(uint32_t utc) { lastCompleted = utc; }
+
+    void setAutotuneTrial(AutotuneTrial trial) { autotuneTrial = trial; }
+
+    /**
+     * Time zone of the recorded unit (UTC until set)
+     */
+    TimeZone& getTimezone() { return zone; }
+
+    /**
+     * Replay a whole dump, then let the last events (feeding, patterns) finish
+     *
+     * @param dump: /api/inputs response
+     * @param size: Dump size in bytes
+     * @return: false if the dump is damaged (records up to the damage are replayed)
+     */
+    bool run(const uint8_t* dump, size_t size);
+
+    uint32_t getNowMs() const { return (uint32_t)(nowUs / 1000); }
+    const Stats& getStats() const { return stats; }
+    uint8_t getFeedingCount() const { return feedingCount; }
+    const Feeding& getFeeding(uint8_t index) const { return feedings[index]; }
+    const AutotuneSearch& getAutotune() const { return autotune; }
+    uint32_t getLastCompleted() const { return lastCompleted; }
+
+private:
+    // Virtual clock (µs since the first record, across boots)
+    int64_t nowUs;
+    int64_t sessionBaseUs;      // nowUs at the first record of the boot session
+    uint32_t sessionFirstMs;    // millis() of that record
+    bool sessionStarted;
+
+    // Wall clock from the last RTC read
+    uint32_t rtcUtc;
+    int64_t rtcAtUs;
+    bool rtcValid;
+
+    // Schedule monitor (FeedingSchedule::processSchedules)
+    TimeZone zone;
+    ScheduleCalendar calendar;
+    const ScheduledFeeding* schedules;
+    uint8_t scheduleCount;
+    uint32_t lastCompleted;
+    uint32_t nextEpoch;
+    int8_t nextIndex;
+    int64_t nextTickUs;
+
+    // Touch input (TouchSensor::update)
+    bool rawTouched;
+    bool pendingTouched;
+    bool touched;
+    bool longPressDone;
+    int64_t rawChangeUs;
+    int64_t touchStartUs;
+
+    // Vibration motor
+    HapticSequencer haptic;
+    int64_t vibrationOnUs;      // Start of the current on phase
+
+    // Motor: one feeding or autotune trial at a time
+    bool feeding;
+    bool tuning;
+    int64_t motorDoneUs;
+    AutotuneSearch autotune;
+    AutotuneTrial autotuneTrial;
+    bool trialPassed;
+
+    Feeding feedings[MAX_FEEDINGS];
+    uint8_t feedingCount;
+    Stats stats;
+
+    void reset();
+    void reboot();
+    void advanceTo(int64_t targetUs);
+    int64_t nextEventUs() const;
+
+    void handleRecord(const InputLog::Record& record);
+    void handleCommand(const char* command);
+    void handleRequest(const char* request);
+    bool setTimezone(const char* posix);
+
+    uint32_t currentUtc() const;
+    void tickSchedules();
+    void updateTouch();
+
+    bool startFeeding(Source source, int8_t schedule, int portions);
+    void endMotorMove();
+    void cancelFeeding();
+
+    void startAutotuneTrial();
+    void playPattern(const HapticSequencer::Pattern& pattern);
+    void stopPattern();
+    void advancePattern();
+};
+
+#endif // INPUT_REPLAY_H
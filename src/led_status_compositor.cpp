@@ -0,0 +1,145 @@
+#include "led_status_compositor.h"
+
+LedStatusCompositor::LedStatusCompositor(RGBLed& led)
+    : led(led),
+      activeMask(0),
+      oneShotMask(0),
+      baseStatus(RGBLed::STATUS_READY),
+      resolvedLayer(LAYER_COUNT),
+      resolvedStatus(RGBLed::STATUS_MANUAL) {
+    for (uint8_t i = 0; i < LAYER_COUNT; i++) {
+        layers[i] = RGBLed::STATUS_MANUAL;
+    }
+}
+
+void LedStatusCompositor::push(Layer layer, RGBLed::DeviceStatus status) {
+    if (layer >= LAYER_COUNT) {
+        return;
+    }
+
+    uint8_t bit = 1 << layer;
+    if ((activeMask & bit) && !(oneShotMask & bit) && layers[layer] == status) {
+        return;  // Already on the stack
+    }
+
+    layers[layer] = status;
+    activeMask |= bit;
+    oneShotMask &= ~bit;
+    resolve();
+}
+
+void LedStatusCompositor::pushOneShot(Layer layer, RGBLed::DeviceStatus status) {
+    if (layer >= LAYER_COUNT || topLayer() < layer) {
+        return;  // Would never be seen
+    }
+
+    uint8_t bit = 1 << layer;
+    layers[layer] = status;
+    activeMask |= bit;
+    oneShotMask |= bit;
+
+    // Restart the flash even if it is already showing
+    resolvedLayer = LAYER_COUNT + 1;
+    resolve();
+}
+
+void LedStatusCompositor::pop(Layer layer) {
+    if (layer >= LAYER_COUNT) {
+        return;
+    }
+
+    uint8_t bit = 1 << layer;
+    if (!(activeMask & bit)) {
+        return;
+    }
+
+    activeMask &= ~bit;
+    oneShotMask &= ~bit;
+    resolve();
+}
+
+void LedStatusCompositor::setBase(RGBLed::DeviceStatus status) {
+    baseStatus = status;
+    resolve();
+}
+
+bool LedStatusCompositor::isActive(Layer layer) const {
+    return layer < LAYER_COUNT && (activeMask & (1 << layer));
+}
+
+void LedStatusCompositor::update() {
+    // Only the shown layer can finish its animation
+    if (resolvedLayer < LAYER_COUNT && (oneShotMask & (1 << resolvedLayer)) && !led.isAnimating()) {
+        pop((Layer)resolvedLayer);
+    }
+}
+
+uint8_t LedStatusCompositor::topLayer() const {
+    return activeMask ? __builtin_ctz(activeMask) : LAYER_COUNT;
+}
+
+void LedStatusCompositor::resolve() {
+    uint8_t top = topLayer();
+    RGBLed::DeviceStatus status = top < LAYER_COUNT ? layers[top] : baseStatus;
+
+    if (top == resolvedLayer && status == resolvedStatus) {
+        return;  // Nothing visible changed
+    }
+
+    // Same pattern from another layer: keep the running animation
+    bool restart = status != resolvedStatus || (oneShotMask & (1 << top));
+    resolvedLayer = top;
+    resolvedStatus = status;
+
+    if (restart) {
+        led.setDeviceStatus(status);
+    }
+}
+
+void LedStatusCompositor::printStatus(Print& out) const {
+    out.println(F("LED Status Layers:"));
+
+    for (uint8_t i = 0; i < LAYER_COUNT; i++) {
+        out.print(F("  "));
+        out.print(layerName(i));
+        out.print(F(": "));
+        if (activeMask & (1 << i)) {
+            out.print(statusName(layers[i]));
+            if (oneShotMask & (1 << i)) {
+                out.print(F(" (one-shot)"));
+            }
+        } else {
+            out.print('-');
+        }
+        out.println(i == resolvedLayer ? F("  <- shown") : F(""));
+    }
+
+    out.print(F("  Base: "));
+    out.print(statusName(baseStatus));
+    out.println(resolvedLayer >= LAYER_COUNT ? F("  <- shown") : F(""));
+}
+
+const char* LedStatusCompositor::layerName(uint8_t layer) {
+    switch (layer) {
+        case LAYER_ERROR:     return "Error";
+        case LAYER_FEEDING:   return "Feeding";
+        case LAYER_TIME_SYNC: return "Time sync";
+        case LAYER_WIFI:      return "WiFi";
+        default:              return "?";
+    }
+}
+
+const char* LedStatusCompositor::statusName(RGBLed::DeviceStatus status) {
+    switch (status) {
+        case RGBLed::STATUS_BOOTING:         return "BOOTING";
+        case RGBLed::STATUS_WIFI_CONNECTING: return "WIFI_CONNECTING";
+        case RGBLed::STATUS_WIFI_ERROR:      return "WIFI_ERROR";
+        case RGBLed::STATUS_TIME_SYNCING:    return "TIME_SYNCING";
+        case RGBLed::STATUS_READY:           return "READY";
+        case RGBLed::STATUS_FEEDING:         return "FEEDING";
+        case RGBLed::STATUS_CANCELED:        return "CANCELED";
+        case RGBLed::STATUS_ERROR:           return "ERROR";
+        case RGBLed::STATUS_MANUAL:          return "MANUAL";
+        default:                             return "?";
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef LED_STATUS_COMPOSITOR_H
+#define LED_STATUS_COMPOSITOR_H
+
+#include <Arduino.h>
+#include "rgb_led.h"
+
+/**
+ * LED Status Compositor
+ *
+ * Single owner of the RGB LED device status. Modules push or pop a status
+ * on their own priority layer instead of calling RGBLed::setDeviceStatus()
+ * and guessing whether they may override each other:
+ *
+ *   LAYER_ERROR      errors, cancel flash        (highest)
+ *   LAYER_FEEDING    feeding in progress
+ *   LAYER_TIME_SYNC  NTP / HTTP time sync
+ *   LAYER_WIFI       connecting, WiFi errors
+ *   base             ready (booting during setup) (lowest)
+ *
+ * Features:
+ * - The shown status is the highest active layer, resolved with a bit scan
+ *   only when the stack changes (push/pop/setBase), never per tick
+ * - Re-pushing the status already shown does not restart its animation
+ * - One-shot layers pop themselves when their animation finishes
+ */
+class LedStatusCompositor {
+public:
+    /**
+     * Status layers, highest priority first
+     */
+    enum Layer : uint8_t {
+        LAYER_ERROR,
+        LAYER_FEEDING,
+        LAYER_TIME_SYNC,
+        LAYER_WIFI,
+        LAYER_COUNT
+    };
+
+    /**
+     * Constructor
+     *
+     * @param led: LED driven by the compositor
+     */
+    explicit LedStatusCompositor(RGBLed& led);
+
+    /**
+     * Set or replace the status of a layer
+     *
+     * @param layer: Layer owned by the caller
+     * @param status: Status shown while this is the highest active layer
+     */
+    void push(Layer layer, RGBLed::DeviceStatus status);
+
+    /**
+     * Set a layer that pops itself when its animation finishes
+     * (e.g. STATUS_CANCELED). Dropped if a higher layer is active.
+     *
+     * @param layer: Layer owned by the caller
+     * @param status: One-shot status (finite animation)
+     */
+    void pushOneShot(Layer layer, RGBLed::DeviceStatus status);
+
+    /**
+     * Clear a layer (no-op if not active)
+     *
+     * @param layer: Layer owned by the caller
+     */
+    void pop(Layer layer);
+
+    /**
+     * Set the status shown when no layer is active
+     *
+     * @param status: Base status (STATUS_READY after boot)
+     */
+    void setBase(RGBLed::DeviceStatus status);
+
+    /**
+     * Check if a layer is active
+     */
+    bool isActive(Layer layer) const;
+
+    /**
+     * @return: Status currently applied to the LED
+     */
+    RGBLed::DeviceStatus getResolved() const { return resolvedStatus; }
+
+    /**
+     * Pop a finished one-shot layer
+     * Call from the LED maintenance task after RGBLed::update()
+     */
+    void update();
+
+    /**
+     * Print layer stack for debugging
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    RGBLed& led;
+
+    RGBLed::DeviceStatus layers[LAYER_COUNT];
+    uint8_t activeMask;          // Bit n set = layer n active
+    uint8_t oneShotMask;         // Active layers that pop when their animation ends
+    RGBLed::DeviceStatus baseStatus;
+
+    // Last resolved state (LAYER_COUNT = base)
+    uint8_t resolvedLayer;
+    RGBLed::DeviceStatus resolvedStatus;
+
+    /**
+     * Apply the highest active layer if it differs from what is shown
+     */
+    void resolve();
+
+    /**
+     * @return: Highest active layer, LAYER_COUNT if none
+     */
+    uint8_t topLayer() const;
+
+    static const char* layerName(uint8_t layer);
+    static const char* statusName(RGBLed::DeviceStatus status);
+};
+
+#endif // LED_STATUS_COMPOSITOR_H
@@ -0,0 +1,563 @@
+#include "loop_watchdog.h"
+#include "console_manager.h"
+#include "metrics_registry.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+
+/**
+ * Loop Stall Watchdog Implementation
+ *
+ * Scopes form a small stack; each frame adds its duration to its parent's
+ * child time, so own time = duration - child time. The pass itself is
+ * frame 0 (CALLBACK_LOOP), which makes scheduler overhead and unscoped
+ * work show up like any other callback. Blockers charge their duration to
+ * the innermost frame.
+ */
+
+namespace {
+
+// Indexed by LoopWatchdog::Callback (task names match the trace)
+const char* const CALLBACK_NAMES[LoopWatchdog::CALLBACK_COUNT] = {
+    "setup", "loop", "serial", "motorMaintenance", "rgbLed", "touchSensor",
+    "feedingMonitor", "scheduleMonitor", "wifiMonitor", "ntpSync", "wifiPortal",
+    "cpuGovernor", "inputFlush", "series", "http"
+};
+
+// Indexed by LoopWatchdog::Blocking
+const char* const BLOCKING_NAMES[LoopWatchdog::BLOCKING_COUNT] = {
+    "none", "ntpWait", "httpTime", "internetTest", "wifiScan", "motorMove", "rtcBegin", "flashWrite"
+};
+
+const uint32_t RESET_RECORD_MAGIC = 0x4C575344;     // "LWSD"
+
+// What the loop was running, kept across resets (not cleared at boot)
+struct ResetRecord {
+    uint32_t magic;
+    uint8_t callback;
+    uint8_t blocking;
+};
+
+RTC_NOINIT_ATTR ResetRecord resetRecord;
+
+MetricsRegistry::Counter stallMetric("feeder_loop_stalls_total", "Loop passes over the stall budget");
+
+bool isWatchdogReset(esp_reset_reason_t reason) {
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+           reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+}
+
+const char* getResetReasonName(uint8_t reason) {
+    switch (reason) {
+        case ESP_RST_PANIC:    return "panic";
+        case ESP_RST_INT_WDT:  return "interruptWatchdog";
+        case ESP_RST_TASK_WDT: return "taskWatchdog";
+        default:               return "watchdog";
+    }
+}
+
+} // namespace
+
+uint32_t LoopWatchdog::budgetUs = 0;
+bool LoopWatchdog::hardwareEnabled = false;
+LoopWatchdog::Frame LoopWatchdog::frames[LOOP_WATCHDOG_MAX_DEPTH];
+uint8_t LoopWatchdog::depth = 0;
+uint8_t LoopWatchdog::overflowDepth = 0;
+LoopWatchdog::Blame LoopWatchdog::blame;
+LoopWatchdog::Blocking LoopWatchdog::activeBlocking = LoopWatchdog::BLOCKING_NONE;
+
+LoopWatchdog::BlockingStats LoopWatchdog::blockingStats[BLOCKING_COUNT];
+LoopWatchdog::Site LoopWatchdog::sites[LOOP_WATCHDOG_SITES];
+uint8_t LoopWatchdog::siteCount = 0;
+uint32_t LoopWatchdog::untrackedStalls = 0;
+LoopWatchdog::Stall LoopWatchdog::recent[LOOP_WATCHDOG_RECENT];
+uint8_t LoopWatchdog::recentNext = 0;
+uint32_t LoopWatchdog::totalStalls = 0;
+uint32_t LoopWatchdog::worstPassUs = 0;
+uint32_t LoopWatchdog::passCount = 0;
+
+bool LoopWatchdog::resetRecorded = false;
+LoopWatchdog::Callback LoopWatchdog::resetCallback = LoopWatchdog::CALLBACK_SETUP;
+LoopWatchdog::Blocking LoopWatchdog::resetBlocking = LoopWatchdog::BLOCKING_NONE;
+uint8_t LoopWatchdog::resetReason = 0;
+
+/**
+ * Read the reset record of the previous boot and apply the settings
+ *
+ * @param budgetMs: Stall budget per loop pass (watchdog.budget)
+ * @param hardware: Escalate to the hardware task watchdog (watchdog.hw)
+ */
+void LoopWatchdog::begin(uint32_t budgetMs, bool hardware) {
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (isWatchdogReset(reason) && resetRecord.magic == RESET_RECORD_MAGIC &&
+        resetRecord.callback < CALLBACK_COUNT && resetRecord.blocking < BLOCKING_COUNT) {
+        resetRecorded = true;
+        resetCallback = (Callback)resetRecord.callback;
+        resetBlocking = (Blocking)resetRecord.blocking;
+        resetReason = (uint8_t)reason;
+
+        Console::printR(F("⚠ Loop watchdog: last reset ("));
+        Console::printR(getResetReasonName(resetReason));
+        Console::printR(F(") in "));
+        Console::printR(CALLBACK_NAMES[resetCallback]);
+        if (resetBlocking != BLOCKING_NONE) {
+            Console::printR(F(", blocked in "));
+            Console::printR(BLOCKING_NAMES[resetBlocking]);
+        }
+        Console::printlnR(F(""));
+    }
+    resetRecord.magic = RESET_RECORD_MAGIC;
+    mirror(CALLBACK_SETUP, activeBlocking);
+
+    setBudget(budgetMs);
+    setHardwareEnabled(hardware);
+}
+
+void LoopWatchdog::setBudget(uint32_t budgetMs) {
+    budgetUs = budgetMs * 1000;
+}
+
+uint32_t LoopWatchdog::getBudget() {
+    return budgetUs / 1000;
+}
+
+/**
+ * Subscribe/unsubscribe the loop task to the hardware task watchdog
+ * The Arduino loop task feeds it between loop() calls once subscribed
+ */
+void LoopWatchdog::setHardwareEnabled(bool enabled) {
+    if (enabled == hardwareEnabled) {
+        return;
+    }
+    hardwareEnabled = enabled;
+    if (enabled) {
+        // Reconfigures the running task watchdog (longer timeout, panic = reset)
+        esp_task_wdt_init(LOOP_WATCHDOG_HW_TIMEOUT_S, true);
+        enableLoopWDT();
+    } else {
+        disableLoopWDT();
+#ifdef CONFIG_ESP_TASK_WDT_PANIC
+        esp_task_wdt_init(CONFIG_ESP_TASK_WDT_TIMEOUT_S, true);
+#else
+        esp_task_wdt_init(CONFIG_ESP_TASK_WDT_TIMEOUT_S, false);
+#endif
+    }
+    Console::printR(F("Loop watchdog: hardware escalation "));
+    Console::printlnR(enabled ? F("ON") : F("OFF"));
+}
+
+bool LoopWatchdog::isHardwareEnabled() {
+    return hardwareEnabled;
+}
+
+/**
+ * Start one loop pass (frame 0)
+ */
+void LoopWatchdog::beginPass() {
+    depth = 0;
+    overflowDepth = 0;
+    blame.callback = CALLBACK_LOOP;
+    blame.blocking = BLOCKING_NONE;
+    blame.detail = nullptr;
+    blame.selfUs = 0;
+    blame.blockingUs = 0;
+    enter(CALLBACK_LOOP, nullptr);
+}
+
+/**
+ * End the loop pass and flag it if it went over the budget
+ *
+ * @return: Pass duration in microseconds
+ */
+uint32_t LoopWatchdog::endPass() {
+    uint32_t passUs = micros() - frames[0].startUs;
+    leave();
+    mirror(CALLBACK_LOOP, activeBlocking);
+
+    passCount++;
+    if (passUs > worstPassUs) {
+        worstPassUs = passUs;
+    }
+    if (budgetUs > 0 && passUs >= budgetUs) {
+        recordStall(passUs);
+    }
+    return passUs;
+}
+
+void LoopWatchdog::enter(Callback callback, const char* detail) {
+    if (depth >= LOOP_WATCHDOG_MAX_DEPTH) {
+        overflowDepth++;
+        return;
+    }
+    Frame& frame = frames[depth++];
+    frame.callback = callback;
+    frame.blocking = BLOCKING_NONE;
+    frame.detail = detail;
+    frame.startUs = micros();
+    frame.childUs = 0;
+    frame.blockingUs = 0;
+    mirror(callback, activeBlocking);
+}
+
+void LoopWatchdog::leave() {
+    if (overflowDepth > 0) {
+        overflowDepth--;
+        return;
+    }
+    if (depth == 0) {
+        return;
+    }
+    const Frame& frame = frames[--depth];
+    uint32_t elapsedUs = micros() - frame.startUs;
+    uint32_t selfUs = elapsedUs > frame.childUs ? elapsedUs - frame.childUs : 0;
+    if (depth > 0) {
+        frames[depth - 1].childUs += elapsedUs;
+    }
+
+    if (selfUs > blame.selfUs) {
+        blame.callback = frame.callback;
+        blame.blocking = frame.blocking;
+        blame.detail = frame.detail;
+        blame.selfUs = selfUs;
+        blame.blockingUs = frame.blockingUs;
+    }
+    mirror(depth > 0 ? frames[depth - 1].callback : CALLBACK_SETUP, activeBlocking);
+}
+
+LoopWatchdog::Blocking LoopWatchdog::beginBlocking(Blocking blocking) {
+    Blocking previous = activeBlocking;
+    activeBlocking = blocking;
+    mirror(depth > 0 ? frames[depth - 1].callback : CALLBACK_SETUP, blocking);
+    return previous;
+}
+
+void LoopWatchdog::endBlocking(Blocking blocking, Blocking previous, uint32_t elapsedUs) {
+    activeBlocking = previous;
+    resetRecord.blocking = previous;
+
+    BlockingStats& stats = blockingStats[blocking];
+    stats.calls++;
+    stats.totalUs += elapsedUs;
+    if (elapsedUs > stats.maxUs) {
+        stats.maxUs = elapsedUs;
+    }
+
+    if (depth > 0 && overflowDepth == 0) {
+        Frame& frame = frames[depth - 1];
+        if (elapsedUs > frame.blockingUs) {
+            frame.blocking = blocking;
+            frame.blockingUs = elapsedUs;
+        }
+    }
+}
+
+/**
+ * Count the pass against the blamed site, keep it in the recent ring and log it
+ */
+void LoopWatchdog::recordStall(uint32_t passUs) {
+    uint32_t uptimeS = millis() / 1000;
+    uint32_t passMs = passUs / 1000;
+    totalStalls++;
+    stallMetric.inc();
+    if (blame.blocking != BLOCKING_NONE) {
+        blockingStats[blame.blocking].stalls++;
+    }
+
+    Site* site = nullptr;
+    for (uint8_t i = 0; i < siteCount; i++) {
+        if (sites[i].callback == blame.callback && sites[i].blocking == blame.blocking &&
+            sites[i].detail == blame.detail) {
+            site = &sites[i];
+            break;
+        }
+    }
+    if (!site && siteCount < LOOP_WATCHDOG_SITES) {
+        site = &sites[siteCount++];
+        site->callback = blame.callback;
+        site->blocking = blame.blocking;
+        site->detail = blame.detail;
+        site->count = 0;
+        site->maxMs = 0;
+    }
+    if (site) {
+        site->count++;
+        if (passMs > site->maxMs) {
+            site->maxMs = passMs;
+        }
+        site->lastUptimeS = uptimeS;
+    } else {
+        untrackedStalls++;
+    }
+
+    Stall& stall = recent[recentNext];
+    recentNext = (recentNext + 1) % LOOP_WATCHDOG_RECENT;
+    stall.uptimeS = uptimeS;
+    stall.passMs = passMs;
+    stall.callbackMs = blame.selfUs / 1000;
+    stall.blockingMs = blame.blockingUs / 1000;
+    stall.callback = blame.callback;
+    stall.blocking = blame.blocking;
+    stall.detail = blame.detail;
+
+    Console::printR(F("⚠ Loop stall: "));
+    Console::printR(String(passMs));
+    Console::printR(F(" ms (budget "));
+    Console::printR(String(getBudget()));
+    Console::printR(F(" ms) in "));
+    Console::printR(CALLBACK_NAMES[blame.callback]);
+    if (blame.detail) {
+        Console::printR(F(" "));
+        Console::printR(blame.detail);
+    }
+    if (blame.blocking != BLOCKING_NONE) {
+        Console::printR(F(", blocked in "));
+        Console::printR(BLOCKING_NAMES[blame.blocking]);
+        Console::printR(F(" for "));
+        Console::printR(String(stall.blockingMs));
+        Console::printR(F(" ms"));
+    }
+    Console::printlnR(F(""));
+}
+
+/**
+ * Forget stalls and primitive statistics (the reset record is kept)
+ */
+void LoopWatchdog::reset() {
+    memset(blockingStats, 0, sizeof(blockingStats));
+    siteCount = 0;
+    untrackedStalls = 0;
+    recentNext = 0;
+    totalStalls = 0;
+    worstPassUs = 0;
+    passCount = 0;
+}
+
+void LoopWatchdog::mirror(Callback callback, Blocking blocking) {
+    resetRecord.callback = callback;
+    resetRecord.blocking = blocking;
+}
+
+const char* LoopWatchdog::getCallbackName(Callback callback) {
+    return callback < CALLBACK_COUNT ? CALLBACK_NAMES[callback] : "?";
+}
+
+const char* LoopWatchdog::getBlockingName(Blocking blocking) {
+    return blocking < BLOCKING_COUNT ? BLOCKING_NAMES[blocking] : "?";
+}
+
+/**
+ * Print budget, primitive statistics, stall sites and recent stalls
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void LoopWatchdog::printStatus(Print& out) {
+    out.println(F("=== Loop Watchdog ==="));
+    out.print(F("Budget: "));
+    out.print(getBudget());
+    out.print(F(" ms, hardware escalation: "));
+    if (hardwareEnabled) {
+        out.print(F("ON ("));
+        out.print(LOOP_WATCHDOG_HW_TIMEOUT_S);
+        out.println(F(" s)"));
+    } else {
+        out.println(F("OFF"));
+    }
+    out.print(F("Passes: "));
+    out.print(passCount);
+    out.print(F(", worst "));
+    out.print(worstPassUs / 1000);
+    out.print(F(" ms, stalls "));
+    out.println(totalStalls);
+    if (resetRecorded) {
+        out.print(F("Last reset ("));
+        out.print(getResetReasonName(resetReason));
+        out.print(F(") in "));
+        printSite(out, resetCallback, nullptr, resetBlocking);
+        out.println();
+    }
+
+    out.println(F("Blocking primitives (calls, stalls, total, max):"));
+    for (uint8_t i = BLOCKING_NONE + 1; i < BLOCKING_COUNT; i++) {
+        const BlockingStats& stats = blockingStats[i];
+        out.print(F("  "));
+        out.print(BLOCKING_NAMES[i]);
+        out.print(F(": "));
+        out.print(stats.calls);
+        out.print(F(", "));
+        out.print(stats.stalls);
+        out.print(F(", "));
+        out.print((uint32_t)(stats.totalUs / 1000));
+        out.print(F(" ms, "));
+        out.print(stats.maxUs / 1000);
+        out.println(F(" ms"));
+    }
+
+    out.println(F("Stall sites (count, max, last at uptime):"));
+    if (siteCount == 0) {
+        out.println(F("  none"));
+    }
+    for (uint8_t i = 0; i < siteCount; i++) {
+        const Site& site = sites[i];
+        out.print(F("  "));
+        printSite(out, site.callback, site.detail, site.blocking);
+        out.print(F(": "));
+        out.print(site.count);
+        out.print(F(", "));
+        out.print(site.maxMs);
+        out.print(F(" ms, "));
+        out.print(site.lastUptimeS);
+        out.println(F(" s"));
+    }
+    if (untrackedStalls > 0) {
+        out.print(F("  (+"));
+        out.print(untrackedStalls);
+        out.println(F(" stalls at untracked sites)"));
+    }
+
+    uint8_t recentCount = totalStalls < LOOP_WATCHDOG_RECENT ? totalStalls : LOOP_WATCHDOG_RECENT;
+    if (recentCount > 0) {
+        out.println(F("Recent stalls (newest first):"));
+    }
+    for (uint8_t i = 0; i < recentCount; i++) {
+        const Stall& stall = recent[(recentNext + LOOP_WATCHDOG_RECENT - 1 - i) % LOOP_WATCHDOG_RECENT];
+        out.print(F("  "));
+        out.print(stall.uptimeS);
+        out.print(F(" s: "));
+        out.print(stall.passMs);
+        out.print(F(" ms, "));
+        printSite(out, stall.callback, stall.detail, stall.blocking);
+        out.print(F(" ("));
+        out.print(stall.callbackMs);
+        out.print(F(" ms own"));
+        if (stall.blocking != BLOCKING_NONE) {
+            out.print(F(", "));
+            out.print(stall.blockingMs);
+            out.print(F(" ms blocked"));
+        }
+        out.println(F(")"));
+    }
+}
+
+/**
+ * "callback [detail] / blocking"
+ */
+void LoopWatchdog::printSite(Print& out, Callback callback, const char* detail, Blocking blocking) {
+    out.print(CALLBACK_NAMES[callback]);
+    if (detail) {
+        out.print(' ');
+        out.print(detail);
+    }
+    if (blocking != BLOCKING_NONE) {
+        out.print(F(" / "));
+        out.print(BLOCKING_NAMES[blocking]);
+    }
+}
+
+/**
+ * Stream the same as JSON (/api/stalls)
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void LoopWatchdog::writeJson(Print& out) {
+    out.print(F("{\"budgetMs\":"));
+    out.print(getBudget());
+    out.print(F(",\"hardware\":"));
+    out.print(hardwareEnabled ? "true" : "false");
+    out.print(F(",\"hardwareTimeoutS\":"));
+    out.print(LOOP_WATCHDOG_HW_TIMEOUT_S);
+    out.print(F(",\"passes\":"));
+    out.print(passCount);
+    out.print(F(",\"worstPassMs\":"));
+    out.print(worstPassUs / 1000);
+    out.print(F(",\"stalls\":"));
+    out.print(totalStalls);
+    out.print(F(",\"untracked\":"));
+    out.print(untrackedStalls);
+
+    out.print(F(",\"lastReset\":"));
+    if (resetRecorded) {
+        out.print(F("{\"reason\":\""));
+        out.print(getResetReasonName(resetReason));
+        out.print(F("\","));
+        writeSiteJson(out, resetCallback, nullptr, resetBlocking);
+        out.print('}');
+    } else {
+        out.print(F("null"));
+    }
+
+    out.print(F(",\"blocking\":{"));
+    for (uint8_t i = BLOCKING_NONE + 1; i < BLOCKING_COUNT; i++) {
+        const BlockingStats& stats = blockingStats[i];
+        if (i > BLOCKING_NONE + 1) {
+            out.print(',');
+        }
+        out.print('"');
+        out.print(BLOCKING_NAMES[i]);
+        out.print(F("\":{\"calls\":"));
+        out.print(stats.calls);
+        out.print(F(",\"stalls\":"));
+        out.print(stats.stalls);
+        out.print(F(",\"totalMs\":"));
+        out.print((uint32_t)(stats.totalUs / 1000));
+        out.print(F(",\"maxMs\":"));
+        out.print(stats.maxUs / 1000);
+        out.print('}');
+    }
+
+    out.print(F("},\"sites\":["));
+    for (uint8_t i = 0; i < siteCount; i++) {
+        const Site& site = sites[i];
+        if (i > 0) {
+            out.print(',');
+        }
+        out.print('{');
+        writeSiteJson(out, site.callback, site.detail, site.blocking);
+        out.print(F(",\"count\":"));
+        out.print(site.count);
+        out.print(F(",\"maxMs\":"));
+        out.print(site.maxMs);
+        out.print(F(",\"lastUptimeS\":"));
+        out.print(site.lastUptimeS);
+        out.print('}');
+    }
+
+    out.print(F("],\"recent\":["));
+    uint8_t recentCount = totalStalls < LOOP_WATCHDOG_RECENT ? totalStalls : LOOP_WATCHDOG_RECENT;
+    for (uint8_t i = 0; i < recentCount; i++) {
+        const Stall& stall = recent[(recentNext + LOOP_WATCHDOG_RECENT - 1 - i) % LOOP_WATCHDOG_RECENT];
+        if (i > 0) {
+            out.print(',');
+        }
+        out.print('{');
+        writeSiteJson(out, stall.callback, stall.detail, stall.blocking);
+        out.print(F(",\"uptimeS\":"));
+        out.print(stall.uptimeS);
+        out.print(F(",\"passMs\":"));
+        out.print(stall.passMs);
+        out.print(F(",\"callbackMs\":"));
+        out.print(stall.callbackMs);
+        out.print(F(",\"blockingMs\":"));
+        out.print(stall.blockingMs);
+        out.print('}');
+    }
+    out.print(F("]}"));
+}
+
+/**
+ * "callback":"...","detail":...,"blocking":"..." (detail null if none)
+ */
+void LoopWatchdog::writeSiteJson(Print& out, Callback callback, const char* detail, Blocking blocking) {
+    out.print(F("\"callback\":\""));
+    out.print(CALLBACK_NAMES[callback]);
+    out.print(F("\",\"detail\":"));
+    if (detail) {
+        out.print('"');
+        out.print(detail);
+        out.print('"');
+    } else {
+        out.print(F("null"));
+    }
+    out.print(F(",\"blocking\":\""));
+    out.print(BLOCKING_NAMES[blocking]);
+    out.print('"');
+}
@@ -0,0 +1,231 @@
+#ifndef LOOP_WATCHDOG_H
+#define LOOP_WATCHDOG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Loop Stall Watchdog
+ *
+ * Everything runs on the cooperative loop, so one blocking call (an NTP
+ * wait, a WiFi scan, a blocking motor move) holds up feeding, touch and the
+ * web server alike. The watchdog times every loop pass and flags the ones
+ * over the budget (watchdog.budget), with what was running:
+ *   - callback: the task or web handler that spent the most of the pass
+ *     in its own code (Scope, next to the TraceBuffer scope)
+ *   - blocking: the longest known blocking primitive inside it (Blocker,
+ *     at the call sites listed in Blocking)
+ * Stalls are logged, counted per site (callback, URI, blocking primitive)
+ * and the last few are kept with their timing; STALLS and /api/stalls
+ * report them. Blocking primitives keep call/time statistics whether or
+ * not they stall a pass, including the ones setup() runs.
+ *
+ * The callback and primitive being run are mirrored into RTC memory that
+ * survives a reset, so after a watchdog or panic reset the next boot
+ * reports where the loop was. With watchdog.hw on the loop task is also
+ * subscribed to the hardware task watchdog (LOOP_WATCHDOG_HW_TIMEOUT_S,
+ * panics and resets): a hard hang then reboots the feeder instead of
+ * leaving it stuck.
+ *
+ * Scopes, blockers and passes all run on the loop task, so no locking is
+ * needed. Details are stored as pointers; pass string literals (registered
+ * URIs).
+ */
+class LoopWatchdog {
+public:
+    /**
+     * Instrumented tasks and handlers (names in loop_watchdog.cpp)
+     */
+    enum Callback : uint8_t {
+        CALLBACK_SETUP,             // Outside loop passes (setup())
+        CALLBACK_LOOP,              // Scheduler and loop() itself
+        CALLBACK_SERIAL,
+        CALLBACK_MOTOR,
+        CALLBACK_RGB_LED,
+        CALLBACK_TOUCH,
+        CALLBACK_FEEDING_MONITOR,
+        CALLBACK_SCHEDULE_MONITOR,
+        CALLBACK_WIFI_MONITOR,
+        CALLBACK_NTP_SYNC,
+        CALLBACK_WIFI_PORTAL,
+        CALLBACK_CPU_GOVERNOR,
+        CALLBACK_INPUT_FLUSH,
+        CALLBACK_SERIES,
+        CALLBACK_HTTP,              // Web handler, detail = URI
+        CALLBACK_COUNT
+    };
+
+    /**
+     * Known blocking primitives
+     */
+    enum Blocking : uint8_t {
+        BLOCKING_NONE,
+        BLOCKING_NTP_WAIT,          // NTPSync::waitForNTPSync() delay loop
+        BLOCKING_HTTP_TIME,         // HTTP Date fallback request
+        BLOCKING_INTERNET_TEST,     // WiFiController::testInternetConnection()
+        BLOCKING_WIFI_SCAN,         // WiFi.scanNetworks()
+        BLOCKING_MOTOR_MOVE,        // Blocking step/rotate/moveToPosition (CALIBRATE, ...)
+        BLOCKING_RTC_BEGIN,         // RTC probe with retries
+        BLOCKING_FLASH_WRITE,       // Input recorder flush/clear, series checkpoint
+        BLOCKING_COUNT
+    };
+
+    /**
+     * RAII marker for a task or handler run
+     */
+    class Scope {
+    public:
+        explicit Scope(Callback callback, const char* detail = nullptr) { enter(callback, detail); }
+        ~Scope() { leave(); }
+    };
+
+    /**
+     * RAII marker for a blocking primitive
+     */
+    class Blocker {
+    public:
+        explicit Blocker(Blocking blocking)
+            : blocking(blocking), previous(beginBlocking(blocking)), startUs(micros()) {}
+        ~Blocker() { endBlocking(blocking, previous, micros() - startUs); }
+    private:
+        Blocking blocking;
+        Blocking previous;
+        uint32_t startUs;
+    };
+
+    /**
+     * Statistics of one blocking primitive
+     */
+    struct BlockingStats {
+        uint32_t calls;
+        uint32_t stalls;            // Passes it was blamed for
+        uint64_t totalUs;
+        uint32_t maxUs;
+    };
+
+    /**
+     * Stalls of one callback/detail/primitive combination
+     */
+    struct Site {
+        Callback callback;
+        Blocking blocking;
+        const char* detail;
+        uint32_t count;
+        uint32_t maxMs;
+        uint32_t lastUptimeS;
+    };
+
+    /**
+     * One flagged loop pass
+     */
+    struct Stall {
+        uint32_t uptimeS;
+        uint32_t passMs;
+        uint32_t callbackMs;        // Own time of the blamed callback
+        uint32_t blockingMs;
+        Callback callback;
+        Blocking blocking;
+        const char* detail;
+    };
+
+    /**
+     * Read the reset record of the previous boot and apply the settings
+     *
+     * @param budgetMs: Stall budget per loop pass (watchdog.budget)
+     * @param hardware: Escalate to the hardware task watchdog (watchdog.hw)
+     */
+    static void begin(uint32_t budgetMs, bool hardware);
+
+    static void setBudget(uint32_t budgetMs);
+    static uint32_t getBudget();
+
+    /**
+     * Subscribe/unsubscribe the loop task to the hardware task watchdog
+     */
+    static void setHardwareEnabled(bool enabled);
+    static bool isHardwareEnabled();
+
+    /**
+     * Bracket one loop pass
+     *
+     * @return: endPass(): Pass duration in microseconds
+     */
+    static void beginPass();
+    static uint32_t endPass();
+
+    /**
+     * Forget stalls and primitive statistics (the reset record is kept)
+     */
+    static void reset();
+
+    /**
+     * Print budget, primitive statistics, stall sites and recent stalls
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    static void printStatus(Print& out);
+
+    /**
+     * Stream the same as JSON (/api/stalls)
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    static void writeJson(Print& out);
+
+    static const char* getCallbackName(Callback callback);
+    static const char* getBlockingName(Blocking blocking);
+
+private:
+    // One nested Scope
+    struct Frame {
+        Callback callback;
+        Blocking blocking;          // Longest primitive seen in it
+        const char* detail;
+        uint32_t startUs;
+        uint32_t childUs;           // Time spent in nested scopes
+        uint32_t blockingUs;
+    };
+
+    // Worst own time of the current pass
+    struct Blame {
+        Callback callback;
+        Blocking blocking;
+        const char* detail;
+        uint32_t selfUs;
+        uint32_t blockingUs;
+    };
+
+    static uint32_t budgetUs;
+    static bool hardwareEnabled;
+    static Frame frames[LOOP_WATCHDOG_MAX_DEPTH];   // [0] = the pass itself
+    static uint8_t depth;
+    static uint8_t overflowDepth;   // Scopes beyond LOOP_WATCHDOG_MAX_DEPTH
+    static Blame blame;
+    static Blocking activeBlocking;
+
+    static BlockingStats blockingStats[BLOCKING_COUNT];
+    static Site sites[LOOP_WATCHDOG_SITES];
+    static uint8_t siteCount;
+    static uint32_t untrackedStalls;    // Site table full
+    static Stall recent[LOOP_WATCHDOG_RECENT];
+    static uint8_t recentNext;
+    static uint32_t totalStalls;
+    static uint32_t worstPassUs;
+    static uint32_t passCount;
+
+    static bool resetRecorded;      // Previous boot ended in a watchdog/panic reset
+    static Callback resetCallback;
+    static Blocking resetBlocking;
+    static uint8_t resetReason;
+
+    static void enter(Callback callback, const char* detail);
+    static void leave();
+    static Blocking beginBlocking(Blocking blocking);
+    static void endBlocking(Blocking blocking, Blocking previous, uint32_t elapsedUs);
+    static void recordStall(uint32_t passUs);
+    static void mirror(Callback callback, Blocking blocking);
+    static void printSite(Print& out, Callback callback, const char* detail, Blocking blocking);
+    static void writeSiteJson(Print& out, Callback callback, const char* detail, Blocking blocking);
+};
+
+#endif // LOOP_WATCHDOG_H
@@ -1,7 +1,6 @@
 #include <Arduino.h>
 #include <EEPROM.h>
 #include <TaskScheduler.h>
-#include <Preferences.h>
 #include "module_manager.h"
 #include "rtc_module.h"
 #include "stepper_motor.h"
@@ -11,7 +10,20 @@
 #include "ntp_sync.h"
 #include "vibration_motor.h"
 #include "rgb_led.h"
+#include "led_status_compositor.h"
 #include "touch_sensor.h"
+#include "index_sensor.h"
+#include "motor_autotune.h"
+#include "cpu_governor.h"
+#include "sampling_profiler.h"
+#include "trace_buffer.h"
+#include "feed_latency.h"
+#include "input_recorder.h"
+#include "metrics_registry.h"
+#include "series_store.h"
+#include "loop_watchdog.h"
+#include "runtime_config.h"
+#include "string_builder.h"
 #include "config.h"
 #include "console_manager.h"
 #include "command_listener.h"
@@ -20,28 +32,9 @@
 // GLOBAL CONFIGURATION VARIABLES
 // ============================================================================
 
-// Touch long press portions - configurable via NVRAM
-uint8_t touchLongPressPortions = DEFAULT_TOUCH_LONG_PRESS_PORTIONS;
-
-// Touch sensor enabled/disabled state - configurable via NVRAM
-bool touchSensorEnabled = DEFAULT_TOUCH_SENSOR_ENABLED;
-
-// LED Status Control - NEW ARCHITECTURE
-// Centralized LED status management based on system state priority
-enum SystemLEDState {
-    LED_STATE_READY,          // Green solid - System ready
-    LED_STATE_FEEDING,        // Green blinking - Feeding in progress
-    LED_STATE_CANCEL_FLASH,   // Red flash - Feeding canceled
-    LED_STATE_ERROR           // Red solid - Error state
-};
-
-SystemLEDState currentLEDState = LED_STATE_READY;
-SystemLEDState desiredLEDState = LED_STATE_READY;
-unsigned long ledStateChangeTime = 0;
-const unsigned long CANCEL_FLASH_DURATION = 300;  // 300ms red flash
-
-// Preferences for NVRAM storage
-Preferences touchPreferences;
+// Runtime configuration registry - user settings loaded from a single NVRAM blob
+// (touch portions/enabled, motor direction, schedule tolerance, NTP interval, ...)
+RuntimeConfig runtimeConfig;
 
 // ============================================================================
 // MODULE MANAGER - CENTRALIZED MODULE REFERENCE MANAGEMENT
@@ -58,8 +51,11 @@ ModuleManager moduleManager;
 RTCModule rtcModule;
 
 // Create stepper motor instance
-// Pinos finais para ESP32 DevKit V1 30-pin CH9102X (sem conflito com RTC I2C)
-StepperMotor feedMotor(15, 4, 5, 18);
+// ULN2003 IN1-IN4 on STEPPER_IN1_PIN..STEPPER_IN4_PIN from the board profile
+// (board_profiles.h), clear of the RTC I2C pins on every board
+// Compile-time pin driver: each coil update is a single GPIO register write pair
+StepperDriver<STEPPER_IN1_PIN, STEPPER_IN2_PIN, STEPPER_IN3_PIN, STEPPER_IN4_PIN> feedMotorDriver;
+StepperMotor feedMotor(feedMotorDriver);
 
 // Create vibration motor instance
 // GPIO 26 with PWM channel 1, 1kHz frequency, 8-bit resolution
@@ -71,10 +67,17 @@ VibrationMotor vibrationMotor(VIBRATION_MOTOR_PIN, VIBRATION_PWM_CHANNEL,
 RGBLed rgbLed(RGB_LED_RED_PIN, RGB_LED_GREEN_PIN, RGB_LED_BLUE_PIN, 
               RGB_LED_TYPE == 0 ? RGBLed::COMMON_CATHODE : RGBLed::COMMON_ANODE);
 
+// LED status compositor - modules push/pop prioritized status layers
+// (error > feeding > time sync > WiFi > ready); only stack changes touch the LED
+LedStatusCompositor ledStatus(rgbLed);
+
 // Create touch sensor instance
 // GPIO 33 - Input only pin, ideal for sensors
 TouchSensor touchSensor(TOUCH_SENSOR_PIN, TOUCH_SENSOR_ACTIVE_LOW);
 
+// Auger index sensor (optical slot / hall switch, one pulse per revolution)
+IndexSensor indexSensor(INDEX_SENSOR_PIN, INDEX_SENSOR_ACTIVE_LOW);
+
 // ============================================================================
 // CONTROLLER MODULE INSTANCES
 // ============================================================================
@@ -82,6 +85,21 @@ TouchSensor touchSensor(TOUCH_SENSOR_PIN, TOUCH_SENSOR_ACTIVE_LOW);
 // Create feeding controller
 FeedingController feedingController(&feedMotor);
 
+// Speed/acceleration tuner (MOTOR AUTOTUNE, needs the index sensor)
+MotorAutotune motorAutotune(feedMotor);
+
+// CPU frequency scaling - idle clock while polling, boost for web requests
+CpuGovernor cpuGovernor;
+
+// Statistical PC sampler (PROFILE SAMPLE, /api/profile)
+SamplingProfiler samplingProfiler;
+
+// Feed trigger -> first step / complete latency histograms (/api/metrics)
+FeedLatencyTracker feedLatency;
+
+// Minute/hour/day history of heap, loop latency, RSSI, ... (/api/series)
+SeriesStore seriesStore;
+
 // Create feeding schedule system
 FeedingSchedule feedingSchedule;
 
@@ -101,21 +119,47 @@ CommandListener commandListener(&moduleManager);
 // Create scheduler instance
 Scheduler taskScheduler;
 
+// ============================================================================
+// SYSTEM METRICS (/metrics)
+// ============================================================================
+
+MetricsRegistry::Counter schedulerPasses("feeder_scheduler_passes_total", "Task scheduler passes (loop iterations)");
+MetricsRegistry::Counter schedulerIdlePasses("feeder_scheduler_idle_passes_total",
+                                             "Scheduler passes that invoked no task");
+MetricsRegistry::Gauge activeTasks("feeder_scheduler_active_tasks", "Enabled scheduler tasks",
+                                   nullptr, []() -> int32_t { return taskScheduler.getActiveTasks(); });
+MetricsRegistry::Gauge heapFree("feeder_heap_free_bytes", "Free heap",
+                                nullptr, []() -> int32_t { return ESP.getFreeHeap(); });
+MetricsRegistry::Gauge heapMinFree("feeder_heap_min_free_bytes", "Lowest free heap since boot",
+                                   nullptr, []() -> int32_t { return ESP.getMinFreeHeap(); });
+MetricsRegistry::Gauge heapMaxAlloc("feeder_heap_max_alloc_bytes", "Largest allocatable heap block",
+                                    nullptr, []() -> int32_t { return ESP.getMaxAllocHeap(); });
+MetricsRegistry::Gauge uptimeSeconds("feeder_uptime_seconds", "Seconds since boot",
+                                     nullptr, []() -> int32_t { return millis() / 1000; });
+MetricsRegistry::Gauge cpuFrequency("feeder_cpu_frequency_mhz", "Current CPU clock",
+                                    nullptr, []() -> int32_t { return cpuGovernor.getFrequencyMhz(); });
+MetricsRegistry::Gauge feedingActive("feeder_feeding_in_progress", "1 while a feeding is running",
+                                     nullptr, []() -> int32_t { return moduleManager.getFeedingInProgress() ? 1 : 0; });
+MetricsRegistry::Counter textOverflows("feeder_string_builder_overflows_total", "Truncated StringBuilder writes",
+                                       nullptr, []() -> uint32_t { return StringBuilder::getOverflowCount(); });
+
 // ============================================================================
 // FORWARD DECLARATIONS - CENTRALIZED FEEDING FUNCTIONS
 // ============================================================================
 
 // These functions are used by multiple modules and must be declared before usage
-bool startFeeding(uint8_t portions, bool recordInSchedule = true);
+bool startFeeding(uint8_t portions, bool recordInSchedule, const FeedLatencyTracker::Trigger& trigger);
 bool cancelFeeding();
 uint8_t getTouchLongPressPortions();
 void setTouchLongPressPortions(uint8_t portions);
 bool getTouchSensorEnabled();
 void setTouchSensorEnabled(bool enabled);
+void onRuntimeConfigChanged(RuntimeConfig::Id id);
+void onAutotuneResult(uint16_t maxSpeed, uint16_t acceleration);
+long readIndexDelivery();
 
-// LED status management functions
-void updateLEDStatus();
-void applyLEDState(SystemLEDState state);
+// LED maintenance task wake-up (LED activity callback)
+void wakeRGBLedMaintenance();
 
 // ============================================================================
 // TASK CALLBACK FORWARD DECLARATIONS
@@ -125,7 +169,6 @@ void applyLEDState(SystemLEDState state);
 void displayTimeTask();
 void processSerialTask();
 void motorMaintenanceTask();
-void vibrationMaintenanceTask();
 void rgbLedMaintenanceTask();
 void touchSensorMaintenanceTask();
 void feedingMonitorTask();
@@ -133,12 +176,14 @@ void scheduleMonitorTask();
 void wifiMonitorTask();
 void ntpSyncTask();
 void wifiPortalTask();
+void cpuGovernorTask();
+void inputFlushTask();
+void seriesSampleTask();
 
 // Task definitions using configuration constants
 Task tDisplayTime(DISPLAY_TIME_INTERVAL, TASK_FOREVER, &displayTimeTask, &taskScheduler, true);
 Task tProcessSerial(SERIAL_PROCESS_INTERVAL, TASK_FOREVER, &processSerialTask, &taskScheduler, true);
 Task tMotorMaintenance(MOTOR_MAINTENANCE_INTERVAL, TASK_FOREVER, &motorMaintenanceTask, &taskScheduler, true);
-Task tVibrationMaintenance(VIBRATION_MAINTENANCE_INTERVAL, TASK_FOREVER, &vibrationMaintenanceTask, &taskScheduler, true);
 Task tRGBLedMaintenance(RGB_LED_MAINTENANCE_INTERVAL, TASK_FOREVER, &rgbLedMaintenanceTask, &taskScheduler, true);
 Task tTouchSensorMaintenance(TOUCH_SENSOR_MAINTENANCE_INTERVAL, TASK_FOREVER, &touchSensorMaintenanceTask, &taskScheduler, true);
 Task tFeedingMonitor(100, TASK_FOREVER, &feedingMonitorTask, &taskScheduler, false); // Start disabled
@@ -146,6 +191,13 @@ Task tScheduleMonitor(FEEDING_SCHEDULE_MONITOR_INTERVAL, TASK_FOREVER, &schedule
 Task tWiFiMonitor(WIFI_CONNECTION_CHECK_INTERVAL, TASK_FOREVER, &wifiMonitorTask, &taskScheduler, true);
 Task tNTPSync(60000, TASK_FOREVER, &ntpSyncTask, &taskScheduler, true); // Check every minute
 Task tWiFiPortal(500, TASK_FOREVER, &wifiPortalTask, &taskScheduler, true); // Process portal every 500ms
+Task tCpuGovernor(CPU_GOVERNOR_INTERVAL, TASK_FOREVER, &cpuGovernorTask, &taskScheduler, true);
+Task tInputFlush(INPUT_RECORDER_FLUSH_INTERVAL, TASK_FOREVER, &inputFlushTask, &taskScheduler, true);
+Task tSeriesSample(SERIES_SAMPLE_CHECK_INTERVAL, TASK_FOREVER, &seriesSampleTask, &taskScheduler, true);
+
+// Series inputs accumulated between minute samples
+uint32_t loopMaxUs = 0;
+uint16_t feedingsThisMinute = 0;
 
 // ============================================================================
 // TASK CALLBACK IMPLEMENTATIONS
@@ -165,9 +217,40 @@ void displayTimeTask() {
  * Runs every 50ms to check for incoming serial commands
  */
 void processSerialTask() {
-    if (Serial.available()) {
-        String command = Serial.readStringUntil('\n');
-        commandListener.processCommand(command);
+    TraceBuffer::Scope trace(TraceBuffer::TASK_SERIAL, TRACE_FAST_TASKS);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_SERIAL);
+    
+    // Accumulate input without blocking; a line is processed on '\n'
+    // The line buffer keeps its overflow flag until cleared, so an over-long
+    // line is rejected as a whole instead of running a truncated command
+    static FixedString<SERIAL_COMMAND_MAX_LENGTH> line;
+    static unsigned long lastByteTime = 0;
+    
+    bool lineComplete = false;
+    while (Serial.available() && !lineComplete) {
+        char c = (char)Serial.read();
+        lastByteTime = millis();
+        if (c == '\n') {
+            lineComplete = true;
+        } else {
+            line.append(c);
+        }
+    }
+    
+    // Line without terminator: process after the input goes quiet
+    if (!lineComplete && (line.length() > 0 || line.overflowed()) &&
+        millis() - lastByteTime >= SERIAL_COMMAND_IDLE_FLUSH) {
+        lineComplete = true;
+    }
+    
+    if (lineComplete) {
+        if (line.overflowed()) {
+            Console::printlnR(F("Command too long."));
+        } else {
+            InputRecorder::recordText(InputRecorder::TYPE_SERIAL_LINE, line.c_str());
+            commandListener.processCommand(line.c_str());
+        }
+        line.clear();
     }
 }
 
@@ -176,90 +259,46 @@ void processSerialTask() {
  * Runs every 10ms to handle motor operations and stepper updates
  */
 void motorMaintenanceTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_MOTOR, TRACE_FAST_TASKS);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_MOTOR);
+    
     // Run stepper motor for non-blocking operations
     feedMotor.run();
+    
+    // Next autotune trial once the previous move ended
+    motorAutotune.update();
 }
 
 /**
- * Task: Vibration motor maintenance
- * Runs every 20ms to handle timed vibration auto-stop
- */
-void vibrationMaintenanceTask() {
-    vibrationMotor.updateState();
-}
-
-/**
- * Update LED based on system state
- * This is the SINGLE SOURCE OF TRUTH for LED status
- * Called by rgbLedMaintenanceTask() every 20ms
+ * Task: RGB LED maintenance (single LED animation scheduler)
+ * Sleeps until the next keyframe of the running animation, and is disabled
+ * while the LED is static; woken by wakeRGBLedMaintenance()
  */
-void updateLEDStatus() {
-    // Determine desired state based on system status (priority order)
-    if (moduleManager.getFeedingInProgress()) {
-        desiredLEDState = LED_STATE_FEEDING;
-    } else {
-        desiredLEDState = LED_STATE_READY;
-    }
+void rgbLedMaintenanceTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_RGB_LED, TRACE_FAST_TASKS);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_RGB_LED);
     
-    // Handle temporary cancel flash
-    if (currentLEDState == LED_STATE_CANCEL_FLASH) {
-        if (millis() - ledStateChangeTime >= CANCEL_FLASH_DURATION) {
-            // Cancel flash expired - transition to desired state
-            currentLEDState = desiredLEDState;
-            applyLEDState(currentLEDState);
-        }
-        // Still flashing, don't change
-        return;
-    }
+    // Advance the LED animation (keyframes, fade completion)
+    rgbLed.update();
     
-    // Apply desired state if different from current
-    if (desiredLEDState != currentLEDState) {
-        currentLEDState = desiredLEDState;
-        applyLEDState(currentLEDState);
-    }
-}
-
-/**
- * Apply LED state to hardware
- */
-void applyLEDState(SystemLEDState state) {
-    switch (state) {
-        case LED_STATE_READY:
-            rgbLed.setDeviceStatus(RGBLed::STATUS_READY);
-            Console::println(F("LED: READY (green solid)"));
-            break;
-            
-        case LED_STATE_FEEDING:
-            rgbLed.setDeviceStatus(RGBLed::STATUS_FEEDING);
-            Console::println(F("LED: FEEDING (green blink)"));
-            break;
-            
-        case LED_STATE_CANCEL_FLASH:
-            rgbLed.stopBlink();
-            rgbLed.setColor(255, 0, 0);
-            rgbLed.turnOn();
-            ledStateChangeTime = millis();
-            Console::println(F("LED: CANCEL FLASH (red)"));
-            break;
-            
-        case LED_STATE_ERROR:
-            rgbLed.setColor(255, 0, 0);
-            rgbLed.turnOn();
-            Console::println(F("LED: ERROR (red solid)"));
-            break;
+    // Drop a finished one-shot status layer (e.g. cancel flash)
+    ledStatus.update();
+    
+    unsigned long nextUpdate = rgbLed.getNextUpdateDelay();
+    if (nextUpdate == 0) {
+        // Nothing to animate: sleep until an animation or status change
+        tRGBLedMaintenance.disable();
+    } else {
+        tRGBLedMaintenance.delay(nextUpdate);
     }
 }
 
 /**
- * Task: RGB LED maintenance
- * Runs every 20ms to handle LED updates and state management
+ * Wake the RGB LED maintenance task
+ * Used as the LED activity callback (any animation start)
  */
-void rgbLedMaintenanceTask() {
-    // Update LED hardware (blinking, fading, etc)
-    rgbLed.update();
-    
-    // Update LED status based on system state
-    updateLEDStatus();
+void wakeRGBLedMaintenance() {
+    tRGBLedMaintenance.enableIfNot();
 }
 
 /**
@@ -267,28 +306,48 @@ void rgbLedMaintenanceTask() {
  * Runs every 20ms to handle touch detection, debouncing, and callbacks
  */
 void touchSensorMaintenanceTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_TOUCH, TRACE_FAST_TASKS);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_TOUCH);
+    
+    // Raw edges (before debouncing) are what a replay has to reproduce
+    static bool wasTouchedRaw = false;
+    bool touchedRaw = touchSensor.isTouchedRaw();
+    if (touchedRaw != wasTouchedRaw) {
+        InputRecorder::recordByte(InputRecorder::TYPE_TOUCH_EDGE, touchedRaw);
+        wasTouchedRaw = touchedRaw;
+    }
+    
     touchSensor.update();
 }
 
 /**
  * Task: Monitor feeding operations
- * Runs every 100ms to check if async feeding is complete
+ * Runs every 100ms to check if async feeding is complete and to drive
+ * hopper agitation through the motion profile
  */
 void feedingMonitorTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_FEEDING_MONITOR);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_FEEDING_MONITOR);
     static bool wasFeeding = false;
     
+    // Hopper agitation follows the stepper acceleration/cruise/deceleration
+    feedingController.update();
+    
     if (moduleManager.getFeedingInProgress() && !feedMotor.isRunning()) {
         // Feeding completed
         Console::printlnR(F("Food dispensing completed successfully"));
         moduleManager.setFeedingInProgress(false);
+        TraceBuffer::end(TraceBuffer::FEED, 1);
+        feedingController.finishFeeding();
+        feedingsThisMinute++;
         tFeedingMonitor.disable();
         wasFeeding = false;
-        // LED will automatically transition to READY via updateLEDStatus()
+        ledStatus.pop(LedStatusCompositor::LAYER_FEEDING);
+        vibrationMotor.play(VibrationMotor::PATTERN_FEED_DONE);
     } else if (moduleManager.getFeedingInProgress() && !wasFeeding) {
         // Feeding just started
         Console::println(F("Feeding in progress detected"));
         wasFeeding = true;
-        // LED will automatically show FEEDING via updateLEDStatus()
     }
 }
 
@@ -297,11 +356,11 @@ void feedingMonitorTask() {
  * Runs every 30 seconds to check for scheduled feeding times
  */
 void scheduleMonitorTask() {
-    // Get current time from RTC
-    DateTime currentTime = rtcModule.now();
+    TraceBuffer::Scope trace(TraceBuffer::TASK_SCHEDULE_MONITOR);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_SCHEDULE_MONITOR);
     
-    // Process schedules - this handles all scheduled feeding logic
-    feedingSchedule.processSchedules(currentTime);
+    // Process schedules with the RTC time (UTC) - this handles all scheduled feeding logic
+    feedingSchedule.processSchedules(rtcModule.nowUtc());
     
     // If scheduled feeding triggered manual feeding, update the schedule system
     // (This logic is handled by the existing feedingMonitorTask)
@@ -312,8 +371,11 @@ void scheduleMonitorTask() {
  * Runs every 10 seconds to check connection and handle auto-reconnection
  */
 void wifiMonitorTask() {
-    // 🚨 CRITICAL: Continuously verify LED status matches actual WiFi state
-    // This ensures LED always reflects the true connection state
+    TraceBuffer::Scope trace(TraceBuffer::TASK_WIFI_MONITOR);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_WIFI_MONITOR);
+    
+    // LED WiFi layer follows connection changes (WiFiController also sets it
+    // during connection attempts)
     
     static bool wasConnected = false;
     bool isConnected = wifiController.isWiFiConnected();
@@ -322,31 +384,14 @@ void wifiMonitorTask() {
     if (!isConnected && wasConnected) {
         // Just lost connection
         Console::printlnR(F("WiFi connection lost!"));
+        ledStatus.push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
     } else if (isConnected && !wasConnected) {
         // Just got connected
         Console::printlnR(F("WiFi connection established - notifying NTP module"));
+        ledStatus.pop(LedStatusCompositor::LAYER_WIFI);
         ntpSync.onWiFiConnected();
     }
     
-    // 🚨 CRITICAL: Ensure LED status is always correct
-    // Check every cycle to prevent LED showing wrong state
-    if (isConnected) {
-        // Connected: LED should be GREEN (unless feeding is in progress)
-        if (rgbLed.getDeviceStatus() == RGBLed::STATUS_WIFI_CONNECTING || 
-            rgbLed.getDeviceStatus() == RGBLed::STATUS_WIFI_ERROR) {
-            // Was showing WiFi status, now we're connected
-            if (!moduleManager.getFeedingInProgress()) {
-                rgbLed.setDeviceStatus(RGBLed::STATUS_READY);
-            }
-        }
-    } else {
-        // Not connected: LED should show trying or error
-        if (rgbLed.getDeviceStatus() == RGBLed::STATUS_READY) {
-            // Was ready, but connection lost - show error
-            rgbLed.setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
-        }
-    }
-    
     wifiController.checkConnectionStatus();
     wifiController.handleAutoReconnect();
     
@@ -358,25 +403,11 @@ void wifiMonitorTask() {
  * Runs every minute to check if NTP sync is needed
  */
 void ntpSyncTask() {
-    // 🚨 STATUS: TIME_SYNCING - Yellow 50% blinking 500ms
-    static bool wasSyncing = false;
-    bool isSyncing = ntpSync.isSyncInProgress();
-    
-    // Detect sync start
-    if (isSyncing && !wasSyncing) {
-        // Only change status if we're in ready state (don't override feeding)
-        if (rgbLed.getDeviceStatus() == RGBLed::STATUS_READY) {
-            rgbLed.setDeviceStatus(RGBLed::STATUS_TIME_SYNCING);
-        }
-    } else if (!isSyncing && wasSyncing) {
-        // Sync completed - return to ready if we were syncing
-        if (rgbLed.getDeviceStatus() == RGBLed::STATUS_TIME_SYNCING) {
-            rgbLed.setDeviceStatus(RGBLed::STATUS_READY);
-        }
-    }
+    TraceBuffer::Scope trace(TraceBuffer::TASK_NTP_SYNC);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_NTP_SYNC);
     
+    // LED time sync layer is pushed/popped by NTPSync itself
     ntpSync.handleNTPSync();
-    wasSyncing = isSyncing;
 }
 
 // ============================================================================
@@ -450,6 +481,28 @@ void showTaskStatus() {
     Console::printR(String(tNTPSync.getInterval()));
     Console::printlnR(F("ms"));
     
+    Console::printR(F("CPU Governor Task - Enabled: "));
+    Console::printR(tCpuGovernor.isEnabled() ? F("Yes") : F("No"));
+    Console::printR(F(", Interval: "));
+    Console::printR(String(tCpuGovernor.getInterval()));
+    Console::printR(F("ms, CPU: "));
+    Console::printR(String(cpuGovernor.getFrequencyMhz()));
+    Console::printlnR(F(" MHz"));
+    
+    Console::printR(F("Input Flush Task - Enabled: "));
+    Console::printR(tInputFlush.isEnabled() ? F("Yes") : F("No"));
+    Console::printR(F(", Interval: "));
+    Console::printR(String(tInputFlush.getInterval()));
+    Console::printR(F("ms, Recording: "));
+    Console::printlnR(InputRecorder::isEnabled() ? F("ON") : F("OFF"));
+    
+    Console::printR(F("Series Sample Task - Enabled: "));
+    Console::printR(tSeriesSample.isEnabled() ? F("Yes") : F("No"));
+    Console::printR(F(", Interval: "));
+    Console::printR(String(tSeriesSample.getInterval()));
+    Console::printR(F("ms, Store: "));
+    Console::printlnR(seriesStore.isReady() ? F("Ready") : F("Unavailable"));
+    
     Console::printlnR(F(""));
     Console::printR(F("Feeding in Progress: "));
     Console::printlnR(moduleManager.getFeedingInProgress() ? F("Yes") : F("No"));
@@ -468,24 +521,26 @@ void showTaskStatus() {
  * Touch sensor event callback
  * 
  * NEW BEHAVIOR:
- * - TOUCH_PRESSED: Quick short vibration (50ms) for tactile feedback
- * - TOUCH_RELEASED: Stop vibration
+ * - TOUCH_PRESSED: "ack" haptic pattern (50ms tick) for tactile feedback
+ * - TOUCH_RELEASED: No action (patterns stop on their own)
  * - TOUCH_LONG_PRESS:
- *   • If feeding in progress: Cancel feeding + Red LED for 1s + Longer vibration (200ms)
- *   • If not feeding: Start feeding with configured portions + Longer vibration (200ms)
+ *   • If feeding in progress: Cancel feeding + red flash + "error" haptic pattern
+ *   • If not feeding: Start feeding with configured portions + "long-press" pattern (200ms)
  */
 void onTouchEvent(TouchSensor::TouchEvent event, unsigned long duration) {
+    TraceBuffer::instant(TraceBuffer::TOUCH_EVENT, event);
+    
     switch (event) {
         case TouchSensor::TOUCH_PRESSED:
             // Quick short vibration on touch (only if touch sensor is enabled)
-            if (touchSensorEnabled) {
-                vibrationMotor.startTimed(60, TOUCH_VIBRATION_SHORT_DURATION);  // 60% for 50ms
+            if (runtimeConfig.getBool(RuntimeConfig::CONFIG_TOUCH_ENABLED)) {
+                vibrationMotor.play(VibrationMotor::PATTERN_ACK);  // 60% for 50ms
             }
             Console::println(F("Touch pressed"));
             break;
             
         case TouchSensor::TOUCH_RELEASED:
-            // Touch released - no action needed (vibration auto-stops with timed)
+            // Touch released - no action needed (haptic pattern stops on its own)
             Console::print(F("Touch released ("));
             Console::print(String(duration));
             Console::println(F("ms)"));
@@ -497,21 +552,25 @@ void onTouchEvent(TouchSensor::TouchEvent event, unsigned long duration) {
             Console::println(F("ms)"));
             
             // Check if touch sensor is enabled
-            if (!touchSensorEnabled) {
+            if (!runtimeConfig.getBool(RuntimeConfig::CONFIG_TOUCH_ENABLED)) {
                 Console::println(F("Touch sensor disabled - ignoring long press"));
                 return;
             }
             
-            // Longer vibration for long press feedback (reduced intensity)
-            vibrationMotor.startTimed(60, TOUCH_VIBRATION_LONG_DURATION);  // 60% for 200ms
-            
             // Check if feeding is currently in progress
             if (moduleManager.getFeedingInProgress()) {
-                // CANCEL FEEDING - Use centralized method
+                // CANCEL FEEDING - Use centralized method (plays the error pattern)
                 cancelFeeding();
             } else {
+                // Longer vibration for long press feedback (60% for 200ms)
+                vibrationMotor.play(VibrationMotor::PATTERN_LONG_PRESS);
+                
                 // START FEEDING - Use centralized method with configured portions
-                startFeeding(touchLongPressPortions, true);
+                // The request counts from when the hold crossed the threshold
+                unsigned long lateMs = duration - touchSensor.getLongPressDuration();
+                FeedLatencyTracker::Trigger trigger = FeedLatencyTracker::Trigger::now(FeedLatencyTracker::SOURCE_TOUCH);
+                trigger.timeUs -= lateMs * 1000UL;
+                startFeeding(getTouchLongPressPortions(), true, trigger);
             }
             break;
     }
@@ -548,17 +607,36 @@ void setup() {
   moduleManager.registerNTPSync(&ntpSync);
   moduleManager.registerVibrationMotor(&vibrationMotor);
   moduleManager.registerRGBLed(&rgbLed);
+  moduleManager.registerLedStatus(&ledStatus);
   moduleManager.registerTouchSensor(&touchSensor);
+  moduleManager.registerRuntimeConfig(&runtimeConfig);
+  moduleManager.registerMotorAutotune(&motorAutotune);
+  moduleManager.registerCpuGovernor(&cpuGovernor);
+  moduleManager.registerSamplingProfiler(&samplingProfiler);
+  moduleManager.registerFeedLatencyTracker(&feedLatency);
+  moduleManager.registerSeriesStore(&seriesStore);
   
   Console::printlnR(F("✓ All modules registered with ModuleManager"));
   Console::printlnR(F("==========================================="));
   Console::printlnR(F(""));
   
+  // Load user settings first - modules below are configured from them
+  runtimeConfig.begin();
+  
+  // Stall attribution covers the blocking calls setup() makes, too
+  LoopWatchdog::begin(runtimeConfig.getInt(RuntimeConfig::CONFIG_WATCHDOG_BUDGET),
+                      runtimeConfig.getBool(RuntimeConfig::CONFIG_WATCHDOG_HW));
+  
+  // Input recording starts before anything can react to input
+  InputRecorder::begin(runtimeConfig.getBool(RuntimeConfig::CONFIG_INPUT_RECORD));
+  
   // 🚨 CRITICAL: Initialize RGB LED FIRST for status indication
   if (rgbLed.begin()) {
     Console::printlnR(F("RGB LED: Initialized - Setting BOOTING status"));
-    // STATUS: BOOTING - Red 50% blinking 500ms
-    rgbLed.setDeviceStatus(RGBLed::STATUS_BOOTING);
+    // Maintenance task sleeps while the LED is static; effects wake it
+    rgbLed.setActivityCallback(wakeRGBLedMaintenance);
+    // STATUS: BOOTING - Red 50% blinking 500ms (base status until setup ends)
+    ledStatus.setBase(RGBLed::STATUS_BOOTING);
   } else {
     Console::printlnR(F("ERROR: Failed to initialize RGB LED"));
   }
@@ -567,22 +645,17 @@ void setup() {
   if (touchSensor.begin(false)) {  // false = no internal pull-up
     Console::printR(F("Touch sensor: Initialized on pin "));
     Console::println(String(TOUCH_SENSOR_PIN));
-    touchSensor.setDebounceDelay(TOUCH_SENSOR_DEBOUNCE_DELAY);
-    touchSensor.setLongPressDuration(TOUCH_SENSOR_LONG_PRESS_DURATION);
+    touchSensor.setDebounceDelay(runtimeConfig.getInt(RuntimeConfig::CONFIG_TOUCH_DEBOUNCE));
+    touchSensor.setLongPressDuration(runtimeConfig.getInt(RuntimeConfig::CONFIG_TOUCH_LONG_PRESS));
     
     // Register callback for touch events (vibration feedback)
     touchSensor.setCallback(onTouchEvent);
     Console::printlnR(F("Touch sensor callback registered (vibration feedback)"));
     
-    // Load touch long press portions from NVRAM
-    touchPreferences.begin("touch", false);
-    touchLongPressPortions = touchPreferences.getUChar(TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY, DEFAULT_TOUCH_LONG_PRESS_PORTIONS);
-    touchSensorEnabled = touchPreferences.getBool(TOUCH_SENSOR_ENABLED_NVRAM_KEY, DEFAULT_TOUCH_SENSOR_ENABLED);
-    touchPreferences.end();
-    Console::printR(F("Touch long press portions loaded from NVRAM: "));
-    Console::printlnR(String(touchLongPressPortions));
+    Console::printR(F("Touch long press portions: "));
+    Console::printlnR(String(getTouchLongPressPortions()));
     Console::printR(F("Touch sensor enabled: "));
-    Console::printlnR(touchSensorEnabled ? F("YES") : F("NO"));
+    Console::printlnR(getTouchSensorEnabled() ? F("YES") : F("NO"));
   } else {
     Console::printlnR(F("ERROR: Failed to initialize touch sensor"));
   }
@@ -593,6 +666,9 @@ void setup() {
     Console::printlnR(F("Run 'rtcModule.scanI2C()' for manual diagnostics."));
   }
   
+  // History is aligned to RTC time; allocated early, before WiFi fragments the heap
+  seriesStore.begin();
+  
   // Keep LED blinking during boot (non-blocking updates)
   for (int i = 0; i < 10; i++) {
     rgbLed.update();
@@ -602,20 +678,26 @@ void setup() {
   // Initialize stepper motor
   if (!feedMotor.begin()) {
     Console::printlnR(F("ERROR: Failed to initialize stepper motor"));
-    Console::printlnR(F("Check connections (ESP32 DevKit V1 30-pin):"));
+    Console::printlnR(F("Check connections (" FEEDER_BOARD_NAME "):"));
     Console::printlnR(F("ULN2003 Motor Driver:"));
-    Console::printlnR(F("- IN1 -> GPIO 15"));
-    Console::printlnR(F("- IN2 -> GPIO 4"));
-    Console::printlnR(F("- IN3 -> GPIO 5"));
-    Console::printlnR(F("- IN4 -> GPIO 18"));
+    Console::printlnR("- IN1 -> GPIO " + String(STEPPER_IN1_PIN));
+    Console::printlnR("- IN2 -> GPIO " + String(STEPPER_IN2_PIN));
+    Console::printlnR("- IN3 -> GPIO " + String(STEPPER_IN3_PIN));
+    Console::printlnR("- IN4 -> GPIO " + String(STEPPER_IN4_PIN));
     Console::printlnR(F("- VCC -> 5V Direct"));
     Console::printlnR(F("- GND -> GND"));
     Console::printlnR(F("RTC DS3231 (when connected):"));
-    Console::printlnR(F("- SDA -> GPIO 21"));
-    Console::printlnR(F("- SCL -> GPIO 22"));
+    Console::printlnR("- SDA -> GPIO " + String(RTC_SDA_PIN));
+    Console::printlnR("- SCL -> GPIO " + String(RTC_SCL_PIN));
   } else {
-    feedMotor.setMaxSpeed(DEFAULT_MAX_SPEED);
-    feedMotor.setAcceleration(DEFAULT_ACCELERATION);
+    feedMotor.setMaxSpeed(runtimeConfig.getInt(RuntimeConfig::CONFIG_MOTOR_SPEED));
+    feedMotor.setAcceleration(runtimeConfig.getInt(RuntimeConfig::CONFIG_MOTOR_ACCEL));
+    feedMotor.setMotorDirection(runtimeConfig.getBool(RuntimeConfig::CONFIG_MOTOR_CLOCKWISE));
+    
+    // Auger index sensor - homing starts once the tasks run (end of setup)
+    if (INDEX_SENSOR_ENABLED && indexSensor.begin()) {
+      feedMotor.setIndexSensor(&indexSensor);
+    }
     
     // Initialize feeding controller
     if (!feedingController.begin()) {
@@ -654,8 +736,8 @@ void setup() {
   
   Console::printlnR(F("=== Transitioning to WiFi Connection Phase ==="));
   
-  // 🚨 STATUS: WIFI_CONNECTING - Blue 50% blinking 500ms
-  rgbLed.setDeviceStatus(RGBLed::STATUS_WIFI_CONNECTING);
+  // 🚨 STATUS: WIFI_CONNECTING - Blue 100% static
+  ledStatus.push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_CONNECTING);
   
   // Keep LED blinking during WiFi init
   for (int i = 0; i < 10; i++) {
@@ -669,9 +751,9 @@ void setup() {
     Console::printlnR(F("WiFi functions will be limited"));
   }
   
-  // Configure WiFi Controller with RGB LED reference for status indication
-  wifiController.setRGBLed(&rgbLed);
-  Console::printlnR(F("WiFi Controller: RGB LED integration configured"));
+  // Configure WiFi Controller with the LED status compositor (WiFi layer)
+  wifiController.setLedStatus(&ledStatus);
+  Console::printlnR(F("WiFi Controller: LED status integration configured"));
   
   // Keep LED blinking during WiFi connection (longer period)
   Console::printlnR(F("Waiting for WiFi connection..."));
@@ -712,6 +794,22 @@ void setup() {
   feedingSchedule.setEnableMonitorCallback(enableFeedingMonitor);
   Console::printlnR(F("Feeding Schedule: Monitor callback registered"));
   
+  // Apply stored settings owned by modules initialized above, then follow changes
+  feedingSchedule.setTolerance(runtimeConfig.getInt(RuntimeConfig::CONFIG_SCHEDULE_TOLERANCE));
+  feedingSchedule.setMaxRecoveryHours(runtimeConfig.getInt(RuntimeConfig::CONFIG_SCHEDULE_RECOVERY));
+  ntpSync.setSyncInterval(runtimeConfig.getInt(RuntimeConfig::CONFIG_NTP_INTERVAL) * 60000UL);
+  feedingController.setVibrationMotor(&vibrationMotor);
+  feedingController.setLatencyTracker(&feedLatency);
+  feedingController.setAgitation(runtimeConfig.getBool(RuntimeConfig::CONFIG_AGITATE_ENABLED),
+                                 runtimeConfig.getInt(RuntimeConfig::CONFIG_AGITATE_DUTY));
+  feedingController.setDispenseProfile(runtimeConfig.getInt(RuntimeConfig::CONFIG_DISPENSE_PROFILE));
+  if (feedMotor.hasIndexSensor()) {
+    // Closed-loop agitation: index edges confirm the auger is turning
+    feedingController.setDeliverySensor(readIndexDelivery);
+  }
+  runtimeConfig.addListener(onRuntimeConfigChanged);
+  motorAutotune.setResultCallback(onAutotuneResult);
+  
   // Configure WiFi Controller with ModuleManager reference for web interface
   wifiController.setModuleManager(&moduleManager);
   
@@ -754,8 +852,21 @@ void setup() {
   Console::printlnR(F("ms (non-blocking)"));
   Console::printlnR(F("System ready - Non-blocking operation active"));
   
-  // 🚨 STATUS: READY - Green 60% static
-  rgbLed.setDeviceStatus(RGBLed::STATUS_READY);
+  // Boot (WiFi connect, portal setup) ran at full clock; idle from here on
+  cpuGovernor.begin(runtimeConfig.getBool(RuntimeConfig::CONFIG_CPU_SCALING));
+  
+  // Home the auger against the index (non-blocking, driven by the motor task)
+  if (feedMotor.hasIndexSensor()) {
+    feedMotor.startHoming();
+  }
+  
+  // 🚨 STATUS: READY - Green 60% static (WiFi layer shows an error if still offline)
+  if (wifiController.isWiFiConnected()) {
+    ledStatus.pop(LedStatusCompositor::LAYER_WIFI);
+  } else {
+    ledStatus.push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
+  }
+  ledStatus.setBase(RGBLed::STATUS_READY);
 }
 
 // ============================================================================
@@ -774,9 +885,10 @@ void setup() {
  * 
  * @param portions: Number of portions to dispense
  * @param recordInSchedule: Whether to record this as manual feeding in schedule
+ * @param trigger: Request source and arrival time (feed latency tracking)
  * @return: true if feeding started successfully, false otherwise
  */
-bool startFeeding(uint8_t portions, bool recordInSchedule) {
+bool startFeeding(uint8_t portions, bool recordInSchedule, const FeedLatencyTracker::Trigger& trigger) {
     // Validate portions
     if (portions < MIN_FOOD_PORTIONS || portions > MAX_FOOD_PORTIONS) {
         String msg = String(F("✗ Invalid portion count: ")) + String(portions);
@@ -790,6 +902,12 @@ bool startFeeding(uint8_t portions, bool recordInSchedule) {
         return false;
     }
     
+    // Autotune owns the motor until it ends (MOTOR AUTOTUNE STOP)
+    if (motorAutotune.isRunning()) {
+        Console::printlnR(F("✗ Motor autotune in progress"));
+        return false;
+    }
+    
     // Check if controller is ready
     if (!feedingController.isReady()) {
         Console::printlnR(F("✗ Feeding controller not ready"));
@@ -800,19 +918,18 @@ bool startFeeding(uint8_t portions, bool recordInSchedule) {
     Console::printlnR(msg);
     
     // Start async feeding
-    if (feedingController.dispenseFoodAsync(portions)) {
+    if (feedingController.dispenseFoodAsync(portions, &trigger)) {
         // Mark feeding as in progress
         moduleManager.setFeedingInProgress(true);
+        TraceBuffer::begin(TraceBuffer::FEED, portions);
+        ledStatus.push(LedStatusCompositor::LAYER_FEEDING, RGBLed::STATUS_FEEDING);
         
         // Enable monitoring task
         tFeedingMonitor.enable();
         
-        // LED will automatically transition to FEEDING via updateLEDStatus()
-        
         // Record in schedule system if requested
         if (recordInSchedule && moduleManager.hasFeedingSchedule() && moduleManager.hasRTCModule()) {
-            DateTime now = moduleManager.getRTCModule()->now();
-            moduleManager.getFeedingSchedule()->recordManualFeeding(now);
+            moduleManager.getFeedingSchedule()->recordManualFeeding(moduleManager.getRTCModule()->nowUtc());
         }
         
         Console::printlnR(F("✓ Feeding started successfully"));
@@ -837,18 +954,21 @@ bool cancelFeeding() {
     
     Console::printlnR(F("⚠ Canceling feeding operation..."));
     
-    // Stop motor immediately - clears target position
+    // Stop motor immediately - clears target position (and a pre-feed homing)
     feedMotor.stop();
+    feedingController.cancel();
     
     // Mark feeding as completed
     moduleManager.setFeedingInProgress(false);
+    TraceBuffer::end(TraceBuffer::FEED, 0);
     
     // Disable monitoring task
     tFeedingMonitor.disable();
     
-    // Trigger cancel flash - will auto-transition to READY after timeout
-    currentLEDState = LED_STATE_CANCEL_FLASH;
-    applyLEDState(LED_STATE_CANCEL_FLASH);
+    // Cancel flash - one-shot layer, pops itself when the flash ends
+    ledStatus.pop(LedStatusCompositor::LAYER_FEEDING);
+    ledStatus.pushOneShot(LedStatusCompositor::LAYER_ERROR, RGBLed::STATUS_CANCELED);
+    vibrationMotor.play(VibrationMotor::PATTERN_ERROR);
     
     Console::printlnR(F("✓ Feeding canceled successfully"));
     return true;
@@ -858,50 +978,139 @@ bool cancelFeeding() {
  * Get current touch long press portions setting
  */
 uint8_t getTouchLongPressPortions() {
-    return touchLongPressPortions;
+    return (uint8_t)runtimeConfig.getInt(RuntimeConfig::CONFIG_TOUCH_PORTIONS);
 }
 
 /**
- * Set touch long press portions and save to NVRAM
+ * Set touch long press portions (persisted by RuntimeConfig)
  */
 void setTouchLongPressPortions(uint8_t portions) {
-    // Validate range
-    if (portions < MIN_FOOD_PORTIONS) portions = MIN_FOOD_PORTIONS;
-    if (portions > MAX_FOOD_PORTIONS) portions = MAX_FOOD_PORTIONS;
-    
-    touchLongPressPortions = portions;
-    
-    // Save to NVRAM
-    touchPreferences.begin("touch", false);
-    touchPreferences.putUChar(TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY, portions);
-    touchPreferences.end();
+    runtimeConfig.setInt(RuntimeConfig::CONFIG_TOUCH_PORTIONS, clampPortions(portions));
     
     Console::printR(F("Touch long press portions set to: "));
-    Console::printlnR(String(portions));
+    Console::printlnR(String(getTouchLongPressPortions()));
 }
 
 /**
  * Get current touch sensor enabled state
  */
 bool getTouchSensorEnabled() {
-    return touchSensorEnabled;
+    return runtimeConfig.getBool(RuntimeConfig::CONFIG_TOUCH_ENABLED);
 }
 
 /**
- * Set touch sensor enabled/disabled state and save to NVRAM
+ * Set touch sensor enabled/disabled state (persisted by RuntimeConfig)
  */
 void setTouchSensorEnabled(bool enabled) {
-    touchSensorEnabled = enabled;
-    
-    // Save to NVRAM
-    touchPreferences.begin("touch", false);
-    touchPreferences.putBool(TOUCH_SENSOR_ENABLED_NVRAM_KEY, enabled);
-    touchPreferences.end();
+    runtimeConfig.setBool(RuntimeConfig::CONFIG_TOUCH_ENABLED, enabled);
     
     Console::printR(F("Touch sensor "));
     Console::printlnR(enabled ? F("ENABLED") : F("DISABLED"));
 }
 
+/**
+ * Apply a changed runtime setting to the module that owns it
+ * Registered with RuntimeConfig at the end of setup()
+ * Touch portions/enabled are read live and need no action
+ * 
+ * @param id: Setting that changed
+ */
+void onRuntimeConfigChanged(RuntimeConfig::Id id) {
+    switch (id) {
+        case RuntimeConfig::CONFIG_TOUCH_DEBOUNCE:
+            touchSensor.setDebounceDelay(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_TOUCH_LONG_PRESS:
+            touchSensor.setLongPressDuration(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_MOTOR_CLOCKWISE:
+            feedMotor.setMotorDirection(runtimeConfig.getBool(id));
+            break;
+        case RuntimeConfig::CONFIG_SCHEDULE_TOLERANCE:
+            feedingSchedule.setTolerance(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_SCHEDULE_RECOVERY:
+            feedingSchedule.setMaxRecoveryHours(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_NTP_INTERVAL:
+            ntpSync.setSyncInterval(runtimeConfig.getInt(id) * 60000UL);
+            break;
+        case RuntimeConfig::CONFIG_AGITATE_ENABLED:
+        case RuntimeConfig::CONFIG_AGITATE_DUTY:
+            feedingController.setAgitation(runtimeConfig.getBool(RuntimeConfig::CONFIG_AGITATE_ENABLED),
+                                           runtimeConfig.getInt(RuntimeConfig::CONFIG_AGITATE_DUTY));
+            break;
+        case RuntimeConfig::CONFIG_DISPENSE_PROFILE:
+            feedingController.setDispenseProfile(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_MOTOR_SPEED:
+            feedMotor.setMaxSpeed(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_MOTOR_ACCEL:
+            feedMotor.setAcceleration(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_CPU_SCALING:
+            cpuGovernor.setEnabled(runtimeConfig.getBool(id));
+            break;
+        case RuntimeConfig::CONFIG_INPUT_RECORD:
+            InputRecorder::setEnabled(runtimeConfig.getBool(id));
+            break;
+        case RuntimeConfig::CONFIG_WATCHDOG_BUDGET:
+            LoopWatchdog::setBudget(runtimeConfig.getInt(id));
+            break;
+        case RuntimeConfig::CONFIG_WATCHDOG_HW:
+            LoopWatchdog::setHardwareEnabled(runtimeConfig.getBool(id));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Persist the MOTOR AUTOTUNE result (motor.speed / motor.accel)
+ * The motor already runs with it; the change listener re-applies the same values
+ * 
+ * @param maxSpeed: Tuned speed in steps/second
+ * @param acceleration: Tuned acceleration in steps/second²
+ */
+void onAutotuneResult(uint16_t maxSpeed, uint16_t acceleration) {
+    runtimeConfig.setInt(RuntimeConfig::CONFIG_MOTOR_SPEED, maxSpeed);
+    runtimeConfig.setInt(RuntimeConfig::CONFIG_MOTOR_ACCEL, acceleration);
+    Console::printlnR(F("Autotune result saved (motor.speed / motor.accel)"));
+}
+
+/**
+ * Delivery feedback for closed-loop agitation, from the auger index sensor
+ * Food bridging or jamming in the hopper stalls the auger and the stepper
+ * skips, so index edges stop while steps are still commanded. Steps
+ * commanded since the last edge beyond one revolution (plus the lost-step
+ * tolerance) count as not delivered; the first reading of a move and every
+ * new edge count as delivered. Moves shorter than that never report a lag.
+ * 
+ * @return: Steps delivered in the current async move, or -1 before it stepped
+ */
+long readIndexDelivery() {
+    static uint32_t moveFirstStepUs = 0;
+    static uint32_t seenEdges = 0;
+    static long stepsAtEdge = 0;
+    
+    uint32_t firstStepUs;
+    if (!feedMotor.getMoveFirstStepMicros(firstStepUs)) {
+        return -1;
+    }
+    
+    long commanded = feedMotor.getMoveStepsCompleted();
+    uint32_t edges = indexSensor.getEdgeCount();
+    if (firstStepUs != moveFirstStepUs || edges != seenEdges) {
+        moveFirstStepUs = firstStepUs;
+        seenEdges = edges;
+        stepsAtEdge = commanded;
+    }
+    
+    long overdue = commanded - stepsAtEdge - (STEPS_PER_REVOLUTION + (long)INDEX_LOST_STEP_TOLERANCE);
+    return overdue > 0 ? commanded - overdue : commanded;
+}
+
 // ============================================================================
 // MAIN LOOP
 // ============================================================================
@@ -911,10 +1120,86 @@ void setTouchSensorEnabled(bool enabled) {
  * Runs every 500ms to handle portal requests
  */
 void wifiPortalTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_WIFI_PORTAL);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_WIFI_PORTAL);
     wifiController.processConfigPortal();
 }
 
+/**
+ * Task: CPU frequency governor
+ * Drops back to the idle clock once the web request boost expires
+ */
+void cpuGovernorTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_CPU_GOVERNOR);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_CPU_GOVERNOR);
+    cpuGovernor.update();
+}
+
+/**
+ * Task: Write recorded inputs to flash
+ * Flash writes stall the caches, so they wait while a feeding is running
+ */
+void inputFlushTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_INPUT_FLUSH);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_INPUT_FLUSH);
+    if (moduleManager.getFeedingInProgress()) {
+        return;
+    }
+    InputRecorder::flush();
+}
+
+/**
+ * Task: Sample the time-series store
+ * Checks for a new RTC minute and adds the values of the one that ended;
+ * checkpoints the store hourly, like input flushes not while feeding
+ */
+void seriesSampleTask() {
+    TraceBuffer::Scope trace(TraceBuffer::TASK_SERIES);
+    LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_SERIES);
+    static uint32_t currentMinute = 0;
+    static uint32_t seenOffsetCount = 0;
+    static unsigned long lastCheckpoint = 0;
+    
+    uint32_t minute = rtcModule.nowUtc() / 60;
+    if (minute == currentMinute) {
+        return;
+    }
+    
+    // The first minute after boot was only partly observed
+    if (currentMinute != 0) {
+        float values[SeriesStore::SERIES_COUNT];
+        values[SeriesStore::SERIES_HEAP_FREE] = ESP.getFreeHeap() / 1024.0f;
+        values[SeriesStore::SERIES_LOOP_LATENCY] = loopMaxUs / 1000.0f;
+        values[SeriesStore::SERIES_RSSI] = WiFi.status() == WL_CONNECTED ? (float)WiFi.RSSI() : NAN;
+        values[SeriesStore::SERIES_RTC_TEMPERATURE] = rtcModule.getTemperature();
+        values[SeriesStore::SERIES_FEEDS] = feedingsThisMinute;
+        values[SeriesStore::SERIES_NTP_OFFSET] =
+            ntpSync.getOffsetCount() != seenOffsetCount ? (float)ntpSync.getLastOffset() : NAN;
+        seriesStore.addSample(currentMinute * 60, values);
+    }
+    currentMinute = minute;
+    loopMaxUs = 0;
+    feedingsThisMinute = 0;
+    seenOffsetCount = ntpSync.getOffsetCount();
+    
+    if (millis() - lastCheckpoint >= SERIES_CHECKPOINT_INTERVAL && !moduleManager.getFeedingInProgress()) {
+        seriesStore.checkpoint();
+        lastCheckpoint = millis();
+    }
+}
+
 void loop() {
+  LoopWatchdog::beginPass();
+  
   // Execute all scheduled tasks
-  taskScheduler.execute();
+  if (taskScheduler.execute()) {
+    schedulerIdlePasses.inc();
+  }
+  schedulerPasses.inc();
+  
+  // Stall check; longest pass of the minute (series store)
+  uint32_t passUs = LoopWatchdog::endPass();
+  if (passUs > loopMaxUs) {
+    loopMaxUs = passUs;
+  }
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "metrics_registry.h"
+#include "string_builder.h"
+
+/**
+ * Metrics Registry Implementation
+ *
+ * Metrics register from static constructors, before setup() runs, so the
+ * list is complete and read-only by the time anything scrapes it. head and
+ * tail are constant-initialized, which makes registration independent of
+ * the order translation units are initialized in.
+ */
+
+MetricsRegistry::Metric* MetricsRegistry::head = nullptr;
+MetricsRegistry::Metric* MetricsRegistry::tail = nullptr;
+
+MetricsRegistry::Metric::Metric(Type type, const char* name, const char* help, const char* labels)
+    : name(name), help(help), labels(labels), type(type), next(nullptr) {
+    MetricsRegistry::add(this);
+}
+
+MetricsRegistry::Histogram::Histogram(const char* name, const char* help, const char* labels,
+                                      const uint32_t* bounds, uint8_t boundCount)
+    : Metric(TYPE_HISTOGRAM, name, help, labels), bounds(bounds),
+      boundCount(boundCount < METRICS_MAX_BUCKETS ? boundCount : METRICS_MAX_BUCKETS),
+      count(0), sum(0) {
+    memset(buckets, 0, sizeof(buckets));
+}
+
+/**
+ * Count one observation in its bucket
+ */
+void MetricsRegistry::Histogram::observe(uint32_t value) {
+    uint8_t bucket = 0;
+    while (bucket < boundCount && value > bounds[bucket]) {
+        bucket++;
+    }
+    __atomic_fetch_add(&buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sum, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
+}
+
+void MetricsRegistry::add(Metric* metric) {
+    // Appended, so series defined together stay together
+    if (tail) {
+        tail->next = metric;
+    } else {
+        head = metric;
+    }
+    tail = metric;
+}
+
+/**
+ * @return: Number of registered series
+ */
+uint16_t MetricsRegistry::getMetricCount() {
+    uint16_t count = 0;
+    for (const Metric* metric = head; metric; metric = metric->next) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Stream every registered metric in Prometheus text format (0.0.4)
+ *
+ * @param out: Destination (ChunkedResponse, Serial, ...)
+ */
+void MetricsRegistry::writePrometheus(Print& out) {
+    static const char* const TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+    const char* previousName = nullptr;
+
+    for (const Metric* metric = head; metric; metric = metric->next) {
+        // One HELP/TYPE header per family
+        if (!previousName || strcmp(previousName, metric->name) != 0) {
+            out.print(F("# HELP "));
+            out.print(metric->name);
+            out.print(' ');
+            out.print(metric->help);
+            out.print(F("\n# TYPE "));
+            out.print(metric->name);
+            out.print(' ');
+            out.print(TYPE_NAMES[metric->type]);
+            out.print('\n');
+            previousName = metric->name;
+        }
+
+        switch (metric->type) {
+            case TYPE_COUNTER:
+                writeSeriesName(out, *metric, "", nullptr);
+                out.print((unsigned long)static_cast<const Counter*>(metric)->get());
+                out.print('\n');
+                break;
+
+            case TYPE_GAUGE:
+                writeSeriesName(out, *metric, "", nullptr);
+                out.print((long)static_cast<const Gauge*>(metric)->get());
+                out.print('\n');
+                break;
+
+            case TYPE_HISTOGRAM: {
+                const Histogram* histogram = static_cast<const Histogram*>(metric);
+                uint32_t cumulative = 0;
+                for (uint8_t i = 0; i <= histogram->boundCount; i++) {
+                    cumulative += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+                    FixedString<10> le;
+                    if (i < histogram->boundCount) {
+                        le.append((unsigned long)histogram->bounds[i]);
+                    } else {
+                        le.append("+Inf");
+                    }
+                    writeSeriesName(out, *metric, "_bucket", le.c_str());
+                    out.print((unsigned long)cumulative);
+                    out.print('\n');
+                }
+                writeSeriesName(out, *metric, "_sum", nullptr);
+                out.print((unsigned long)__atomic_load_n(&histogram->sum, __ATOMIC_RELAXED));
+                out.print('\n');
+                // Count matches the +Inf bucket even if an observation is in flight
+                writeSeriesName(out, *metric, "_count", nullptr);
+                out.print((unsigned long)cumulative);
+                out.print('\n');
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Write "name<suffix>{labels,le="..."} " (braces only when there are labels)
+ */
+void MetricsRegistry::writeSeriesName(Print& out, const Metric& metric, const char* suffix, const char* le) {
+    out.print(metric.name);
+    out.print(suffix);
+    if (metric.labels || le) {
+        out.print('{');
+        if (metric.labels) {
+            out.print(metric.labels);
+        }
+        if (le) {
+            if (metric.labels) {
+                out.print(',');
+            }
+            out.print(F("le=\""));
+            out.print(le);
+            out.print('"');
+        }
+        out.print('}');
+    }
+    out.print(' ');
+}
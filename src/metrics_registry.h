@@ -0,0 +1,154 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Metrics Registry
+ *
+ * One place for the counters, gauges and histograms the modules keep, served
+ * as Prometheus text (/metrics, METRICS command) so a scraper can watch a
+ * whole fleet.
+ *
+ * Metrics are static objects that register themselves when constructed, so
+ * a module only defines one next to the code it measures:
+ *   static MetricsRegistry::Counter syncAttempts("feeder_time_sync_attempts_total",
+ *                                                "Time synchronizations started");
+ *   syncAttempts.inc();
+ *
+ * - Counter: monotonic, relaxed atomic add (no locks, safe from any task)
+ * - Gauge: last set() value, or a Reader function sampled at scrape time
+ *   for values a module already tracks (heap, RSSI, ...)
+ * - Histogram: fixed upper bounds (up to METRICS_MAX_BUCKETS) plus +Inf,
+ *   with count and sum; each field is updated atomically, so a scrape may
+ *   see an observation half-applied but never a torn value
+ *
+ * Series of one family share the name and differ by labels (a constant
+ * string like "source=\"touch\""); define them next to each other so they
+ * register in a row and get one HELP/TYPE header. Values are never reset,
+ * module statistics that can be reset (FEED LATENCY RESET, TOUCH RESET)
+ * keep their own copies.
+ */
+class MetricsRegistry {
+public:
+    enum Type : uint8_t {
+        TYPE_COUNTER,
+        TYPE_GAUGE,
+        TYPE_HISTOGRAM
+    };
+
+    /**
+     * Common part of all metrics (intrusive registration list)
+     */
+    class Metric {
+    public:
+        const char* getName() const { return name; }
+        Type getType() const { return type; }
+
+    protected:
+        Metric(Type type, const char* name, const char* help, const char* labels);
+
+    private:
+        friend class MetricsRegistry;
+
+        const char* name;
+        const char* help;
+        const char* labels;     // Without braces, nullptr if none
+        Type type;
+        Metric* next;
+
+        // Not copyable: the registry links the original
+        Metric(const Metric&);
+        Metric& operator=(const Metric&);
+    };
+
+    class Counter : public Metric {
+    public:
+        typedef uint32_t (*Reader)();
+
+        Counter(const char* name, const char* help, const char* labels = nullptr)
+            : Metric(TYPE_COUNTER, name, help, labels), value(0), reader(nullptr) {}
+
+        /**
+         * Counter mirrored from a module at scrape time
+         */
+        Counter(const char* name, const char* help, const char* labels, Reader reader)
+            : Metric(TYPE_COUNTER, name, help, labels), value(0), reader(reader) {}
+
+        void inc(uint32_t amount = 1) { __atomic_fetch_add(&value, amount, __ATOMIC_RELAXED); }
+        uint32_t get() const { return reader ? reader() : __atomic_load_n(&value, __ATOMIC_RELAXED); }
+
+    private:
+        uint32_t value;
+        Reader reader;
+    };
+
+    class Gauge : public Metric {
+    public:
+        typedef int32_t (*Reader)();
+
+        Gauge(const char* name, const char* help, const char* labels = nullptr)
+            : Metric(TYPE_GAUGE, name, help, labels), value(0), reader(nullptr) {}
+
+        /**
+         * Gauge sampled from a module at scrape time
+         */
+        Gauge(const char* name, const char* help, const char* labels, Reader reader)
+            : Metric(TYPE_GAUGE, name, help, labels), value(0), reader(reader) {}
+
+        void set(int32_t value) { __atomic_store_n(&this->value, value, __ATOMIC_RELAXED); }
+        int32_t get() const { return reader ? reader() : __atomic_load_n(&value, __ATOMIC_RELAXED); }
+
+    private:
+        int32_t value;
+        Reader reader;
+    };
+
+    class Histogram : public Metric {
+    public:
+        /**
+         * @param bounds: Bucket upper bounds, ascending (must outlive the histogram)
+         * @param boundCount: Number of bounds (at most METRICS_MAX_BUCKETS)
+         */
+        Histogram(const char* name, const char* help, const char* labels,
+                  const uint32_t* bounds, uint8_t boundCount);
+
+        /**
+         * Count one observation in its bucket
+         */
+        void observe(uint32_t value);
+
+        uint32_t getCount() const { return __atomic_load_n(&count, __ATOMIC_RELAXED); }
+
+    private:
+        friend class MetricsRegistry;
+
+        const uint32_t* bounds;
+        uint8_t boundCount;
+        uint32_t buckets[METRICS_MAX_BUCKETS + 1];     // Last one: over the largest bound
+        uint32_t count;
+        uint32_t sum;           // Wraps like a Prometheus counter reset
+    };
+
+    /**
+     * Stream every registered metric in Prometheus text format (0.0.4)
+     *
+     * @param out: Destination (ChunkedResponse, Serial, ...)
+     */
+    static void writePrometheus(Print& out);
+
+    /**
+     * @return: Number of registered series
+     */
+    static uint16_t getMetricCount();
+
+private:
+    static Metric* head;
+    static Metric* tail;
+
+    static void add(Metric* metric);
+    static void writeSeriesName(Print& out, const Metric& metric, const char* suffix, const char* le);
+};
+
+#endif // METRICS_REGISTRY_H
@@ -14,7 +14,12 @@
 #include "ntp_sync.h"
 #include "vibration_motor.h"
 #include "rgb_led.h"
+#include "led_status_compositor.h"
 #include "touch_sensor.h"
+#include "runtime_config.h"
+#include "motor_autotune.h"
+#include "cpu_governor.h"
+#include "sampling_profiler.h"
 
 /**
  * Constructor - Initialize all module pointers to nullptr
@@ -28,7 +33,14 @@ ModuleManager::ModuleManager()
       ntpSync(nullptr),
       vibrationMotor(nullptr),
       rgbLed(nullptr),
+      ledStatus(nullptr),
       touchSensor(nullptr),
+      runtimeConfig(nullptr),
+      motorAutotune(nullptr),
+      cpuGovernor(nullptr),
+      samplingProfiler(nullptr),
+      feedLatencyTracker(nullptr),
+      seriesStore(nullptr),
       feedingInProgress(false) {
 }
 
@@ -68,6 +80,34 @@ void ModuleManager::registerRGBLed(RGBLed* led) {
     rgbLed = led;
 }
 
+void ModuleManager::registerLedStatus(LedStatusCompositor* compositor) {
+    ledStatus = compositor;
+}
+
 void ModuleManager::registerTouchSensor(TouchSensor* sensor) {
     touchSensor = sensor;
 }
+
+void ModuleManager::registerRuntimeConfig(RuntimeConfig* config) {
+    runtimeConfig = config;
+}
+
+void ModuleManager::registerMotorAutotune(MotorAutotune* autotune) {
+    motorAutotune = autotune;
+}
+
+void ModuleManager::registerCpuGovernor(CpuGovernor* governor) {
+    cpuGovernor = governor;
+}
+
+void ModuleManager::registerSamplingProfiler(SamplingProfiler* profiler) {
+    samplingProfiler = profiler;
+}
+
+void ModuleManager::registerFeedLatencyTracker(FeedLatencyTracker* tracker) {
+    feedLatencyTracker = tracker;
+}
+
+void ModuleManager::registerSeriesStore(SeriesStore* store) {
+    seriesStore = store;
+}
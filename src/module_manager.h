@@ -29,7 +29,14 @@ class WiFiController;
 class NTPSync;
 class VibrationMotor;
 class RGBLed;
+class LedStatusCompositor;
 class TouchSensor;
+class RuntimeConfig;
+class MotorAutotune;
+class CpuGovernor;
+class SamplingProfiler;
+class FeedLatencyTracker;
+class SeriesStore;
 
 /**
  * ModuleManager - Central registry for all system modules
@@ -96,12 +103,54 @@ public:
      */
     void registerRGBLed(RGBLed* led);
     
+    /**
+     * Register LED status compositor
+     * @param compositor Pointer to LedStatusCompositor instance
+     */
+    void registerLedStatus(LedStatusCompositor* compositor);
+    
     /**
      * Register touch sensor
      * @param sensor Pointer to TouchSensor instance
      */
     void registerTouchSensor(TouchSensor* sensor);
     
+    /**
+     * Register runtime configuration registry
+     * @param config Pointer to RuntimeConfig instance
+     */
+    void registerRuntimeConfig(RuntimeConfig* config);
+    
+    /**
+     * Register motor autotune
+     * @param autotune Pointer to MotorAutotune instance
+     */
+    void registerMotorAutotune(MotorAutotune* autotune);
+    
+    /**
+     * Register CPU frequency governor
+     * @param governor Pointer to CpuGovernor instance
+     */
+    void registerCpuGovernor(CpuGovernor* governor);
+    
+    /**
+     * Register sampling profiler
+     * @param profiler Pointer to SamplingProfiler instance
+     */
+    void registerSamplingProfiler(SamplingProfiler* profiler);
+    
+    /**
+     * Register feed latency tracker
+     * @param tracker Pointer to FeedLatencyTracker instance
+     */
+    void registerFeedLatencyTracker(FeedLatencyTracker* tracker);
+    
+    /**
+     * Register time-series store
+     * @param store Pointer to SeriesStore instance
+     */
+    void registerSeriesStore(SeriesStore* store);
+    
     // ========================================================================
     // MODULE ACCESSOR METHODS
     // ========================================================================
@@ -154,12 +203,54 @@ public:
      */
     RGBLed* getRGBLed() const { return rgbLed; }
     
+    /**
+     * Get LED status compositor (status layers for the RGB LED)
+     * @return Pointer to LedStatusCompositor instance (may be nullptr if not registered)
+     */
+    LedStatusCompositor* getLedStatus() const { return ledStatus; }
+    
     /**
      * Get touch sensor reference
      * @return Pointer to TouchSensor instance (may be nullptr if not registered)
      */
     TouchSensor* getTouchSensor() const { return touchSensor; }
     
+    /**
+     * Get runtime configuration reference
+     * @return Pointer to RuntimeConfig instance (may be nullptr if not registered)
+     */
+    RuntimeConfig* getRuntimeConfig() const { return runtimeConfig; }
+    
+    /**
+     * Get motor autotune reference
+     * @return Pointer to MotorAutotune instance (may be nullptr if not registered)
+     */
+    MotorAutotune* getMotorAutotune() const { return motorAutotune; }
+    
+    /**
+     * Get CPU frequency governor reference
+     * @return Pointer to CpuGovernor instance (may be nullptr if not registered)
+     */
+    CpuGovernor* getCpuGovernor() const { return cpuGovernor; }
+    
+    /**
+     * Get sampling profiler reference
+     * @return Pointer to SamplingProfiler instance (may be nullptr if not registered)
+     */
+    SamplingProfiler* getSamplingProfiler() const { return samplingProfiler; }
+    
+    /**
+     * Get feed latency tracker reference
+     * @return Pointer to FeedLatencyTracker instance (may be nullptr if not registered)
+     */
+    FeedLatencyTracker* getFeedLatencyTracker() const { return feedLatencyTracker; }
+    
+    /**
+     * Get time-series store reference
+     * @return Pointer to SeriesStore instance (may be nullptr if not registered)
+     */
+    SeriesStore* getSeriesStore() const { return seriesStore; }
+    
     // ========================================================================
     // MODULE AVAILABILITY CHECK
     // ========================================================================
@@ -212,12 +303,54 @@ public:
      */
     bool hasRGBLed() const { return rgbLed != nullptr; }
     
+    /**
+     * Check if LED status compositor is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasLedStatus() const { return ledStatus != nullptr; }
+    
     /**
      * Check if touch sensor is registered
      * @return true if module is available, false otherwise
      */
     bool hasTouchSensor() const { return touchSensor != nullptr; }
     
+    /**
+     * Check if runtime configuration is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasRuntimeConfig() const { return runtimeConfig != nullptr; }
+    
+    /**
+     * Check if motor autotune is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasMotorAutotune() const { return motorAutotune != nullptr; }
+    
+    /**
+     * Check if CPU frequency governor is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasCpuGovernor() const { return cpuGovernor != nullptr; }
+    
+    /**
+     * Check if sampling profiler is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasSamplingProfiler() const { return samplingProfiler != nullptr; }
+    
+    /**
+     * Check if feed latency tracker is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasFeedLatencyTracker() const { return feedLatencyTracker != nullptr; }
+    
+    /**
+     * Check if time-series store is registered
+     * @return true if module is available, false otherwise
+     */
+    bool hasSeriesStore() const { return seriesStore != nullptr; }
+    
     // ========================================================================
     // GLOBAL FEEDING STATE (moved from main.cpp)
     // ========================================================================
@@ -244,7 +377,14 @@ private:
     NTPSync* ntpSync;
     VibrationMotor* vibrationMotor;
     RGBLed* rgbLed;
+    LedStatusCompositor* ledStatus;
     TouchSensor* touchSensor;
+    RuntimeConfig* runtimeConfig;
+    MotorAutotune* motorAutotune;
+    CpuGovernor* cpuGovernor;
+    SamplingProfiler* samplingProfiler;
+    FeedLatencyTracker* feedLatencyTracker;
+    SeriesStore* seriesStore;
     
     // Global feeding state
     bool feedingInProgress;
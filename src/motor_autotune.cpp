@@ -0,0 +1,319 @@
+#include "motor_autotune.h"
+#include "index_sensor.h"
+#include "console_manager.h"
+#include "config.h"
+
+/**
+ * Motor Autotune Implementation
+ *
+ * Homing and positioning always run at the start settings, which the
+ * first trial proved safe; only trial moves use the candidate setting.
+ */
+
+/**
+ * Constructor
+ *
+ * @param motor: Feed motor (index sensor attached before start())
+ */
+MotorAutotune::MotorAutotune(StepperMotor& motor)
+    : motor(motor),
+      resultCallback(nullptr),
+      state(STATE_IDLE),
+      originalSpeed(0),
+      originalAcceleration(0),
+      trialRevolutions(0),
+      trialStartEdges(0),
+      trialStartLostSteps(0),
+      resultSpeed(0),
+      resultAcceleration(0) {
+}
+
+/**
+ * Start the search (homes first if needed)
+ *
+ * @return: true if started
+ */
+bool MotorAutotune::start() {
+    if (state != STATE_IDLE) {
+        Console::printlnR(F("ERROR: Autotune already running"));
+        return false;
+    }
+    if (!motor.isReady()) {
+        Console::printlnR(F("ERROR: Motor not initialized"));
+        return false;
+    }
+    if (!motor.hasIndexSensor()) {
+        Console::printlnR(F("ERROR: Autotune needs the index sensor to detect missed steps"));
+        return false;
+    }
+    if (motor.isRunning()) {
+        Console::printlnR(F("ERROR: Motor busy - cannot autotune while moving"));
+        return false;
+    }
+
+    originalSpeed = motor.getMaxSpeed();
+    originalAcceleration = motor.getAcceleration();
+
+    AutotuneSearch::Axis speedAxis = {
+        AUTOTUNE_START_SPEED, AUTOTUNE_MAX_SPEED, AUTOTUNE_SPEED_STEP, AUTOTUNE_MIN_SPEED_STEP };
+    AutotuneSearch::Axis accelAxis = {
+        AUTOTUNE_START_ACCEL, AUTOTUNE_MAX_ACCEL, AUTOTUNE_ACCEL_STEP, AUTOTUNE_MIN_ACCEL_STEP };
+    search.begin(speedAxis, accelAxis, AUTOTUNE_RUNS_PER_SETTING, AUTOTUNE_MARGIN_PERCENT);
+
+    Console::printlnR(F("Motor autotune started - the auger will turn and dispense food"));
+
+    if (motor.isHomed()) {
+        startPositioning();
+    } else {
+        startHoming();
+    }
+    return state != STATE_IDLE;
+}
+
+/**
+ * Stop the motor and restore the settings from before start()
+ */
+void MotorAutotune::cancel() {
+    if (state == STATE_IDLE) {
+        return;
+    }
+    motor.stop();
+    abort(F("canceled"));
+}
+
+/**
+ * Advance the trial sequence; call from the motor task
+ * Each state waits for the motor to stop (homing included)
+ */
+void MotorAutotune::update() {
+    if (state == STATE_IDLE || motor.isRunning()) {
+        return;
+    }
+
+    switch (state) {
+        case STATE_HOMING:
+            if (!motor.isHomed()) {
+                abort(F("homing failed"));
+                return;
+            }
+            startPositioning();
+            break;
+        case STATE_POSITIONING:
+            startTrial();
+            break;
+        case STATE_TRIAL:
+            finishTrial();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @return: true while the search is running
+ */
+bool MotorAutotune::isRunning() const {
+    return state != STATE_IDLE;
+}
+
+/**
+ * Set the callback invoked with the result when the search succeeds
+ */
+void MotorAutotune::setResultCallback(ResultCallback callback) {
+    resultCallback = callback;
+}
+
+/**
+ * Re-reference the auger (at boot, or after a stalled trial)
+ */
+void MotorAutotune::startHoming() {
+    applySettings(AUTOTUNE_START_SPEED, AUTOTUNE_START_ACCEL);
+    if (!motor.startHoming()) {
+        abort(F("homing failed"));
+        return;
+    }
+    state = STATE_HOMING;
+}
+
+/**
+ * Move (forward only) to half a revolution past the index, so whole-
+ * revolution trials cross it mid-move and never end near its edge
+ */
+void MotorAutotune::startPositioning() {
+    applySettings(AUTOTUNE_START_SPEED, AUTOTUNE_START_ACCEL);
+    state = STATE_POSITIONING;
+
+    // Angle from the index measured in the feeding direction
+    long angle = motor.getAbsolutePosition();
+    if (feedDirection() < 0) {
+        angle = (STEPS_PER_REVOLUTION - angle) % STEPS_PER_REVOLUTION;
+    }
+    long distance = (STEPS_PER_REVOLUTION / 2 - angle + STEPS_PER_REVOLUTION) % STEPS_PER_REVOLUTION;
+    if (distance == 0) {
+        startTrial();
+        return;
+    }
+    motor.moveToPositionAsync(motor.getCurrentPosition() + feedDirection() * distance);
+}
+
+/**
+ * Start a trial move at the search's candidate setting
+ * Long enough that the cruise covers at least one revolution
+ */
+void MotorAutotune::startTrial() {
+    float speed = search.getTrialSpeed();
+    float accel = search.getTrialAcceleration();
+
+    // Ramp up + ramp down take speed² / accel steps
+    float rampRevolutions = (speed * speed / accel) / STEPS_PER_REVOLUTION;
+    trialRevolutions = (uint16_t)ceilf(rampRevolutions) + 1;
+    if (trialRevolutions < AUTOTUNE_MIN_TRIAL_REVOLUTIONS) {
+        trialRevolutions = AUTOTUNE_MIN_TRIAL_REVOLUTIONS;
+    }
+
+    Console::printR(F("Autotune trial "));
+    Console::printR(String(search.getTrialCount() + 1));
+    Console::printR(F(": "));
+    Console::printR(String((int)speed));
+    Console::printR(F(" steps/s, "));
+    Console::printR(String((int)accel));
+    Console::printR(F(" steps/s², "));
+    Console::printR(String(trialRevolutions));
+    Console::printlnR(F(" rev"));
+
+    applySettings(speed, accel);
+    trialStartEdges = motor.getIndexSensor()->getEdgeCount();
+    trialStartLostSteps = motor.getLostStepEvents();
+    state = STATE_TRIAL;
+    motor.moveToPositionAsync(motor.getCurrentPosition() +
+                              feedDirection() * (long)trialRevolutions * STEPS_PER_REVOLUTION);
+}
+
+/**
+ * Judge the finished trial and queue the next step
+ * Missed steps show up as fewer index edges than revolutions (a stall)
+ * or as a lost-step event from the per-revolution position check
+ */
+void MotorAutotune::finishTrial() {
+    uint32_t edges = motor.getIndexSensor()->getEdgeCount() - trialStartEdges;
+    bool passed = edges == trialRevolutions && motor.getLostStepEvents() == trialStartLostSteps;
+
+    Console::printR(F("  -> "));
+    if (passed) {
+        Console::printlnR(F("PASS"));
+    } else {
+        Console::printR(F("FAIL ("));
+        Console::printR(String(edges));
+        Console::printR(F("/"));
+        Console::printR(String(trialRevolutions));
+        Console::printlnR(F(" index edges)"));
+    }
+
+    search.report(passed);
+    if (search.isFinished()) {
+        finish();
+    } else if (passed) {
+        startPositioning();
+    } else {
+        startHoming();
+    }
+}
+
+/**
+ * Apply the result, or restore the original settings if even the start
+ * setting failed
+ */
+void MotorAutotune::finish() {
+    if (search.getPhase() == AutotuneSearch::PHASE_FAILED) {
+        abort(F("start setting already misses steps - check wiring and supply"));
+        return;
+    }
+
+    state = STATE_IDLE;
+    resultSpeed = (uint16_t)(search.getResultSpeed() + 0.5f);
+    resultAcceleration = (uint16_t)(search.getResultAcceleration() + 0.5f);
+    applySettings(resultSpeed, resultAcceleration);
+
+    Console::printR(F("✓ Autotune complete after "));
+    Console::printR(String(search.getTrialCount()));
+    Console::printR(F(" trials: "));
+    Console::printR(String(resultSpeed));
+    Console::printR(F(" steps/s, "));
+    Console::printR(String(resultAcceleration));
+    Console::printR(F(" steps/s² ("));
+    Console::printR(String(AUTOTUNE_MARGIN_PERCENT));
+    Console::printlnR(F("% margin)"));
+
+    if (resultCallback) {
+        resultCallback(resultSpeed, resultAcceleration);
+    }
+}
+
+/**
+ * End the search without a result
+ *
+ * @param reason: Shown to the user
+ */
+void MotorAutotune::abort(const __FlashStringHelper* reason) {
+    state = STATE_IDLE;
+    applySettings(originalSpeed, originalAcceleration);
+    Console::printR(F("✗ Autotune stopped: "));
+    Console::printlnR(reason);
+}
+
+/**
+ * Set speed and acceleration for the next move (only changed values,
+ * each setter logs)
+ */
+void MotorAutotune::applySettings(float speed, float accel) {
+    if (motor.getMaxSpeed() != speed) {
+        motor.setMaxSpeed(speed);
+    }
+    if (motor.getAcceleration() != accel) {
+        motor.setAcceleration(accel);
+    }
+}
+
+/**
+ * Feeding direction as a position counter sign
+ */
+int MotorAutotune::feedDirection() const {
+    return motor.getMotorDirection() ? 1 : -1;
+}
+
+/**
+ * Print search progress and the last result
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void MotorAutotune::printStatus(Print& out) const {
+    static const char* const PHASE_NAMES[] = { "idle", "speed", "acceleration", "done", "failed" };
+
+    out.println(F("Motor Autotune Status:"));
+    out.print(F("  Running: "));
+    out.println(isRunning() ? "YES" : "NO");
+    out.print(F("  Phase: "));
+    out.println(PHASE_NAMES[search.getPhase()]);
+    out.print(F("  Trials: "));
+    out.println(search.getTrialCount());
+
+    if (isRunning()) {
+        out.print(F("  Best So Far: "));
+        out.print((int)search.getSafeSpeed());
+        out.print(F(" steps/s, "));
+        out.print((int)search.getSafeAcceleration());
+        out.println(F(" steps/s²"));
+    }
+    if (resultSpeed > 0) {
+        out.print(F("  Last Result: "));
+        out.print(resultSpeed);
+        out.print(F(" steps/s, "));
+        out.print(resultAcceleration);
+        out.println(F(" steps/s²"));
+    }
+    out.print(F("  Current: "));
+    out.print((int)motor.getMaxSpeed());
+    out.print(F(" steps/s, "));
+    out.print((int)motor.getAcceleration());
+    out.println(F(" steps/s²"));
+}
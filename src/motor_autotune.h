@@ -0,0 +1,109 @@
+#ifndef MOTOR_AUTOTUNE_H
+#define MOTOR_AUTOTUNE_H
+
+#include <Arduino.h>
+#include "stepper_motor.h"
+#include "autotune_search.h"
+
+/**
+ * Motor Autotune (MOTOR AUTOTUNE command)
+ *
+ * Runs AutotuneSearch trials on the feed motor without blocking: each
+ * trial starts half a revolution from the index and turns whole
+ * revolutions at the trial speed/acceleration. The index sensor is the
+ * missed-step detector - a trial passes only if it saw one index edge per
+ * revolution and StepperMotor reported no lost steps. After a failed trial
+ * the stalled auger is homed again before the next one.
+ *
+ * Requires an index sensor on the motor. The auger really turns, so food
+ * is dispensed unless the hopper is empty.
+ *
+ * Call update() from the motor task after StepperMotor::run().
+ */
+class MotorAutotune {
+public:
+    /**
+     * Result callback (persist the tuned settings)
+     *
+     * @param maxSpeed: Tuned speed in steps/second
+     * @param acceleration: Tuned acceleration in steps/second²
+     */
+    typedef void (*ResultCallback)(uint16_t maxSpeed, uint16_t acceleration);
+
+    /**
+     * Constructor
+     *
+     * @param motor: Feed motor (index sensor attached before start())
+     */
+    explicit MotorAutotune(StepperMotor& motor);
+
+    /**
+     * Start the search (homes first if needed)
+     *
+     * @return: true if started
+     */
+    bool start();
+
+    /**
+     * Stop the motor and restore the settings from before start()
+     */
+    void cancel();
+
+    /**
+     * Advance the trial sequence; call from the motor task
+     */
+    void update();
+
+    /**
+     * @return: true while the search is running
+     */
+    bool isRunning() const;
+
+    /**
+     * Set the callback invoked with the result when the search succeeds
+     */
+    void setResultCallback(ResultCallback callback);
+
+    /**
+     * Print search progress and the last result
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    enum State : uint8_t {
+        STATE_IDLE,
+        STATE_HOMING,           // Re-referencing the auger to the index
+        STATE_POSITIONING,      // Moving half a revolution away from the index
+        STATE_TRIAL             // Trial move at the candidate setting
+    };
+
+    StepperMotor& motor;
+    AutotuneSearch search;
+    ResultCallback resultCallback;
+    State state;
+
+    float originalSpeed;        // Restored on cancel/failure
+    float originalAcceleration;
+
+    // Running trial
+    uint16_t trialRevolutions;
+    uint32_t trialStartEdges;
+    uint32_t trialStartLostSteps;
+
+    // Last finished search (0 = none)
+    uint16_t resultSpeed;
+    uint16_t resultAcceleration;
+
+    void startHoming();
+    void startPositioning();
+    void startTrial();
+    void finishTrial();
+    void finish();
+    void abort(const __FlashStringHelper* reason);
+    void applySettings(float speed, float accel);
+    int feedDirection() const;
+};
+
+#endif // MOTOR_AUTOTUNE_H
@@ -2,7 +2,22 @@
 #include "module_manager.h"
 #include "rtc_module.h"
 #include "wifi_controller.h"
+#include "runtime_config.h"
 #include "console_manager.h"
+#include "led_status_compositor.h"
+#include "trace_buffer.h"
+#include "metrics_registry.h"
+#include "loop_watchdog.h"
+
+// Sync statistics (/metrics)
+static MetricsRegistry::Counter syncAttempts("feeder_time_sync_attempts_total",
+                                             "Time synchronizations started");
+static MetricsRegistry::Counter ntpSyncs("feeder_time_sync_success_total",
+                                         "Successful time synchronizations", "method=\"ntp\"");
+static MetricsRegistry::Counter httpSyncs("feeder_time_sync_success_total",
+                                          "Successful time synchronizations", "method=\"http\"");
+static MetricsRegistry::Counter failedSyncs("feeder_time_sync_failures_total",
+                                            "Time synchronizations where every server failed");
 
 /**
  * Constructor: Initialize NTP synchronization module
@@ -13,10 +28,9 @@ NTPSync::NTPSync(ModuleManager* moduleManager)
       wifiConnectedTime(0), initialSyncPending(false),
       syncStartTime(0), lastSyncCheck(0), waitingForNTPResponse(false),
       currentServerIndex(0), needsReconfigure(true),
-      syncAttempts(0), successfulSyncs(0), failedSyncs(0),
       httpFallbackInProgress(false), currentHTTPServerIndex(0), httpStartTime(0),
       syncIntervalMs(NTP_SYNC_INTERVAL), previousWiFiSleepState(false),
-      lastSyncTimestampNVRAM(0) {
+      lastSyncTimestampNVRAM(0), lastOffset(0), offsetCount(0) {
 }
 
 /**
@@ -42,7 +56,7 @@ bool NTPSync::begin() {
     if (lastSyncTimestampNVRAM > 0) {
         DateTime lastSyncDT(lastSyncTimestampNVRAM);
         Console::printR(F("Last NTP sync from NVRAM: "));
-        Console::printlnR(formatDateTime(lastSyncDT));
+        Console::printlnR(formatDateTime(lastSyncDT).c_str());
     } else {
         Console::printlnR(F("No previous NTP sync found in NVRAM"));
     }
@@ -65,9 +79,9 @@ bool NTPSync::begin() {
         }
     }
     
-    Console::printR(F("GMT Offset: "));
-    Console::printR(String(GMT_OFFSET_SEC / 3600));
-    Console::printlnR(F(" hours"));
+    Console::printR(F("Time Zone: "));
+    Console::printR(modules->getRTCModule()->getTimezone().getPosix());
+    Console::printlnR(F(" (RTC keeps UTC)"));
     Console::printR(F("Sync Interval: "));
     Console::printR(String(syncIntervalMs / 60000));
     Console::printlnR(F(" minutes"));
@@ -82,8 +96,7 @@ bool NTPSync::begin() {
         Console::printlnR(F("NTP sync not required - RTC is up to date"));
         Console::printR(F("Next sync in approximately "));
         
-        DateTime rtcNow = modules->getRTCModule()->now();
-        unsigned long rtcTimestamp = rtcNow.unixtime();
+        unsigned long rtcTimestamp = modules->getRTCModule()->nowUtc();
         unsigned long timeSinceLastSync = rtcTimestamp - lastSyncTimestampNVRAM;
         
         if (timeSinceLastSync < syncIntervalMs / 1000) {
@@ -110,7 +123,7 @@ void NTPSync::handleNTPSync() {
     if (!modules->getWiFiController()->isWiFiConnected()) {
         // Reset sync state if WiFi disconnected during sync
         if (syncInProgress) {
-            syncInProgress = false;
+            setSyncInProgress(false);
             waitingForNTPResponse = false;
             Console::printlnR(F("NTP sync cancelled - WiFi disconnected"));
         }
@@ -158,7 +171,7 @@ bool NTPSync::forceSyncNow() {
     
     Console::printlnR(F("Starting NTP synchronization (non-blocking)..."));
     lastSyncAttempt = millis();
-    syncAttempts++;
+    syncAttempts.inc();
     
     // Start non-blocking sync
     performNTPSync();
@@ -183,11 +196,35 @@ void NTPSync::onWiFiConnected() {
     }
 }
 
+/**
+ * Update sync state and the LED time sync layer (pushed while syncing)
+ */
+void NTPSync::setSyncInProgress(bool inProgress) {
+    if (inProgress == syncInProgress) {
+        return;
+    }
+    syncInProgress = inProgress;
+    
+    if (inProgress) {
+        TraceBuffer::begin(TraceBuffer::TIME_SYNC);
+    } else {
+        TraceBuffer::end(TraceBuffer::TIME_SYNC);
+    }
+    
+    if (modules && modules->hasLedStatus()) {
+        if (inProgress) {
+            modules->getLedStatus()->push(LedStatusCompositor::LAYER_TIME_SYNC, RGBLed::STATUS_TIME_SYNCING);
+        } else {
+            modules->getLedStatus()->pop(LedStatusCompositor::LAYER_TIME_SYNC);
+        }
+    }
+}
+
 /**
  * Perform actual NTP synchronization - Non-blocking version
  */
 bool NTPSync::performNTPSync() {
-    syncInProgress = true;
+    setSyncInProgress(true);
     waitingForNTPResponse = true;
     syncStartTime = millis();
     lastSyncCheck = 0;
@@ -225,6 +262,7 @@ void NTPSync::configureNTP() {
  * This method is kept for compatibility but should not be used in main loop
  */
 bool NTPSync::waitForNTPSync() {
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_NTP_WAIT);
     Console::printR(F("Waiting for NTP sync"));
     
     unsigned long startTime = millis();
@@ -272,9 +310,9 @@ bool NTPSync::checkNTPSyncProgress() {
                 
                 // Try HTTP time request (synchronous for simplicity)
                 if (tryHTTPTimeFallback()) {
-                    successfulSyncs++;
+                    httpSyncs.inc();
                     lastSuccessfulSync = millis();
-                    syncInProgress = false;
+                    setSyncInProgress(false);
                     waitingForNTPResponse = false;
                     needsReconfigure = true;
                     currentServerIndex = 0; // Reset for next sync
@@ -286,8 +324,7 @@ bool NTPSync::checkNTPSyncProgress() {
                     }
                     
                     // 🚨 SAVE LAST SYNC TIMESTAMP TO NVRAM
-                    DateTime rtcNow = modules->getRTCModule()->now();
-                    saveLastSyncToNVRAM(rtcNow.unixtime());
+                    saveLastSyncToNVRAM(modules->getRTCModule()->nowUtc());
                     
                     printSyncResult(true, String("HTTP time from ") + entry.server);
                     return true; // Sync completed (success via HTTP)
@@ -318,8 +355,8 @@ bool NTPSync::checkNTPSyncProgress() {
             Console::printlnR(F("All time servers failed (NTP and HTTP)"));
             
             currentServerIndex = 0; // Reset for next attempt
-            failedSyncs++;
-            syncInProgress = false;
+            failedSyncs.inc();
+            setSyncInProgress(false);
             waitingForNTPResponse = false;
             needsReconfigure = true;
             
@@ -360,9 +397,9 @@ bool NTPSync::checkNTPSyncProgress() {
     
     if (getLocalTime(&timeinfo)) {
         // Success! NTP sync completed
-        successfulSyncs++;
+        ntpSyncs.inc();
         lastSuccessfulSync = millis();
-        syncInProgress = false;
+        setSyncInProgress(false);
         waitingForNTPResponse = false;
         currentServerIndex = 0; // Reset to primary server for next sync
         
@@ -374,8 +411,8 @@ bool NTPSync::checkNTPSyncProgress() {
         
         Console::printlnR(F(" ✓"));
         
-        // Show received time
-        Console::printR(F("Received NTP time: "));
+        // Show received time (libc has no TZ set, so this is UTC)
+        Console::printR(F("Received NTP time (UTC): "));
         Console::printR(String(timeinfo.tm_mday));
         Console::printR(F("/"));
         Console::printR(String(timeinfo.tm_mon + 1));
@@ -394,8 +431,7 @@ bool NTPSync::checkNTPSyncProgress() {
         updateRTCFromNTP();
         
         // 🚨 SAVE LAST SYNC TIMESTAMP TO NVRAM
-        DateTime rtcNow = modules->getRTCModule()->now();
-        saveLastSyncToNVRAM(rtcNow.unixtime());
+        saveLastSyncToNVRAM(modules->getRTCModule()->nowUtc());
         
         printSyncResult(true, successMsg);
         return true; // Sync completed (success)
@@ -409,7 +445,7 @@ bool NTPSync::checkNTPSyncProgress() {
 }
 
 /**
- * Update RTC module with time from NTP
+ * Update RTC module with time from NTP (both in UTC)
  */
 void NTPSync::updateRTCFromNTP() {
     struct tm timeinfo;
@@ -418,27 +454,25 @@ void NTPSync::updateRTCFromNTP() {
         return;
     }
     
-    // Convert tm struct to DateTime
-    DateTime ntpTime(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-                     timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    uint32_t ntpUtc = (uint32_t)time(nullptr);
+    uint32_t rtcUtc = modules->getRTCModule()->nowUtc();
     
-    // Get current RTC time for comparison
-    DateTime rtcTime = modules->getRTCModule()->now();
-    
-    Console::printR(F("NTP Time: "));
-    Console::printlnR(formatDateTime(ntpTime));
-    Console::printR(F("RTC Time: "));
-    Console::printlnR(formatDateTime(rtcTime));
+    Console::printR(F("NTP Time (UTC): "));
+    Console::printlnR(formatDateTime(DateTime(ntpUtc)).c_str());
+    Console::printR(F("RTC Time (UTC): "));
+    Console::printlnR(formatDateTime(DateTime(rtcUtc)).c_str());
     
     // Calculate time difference
-    int32_t timeDiff = ntpTime.unixtime() - rtcTime.unixtime();
+    int32_t timeDiff = (int32_t)(ntpUtc - rtcUtc);
+    lastOffset = timeDiff;
+    offsetCount++;
     Console::printR(F("Time difference: "));
     Console::printR(String(timeDiff));
     Console::printlnR(F(" seconds"));
     
     // Update RTC if difference is significant (more than 2 seconds)
     if (abs(timeDiff) > 2) {
-        modules->getRTCModule()->adjust(ntpTime);
+        modules->getRTCModule()->adjustUtc(ntpUtc);
         Console::printlnR(F("RTC updated with NTP time"));
     } else {
         Console::printlnR(F("RTC time is already accurate (no update needed)"));
@@ -461,12 +495,12 @@ void NTPSync::printSyncResult(bool success, const String& details) {
 /**
  * Format DateTime for display
  */
-String NTPSync::formatDateTime(const DateTime& dt) {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d %02d:%02d:%02d",
-             dt.day(), dt.month(), dt.year(),
-             dt.hour(), dt.minute(), dt.second());
-    return String(buffer);
+FixedString<20> NTPSync::formatDateTime(const DateTime& dt) {
+    FixedString<20> text;
+    text.appendFormat("%02d/%02d/%04d %02d:%02d:%02d",
+                      dt.day(), dt.month(), dt.year(),
+                      dt.hour(), dt.minute(), dt.second());
+    return text;
 }
 
 /**
@@ -534,11 +568,10 @@ void NTPSync::showSyncStatus() {
     if (lastSyncTimestampNVRAM > 0) {
         DateTime lastSyncDT(lastSyncTimestampNVRAM);
         Console::printR(F("Last Sync (NVRAM): "));
-        Console::printlnR(formatDateTime(lastSyncDT));
+        Console::printlnR(formatDateTime(lastSyncDT).c_str());
         
         // Calculate time since last sync
-        DateTime rtcNow = modules->getRTCModule()->now();
-        unsigned long rtcTimestamp = rtcNow.unixtime();
+        unsigned long rtcTimestamp = modules->getRTCModule()->nowUtc();
         
         if (rtcTimestamp >= lastSyncTimestampNVRAM) {
             unsigned long timeSince = rtcTimestamp - lastSyncTimestampNVRAM;
@@ -571,8 +604,7 @@ void NTPSync::showSyncStatus() {
     
     Console::printR(F("Next Sync: "));
     if (lastSyncTimestampNVRAM > 0) {
-        DateTime rtcNow = modules->getRTCModule()->now();
-        unsigned long rtcTimestamp = rtcNow.unixtime();
+        unsigned long rtcTimestamp = modules->getRTCModule()->nowUtc();
         unsigned long timeSinceLastSync = rtcTimestamp - lastSyncTimestampNVRAM;
         unsigned long syncIntervalSec = syncIntervalMs / 1000;
         
@@ -609,15 +641,20 @@ void NTPSync::showSyncStatus() {
 void NTPSync::showSyncStatistics() {
     Console::printlnR(F(""));
     Console::printlnR(F("=== NTP SYNC STATISTICS ==="));
+    uint32_t attempts = syncAttempts.get();
+    uint32_t successful = ntpSyncs.get() + httpSyncs.get();
     Console::printR(F("Total Attempts: "));
-    Console::printlnR(String(syncAttempts));
+    Console::printlnR(String(attempts));
     Console::printR(F("Successful Syncs: "));
-    Console::printlnR(String(successfulSyncs));
+    Console::printR(String(successful));
+    Console::printR(F(" (HTTP fallback: "));
+    Console::printR(String(httpSyncs.get()));
+    Console::printlnR(F(")"));
     Console::printR(F("Failed Syncs: "));
-    Console::printlnR(String(failedSyncs));
+    Console::printlnR(String(failedSyncs.get()));
     
-    if (syncAttempts > 0) {
-        float successRate = (float)successfulSyncs / syncAttempts * 100.0;
+    if (attempts > 0) {
+        float successRate = (float)successful / attempts * 100.0;
         Console::printR(F("Success Rate: "));
         Console::printR(String(successRate, 1));
         Console::printlnR(F("%"));
@@ -637,16 +674,14 @@ void NTPSync::setSyncInterval(unsigned long intervalMs) {
 }
 
 /**
- * Set custom timezone
+ * Set the local time zone (POSIX TZ string, persisted by the RTC module)
+ * NTP itself always runs in UTC, so no reconfiguration is needed
+ *
+ * @param posix: e.g. "EST5EDT,M3.2.0,M11.1.0"
+ * @return: false if the string is invalid
  */
-void NTPSync::setTimezone(long gmtOffsetSec, int daylightOffsetSec) {
-    Console::printR(F("Timezone updated: GMT"));
-    Console::printR(gmtOffsetSec >= 0 ? F("+") : F(""));
-    Console::printR(String(gmtOffsetSec / 3600));
-    Console::printlnR(F(" hours"));
-    
-    // Reconfigure NTP with new timezone using current server
-    configTime(gmtOffsetSec, daylightOffsetSec, getCurrentNTPServer());
+bool NTPSync::setTimezone(const char* posix) {
+    return modules && modules->hasRTCModule() && modules->getRTCModule()->setTimezone(posix);
 }
 
 /**
@@ -682,11 +717,6 @@ void NTPSync::configureNTPWithServer(int serverIndex) {
     
     Console::printR(F("Configuring NTP with server: "));
     Console::printlnR(entry.server);
-    Console::printR(F("GMT Offset: "));
-    Console::printR(String(GMT_OFFSET_SEC));
-    Console::printR(F(" seconds ("));
-    Console::printR(String(GMT_OFFSET_SEC / 3600));
-    Console::printlnR(F(" hours)"));
     
     // Test DNS resolution first
     IPAddress serverIP;
@@ -700,8 +730,8 @@ void NTPSync::configureNTPWithServer(int serverIndex) {
         Console::printlnR(entry.server);
     }
     
-    // Configure NTP with timezone settings and specific server
-    configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, entry.server);
+    // Configure NTP in UTC (the RTC keeps UTC, local time comes from the time zone)
+    configTime(0, 0, entry.server);
     
     Console::printlnR(F("✓ NTP configuration completed"));
     
@@ -735,11 +765,34 @@ bool NTPSync::processNTPCommand(const String& command) {
         }
         return true;
     }
+    else if (command == "NTP TZ") {
+        if (modules && modules->hasRTCModule()) {
+            modules->getRTCModule()->getTimezone().printInfo(Serial);
+            modules->getRTCModule()->printDateTime();
+        }
+        return true;
+    }
+    else if (command.startsWith("NTP TZ ")) {
+        String posix = command.substring(7);
+        posix.trim();
+        if (!setTimezone(posix.c_str())) {
+            Console::printlnR(F("ERROR: Invalid POSIX TZ string"));
+            Console::printlnR(F("Examples: <-03>3, EST5EDT,M3.2.0,M11.1.0, CET-1CEST,M3.5.0,M10.5.0/3"));
+        }
+        return true;
+    }
     else if (command.startsWith("NTP INTERVAL ")) {
         String intervalStr = command.substring(13);
         int minutes = intervalStr.toInt();
         if (minutes > 0) {
-            setSyncInterval(minutes * 60000);
+            // Persisted through the registry, which applies it via setSyncInterval()
+            if (modules && modules->hasRuntimeConfig()) {
+                if (!modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_NTP_INTERVAL, minutes)) {
+                    Console::printlnR(F("ERROR: Interval must be 1-10080 minutes"));
+                }
+            } else {
+                setSyncInterval(minutes * 60000);
+            }
             return true;
         } else {
             Console::printlnR(F("Usage: NTP INTERVAL [minutes]"));
@@ -777,6 +830,9 @@ bool NTPSync::tryHTTPTimeFallback() {
     // Determine which HTTP time API based on server URL
     String serverStr = String(entry.server);
     
+    // Blocks the loop until the HTTP request completes or times out
+    TraceBuffer::begin(TraceBuffer::TIME_HTTP_FALLBACK, entry.server);
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_HTTP_TIME);
     if (serverStr.indexOf("worldtimeapi.org") >= 0) {
         success = getTimeFromWorldTimeAPI();
     } else if (serverStr.indexOf("timeapi.io") >= 0) {
@@ -784,9 +840,11 @@ bool NTPSync::tryHTTPTimeFallback() {
     } else if (serverStr.indexOf("worldclockapi.com") >= 0) {
         success = getTimeFromWorldClockAPI(); // Separate handler for UTC API
     } else {
+        TraceBuffer::end(TraceBuffer::TIME_HTTP_FALLBACK);
         Console::printlnR(F("Unknown HTTP time API format"));
         return false;
     }
+    TraceBuffer::end(TraceBuffer::TIME_HTTP_FALLBACK, success);
     
     if (success) {
         Console::printR(F("✓ HTTP time sync successful with "));
@@ -803,9 +861,7 @@ bool NTPSync::tryHTTPTimeFallback() {
  * Get time from WorldTimeAPI (worldtimeapi.org)
  * Free API that provides JSON time data
  * 
- * 🚨 CRITICAL CORRECTION: WorldTimeAPI "unixtime" field is ALWAYS UTC!
- * The "datetime" field has local time, but "unixtime" is UTC timestamp.
- * We must parse the "datetime" field with timezone offset instead.
+ * Requests the Etc/UTC zone, so the "datetime" field is UTC (the RTC keeps UTC)
  */
 bool NTPSync::getTimeFromWorldTimeAPI() {
     WiFiClient client;
@@ -822,8 +878,8 @@ bool NTPSync::getTimeFromWorldTimeAPI() {
         return false;
     }
     
-    // Make HTTP request for Brazil timezone
-    String url = "/api/timezone/America/Sao_Paulo";
+    // Make HTTP request for UTC
+    String url = "/api/timezone/Etc/UTC";
     client.print(String("GET ") + url + " HTTP/1.1\r\n" +
                  "Host: " + host + "\r\n" +
                  "Connection: close\r\n\r\n");
@@ -882,12 +938,12 @@ bool NTPSync::getTimeFromWorldTimeAPI() {
                 Console::printR(F(":"));
                 Console::printlnR(String(second));
                 
-                // Create DateTime (already local time with timezone applied by API)
+                // Create DateTime (UTC)
                 DateTime dt(year, month, day, hour, minute, second);
                 
                 // Update RTC
-                modules->getRTCModule()->adjust(dt);
-                Console::printlnR(F("✓ RTC updated from WorldTimeAPI (local time)"));
+                modules->getRTCModule()->adjustUtc(dt.unixtime());
+                Console::printlnR(F("✓ RTC updated from WorldTimeAPI (UTC)"));
                 return true;
             }
         }
@@ -901,7 +957,7 @@ bool NTPSync::getTimeFromWorldTimeAPI() {
  * Get time from TimeAPI.io
  * Alternative free time API
  * 
- * 🚨 TimeAPI returns datetime in requested timezone format
+ * 🚨 TimeAPI returns datetime in the requested timezone (UTC)
  */
 bool NTPSync::getTimeFromTimeAPI() {
     WiFiClient client;
@@ -918,8 +974,8 @@ bool NTPSync::getTimeFromTimeAPI() {
         return false;
     }
     
-    // Make HTTP request for Brazil timezone
-    String url = "/api/Time/current/zone?timeZone=America/Sao_Paulo";
+    // Make HTTP request for UTC
+    String url = "/api/Time/current/zone?timeZone=UTC";
     client.print(String("GET ") + url + " HTTP/1.1\r\n" +
                  "Host: " + host + "\r\n" +
                  "Connection: close\r\n\r\n");
@@ -947,9 +1003,9 @@ bool NTPSync::getTimeFromTimeAPI() {
     // Parse datetime field (should have timezone already applied)
     DateTime parsedTime;
     if (parseTimeAPIResponse(response, parsedTime)) {
-        // Update RTC with parsed local time
-        modules->getRTCModule()->adjust(parsedTime);
-        Console::printlnR(F("✓ RTC updated from TimeAPI (local time)"));
+        // Update RTC with parsed UTC time
+        modules->getRTCModule()->adjustUtc(parsedTime.unixtime());
+        Console::printlnR(F("✓ RTC updated from TimeAPI (UTC)"));
         return true;
     }
     
@@ -1007,7 +1063,7 @@ bool NTPSync::parseTimeAPIResponse(const String& response, DateTime& dateTime) {
             Console::printR(F(":"));
             Console::printlnR(String(second));
             
-            // TimeAPI with timezone parameter returns local time
+            // TimeAPI with timezone parameter returns time in that zone (UTC)
             dateTime = DateTime(year, month, day, hour, minute, second);
             return true;
         }
@@ -1018,7 +1074,7 @@ bool NTPSync::parseTimeAPIResponse(const String& response, DateTime& dateTime) {
 
 /**
  * Get time from WorldClockAPI (worldclockapi.com)
- * This API returns UTC time, so we must apply GMT offset
+ * This API returns UTC time, stored in the RTC as is
  */
 bool NTPSync::getTimeFromWorldClockAPI() {
     WiFiClient client;
@@ -1097,17 +1153,9 @@ bool NTPSync::getTimeFromWorldClockAPI() {
                 // Create DateTime with UTC time
                 DateTime utcTime(year, month, day, hour, minute, second);
                 
-                // Convert UTC to local time by applying GMT offset
-                unsigned long utcTimestamp = utcTime.unixtime();
-                unsigned long localTimestamp = utcTimestamp + GMT_OFFSET_SEC;
-                DateTime localTime(localTimestamp);
-                
-                Console::printR(F("Converted to local: "));
-                Console::printlnR(formatDateTime(localTime));
-                
-                // Update RTC with local time
-                modules->getRTCModule()->adjust(localTime);
-                Console::printlnR(F("✓ RTC updated from WorldClockAPI (UTC + offset)"));
+                // Update RTC with UTC time
+                modules->getRTCModule()->adjustUtc(utcTime.unixtime());
+                Console::printlnR(F("✓ RTC updated from WorldClockAPI (UTC)"));
                 return true;
             }
         }
@@ -1120,45 +1168,21 @@ bool NTPSync::getTimeFromWorldClockAPI() {
 /**
  * Set time from Unix timestamp
  * 
- * @param timestamp: Unix timestamp (seconds since 1970-01-01)
- * @param applyOffset: true = timestamp is UTC, apply GMT offset
- *                     false = timestamp is already local time
+ * @param timestamp: Unix timestamp (UTC seconds since 1970-01-01)
  */
-bool NTPSync::setTimeFromUnixTimestamp(unsigned long timestamp, bool applyOffset) {
+bool NTPSync::setTimeFromUnixTimestamp(unsigned long timestamp) {
     if (timestamp < 1000000000) { // Sanity check (must be after 2001)
         Console::printlnR(F("Invalid timestamp"));
         return false;
     }
     
-    unsigned long localTimestamp;
+    Console::printR(F("UTC timestamp: "));
+    Console::printlnR(String(timestamp));
+    Console::printR(F("Converted to (UTC): "));
+    Console::printlnR(formatDateTime(DateTime(timestamp)).c_str());
     
-    if (applyOffset) {
-        // Timestamp is UTC - apply GMT offset to convert to local time
-        // GMT_OFFSET_SEC is negative for Brazil (UTC-3 = -10800 seconds)
-        localTimestamp = timestamp + GMT_OFFSET_SEC;
-        
-        Console::printR(F("UTC timestamp: "));
-        Console::printlnR(String(timestamp));
-        Console::printR(F("Applying offset (UTC"));
-        Console::printR(String(GMT_OFFSET_SEC / 3600));
-        Console::printR(F("): "));
-        Console::printlnR(String(localTimestamp));
-    } else {
-        // Timestamp is already local time - use directly
-        localTimestamp = timestamp;
-        
-        Console::printR(F("Local timestamp (already with offset): "));
-        Console::printlnR(String(localTimestamp));
-    }
-    
-    // Convert to DateTime
-    DateTime dt(localTimestamp);
-    
-    Console::printR(F("Converted to: "));
-    Console::printlnR(formatDateTime(dt));
-    
-    // Update RTC
-    modules->getRTCModule()->adjust(dt);
+    // Update RTC (keeps UTC)
+    modules->getRTCModule()->adjustUtc(timestamp);
     Console::printlnR(F("✓ RTC updated from HTTP timestamp"));
     return true;
 }
@@ -1167,11 +1191,15 @@ bool NTPSync::setTimeFromUnixTimestamp(unsigned long timestamp, bool applyOffset
  * Save last sync timestamp to NVRAM
  */
 void NTPSync::saveLastSyncToNVRAM(unsigned long timestamp) {
-    if (preferences.putULong(NTP_LAST_SYNC_NVRAM_KEY, timestamp)) {
+    TraceBuffer::begin(TraceBuffer::NVS_COMMIT, "ntp.lastSync");
+    bool saved = preferences.putULong(NTP_LAST_SYNC_NVRAM_KEY, timestamp);
+    TraceBuffer::end(TraceBuffer::NVS_COMMIT);
+    
+    if (saved) {
         lastSyncTimestampNVRAM = timestamp;
         DateTime dt(timestamp);
         Console::printR(F("✓ Last sync saved to NVRAM: "));
-        Console::printlnR(formatDateTime(dt));
+        Console::printlnR(formatDateTime(dt).c_str());
     } else {
         Console::printlnR(F("⚠ Failed to save last sync to NVRAM"));
     }
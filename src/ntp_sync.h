@@ -7,6 +7,7 @@
 #include <RTClib.h>
 #include <Preferences.h>
 #include "config.h"
+#include "string_builder.h"
 
 // Forward declarations
 class ModuleManager;
@@ -23,8 +24,9 @@ class WiFiController;
  * Features:
  * - Automatic sync every 30 minutes when WiFi is connected
  * - Initial sync shortly after WiFi connection established
- * - Timezone support (configurable GMT offset)
- * - Daylight saving time support
+ * - NTP and HTTP sources run in UTC; the RTC keeps UTC
+ * - Local time zone as a POSIX TZ string with DST rules (NTP TZ command,
+ *   /api/timezone), converted by the RTC module's TimeZone
  * - Error handling and retry logic
  * - Status reporting and diagnostics
  * 
@@ -47,6 +49,8 @@ private:
     unsigned long syncIntervalMs; // Dynamic sync interval
     bool previousWiFiSleepState; // Store previous WiFi sleep state (true = enabled)
     unsigned long lastSyncTimestampNVRAM; // Last sync timestamp saved in NVRAM
+    int32_t lastOffset;          // NTP - RTC seconds at the last NTP sync
+    uint32_t offsetCount;        // NTP syncs that measured an offset
     
     // Non-blocking sync state
     unsigned long syncStartTime;
@@ -55,17 +59,13 @@ private:
     int currentServerIndex;
     bool needsReconfigure;
     
-    // Sync statistics
-    int syncAttempts;
-    int successfulSyncs;
-    int failedSyncs;
-    
     // HTTP fallback state
     bool httpFallbackInProgress;
     int currentHTTPServerIndex;
     unsigned long httpStartTime;
     
     // Internal helper methods
+    void setSyncInProgress(bool inProgress); // Also drives the LED time sync layer
     bool performNTPSync();
     void configureNTP();
     void configureNTPWithServer(int serverIndex);
@@ -73,7 +73,7 @@ private:
     bool checkNTPSyncProgress(); // New non-blocking method
     void updateRTCFromNTP();
     void printSyncResult(bool success, const String& details = "");
-    String formatDateTime(const DateTime& dt);
+    FixedString<20> formatDateTime(const DateTime& dt);
     const char* getCurrentNTPServer();
     
     // NVRAM helper methods
@@ -92,7 +92,7 @@ private:
     bool getTimeFromWorldClockAPI();
     bool parseHTTPTimeResponse(const String& response, DateTime& dateTime);
     bool parseTimeAPIResponse(const String& response, DateTime& dateTime);
-    bool setTimeFromUnixTimestamp(unsigned long timestamp, bool applyOffset = true);
+    bool setTimeFromUnixTimestamp(unsigned long timestamp);
     
 public:
     // Constructor
@@ -111,12 +111,14 @@ public:
     bool isSyncInProgress();
     unsigned long getLastSyncTime();
     unsigned long getTimeSinceLastSync();
+    int32_t getLastOffset() const { return lastOffset; }
+    uint32_t getOffsetCount() const { return offsetCount; }
     void showSyncStatus();
     void showSyncStatistics();
     
     // Configuration
     void setSyncInterval(unsigned long intervalMs);
-    void setTimezone(long gmtOffsetSec, int daylightOffsetSec);
+    bool setTimezone(const char* posix);
     
     // Command processing
     bool processNTPCommand(const String& command);
@@ -0,0 +1,183 @@
+#include "request_arena.h"
+#include "console_manager.h"
+#include <new>
+#include <stdlib.h>
+
+// Allocation alignment (covers pointers, 64-bit integers and doubles)
+static const size_t ARENA_ALIGNMENT = 8;
+
+static inline size_t alignUp(size_t value) {
+    return (value + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+// Returned by createBuilder() when neither arena nor heap has room
+static char emptyBuilderStorage[1];
+static StringBuilder emptyBuilder(emptyBuilderStorage, sizeof(emptyBuilderStorage));
+
+/**
+ * Constructor
+ */
+RequestArena::RequestArena()
+    : buffer(nullptr),
+      size(0),
+      offset(0),
+      requestBytes(0),
+      highWaterMark(0),
+      peakRequestBytes(0),
+      fallbackHead(nullptr),
+      fallbackCount(0),
+      fallbackBytes(0),
+      requestCount(0) {
+}
+
+/**
+ * Destructor
+ */
+RequestArena::~RequestArena() {
+    reset();
+    free(buffer);
+}
+
+/**
+ * Allocate the arena buffer
+ * Done once at startup so the block sits low in the heap and never moves
+ *
+ * @param size: Arena size in bytes
+ * @return: true if allocated
+ */
+bool RequestArena::begin(size_t size) {
+    if (buffer) {
+        return true;
+    }
+
+    buffer = (uint8_t*)malloc(alignUp(size));
+    if (!buffer) {
+        this->size = 0;
+        Console::printlnR(F("RequestArena: ERROR - Buffer allocation failed, using heap for all requests"));
+        return false;
+    }
+
+    this->size = alignUp(size);
+    offset = 0;
+    return true;
+}
+
+// ============================================================================
+// ALLOCATION
+// ============================================================================
+
+void* RequestArena::allocate(size_t size) {
+    size_t alignedSize = alignUp(size > 0 ? size : 1);
+
+    if (buffer && alignedSize <= this->size - offset) {
+        void* block = buffer + offset;
+        offset += alignedSize;
+        requestBytes += alignedSize;
+        if (offset > highWaterMark) {
+            highWaterMark = offset;
+        }
+        if (requestBytes > peakRequestBytes) {
+            peakRequestBytes = requestBytes;
+        }
+        return block;
+    }
+
+    return allocateFallback(alignedSize);
+}
+
+/**
+ * Serve an allocation from the heap and chain it for release in reset()
+ */
+void* RequestArena::allocateFallback(size_t size) {
+    // Room to move the payload up to the arena alignment
+    FallbackBlock* block = (FallbackBlock*)malloc(sizeof(FallbackBlock) + ARENA_ALIGNMENT - 1 + size);
+    if (!block) {
+        return nullptr;
+    }
+
+    block->next = fallbackHead;
+    fallbackHead = block;
+    fallbackCount++;
+    fallbackBytes += size;
+    requestBytes += size;
+    if (requestBytes > peakRequestBytes) {
+        peakRequestBytes = requestBytes;
+    }
+    return (void*)alignUp((size_t)(block + 1));
+}
+
+char* RequestArena::allocateText(size_t capacity) {
+    char* text = (char*)allocate(capacity + 1);
+    if (text) {
+        text[0] = '\0';
+    }
+    return text;
+}
+
+const char* RequestArena::copy(const char* text) {
+    if (!text) {
+        return "";
+    }
+    size_t length = strlen(text);
+    char* result = (char*)allocate(length + 1);
+    if (!result) {
+        return "";
+    }
+    memcpy(result, text, length + 1);
+    return result;
+}
+
+StringBuilder& RequestArena::createBuilder(size_t capacity) {
+    void* object = allocate(sizeof(StringBuilder));
+    char* text = object ? allocateText(capacity) : nullptr;
+    if (!object || !text) {
+        emptyBuilder.clear();
+        return emptyBuilder;
+    }
+    // StringBuilder owns no resources, so the arena never runs its destructor
+    return *new (object) StringBuilder(text, capacity + 1);
+}
+
+// ============================================================================
+// RESET
+// ============================================================================
+
+void RequestArena::reset() {
+    while (fallbackHead) {
+        FallbackBlock* next = fallbackHead->next;
+        free(fallbackHead);
+        fallbackHead = next;
+    }
+    offset = 0;
+    requestBytes = 0;
+    requestCount++;
+}
+
+// ============================================================================
+// TELEMETRY
+// ============================================================================
+
+void RequestArena::printStats() const {
+    FixedString<64> line;
+
+    Console::printlnR(F("=== HTTP REQUEST ARENA ==="));
+    line.appendFormat("Size: %u bytes", (unsigned)size);
+    Console::printlnR(line.c_str());
+
+    line.clear();
+    line.appendFormat("High-water mark: %u bytes", (unsigned)highWaterMark);
+    Console::printlnR(line.c_str());
+
+    line.clear();
+    line.appendFormat("Peak request demand: %u bytes", (unsigned)peakRequestBytes);
+    Console::printlnR(line.c_str());
+
+    line.clear();
+    line.appendFormat("Heap fallbacks: %lu (%lu bytes)",
+                      (unsigned long)fallbackCount, (unsigned long)fallbackBytes);
+    Console::printlnR(line.c_str());
+
+    line.clear();
+    line.appendFormat("Requests served: %lu", (unsigned long)requestCount);
+    Console::printlnR(line.c_str());
+}
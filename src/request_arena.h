@@ -0,0 +1,134 @@
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <Arduino.h>
+#include "string_builder.h"
+
+/**
+ * RequestArena Class
+ *
+ * Bump-pointer allocator for memory that lives exactly as long as one HTTP
+ * request (JSON bodies, copied arguments, response chunks). The buffer is
+ * allocated once at startup and rewound by reset() when the request ends,
+ * so handlers no longer create and free many small heap blocks in random
+ * order.
+ *
+ * Features:
+ * - O(1) allocation, no per-block free
+ * - Requests that do not fit fall back to the heap; those blocks are
+ *   chained and released by reset(), and counted for telemetry
+ * - High-water mark and peak per-request demand (arena + fallback) to
+ *   tune WEB_REQUEST_ARENA_SIZE in config.h
+ *
+ * Not thread-safe: use from the web server task only.
+ */
+class RequestArena {
+public:
+    /**
+     * RAII guard that resets the arena when a request handler returns
+     */
+    class Scope {
+    public:
+        explicit Scope(RequestArena& arena) : arena(arena) {}
+        ~Scope() { arena.reset(); }
+    private:
+        RequestArena& arena;
+    };
+
+    /**
+     * Constructor - call begin() to allocate the buffer
+     */
+    RequestArena();
+
+    /**
+     * Destructor - releases the buffer and any fallback blocks
+     */
+    ~RequestArena();
+
+    /**
+     * Allocate the arena buffer (once)
+     *
+     * @param size: Arena size in bytes
+     * @return: true if allocated; on failure every allocation uses the heap
+     */
+    bool begin(size_t size);
+
+    /**
+     * Allocate memory valid until the next reset()
+     *
+     * @param size: Number of bytes
+     * @return: Pointer (8-byte aligned), or nullptr if the heap is exhausted
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Allocate an empty NUL-terminated text buffer
+     *
+     * @param capacity: Maximum text length (excluding the terminator)
+     * @return: Buffer of capacity + 1 bytes, or nullptr
+     */
+    char* allocateText(size_t capacity);
+
+    /**
+     * Copy text into the arena
+     *
+     * @param text: Text to copy (nullptr is treated as "")
+     * @return: Arena copy (never nullptr; "" if out of memory)
+     */
+    const char* copy(const char* text);
+
+    /**
+     * Create a StringBuilder with arena storage
+     * If no memory is available the returned builder has no capacity and
+     * reports overflowed() on the first append
+     *
+     * @param capacity: Maximum text length
+     * @return: Builder valid until the next reset()
+     */
+    StringBuilder& createBuilder(size_t capacity);
+
+    /**
+     * Release everything allocated since the last reset
+     */
+    void reset();
+
+    // Telemetry
+    size_t getSize() const { return size; }
+    size_t getUsed() const { return offset; }
+    size_t getHighWaterMark() const { return highWaterMark; }
+    size_t getPeakRequestBytes() const { return peakRequestBytes; }
+    uint32_t getFallbackCount() const { return fallbackCount; }
+    uint32_t getFallbackBytes() const { return fallbackBytes; }
+    uint32_t getRequestCount() const { return requestCount; }
+
+    /**
+     * Print arena statistics
+     */
+    void printStats() const;
+
+private:
+    // Header at the start of heap fallback blocks; the payload follows at
+    // the next 8-byte boundary (malloc() only guarantees 4 on the ESP32)
+    struct FallbackBlock {
+        FallbackBlock* next;
+    };
+
+    uint8_t* buffer;
+    size_t size;
+    size_t offset;
+    size_t requestBytes;          // Arena + fallback bytes for the current request
+    size_t highWaterMark;         // Highest arena offset reached
+    size_t peakRequestBytes;      // Highest requestBytes reached
+    FallbackBlock* fallbackHead;
+    uint32_t fallbackCount;       // Allocations served by the heap since boot
+    uint32_t fallbackBytes;       // Bytes served by the heap since boot
+    uint32_t requestCount;        // Completed resets (requests)
+
+    void* allocateFallback(size_t size);
+
+    // Not copyable (owns the buffer)
+    RequestArena(const RequestArena&);
+    RequestArena& operator=(const RequestArena&);
+};
+
+#endif // REQUEST_ARENA_H
@@ -1,20 +1,137 @@
 #include "rgb_led.h"
+#include <driver/ledc.h>
 
 // Static PWM channel counter to avoid conflicts
 static uint8_t nextPWMChannel = 0;
 
-// Predefined color constants
+// Predefined color constants (perceptual values, gamma applied on output)
 const RGBLed::Color RGBLed::RED = {255, 0, 0};
 const RGBLed::Color RGBLed::GREEN = {0, 255, 0};
 const RGBLed::Color RGBLed::BLUE = {0, 0, 255};
-const RGBLed::Color RGBLed::YELLOW = {255, 80, 0};
+const RGBLed::Color RGBLed::YELLOW = {255, 151, 0};
 const RGBLed::Color RGBLed::CYAN = {0, 255, 255};
 const RGBLed::Color RGBLed::MAGENTA = {255, 0, 255};
 const RGBLed::Color RGBLed::WHITE = {255, 255, 255};
-const RGBLed::Color RGBLed::ORANGE = {255, 20, 0};
-const RGBLed::Color RGBLed::PURPLE = {128, 0, 128};
+const RGBLed::Color RGBLed::ORANGE = {255, 80, 0};
+const RGBLed::Color RGBLed::PURPLE = {186, 0, 186};
 const RGBLed::Color RGBLed::OFF = {0, 0, 0};
 
+// ============================================================================
+// LOOKUP TABLES (flash)
+// ============================================================================
+
+// Gamma 2.2: perceptual level 0-255 -> PWM duty 0-255
+static const uint8_t GAMMA_22[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+// Progress (0-255) reached at the end of each of the EASE_STEPS sub-steps,
+// indexed by easing - EASE_LINEAR
+static const uint8_t EASE_CURVES[4][4] = {
+    { 64, 128, 192, 255},   // EASE_LINEAR
+    { 16,  64, 143, 255},   // EASE_IN     (t^2)
+    {112, 191, 239, 255},   // EASE_OUT    (1 - (1-t)^2)
+    { 40, 128, 215, 255},   // EASE_IN_OUT (3t^2 - 2t^3)
+};
+
+// ============================================================================
+// DEVICE STATUS ANIMATIONS (flash)
+// ============================================================================
+
+typedef RGBLed::Keyframe Keyframe;
+typedef RGBLed::Animation Animation;
+
+static const Keyframe FRAMES_RED_BLINK_500[] = {
+    {{255, 0, 0}, RGBLed::EASE_STEP, 500},
+    {{0, 0, 0},   RGBLed::EASE_STEP, 500},
+};
+
+static const Keyframe FRAMES_YELLOW_BLINK_500[] = {
+    {{255, 151, 0}, RGBLed::EASE_STEP, 500},
+    {{0, 0, 0},     RGBLed::EASE_STEP, 500},
+};
+
+static const Keyframe FRAMES_GREEN_BLINK_250[] = {
+    {{0, 255, 0}, RGBLed::EASE_STEP, 250},
+    {{0, 0, 0},   RGBLed::EASE_STEP, 250},
+};
+
+static const Keyframe FRAMES_BLUE[] = {
+    {{0, 0, 255}, RGBLed::EASE_STEP, 0},
+};
+
+static const Keyframe FRAMES_GREEN[] = {
+    {{0, 255, 0}, RGBLed::EASE_STEP, 0},
+};
+
+static const Keyframe FRAMES_RED[] = {
+    {{255, 0, 0}, RGBLed::EASE_STEP, 0},
+};
+
+static const Keyframe FRAMES_RED_FLASH_300[] = {
+    {{255, 0, 0}, RGBLed::EASE_STEP, 300},
+    {{0, 0, 0},   RGBLed::EASE_STEP, 0},
+};
+
+#define FRAME_COUNT(frames) (uint8_t)(sizeof(frames) / sizeof(frames[0]))
+
+static const Animation ANIM_BOOTING         = {"booting",       FRAMES_RED_BLINK_500,    FRAME_COUNT(FRAMES_RED_BLINK_500),    50,  0};
+static const Animation ANIM_WIFI_CONNECTING = {"wifi-connect",  FRAMES_BLUE,             FRAME_COUNT(FRAMES_BLUE),             100, 1};
+static const Animation ANIM_WIFI_ERROR      = {"wifi-error",    FRAMES_RED_BLINK_500,    FRAME_COUNT(FRAMES_RED_BLINK_500),    50,  0};
+static const Animation ANIM_TIME_SYNCING    = {"time-sync",     FRAMES_YELLOW_BLINK_500, FRAME_COUNT(FRAMES_YELLOW_BLINK_500), 50,  0};
+static const Animation ANIM_READY           = {"ready",         FRAMES_GREEN,            FRAME_COUNT(FRAMES_GREEN),            60,  1};
+static const Animation ANIM_FEEDING         = {"feeding",       FRAMES_GREEN_BLINK_250,  FRAME_COUNT(FRAMES_GREEN_BLINK_250),  60,  0};
+static const Animation ANIM_CANCELED        = {"canceled",      FRAMES_RED_FLASH_300,    FRAME_COUNT(FRAMES_RED_FLASH_300),    100, 1};
+static const Animation ANIM_ERROR           = {"error",         FRAMES_RED,              FRAME_COUNT(FRAMES_RED),              100, 1};
+
+// ============================================================================
+// LEDC HELPERS
+// ============================================================================
+
+// Arduino LEDC channel 0-15 -> IDF speed mode / channel (8 channels per group)
+static inline ledc_mode_t ledcModeOf(uint8_t channel) {
+    return (ledc_mode_t)(channel / 8);
+}
+
+static inline ledc_channel_t ledcChannelOf(uint8_t channel) {
+    return (ledc_channel_t)(channel % 8);
+}
+
+/**
+ * LEDC fade-end interrupt: one call per channel whose fade finished
+ * user_arg points to the owning LED's pending fade counter
+ */
+static bool IRAM_ATTR onLedcFadeEnd(const ledc_cb_param_t* param, void* user_arg) {
+    volatile uint8_t* pending = (volatile uint8_t*)user_arg;
+    if (param->event == LEDC_FADE_END_EVT && *pending > 0) {
+        *pending = *pending - 1;
+    }
+    return false;  // No task woken
+}
+
+static inline uint8_t lerp8(uint8_t from, uint8_t to, uint8_t progress) {
+    return from + (((int16_t)to - (int16_t)from) * progress) / 255;
+}
+
+static inline uint16_t clampDuration(unsigned long durationMs) {
+    return durationMs > 0xFFFF ? 0xFFFF : (uint16_t)durationMs;
+}
+
 RGBLed::RGBLed(uint8_t redPin, uint8_t greenPin, uint8_t bluePin, LEDType type)
     : _redPin(redPin),
       _greenPin(greenPin),
@@ -23,21 +140,19 @@ RGBLed::RGBLed(uint8_t redPin, uint8_t greenPin, uint8_t bluePin, LEDType type)
       _currentColor({0, 0, 0}),
       _brightness(100),
       _isOn(false),
-      _timedOperation(false),
-      _timedStartTime(0),
-      _timedDuration(0),
-      _fadeInProgress(false),
-      _fadeStartColor({0, 0, 0}),
-      _fadeTargetColor({0, 0, 0}),
-      _fadeStartTime(0),
-      _fadeDuration(0),
-      _blinkActive(false),
-      _blinkInterval(0),
-      _blinkLastChange(0),
-      _blinkTotalCount(0),
-      _blinkCompletedCount(0),
-      _blinkCurrentlyOn(false),
-      _deviceStatus(STATUS_MANUAL) {
+      _shownColor({0, 0, 0}),
+      _hardwareFade(false),
+      _fadesPending(0),
+      _playing(false),
+      _frameIndex(0),
+      _stepIndex(0),
+      _loopsDone(0),
+      _segmentStart({0, 0, 0}),
+      _stepStartTime(0),
+      _stepDuration(0),
+      _dutyKnown(false),
+      _deviceStatus(STATUS_MANUAL),
+      _activityCallback(nullptr) {
     
     // Assign PWM channels (ensure we don't exceed 16 channels)
     _redChannel = nextPWMChannel++;
@@ -47,6 +162,9 @@ RGBLed::RGBLed(uint8_t redPin, uint8_t greenPin, uint8_t bluePin, LEDType type)
     if (nextPWMChannel > 15) {
         nextPWMChannel = 0;  // Wrap around if needed
     }
+    
+    _animation = ANIM_READY;
+    buildLut();
 }
 
 bool RGBLed::begin() {
@@ -60,6 +178,21 @@ bool RGBLed::begin() {
     ledcAttachPin(_greenPin, _greenChannel);
     ledcAttachPin(_bluePin, _blueChannel);
     
+    // Enable the LEDC hardware fade engine (already installed is fine)
+    esp_err_t err = ledc_fade_func_install(0);
+    _hardwareFade = (err == ESP_OK || err == ESP_ERR_INVALID_STATE);
+    
+    if (_hardwareFade) {
+        ledc_cbs_t callbacks;
+        callbacks.fade_cb = onLedcFadeEnd;
+
+        const uint8_t channels[3] = {_redChannel, _greenChannel, _blueChannel};
+        for (uint8_t i = 0; i < 3; i++) {
+            ledc_cb_register(ledcModeOf(channels[i]), ledcChannelOf(channels[i]),
+                             &callbacks, (void*)&_fadesPending);
+        }
+    }
+    
     // Initialize LED to off state
     turnOff();
     
@@ -67,40 +200,16 @@ bool RGBLed::begin() {
 }
 
 void RGBLed::turnOn() {
-    // Stop any active blink when manually turning on
-    if (_blinkActive) {
-        _blinkActive = false;
-        _blinkCompletedCount = 0;
-        _blinkTotalCount = 0;
-    }
+    // Stop any running animation when manually turning on
+    stopAnimation();
     
     _isOn = true;
     applyColor();
 }
 
 void RGBLed::turnOff() {
-    _isOn = false;
-    _timedOperation = false;
-    _fadeInProgress = false;
-    // DO NOT stop blink here - let blink control itself
-    // _blinkActive = false;  // REMOVED - was causing blink to stop
+    stopAnimation();
     
-    // Turn off all channels
-    writePWM(_redChannel, 0);
-    writePWM(_greenChannel, 0);
-    writePWM(_blueChannel, 0);
-}
-
-void RGBLed::_turnOn() {
-    // Internal turn on for blink state machine
-    // Does NOT cancel active blink
-    _isOn = true;
-    applyColor();
-}
-
-void RGBLed::_turnOff() {
-    // Internal turn off for blink state machine
-    // Does NOT cancel active blink or timed operations
     _isOn = false;
     applyColor();
 }
@@ -110,12 +219,8 @@ bool RGBLed::isOn() const {
 }
 
 void RGBLed::setColor(uint8_t red, uint8_t green, uint8_t blue) {
-    // Stop any active blink when manually changing color
-    if (_blinkActive) {
-        _blinkActive = false;
-        _blinkCompletedCount = 0;
-        _blinkTotalCount = 0;
-    }
+    // Stop any running animation when manually changing color
+    stopAnimation();
     
     _currentColor.r = red;
     _currentColor.g = green;
@@ -136,8 +241,10 @@ RGBLed::Color RGBLed::getColor() const {
 
 void RGBLed::setBrightness(uint8_t brightness) {
     _brightness = constrain(brightness, 0, 100);
+    buildLut();
     
-    if (_isOn) {
+    // A running animation picks the new table up at its next step
+    if (_isOn && !_playing) {
         applyColor();
     }
 }
@@ -147,17 +254,10 @@ uint8_t RGBLed::getBrightness() const {
 }
 
 void RGBLed::turnOnFor(unsigned long durationMs) {
-    // Stop any active blink when starting timed operation
-    if (_blinkActive) {
-        _blinkActive = false;
-        _blinkCompletedCount = 0;
-        _blinkTotalCount = 0;
-    }
-    
-    _timedOperation = true;
-    _timedStartTime = millis();
-    _timedDuration = durationMs;
-    turnOn();
+    // On with the current color, then off
+    _generatedFrames[0] = {_currentColor, EASE_STEP, clampDuration(durationMs)};
+    _generatedFrames[1] = {OFF, EASE_STEP, 0};
+    playGenerated("timed", 2, 1);
 }
 
 void RGBLed::turnOnFor(unsigned long durationMs, const Color& color) {
@@ -166,113 +266,106 @@ void RGBLed::turnOnFor(unsigned long durationMs, const Color& color) {
 }
 
 void RGBLed::fadeTo(const Color& targetColor, unsigned long durationMs) {
-    // Stop any active blink when starting fade
-    if (_blinkActive) {
-        _blinkActive = false;
-        _blinkCompletedCount = 0;
-        _blinkTotalCount = 0;
-    }
-    
-    _fadeInProgress = true;
-    _fadeStartColor = _currentColor;
-    _fadeTargetColor = targetColor;
-    _fadeStartTime = millis();
-    _fadeDuration = durationMs;
+    stopAnimation();
+    _currentColor = targetColor;
     
-    if (!_isOn) {
-        turnOn();
+    if (durationMs == 0) {
+        _isOn = true;
+        applyColor();
+        return;
     }
+    
+    // Fade starts from whatever the LED shows now
+    _generatedFrames[0] = {targetColor, EASE_LINEAR, clampDuration(durationMs)};
+    playGenerated("fade", 1, 1);
 }
 
-void RGBLed::blink(unsigned long intervalMs, uint16_t count) {
-    // CRITICAL: Cancel any existing blink first
-    if (_blinkActive) {
-        _blinkActive = false;
-        _blinkCompletedCount = 0;
-        _blinkTotalCount = 0;
+void RGBLed::breathe(unsigned long periodMs, uint16_t count) {
+    // Breathe the color already set (like blink)
+    uint16_t half = clampDuration(periodMs / 2);
+    if (half == 0) {
+        half = 1;
     }
     
+    _generatedFrames[0] = {_currentColor, EASE_IN_OUT, half};
+    _generatedFrames[1] = {OFF, EASE_IN_OUT, half};
+    playGenerated("breathe", 2, count);  // 0 = infinite
+}
+
+void RGBLed::blink(unsigned long intervalMs, uint16_t count) {
     // DO NOT change color - use whatever color is already set
-    // If no color is set, _currentColor will be from last operation
-    
-    // Initialize NEW blink state
-    _blinkActive = true;
-    _blinkInterval = intervalMs;
-    _blinkTotalCount = count;           // 0 = infinite, >0 = specific count
-    _blinkCompletedCount = 0;           // Start from zero
-    _blinkCurrentlyOn = false;          // Will turn on in first update
-    _blinkLastChange = millis();        // Mark start time
+    uint16_t interval = clampDuration(intervalMs);
+    if (interval == 0) {
+        interval = 1;
+    }
     
-    // Turn LED off initially so first toggle turns it on
-    _turnOff();  // Use internal method - preserves blink state
+    // One blink = on for interval, then off for interval
+    _generatedFrames[0] = {_currentColor, EASE_STEP, interval};
+    _generatedFrames[1] = {OFF, EASE_STEP, interval};
+    playGenerated("blink", 2, count);  // 0 = infinite
 }
 
 void RGBLed::stopBlink() {
-    _blinkActive = false;
-    _blinkCompletedCount = 0;
-    _blinkTotalCount = 0;
-    turnOff();  // Final turn off
+    turnOff();  // Stops the animation, final turn off
+}
+
+void RGBLed::play(const Animation& animation) {
+    stopAnimation();
+    
+    _animation = animation;
+    if (animation.brightness > 0) {
+        setBrightness(animation.brightness);
+    }
+    
+    startAnimation();
+    
+    if (_playing) {
+        notifyActivity();
+    }
 }
 
 /**
- * Set device status and apply corresponding LED pattern
+ * Set device status and play the corresponding LED animation
  */
 void RGBLed::setDeviceStatus(DeviceStatus status) {
     _deviceStatus = status;
     
-    // Stop any manual operations when entering automatic status mode
-    if (status != STATUS_MANUAL) {
-        _timedOperation = false;
-        _fadeInProgress = false;
-    }
-    
     switch (status) {
         case STATUS_BOOTING:
-            // Red 50% blinking 500ms
-            setColor(RED);
-            setBrightness(50);
-            blink(500, 0);  // Infinite blink
+            play(ANIM_BOOTING);
             break;
-            
+        
         case STATUS_WIFI_CONNECTING:
-            // Blue 100% STATIC (not blinking - indicates actively trying to connect)
-            stopBlink();  // Stop any blinking
-            setColor(BLUE);
-            setBrightness(100);  // Full brightness for clear indication
-            turnOn();  // Static, not blinking
+            // STATIC (not blinking - indicates actively trying to connect)
+            play(ANIM_WIFI_CONNECTING);
             break;
-            
+        
         case STATUS_WIFI_ERROR:
-            // Red 50% blinking 500ms (connection failed/error)
-            setColor(RED);
-            setBrightness(50);
-            blink(500, 0);  // Infinite blink
+            play(ANIM_WIFI_ERROR);
             break;
-            
+        
         case STATUS_TIME_SYNCING:
-            // Yellow 50% blinking 500ms
-            setColor(YELLOW);
-            setBrightness(50);
-            blink(500, 0);  // Infinite blink
+            play(ANIM_TIME_SYNCING);
             break;
-            
+        
         case STATUS_READY:
-            // Green 60% static
-            stopBlink();  // Stop any blinking
-            setColor(GREEN);
-            setBrightness(60);
-            turnOn();
+            play(ANIM_READY);
             break;
-            
+        
         case STATUS_FEEDING:
-            // Green 60% blinking 250ms
-            setColor(GREEN);
-            setBrightness(60);
-            blink(250, 0);  // Infinite blink
+            play(ANIM_FEEDING);
             break;
-            
+        
+        case STATUS_CANCELED:
+            play(ANIM_CANCELED);
+            break;
+        
+        case STATUS_ERROR:
+            play(ANIM_ERROR);
+            break;
+        
         case STATUS_MANUAL:
-            // Manual control - do nothing, user controls LED
+            // Manual control - user controls LED
             stopBlink();
             break;
     }
@@ -286,117 +379,279 @@ RGBLed::DeviceStatus RGBLed::getDeviceStatus() const {
 }
 
 void RGBLed::update() {
-    // Handle timed operation
-    if (_timedOperation) {
-        if (millis() - _timedStartTime >= _timedDuration) {
-            turnOff();
+    // Zero-length steps chain in one call; bounded by one full pass
+    uint16_t guard = (uint16_t)_animation.frameCount * EASE_STEPS + 1;
+    
+    while (_playing && guard-- > 0) {
+        unsigned long elapsed = millis() - _stepStartTime;
+        
+        if (elapsed < _stepDuration) {
+            return;
+        }
+        
+        // Fade-end interrupts not all in yet (or none for an unchanged channel)
+        if (_fadesPending > 0 && elapsed < _stepDuration + FADE_COMPLETE_MARGIN_MS) {
+            return;
+        }
+        
+        if (!advanceStep()) {
+            return;
         }
     }
+}
+
+bool RGBLed::isAnimating() const {
+    return _playing;
+}
+
+unsigned long RGBLed::getNextUpdateDelay() const {
+    if (!_playing) {
+        return 0;
+    }
     
-    // Handle fade effect
-    if (_fadeInProgress) {
-        unsigned long elapsed = millis() - _fadeStartTime;
-        
-        if (elapsed >= _fadeDuration) {
-            // Fade complete
-            setColor(_fadeTargetColor);
-            _fadeInProgress = false;
+    unsigned long elapsed = millis() - _stepStartTime;
+    return elapsed < _stepDuration ? _stepDuration - elapsed : 1;
+}
+
+void RGBLed::setActivityCallback(ActivityCallback callback) {
+    _activityCallback = callback;
+}
+
+void RGBLed::printStatus(Print& out) const {
+    out.println(F("RGB LED Status:"));
+    out.print(F("  State: "));
+    out.println(_isOn ? "ON" : "OFF");
+    out.print(F("  Color: R="));
+    out.print(_currentColor.r);
+    out.print(F(" G="));
+    out.print(_currentColor.g);
+    out.print(F(" B="));
+    out.println(_currentColor.b);
+    out.print(F("  Brightness: "));
+    out.print(_brightness);
+    out.println(F("% (gamma 2.2)"));
+    out.print(F("  Pins: R="));
+    out.print(_redPin);
+    out.print(F(" G="));
+    out.print(_greenPin);
+    out.print(F(" B="));
+    out.println(_bluePin);
+    out.print(F("  Type: "));
+    out.println(_ledType == COMMON_CATHODE ? "Common Cathode" : "Common Anode");
+    out.print(F("  Fades: "));
+    out.println(_hardwareFade ? F("LEDC hardware") : F("unavailable (steps only)"));
+    
+    if (_playing) {
+        out.print(F("  Animation: "));
+        out.print(_animation.name);
+        out.print(F(", Frame="));
+        out.print(_frameIndex + 1);
+        out.print('/');
+        out.print(_animation.frameCount);
+        out.print(F(", Completed="));
+        out.print(_loopsDone);
+        if (_animation.loops > 0) {
+            out.print('/');
+            out.println(_animation.loops);
         } else {
-            // Calculate interpolated color
-            float progress = (float)elapsed / (float)_fadeDuration;
-            
-            uint8_t r = _fadeStartColor.r + ((_fadeTargetColor.r - _fadeStartColor.r) * progress);
-            uint8_t g = _fadeStartColor.g + ((_fadeTargetColor.g - _fadeStartColor.g) * progress);
-            uint8_t b = _fadeStartColor.b + ((_fadeTargetColor.b - _fadeStartColor.b) * progress);
-            
-            setColor(r, g, b);
+            out.println(F(" (Infinite)"));
         }
+        out.print(F("  Next step in: "));
+        out.print(getNextUpdateDelay());
+        out.println(F("ms"));
     }
+}
+
+void RGBLed::applyColor() {
+    // If LED is off, write 0 to all channels
+    showColor(_isOn ? _currentColor : OFF);
+}
+
+void RGBLed::showColor(const Color& color) {
+    _shownColor = color;
+    writeChannels(_lut[color.r], _lut[color.g], _lut[color.b]);
+}
+
+void RGBLed::writeChannels(uint8_t red, uint8_t green, uint8_t blue) {
+    stopHardwareFade();
+
+    const uint8_t channels[3] = {_redChannel, _greenChannel, _blueChannel};
+    const uint8_t values[3] = {red, green, blue};
     
-    // Handle blinking - COMPLETELY INDEPENDENT LOGIC
-    if (_blinkActive) {
-        unsigned long currentTime = millis();
-        
-        // Check if it's time to change state
-        if (currentTime - _blinkLastChange >= _blinkInterval) {
-            _blinkLastChange = currentTime;
-            
-            // Toggle LED state
-            if (_blinkCurrentlyOn) {
-                // LED is ON, turn it OFF
-                _turnOff();  // Use internal method - does NOT cancel blink
-                _blinkCurrentlyOn = false;
-                
-                // One complete blink cycle finished (ON → OFF)
-                _blinkCompletedCount++;
-                
-                // Check if we've completed all requested blinks
-                if (_blinkTotalCount > 0 && _blinkCompletedCount >= _blinkTotalCount) {
-                    _blinkActive = false;
-                }
-            } else {
-                // LED is OFF, turn it ON
-                _turnOn();  // Use internal method - does NOT cancel blink
-                _blinkCurrentlyOn = true;
-            }
+    for (uint8_t i = 0; i < 3; i++) {
+        // Dirty tracking: skip channels already at this duty
+        if (_dutyKnown && _duty[i] == values[i]) {
+            continue;
         }
+        writePWM(channels[i], values[i]);
+        _duty[i] = values[i];
     }
+    _dutyKnown = true;
 }
 
-String RGBLed::getStatus() const {
-    String status = "RGB LED Status:\n";
-    status += "  State: " + String(_isOn ? "ON" : "OFF") + "\n";
-    status += "  Color: R=" + String(_currentColor.r) + 
-              " G=" + String(_currentColor.g) + 
-              " B=" + String(_currentColor.b) + "\n";
-    status += "  Brightness: " + String(_brightness) + "%\n";
-    status += "  Pins: R=" + String(_redPin) + 
-              " G=" + String(_greenPin) + 
-              " B=" + String(_bluePin) + "\n";
-    status += "  Type: " + String(_ledType == COMMON_CATHODE ? "Common Cathode" : "Common Anode") + "\n";
-    
-    if (_timedOperation) {
-        unsigned long remaining = _timedDuration - (millis() - _timedStartTime);
-        status += "  Timed: " + String(remaining) + "ms remaining\n";
+void RGBLed::startHardwareFade(uint8_t red, uint8_t green, uint8_t blue, unsigned long durationMs) {
+    if (!_hardwareFade || durationMs == 0) {
+        // No fade service (or nothing to ramp): jump to the target, the step is still timed
+        writeChannels(red, green, blue);
+        return;
     }
     
-    if (_fadeInProgress) {
-        unsigned long remaining = _fadeDuration - (millis() - _fadeStartTime);
-        status += "  Fading: " + String(remaining) + "ms remaining\n";
+    stopHardwareFade();
+
+    const uint8_t channels[3] = {_redChannel, _greenChannel, _blueChannel};
+    const uint8_t values[3] = {red, green, blue};
+    bool changed[3];
+    uint8_t count = 0;
+    
+    for (uint8_t i = 0; i < 3; i++) {
+        changed[i] = !_dutyKnown || _duty[i] != values[i];
+        if (changed[i]) {
+            count++;
+        }
     }
     
-    if (_blinkActive) {
-        status += "  Blinking: Interval=" + String(_blinkInterval) + "ms";
-        status += ", Completed=" + String(_blinkCompletedCount);
-        if (_blinkTotalCount > 0) {
-            status += "/" + String(_blinkTotalCount);
-        } else {
-            status += " (Infinite)";
+    // Set the counter before starting: the fade-end ISR only decrements it
+    _fadesPending = count;
+    
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!changed[i]) {
+            continue;
         }
-        status += ", Currently=" + String(_blinkCurrentlyOn ? "ON" : "OFF");
-        status += "\n";
+        uint32_t duty = (_ledType == COMMON_ANODE) ? 255 - values[i] : values[i];
+        ledc_set_fade_with_time(ledcModeOf(channels[i]), ledcChannelOf(channels[i]), duty, (int)durationMs);
+        ledc_fade_start(ledcModeOf(channels[i]), ledcChannelOf(channels[i]), LEDC_FADE_NO_WAIT);
+        _duty[i] = values[i];
+    }
+    _dutyKnown = true;
+}
+
+void RGBLed::stopHardwareFade() {
+    if (!_hardwareFade || _fadesPending == 0) {
+        return;
     }
+
+    const uint8_t channels[3] = {_redChannel, _greenChannel, _blueChannel};
     
-    return status;
+    for (uint8_t i = 0; i < 3; i++) {
+        ledc_fade_stop(ledcModeOf(channels[i]), ledcChannelOf(channels[i]));
+        
+        // Resync dirty tracking with the duty the ramp stopped at
+        uint32_t duty = ledc_get_duty(ledcModeOf(channels[i]), ledcChannelOf(channels[i]));
+        if (duty > 255) {
+            duty = 255;
+        }
+        _duty[i] = (_ledType == COMMON_ANODE) ? 255 - duty : duty;
+    }
+    _fadesPending = 0;
 }
 
-void RGBLed::applyColor() {
-    if (!_isOn) {
-        // If LED is off, write 0 to all channels
-        writePWM(_redChannel, 0);
-        writePWM(_greenChannel, 0);
-        writePWM(_blueChannel, 0);
+void RGBLed::buildLut() {
+    // Brightness scales the perceptual level, gamma maps it to duty
+    for (uint16_t v = 0; v < 256; v++) {
+        _lut[v] = GAMMA_22[(v * _brightness + 50) / 100];
+    }
+}
+
+void RGBLed::startAnimation() {
+    if (_animation.frames == nullptr || _animation.frameCount == 0) {
         return;
     }
     
-    // LED is on, apply color with brightness
-    uint8_t r = applyBrightness(_currentColor.r);
-    uint8_t g = applyBrightness(_currentColor.g);
-    uint8_t b = applyBrightness(_currentColor.b);
+    // An endless pass of zero-length frames would never yield: play it once
+    uint32_t passDuration = 0;
+    for (uint8_t i = 0; i < _animation.frameCount; i++) {
+        passDuration += _animation.frames[i].durationMs;
+    }
+    if (passDuration == 0) {
+        _animation.loops = 1;
+    }
+    
+    _playing = true;
+    _isOn = true;
+    _frameIndex = 0;
+    _stepIndex = 0;
+    _loopsDone = 0;
+    _segmentStart = _shownColor;
     
-    writePWM(_redChannel, r);
-    writePWM(_greenChannel, g);
-    writePWM(_blueChannel, b);
+    startStep();
+    
+    // Consume zero-length steps now (static colors finish immediately)
+    update();
+}
+
+void RGBLed::startStep() {
+    const Keyframe& frame = _animation.frames[_frameIndex];
+    _stepStartTime = millis();
+    
+    if (frame.easing == EASE_STEP || frame.durationMs == 0) {
+        showColor(frame.color);
+        _stepDuration = frame.durationMs;
+        return;
+    }
+    
+    // Eased segment: linear hardware ramp to the eased point of this sub-step
+    uint8_t progress = EASE_CURVES[frame.easing - EASE_LINEAR][_stepIndex];
+    Color target = {lerp8(_segmentStart.r, frame.color.r, progress),
+                    lerp8(_segmentStart.g, frame.color.g, progress),
+                    lerp8(_segmentStart.b, frame.color.b, progress)};
+    
+    uint32_t duration = frame.durationMs;
+    _stepDuration = duration * (_stepIndex + 1) / EASE_STEPS - duration * _stepIndex / EASE_STEPS;
+    
+    _shownColor = target;
+    startHardwareFade(_lut[target.r], _lut[target.g], _lut[target.b], _stepDuration);
+}
+
+bool RGBLed::advanceStep() {
+    const Keyframe& frame = _animation.frames[_frameIndex];
+    bool eased = frame.easing != EASE_STEP && frame.durationMs > 0;
+    
+    if (eased && ++_stepIndex < EASE_STEPS) {
+        startStep();
+        return true;
+    }
+    
+    // Keyframe reached
+    _stepIndex = 0;
+    _segmentStart = frame.color;
+    _fadesPending = 0;
+    
+    if (++_frameIndex >= _animation.frameCount) {
+        _frameIndex = 0;
+        _loopsDone++;
+        
+        if (_animation.loops > 0 && _loopsDone >= _animation.loops) {
+            // Finished: hold the last keyframe color
+            _playing = false;
+            
+            if (frame.color.r == 0 && frame.color.g == 0 && frame.color.b == 0) {
+                _isOn = false;
+            } else {
+                _currentColor = frame.color;
+            }
+            return false;
+        }
+    }
+    
+    startStep();
+    return true;
+}
+
+void RGBLed::stopAnimation() {
+    // Colors stay where the animation left them
+    _playing = false;
+    stopHardwareFade();
+}
+
+void RGBLed::playGenerated(const char* name, uint8_t count, uint16_t loops) {
+    Animation animation = {name, _generatedFrames, count, 0, loops};
+    play(animation);
+}
+
+void RGBLed::notifyActivity() {
+    if (_activityCallback) {
+        _activityCallback();
+    }
 }
 
 void RGBLed::writePWM(uint8_t channel, uint8_t value) {
@@ -407,7 +662,3 @@ void RGBLed::writePWM(uint8_t channel, uint8_t value) {
     
     ledcWrite(channel, value);
 }
-
-uint8_t RGBLed::applyBrightness(uint8_t value) const {
-    return (value * _brightness) / 100;
-}
@@ -16,11 +16,20 @@
  * 
  * Features:
  * - Turn LED on/off
- * - Set custom RGB colors (0-255 per channel)
+ * - Set custom RGB colors (0-255 per channel, perceptual / gamma 2.2)
  * - Predefined color constants
  * - Adjust brightness (0-100%)
- * - Timed on/off operations (non-blocking)
- * - Smooth fade effects
+ * - Keyframe animations (color, duration, easing per segment, looping);
+ *   device status patterns are constant animations in flash
+ * - Timed on, fade, breathing and blinking are generated keyframe animations
+ * - Gamma + brightness lookup table rebuilt only when brightness changes,
+ *   so every frame is a table lookup per channel
+ * - Fade segments run on the LEDC hardware fade engine (completion reported
+ *   by the LEDC fade-end interrupt); eased segments are split into a few
+ *   linear hardware ramps
+ * - PWM channels are written only when their duty actually changes
+ * - getNextUpdateDelay() / activity callback let the maintenance task sleep
+ *   until the next keyframe, or entirely while the LED is static
  */
 
 class RGBLed {
@@ -44,6 +53,8 @@ public:
         STATUS_TIME_SYNCING,       // Yellow 50% blinking 500ms
         STATUS_READY,              // Green 60% static
         STATUS_FEEDING,            // Green 60% blinking 250ms
+        STATUS_CANCELED,           // Red 100% flash 300ms, then off
+        STATUS_ERROR,              // Red 100% static
         STATUS_MANUAL              // Manual control (no automatic status)
     };
 
@@ -66,6 +77,46 @@ public:
     static const Color PURPLE;
     static const Color OFF;
 
+    /**
+     * Segment easing (how the color moves towards the keyframe color)
+     */
+    enum Easing : uint8_t {
+        EASE_STEP,                 // Jump to the color, then hold for the duration
+        EASE_LINEAR,
+        EASE_IN,                   // Slow start (quadratic)
+        EASE_OUT,                  // Slow end (quadratic)
+        EASE_IN_OUT                // Slow start and end (smoothstep)
+    };
+
+    /**
+     * Animation keyframe: reach color over durationMs using easing
+     */
+    struct Keyframe {
+        Color color;
+        Easing easing;
+        uint16_t durationMs;
+    };
+
+    /**
+     * Keyframe animation (frames usually static const, i.e. in flash)
+     * 
+     * Each pass starts from the color the LED shows when it begins. After
+     * the last pass the LED holds the last keyframe color (off if OFF).
+     */
+    struct Animation {
+        const char* name;
+        const Keyframe* frames;
+        uint8_t frameCount;
+        uint8_t brightness;        // 1-100 applies a brightness, 0 keeps the current one
+        uint16_t loops;            // Number of passes (0 = loop forever)
+    };
+
+    /**
+     * Activity callback type
+     * Called when an animation starts (blink, fade, status pattern, ...)
+     */
+    typedef void (*ActivityCallback)();
+
     /**
      * Constructor
      * 
@@ -129,7 +180,7 @@ public:
     /**
      * Set brightness level (0-100%)
      * 
-     * Applies a brightness multiplier to the current color.
+     * Rebuilds the gamma/brightness lookup table used for every channel.
      * 
      * @param brightness: Brightness percentage (0-100)
      */
@@ -163,11 +214,21 @@ public:
     /**
      * Fade to a new color over specified duration (non-blocking)
      * 
+     * getColor() returns the target color as soon as the fade starts.
+     * 
      * @param targetColor: Target color to fade to
      * @param durationMs: Fade duration in milliseconds
      */
     void fadeTo(const Color& targetColor, unsigned long durationMs);
 
+    /**
+     * Breathe the current color (ease in/out up, then down, repeat)
+     * 
+     * @param periodMs: Duration of one full breath in milliseconds
+     * @param count: Number of breaths (0 = infinite)
+     */
+    void breathe(unsigned long periodMs, uint16_t count = 0);
+
     /**
      * Blink LED with specified interval (non-blocking)
      * 
@@ -177,14 +238,21 @@ public:
     void blink(unsigned long intervalMs, uint16_t count = 0);
 
     /**
-     * Stop blinking
+     * Stop blinking, breathing or any other animation (LED off)
      */
     void stopBlink();
 
+    /**
+     * Play a keyframe animation (replaces the running one)
+     * 
+     * @param animation: Animation to play (frames must outlive playback)
+     */
+    void play(const Animation& animation);
+
     /**
      * Set device status (automatic LED behavior)
      * 
-     * Controls LED color, brightness, and blinking pattern based on device state.
+     * Plays the status animation (color, brightness and pattern).
      * 
      * @param status: Device status enum
      */
@@ -200,17 +268,42 @@ public:
     /**
      * Update LED state (call regularly in loop)
      * 
-     * Handles timed operations, fading, and blinking.
-     * Must be called frequently for non-blocking operations.
+     * Advances the running animation to the next keyframe step when the
+     * current one has ended. Only needed while isAnimating() is true.
      */
     void update();
 
     /**
-     * Get status string for debugging
+     * Check if an animation needs update() calls
+     * 
+     * @return: true while an animation is playing
+     */
+    bool isAnimating() const;
+
+    /**
+     * Time until update() has work to do
      * 
-     * @return: String with LED status information
+     * @return: Milliseconds until the current keyframe step ends
+     *          (at least 1), 0 if no animation is playing
      */
-    String getStatus() const;
+    unsigned long getNextUpdateDelay() const;
+
+    /**
+     * Set callback invoked when an animation starts
+     * 
+     * Lets the owner re-enable a maintenance task that sleeps while the
+     * LED is static.
+     * 
+     * @param callback: Function to call (nullptr to disable)
+     */
+    void setActivityCallback(ActivityCallback callback);
+
+    /**
+     * Print status report for debugging
+     * 
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
 
 private:
     // Pin assignments
@@ -230,36 +323,49 @@ private:
     Color _currentColor;
     uint8_t _brightness;  // 0-100%
     bool _isOn;
+    Color _shownColor;    // Color last sent to the channels (start of the next segment)
+
+    // Gamma 2.2 + brightness: perceptual 0-255 -> PWM duty
+    uint8_t _lut[256];
+
+    // Hardware fade state
+    bool _hardwareFade;              // LEDC fade service available
+    volatile uint8_t _fadesPending;  // Channel fades still running (decremented by the fade-end ISR)
+
+    // Animation player state
+    Animation _animation;            // Running animation (frames may point to _generatedFrames)
+    bool _playing;
+    uint8_t _frameIndex;
+    uint8_t _stepIndex;              // Sub-step within an eased segment
+    uint16_t _loopsDone;
+    Color _segmentStart;             // Color at the start of the current keyframe
+    unsigned long _stepStartTime;
+    unsigned long _stepDuration;
 
-    // Timed operation state
-    bool _timedOperation;
-    unsigned long _timedStartTime;
-    unsigned long _timedDuration;
-
-    // Fade effect state
-    bool _fadeInProgress;
-    Color _fadeStartColor;
-    Color _fadeTargetColor;
-    unsigned long _fadeStartTime;
-    unsigned long _fadeDuration;
-
-    // Blink state
-    bool _blinkActive;
-    unsigned long _blinkInterval;
-    unsigned long _blinkLastChange;
-    uint16_t _blinkTotalCount;       // Total number of complete blinks requested
-    uint16_t _blinkCompletedCount;   // Number of complete blinks done
-    bool _blinkCurrentlyOn;          // Current on/off state during blinking
+    // Frames for animations generated at runtime (blink, breathe, fade, timed on)
+    Keyframe _generatedFrames[2];
+
+    // Last duty written per channel (before common anode inversion)
+    uint8_t _duty[3];
+    bool _dutyKnown;                 // false until the first write
 
     // Device status state
     DeviceStatus _deviceStatus;
 
+    ActivityCallback _activityCallback;
+
     // PWM configuration
     static const uint32_t PWM_FREQUENCY = 5000;  // 5 kHz
     static const uint8_t PWM_RESOLUTION = 8;     // 8-bit (0-255)
 
+    // Eased segments are played as this many linear hardware ramps
+    static const uint8_t EASE_STEPS = 4;
+
+    // Extra time before a fade is treated as finished without its interrupt
+    static const unsigned long FADE_COMPLETE_MARGIN_MS = 50;
+
     /**
-     * Apply current color to hardware with brightness adjustment
+     * Apply current color to hardware (off if LED is off)
      */
     void applyColor();
 
@@ -272,24 +378,65 @@ private:
     void writePWM(uint8_t channel, uint8_t value);
 
     /**
-     * Calculate brightness-adjusted color value
+     * Show a color immediately through the lookup table
+     */
+    void showColor(const Color& color);
+
+    /**
+     * Write duty to all channels, skipping channels that already hold it
+     * Stops a running hardware fade first
+     */
+    void writeChannels(uint8_t red, uint8_t green, uint8_t blue);
+
+    /**
+     * Start LEDC hardware fades from the current duty to the given duty
      * 
-     * @param value: Original color value (0-255)
-     * @return: Brightness-adjusted value (0-255)
+     * @param red, green, blue: Target duty (lookup table already applied)
+     * @param durationMs: Fade duration in milliseconds
+     */
+    void startHardwareFade(uint8_t red, uint8_t green, uint8_t blue, unsigned long durationMs);
+
+    /**
+     * Stop running hardware fades, keeping the duty they reached
+     */
+    void stopHardwareFade();
+
+    /**
+     * Rebuild the gamma/brightness lookup table
+     */
+    void buildLut();
+
+    /**
+     * Start playing _animation from its first keyframe
+     */
+    void startAnimation();
+
+    /**
+     * Start the current keyframe step (jump or hardware ramp)
+     */
+    void startStep();
+
+    /**
+     * Move to the next keyframe step, loop or finish
+     * 
+     * @return: true if another step was started
+     */
+    bool advanceStep();
+
+    /**
+     * Stop the running animation, keeping the color it reached
      */
-    uint8_t applyBrightness(uint8_t value) const;
+    void stopAnimation();
 
     /**
-     * Internal turn on (for blink state machine)
-     * Does NOT cancel active blink operation
+     * Play the first count entries of _generatedFrames
      */
-    void _turnOn();
+    void playGenerated(const char* name, uint8_t count, uint16_t loops);
 
     /**
-     * Internal turn off (for blink state machine)
-     * Does NOT cancel active blink operation
+     * Invoke activity callback (if set)
      */
-    void _turnOff();
+    void notifyActivity();
 };
 
 #endif // RGB_LED_H
@@ -1,6 +1,11 @@
 #include "rtc_module.h"
+#include "console_manager.h"
+#include "trace_buffer.h"
+#include "input_recorder.h"
+#include "loop_watchdog.h"
+#include "config.h"
 
-RTCModule::RTCModule() {
+RTCModule::RTCModule() : preferencesReady(false), lastRecordedUtc(0) {
   // Construtor vazio
 }
 
@@ -32,6 +37,8 @@ bool RTCModule::testDS3231Communication() {
 }
 
 bool RTCModule::begin() {
+  LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_RTC_BEGIN);
+  
   // Initialize Wire (I2C)
   Wire.begin();
   
@@ -93,6 +100,9 @@ bool RTCModule::begin() {
     }
   }
   
+  // Zone first: conversions below (and other modules) need it even without an RTC
+  loadTimezone();
+  
   if (!rtcOK) {
     Serial.println();
     Serial.println(F("=== COMPLETE DIAGNOSIS ==="));
@@ -111,7 +121,12 @@ bool RTCModule::begin() {
   // Verificar se o RTC perdeu energia e resetar se necessário
   if (rtc.lostPower()) {
     Serial.println("RTC perdeu energia, configurando com data/hora de compilação!");
-    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+    adjust(DateTime(F(__DATE__), F(__TIME__)));
+    if (preferencesReady) {
+      preferences.putBool(RTC_UTC_NVRAM_KEY, true);
+    }
+  } else {
+    migrateToUtc();
   }
   
   Serial.println(F("✓ RTC module initialized successfully!"));
@@ -177,8 +192,55 @@ void RTCModule::scanI2C() {
   Serial.println();
 }
 
+/**
+ * Load the time zone from NVRAM (DEFAULT_TIMEZONE if none or invalid)
+ */
+void RTCModule::loadTimezone() {
+  preferencesReady = preferences.begin(RTC_NVRAM_NAMESPACE, false);
+  
+  char posix[TIMEZONE_POSIX_MAX_LENGTH + 1] = "";
+  if (preferencesReady) {
+    preferences.getString(RTC_TIMEZONE_NVRAM_KEY, posix, sizeof(posix));
+  } else {
+    Console::printlnR(F("RTC: WARNING - NVRAM not available, using default time zone"));
+  }
+  
+  if (posix[0] == '\0' || !timeZone.set(posix)) {
+    timeZone.set(DEFAULT_TIMEZONE);
+  }
+  
+  Console::printR(F("Time zone: "));
+  Console::printlnR(timeZone.getPosix());
+}
+
+/**
+ * Older firmware kept local time in the RTC. Convert it to UTC once,
+ * using the configured zone, and remember that in NVRAM.
+ */
+void RTCModule::migrateToUtc() {
+  if (!preferencesReady || preferences.getBool(RTC_UTC_NVRAM_KEY, false)) {
+    return;
+  }
+  
+  uint32_t local = rtc.now().unixtime();
+  rtc.adjust(DateTime(timeZone.toUtc(local)));
+  preferences.putBool(RTC_UTC_NVRAM_KEY, true);
+  Console::printlnR(F("RTC: Converted stored local time to UTC"));
+}
+
 DateTime RTCModule::now() {
-  return rtc.now();
+  return DateTime(timeZone.toLocal(nowUtc()));
+}
+
+uint32_t RTCModule::nowUtc() {
+  uint32_t utc = rtc.now().unixtime();
+  
+  // Readings within the same second add nothing to a replay
+  if (utc != lastRecordedUtc && InputRecorder::isEnabled()) {
+    InputRecorder::record(InputRecorder::TYPE_RTC_READ, &utc, sizeof(utc));
+    lastRecordedUtc = utc;
+  }
+  return utc;
 }
 
 bool RTCModule::lostPower() {
@@ -186,7 +248,37 @@ bool RTCModule::lostPower() {
 }
 
 void RTCModule::adjust(const DateTime& dt) {
-  rtc.adjust(dt);
+  rtc.adjust(DateTime(timeZone.toUtc(dt.unixtime())));
+}
+
+void RTCModule::adjustUtc(uint32_t utc) {
+  rtc.adjust(DateTime(utc));
+}
+
+/**
+ * Apply and persist a POSIX TZ string
+ *
+ * @param posix: e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+ * @return: false if the string is invalid (zone unchanged)
+ */
+bool RTCModule::setTimezone(const char* posix) {
+  if (!timeZone.set(posix)) {
+    return false;
+  }
+  
+  if (preferencesReady) {
+    TraceBuffer::begin(TraceBuffer::NVS_COMMIT, "rtc.timezone");
+    preferences.putString(RTC_TIMEZONE_NVRAM_KEY, posix);
+    TraceBuffer::end(TraceBuffer::NVS_COMMIT);
+  }
+  
+  Console::printR(F("Time zone set to "));
+  Console::printlnR(timeZone.getPosix());
+  return true;
+}
+
+TimeZone& RTCModule::getTimezone() {
+  return timeZone;
 }
 
 float RTCModule::getTemperature() {
@@ -219,8 +311,8 @@ bool RTCModule::processCommand(String comando) {
       if (dia >= 1 && dia <= 31 && mes >= 1 && mes <= 12 && ano >= 2000 && ano <= 2099 &&
           hora >= 0 && hora <= 23 && minuto >= 0 && minuto <= 59 && segundo >= 0 && segundo <= 59) {
         
-        // Adjust the RTC
-        rtc.adjust(DateTime(ano, mes, dia, hora, minuto, segundo));
+        // Adjust the RTC (input is local time)
+        adjust(DateTime(ano, mes, dia, hora, minuto, segundo));
         
         Serial.println(F("✓ Time adjusted successfully!"));
         Serial.print(F("New date/time: "));
@@ -253,7 +345,8 @@ bool RTCModule::processCommand(String comando) {
 }
 
 void RTCModule::printDateTime() {
-  DateTime now = rtc.now();
+  uint32_t utc = nowUtc();
+  DateTime now(timeZone.toLocal(utc));
   
   // Display date and time in DD/MM/YYYY HH:MM:SS format
   Serial.print(F("Date/Time: "));
@@ -273,15 +366,17 @@ void RTCModule::printDateTime() {
   Serial.print(':');
   if (now.second() < 10) Serial.print("0");
   Serial.print(now.second(), DEC);
+  Serial.print(' ');
+  Serial.print(timeZone.getAbbreviation(utc));
   
   // Show day of week
   const char* dayNames[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
   Serial.print(F(" - "));
   Serial.print(dayNames[now.dayOfTheWeek()]);
   
-  // Show Unix timestamp
+  // Show Unix timestamp (UTC)
   Serial.print(F(" (Unix: "));
-  Serial.print(now.unixtime());
+  Serial.print(utc);
   Serial.println(F(")"));
 }
 
@@ -4,14 +4,30 @@
 #include <Arduino.h>
 #include <RTClib.h>
 #include <Wire.h>
+#include <Preferences.h>
+#include "time_zone.h"
 
+/**
+ * RTCModule Class
+ * 
+ * DS3231 access. The RTC keeps UTC; now()/adjust() work in local time
+ * through the configured TimeZone, nowUtc()/adjustUtc() use UTC directly.
+ */
 class RTCModule {
 private:
   RTC_DS3231 rtc;
+  TimeZone timeZone;
+  Preferences preferences;    // Time zone and UTC migration flag
+  bool preferencesReady;
+  uint32_t lastRecordedUtc;   // Last reading written to the input recorder
   
   // Função para testar comunicação I2C específica com DS3231
   bool testDS3231Communication();
   
+  // Load the time zone and convert a local-time RTC to UTC (once)
+  void loadTimezone();
+  void migrateToUtc();
+  
 public:
   // Constructor
   RTCModule();
@@ -22,15 +38,25 @@ public:
   // Diagnostic functions
   void scanI2C();
   
-  // Get current date/time
+  // Get current local date/time
   DateTime now();
   
+  // Get current time as UTC epoch seconds
+  uint32_t nowUtc();
+  
   // Check if RTC lost power
   bool lostPower();
   
-  // Adjust date/time
+  // Adjust date/time (local time)
   void adjust(const DateTime& dt);
   
+  // Adjust date/time (UTC epoch seconds)
+  void adjustUtc(uint32_t utc);
+  
+  // Time zone (POSIX TZ string, persisted in NVRAM)
+  bool setTimezone(const char* posix);
+  TimeZone& getTimezone();
+  
   // Get RTC temperature
   float getTemperature();
   
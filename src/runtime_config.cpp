@@ -0,0 +1,403 @@
+#include "runtime_config.h"
+#include "console_manager.h"
+#include "trace_buffer.h"
+#include <stddef.h>
+
+// ============================================================================
+// REGISTRY TABLE
+// ============================================================================
+
+// Indexed by RuntimeConfig::Id - keep in the same order as the enum
+static const RuntimeConfig::Entry CONFIG_ENTRIES[RuntimeConfig::CONFIG_COUNT] = {
+    { "touch.portions",     RuntimeConfig::TYPE_UINT8,  offsetof(RuntimeConfig::Values, touchPortions),
+      MIN_FOOD_PORTIONS, MAX_FOOD_PORTIONS, DEFAULT_TOUCH_LONG_PRESS_PORTIONS, true, "portions" },
+    { "touch.enabled",      RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, touchEnabled),
+      0, 1, DEFAULT_TOUCH_SENSOR_ENABLED, true, "" },
+    { "touch.debounce",     RuntimeConfig::TYPE_UINT32, offsetof(RuntimeConfig::Values, touchDebounceMs),
+      10, 500, (uint32_t)TOUCH_SENSOR_DEBOUNCE_DELAY, false, "ms" },
+    { "touch.longpress",    RuntimeConfig::TYPE_UINT32, offsetof(RuntimeConfig::Values, touchLongPressMs),
+      100, 10000, (uint32_t)TOUCH_SENSOR_LONG_PRESS_DURATION, false, "ms" },
+    { "motor.clockwise",    RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, motorClockwise),
+      0, 1, DEFAULT_MOTOR_CLOCKWISE, true, "" },
+    { "schedule.tolerance", RuntimeConfig::TYPE_UINT16, offsetof(RuntimeConfig::Values, scheduleToleranceMinutes),
+      1, 120, FEEDING_SCHEDULE_TOLERANCE_MINUTES, true, "min" },
+    { "schedule.recovery",  RuntimeConfig::TYPE_UINT16, offsetof(RuntimeConfig::Values, scheduleRecoveryHours),
+      1, 72, FEEDING_SCHEDULE_MAX_RECOVERY_HOURS, true, "h" },
+    { "ntp.interval",       RuntimeConfig::TYPE_UINT32, offsetof(RuntimeConfig::Values, ntpIntervalMinutes),
+      1, 10080, (uint32_t)(NTP_SYNC_INTERVAL / 60000), true, "min" },
+    { "feed.agitate",       RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, agitateEnabled),
+      0, 1, DEFAULT_AGITATION_ENABLED, true, "" },
+    { "feed.agitate.duty",  RuntimeConfig::TYPE_UINT8,  offsetof(RuntimeConfig::Values, agitateDuty),
+      10, AGITATION_MAX_DUTY, DEFAULT_AGITATION_DUTY, true, "%" },
+    { "feed.profile",       RuntimeConfig::TYPE_UINT8,  offsetof(RuntimeConfig::Values, dispenseProfile),
+      0, DISPENSE_PROFILE_COUNT - 1, DEFAULT_DISPENSE_PROFILE, true, "" },
+    { "motor.speed",        RuntimeConfig::TYPE_UINT16, offsetof(RuntimeConfig::Values, motorSpeed),
+      100, AUTOTUNE_MAX_SPEED, (uint32_t)DEFAULT_MAX_SPEED, true, "steps/s" },
+    { "motor.accel",        RuntimeConfig::TYPE_UINT16, offsetof(RuntimeConfig::Values, motorAccel),
+      50, AUTOTUNE_MAX_ACCEL, (uint32_t)DEFAULT_ACCELERATION, true, "steps/s²" },
+    { "cpu.scaling",        RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, cpuScaling),
+      0, 1, DEFAULT_CPU_SCALING_ENABLED, true, "" },
+    { "input.record",       RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, inputRecord),
+      0, 1, DEFAULT_INPUT_RECORDING_ENABLED, true, "" },
+    { "watchdog.budget",    RuntimeConfig::TYPE_UINT16, offsetof(RuntimeConfig::Values, watchdogBudgetMs),
+      20, 10000, DEFAULT_LOOP_STALL_BUDGET_MS, true, "ms" },
+    { "watchdog.hw",        RuntimeConfig::TYPE_BOOL,   offsetof(RuntimeConfig::Values, watchdogHardware),
+      0, 1, DEFAULT_LOOP_WATCHDOG_HW, true, "" },
+};
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+/**
+ * Constructor: Values are filled in by begin()
+ * CONFIG_ENTRIES is initialized from defaults defined in config.cpp, so it may
+ * not be ready yet when global constructors run - don't read it here
+ */
+RuntimeConfig::RuntimeConfig()
+    : nvramReady(false), loadedFromNVRAM(false), listenerCount(0) {
+    memset(&values, 0, sizeof(values));
+    values.version = RUNTIME_CONFIG_VERSION;
+    for (uint8_t i = 0; i < RUNTIME_CONFIG_MAX_LISTENERS; i++) {
+        listeners[i] = nullptr;
+    }
+}
+
+/**
+ * Load settings from NVRAM with a single blob read
+ *
+ * @return: true if NVRAM is available
+ */
+bool RuntimeConfig::begin() {
+    applyDefaults(true);
+
+    if (!preferences.begin(RUNTIME_CONFIG_NVRAM_NAMESPACE, false)) {
+        Console::printlnR(F("RuntimeConfig: ERROR - Failed to open NVRAM, using defaults"));
+        nvramReady = false;
+        return false;
+    }
+    nvramReady = true;
+
+    // The layout only grows at the end, so a blob from any version holds a
+    // prefix of Values: take what it has, fields added since keep defaults
+    size_t length = preferences.isKey(RUNTIME_CONFIG_NVRAM_KEY) ?
+                    preferences.getBytesLength(RUNTIME_CONFIG_NVRAM_KEY) : 0;
+    if (length == 0) {
+        // First boot with the registry - pick up the old per-module keys
+        if (migrateLegacyKeys()) {
+            Console::printlnR(F("RuntimeConfig: Migrated settings from legacy NVRAM keys"));
+        } else {
+            Console::printlnR(F("RuntimeConfig: No stored settings, using defaults"));
+        }
+        clampAll();
+        save();
+        loadedFromNVRAM = false;
+        return true;
+    }
+
+    Values stored = values;
+    bool read;
+    if (length <= sizeof(Values)) {
+        read = preferences.getBytes(RUNTIME_CONFIG_NVRAM_KEY, &stored, length) == length;
+    } else {
+        // Written by a newer firmware: keep the fields this one knows
+        uint8_t* blob = (uint8_t*)malloc(length);
+        read = blob && preferences.getBytes(RUNTIME_CONFIG_NVRAM_KEY, blob, length) == length;
+        if (read) {
+            memcpy(&stored, blob, sizeof(Values));
+        }
+        free(blob);
+    }
+    if (!read) {
+        // Leave the blob alone, the next change rewrites it
+        Console::printlnR(F("RuntimeConfig: ERROR - Failed to read stored settings, using defaults"));
+        loadedFromNVRAM = false;
+        return true;
+    }
+
+    uint8_t storedVersion = stored.version;
+    values = stored;
+    values.version = RUNTIME_CONFIG_VERSION;
+    applyDefaults(false);  // Non-persistent settings always start from default
+    clampAll();
+    loadedFromNVRAM = true;
+
+    if (length < sizeof(Values)) {
+        Console::printlnR("RuntimeConfig: Settings loaded from NVRAM (version " + String(storedVersion) +
+                          ", upgraded to " + String(RUNTIME_CONFIG_VERSION) + ")");
+        save();
+    } else {
+        Console::printlnR(F("RuntimeConfig: Settings loaded from NVRAM"));
+    }
+    return true;
+}
+
+/**
+ * Reset settings to their defaults
+ *
+ * @param includePersistent: false to reset only non-persistent settings
+ */
+void RuntimeConfig::applyDefaults(bool includePersistent) {
+    for (uint8_t i = 0; i < CONFIG_COUNT; i++) {
+        const Entry& entry = CONFIG_ENTRIES[i];
+        if (includePersistent || !entry.persistent) {
+            writeField(entry, entry.defaultValue);
+        }
+    }
+}
+
+/**
+ * Read settings from the per-module keys used before the registry existed
+ * Namespaces are opened read-only and left in place
+ *
+ * @return: true if any legacy value was found
+ */
+bool RuntimeConfig::migrateLegacyKeys() {
+    bool migrated = false;
+    Preferences legacy;
+
+    if (legacy.begin("touch", true)) {
+        if (legacy.isKey(TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY)) {
+            values.touchPortions = legacy.getUChar(TOUCH_LONG_PRESS_PORTIONS_NVRAM_KEY, DEFAULT_TOUCH_LONG_PRESS_PORTIONS);
+            migrated = true;
+        }
+        if (legacy.isKey(TOUCH_SENSOR_ENABLED_NVRAM_KEY)) {
+            values.touchEnabled = legacy.getBool(TOUCH_SENSOR_ENABLED_NVRAM_KEY, DEFAULT_TOUCH_SENSOR_ENABLED);
+            migrated = true;
+        }
+        legacy.end();
+    }
+
+    if (legacy.begin("motor", true)) {
+        if (legacy.isKey(MOTOR_DIRECTION_NVRAM_KEY)) {
+            values.motorClockwise = legacy.getBool(MOTOR_DIRECTION_NVRAM_KEY, DEFAULT_MOTOR_CLOCKWISE);
+            migrated = true;
+        }
+        legacy.end();
+    }
+
+    return migrated;
+}
+
+/**
+ * Write the whole blob (one NVRAM write)
+ */
+void RuntimeConfig::save() {
+    if (!nvramReady) {
+        return;
+    }
+    TraceBuffer::begin(TraceBuffer::NVS_COMMIT, "config");
+    size_t written = preferences.putBytes(RUNTIME_CONFIG_NVRAM_KEY, &values, sizeof(Values));
+    TraceBuffer::end(TraceBuffer::NVS_COMMIT);
+    if (written != sizeof(Values)) {
+        Console::printlnR(F("RuntimeConfig: ERROR - Failed to save settings to NVRAM"));
+    }
+}
+
+/**
+ * Force every value into its registered range (guards against corrupt blobs)
+ */
+void RuntimeConfig::clampAll() {
+    for (uint8_t i = 0; i < CONFIG_COUNT; i++) {
+        const Entry& entry = CONFIG_ENTRIES[i];
+        uint32_t value = readField(entry);
+        if (value < entry.minValue || value > entry.maxValue) {
+            writeField(entry, entry.defaultValue);
+        }
+    }
+}
+
+// ============================================================================
+// FIELD ACCESS
+// ============================================================================
+
+uint32_t RuntimeConfig::readField(const Entry& entry) const {
+    const uint8_t* field = reinterpret_cast<const uint8_t*>(&values) + entry.offset;
+    switch (entry.type) {
+        case TYPE_BOOL:
+        case TYPE_UINT8:
+            return *field;
+        case TYPE_UINT16: {
+            uint16_t value;
+            memcpy(&value, field, sizeof(value));
+            return value;
+        }
+        case TYPE_UINT32: {
+            uint32_t value;
+            memcpy(&value, field, sizeof(value));
+            return value;
+        }
+    }
+    return 0;
+}
+
+void RuntimeConfig::writeField(const Entry& entry, uint32_t value) {
+    uint8_t* field = reinterpret_cast<uint8_t*>(&values) + entry.offset;
+    switch (entry.type) {
+        case TYPE_BOOL:
+            *field = value ? 1 : 0;
+            break;
+        case TYPE_UINT8:
+            *field = (uint8_t)value;
+            break;
+        case TYPE_UINT16: {
+            uint16_t narrow = (uint16_t)value;
+            memcpy(field, &narrow, sizeof(narrow));
+            break;
+        }
+        case TYPE_UINT32:
+            memcpy(field, &value, sizeof(value));
+            break;
+    }
+}
+
+/**
+ * Store a validated value, persist it and notify listeners if it changed
+ */
+void RuntimeConfig::store(Id id, uint32_t value) {
+    const Entry& entry = CONFIG_ENTRIES[id];
+    if (readField(entry) == value) {
+        return;
+    }
+
+    writeField(entry, value);
+    if (entry.persistent) {
+        save();
+    }
+
+    for (uint8_t i = 0; i < listenerCount; i++) {
+        listeners[i](id);
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool RuntimeConfig::addListener(ChangeCallback callback) {
+    if (!callback || listenerCount >= RUNTIME_CONFIG_MAX_LISTENERS) {
+        return false;
+    }
+    listeners[listenerCount++] = callback;
+    return true;
+}
+
+bool RuntimeConfig::getBool(Id id) const {
+    return readField(CONFIG_ENTRIES[id]) != 0;
+}
+
+uint32_t RuntimeConfig::getInt(Id id) const {
+    return readField(CONFIG_ENTRIES[id]);
+}
+
+bool RuntimeConfig::setBool(Id id, bool value) {
+    if (id >= CONFIG_COUNT || CONFIG_ENTRIES[id].type != TYPE_BOOL) {
+        return false;
+    }
+    store(id, value ? 1 : 0);
+    return true;
+}
+
+bool RuntimeConfig::setInt(Id id, uint32_t value) {
+    if (id >= CONFIG_COUNT || CONFIG_ENTRIES[id].type == TYPE_BOOL) {
+        return false;
+    }
+    const Entry& entry = CONFIG_ENTRIES[id];
+    if (value < entry.minValue || value > entry.maxValue) {
+        return false;
+    }
+    store(id, value);
+    return true;
+}
+
+bool RuntimeConfig::setFromString(Id id, const String& text) {
+    if (id >= CONFIG_COUNT) {
+        return false;
+    }
+
+    String value = text;
+    value.trim();
+    value.toUpperCase();
+    if (value.length() == 0) {
+        return false;
+    }
+
+    if (CONFIG_ENTRIES[id].type == TYPE_BOOL) {
+        if (value == "TRUE" || value == "ON" || value == "1") {
+            return setBool(id, true);
+        }
+        if (value == "FALSE" || value == "OFF" || value == "0") {
+            return setBool(id, false);
+        }
+        return false;
+    }
+
+    // Digits only - toInt() would silently turn garbage into 0
+    for (unsigned int i = 0; i < value.length(); i++) {
+        if (!isDigit(value[i])) {
+            return false;
+        }
+    }
+    if (value.length() > 10) {
+        return false;
+    }
+    return setInt(id, (uint32_t)strtoul(value.c_str(), nullptr, 10));
+}
+
+void RuntimeConfig::resetToDefault(Id id) {
+    if (id >= CONFIG_COUNT) {
+        return;
+    }
+    store(id, CONFIG_ENTRIES[id].defaultValue);
+}
+
+bool RuntimeConfig::findByName(const String& name, Id& id) const {
+    for (uint8_t i = 0; i < CONFIG_COUNT; i++) {
+        if (name.equalsIgnoreCase(CONFIG_ENTRIES[i].name)) {
+            id = (Id)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const RuntimeConfig::Entry& RuntimeConfig::getEntry(Id id) {
+    return CONFIG_ENTRIES[id < CONFIG_COUNT ? id : 0];
+}
+
+String RuntimeConfig::formatValue(Id id) const {
+    const Entry& entry = CONFIG_ENTRIES[id];
+    if (entry.type == TYPE_BOOL) {
+        return getBool(id) ? "true" : "false";
+    }
+    return String(getInt(id));
+}
+
+void RuntimeConfig::printAll() const {
+    Console::printlnR(F("=== RUNTIME CONFIGURATION ==="));
+    for (uint8_t i = 0; i < CONFIG_COUNT; i++) {
+        const Entry& entry = CONFIG_ENTRIES[i];
+        String line = "  " + String(entry.name);
+        while (line.length() < 22) {
+            line += ' ';
+        }
+        line += "= " + formatValue((Id)i);
+        if (entry.unit[0] != '\0') {
+            line += " " + String(entry.unit);
+        }
+        if (entry.type != TYPE_BOOL) {
+            line += "  [" + String(entry.minValue) + "-" + String(entry.maxValue) + "]";
+        }
+        if (!entry.persistent) {
+            line += "  (session only)";
+        }
+        Console::printlnR(line);
+    }
+    Console::printR(F("Source: "));
+    Console::printlnR(loadedFromNVRAM ? F("NVRAM") : F("defaults"));
+    Console::printlnR(F("============================="));
+}
+
+bool RuntimeConfig::isLoadedFromNVRAM() const {
+    return loadedFromNVRAM;
+}
@@ -0,0 +1,222 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+/**
+ * Runtime Configuration Registry
+ *
+ * Central typed registry for user settings that can change while running.
+ * Every setting has a fixed id, a type, a valid range, a default and a
+ * persistence flag (see the entry table in runtime_config.cpp).
+ *
+ * Storage:
+ * - All values live in one packed struct (Values)
+ * - Persistent values are saved as a single NVRAM blob and loaded with
+ *   one read at boot; non-persistent values start from their default
+ * - Values only grows at the end: a blob written by an older firmware is
+ *   a prefix of the current layout, so its fields are kept and only the
+ *   fields added since start from their default (the blob is then
+ *   rewritten at the current size)
+ * - Settings from the old per-module keys ("touch", "motor" namespaces)
+ *   are migrated once when no blob exists yet
+ *
+ * Access:
+ * - getBool/getInt by id are O(1) (table lookup + field read)
+ * - set* validates type and range, saves the blob if the entry is
+ *   persistent and notifies listeners only when the value changed
+ * - Name lookup and string parsing serve CONFIG GET/SET and /api/config
+ *
+ * Adding a setting:
+ * 1. Add an Id before CONFIG_COUNT
+ * 2. Append its field to the end of Values (bump RUNTIME_CONFIG_VERSION
+ *    in config.h); never reorder, resize or remove a field, stored blobs
+ *    depend on the offsets
+ * 3. Add its entry to the table in runtime_config.cpp
+ */
+class RuntimeConfig {
+public:
+    /**
+     * Setting identifiers (index into the entry table)
+     */
+    enum Id : uint8_t {
+        CONFIG_TOUCH_PORTIONS,        // Portions dispensed on touch long press
+        CONFIG_TOUCH_ENABLED,         // Touch sensor triggers feeding/vibration
+        CONFIG_TOUCH_DEBOUNCE,        // Touch debounce delay (ms)
+        CONFIG_TOUCH_LONG_PRESS,      // Touch long press duration (ms)
+        CONFIG_MOTOR_CLOCKWISE,       // Feeding rotation direction
+        CONFIG_SCHEDULE_TOLERANCE,    // Missed feeding tolerance (minutes)
+        CONFIG_SCHEDULE_RECOVERY,     // Power loss recovery window (hours)
+        CONFIG_NTP_INTERVAL,          // NTP sync interval (minutes)
+        CONFIG_AGITATE_ENABLED,       // Hopper agitation during feeding
+        CONFIG_AGITATE_DUTY,          // Hopper agitation duty (%)
+        CONFIG_DISPENSE_PROFILE,      // Dispense profile (index into DISPENSE_PROFILES)
+        CONFIG_MOTOR_SPEED,           // Motor max speed (steps/s, MOTOR AUTOTUNE result)
+        CONFIG_MOTOR_ACCEL,           // Motor acceleration (steps/s², MOTOR AUTOTUNE result)
+        CONFIG_CPU_SCALING,           // CPU frequency scaling (idle low, boost for web)
+        CONFIG_INPUT_RECORD,          // Record inputs to flash for replay
+        CONFIG_WATCHDOG_BUDGET,       // Loop stall budget (ms)
+        CONFIG_WATCHDOG_HW,           // Escalate loop hangs to the hardware task watchdog
+        CONFIG_COUNT
+    };
+
+    /**
+     * Storage type of a setting
+     */
+    enum Type : uint8_t {
+        TYPE_BOOL,
+        TYPE_UINT8,
+        TYPE_UINT16,
+        TYPE_UINT32
+    };
+
+    /**
+     * Registry entry (one per Id, stored in flash)
+     */
+    struct Entry {
+        const char* name;         // Lowercase dotted name used by CONFIG and /api/config
+        Type type;                // Storage type
+        uint8_t offset;           // Field offset in Values
+        uint32_t minValue;        // Inclusive range
+        uint32_t maxValue;
+        uint32_t defaultValue;
+        bool persistent;          // Saved in NVRAM
+        const char* unit;         // Display unit ("" if none)
+    };
+
+    /**
+     * Packed settings blob (exact NVRAM layout, append new fields only)
+     */
+    struct __attribute__((packed)) Values {
+        uint8_t version;
+        uint8_t touchPortions;
+        bool touchEnabled;
+        uint32_t touchDebounceMs;
+        uint32_t touchLongPressMs;
+        bool motorClockwise;
+        uint16_t scheduleToleranceMinutes;
+        uint16_t scheduleRecoveryHours;
+        uint32_t ntpIntervalMinutes;
+        bool agitateEnabled;
+        uint8_t agitateDuty;
+        uint8_t dispenseProfile;
+        uint16_t motorSpeed;
+        uint16_t motorAccel;
+        bool cpuScaling;
+        bool inputRecord;
+        uint16_t watchdogBudgetMs;
+        bool watchdogHardware;
+    };
+
+    /**
+     * Change listener
+     *
+     * Function signature: void callback(Id id)
+     * Called after the new value is stored, so getters return the new value
+     */
+    typedef void (*ChangeCallback)(Id id);
+
+    /**
+     * Constructor - call begin() before reading any setting
+     */
+    RuntimeConfig();
+
+    /**
+     * Load all settings from NVRAM (single blob read)
+     * Blobs from older versions keep their fields; new fields start from default
+     * Falls back to legacy keys if no blob exists yet
+     *
+     * @return: true if NVRAM is available
+     */
+    bool begin();
+
+    /**
+     * Register a change listener
+     *
+     * @param callback: Function called when any setting changes
+     * @return: true if registered, false if the listener table is full
+     */
+    bool addListener(ChangeCallback callback);
+
+    // Typed access (O(1) by id)
+    bool getBool(Id id) const;
+    uint32_t getInt(Id id) const;
+
+    /**
+     * Set a boolean setting
+     *
+     * @return: false if the id is not boolean
+     */
+    bool setBool(Id id, bool value);
+
+    /**
+     * Set an integer setting
+     *
+     * @return: false if the id is boolean or the value is out of range
+     */
+    bool setInt(Id id, uint32_t value);
+
+    /**
+     * Parse and set a value from text (CONFIG SET, /api/config)
+     * Booleans accept TRUE/FALSE, ON/OFF, 1/0 (case-insensitive)
+     *
+     * @param id: Setting id
+     * @param text: Value as text
+     * @return: true if parsed, in range and stored
+     */
+    bool setFromString(Id id, const String& text);
+
+    /**
+     * Restore a setting to its default value
+     */
+    void resetToDefault(Id id);
+
+    /**
+     * Find a setting by name (case-insensitive)
+     *
+     * @param name: Entry name, e.g. "touch.portions"
+     * @param id: Receives the id when found
+     * @return: true if found
+     */
+    bool findByName(const String& name, Id& id) const;
+
+    /**
+     * Get registry entry metadata
+     */
+    static const Entry& getEntry(Id id);
+
+    /**
+     * Get a value as text ("true"/"false" or decimal)
+     */
+    String formatValue(Id id) const;
+
+    /**
+     * Print all settings with range and persistence flag
+     */
+    void printAll() const;
+
+    /**
+     * @return: true if the last begin() loaded values from the NVRAM blob
+     */
+    bool isLoadedFromNVRAM() const;
+
+private:
+    Values values;
+    Preferences preferences;
+    bool nvramReady;
+    bool loadedFromNVRAM;
+    ChangeCallback listeners[RUNTIME_CONFIG_MAX_LISTENERS];
+    uint8_t listenerCount;
+
+    void applyDefaults(bool includePersistent);
+    bool migrateLegacyKeys();
+    void save();
+    void clampAll();
+    uint32_t readField(const Entry& entry) const;
+    void writeField(const Entry& entry, uint32_t value);
+    void store(Id id, uint32_t value);
+};
+
+#endif // RUNTIME_CONFIG_H
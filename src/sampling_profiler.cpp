@@ -0,0 +1,277 @@
+#include "sampling_profiler.h"
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/xtensa_context.h>
+
+/**
+ * Sampling Profiler Implementation
+ *
+ * The timer interrupt is allocated on the core that calls start() (the
+ * loop task's core, commands run there). On interrupt entry FreeRTOS
+ * stores the interrupted task's stack pointer - which points at its
+ * XtExcFrame - in pxTopOfStack, the first field of the task control block,
+ * so the ISR reads PC and a0 from there without unwinding.
+ */
+
+SamplingProfiler* SamplingProfiler::activeInstance = nullptr;
+
+// Interrupt nesting per core, kept by the Xtensa FreeRTOS port (port.c).
+// Bound by symbol name: IDF versions differ on whether and how their
+// headers declare it
+extern "C" volatile unsigned profilerInterruptNesting[portNUM_PROCESSORS] asm("port_interruptNesting");
+
+namespace {
+
+/**
+ * Print adapter that base64-encodes everything written through it
+ * (76 characters per line)
+ */
+class Base64Writer : public Print {
+public:
+    explicit Base64Writer(Print& out) : out(out), pending(0), pendingCount(0), column(0) {}
+
+    size_t write(uint8_t c) override {
+        pending = (pending << 8) | c;
+        if (++pendingCount == 3) {
+            emit(3);
+        }
+        return 1;
+    }
+    using Print::write;
+
+    // Encode the last partial group with padding and end the line
+    void finish() {
+        if (pendingCount > 0) {
+            pending <<= 8 * (3 - pendingCount);
+            emit(pendingCount);
+        }
+        if (column > 0) {
+            out.println();
+        }
+    }
+
+private:
+    Print& out;
+    uint32_t pending;
+    uint8_t pendingCount;
+    uint8_t column;
+
+    void emit(uint8_t bytes) {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        char quad[4];
+        for (uint8_t i = 0; i < 4; i++) {
+            quad[i] = i <= bytes ? ALPHABET[(pending >> (18 - 6 * i)) & 0x3F] : '=';
+        }
+        out.write((const uint8_t*)quad, 4);
+        pending = 0;
+        pendingCount = 0;
+
+        column += 4;
+        if (column >= 76) {
+            out.println();
+            column = 0;
+        }
+    }
+};
+
+void writeU16(Print& out, uint16_t value) {
+    uint8_t bytes[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    out.write(bytes, 2);
+}
+
+void writeU32(Print& out, uint32_t value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    out.write(bytes, 4);
+}
+
+} // namespace
+
+SamplingProfiler::SamplingProfiler()
+    : timer(nullptr),
+      ring(nullptr),
+      rateHz(0),
+      running(false),
+      totalSamples(0),
+      skippedSamples(0) {
+}
+
+/**
+ * Clear the ring and start sampling
+ *
+ * @param hz: Sample rate (1 to PROFILER_MAX_HZ)
+ * @return: true if started
+ */
+bool SamplingProfiler::start(uint16_t hz) {
+    if (running) {
+        return false;
+    }
+    if (hz == 0 || hz > PROFILER_MAX_HZ) {
+        return false;
+    }
+    if (!ring) {
+        ring = (Sample*)malloc(PROFILER_SAMPLE_CAPACITY * sizeof(Sample));
+        if (!ring) {
+            return false;
+        }
+    }
+
+    rateHz = hz;
+    totalSamples = 0;
+    skippedSamples = 0;
+    activeInstance = this;
+
+    // 80 MHz APB / 80 = 1 MHz timer ticks (APB is fixed, see CpuGovernor)
+    timer = timerBegin(PROFILER_TIMER, 80, true);
+    if (!timer) {
+        activeInstance = nullptr;
+        return false;
+    }
+    timerAttachInterrupt(timer, &SamplingProfiler::onTimer, true);
+    timerAlarmWrite(timer, 1000000UL / hz, true);
+    timerAlarmEnable(timer);
+    running = true;
+    return true;
+}
+
+/**
+ * Stop sampling (the ring is kept for dumping)
+ */
+void SamplingProfiler::stop() {
+    if (!running) {
+        return;
+    }
+    timerAlarmDisable(timer);
+    timerDetachInterrupt(timer);
+    timerEnd(timer);
+    timer = nullptr;
+    activeInstance = nullptr;
+    running = false;
+}
+
+bool SamplingProfiler::isRunning() const {
+    return running;
+}
+
+/**
+ * Timer interrupt entry (the Arduino timer API passes no argument)
+ */
+void IRAM_ATTR SamplingProfiler::onTimer() {
+    SamplingProfiler* profiler = activeInstance;
+    if (profiler) {
+        profiler->capture();
+    }
+}
+
+/**
+ * Record the interrupted task's PC and caller
+ */
+void IRAM_ATTR SamplingProfiler::capture() {
+    // Only the outermost interrupt has the task frame in pxTopOfStack. This
+    // ISR itself counts as one level, so more than one means it interrupted
+    // another ISR (xPortInterruptedFromISRContext() is true in every ISR)
+    if (profilerInterruptNesting[xPortGetCoreID()] > 1) {
+        skippedSamples = skippedSamples + 1;
+        return;
+    }
+
+    const XtExcFrame* frame = *(const XtExcFrame* const*)xTaskGetCurrentTaskHandle();
+    uint32_t index = totalSamples;
+    Sample& sample = ring[index % PROFILER_SAMPLE_CAPACITY];
+    sample.pc = frame->pc;
+
+    // Windowed call return address: top bits hold the window size, the
+    // call instruction is 3 bytes before it
+    uint32_t a0 = frame->a0;
+    sample.caller = (a0 & 0xC0000000) ? ((a0 & 0x3FFFFFFF) | 0x40000000) - 3 : 0;
+
+    totalSamples = index + 1;
+}
+
+/**
+ * @return: Samples held in the ring
+ */
+uint32_t SamplingProfiler::getSampleCount() const {
+    uint32_t total = totalSamples;
+    return total < PROFILER_SAMPLE_CAPACITY ? total : PROFILER_SAMPLE_CAPACITY;
+}
+
+/**
+ * @return: Samples taken since start (including overwritten ones)
+ */
+uint32_t SamplingProfiler::getTotalSamples() const {
+    return totalSamples;
+}
+
+/**
+ * @return: Dump size in bytes
+ */
+size_t SamplingProfiler::getDumpSize() const {
+    return DUMP_HEADER_SIZE + getSampleCount() * 8;
+}
+
+/**
+ * Write the binary dump (call while stopped)
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ * @return: Bytes written
+ */
+size_t SamplingProfiler::writeDump(Print& out) const {
+    uint32_t total = totalSamples;
+    uint32_t count = getSampleCount();
+
+    out.write((const uint8_t*)"FFPS", 4);
+    out.write(DUMP_VERSION);
+    out.write((uint8_t)0);
+    writeU16(out, rateHz);
+    writeU32(out, count);
+    writeU32(out, total);
+
+    // Oldest first: after a wrap the oldest sample is at the write index
+    uint32_t first = total > PROFILER_SAMPLE_CAPACITY ? total % PROFILER_SAMPLE_CAPACITY : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const Sample& sample = ring[(first + i) % PROFILER_SAMPLE_CAPACITY];
+        writeU32(out, sample.pc);
+        writeU32(out, sample.caller);
+    }
+    return getDumpSize();
+}
+
+/**
+ * Write the dump as base64 lines between BEGIN/END markers (serial)
+ *
+ * @param out: Destination
+ */
+void SamplingProfiler::printDumpBase64(Print& out) const {
+    out.println(F("-----BEGIN PROFILE-----"));
+    Base64Writer encoder(out);
+    writeDump(encoder);
+    encoder.finish();
+    out.println(F("-----END PROFILE-----"));
+}
+
+/**
+ * Print state, rate and sample counts
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void SamplingProfiler::printStatus(Print& out) const {
+    out.println(F("Sampling Profiler Status:"));
+    out.print(F("  Running: "));
+    out.println(running ? "YES" : "NO");
+    out.print(F("  Rate: "));
+    out.print(rateHz);
+    out.println(F(" Hz"));
+    out.print(F("  Samples: "));
+    out.print(getSampleCount());
+    out.print(F(" in ring ("));
+    out.print(PROFILER_SAMPLE_CAPACITY);
+    out.print(F(" max), "));
+    out.print(getTotalSamples());
+    out.println(F(" taken"));
+    out.print(F("  Skipped (in ISR): "));
+    out.println((uint32_t)skippedSamples);
+    out.print(F("  Dump Size: "));
+    out.print((uint32_t)getDumpSize());
+    out.println(F(" bytes"));
+}
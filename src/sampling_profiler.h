@@ -0,0 +1,106 @@
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <Arduino.h>
+
+/**
+ * Statistical Sampling Profiler
+ *
+ * A hardware timer interrupt samples the code running on the loop task's
+ * core (TaskScheduler tasks, WiFiManager/WebServer, String handling) at
+ * a fixed rate. Each sample is the interrupted PC and the return address
+ * of that function (a0), read from the exception frame FreeRTOS saved on
+ * the interrupted task's stack.
+ *
+ * Dump format (little endian), symbolized on the host by
+ * tools/profile_symbolize.py against the firmware ELF:
+ *   Header: "FFPS", version (1), reserved, rate in Hz (u16),
+ *           sample count (u32), samples taken incl. overwritten (u32)
+ *   Samples: count x { pc (u32), caller (u32, 0 = unknown) }, oldest first
+ *
+ * Overhead at 1 kHz is a few microseconds per millisecond; the ring is
+ * only allocated on the first start.
+ */
+class SamplingProfiler {
+public:
+    /**
+     * One captured sample
+     */
+    struct Sample {
+        uint32_t pc;
+        uint32_t caller;
+    };
+
+    static const uint8_t DUMP_VERSION = 1;
+    static const size_t DUMP_HEADER_SIZE = 16;
+
+    SamplingProfiler();
+
+    /**
+     * Clear the ring and start sampling
+     *
+     * @param hz: Sample rate (1 to PROFILER_MAX_HZ)
+     * @return: true if started
+     */
+    bool start(uint16_t hz);
+
+    /**
+     * Stop sampling (the ring is kept for dumping)
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @return: Samples held in the ring
+     */
+    uint32_t getSampleCount() const;
+
+    /**
+     * @return: Samples taken since start (including overwritten ones)
+     */
+    uint32_t getTotalSamples() const;
+
+    /**
+     * @return: Dump size in bytes
+     */
+    size_t getDumpSize() const;
+
+    /**
+     * Write the binary dump (call while stopped)
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     * @return: Bytes written
+     */
+    size_t writeDump(Print& out) const;
+
+    /**
+     * Write the dump as base64 lines between BEGIN/END markers (serial)
+     *
+     * @param out: Destination
+     */
+    void printDumpBase64(Print& out) const;
+
+    /**
+     * Print state, rate and sample counts
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+private:
+    hw_timer_t* timer;
+    Sample* ring;
+    uint16_t rateHz;
+    bool running;
+
+    // Written by the ISR only while running
+    volatile uint32_t totalSamples;
+    volatile uint32_t skippedSamples;   // No task frame (interrupted an ISR)
+
+    static SamplingProfiler* activeInstance;
+    static void onTimer();
+    void capture();
+};
+
+#endif // SAMPLING_PROFILER_H
@@ -0,0 +1,118 @@
+#include "schedule_calendar.h"
+#include "time_zone.h"
+
+static const uint32_t SECONDS_PER_DAY = 86400UL;
+
+ScheduleCalendar::ScheduleCalendar()
+    : zone(nullptr),
+      midnightAnchor(0),
+      anchorStartUtc(0),
+      anchorEndUtc(0),
+      anchorZoneGeneration(0) {
+}
+
+void ScheduleCalendar::setTimezone(TimeZone* newZone) {
+    zone = newZone;
+    midnightAnchor = 0;
+}
+
+uint32_t ScheduleCalendar::toLocal(uint32_t utc) {
+    return zone ? zone->toLocal(utc) : utc;
+}
+
+uint32_t ScheduleCalendar::toUtc(uint32_t local) {
+    return zone ? zone->toUtc(local) : local;
+}
+
+uint32_t ScheduleCalendar::localMidnight(uint32_t utc) {
+    uint32_t local = toLocal(utc);
+    return local - (local % SECONDS_PER_DAY);
+}
+
+/**
+ * Recompute the cached start of day only when the clock has left the
+ * current local day (day rollover, RTC set, or time zone changed)
+ */
+void ScheduleCalendar::refreshAnchor(uint32_t now) {
+    uint16_t generation = zone ? zone->getGeneration() : 0;
+
+    if (midnightAnchor != 0 && generation == anchorZoneGeneration &&
+        now >= anchorStartUtc && now < anchorEndUtc) {
+        return;
+    }
+
+    midnightAnchor = localMidnight(now);
+    anchorStartUtc = toUtc(midnightAnchor);
+    anchorEndUtc = toUtc(midnightAnchor + SECONDS_PER_DAY);
+    anchorZoneGeneration = generation;
+}
+
+uint32_t ScheduleCalendar::secondsOfDay(const ScheduledFeeding& schedule) {
+    return (uint32_t)schedule.hour * 3600UL + (uint32_t)schedule.minute * 60UL + schedule.second;
+}
+
+uint32_t ScheduleCalendar::scheduleEpoch(uint32_t dayStart, const ScheduledFeeding& schedule) {
+    return toUtc(dayStart + secondsOfDay(schedule));
+}
+
+int8_t ScheduleCalendar::findNext(const ScheduledFeeding* schedules, uint8_t count, uint32_t now, uint32_t& nextEpoch) {
+    int8_t index = -1;
+    nextEpoch = 0;
+
+    refreshAnchor(now);
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (!schedules[i].enabled) continue;
+
+        uint32_t candidate = scheduleEpoch(midnightAnchor, schedules[i]);
+
+        // Already passed today - next occurrence is tomorrow
+        if (candidate <= now) {
+            candidate = scheduleEpoch(midnightAnchor + SECONDS_PER_DAY, schedules[i]);
+        }
+
+        if (nextEpoch == 0 || candidate < nextEpoch) {
+            nextEpoch = candidate;
+            index = i;
+        }
+    }
+    return index;
+}
+
+int8_t ScheduleCalendar::findMissed(const ScheduledFeeding* schedules, uint8_t count, uint32_t now, uint32_t lastCompleted,
+                                    uint16_t toleranceMinutes, uint16_t maxRecoveryHours, uint32_t& missedEpoch) {
+    uint32_t toleranceSpan = (uint32_t)toleranceMinutes * 60UL;
+    uint32_t recoverySpan = (uint32_t)maxRecoveryHours * 3600UL;
+    uint32_t recoveryStart = now > recoverySpan ? now - recoverySpan : 0;
+
+    // Nothing older than the tolerance can qualify, so only the days
+    // spanned by [max(last feeding, now - tolerance), now] are checked
+    uint32_t searchStart = now > toleranceSpan ? now - toleranceSpan : 0;
+    if (searchStart < lastCompleted) {
+        searchStart = lastCompleted;
+    }
+    if (searchStart >= now) {
+        return -1;
+    }
+
+    uint32_t lastDay = localMidnight(now);
+    for (uint32_t day = localMidnight(searchStart); day <= lastDay; day += SECONDS_PER_DAY) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (!schedules[i].enabled) continue;
+
+            uint32_t scheduleTime = scheduleEpoch(day, schedules[i]);
+
+            // Skip future schedules, already-covered ones and anything
+            // before the maximum recovery period
+            if (scheduleTime >= now || scheduleTime <= lastCompleted || scheduleTime < recoveryStart) continue;
+
+            uint32_t minutesPast = (now - scheduleTime) / 60;
+            if (minutesPast > 1 && minutesPast <= toleranceMinutes) {
+                missedEpoch = scheduleTime;
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
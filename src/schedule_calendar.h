@@ -0,0 +1,110 @@
+#ifndef SCHEDULE_CALENDAR_H
+#define SCHEDULE_CALENDAR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class TimeZone;
+
+/**
+ * ScheduleCalendar Class
+ *
+ * Epoch-second arithmetic of the feeding schedule: when each schedule
+ * falls on a local day, which one comes next and which missed one can
+ * still be recovered. FeedingSchedule owns one and adds the NVRAM,
+ * console and feeding side; this part only needs a TimeZone, so it is
+ * exercised (and benchmarked) on the host.
+ *
+ * Time handling:
+ * - Instants are uint32_t UTC epoch seconds; schedules are seconds-of-day
+ *   on the local wall clock
+ * - The start of the current local day is cached and recomputed only when
+ *   the clock leaves that day or the zone changes
+ * - Tomorrow is today's local midnight + 24h (no calendar math at month or
+ *   year end); DST is handled by the local -> UTC conversion, so a
+ *   schedule in the skipped hour fires just after the jump and one in the
+ *   repeated hour fires at its first occurrence
+ */
+class ScheduleCalendar {
+public:
+    ScheduleCalendar();
+
+    /**
+     * @param zone: Local time zone (nullptr = local time is UTC)
+     */
+    void setTimezone(TimeZone* zone);
+
+    uint32_t toLocal(uint32_t utc);
+    uint32_t toUtc(uint32_t local);
+
+    /**
+     * Start of the local day containing an instant
+     *
+     * @param utc: Time in UTC epoch seconds
+     * @return: Local midnight as local epoch seconds
+     */
+    uint32_t localMidnight(uint32_t utc);
+
+    /**
+     * Recompute the cached start of day if now is outside it
+     *
+     * @param now: Current time in UTC epoch seconds
+     */
+    void refreshAnchor(uint32_t now);
+
+    /**
+     * @return: Cached start of the current local day, local epoch (0 until first use)
+     */
+    uint32_t getMidnightAnchor() const { return midnightAnchor; }
+
+    /**
+     * Schedule time as seconds since the start of the day
+     */
+    static uint32_t secondsOfDay(const ScheduledFeeding& schedule);
+
+    /**
+     * UTC time of a schedule on a given local day
+     *
+     * @param dayStart: Local midnight (local epoch seconds)
+     * @param schedule: Schedule entry (local wall clock time)
+     * @return: UTC epoch seconds
+     */
+    uint32_t scheduleEpoch(uint32_t dayStart, const ScheduledFeeding& schedule);
+
+    /**
+     * Find the next enabled schedule strictly after now (today or tomorrow)
+     *
+     * @param schedules: Schedule entries
+     * @param count: Number of entries
+     * @param now: Current time in UTC epoch seconds
+     * @param nextEpoch: Set to its UTC time (0 if none)
+     * @return: Schedule index, or -1 if no schedule is enabled
+     */
+    int8_t findNext(const ScheduledFeeding* schedules, uint8_t count, uint32_t now, uint32_t& nextEpoch);
+
+    /**
+     * Find the earliest missed feeding that can still be recovered
+     * A schedule qualifies if it lies after the last completed feeding,
+     * inside the recovery window, and 1 < minutes past <= tolerance
+     *
+     * @param schedules: Schedule entries
+     * @param count: Number of entries
+     * @param now: Current time in UTC epoch seconds
+     * @param lastCompleted: Last completed feeding, UTC epoch seconds
+     * @param toleranceMinutes: How late a feeding may still be recovered
+     * @param maxRecoveryHours: Recovery look-back limit
+     * @param missedEpoch: Set to the missed schedule time when found
+     * @return: Schedule index, or -1 if nothing to recover
+     */
+    int8_t findMissed(const ScheduledFeeding* schedules, uint8_t count, uint32_t now, uint32_t lastCompleted,
+                      uint16_t toleranceMinutes, uint16_t maxRecoveryHours, uint32_t& missedEpoch);
+
+private:
+    TimeZone* zone;
+    uint32_t midnightAnchor;        // Start of the current local day, local epoch (0 until first use)
+    uint32_t anchorStartUtc;        // UTC range of the anchored day
+    uint32_t anchorEndUtc;
+    uint16_t anchorZoneGeneration;  // Time zone generation the anchor was computed with
+};
+
+#endif // SCHEDULE_CALENDAR_H
@@ -0,0 +1,566 @@
+#include "series_store.h"
+#include "console_manager.h"
+#include "loop_watchdog.h"
+#include <rom/crc.h>
+
+/**
+ * Time-Series Store Implementation
+ *
+ * Slot data is stored tier by tier, and within a tier series by series, so
+ * every series of a tier is one ring that /api/series can send in two runs.
+ * Samples arrive on the loop task (series task), so no locking is needed.
+ */
+
+namespace {
+
+const char CHECKPOINT_MAGIC[4] = { 'F', 'F', 'T', 'C' };
+const uint8_t CHECKPOINT_VERSION = 1;
+const char BINARY_MAGIC[4] = { 'F', 'F', 'T', 'S' };
+const uint8_t BINARY_VERSION = 1;
+
+// Anything earlier is an RTC that lost its time
+const uint32_t MIN_VALID_UTC = 1577836800UL;   // 2020-01-01
+
+// A larger step back means the history was recorded with a wrong clock
+const uint32_t MAX_BACKWARD_MINUTES = 60;
+
+const SeriesStore::SeriesInfo SERIES_INFO[SeriesStore::SERIES_COUNT] = {
+    { "heap_free_kb",     "Free heap",                 "KB",       0.1f,  1, SeriesStore::KIND_GAUGE },
+    { "loop_latency_ms",  "Longest loop pass",         "ms",       0.1f,  1, SeriesStore::KIND_GAUGE },
+    { "rssi_dbm",         "WiFi signal",               "dBm",      1.0f,  0, SeriesStore::KIND_GAUGE },
+    { "rtc_temperature_c", "RTC temperature",          "°C",       0.01f, 2, SeriesStore::KIND_GAUGE },
+    { "feeds",            "Feedings",                  "feedings", 1.0f,  0, SeriesStore::KIND_COUNT },
+    { "ntp_offset_s",     "NTP offset (NTP - RTC)",    "s",        1.0f,  0, SeriesStore::KIND_GAUGE }
+};
+
+const SeriesStore::TierInfo TIER_INFO[SeriesStore::TIER_COUNT] = {
+    { "minute", 60,    SERIES_MINUTE_SLOTS, 1 },
+    { "hour",   3600,  SERIES_HOUR_SLOTS,   3 },
+    { "day",    86400, SERIES_DAY_SLOTS,    3 }
+};
+
+struct BinaryHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t tier;
+    uint8_t seriesCount;
+    uint8_t fields;
+    uint32_t slotSeconds;
+    uint32_t newestSlotUtc;
+    uint16_t slots;
+    uint16_t reserved;
+};
+
+struct BinarySeries {
+    float scale;
+    uint8_t kind;
+    uint8_t reserved[3];
+};
+
+} // namespace
+
+SeriesStore::SeriesStore()
+    : data(nullptr), partition(nullptr), checkpointBytes(0), checkpointSequence(0),
+      checkpointArea(1), lastCheckpointMs(0), dirty(false) {
+    memset(&state, 0, sizeof(state));
+}
+
+/**
+ * Allocate the store and load the newest checkpoint
+ *
+ * @return: false if the store could not be allocated (history off)
+ */
+bool SeriesStore::begin() {
+    size_t bytes = getDataCount() * sizeof(int16_t);
+    data = (int16_t*)malloc(bytes);
+    if (!data) {
+        Console::printlnR(F("✗ Series store: not enough memory - history disabled"));
+        return false;
+    }
+    clear();
+
+    // Two copies behind the input recorder ring, if the partition has room
+    checkpointBytes = sizeof(CheckpointHeader) + sizeof(State) + bytes;
+    checkpointBytes = (checkpointBytes + INPUT_RECORDER_SECTOR_SIZE - 1) / INPUT_RECORDER_SECTOR_SIZE *
+                      INPUT_RECORDER_SECTOR_SIZE;
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+    if (partition && partition->size < SERIES_FLASH_OFFSET + 2 * checkpointBytes) {
+        partition = nullptr;
+    }
+
+    bool loaded = partition && loadCheckpoint();
+    dirty = false;
+
+    Console::printR(F("Series store: "));
+    Console::printR(String((unsigned long)(bytes / 1024)));
+    Console::printR(F(" KB, "));
+    if (!partition) {
+        Console::printlnR(F("no flash checkpoint (SPIFFS partition missing or too small)"));
+    } else if (loaded) {
+        Console::printlnR(F("history restored from flash"));
+    } else {
+        Console::printlnR(F("starting empty"));
+    }
+    return true;
+}
+
+/**
+ * Add one minute of samples
+ *
+ * @param utc: Start of the minute (UTC epoch seconds)
+ * @param values: One value per series in its unit, NAN if unknown
+ */
+void SeriesStore::addSample(uint32_t utc, const float values[SERIES_COUNT]) {
+    if (!data || utc < MIN_VALID_UTC) {
+        return;
+    }
+
+    uint32_t newestMinute = state.tiers[TIER_MINUTE].newestSlot;
+    uint32_t minute = utc / TIER_INFO[TIER_MINUTE].slotSeconds;
+    if (newestMinute != 0 && minute <= newestMinute) {
+        // Already sampled, or the clock was corrected back a little
+        if (newestMinute - minute <= MAX_BACKWARD_MINUTES) {
+            return;
+        }
+        Console::printlnR(F("⚠ Series store: clock moved back - history cleared"));
+        clear();
+    }
+
+    int16_t encoded[SERIES_COUNT];
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        encoded[series] = encode((Series)series, values[series]);
+    }
+
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        const TierInfo& info = TIER_INFO[tier];
+        advance((Tier)tier, utc / info.slotSeconds);
+        uint16_t pos = state.tiers[tier].newestPos;
+
+        for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+            int16_t value = encoded[series];
+            int16_t* slot = slotAt((Tier)tier, (Series)series, pos);
+            if (info.fields == 1) {
+                slot[0] = value;
+                continue;
+            }
+            if (value == UNKNOWN) {
+                continue;
+            }
+
+            Accumulator& acc = state.accumulators[tier][series];
+            acc.sum += value;
+            acc.count++;
+            if (value < acc.min) {
+                acc.min = value;
+            }
+            if (value > acc.max) {
+                acc.max = value;
+            }
+
+            int32_t average;
+            if (SERIES_INFO[series].kind == KIND_COUNT) {
+                average = acc.sum > 32767 ? 32767 : acc.sum;
+            } else {
+                // Rounded to nearest
+                average = (acc.sum + (acc.sum >= 0 ? acc.count / 2 : -(int32_t)(acc.count / 2))) / acc.count;
+            }
+            slot[0] = acc.min;
+            slot[1] = (int16_t)average;
+            slot[2] = acc.max;
+        }
+    }
+    dirty = true;
+}
+
+/**
+ * Write the store to the other checkpoint area (blocks for about a
+ * second: sector erases)
+ *
+ * @return: true if written (or nothing changed since the last one)
+ */
+bool SeriesStore::checkpoint() {
+    if (!data || !partition) {
+        return false;
+    }
+    if (!dirty) {
+        return true;
+    }
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_FLASH_WRITE);
+
+    uint8_t area = checkpointArea ^ 1;
+    uint32_t base = SERIES_FLASH_OFFSET + area * checkpointBytes;
+    size_t dataBytes = getDataCount() * sizeof(int16_t);
+
+    CheckpointHeader header;
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.seriesCount = SERIES_COUNT;
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        header.slots[tier] = TIER_INFO[tier].slots;
+    }
+    header.reserved = 0xFFFF;
+    header.sequence = checkpointSequence + 1;
+    header.crc = crc32_le(0, (const uint8_t*)&state, sizeof(state));
+    header.crc = crc32_le(header.crc, (const uint8_t*)data, dataBytes);
+
+    // Header last: a copy interrupted by a reset stays invalid
+    if (esp_partition_erase_range(partition, base, checkpointBytes) != ESP_OK ||
+        esp_partition_write(partition, base + sizeof(header), &state, sizeof(state)) != ESP_OK ||
+        esp_partition_write(partition, base + sizeof(header) + sizeof(state), data, dataBytes) != ESP_OK ||
+        esp_partition_write(partition, base, &header, sizeof(header)) != ESP_OK) {
+        Console::printlnR(F("✗ Series store: checkpoint write failed"));
+        return false;
+    }
+
+    checkpointArea = area;
+    checkpointSequence = header.sequence;
+    lastCheckpointMs = millis();
+    dirty = false;
+    return true;
+}
+
+/**
+ * Forget all history (the next checkpoint overwrites flash)
+ */
+void SeriesStore::clear() {
+    if (!data) {
+        return;
+    }
+    size_t count = getDataCount();
+    for (size_t i = 0; i < count; i++) {
+        data[i] = UNKNOWN;
+    }
+    memset(&state, 0, sizeof(state));
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        resetAccumulators((Tier)tier);
+    }
+    dirty = true;
+}
+
+/**
+ * Stream one tier in the binary format described in the header
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void SeriesStore::writeBinary(Print& out, Tier tier) const {
+    const TierInfo& info = TIER_INFO[tier];
+    const TierState& tierState = state.tiers[tier];
+
+    BinaryHeader header;
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.tier = tier;
+    header.seriesCount = SERIES_COUNT;
+    header.fields = info.fields;
+    header.slotSeconds = info.slotSeconds;
+    header.newestSlotUtc = tierState.newestSlot * info.slotSeconds;
+    header.slots = info.slots;
+    header.reserved = 0;
+    out.write((const uint8_t*)&header, sizeof(header));
+
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        BinarySeries descriptor;
+        descriptor.scale = SERIES_INFO[series].scale;
+        descriptor.kind = SERIES_INFO[series].kind;
+        memset(descriptor.reserved, 0, sizeof(descriptor.reserved));
+        out.write((const uint8_t*)&descriptor, sizeof(descriptor));
+    }
+
+    // Oldest first: the slots after the newest, then up to the newest
+    uint16_t oldest = (tierState.newestPos + 1) % info.slots;
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        const int16_t* ring = data ? slotAt(tier, (Series)series, 0) : nullptr;
+        if (!ring) {
+            int16_t unknown[3] = { UNKNOWN, UNKNOWN, UNKNOWN };
+            for (uint16_t i = 0; i < info.slots; i++) {
+                out.write((const uint8_t*)unknown, info.fields * sizeof(int16_t));
+            }
+            continue;
+        }
+        out.write((const uint8_t*)(ring + oldest * info.fields), (info.slots - oldest) * info.fields * sizeof(int16_t));
+        out.write((const uint8_t*)ring, oldest * info.fields * sizeof(int16_t));
+    }
+}
+
+/**
+ * Stream one tier as CSV, oldest slot first (empty cell = unknown)
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void SeriesStore::writeCsv(Print& out, Tier tier) const {
+    static const char* const FIELD_SUFFIXES[] = { "_min", "_avg", "_max" };
+    const TierInfo& info = TIER_INFO[tier];
+    const TierState& tierState = state.tiers[tier];
+
+    out.print(F("utc"));
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        if (info.fields == 1 || SERIES_INFO[series].kind == KIND_COUNT) {
+            out.print(',');
+            out.print(SERIES_INFO[series].name);
+            continue;
+        }
+        for (uint8_t field = 0; field < info.fields; field++) {
+            out.print(',');
+            out.print(SERIES_INFO[series].name);
+            out.print(FIELD_SUFFIXES[field]);
+        }
+    }
+    out.print('\n');
+    if (!data || tierState.newestSlot == 0) {
+        return;
+    }
+
+    // Rows start at the oldest slot the tier can hold
+    uint32_t firstSlot = tierState.newestSlot - (info.slots - 1);
+    for (uint16_t i = 0; i < info.slots; i++) {
+        uint16_t pos = (tierState.newestPos + 1 + i) % info.slots;
+        out.print((unsigned long)((firstSlot + i) * info.slotSeconds));
+        for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+            const SeriesInfo& seriesInfo = SERIES_INFO[series];
+            const int16_t* slot = slotAt(tier, (Series)series, pos);
+            uint8_t first = 0;
+            uint8_t last = info.fields - 1;
+            if (info.fields > 1 && seriesInfo.kind == KIND_COUNT) {
+                first = last = 1;
+            }
+            for (uint8_t field = first; field <= last; field++) {
+                out.print(',');
+                if (slot[field] != UNKNOWN) {
+                    out.print(slot[field] * seriesInfo.scale, seriesInfo.decimals);
+                }
+            }
+        }
+        out.print('\n');
+    }
+}
+
+/**
+ * Print memory use, tier fill and checkpoint state
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void SeriesStore::printStatus(Print& out) const {
+    out.println(F("Series Store Status:"));
+    if (!data) {
+        out.println(F("  Unavailable (not enough memory)"));
+        return;
+    }
+
+    out.print(F("  Memory: "));
+    out.print((unsigned long)(getDataCount() * sizeof(int16_t)));
+    out.print(F(" bytes, "));
+    out.print(SERIES_COUNT);
+    out.println(F(" series"));
+
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        const TierInfo& info = TIER_INFO[tier];
+        const TierState& tierState = state.tiers[tier];
+
+        // Filled slots of the first series that has any
+        uint16_t filled = 0;
+        for (uint8_t series = 0; series < SERIES_COUNT && filled == 0; series++) {
+            for (uint16_t pos = 0; pos < info.slots; pos++) {
+                if (slotAt((Tier)tier, (Series)series, pos)[info.fields > 1 ? 1 : 0] != UNKNOWN) {
+                    filled++;
+                }
+            }
+        }
+
+        out.print(F("  "));
+        out.print(info.name);
+        out.print(F(": "));
+        out.print(filled);
+        out.print('/');
+        out.print(info.slots);
+        out.print(F(" slots of "));
+        out.print(info.slotSeconds);
+        out.print(F(" s"));
+        if (tierState.newestSlot != 0) {
+            out.print(F(", newest at UTC "));
+            out.print((unsigned long)(tierState.newestSlot * info.slotSeconds));
+        }
+        out.println();
+    }
+
+    out.print(F("  Checkpoint: "));
+    if (!partition) {
+        out.println(F("unavailable (SPIFFS partition missing or too small)"));
+        return;
+    }
+    if (checkpointSequence == 0) {
+        out.print(F("none yet"));
+    } else {
+        out.print(F("#"));
+        out.print(checkpointSequence);
+        out.print(F(" in area "));
+        out.print(checkpointArea);
+        if (lastCheckpointMs != 0) {
+            out.print(F(", "));
+            out.print((millis() - lastCheckpointMs) / 60000UL);
+            out.print(F(" min ago"));
+        }
+    }
+    out.println(dirty ? F(" (unsaved samples)") : F(""));
+}
+
+const SeriesStore::SeriesInfo& SeriesStore::getSeriesInfo(Series series) {
+    return SERIES_INFO[series];
+}
+
+const SeriesStore::TierInfo& SeriesStore::getTierInfo(Tier tier) {
+    return TIER_INFO[tier];
+}
+
+/**
+ * @return: Tier named name ("minute", "hour", "day"), TIER_COUNT if none
+ */
+SeriesStore::Tier SeriesStore::findTier(const char* name) {
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        if (strcmp(name, TIER_INFO[tier].name) == 0) {
+            return (Tier)tier;
+        }
+    }
+    return TIER_COUNT;
+}
+
+/**
+ * @return: int16 values in the whole store
+ */
+size_t SeriesStore::getDataCount() {
+    size_t count = 0;
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        count += (size_t)TIER_INFO[tier].slots * TIER_INFO[tier].fields * SERIES_COUNT;
+    }
+    return count;
+}
+
+int16_t* SeriesStore::slotAt(Tier tier, Series series, uint16_t pos) const {
+    size_t offset = 0;
+    for (uint8_t i = 0; i < tier; i++) {
+        offset += (size_t)TIER_INFO[i].slots * TIER_INFO[i].fields * SERIES_COUNT;
+    }
+    const TierInfo& info = TIER_INFO[tier];
+    return data + offset + ((size_t)series * info.slots + pos) * info.fields;
+}
+
+/**
+ * Make slot the newest of the tier, marking skipped slots unknown
+ */
+void SeriesStore::advance(Tier tier, uint32_t slot) {
+    const TierInfo& info = TIER_INFO[tier];
+    TierState& tierState = state.tiers[tier];
+    if (tierState.newestSlot == slot) {
+        return;
+    }
+
+    uint32_t steps = tierState.newestSlot == 0 ? info.slots : slot - tierState.newestSlot;
+    if (steps > info.slots) {
+        steps = info.slots;
+    }
+    for (uint32_t i = 0; i < steps; i++) {
+        tierState.newestPos = (tierState.newestPos + 1) % info.slots;
+        for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+            int16_t* values = slotAt(tier, (Series)series, tierState.newestPos);
+            for (uint8_t field = 0; field < info.fields; field++) {
+                values[field] = UNKNOWN;
+            }
+        }
+    }
+    tierState.newestSlot = slot;
+    resetAccumulators(tier);
+}
+
+void SeriesStore::resetAccumulators(Tier tier) {
+    for (uint8_t series = 0; series < SERIES_COUNT; series++) {
+        Accumulator& acc = state.accumulators[tier][series];
+        acc.sum = 0;
+        acc.count = 0;
+        acc.min = 32767;
+        acc.max = -32767;
+        acc.reserved = 0;
+    }
+}
+
+/**
+ * Load the newest copy whose CRC matches (the other one if it does not)
+ *
+ * @return: true if history was restored
+ */
+bool SeriesStore::loadCheckpoint() {
+    CheckpointHeader headers[2];
+    bool valid[2];
+    for (uint8_t area = 0; area < 2; area++) {
+        valid[area] = readCheckpoint(area, headers[area]);
+    }
+
+    size_t dataBytes = getDataCount() * sizeof(int16_t);
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        uint8_t area;
+        if (valid[0] && valid[1]) {
+            area = (int32_t)(headers[1].sequence - headers[0].sequence) > 0 ? 1 : 0;
+        } else if (valid[0] || valid[1]) {
+            area = valid[1] ? 1 : 0;
+        } else {
+            break;
+        }
+        valid[area] = false;
+
+        uint32_t base = SERIES_FLASH_OFFSET + area * checkpointBytes;
+        if (esp_partition_read(partition, base + sizeof(CheckpointHeader), &state, sizeof(state)) != ESP_OK ||
+            esp_partition_read(partition, base + sizeof(CheckpointHeader) + sizeof(state), data, dataBytes) != ESP_OK) {
+            continue;
+        }
+        uint32_t crc = crc32_le(0, (const uint8_t*)&state, sizeof(state));
+        crc = crc32_le(crc, (const uint8_t*)data, dataBytes);
+        if (crc != headers[area].crc) {
+            Console::printR(F("⚠ Series store: checkpoint area "));
+            Console::printR(String(area));
+            Console::printlnR(F(" is corrupt"));
+            continue;
+        }
+
+        checkpointArea = area;
+        checkpointSequence = headers[area].sequence;
+        return true;
+    }
+
+    clear();
+    return false;
+}
+
+/**
+ * Read the header of a checkpoint area
+ *
+ * @return: true if it holds a copy with the current layout
+ */
+bool SeriesStore::readCheckpoint(uint8_t area, CheckpointHeader& header) {
+    uint32_t base = SERIES_FLASH_OFFSET + area * checkpointBytes;
+    if (esp_partition_read(partition, base, &header, sizeof(header)) != ESP_OK ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+        header.version != CHECKPOINT_VERSION || header.seriesCount != SERIES_COUNT) {
+        return false;
+    }
+    for (uint8_t tier = 0; tier < TIER_COUNT; tier++) {
+        if (header.slots[tier] != TIER_INFO[tier].slots) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Value in the series unit -> stored step (saturating)
+ */
+int16_t SeriesStore::encode(Series series, float value) {
+    if (isnan(value)) {
+        return UNKNOWN;
+    }
+    float steps = roundf(value / SERIES_INFO[series].scale);
+    if (steps > 32767.0f) {
+        return 32767;
+    }
+    if (steps < -32767.0f) {
+        return -32767;
+    }
+    return (int16_t)steps;
+}
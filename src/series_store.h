@@ -0,0 +1,190 @@
+#ifndef SERIES_STORE_H
+#define SERIES_STORE_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+
+/**
+ * Time-Series Store
+ *
+ * Round-robin history of a few operational values, sampled once a minute
+ * (addSample()) into three tiers:
+ *   - minute: SERIES_MINUTE_SLOTS slots, the sample itself
+ *   - hour:   SERIES_HOUR_SLOTS slots of min/avg/max
+ *   - day:    SERIES_DAY_SLOTS slots of min/avg/max
+ * Hour and day slots are consolidated incrementally: every sample updates a
+ * running min/sum/max of the current slot, so the newest slot is always
+ * current and nothing is recomputed at rollover. Count series (feedings)
+ * keep the total of the slot in the avg field.
+ *
+ * Slots are aligned to UTC (slot = utc / slot length), so time the device
+ * was off shows up as unknown slots. Values are int16 in a per-series unit
+ * (SeriesInfo::scale), UNKNOWN marks a missing value.
+ *
+ * The store is one heap block allocated by begin(). checkpoint() writes it
+ * with the consolidation state to one of two alternating flash areas
+ * behind the input recorder ring; begin() loads the newest valid copy.
+ *
+ * /api/series serves one tier as binary (charts on /custom) or CSV.
+ * Binary layout (little-endian):
+ *   header: "FFTS", version (1), tier (1), series count (1), fields per
+ *           slot (1), slot seconds (4), newest slot start UTC (4),
+ *           slot count (2), reserved (2)
+ *   per series: scale (float), kind (1), reserved (3)
+ *   per series: slot count x fields int16, oldest slot first
+ */
+class SeriesStore {
+public:
+    enum Series : uint8_t {
+        SERIES_HEAP_FREE,
+        SERIES_LOOP_LATENCY,
+        SERIES_RSSI,
+        SERIES_RTC_TEMPERATURE,
+        SERIES_FEEDS,
+        SERIES_NTP_OFFSET,
+        SERIES_COUNT
+    };
+
+    enum Tier : uint8_t {
+        TIER_MINUTE,
+        TIER_HOUR,
+        TIER_DAY,
+        TIER_COUNT
+    };
+
+    enum Kind : uint8_t {
+        KIND_GAUGE,             // min/avg/max of the samples
+        KIND_COUNT              // avg field holds the total of the slot
+    };
+
+    struct SeriesInfo {
+        const char* name;       // CSV column
+        const char* label;      // Chart title
+        const char* unit;
+        float scale;            // Unit per stored step
+        uint8_t decimals;
+        Kind kind;
+    };
+
+    struct TierInfo {
+        const char* name;       // /api/series?tier=
+        uint32_t slotSeconds;
+        uint16_t slots;
+        uint8_t fields;         // 1 (sample) or 3 (min, avg, max)
+    };
+
+    static const int16_t UNKNOWN = -32768;
+
+    SeriesStore();
+
+    /**
+     * Allocate the store and load the newest checkpoint
+     *
+     * @return: false if the store could not be allocated (history off)
+     */
+    bool begin();
+
+    /**
+     * Add one minute of samples
+     *
+     * @param utc: Start of the minute (UTC epoch seconds)
+     * @param values: One value per series in its unit, NAN if unknown
+     */
+    void addSample(uint32_t utc, const float values[SERIES_COUNT]);
+
+    /**
+     * Write the store to the other checkpoint area (blocks for about a
+     * second: sector erases)
+     *
+     * @return: true if written (or nothing changed since the last one)
+     */
+    bool checkpoint();
+
+    /**
+     * Forget all history (the next checkpoint overwrites flash)
+     */
+    void clear();
+
+    bool isReady() const { return data != nullptr; }
+
+    /**
+     * Stream one tier in the binary format described above
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    void writeBinary(Print& out, Tier tier) const;
+
+    /**
+     * Stream one tier as CSV, oldest slot first (empty cell = unknown)
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    void writeCsv(Print& out, Tier tier) const;
+
+    /**
+     * Print memory use, tier fill and checkpoint state
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printStatus(Print& out) const;
+
+    static const SeriesInfo& getSeriesInfo(Series series);
+    static const TierInfo& getTierInfo(Tier tier);
+
+    /**
+     * @return: Tier named name ("minute", "hour", "day"), TIER_COUNT if none
+     */
+    static Tier findTier(const char* name);
+
+private:
+    struct TierState {
+        uint32_t newestSlot;    // utc / slotSeconds of the newest slot, 0 = empty
+        uint16_t newestPos;     // Its ring position
+        uint16_t reserved;
+    };
+
+    // Running consolidation of the newest hour/day slot
+    struct Accumulator {
+        int32_t sum;
+        uint16_t count;
+        int16_t min;
+        int16_t max;
+        int16_t reserved;
+    };
+
+    // Everything besides the slots that a checkpoint has to restore
+    struct State {
+        TierState tiers[TIER_COUNT];
+        Accumulator accumulators[TIER_COUNT][SERIES_COUNT];
+    };
+
+    struct CheckpointHeader {
+        char magic[4];          // "FFTC"
+        uint8_t version;
+        uint8_t seriesCount;
+        uint16_t slots[TIER_COUNT];
+        uint16_t reserved;
+        uint32_t sequence;      // Newest copy wins
+        uint32_t crc;           // State and slots
+    };
+
+    int16_t* data;
+    State state;
+    const esp_partition_t* partition;
+    uint32_t checkpointBytes;   // One copy, whole sectors
+    uint32_t checkpointSequence;
+    uint8_t checkpointArea;     // Area of the newest copy
+    uint32_t lastCheckpointMs;
+    bool dirty;
+
+    static size_t getDataCount();
+    int16_t* slotAt(Tier tier, Series series, uint16_t pos) const;
+    void advance(Tier tier, uint32_t slot);
+    void resetAccumulators(Tier tier);
+    bool loadCheckpoint();
+    bool readCheckpoint(uint8_t area, CheckpointHeader& header);
+    static int16_t encode(Series series, float value);
+};
+
+#endif // SERIES_STORE_H
@@ -0,0 +1,98 @@
+#ifndef STEPPER_DRIVER_H
+#define STEPPER_DRIVER_H
+
+#include <Arduino.h>
+#include <AccelStepper.h>
+#include <soc/gpio_struct.h>
+
+/**
+ * StepperDriver Template
+ *
+ * Compile-time specialized ULN2003 driver for AccelStepper (FULL4WIRE).
+ *
+ * AccelStepper's default step() path calls digitalWrite() once per coil, each
+ * doing a pin-table lookup and a read-modify-write. Here the pins are template
+ * parameters, so the set/clear masks of the four phases are constants and every
+ * phase change is a single GPIO.out_w1tc / GPIO.out_w1ts register write pair.
+ *
+ * Usage:
+ *   StepperDriver<15, 4, 5, 18> feedMotorDriver;
+ *   StepperMotor feedMotor(feedMotorDriver);
+ *
+ * The runtime-pin StepperMotor(int, int, int, int) constructor remains available
+ * for builds where the pins are only known at runtime.
+ *
+ * @tparam IN1, IN2, IN3, IN4: ULN2003 control pins (GPIO 0-31)
+ */
+template <uint8_t IN1, uint8_t IN2, uint8_t IN3, uint8_t IN4>
+class StepperDriver : public AccelStepper {
+    static_assert(IN1 < 32 && IN2 < 32 && IN3 < 32 && IN4 < 32,
+                  "StepperDriver pins must be GPIO 0-31 (GPIO.out_w1ts bank)");
+    static_assert(IN1 != IN2 && IN1 != IN3 && IN1 != IN4 && IN2 != IN3 && IN2 != IN4 && IN3 != IN4,
+                  "StepperDriver pins must be distinct");
+
+public:
+    // All four coil lines
+    static constexpr uint32_t COIL_MASK = (1UL << IN1) | (1UL << IN2) | (1UL << IN3) | (1UL << IN4);
+
+    // Energized coils per phase, same sequence as AccelStepper::step4() with pin order IN1, IN3, IN2, IN4
+    static constexpr uint32_t PHASE_0 = (1UL << IN1) | (1UL << IN2);
+    static constexpr uint32_t PHASE_1 = (1UL << IN2) | (1UL << IN3);
+    static constexpr uint32_t PHASE_2 = (1UL << IN3) | (1UL << IN4);
+    static constexpr uint32_t PHASE_3 = (1UL << IN4) | (1UL << IN1);
+
+    static constexpr uint8_t PIN_IN1 = IN1;
+    static constexpr uint8_t PIN_IN2 = IN2;
+    static constexpr uint8_t PIN_IN3 = IN3;
+    static constexpr uint8_t PIN_IN4 = IN4;
+
+    /**
+     * Constructor
+     * Pins are configured by StepperMotor::begin(), so AccelStepper must not touch them here
+     */
+    StepperDriver() : AccelStepper(AccelStepper::FULL4WIRE, IN1, IN3, IN2, IN4, false) {}
+
+    /**
+     * Output the coil pattern for a step position
+     * Static so it can be benchmarked without an AccelStepper instance
+     *
+     * @param step: Step position (only the two low bits select the phase)
+     */
+    static inline void writePhase(long step) {
+        switch (step & 0x03) {
+            case 0: writeCoils(PHASE_0); break;
+            case 1: writeCoils(PHASE_1); break;
+            case 2: writeCoils(PHASE_2); break;
+            case 3: writeCoils(PHASE_3); break;
+        }
+    }
+
+protected:
+    /**
+     * AccelStepper hook called for every step
+     */
+    void step(long step) override {
+        writePhase(step);
+    }
+
+    /**
+     * AccelStepper hook used by disableOutputs()/enableOutputs()
+     * Bit order follows the constructor pin order: IN1, IN3, IN2, IN4
+     */
+    void setOutputPins(uint8_t mask) override {
+        uint32_t set = 0;
+        if (mask & 0x01) set |= (1UL << IN1);
+        if (mask & 0x02) set |= (1UL << IN3);
+        if (mask & 0x04) set |= (1UL << IN2);
+        if (mask & 0x08) set |= (1UL << IN4);
+        writeCoils(set);
+    }
+
+private:
+    static inline void writeCoils(uint32_t set) {
+        GPIO.out_w1tc = COIL_MASK & ~set;
+        GPIO.out_w1ts = set;
+    }
+};
+
+#endif // STEPPER_DRIVER_H
@@ -1,9 +1,17 @@
 #include "stepper_motor.h"
+#include "loop_watchdog.h"
 #include "config.h"
-#include <Preferences.h>
 
-// Preferences object for NVRAM storage
-Preferences motorPreferences;
+/**
+ * Exposes AccelStepper's protected step() so the benchmark can time
+ * the stock digitalWrite() coil update path
+ */
+class RuntimeStepProbe : public AccelStepper {
+public:
+    RuntimeStepProbe(int in1, int in2, int in3, int in4)
+        : AccelStepper(AccelStepper::FULL4WIRE, in1, in3, in2, in4, false) {}
+    void probe(long position) { step(position); }
+};
 
 /**
  * Constructor: Initialize stepper motor with pin configuration
@@ -13,17 +21,31 @@ Preferences motorPreferences;
  */
 StepperMotor::StepperMotor(int in1, int in2, int in3, int in4, int stepsPerRev) 
     : pin1(in1), pin2(in2), pin3(in3), pin4(in4), 
-      stepsPerRevolution(stepsPerRev), stepper(nullptr), isInitialized(false),
-      maxSpeed(1200.0), acceleration(800.0), motorDirectionClockwise(DEFAULT_MOTOR_CLOCKWISE) {
+      stepsPerRevolution(stepsPerRev), stepper(nullptr), externalDriver(nullptr),
+      fastPhaseWriter(nullptr), isInitialized(false),
+      maxSpeed(1200.0), acceleration(800.0), motorDirectionClockwise(DEFAULT_MOTOR_CLOCKWISE),
+      moveStartPosition(0),
+      moveStepped(false), moveEnded(false), moveFirstStepUs(0), moveEndUs(0),
+      waveform(nullptr), waveformMoveActive(false), waveformStartPosition(0), waveformTargetPosition(0),
+      planActive(false), planReversing(false), planTarget(0), planStroke(0), planReverse(0),
+      indexSensor(nullptr), homingState(HOMING_IDLE), homed(false), homeOrigin(0),
+      handledIndexEdges(0), indexChecks(0), lostStepEvents(0), lastIndexError(0) {
 }
 
 /**
  * Destructor: Clean up stepper instance and disable motor
  */
 StepperMotor::~StepperMotor() {
+    if (waveform) {
+        waveform->stop();
+        waveform->releaseCoils();
+        delete waveform;
+    }
     if (stepper) {
         disableMotor();
-        delete stepper;
+        if (stepper != externalDriver) {
+            delete stepper;
+        }
     }
 }
 
@@ -35,17 +57,14 @@ StepperMotor::~StepperMotor() {
 bool StepperMotor::begin() {
     Serial.println(F("Initializing Stepper Motor (28BYJ-48) with AccelStepper..."));
     
-    // Load motor direction from NVRAM
-    motorPreferences.begin("motor", false);
-    motorDirectionClockwise = motorPreferences.getBool(MOTOR_DIRECTION_NVRAM_KEY, DEFAULT_MOTOR_CLOCKWISE);
-    motorPreferences.end();
-    
-    Serial.print(F("Motor direction loaded from NVRAM: "));
-    Serial.println(motorDirectionClockwise ? F("CLOCKWISE (CW)") : F("COUNTER-CLOCKWISE (CCW)"));
-    
-    // Create AccelStepper instance with FULL4WIRE interface
+    // Use the compile-time driver if one was supplied, otherwise create a runtime-pin
+    // AccelStepper instance with FULL4WIRE interface
     // Pin order for ULN2003: IN1, IN3, IN2, IN4 (proper sequence)
-    stepper = new AccelStepper(AccelStepper::FULL4WIRE, pin1, pin3, pin2, pin4);
+    if (externalDriver) {
+        stepper = externalDriver;
+    } else {
+        stepper = new AccelStepper(AccelStepper::FULL4WIRE, pin1, pin3, pin2, pin4);
+    }
     
     if (!stepper) {
         Serial.println(F("ERROR: Failed to create AccelStepper instance"));
@@ -60,8 +79,23 @@ bool StepperMotor::begin() {
     stepper->setAcceleration(acceleration);
     stepper->setCurrentPosition(0);
     
+    // Offload non-blocking moves to RMT when enabled
+    if (STEPPER_RMT_BACKEND_ENABLED) {
+        waveform = new StepperWaveform(STEPPER_RMT_CHANNEL_A, STEPPER_RMT_CHANNEL_B);
+        if (!waveform->begin(pin1, pin2, pin3, pin4)) {
+            Serial.println(F("WARNING: RMT coil sequencer unavailable - using AccelStepper stepping"));
+            delete waveform;
+            waveform = nullptr;
+        }
+        disableMotor();
+    }
+    
     isInitialized = true;
     Serial.println(F("AccelStepper Motor initialized successfully"));
+    Serial.print(F("Coil driver: "));
+    Serial.println(fastPhaseWriter ? F("compile-time GPIO registers") : F("runtime digitalWrite"));
+    Serial.print(F("Async backend: "));
+    Serial.println(waveform ? F("RMT waveform") : F("AccelStepper"));
     Serial.print(F("Pin Configuration - IN1: "));
     Serial.print(pin1);
     Serial.print(F(", IN2: "));
@@ -142,6 +176,24 @@ void StepperMotor::setAcceleration(float accel) {
     Serial.println(F(" steps/second²"));
 }
 
+/**
+ * Get the maximum speed used by async moves
+ * 
+ * @return Speed in steps/second
+ */
+float StepperMotor::getMaxSpeed() const {
+    return maxSpeed;
+}
+
+/**
+ * Get the acceleration used by async moves
+ * 
+ * @return Acceleration in steps/second²
+ */
+float StepperMotor::getAcceleration() const {
+    return acceleration;
+}
+
 /**
  * Set constant speed for runSpeed() operation
  * 
@@ -161,20 +213,15 @@ void StepperMotor::setSpeed(float speed) {
 
 /**
  * Set motor rotation direction for feeding operations
+ * Persistence is handled by RuntimeConfig (motor.clockwise), which calls this on change
  * 
  * @param clockwise: true = clockwise, false = counter-clockwise
  */
 void StepperMotor::setMotorDirection(bool clockwise) {
     motorDirectionClockwise = clockwise;
     
-    // Save to NVRAM for persistence
-    motorPreferences.begin("motor", false);
-    motorPreferences.putBool(MOTOR_DIRECTION_NVRAM_KEY, clockwise);
-    motorPreferences.end();
-    
     Serial.print(F("Motor direction set to: "));
     Serial.println(clockwise ? F("CLOCKWISE (CW)") : F("COUNTER-CLOCKWISE (CCW)"));
-    Serial.println(F("Direction saved to NVRAM"));
 }
 
 /**
@@ -197,6 +244,11 @@ void StepperMotor::stepClockwise(int steps) {
         return;
     }
     
+    if (waveformMoveActive || planActive || homingState != HOMING_IDLE) {
+        Serial.println(F("ERROR: Motor busy - async move in progress"));
+        return;
+    }
+    
     Serial.print(F("Moving "));
     Serial.print(steps);
     Serial.println(F(" steps clockwise"));
@@ -208,8 +260,12 @@ void StepperMotor::stepClockwise(int steps) {
     stepper->moveTo(currentPos + adjustedSteps);
     
     // Run until target is reached
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_MOTOR_MOVE);
     while (stepper->distanceToGo() != 0) {
         stepper->run();
+        if (indexSensor) {
+            serviceIndex();
+        }
     }
     
     // Disable motor after movement to save power
@@ -227,6 +283,11 @@ void StepperMotor::stepCounterClockwise(int steps) {
         return;
     }
     
+    if (waveformMoveActive || planActive || homingState != HOMING_IDLE) {
+        Serial.println(F("ERROR: Motor busy - async move in progress"));
+        return;
+    }
+    
     Serial.print(F("Moving "));
     Serial.print(steps);
     Serial.println(F(" steps counter-clockwise"));
@@ -238,8 +299,12 @@ void StepperMotor::stepCounterClockwise(int steps) {
     stepper->moveTo(currentPos + adjustedSteps);
     
     // Run until target is reached
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_MOTOR_MOVE);
     while (stepper->distanceToGo() != 0) {
         stepper->run();
+        if (indexSensor) {
+            serviceIndex();
+        }
     }
     
     // Disable motor after movement to save power
@@ -277,14 +342,23 @@ void StepperMotor::moveToPosition(long targetSteps) {
         return;
     }
     
+    if (waveformMoveActive || planActive || homingState != HOMING_IDLE) {
+        Serial.println(F("ERROR: Motor busy - async move in progress"));
+        return;
+    }
+    
     Serial.print(F("Moving to position: "));
     Serial.println(targetSteps);
     
     stepper->moveTo(targetSteps);
     
     // Run until target is reached
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_MOTOR_MOVE);
     while (stepper->distanceToGo() != 0) {
         stepper->run();
+        if (indexSensor) {
+            serviceIndex();
+        }
     }
     
     Serial.println(F("Target position reached"));
@@ -294,9 +368,15 @@ void StepperMotor::moveToPosition(long targetSteps) {
 /**
  * Move motor to absolute position (non-blocking)
  * 
+ * With strokeSteps > reverseSteps > 0 the move oscillates: forward strokes of
+ * strokeSteps with reverseSteps back after each one (anti-clog dispensing).
+ * The net displacement is still targetSteps - current position.
+ * 
  * @param targetSteps: Target position in steps
+ * @param strokeSteps: Forward stroke length (0 = single stroke)
+ * @param reverseSteps: Reverse stroke length between forward strokes
  */
-void StepperMotor::moveToPositionAsync(long targetSteps) {
+void StepperMotor::moveToPositionAsync(long targetSteps, uint16_t strokeSteps, uint16_t reverseSteps) {
     if (!isInitialized || !stepper) {
         Serial.println(F("ERROR: Motor not initialized"));
         return;
@@ -305,9 +385,86 @@ void StepperMotor::moveToPositionAsync(long targetSteps) {
     Serial.print(F("Setting target position: "));
     Serial.println(targetSteps);
     
+    // Same rule as StepperWaveform::start(): reverse strokes shorter than forward ones
+    if (reverseSteps == 0 || reverseSteps >= strokeSteps) {
+        strokeSteps = 0;
+        reverseSteps = 0;
+    }
+    planActive = false;
+    
+    if (waveform) {
+        // A new target replaces the move being played; after stop() the
+        // waveform position is exact, so the new move starts at the rotor
+        if (waveformMoveActive) {
+            waveform->stop();
+            stepper->setCurrentPosition(getWaveformPosition());
+            waveformMoveActive = false;
+        }
+        
+        moveStepped = false;
+        moveEnded = false;
+        
+        long startPosition = stepper->currentPosition();
+        moveStartPosition = startPosition;
+        if (waveform->start(startPosition, targetSteps - startPosition, maxSpeed, acceleration,
+                            strokeSteps, reverseSteps)) {
+            waveformStartPosition = startPosition;
+            waveformTargetPosition = targetSteps;
+            waveformMoveActive = true;
+            stepper->moveTo(targetSteps);  // Keeps getTargetPosition() consistent
+            
+            // RMT starts clocking the first step right away
+            moveFirstStepUs = micros();
+            moveStepped = true;
+            return;
+        }
+        
+        waveform->releaseCoils();
+    }
+    
+    moveStartPosition = stepper->currentPosition();
+    moveStepped = false;
+    moveEnded = false;
+    
+    if (strokeSteps && labs(targetSteps - moveStartPosition) > strokeSteps) {
+        planTarget = targetSteps;
+        planStroke = strokeSteps;
+        planReverse = reverseSteps;
+        planReversing = true;  // So the first stroke is a forward one
+        planActive = true;
+        startNextStroke();
+        return;
+    }
+    
     stepper->moveTo(targetSteps);
 }
 
+/**
+ * Queue the next stroke of an oscillating move on AccelStepper
+ * Unlike the RMT waveform, the motor comes to a stop between strokes
+ * 
+ * @return false when the plan is complete
+ */
+bool StepperMotor::startNextStroke() {
+    long position = stepper->currentPosition();
+    long left = planTarget - position;
+    if (left == 0) {
+        planActive = false;
+        return false;
+    }
+    
+    long direction = left > 0 ? 1 : -1;
+    if (!planReversing && labs(left) > planStroke) {
+        // Back off between forward strokes, but not on the last one
+        planReversing = true;
+        stepper->moveTo(position - direction * planReverse);
+    } else {
+        planReversing = false;
+        stepper->moveTo(labs(left) > planStroke ? position + direction * planStroke : planTarget);
+    }
+    return true;
+}
+
 /**
  * Run motor to target position (call in loop for non-blocking)
  * 
@@ -318,7 +475,18 @@ bool StepperMotor::runToPosition() {
         return false;
     }
     
+    if (waveformMoveActive) {
+        if (waveform->isBusy()) {
+            return true;
+        }
+        finishWaveformMove();
+        return false;
+    }
+    
     bool stillRunning = stepper->run();
+    if (!stillRunning && planActive) {
+        stillRunning = startNextStroke();
+    }
     if (!stillRunning) {
         disableMotor();
     }
@@ -342,11 +510,73 @@ bool StepperMotor::runSpeed() {
  * Main run function - call frequently in loop for non-blocking operation
  */
 void StepperMotor::run() {
-    if (isInitialized && stepper) {
-        stepper->run();
+    if (!isInitialized || !stepper) {
+        return;
+    }
+    
+    // Before stepping, so the homing approach takes the position at the edge
+    if (indexSensor) {
+        serviceIndex();
+    }
+    
+    if (waveformMoveActive) {
+        // RMT plays the steps - only watch for the end of the move
+        if (!waveform->isBusy()) {
+            finishWaveformMove();
+        }
+    } else if (!stepper->run() && planActive) {
+        startNextStroke();
+    }
+    
+    if (homingState != HOMING_IDLE) {
+        updateHoming();
+    }
+    
+    trackMoveTiming();
+}
+
+/**
+ * Timestamp the first step (AccelStepper path) and the end of the async move
+ */
+void StepperMotor::trackMoveTiming() {
+    if (moveEnded) {
+        return;
+    }
+    if (!moveStepped && stepper->currentPosition() != moveStartPosition) {
+        moveFirstStepUs = micros();
+        moveStepped = true;
+    }
+    if (!isRunning()) {
+        moveEndUs = micros();
+        moveEnded = true;
     }
 }
 
+/**
+ * Complete an RMT move: sync AccelStepper's position and release the coils
+ * Coils are de-energized like after blocking moves (AccelStepper holds them)
+ */
+void StepperMotor::finishWaveformMove() {
+    waveformMoveActive = false;
+    stepper->setCurrentPosition(waveformTargetPosition);
+    waveform->releaseCoils();
+    disableMotor();
+}
+
+/**
+ * Estimate the live position of an RMT move
+ * Resolution is one half RMT buffer (about 64 steps) while playing; exact
+ * once the waveform was stopped
+ * 
+ * @return Position in steps
+ */
+long StepperMotor::getWaveformPosition() const {
+    long played = waveform->getStepsCompleted();
+    return waveformTargetPosition >= waveformStartPosition
+        ? waveformStartPosition + played
+        : waveformStartPosition - played;
+}
+
 /**
  * Get current position in steps
  * 
@@ -356,6 +586,9 @@ long StepperMotor::getCurrentPosition() const {
     if (!isInitialized || !stepper) {
         return 0;
     }
+    if (waveformMoveActive) {
+        return getWaveformPosition();
+    }
     return stepper->currentPosition();
 }
 
@@ -368,6 +601,7 @@ void StepperMotor::resetPosition() {
         return;
     }
     
+    homeOrigin -= stepper->currentPosition();  // Absolute angle is unchanged
     stepper->setCurrentPosition(0);
     Serial.println(F("Position reset to zero"));
 }
@@ -383,6 +617,7 @@ void StepperMotor::setCurrentPosition(long position) {
         return;
     }
     
+    homeOrigin += position - stepper->currentPosition();  // Absolute angle is unchanged
     stepper->setCurrentPosition(position);
     Serial.print(F("Position set to "));
     Serial.println(position);
@@ -397,6 +632,9 @@ long StepperMotor::getTargetPosition() const {
     if (!isInitialized || !stepper) {
         return 0;
     }
+    if (planActive) {
+        return planTarget;
+    }
     return stepper->targetPosition();
 }
 
@@ -409,6 +647,12 @@ long StepperMotor::distanceToGo() const {
     if (!isInitialized || !stepper) {
         return 0;
     }
+    if (waveformMoveActive) {
+        return waveformTargetPosition - getWaveformPosition();
+    }
+    if (planActive) {
+        return planTarget - stepper->currentPosition();
+    }
     return stepper->distanceToGo();
 }
 
@@ -421,9 +665,326 @@ bool StepperMotor::isRunning() const {
     if (!isInitialized || !stepper) {
         return false;
     }
+    if (waveformMoveActive || planActive || homingState != HOMING_IDLE) {
+        return true;
+    }
     return stepper->isRunning();
 }
 
+/**
+ * Get the profile segment of the current async move
+ * Both the RMT and AccelStepper paths use the same trapezoid: the ramp covers
+ * maxSpeed² / (2 * acceleration) steps, or half the move if it is shorter
+ * 
+ * @return MOTION_IDLE when not moving
+ */
+StepperMotor::MotionPhase StepperMotor::getMotionPhase() const {
+    if (!isRunning()) {
+        return MOTION_IDLE;
+    }
+    
+    long done = getMoveStepsCompleted();
+    long left = labs(distanceToGo());
+    float rampSteps = (maxSpeed * maxSpeed) / (2.0f * acceleration);
+    float halfMove = (done + left) / 2.0f;
+    if (rampSteps > halfMove) {
+        rampSteps = halfMove;
+    }
+    
+    if (left <= rampSteps) {
+        return MOTION_DECELERATING;
+    }
+    return done < rampSteps ? MOTION_ACCELERATING : MOTION_CRUISING;
+}
+
+/**
+ * Get progress of the current async move
+ * 
+ * @return Steps output since the move started (RMT: half-buffer resolution)
+ */
+long StepperMotor::getMoveStepsCompleted() const {
+    if (!isInitialized || !stepper) {
+        return 0;
+    }
+    return labs(getCurrentPosition() - moveStartPosition);
+}
+
+/**
+ * Get the time the last async move output its first step
+ * 
+ * @param us: micros() of the first step (set when true is returned)
+ * @return false if the move has not stepped yet
+ */
+bool StepperMotor::getMoveFirstStepMicros(uint32_t& us) const {
+    if (!moveStepped) {
+        return false;
+    }
+    us = moveFirstStepUs;
+    return true;
+}
+
+/**
+ * Get the time run() saw the last async move complete (10 ms task resolution)
+ * 
+ * @param us: micros() of the end (set when true is returned)
+ * @return false while the move runs
+ */
+bool StepperMotor::getMoveEndMicros(uint32_t& us) const {
+    if (!moveEnded) {
+        return false;
+    }
+    us = moveEndUs;
+    return true;
+}
+
+/**
+ * Estimate how long an async move takes with the current speed settings
+ * Uses the RMT waveform's StrokePlan; the AccelStepper fallback follows the same
+ * trapezoid per stroke
+ * 
+ * @param steps: Net move in steps
+ * @param strokeSteps, reverseSteps: Stroke plan (0 = single stroke)
+ * @return Duration in milliseconds
+ */
+unsigned long StepperMotor::estimateMoveMs(long steps, uint16_t strokeSteps, uint16_t reverseSteps) const {
+    return (StrokePlan::estimateDuration(steps, maxSpeed, acceleration, strokeSteps, reverseSteps) + 500) / 1000;
+}
+
+/**
+ * Attach the auger index sensor (enables homing and lost-step checks)
+ * 
+ * @param sensor: Initialized index sensor (nullptr = none)
+ */
+void StepperMotor::setIndexSensor(IndexSensor* sensor) {
+    indexSensor = sensor;
+    homed = false;
+    if (sensor) {
+        handledIndexEdges = sensor->getEdgeCount();
+    }
+}
+
+/**
+ * Check if an index sensor is attached
+ */
+bool StepperMotor::hasIndexSensor() const {
+    return indexSensor != nullptr;
+}
+
+/**
+ * Get the attached index sensor
+ * 
+ * @return Sensor, or nullptr if none
+ */
+IndexSensor* StepperMotor::getIndexSensor() const {
+    return indexSensor;
+}
+
+/**
+ * Start homing against the index sensor (non-blocking)
+ * Progress is driven by run(); isHoming() stays true until it ends
+ * 
+ * @return true if homing started
+ */
+bool StepperMotor::startHoming() {
+    if (!isInitialized || !stepper) {
+        Serial.println(F("ERROR: Motor not initialized"));
+        return false;
+    }
+    
+    if (!indexSensor) {
+        Serial.println(F("ERROR: No index sensor - homing unavailable"));
+        return false;
+    }
+    
+    if (isRunning()) {
+        Serial.println(F("ERROR: Motor busy - cannot home while moving"));
+        return false;
+    }
+    
+    Serial.println(F("Homing auger against index sensor..."));
+    homed = false;
+    indexChecks = 0;
+    handledIndexEdges = indexSensor->getEdgeCount();
+    
+    long position = stepper->currentPosition();
+    if (indexSensor->isActive()) {
+        // Already on the index: its edge is behind us, back off first
+        homingState = HOMING_BACKOFF;
+        moveToPositionAsync(position - feedDirection() * (long)HOMING_BACKOFF_STEPS);
+    } else {
+        homingState = HOMING_SEARCH;
+        moveToPositionAsync(position + feedDirection() * (long)HOMING_SEARCH_STEPS);
+    }
+    return true;
+}
+
+/**
+ * Check if homing is in progress
+ */
+bool StepperMotor::isHoming() const {
+    return homingState != HOMING_IDLE;
+}
+
+/**
+ * Check if the absolute position is referenced to the index
+ */
+bool StepperMotor::isHomed() const {
+    return homed;
+}
+
+/**
+ * Get the auger angle from the index
+ * 
+ * @return Steps past the index in the position counter's direction,
+ *         0 to stepsPerRevolution - 1 (0 if not homed)
+ */
+long StepperMotor::getAbsolutePosition() const {
+    if (!homed) {
+        return 0;
+    }
+    long angle = (getCurrentPosition() - homeOrigin) % stepsPerRevolution;
+    return angle < 0 ? angle + stepsPerRevolution : angle;
+}
+
+/**
+ * Get the number of index checks that found lost steps
+ */
+uint32_t StepperMotor::getLostStepEvents() const {
+    return lostStepEvents;
+}
+
+/**
+ * Get the position error found by the last lost-step event
+ * 
+ * @return Error in steps (sign = direction of the counter drift)
+ */
+long StepperMotor::getLastIndexError() const {
+    return lastIndexError;
+}
+
+/**
+ * Handle index edges captured by the sensor ISR
+ * During homing the edge drives the sequence; otherwise each pass while
+ * moving in the feed direction checks the position against the homed origin
+ * 
+ * The position is taken at the edge timestamp: exact for RMT moves (step
+ * timing replay), the current step for AccelStepper (serviced before every
+ * step). Edges crossed backwards - reverse strokes of an anti-clog profile,
+ * reverse moves - are skipped: the sensor fires on the other side of the
+ * flag then, so the angle would be off by the flag width.
+ */
+void StepperMotor::serviceIndex() {
+    uint32_t edges = indexSensor->getEdgeCount();
+    if (edges == handledIndexEdges) {
+        return;
+    }
+    handledIndexEdges = edges;
+    
+    long position;
+    int direction;  // Travel direction at the edge (position counter sign)
+    if (waveformMoveActive) {
+        int32_t played = 0;
+        bool reversing = false;
+        waveform->getProgressAt(indexSensor->getLastEdgeUs(), played, reversing);
+        int moveDirection = waveformTargetPosition >= waveformStartPosition ? 1 : -1;
+        position = waveformStartPosition + moveDirection * played;
+        direction = reversing ? -moveDirection : moveDirection;
+    } else {
+        position = stepper->currentPosition();
+        direction = stepper->speed() < 0 ? -1 : 1;
+    }
+    
+    if (homingState == HOMING_SEARCH) {
+        // Coarse edge: back off, then approach slowly for the exact position
+        homingState = HOMING_BACKOFF;
+        moveToPositionAsync(position - feedDirection() * (long)HOMING_BACKOFF_STEPS);
+        return;
+    }
+    if (homingState == HOMING_APPROACH) {
+        homeOrigin = position;
+        stepper->setCurrentPosition(position);  // Stops the approach on this step
+        finishHoming(true);
+        return;
+    }
+    if (homingState == HOMING_BACKOFF || !homed || !isRunning() || direction != feedDirection()) {
+        return;  // Crossing the index backwards, or noise while idle
+    }
+    
+    // Distance from the expected index position, wrapped to half a revolution
+    long error = (position - homeOrigin) % stepsPerRevolution;
+    if (error < 0) {
+        error += stepsPerRevolution;
+    }
+    if (error >= stepsPerRevolution / 2) {
+        error -= stepsPerRevolution;
+    }
+    
+    indexChecks++;
+    if (labs(error) > INDEX_LOST_STEP_TOLERANCE) {
+        lostStepEvents++;
+        lastIndexError = error;
+        homeOrigin = position;  // Re-sync to the index
+        Serial.print(F("WARNING: Lost steps detected at index ("));
+        Serial.print(error);
+        Serial.println(F(" steps) - position re-synced"));
+    }
+}
+
+/**
+ * Advance the homing sequence when the current move ends
+ * Called from run() after the move was serviced
+ */
+void StepperMotor::updateHoming() {
+    if (waveformMoveActive || planActive || stepper->isRunning()) {
+        return;
+    }
+    
+    switch (homingState) {
+        case HOMING_SEARCH:
+            Serial.println(F("ERROR: Homing failed - no index edge within search range"));
+            finishHoming(false);
+            break;
+        case HOMING_BACKOFF:
+            // AccelStepper takes at most one step per motor task run here, so
+            // the edge is handled before the next step (exact position)
+            homingState = HOMING_APPROACH;
+            handledIndexEdges = indexSensor->getEdgeCount();
+            stepper->moveTo(stepper->currentPosition() + feedDirection() * 2L * HOMING_BACKOFF_STEPS);
+            break;
+        case HOMING_APPROACH:
+            Serial.println(F("ERROR: Homing failed - index edge lost during approach"));
+            finishHoming(false);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * End the homing sequence and release the coils
+ * 
+ * @param success: Index found (homeOrigin is set)
+ */
+void StepperMotor::finishHoming(bool success) {
+    homingState = HOMING_IDLE;
+    homed = success;
+    disableMotor();
+    
+    if (success) {
+        Serial.print(F("Auger homed - index at position "));
+        Serial.println(homeOrigin);
+    }
+}
+
+/**
+ * Feeding direction as a position counter sign
+ * 
+ * @return +1 for clockwise feeding, -1 for counter-clockwise
+ */
+int StepperMotor::feedDirection() const {
+    return motorDirectionClockwise ? 1 : -1;
+}
+
 /**
  * Stop motor and disable coils
  */
@@ -432,6 +993,21 @@ void StepperMotor::stop() {
         return;
     }
     
+    homingState = HOMING_IDLE;
+    
+    // Halt RMT playback before touching AccelStepper state (exact position
+    // of the stopped move)
+    if (waveformMoveActive) {
+        waveform->stop();
+        stepper->setCurrentPosition(getWaveformPosition());
+        waveform->releaseCoils();
+        waveformMoveActive = false;
+    }
+    planActive = false;
+    
+    // Keep the absolute angle across the position reset below
+    homeOrigin -= stepper->currentPosition();
+    
     // CRITICAL: Stop movement immediately by clearing target position
     stepper->stop();  // AccelStepper's stop() sets target to current position
     stepper->setCurrentPosition(0);  // Reset position counter
@@ -460,17 +1036,19 @@ void StepperMotor::printStatus() const {
     Serial.println(isInitialized ? F("Yes") : F("No"));
     
     if (isInitialized && stepper) {
+        Serial.print(F("Async Backend: "));
+        Serial.println(waveform ? F("RMT waveform") : F("AccelStepper"));
         Serial.print(F("Current Position: "));
-        Serial.print(stepper->currentPosition());
+        Serial.print(getCurrentPosition());
         Serial.println(F(" steps"));
         Serial.print(F("Target Position: "));
-        Serial.print(stepper->targetPosition());
+        Serial.print(getTargetPosition());
         Serial.println(F(" steps"));
         Serial.print(F("Distance to Go: "));
-        Serial.print(stepper->distanceToGo());
+        Serial.print(distanceToGo());
         Serial.println(F(" steps"));
         Serial.print(F("Is Running: "));
-        Serial.println(stepper->isRunning() ? F("Yes") : F("No"));
+        Serial.println(isRunning() ? F("Yes") : F("No"));
         Serial.print(F("Max Speed: "));
         Serial.print(maxSpeed);
         Serial.println(F(" steps/sec"));
@@ -479,6 +1057,32 @@ void StepperMotor::printStatus() const {
         Serial.println(F(" steps/sec²"));
         Serial.print(F("Motor Direction: "));
         Serial.println(motorDirectionClockwise ? F("CLOCKWISE (CW)") : F("COUNTER-CLOCKWISE (CCW)"));
+        
+        if (indexSensor) {
+            Serial.print(F("Homing: "));
+            if (homingState != HOMING_IDLE) {
+                Serial.println(F("IN PROGRESS"));
+            } else {
+                Serial.println(homed ? F("HOMED") : F("NOT HOMED"));
+            }
+            if (homed) {
+                Serial.print(F("Absolute Position: "));
+                Serial.print(getAbsolutePosition());
+                Serial.print(F(" / "));
+                Serial.print(stepsPerRevolution);
+                Serial.println(F(" steps from index"));
+            }
+            Serial.print(F("Index Checks: "));
+            Serial.print(indexChecks);
+            Serial.print(F(", Lost-Step Events: "));
+            Serial.print(lostStepEvents);
+            if (lostStepEvents > 0) {
+                Serial.print(F(" (last error "));
+                Serial.print(lastIndexError);
+                Serial.print(F(" steps)"));
+            }
+            Serial.println();
+        }
     }
     
     Serial.print(F("Steps per Revolution: "));
@@ -576,3 +1180,64 @@ void StepperMotor::performFullRevolution() {
     Serial.println(endPosition - startPosition);
 }
 
+
+/**
+ * Measure the CPU cost of one coil phase update for each driver path
+ * Coils are toggled without motion (far above the motor's step rate) and
+ * disabled afterwards. Loop overhead is included in both figures.
+ * 
+ * @param iterations: Number of phase updates to time per driver
+ */
+void StepperMotor::benchmarkStepUpdate(uint32_t iterations) {
+    if (!isInitialized || !stepper) {
+        Serial.println(F("ERROR: Motor not initialized"));
+        return;
+    }
+    
+    if (isRunning()) {
+        Serial.println(F("ERROR: Motor busy - benchmark requires an idle motor"));
+        return;
+    }
+    
+    if (iterations == 0) {
+        iterations = 1000;
+    }
+    
+    Serial.print(F("Benchmarking coil update ("));
+    Serial.print(iterations);
+    Serial.println(F(" phase changes per driver)..."));
+    
+    RuntimeStepProbe runtimeProbe(pin1, pin2, pin3, pin4);
+    uint32_t start = ESP.getCycleCount();
+    for (uint32_t i = 0; i < iterations; i++) {
+        runtimeProbe.probe((long)i);
+    }
+    uint32_t runtimeCycles = ESP.getCycleCount() - start;
+    
+    Serial.print(F("Runtime digitalWrite:   "));
+    Serial.print((float)runtimeCycles / iterations, 1);
+    Serial.println(F(" cycles/update"));
+    
+    if (fastPhaseWriter) {
+        start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < iterations; i++) {
+            fastPhaseWriter((long)i);
+        }
+        uint32_t fastCycles = ESP.getCycleCount() - start;
+        
+        Serial.print(F("Compile-time registers: "));
+        Serial.print((float)fastCycles / iterations, 1);
+        Serial.println(F(" cycles/update"));
+        Serial.print(F("Speedup: "));
+        Serial.print(fastCycles > 0 ? (float)runtimeCycles / fastCycles : 0.0f, 1);
+        Serial.println(F("x"));
+    } else {
+        Serial.println(F("Compile-time registers: not in use (runtime-pin build)"));
+    }
+    
+    Serial.print(F("CPU frequency: "));
+    Serial.print(ESP.getCpuFreqMHz());
+    Serial.println(F(" MHz"));
+    
+    disableMotor();
+}
@@ -3,41 +3,127 @@
 
 #include <Arduino.h>
 #include <AccelStepper.h>
+#include "stepper_waveform.h"
+#include "stepper_driver.h"
+#include "index_sensor.h"
 
 /**
  * StepperMotor Class
  * 
  * Manages a 28BYJ-48 stepper motor with ULN2003 driver
  * Uses AccelStepper library for smooth acceleration/deceleration control
+ * Non-blocking moves are offloaded to the RMT peripheral when available
+ * (see StepperWaveform), falling back to AccelStepper stepping otherwise
  * 
  * Hardware Configuration:
  * - Motor: 28BYJ-48 (2048 steps per revolution in half-step mode)
  * - Driver: ULN2003 
  * - Pins: IN1, IN2, IN3, IN4 configurable via constructor
+ * 
+ * Drivers:
+ * - StepperMotor(in1, in2, in3, in4): runtime pins, AccelStepper digitalWrite() stepping
+ * - StepperMotor(StepperDriver<...>&): compile-time pins, direct GPIO register stepping
+ * 
+ * Homing (optional IndexSensor, one pulse per revolution):
+ * - startHoming() finds the index without blocking (see config.h sequence)
+ * - getAbsolutePosition() is the auger angle in steps from the index
+ * - Every index pass in the feed direction checks the angle at the edge
+ *   time; an error above INDEX_LOST_STEP_TOLERANCE counts as lost steps
+ *   and re-syncs the origin (reverse strokes are not checked)
  */
 class StepperMotor {
+public:
+    /**
+     * Segment of the trapezoidal profile the current async move is in
+     */
+    enum MotionPhase {
+        MOTION_IDLE,
+        MOTION_ACCELERATING,
+        MOTION_CRUISING,
+        MOTION_DECELERATING
+    };
+    
+    /**
+     * Homing sequence step (HOMING_IDLE when not homing)
+     */
+    enum HomingState {
+        HOMING_IDLE,
+        HOMING_SEARCH,
+        HOMING_BACKOFF,
+        HOMING_APPROACH
+    };
+
 private:
     AccelStepper* stepper;               // AccelStepper library instance
+    AccelStepper* externalDriver;        // Compile-time driver supplied by the caller (not owned)
+    void (*fastPhaseWriter)(long);       // StepperDriver::writePhase when using a compile-time driver
     int stepsPerRevolution;              // Steps per full revolution
     int pin1, pin2, pin3, pin4;         // Motor control pins
     bool isInitialized;                  // Initialization status
     float maxSpeed;                      // Maximum speed in steps/second
     float acceleration;                  // Acceleration in steps/second^2
     bool motorDirectionClockwise;        // Motor rotation direction (true = CW, false = CCW)
+    long moveStartPosition;              // Position when the last async move started
+    
+    // Step engine timing of the last async move (feed latency tracking)
+    bool moveStepped;                    // First step output
+    bool moveEnded;                      // Move seen complete by run()
+    uint32_t moveFirstStepUs;            // micros() of the first step
+    uint32_t moveEndUs;                  // micros() when run() saw the move end
+    
+    // RMT coil sequencer (nullptr when disabled or unavailable)
+    StepperWaveform* waveform;
+    bool waveformMoveActive;             // Async move currently played by RMT
+    long waveformStartPosition;          // Position when the RMT move started
+    long waveformTargetPosition;         // Absolute target of the RMT move
+    
+    // Oscillating stroke plan on the AccelStepper fallback (RMT plays it in one waveform)
+    bool planActive;                     // Stroke plan in progress
+    bool planReversing;                  // Current stroke runs against the move direction
+    long planTarget;                     // Net target of the whole move
+    uint16_t planStroke;                 // Forward stroke length
+    uint16_t planReverse;                // Reverse stroke length between forward strokes
+    
+    // Index sensor homing and lost-step detection (nullptr = no sensor)
+    IndexSensor* indexSensor;
+    HomingState homingState;
+    bool homed;                          // homeOrigin matches the index
+    long homeOrigin;                     // Position counter value at the index edge
+    uint32_t handledIndexEdges;          // Last IndexSensor edge count processed
+    uint32_t indexChecks;                // Index passes checked since homing
+    uint32_t lostStepEvents;             // Checks beyond INDEX_LOST_STEP_TOLERANCE
+    long lastIndexError;                 // Error of the last lost-step event (steps)
     
     // Internal methods
     void initializePins();
     void disableMotor();
+    void finishWaveformMove();
+    void trackMoveTiming();
+    long getWaveformPosition() const;
+    bool startNextStroke();
+    void serviceIndex();
+    void updateHoming();
+    void finishHoming(bool success);
+    int feedDirection() const;
 
 public:
     // Constructor and destructor
     StepperMotor(int in1, int in2, int in3, int in4, int stepsPerRev = 2048);
+    
+    template <uint8_t IN1, uint8_t IN2, uint8_t IN3, uint8_t IN4>
+    explicit StepperMotor(StepperDriver<IN1, IN2, IN3, IN4>& driver, int stepsPerRev = 2048)
+        : StepperMotor(IN1, IN2, IN3, IN4, stepsPerRev) {
+        externalDriver = &driver;
+        fastPhaseWriter = &StepperDriver<IN1, IN2, IN3, IN4>::writePhase;
+    }
     ~StepperMotor();
     
     // Initialization and configuration
     bool begin();
     void setMaxSpeed(float speed);           // Set max speed in steps/second
     void setAcceleration(float accel);       // Set acceleration in steps/second^2
+    float getMaxSpeed() const;
+    float getAcceleration() const;
     void setSpeed(float speed);              // Set constant speed for runSpeed()
     void setMotorDirection(bool clockwise);  // Set rotation direction (true = CW, false = CCW)
     bool getMotorDirection() const;          // Get current rotation direction
@@ -50,7 +136,7 @@ public:
     void moveToPosition(long targetSteps);
     
     // Movement methods (non-blocking)
-    void moveToPositionAsync(long targetSteps);
+    void moveToPositionAsync(long targetSteps, uint16_t strokeSteps = 0, uint16_t reverseSteps = 0);
     bool runToPosition();                    // Run until target reached
     bool runSpeed();                         // Run at constant speed
     void run();                              // Call in loop for non-blocking operation
@@ -63,6 +149,24 @@ public:
     long distanceToGo() const;
     bool isRunning() const;
     
+    // Motion profile (async moves)
+    MotionPhase getMotionPhase() const;      // Ramp segment from steps done/left and the accel distance
+    long getMoveStepsCompleted() const;      // Steps commanded so far in the current async move
+    unsigned long estimateMoveMs(long steps, uint16_t strokeSteps = 0, uint16_t reverseSteps = 0) const;
+    bool getMoveFirstStepMicros(uint32_t& us) const;  // false until the async move stepped
+    bool getMoveEndMicros(uint32_t& us) const;        // false until run() saw the move end
+    
+    // Index sensor homing
+    void setIndexSensor(IndexSensor* sensor);
+    bool hasIndexSensor() const;
+    IndexSensor* getIndexSensor() const;
+    bool startHoming();                      // Non-blocking, driven by run()
+    bool isHoming() const;
+    bool isHomed() const;
+    long getAbsolutePosition() const;        // Steps from the index, 0 to stepsPerRevolution - 1
+    uint32_t getLostStepEvents() const;
+    long getLastIndexError() const;
+    
     // Utility methods
     void stop();
     bool isReady() const;
@@ -74,6 +178,7 @@ public:
     
     // Generic utility methods
     void performFullRevolution();
+    void benchmarkStepUpdate(uint32_t iterations);  // Compare coil update cost (CPU cycles)
 };
 
 #endif // STEPPER_MOTOR_H
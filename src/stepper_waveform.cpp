@@ -0,0 +1,418 @@
+#include "stepper_waveform.h"
+#include <esp_timer.h>
+#include <soc/rmt_struct.h>
+#include <soc/gpio_sig_map.h>
+
+// RMT memory is split in two halves: one plays while the other is refilled
+static const uint16_t WAVEFORM_BLOCK_ITEMS = RMT_MEM_ITEM_NUM;
+static const uint16_t WAVEFORM_HALF_ITEMS = RMT_MEM_ITEM_NUM / 2;
+
+// 80MHz APB / 80 = 1µs per RMT tick
+static const uint8_t WAVEFORM_CLOCK_DIVIDER = 80;
+
+// Longest duration that fits in one half of an RMT item (15 bits)
+static const uint32_t WAVEFORM_MAX_ITEM_TICKS = 32767;
+
+// Coil levels per phase, matching AccelStepper::step4() with pin order IN1, IN3, IN2, IN4
+//   phase 0: IN1=1 IN2=1 | phase 1: IN1=0 IN2=1 | phase 2: IN1=0 IN2=0 | phase 3: IN1=1 IN2=0
+static const uint8_t IN1_PHASE_MASK = 0b1001;
+static const uint8_t IN2_PHASE_MASK = 0b0011;
+
+static portMUX_TYPE waveformMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * Constructor: Store RMT channel assignment
+ *
+ * @param rmtChannelA: RMT channel for the IN1/IN3 coil pair
+ * @param rmtChannelB: RMT channel for the IN2/IN4 coil pair
+ */
+StepperWaveform::StepperWaveform(uint8_t rmtChannelA, uint8_t rmtChannelB)
+    : moveStartUs(0), replayUs(0), replaySteps(0), replayReversing(false),
+      replayPending(false), replayIntervalUs(0),
+      pinIN1(-1), pinIN2(-1), pinIN3(-1), pinIN4(-1),
+      isInitialized(false), coilsAttached(false), isrHandle(nullptr) {
+    memset(&channelA, 0, sizeof(channelA));
+    memset(&channelB, 0, sizeof(channelB));
+    memset(&replay, 0, sizeof(replay));
+    channelA.channel = rmtChannelA;
+    channelA.phaseMask = IN1_PHASE_MASK;
+    channelB.channel = rmtChannelB;
+    channelB.phaseMask = IN2_PHASE_MASK;
+
+    // Same bit layout as serviceChannel(): tx_end at ch * 3, tx_thr_event at 24 + ch
+    interruptMask = (1UL << (rmtChannelA * 3)) | (1UL << (24 + rmtChannelA)) |
+                    (1UL << (rmtChannelB * 3)) | (1UL << (24 + rmtChannelB));
+}
+
+/**
+ * Configure both RMT channels and install the refill interrupt
+ *
+ * @param in1, in2, in3, in4: ULN2003 control pins (IN1-IN4)
+ * @return: true if the RMT peripheral is ready for playback
+ */
+bool StepperWaveform::begin(int in1, int in2, int in3, int in4) {
+    pinIN1 = in1;
+    pinIN2 = in2;
+    pinIN3 = in3;
+    pinIN4 = in4;
+
+    ChannelState* states[2] = { &channelA, &channelB };
+    int pins[2] = { in1, in2 };
+
+    for (int i = 0; i < 2; i++) {
+        rmt_channel_t channel = (rmt_channel_t)states[i]->channel;
+
+        rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pins[i], channel);
+        config.clk_div = WAVEFORM_CLOCK_DIVIDER;
+        config.mem_block_num = 1;
+        config.tx_config.loop_en = false;
+        config.tx_config.carrier_en = false;
+        config.tx_config.idle_output_en = true;
+        config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+        if (rmt_config(&config) != ESP_OK) {
+            Serial.println(F("ERROR: RMT channel configuration failed"));
+            return false;
+        }
+
+        // Threshold event every half block drives the ping-pong refill
+        rmt_set_tx_thr_intr_en(channel, true, WAVEFORM_HALF_ITEMS);
+        rmt_set_tx_intr_en(channel, true);
+    }
+
+    // Wrap around at the end of the block instead of stopping. The ESP32 has
+    // no per-channel wrap: the bit is peripheral-wide, so any other RMT TX
+    // user must end its items with an end marker inside its own block or it
+    // replays stale items. The RMT driver's own ISR (rmt_driver_install)
+    // cannot run alongside rmt_isr_register() anyway.
+    RMT.apb_conf.mem_tx_wrap_en = 1;
+
+    if (rmt_isr_register(&StepperWaveform::isrHandler, this, ESP_INTR_FLAG_IRAM, &isrHandle) != ESP_OK) {
+        Serial.println(F("ERROR: RMT interrupt registration failed"));
+        return false;
+    }
+
+    // rmt_config() routed IN1/IN2 to RMT - keep them on GPIO until a move starts
+    coilsAttached = true;
+    releaseCoils();
+
+    isInitialized = true;
+    Serial.print(F("RMT coil sequencer ready on channels "));
+    Serial.print(channelA.channel);
+    Serial.print(F(" (IN1/IN3) and "));
+    Serial.print(channelB.channel);
+    Serial.println(F(" (IN2/IN4)"));
+    return true;
+}
+
+/**
+ * Reset a channel's generator for a new move (plan already loaded)
+ *
+ * @param state: Channel to reset
+ * @param startPosition: Current position in steps
+ */
+void StepperWaveform::initializeChannel(ChannelState& state, long startPosition) {
+    state.phase = (uint8_t)(startPosition & 0x03);
+
+    state.level = (state.phaseMask >> state.phase) & 0x01;
+    state.runTicks = 0;
+    state.outTicks = 0;
+    state.outLevel = state.level;
+    state.exhausted = false;
+    state.nextHalf = 0;
+    state.fillSteps = 0;
+    state.stepsPlayed = 0;
+    state.stepsGenerated = 0;
+
+    // Preload the whole block; the first threshold event refills half 0
+    state.halfSteps[0] = fillItems(state, 0, WAVEFORM_HALF_ITEMS);
+    state.halfSteps[1] = fillItems(state, WAVEFORM_HALF_ITEMS, WAVEFORM_HALF_ITEMS);
+}
+
+/**
+ * Start playing a trapezoidal move (non-blocking)
+ *
+ * @param startPosition: Current position in steps (selects the starting coil phase)
+ * @param steps: Relative move in steps (sign = direction)
+ * @param maxSpeed: Cruise speed in steps/second
+ * @param acceleration: Acceleration in steps/second²
+ * @return: true if playback started
+ */
+bool StepperWaveform::start(long startPosition, long steps, float maxSpeed, float acceleration,
+                            uint16_t strokeSteps, uint16_t reverseSteps) {
+    if (!isInitialized || isBusy() || steps == 0) {
+        return false;
+    }
+
+    // Both channels and the replay walk their own copy of the same plan
+    replay.begin(StrokePlan::makeRamp(maxSpeed, acceleration), steps, strokeSteps, reverseSteps);
+    channelA.plan = replay;
+    channelB.plan = replay;
+    initializeChannel(channelA, startPosition);
+    initializeChannel(channelB, startPosition);
+
+    replayUs = 0;
+    replaySteps = 0;
+    replayReversing = false;
+    replayPending = false;
+
+    // Outputs show the current phase until the first edge, then hold the final phase
+    uint8_t finalPhase = (uint8_t)((startPosition + steps) & 0x03);
+    rmt_set_idle_level((rmt_channel_t)channelA.channel, true, (rmt_idle_level_t)(channelA.level ? 1 : 0));
+    rmt_set_idle_level((rmt_channel_t)channelB.channel, true, (rmt_idle_level_t)(channelB.level ? 1 : 0));
+    attachCoils();
+
+    channelA.active = true;
+    channelB.active = true;
+
+    // Start both channels back to back so the quadrature stays aligned
+    portENTER_CRITICAL(&waveformMux);
+    RMT.conf_ch[channelA.channel].conf1.idle_out_lv = (IN1_PHASE_MASK >> finalPhase) & 0x01;
+    RMT.conf_ch[channelB.channel].conf1.idle_out_lv = (IN2_PHASE_MASK >> finalPhase) & 0x01;
+    RMT.conf_ch[channelA.channel].conf1.mem_rd_rst = 1;
+    RMT.conf_ch[channelA.channel].conf1.mem_rd_rst = 0;
+    RMT.conf_ch[channelB.channel].conf1.mem_rd_rst = 1;
+    RMT.conf_ch[channelB.channel].conf1.mem_rd_rst = 0;
+    RMT.conf_ch[channelA.channel].conf1.tx_start = 1;
+    RMT.conf_ch[channelB.channel].conf1.tx_start = 1;
+    moveStartUs = esp_timer_get_time();
+    portEXIT_CRITICAL(&waveformMux);
+
+    return true;
+}
+
+/**
+ * Abort playback immediately
+ * The step count is set to the exact steps output before the stop (step
+ * timing replay), so the caller can resume from the real rotor position
+ */
+void StepperWaveform::stop() {
+    if (!isInitialized) {
+        return;
+    }
+    bool wasBusy = isBusy();
+
+    // Prevent the interrupt from queueing more steps or updating the step
+    // count before the channels halt
+    portENTER_CRITICAL(&waveformMux);
+    channelA.exhausted = true;
+    channelB.exhausted = true;
+    channelA.active = false;
+    channelB.active = false;
+    portEXIT_CRITICAL(&waveformMux);
+
+    rmt_tx_stop((rmt_channel_t)channelA.channel);
+    int64_t stoppedUs = esp_timer_get_time();
+    rmt_tx_stop((rmt_channel_t)channelB.channel);
+
+    if (wasBusy) {
+        int32_t steps = 0;
+        bool reversing = false;
+        getProgressAt(stoppedUs, steps, reversing);
+        channelA.stepsPlayed = steps;
+    }
+}
+
+/**
+ * Route the RMT outputs to the coil pins
+ * IN3/IN4 are the complements of IN1/IN2 so they use the inverted matrix output
+ */
+void StepperWaveform::attachCoils() {
+    if (coilsAttached) {
+        return;
+    }
+
+    pinMatrixOutAttach(pinIN1, RMT_SIG_OUT0_IDX + channelA.channel, false, false);
+    pinMatrixOutAttach(pinIN3, RMT_SIG_OUT0_IDX + channelA.channel, true, false);
+    pinMatrixOutAttach(pinIN2, RMT_SIG_OUT0_IDX + channelB.channel, false, false);
+    pinMatrixOutAttach(pinIN4, RMT_SIG_OUT0_IDX + channelB.channel, true, false);
+    coilsAttached = true;
+}
+
+/**
+ * Hand the coil pins back to GPIO control
+ */
+void StepperWaveform::releaseCoils() {
+    if (!coilsAttached) {
+        return;
+    }
+
+    pinMatrixOutDetach(pinIN1, false, false);
+    pinMatrixOutDetach(pinIN2, false, false);
+    pinMatrixOutDetach(pinIN3, false, false);
+    pinMatrixOutDetach(pinIN4, false, false);
+    coilsAttached = false;
+}
+
+/**
+ * @return: true while either channel is still transmitting
+ */
+bool StepperWaveform::isBusy() const {
+    return channelA.active || channelB.active;
+}
+
+/**
+ * @return: Net steps output so far for the current move
+ */
+int32_t StepperWaveform::getStepsCompleted() const {
+    return channelA.stepsPlayed;
+}
+
+/**
+ * Exact progress of the current move at a given time
+ * Walks the plan from the previous call: about one revolution of steps per
+ * index edge, integer math only
+ */
+void StepperWaveform::getProgressAt(int64_t atUs, int32_t& steps, bool& reversing) {
+    int64_t elapsedUs = atUs - moveStartUs;
+
+    while (true) {
+        if (!replayPending) {
+            if (replay.ramp.remaining == 0 && !replay.nextStroke()) {
+                break;  // Move complete
+            }
+            replayIntervalUs = replay.nextStepInterval();
+            replayPending = true;
+        }
+        if (replayUs + replayIntervalUs > elapsedUs) {
+            break;
+        }
+        replayUs += replayIntervalUs;
+        replayPending = false;
+        replaySteps += replay.reversing ? -1 : 1;
+        replayReversing = replay.reversing;
+    }
+
+    steps = replaySteps;
+    reversing = replayReversing;
+}
+
+/**
+ * @return: true if begin() succeeded
+ */
+bool StepperWaveform::isReady() const {
+    return isInitialized;
+}
+
+// ============================================================================
+// INTERRUPT PATH - everything below runs from IRAM with the cache disabled
+// ============================================================================
+
+/**
+ * RMT interrupt: refill consumed halves and detect end of transmission
+ */
+void IRAM_ATTR StepperWaveform::isrHandler(void* arg) {
+    StepperWaveform* self = static_cast<StepperWaveform*>(arg);
+
+    // Only this driver's channels: events of other RMT channels stay pending
+    uint32_t status = RMT.int_st.val & self->interruptMask;
+
+    serviceChannel(self->channelA, status);
+    serviceChannel(self->channelB, status);
+
+    RMT.int_clr.val = status;
+}
+
+/**
+ * Handle threshold/end events for one channel
+ *
+ * @param state: Channel to service
+ * @param status: RMT interrupt status snapshot
+ */
+void IRAM_ATTR StepperWaveform::serviceChannel(ChannelState& state, uint32_t status) {
+    uint32_t thresholdBit = 1UL << (24 + state.channel);
+    uint32_t endBit = 1UL << (state.channel * 3);
+
+    // Stopped: stop() owns the step count now
+    if (!state.active) {
+        return;
+    }
+
+    if (status & thresholdBit) {
+        // The half just played is free again
+        uint8_t half = state.nextHalf;
+        state.stepsPlayed += state.halfSteps[half];
+        state.halfSteps[half] = fillItems(state, half * WAVEFORM_HALF_ITEMS, WAVEFORM_HALF_ITEMS);
+        state.nextHalf = half ^ 1;
+    }
+
+    if (status & endBit) {
+        state.stepsPlayed = state.stepsGenerated;
+        state.active = false;
+    }
+}
+
+/**
+ * Encode the next part of the move into RMT memory
+ *
+ * @param state: Channel being filled
+ * @param offset: First item index in the channel block
+ * @param count: Number of items to write
+ * @return: Steps encoded in the written items
+ */
+uint32_t IRAM_ATTR StepperWaveform::fillItems(ChannelState& state, uint16_t offset, uint16_t count) {
+    volatile rmt_item32_t* dst = &RMTMEM.chan[state.channel].data32[offset];
+    state.fillSteps = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        rmt_item32_t item;
+        item.val = 0;  // Zero duration = end marker
+
+        uint16_t ticks;
+        bool level;
+        if (!state.exhausted && nextHalfItem(state, ticks, level)) {
+            item.duration0 = ticks;
+            item.level0 = level;
+            if (nextHalfItem(state, ticks, level)) {
+                item.duration1 = ticks;
+                item.level1 = level;
+            } else {
+                state.exhausted = true;
+            }
+        } else {
+            state.exhausted = true;
+        }
+
+        dst[i].val = item.val;
+    }
+
+    return state.fillSteps;
+}
+
+/**
+ * Produce the next (duration, level) half item for a channel
+ * Walks the ramp step by step and merges steps that keep this coil's level
+ *
+ * @param state: Channel being filled
+ * @param ticks: Output duration in µs
+ * @param level: Output level
+ * @return: false once the last edge of the move has been emitted
+ */
+bool IRAM_ATTR StepperWaveform::nextHalfItem(ChannelState& state, uint16_t& ticks, bool& level) {
+    while (state.outTicks == 0) {
+        if (state.plan.ramp.remaining == 0 && !state.plan.nextStroke()) {
+            // Time after this coil's last edge is covered by the idle level
+            return false;
+        }
+
+        state.runTicks += state.plan.nextStepInterval();
+        state.phase = (uint8_t)(state.phase + state.plan.direction) & 0x03;
+        int8_t net = state.plan.reversing ? -1 : 1;
+        state.stepsGenerated += net;
+        state.fillSteps += net;
+
+        bool newLevel = (state.phaseMask >> state.phase) & 0x01;
+        if (newLevel != state.level) {
+            state.outTicks = state.runTicks;
+            state.outLevel = state.level;
+            state.level = newLevel;
+            state.runTicks = 0;
+        }
+    }
+
+    uint32_t chunk = state.outTicks > WAVEFORM_MAX_ITEM_TICKS ? WAVEFORM_MAX_ITEM_TICKS : state.outTicks;
+    state.outTicks -= chunk;
+    ticks = (uint16_t)chunk;
+    level = state.outLevel;
+    return true;
+}
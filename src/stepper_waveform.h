@@ -0,0 +1,157 @@
+#ifndef STEPPER_WAVEFORM_H
+#define STEPPER_WAVEFORM_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include "stroke_plan.h"
+
+/**
+ * StepperWaveform Class
+ *
+ * Hardware coil sequencer for the 28BYJ-48 / ULN2003 using the ESP32 RMT peripheral.
+ *
+ * In FULL4WIRE mode the four coil lines are two square waves in quadrature
+ * plus their complements (IN3 = !IN1, IN4 = !IN2). Each wave is generated by
+ * one RMT channel: the channel output is routed to IN1/IN2 directly and to
+ * IN3/IN4 inverted through the GPIO matrix, so two channels drive all four coils.
+ *
+ * The acceleration ramp and cruise are encoded as RMT item durations (1 µs ticks);
+ * the step timing itself comes from StrokePlan (hardware-free). Oscillating moves (forward strokes with short reverse strokes between them)
+ * are one continuous plan: each stroke ramps down and the next one ramps up in
+ * the opposite direction from the same waveform, without returning to the CPU.
+ * Both channels start in the same critical section and play from a ping-pong
+ * buffer in RMT memory; the CPU only refills the consumed half from the RMT
+ * threshold interrupt, so step timing is independent of the cooperative loop
+ * and of WiFi activity.
+ *
+ * Pins are only attached to RMT while a move is playing; between moves they are
+ * plain GPIOs so AccelStepper (blocking moves, disableMotor) keeps working.
+ */
+class StepperWaveform {
+private:
+    // Per RMT channel playback state
+    struct ChannelState {
+        uint8_t channel;        // RMT channel number
+        uint8_t phaseMask;      // Coil level for phases 0-3 (bit n = phase n)
+        StrokePlan plan;        // Private copy of the plan (both channels walk the same steps)
+        uint8_t phase;          // Current coil phase (position & 3)
+        bool level;             // Level held since the last edge
+        uint32_t runTicks;      // Time accumulated at the current level
+        uint32_t outTicks;      // Completed run still to be written
+        bool outLevel;          // Level of the completed run
+        bool exhausted;         // End marker written
+        uint8_t nextHalf;       // Half of RMT memory to refill on the next threshold event
+        int32_t halfSteps[2];   // Net steps encoded in each half (reverse strokes count negative)
+        int32_t fillSteps;      // Net steps of the fill in progress
+        volatile int32_t stepsPlayed;   // Net steps already output (half-buffer resolution)
+        int32_t stepsGenerated;         // Net steps encoded so far
+        volatile bool active;           // Channel transmitting
+    };
+
+    ChannelState channelA;      // Drives IN1 and IN3 (inverted)
+    ChannelState channelB;      // Drives IN2 and IN4 (inverted)
+
+    // Step timing replay of the current move (see getProgressAt())
+    StrokePlan replay;
+    int64_t moveStartUs;        // esp_timer time playback started
+    int64_t replayUs;           // Time of the last replayed step, from moveStartUs
+    int32_t replaySteps;        // Net steps replayed
+    bool replayReversing;       // Last replayed step was part of a reverse stroke
+    bool replayPending;         // replayIntervalUs holds the next step
+    uint32_t replayIntervalUs;  // Interval before the next step
+    int pinIN1, pinIN2, pinIN3, pinIN4;
+    bool isInitialized;
+    bool coilsAttached;
+    rmt_isr_handle_t isrHandle;
+    uint32_t interruptMask;     // tx_end and tx_thr_event bits of both channels
+
+    void initializeChannel(ChannelState& state, long startPosition);
+    void attachCoils();
+
+    static void isrHandler(void* arg);
+    static void serviceChannel(ChannelState& state, uint32_t status);
+    static uint32_t fillItems(ChannelState& state, uint16_t offset, uint16_t count);
+    static bool nextHalfItem(ChannelState& state, uint16_t& ticks, bool& level);
+
+public:
+    /**
+     * Constructor
+     *
+     * @param rmtChannelA: RMT channel for the IN1/IN3 coil pair
+     * @param rmtChannelB: RMT channel for the IN2/IN4 coil pair
+     */
+    StepperWaveform(uint8_t rmtChannelA, uint8_t rmtChannelB);
+
+    /**
+     * Configure both RMT channels and install the refill interrupt
+     *
+     * @param in1, in2, in3, in4: ULN2003 control pins (IN1-IN4)
+     * @return: true if the RMT peripheral is ready for playback
+     */
+    bool begin(int in1, int in2, int in3, int in4);
+
+    /**
+     * Start playing a trapezoidal move (non-blocking)
+     *
+     * With strokeSteps > reverseSteps > 0 the move is split into forward strokes
+     * of strokeSteps with reverseSteps back after each one; the last forward
+     * stroke is shortened so the net displacement is exactly steps.
+     *
+     * @param startPosition: Current position in steps (selects the starting coil phase)
+     * @param steps: Relative move in steps (sign = direction)
+     * @param maxSpeed: Cruise speed in steps/second
+     * @param acceleration: Acceleration in steps/second²
+     * @param strokeSteps: Forward stroke length (0 = single stroke)
+     * @param reverseSteps: Reverse stroke length between forward strokes
+     * @return: true if playback started
+     */
+    bool start(long startPosition, long steps, float maxSpeed, float acceleration,
+               uint16_t strokeSteps = 0, uint16_t reverseSteps = 0);
+
+    /**
+     * Abort playback immediately
+     * getStepsCompleted() is exact afterwards (steps output before the stop)
+     */
+    void stop();
+
+    /**
+     * Hand the coil pins back to GPIO control
+     * Outputs keep their last GPIO level (normally LOW after disableMotor)
+     */
+    void releaseCoils();
+
+    /**
+     * @return: true while either channel is still transmitting
+     */
+    bool isBusy() const;
+
+    /**
+     * @return: Net steps output so far for the current move, reverse strokes
+     *          subtracted (updated every half buffer; exact once the move
+     *          ended or was stopped)
+     */
+    int32_t getStepsCompleted() const;
+
+    /**
+     * Exact progress of the current (or last) move at a given time
+     *
+     * Replays the step timing from the start of the move: RMT plays the same
+     * integer ramp and stroke plan with 1 µs resolution, so the result is
+     * exact to the step where getStepsCompleted() lags by up to half a
+     * buffer. The replay resumes where the previous call stopped; call from
+     * the motor task only, with non-decreasing times (an earlier time
+     * returns the last result).
+     *
+     * @param atUs: esp_timer time, e.g. an IndexSensor edge timestamp
+     * @param steps: Net steps output by then (reverse strokes subtracted)
+     * @param reversing: true if the last of those steps was part of a reverse stroke
+     */
+    void getProgressAt(int64_t atUs, int32_t& steps, bool& reversing);
+
+    /**
+     * @return: true if begin() succeeded
+     */
+    bool isReady() const;
+};
+
+#endif // STEPPER_WAVEFORM_H
@@ -0,0 +1,195 @@
+#include "string_builder.h"
+#include <stdio.h>
+
+// Static member initialization
+uint32_t StringBuilder::overflowCount = 0;
+
+/**
+ * Constructor: Wrap a caller-supplied buffer
+ *
+ * @param buffer: Storage for the text (including the terminator)
+ * @param capacity: Size of buffer in bytes
+ */
+StringBuilder::StringBuilder(char* buffer, size_t capacity)
+    : buffer(buffer), cap(capacity > 0 ? capacity : 1), len(0), overflow(false) {
+    this->buffer[0] = '\0';
+}
+
+// ============================================================================
+// PRINT INTERFACE
+// ============================================================================
+
+size_t StringBuilder::write(uint8_t c) {
+    if (len + 1 >= cap) {
+        markOverflow();
+        return 0;
+    }
+    buffer[len++] = (char)c;
+    buffer[len] = '\0';
+    return 1;
+}
+
+size_t StringBuilder::write(const uint8_t* data, size_t size) {
+    size_t available = cap - 1 - len;
+    if (size > available) {
+        markOverflow();
+        size = available;
+    }
+    memcpy(buffer + len, data, size);
+    len += size;
+    buffer[len] = '\0';
+    return size;
+}
+
+// ============================================================================
+// APPEND METHODS
+// ============================================================================
+
+StringBuilder& StringBuilder::append(const char* text) {
+    if (text) {
+        write((const uint8_t*)text, strlen(text));
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(const __FlashStringHelper* text) {
+    print(text);
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(char c) {
+    write((uint8_t)c);
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(long value) {
+    print(value);
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(unsigned long value) {
+    print(value);
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendFormat(const char* format, ...) {
+    size_t available = cap - len;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + len, available, format, args);
+    va_end(args);
+
+    if (written < 0) {
+        buffer[len] = '\0';
+        return *this;
+    }
+    if ((size_t)written >= available) {
+        // vsnprintf already truncated and terminated the output
+        markOverflow();
+        len = cap - 1;
+    } else {
+        len += written;
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendPadded(unsigned long value, uint8_t width) {
+    char digits[12];
+    uint8_t count = 0;
+    do {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0 && count < sizeof(digits));
+
+    while (width > count) {
+        write((uint8_t)'0');
+        width--;
+    }
+    while (count > 0) {
+        write((uint8_t)digits[--count]);
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendJsonEscaped(const char* text) {
+    if (!text) {
+        return *this;
+    }
+    for (const char* p = text; *p; p++) {
+        char c = *p;
+        switch (c) {
+            case '"':  append("\\\""); break;
+            case '\\': append("\\\\"); break;
+            case '\n': append("\\n"); break;
+            case '\r': append("\\r"); break;
+            case '\t': append("\\t"); break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    appendFormat("\\u%04x", (unsigned)c);
+                } else {
+                    write((uint8_t)c);
+                }
+                break;
+        }
+    }
+    return *this;
+}
+
+// ============================================================================
+// IN-PLACE EDITING
+// ============================================================================
+
+void StringBuilder::clear() {
+    len = 0;
+    overflow = false;
+    buffer[0] = '\0';
+}
+
+void StringBuilder::trim() {
+    size_t start = 0;
+    while (start < len && isspace((unsigned char)buffer[start])) {
+        start++;
+    }
+    size_t end = len;
+    while (end > start && isspace((unsigned char)buffer[end - 1])) {
+        end--;
+    }
+    len = end - start;
+    if (start > 0) {
+        memmove(buffer, buffer + start, len);
+    }
+    buffer[len] = '\0';
+}
+
+void StringBuilder::toUpperCase() {
+    for (size_t i = 0; i < len; i++) {
+        buffer[i] = toupper((unsigned char)buffer[i]);
+    }
+}
+
+// ============================================================================
+// COMPARISON
+// ============================================================================
+
+bool StringBuilder::equals(const char* text) const {
+    return text && strcmp(buffer, text) == 0;
+}
+
+bool StringBuilder::startsWith(const char* prefix) const {
+    return prefix && strncmp(buffer, prefix, strlen(prefix)) == 0;
+}
+
+// ============================================================================
+// OVERFLOW TRACKING
+// ============================================================================
+
+void StringBuilder::markOverflow() {
+    if (!overflow) {
+        overflow = true;
+        overflowCount++;
+    }
+}
+
+uint32_t StringBuilder::getOverflowCount() {
+    return overflowCount;
+}
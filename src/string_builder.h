@@ -0,0 +1,151 @@
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+/**
+ * StringBuilder Class
+ *
+ * Heap-free text builder over a caller-supplied buffer, for the paths that
+ * run all day (NVRAM keys, log lines, JSON responses, status reports).
+ * Arduino String reallocates on every append; on a device that runs for
+ * months those short-lived blocks fragment the heap until a large request
+ * can no longer be served.
+ *
+ * Features:
+ * - Print-compatible: print()/println() of numbers, F() strings and
+ *   Strings write straight into the buffer
+ * - Always NUL-terminated; appends past capacity are truncated and flagged
+ *   (overflowed()) and counted globally (getOverflowCount())
+ * - In-place helpers for the command parser (trim, toUpperCase)
+ *
+ * Use FixedString<N> for inline (stack/member) storage.
+ */
+class StringBuilder : public Print {
+public:
+    /**
+     * Constructor
+     *
+     * @param buffer: Storage for the text (including the terminator)
+     * @param capacity: Size of buffer in bytes (must be at least 1)
+     */
+    StringBuilder(char* buffer, size_t capacity);
+
+    // Print interface
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t size) override;
+    using Print::write;
+
+    /**
+     * Append text (chainable)
+     */
+    StringBuilder& append(const char* text);
+    StringBuilder& append(const __FlashStringHelper* text);
+    StringBuilder& append(char c);
+    StringBuilder& append(long value);
+    StringBuilder& append(unsigned long value);
+    StringBuilder& append(int value) { return append((long)value); }
+    StringBuilder& append(unsigned int value) { return append((unsigned long)value); }
+
+    /**
+     * Append printf-style formatted text without a temporary buffer
+     */
+    StringBuilder& appendFormat(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * Append unsigned value padded with leading zeros (e.g. 7 -> "07")
+     *
+     * @param value: Number to append
+     * @param width: Minimum number of digits
+     */
+    StringBuilder& appendPadded(unsigned long value, uint8_t width);
+
+    /**
+     * Append text with JSON string escaping (quotes, backslash, control chars)
+     * The surrounding quotes are not added
+     */
+    StringBuilder& appendJsonEscaped(const char* text);
+
+    /**
+     * Discard the content (keeps the buffer, clears the overflow flag)
+     */
+    void clear();
+
+    /**
+     * Remove leading and trailing whitespace in place
+     */
+    void trim();
+
+    /**
+     * Convert ASCII letters to upper case in place
+     */
+    void toUpperCase();
+
+    // Comparisons against C strings
+    bool equals(const char* text) const;
+    bool startsWith(const char* prefix) const;
+
+    // Accessors
+    const char* c_str() const { return buffer; }
+    size_t length() const { return len; }
+    size_t capacity() const { return cap - 1; }
+    bool isEmpty() const { return len == 0; }
+    bool overflowed() const { return overflow; }
+
+    /**
+     * @return: Number of builders that truncated output since boot
+     */
+    static uint32_t getOverflowCount();
+
+protected:
+    char* buffer;
+    size_t cap;
+    size_t len;
+    bool overflow;
+
+private:
+    static uint32_t overflowCount;
+
+    void markOverflow();
+
+    // Not copyable: a copy would alias the original buffer
+    StringBuilder(const StringBuilder&);
+    StringBuilder& operator=(const StringBuilder&);
+};
+
+/**
+ * FixedString Template
+ *
+ * StringBuilder with inline storage for N characters, e.g.
+ *   FixedString<15> key;          // NVRAM key (NVS limit is 15 chars)
+ *   key.appendFormat("s%u_h", i);
+ *
+ * @tparam N: Maximum text length (excluding the terminator)
+ */
+template <size_t N>
+class FixedString : public StringBuilder {
+public:
+    FixedString() : StringBuilder(storage, N + 1) {}
+
+    explicit FixedString(const char* text) : StringBuilder(storage, N + 1) {
+        append(text);
+    }
+
+    FixedString(const FixedString& other) : StringBuilder(storage, N + 1) {
+        append(other.c_str());
+    }
+
+    FixedString& operator=(const FixedString& other) {
+        if (this != &other) {
+            clear();
+            append(other.c_str());
+        }
+        return *this;
+    }
+
+private:
+    char storage[N + 1];
+};
+
+#endif // STRING_BUILDER_H
@@ -0,0 +1,130 @@
+#include "stroke_plan.h"
+
+/**
+ * Build a ramp for the given speed and acceleration
+ * Same constants as AccelStepper::computeNewSpeed(), converted once to Q8 µs
+ * so the interrupt only needs integer math
+ *
+ * @return: Ramp at standstill (remaining set by begin())
+ */
+StrokePlan::Ramp StrokePlan::makeRamp(float maxSpeed, float acceleration) {
+    if (maxSpeed < 1.0f) maxSpeed = 1.0f;
+    if (acceleration < 1.0f) acceleration = 1.0f;
+
+    Ramp ramp;
+    ramp.remaining = 0;
+    ramp.n = 0;
+    ramp.cQ8 = 0;
+    ramp.c0Q8 = (uint32_t)(0.676f * sqrtf(2.0f / acceleration) * 1000000.0f * 256.0f);
+    ramp.cminQ8 = (uint32_t)(1000000.0f / maxSpeed * 256.0f);
+    return ramp;
+}
+
+/**
+ * Load the first forward stroke of a move
+ *
+ * @param ramp: Ramp from makeRamp()
+ * @param steps: Relative move in steps (sign = direction)
+ * @param strokeSteps, reverseSteps: Stroke plan (0 = single stroke)
+ */
+void StrokePlan::begin(const Ramp& newRamp, long steps, uint16_t newStrokeSteps, uint16_t newReverseSteps) {
+    // Reverse strokes must be shorter than forward ones or the move never ends
+    if (newReverseSteps == 0 || newReverseSteps >= newStrokeSteps) {
+        newStrokeSteps = 0;
+        newReverseSteps = 0;
+    }
+
+    ramp = newRamp;
+    strokeSteps = newStrokeSteps;
+    reverseSteps = newReverseSteps;
+    direction = steps > 0 ? 1 : -1;
+    moveDirection = direction;
+    reversing = false;
+
+    uint32_t total = (uint32_t)labs(steps);
+    uint32_t first = (strokeSteps && total > strokeSteps) ? strokeSteps : total;
+    ramp.remaining = first;
+    ramp.n = 0;
+    netLeft = total - first;
+}
+
+/**
+ * Next step interval of the trapezoidal profile (integer AccelStepper ramp)
+ * Runs from the RMT interrupt with the cache disabled
+ *
+ * @return: Interval before the next step in µs
+ */
+uint32_t IRAM_ATTR StrokePlan::nextStepInterval() {
+    // Begin decelerating when the steps left equal the steps spent accelerating
+    if (ramp.n > 0 && ramp.remaining <= (uint32_t)ramp.n) {
+        ramp.n = -(int32_t)ramp.remaining;
+    }
+
+    if (ramp.n == 0) {
+        ramp.cQ8 = ramp.c0Q8;
+    } else if (ramp.n > 0) {
+        ramp.cQ8 -= (2 * ramp.cQ8) / (uint32_t)(4 * ramp.n + 1);
+    } else {
+        ramp.cQ8 += (2 * ramp.cQ8) / (uint32_t)(-4 * ramp.n - 1);
+    }
+
+    if (ramp.cQ8 <= ramp.cminQ8) {
+        // Cruising: freeze n so it still equals the steps needed to stop
+        ramp.cQ8 = ramp.cminQ8;
+    } else {
+        ramp.n++;
+    }
+
+    ramp.remaining--;
+    return ramp.cQ8 >> 8;
+}
+
+/**
+ * Load the next stroke of an oscillating move
+ * A forward stroke is followed by a reverse one while net steps remain;
+ * each stroke ramps up from standstill again. Runs from the RMT interrupt.
+ *
+ * @return: false when the move is complete
+ */
+bool IRAM_ATTR StrokePlan::nextStroke() {
+    if (netLeft == 0) {
+        return false;
+    }
+
+    uint32_t length;
+    if (!reversing) {
+        length = reverseSteps;
+        netLeft += length;
+        reversing = true;
+    } else {
+        length = netLeft > strokeSteps ? strokeSteps : netLeft;
+        netLeft -= length;
+        reversing = false;
+    }
+
+    direction = reversing ? -moveDirection : moveDirection;
+    ramp.remaining = length;
+    ramp.n = 0;
+    return true;
+}
+
+/**
+ * Duration of a move with the same ramp and stroke plan that start() plays
+ * Walks the integer ramp step by step (MOTOR/FEED commands, not the ISR)
+ *
+ * @return: Move time in µs
+ */
+uint32_t StrokePlan::estimateDuration(long steps, float maxSpeed, float acceleration,
+                                      uint16_t strokeSteps, uint16_t reverseSteps) {
+    StrokePlan plan;
+    plan.begin(makeRamp(maxSpeed, acceleration), steps, strokeSteps, reverseSteps);
+
+    uint32_t durationUs = 0;
+    do {
+        while (plan.ramp.remaining > 0) {
+            durationUs += plan.nextStepInterval();
+        }
+    } while (plan.nextStroke());
+
+    return durationUs;
+}
@@ -0,0 +1,87 @@
+#ifndef STROKE_PLAN_H
+#define STROKE_PLAN_H
+
+#include <Arduino.h>
+
+/**
+ * StrokePlan Class
+ *
+ * Step timing of a StepperWaveform move, without the RMT side: the integer
+ * AccelStepper ramp (Q8 microseconds) and the oscillating stroke plan
+ * (forward strokes with a short reverse stroke after each one). The RMT
+ * interrupt walks one per channel, getProgressAt() replays one, and
+ * estimateDuration() walks a private one, so all three see the same steps.
+ *
+ * Plain data with no constructor: StepperWaveform keeps it inside
+ * memset-cleared channel state. No hardware dependency, so move times of
+ * the DISPENSE_PROFILES are benchmarked on the host (env:native).
+ */
+class StrokePlan {
+public:
+    // Integer step-interval generator (AccelStepper ramp, Q8 microseconds)
+    struct Ramp {
+        uint32_t remaining;     // Steps left in the current stroke
+        int32_t n;              // Ramp step counter (negative while decelerating)
+        uint32_t cQ8;           // Current step interval
+        uint32_t c0Q8;          // First step interval from standstill
+        uint32_t cminQ8;        // Cruise interval (1 / max speed)
+    };
+
+    Ramp ramp;
+    int8_t direction;           // Direction of the current stroke (+1 or -1)
+    int8_t moveDirection;       // Direction of the net move (+1 or -1)
+    uint16_t strokeSteps;       // Forward stroke length (0 = single stroke)
+    uint16_t reverseSteps;      // Reverse stroke length between forward strokes
+    bool reversing;             // Current stroke runs against the move direction
+    uint32_t netLeft;           // Net steps still to go after the current stroke
+
+    /**
+     * Build a ramp for the given speed and acceleration
+     *
+     * @param maxSpeed: Cruise speed in steps/second
+     * @param acceleration: Acceleration in steps/second²
+     * @return: Ramp at standstill (remaining set by begin())
+     */
+    static Ramp makeRamp(float maxSpeed, float acceleration);
+
+    /**
+     * Load the first forward stroke of a move
+     * A stroke plan with reverseSteps == 0 or reverseSteps >= strokeSteps
+     * would never end, so it falls back to a single stroke
+     *
+     * @param ramp: Ramp from makeRamp()
+     * @param steps: Relative move in steps (sign = direction)
+     * @param strokeSteps: Forward stroke length (0 = single stroke)
+     * @param reverseSteps: Reverse stroke length between forward strokes
+     */
+    void begin(const Ramp& ramp, long steps, uint16_t strokeSteps, uint16_t reverseSteps);
+
+    /**
+     * Interval before the next step of the current stroke (remaining > 0)
+     *
+     * @return: Interval in µs
+     */
+    uint32_t nextStepInterval();
+
+    /**
+     * Load the next stroke once the current one is done
+     *
+     * @return: false when the move is complete
+     */
+    bool nextStroke();
+
+    /**
+     * Duration of a move with the same ramp and stroke plan that
+     * StepperWaveform::start() plays
+     *
+     * @param steps: Net move in steps
+     * @param maxSpeed: Cruise speed in steps/second
+     * @param acceleration: Acceleration in steps/second²
+     * @param strokeSteps, reverseSteps: Stroke plan (0 = single stroke)
+     * @return: Move time in µs
+     */
+    static uint32_t estimateDuration(long steps, float maxSpeed, float acceleration,
+                                     uint16_t strokeSteps = 0, uint16_t reverseSteps = 0);
+};
+
+#endif // STROKE_PLAN_H
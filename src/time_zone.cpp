@@ -0,0 +1,456 @@
+#include "time_zone.h"
+#include "string_builder.h"
+#include <ctype.h>
+
+static const uint32_t SECONDS_PER_DAY = 86400UL;
+
+// ============================================================================
+// CALENDAR HELPERS (proleptic Gregorian, integer only)
+// ============================================================================
+
+static bool isLeapYear(int32_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static uint8_t daysInMonth(int32_t year, uint8_t month) {
+    static const uint8_t DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : DAYS[month - 1];
+}
+
+/**
+ * Days since 1970-01-01 for a civil date
+ */
+static int32_t daysFromCivil(int32_t year, uint8_t month, uint8_t day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yearOfEra = (uint32_t)(year - era * 400);
+    uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int32_t)dayOfEra - 719468;
+}
+
+/**
+ * Calendar year containing a day count since 1970-01-01
+ */
+static uint16_t yearFromDays(int32_t days) {
+    int32_t year = 1970 + days / 366;
+    while (daysFromCivil(year + 1, 1, 1) <= days) {
+        year++;
+    }
+    return (uint16_t)year;
+}
+
+/**
+ * Civil date of a day count since 1970-01-01 (display only)
+ */
+static void civilFromDays(int32_t days, uint16_t& year, uint8_t& month, uint8_t& day) {
+    year = yearFromDays(days);
+    days -= daysFromCivil(year, 1, 1);
+    month = 1;
+    while (days >= daysInMonth(year, month)) {
+        days -= daysInMonth(year, month);
+        month++;
+    }
+    day = (uint8_t)(days + 1);
+}
+
+static uint32_t clampEpoch(int64_t seconds) {
+    if (seconds < 0) return 0;
+    if (seconds > (int64_t)UINT32_MAX) return UINT32_MAX;
+    return (uint32_t)seconds;
+}
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+/**
+ * Constructor
+ */
+TimeZone::TimeZone()
+    : generation(0),
+      tableCount(0),
+      tableBaseOffset(0),
+      tableFirstYear(0),
+      tableStart(0),
+      tableEnd(0) {
+    posix[0] = '\0';
+    set("UTC0");
+}
+
+bool TimeZone::set(const char* text) {
+    Zone parsed;
+    if (!parse(text, parsed)) {
+        return false;
+    }
+
+    zone = parsed;
+    strncpy(posix, text, TIMEZONE_POSIX_MAX_LENGTH);
+    posix[TIMEZONE_POSIX_MAX_LENGTH] = '\0';
+
+    // Force a rebuild around the next converted time
+    tableCount = 0;
+    tableStart = 0;
+    tableEnd = 0;
+    tableBaseOffset = zone.stdOffset;
+    generation++;
+    return true;
+}
+
+bool TimeZone::isValid(const char* text) {
+    Zone parsed;
+    return parse(text, parsed);
+}
+
+// ============================================================================
+// CONVERSION
+// ============================================================================
+
+int32_t TimeZone::getOffset(uint32_t utc) {
+    if (!zone.dst) {
+        return zone.stdOffset;
+    }
+    ensureCovered(utc);
+
+    // Binary search for the first transition after utc
+    uint8_t low = 0;
+    uint8_t high = tableCount;
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        if (table[mid].utc <= utc) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low == 0 ? tableBaseOffset : table[low - 1].offset;
+}
+
+bool TimeZone::isDst(uint32_t utc) {
+    return zone.dst && zone.dstOffset != zone.stdOffset && getOffset(utc) == zone.dstOffset;
+}
+
+const char* TimeZone::getAbbreviation(uint32_t utc) {
+    return isDst(utc) ? zone.dstName : zone.stdName;
+}
+
+uint32_t TimeZone::toUtc(uint32_t local) {
+    if (!zone.dst) {
+        return local - zone.stdOffset;
+    }
+
+    // A wall clock reading maps to local - offset for one of the two
+    // offsets; it is valid if that offset really applies at the result
+    uint32_t asStandard = local - zone.stdOffset;
+    uint32_t asDaylight = local - zone.dstOffset;
+    bool standardValid = getOffset(asStandard) == zone.stdOffset;
+    bool daylightValid = getOffset(asDaylight) == zone.dstOffset;
+
+    if (standardValid && daylightValid) {
+        return asStandard < asDaylight ? asStandard : asDaylight; // Repeated hour: first occurrence
+    }
+    if (standardValid) return asStandard;
+    if (daylightValid) return asDaylight;
+    return asStandard > asDaylight ? asStandard : asDaylight;     // Skipped hour: after the jump
+}
+
+// ============================================================================
+// TRANSITION TABLE
+// ============================================================================
+
+/**
+ * Local time (epoch seconds) at which a rule fires in a given year
+ */
+uint32_t TimeZone::ruleLocalTime(const Rule& rule, uint16_t year) {
+    int32_t days = daysFromCivil(year, 1, 1);
+
+    if (rule.kind == 'J') {
+        // 1-365, February 29 is never counted
+        days += rule.day - 1;
+        if (isLeapYear(year) && rule.day >= 60) {
+            days++;
+        }
+    } else if (rule.kind == 'D') {
+        days += rule.day;
+    } else {
+        // Weekday rule.day of week rule.week (5 = last) in rule.month
+        int32_t firstOfMonth = daysFromCivil(year, rule.month, 1);
+        uint8_t firstWeekday = (uint8_t)((firstOfMonth + 4) % 7); // 1970-01-01 was a Thursday
+        int32_t dayOfMonth = (rule.day + 7 - firstWeekday) % 7 + (rule.week - 1) * 7;
+        if (dayOfMonth >= daysInMonth(year, rule.month)) {
+            dayOfMonth -= 7;
+        }
+        days = firstOfMonth + dayOfMonth;
+    }
+
+    return clampEpoch((int64_t)days * SECONDS_PER_DAY + rule.time);
+}
+
+/**
+ * Precompute both DST transitions for TIMEZONE_TABLE_YEARS years
+ *
+ * @param firstYear: First calendar year covered
+ */
+void TimeZone::buildTable(uint16_t firstYear) {
+    tableFirstYear = firstYear;
+    tableStart = clampEpoch((int64_t)daysFromCivil(firstYear, 1, 1) * SECONDS_PER_DAY);
+    tableEnd = clampEpoch((int64_t)daysFromCivil(firstYear + TIMEZONE_TABLE_YEARS, 1, 1) * SECONDS_PER_DAY);
+    tableCount = 0;
+
+    for (uint16_t year = firstYear; year < firstYear + TIMEZONE_TABLE_YEARS; year++) {
+        // Start is given in standard time, end in daylight time
+        uint32_t start = ruleLocalTime(zone.start, year) - zone.stdOffset;
+        uint32_t end = ruleLocalTime(zone.end, year) - zone.dstOffset;
+
+        if (start < end) {
+            table[tableCount++] = {start, zone.dstOffset};
+            table[tableCount++] = {end, zone.stdOffset};
+        } else {
+            // Southern hemisphere: DST spans the new year
+            table[tableCount++] = {end, zone.stdOffset};
+            table[tableCount++] = {start, zone.dstOffset};
+        }
+    }
+
+    tableBaseOffset = table[0].offset == zone.dstOffset ? zone.stdOffset : zone.dstOffset;
+}
+
+void TimeZone::ensureCovered(uint32_t utc) {
+    if (tableCount > 0 && utc >= tableStart && utc < tableEnd) {
+        return;
+    }
+
+    // Start one year back so recent history (missed feedings) stays in range
+    uint16_t year = yearFromDays((int32_t)(utc / SECONDS_PER_DAY));
+    uint16_t firstYear = year > 1970 ? year - 1 : 1970;
+    if (firstYear > 2105 - TIMEZONE_TABLE_YEARS) {
+        firstYear = 2105 - TIMEZONE_TABLE_YEARS;
+    }
+    buildTable(firstYear);
+}
+
+// ============================================================================
+// POSIX TZ PARSING
+// ============================================================================
+
+/**
+ * Parse an unsigned decimal number
+ *
+ * @return: Pointer after the digits, or nullptr if none or above maxValue
+ */
+static const char* parseNumber(const char* p, long& value, long maxValue) {
+    if (!isdigit((unsigned char)*p)) {
+        return nullptr;
+    }
+    value = 0;
+    while (isdigit((unsigned char)*p)) {
+        value = value * 10 + (*p - '0');
+        if (value > maxValue) {
+            return nullptr;
+        }
+        p++;
+    }
+    return p;
+}
+
+/**
+ * Zone name: 3+ letters, or <...> with letters, digits, '+' and '-'
+ */
+const char* TimeZone::parseName(const char* p, char* out) {
+    size_t length = 0;
+
+    if (*p == '<') {
+        p++;
+        while (*p && *p != '>') {
+            if (!(isalnum((unsigned char)*p) || *p == '+' || *p == '-') || length >= TIMEZONE_NAME_MAX_LENGTH) {
+                return nullptr;
+            }
+            out[length++] = *p++;
+        }
+        if (*p != '>') {
+            return nullptr;
+        }
+        p++;
+    } else {
+        while (isalpha((unsigned char)*p)) {
+            if (length >= TIMEZONE_NAME_MAX_LENGTH) {
+                return nullptr;
+            }
+            out[length++] = *p++;
+        }
+    }
+
+    if (length < 3) {
+        return nullptr;
+    }
+    out[length] = '\0';
+    return p;
+}
+
+/**
+ * [+|-]hh[:mm[:ss]] in seconds (sign as written)
+ */
+const char* TimeZone::parseOffset(const char* p, int32_t& seconds, int maxHours) {
+    int32_t sign = 1;
+    if (*p == '+') {
+        p++;
+    } else if (*p == '-') {
+        sign = -1;
+        p++;
+    }
+
+    long hours = 0, minutes = 0, secs = 0;
+    p = parseNumber(p, hours, maxHours);
+    if (p && *p == ':') {
+        p = parseNumber(p + 1, minutes, 59);
+        if (p && *p == ':') {
+            p = parseNumber(p + 1, secs, 59);
+        }
+    }
+    if (!p) {
+        return nullptr;
+    }
+
+    seconds = sign * (int32_t)(hours * 3600 + minutes * 60 + secs);
+    return p;
+}
+
+/**
+ * Mm.w.d, Jn or n, optionally followed by /time (default 02:00:00)
+ */
+const char* TimeZone::parseRule(const char* p, Rule& rule) {
+    long value = 0;
+
+    if (*p == 'M') {
+        rule.kind = 'M';
+        if (!(p = parseNumber(p + 1, value, 12)) || value < 1 || *p != '.') return nullptr;
+        rule.month = (uint8_t)value;
+        if (!(p = parseNumber(p + 1, value, 5)) || value < 1 || *p != '.') return nullptr;
+        rule.week = (uint8_t)value;
+        if (!(p = parseNumber(p + 1, value, 6))) return nullptr;
+        rule.day = (uint16_t)value;
+    } else if (*p == 'J') {
+        rule.kind = 'J';
+        if (!(p = parseNumber(p + 1, value, 365)) || value < 1) return nullptr;
+        rule.day = (uint16_t)value;
+    } else {
+        rule.kind = 'D';
+        if (!(p = parseNumber(p, value, 365))) return nullptr;
+        rule.day = (uint16_t)value;
+    }
+
+    rule.time = 7200;
+    if (*p == '/') {
+        p = parseOffset(p + 1, rule.time, 167);
+    }
+    return p;
+}
+
+/**
+ * Parse a complete POSIX TZ string
+ *
+ * @return: true if the whole string was consumed
+ */
+bool TimeZone::parse(const char* text, Zone& out) {
+    if (!text || !*text || strlen(text) > TIMEZONE_POSIX_MAX_LENGTH) {
+        return false;
+    }
+
+    int32_t offset = 0;
+    const char* p = parseName(text, out.stdName);
+    if (!p || !(p = parseOffset(p, offset, 24))) {
+        return false;
+    }
+    out.stdOffset = -offset;  // POSIX offsets are positive west of Greenwich
+    out.dstOffset = out.stdOffset;
+    out.dstName[0] = '\0';
+    out.dst = false;
+
+    if (*p == '\0') {
+        return true;
+    }
+
+    if (!(p = parseName(p, out.dstName))) {
+        return false;
+    }
+    out.dst = true;
+    out.dstOffset = out.stdOffset + 3600;
+    if (*p && *p != ',') {
+        if (!(p = parseOffset(p, offset, 24))) {
+            return false;
+        }
+        out.dstOffset = -offset;
+    }
+
+    if (*p == '\0') {
+        // No rules given: POSIX leaves this to the implementation, use US rules
+        out.start = {'M', 3, 2, 0, 7200};
+        out.end = {'M', 11, 1, 0, 7200};
+        return true;
+    }
+
+    if (*p != ',' || !(p = parseRule(p + 1, out.start)) || *p != ',' || !(p = parseRule(p + 1, out.end))) {
+        return false;
+    }
+    return *p == '\0';
+}
+
+// ============================================================================
+// DIAGNOSTICS
+// ============================================================================
+
+/**
+ * Append "UTC+hh:mm" for an offset in seconds east of UTC
+ */
+static void appendUtcOffset(StringBuilder& out, int32_t offset) {
+    char sign = offset < 0 ? '-' : '+';
+    uint32_t magnitude = offset < 0 ? -offset : offset;
+    out.appendFormat("UTC%c%02lu:%02lu", sign,
+                     (unsigned long)(magnitude / 3600), (unsigned long)(magnitude % 3600 / 60));
+}
+
+void TimeZone::printInfo(Print& out) {
+    FixedString<64> line;
+
+    out.println(F("=== TIME ZONE ==="));
+    line.append("Zone: ").append(posix);
+    out.println(line.c_str());
+
+    line.clear();
+    line.append("Standard: ").append(zone.stdName).append(' ');
+    appendUtcOffset(line, zone.stdOffset);
+    out.println(line.c_str());
+
+    if (!zone.dst) {
+        out.println(F("Daylight saving: none"));
+        return;
+    }
+
+    line.clear();
+    line.append("Daylight: ").append(zone.dstName).append(' ');
+    appendUtcOffset(line, zone.dstOffset);
+    out.println(line.c_str());
+
+    if (tableCount == 0) {
+        out.println(F("Transitions: not computed yet"));
+        return;
+    }
+
+    line.clear();
+    line.appendFormat("Transitions %u-%u (UTC):", tableFirstYear, tableFirstYear + TIMEZONE_TABLE_YEARS - 1);
+    out.println(line.c_str());
+
+    for (uint8_t i = 0; i < tableCount; i++) {
+        uint16_t year;
+        uint8_t month;
+        uint8_t day;
+        uint32_t secondOfDay = table[i].utc % SECONDS_PER_DAY;
+        civilFromDays((int32_t)(table[i].utc / SECONDS_PER_DAY), year, month, day);
+        line.clear();
+        line.appendFormat("  %04u-%02u-%02u %02u:%02u -> ", year, month, day,
+                          (unsigned)(secondOfDay / 3600), (unsigned)(secondOfDay % 3600 / 60));
+        appendUtcOffset(line, table[i].offset);
+        line.append(' ').append(table[i].offset == zone.dstOffset ? zone.dstName : zone.stdName);
+        out.println(line.c_str());
+    }
+}
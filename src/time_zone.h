@@ -0,0 +1,159 @@
+#ifndef TIME_ZONE_H
+#define TIME_ZONE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * TimeZone Class
+ *
+ * Converts between UTC epoch seconds (what the RTC stores) and local epoch
+ * seconds using a POSIX TZ string, e.g.:
+ *   "<-03>3"                         Brazil (no DST)
+ *   "EST5EDT,M3.2.0,M11.1.0"         US Eastern
+ *   "CET-1CEST,M3.5.0,M10.5.0/3"     Central Europe
+ *   "AEST-10AEDT,M10.1.0,M4.1.0/3"   Sydney (DST across the new year)
+ *
+ * Features:
+ * - Mm.w.d, Jn and n transition rules with optional /time (may be
+ *   negative or beyond 24h)
+ * - DST transitions for TIMEZONE_TABLE_YEARS years are precomputed into a
+ *   small table; conversion is a binary search plus an add (no mktime/
+ *   localtime, no libc TZ state)
+ * - The table is rebuilt (integer math only) when a time outside its
+ *   range is converted, e.g. after the RTC is set to another year
+ *
+ * Local -> UTC:
+ * - Times repeated when DST ends resolve to the first occurrence
+ * - Times skipped when DST starts map to the same wall clock reading
+ *   after the jump (02:30 -> 03:30)
+ */
+class TimeZone {
+public:
+    /**
+     * Offset change (offset in effect from utc onwards)
+     */
+    struct Transition {
+        uint32_t utc;
+        int32_t offset;           // Seconds east of UTC
+    };
+
+    /**
+     * Constructor - zone starts as UTC until set() succeeds
+     */
+    TimeZone();
+
+    /**
+     * Parse and apply a POSIX TZ string
+     *
+     * @param posix: TZ string (see class comment)
+     * @return: false if the string is invalid (current zone unchanged)
+     */
+    bool set(const char* posix);
+
+    /**
+     * Check a POSIX TZ string without applying it
+     */
+    static bool isValid(const char* posix);
+
+    /**
+     * @return: TZ string currently applied
+     */
+    const char* getPosix() const { return posix; }
+
+    /**
+     * @return: true if the zone has daylight saving rules
+     */
+    bool hasDst() const { return zone.dst; }
+
+    /**
+     * @return: Counter bumped by every successful set(), so callers can
+     *          drop values cached for the previous zone
+     */
+    uint16_t getGeneration() const { return generation; }
+
+    /**
+     * UTC offset at a given instant
+     *
+     * @param utc: UTC epoch seconds
+     * @return: Offset in seconds east of UTC
+     */
+    int32_t getOffset(uint32_t utc);
+
+    /**
+     * @param utc: UTC epoch seconds
+     * @return: true if daylight saving time is in effect
+     */
+    bool isDst(uint32_t utc);
+
+    /**
+     * @param utc: UTC epoch seconds
+     * @return: Zone abbreviation in effect ("CET", "CEST", "-03")
+     */
+    const char* getAbbreviation(uint32_t utc);
+
+    /**
+     * Convert UTC epoch seconds to local epoch seconds
+     */
+    uint32_t toLocal(uint32_t utc) { return utc + getOffset(utc); }
+
+    /**
+     * Convert local epoch seconds (wall clock read as if UTC) to UTC
+     */
+    uint32_t toUtc(uint32_t local);
+
+    /**
+     * Print zone rules and the transition table
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    void printInfo(Print& out);
+
+private:
+    /**
+     * DST start/end rule
+     */
+    struct Rule {
+        char kind;                // 'M' (month.week.day), 'J' (1-365, no Feb 29) or 'D' (0-365)
+        uint8_t month;            // 1-12 ('M')
+        uint8_t week;             // 1-5, 5 = last ('M')
+        uint16_t day;             // Weekday 0-6 ('M') or day number ('J', 'D')
+        int32_t time;             // Local time of day of the change (seconds)
+    };
+
+    /**
+     * Parsed POSIX TZ string
+     */
+    struct Zone {
+        char stdName[TIMEZONE_NAME_MAX_LENGTH + 1];
+        char dstName[TIMEZONE_NAME_MAX_LENGTH + 1];
+        int32_t stdOffset;        // Seconds east of UTC
+        int32_t dstOffset;
+        bool dst;
+        Rule start;               // Entering DST (local standard time)
+        Rule end;                 // Leaving DST (local daylight time)
+    };
+
+    char posix[TIMEZONE_POSIX_MAX_LENGTH + 1];
+    Zone zone;
+    uint16_t generation;
+
+    // Precomputed transitions for [tableFirstYear, tableFirstYear + TIMEZONE_TABLE_YEARS)
+    Transition table[TIMEZONE_TABLE_YEARS * 2];
+    uint8_t tableCount;
+    int32_t tableBaseOffset;      // Offset before table[0]
+    uint16_t tableFirstYear;
+    uint32_t tableStart;          // UTC range covered by the table
+    uint32_t tableEnd;
+
+    static bool parse(const char* text, Zone& out);
+    static const char* parseName(const char* p, char* out);
+    static const char* parseOffset(const char* p, int32_t& seconds, int maxHours);
+    static const char* parseRule(const char* p, Rule& rule);
+    static uint32_t ruleLocalTime(const Rule& rule, uint16_t year);
+
+    void buildTable(uint16_t firstYear);
+    void ensureCovered(uint32_t utc);
+};
+
+#endif // TIME_ZONE_H
@@ -1,5 +1,6 @@
 #include "touch_sensor.h"
 #include "console_manager.h"
+#include "metrics_registry.h"
 
 /**
  * Touch Sensor Module Implementation (TTP223)
@@ -7,6 +8,10 @@
  * Non-blocking capacitive touch sensor controller with debouncing and callbacks.
  */
 
+// Since boot (/metrics), unlike the counts TOUCH RESET clears
+static MetricsRegistry::Counter touchPresses("feeder_touch_presses_total", "Debounced touch presses");
+static MetricsRegistry::Counter touchLongPresses("feeder_touch_long_presses_total", "Touch long presses");
+
 /**
  * Constructor
  * 
@@ -27,7 +32,8 @@ TouchSensor::TouchSensor(uint8_t pin, bool activeLow)
       _longPressDetected(false),
       _callback(nullptr),
       _touchCount(0),
-      _longPressCount(0) {
+      _longPressCount(0),
+      _rawOverride(-1) {
 }
 
 /**
@@ -91,6 +97,7 @@ void TouchSensor::update() {
                 _touchStartTime = currentTime;
                 _longPressDetected = false;
                 _touchCount++;
+                touchPresses.inc();
                 
                 // Invoke callback
                 invokeCallback(TOUCH_PRESSED, 0);
@@ -120,6 +127,7 @@ void TouchSensor::update() {
             // Long press detected
             _longPressDetected = true;
             _longPressCount++;
+            touchLongPresses.inc();
             
             // Invoke callback
             invokeCallback(TOUCH_LONG_PRESS, touchDuration);
@@ -267,6 +275,24 @@ unsigned long TouchSensor::getLongPressCount() const {
     return _longPressCount;
 }
 
+/**
+ * Drive the raw input from software instead of the pin
+ * 
+ * @param state: 1 = touched, 0 = released, -1 = follow the pin again
+ */
+void TouchSensor::setRawOverride(int8_t state) {
+    _rawOverride = state < 0 ? -1 : (state ? 1 : 0);
+}
+
+/**
+ * Check if the raw input is driven from software
+ * 
+ * @return: true while setRawOverride() is active
+ */
+bool TouchSensor::isRawOverridden() const {
+    return _rawOverride >= 0;
+}
+
 /**
  * Reset touch statistics
  */
@@ -277,40 +303,45 @@ void TouchSensor::resetStatistics() {
 }
 
 /**
- * Get status string for debugging
+ * Print status report for debugging (written directly, no String building)
  * 
- * @return: String with sensor status information
+ * @param out: Destination (Serial, StringBuilder, ...)
  */
-String TouchSensor::getStatus() const {
-    String status = "";
-    status += "Touch Sensor Status:\n";
-    status += "  Pin: " + String(_pin) + "\n";
-    status += "  Active Logic: ";
-    status += _activeLow ? "LOW" : "HIGH";
-    status += "\n  Current State: ";
-    status += _touched ? "TOUCHED" : "NOT TOUCHED";
-    status += "\n  Raw State: ";
-    status += readRaw() ? "TOUCHED" : "NOT TOUCHED";
-    status += "\n";
+void TouchSensor::printStatus(Print& out) const {
+    out.println(F("Touch Sensor Status:"));
+    out.print(F("  Pin: "));
+    out.println(_pin);
+    out.print(F("  Active Logic: "));
+    out.println(_activeLow ? "LOW" : "HIGH");
+    out.print(F("  Current State: "));
+    out.println(_touched ? "TOUCHED" : "NOT TOUCHED");
+    out.print(F("  Raw State: "));
+    out.print(readRaw() ? "TOUCHED" : "NOT TOUCHED");
+    out.println(isRawOverridden() ? " (INJECTED)" : "");
     
     if (_touched) {
         unsigned long duration = millis() - _touchStartTime;
-        status += "  Touch Duration: " + String(duration) + "ms\n";
-        status += "  Long Press: ";
-        status += _longPressDetected ? "YES" : "NO";
-        status += "\n";
+        out.print(F("  Touch Duration: "));
+        out.print(duration);
+        out.println(F("ms"));
+        out.print(F("  Long Press: "));
+        out.println(_longPressDetected ? "YES" : "NO");
     }
     
-    status += "  Debounce Delay: " + String(_debounceDelay) + "ms\n";
-    status += "  Long Press Enabled: ";
-    status += _longPressEnabled ? "YES" : "NO";
-    status += "\n  Long Press Duration: " + String(_longPressDuration) + "ms\n";
-    status += "  Total Touches: " + String(_touchCount) + "\n";
-    status += "  Total Long Presses: " + String(_longPressCount) + "\n";
-    status += "  Callback: ";
-    status += _callback ? "ENABLED" : "DISABLED";
-    
-    return status;
+    out.print(F("  Debounce Delay: "));
+    out.print(_debounceDelay);
+    out.println(F("ms"));
+    out.print(F("  Long Press Enabled: "));
+    out.println(_longPressEnabled ? "YES" : "NO");
+    out.print(F("  Long Press Duration: "));
+    out.print(_longPressDuration);
+    out.println(F("ms"));
+    out.print(F("  Total Touches: "));
+    out.println(_touchCount);
+    out.print(F("  Total Long Presses: "));
+    out.println(_longPressCount);
+    out.print(F("  Callback: "));
+    out.println(_callback ? "ENABLED" : "DISABLED");
 }
 
 /**
@@ -319,6 +350,10 @@ String TouchSensor::getStatus() const {
  * @return: true if touched, false if not touched
  */
 bool TouchSensor::readRaw() const {
+    if (_rawOverride >= 0) {
+        return _rawOverride;
+    }
+    
     bool pinState = digitalRead(_pin);
     
     // Invert if active low
@@ -184,17 +184,32 @@ public:
      */
     unsigned long getLongPressCount() const;
 
+    /**
+     * Drive the raw input from software instead of the pin (input replay,
+     * TOUCH INJECT command); debouncing and long press work as usual
+     * 
+     * @param state: 1 = touched, 0 = released, -1 = follow the pin again
+     */
+    void setRawOverride(int8_t state);
+
+    /**
+     * Check if the raw input is driven from software
+     * 
+     * @return: true while setRawOverride() is active
+     */
+    bool isRawOverridden() const;
+
     /**
      * Reset touch statistics
      */
     void resetStatistics();
 
     /**
-     * Get status string for debugging
+     * Print status report for debugging
      * 
-     * @return: String with sensor status information
+     * @param out: Destination (Serial, StringBuilder, ...)
      */
-    String getStatus() const;
+    void printStatus(Print& out) const;
 
 private:
     // Pin configuration
@@ -223,6 +238,9 @@ private:
     unsigned long _touchCount;
     unsigned long _longPressCount;
 
+    // Software-driven raw input (-1 = read the pin)
+    int8_t _rawOverride;
+
     /**
      * Read raw sensor state from pin
      * 
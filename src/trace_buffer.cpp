@@ -0,0 +1,213 @@
+#include "trace_buffer.h"
+#include <esp_timer.h>
+
+/**
+ * Timeline Trace Buffer Implementation
+ *
+ * Chrome trace-event format: every event carries a thread id (tid), which
+ * Perfetto shows as a track; the "M" metadata events at the start of the
+ * export name the tracks. Timestamps are in microseconds.
+ */
+
+static_assert(sizeof(const char*) <= sizeof(uint32_t), "Text arguments are stored as 32-bit pointers");
+
+TraceBuffer::Event TraceBuffer::ring[TRACE_BUFFER_EVENTS];
+uint32_t TraceBuffer::head = 0;
+volatile bool TraceBuffer::enabled = TRACE_ENABLED_AT_BOOT;
+
+namespace {
+
+enum Track : uint8_t {
+    TRACK_TASKS = 1,
+    TRACK_WEB,
+    TRACK_INPUT,
+    TRACK_FEEDING,
+    TRACK_NVS,
+    TRACK_WIFI,
+    TRACK_TIME,
+    TRACK_LAST = TRACK_TIME
+};
+
+const char* const TRACK_NAMES[] = {
+    "", "tasks", "web", "input", "feeding", "nvs", "wifi", "time"
+};
+
+struct EventInfo {
+    const char* name;
+    const char* category;
+    uint8_t track;
+};
+
+// Indexed by TraceBuffer::EventId
+const EventInfo EVENT_INFO[TraceBuffer::EVENT_COUNT] = {
+    { "serial",            "task",    TRACK_TASKS },
+    { "motorMaintenance",  "task",    TRACK_TASKS },
+    { "rgbLed",            "task",    TRACK_TASKS },
+    { "touchSensor",       "task",    TRACK_TASKS },
+    { "feedingMonitor",    "task",    TRACK_TASKS },
+    { "scheduleMonitor",   "task",    TRACK_TASKS },
+    { "wifiMonitor",       "task",    TRACK_TASKS },
+    { "ntpSync",           "task",    TRACK_TASKS },
+    { "wifiPortal",        "task",    TRACK_TASKS },
+    { "cpuGovernor",       "task",    TRACK_TASKS },
+    { "inputFlush",        "task",    TRACK_TASKS },
+    { "series",            "task",    TRACK_TASKS },
+    { "http",              "web",     TRACK_WEB },
+    { "touch",             "input",   TRACK_INPUT },
+    { "feed",              "feeding", TRACK_FEEDING },
+    { "segment",           "feeding", TRACK_FEEDING },
+    { "nvsCommit",         "nvs",     TRACK_NVS },
+    { "wifiState",         "wifi",    TRACK_WIFI },
+    { "timeSync",          "time",    TRACK_TIME },
+    { "httpTimeFallback",  "time",    TRACK_TIME },
+};
+
+} // namespace
+
+/**
+ * Start/stop recording (the ring is kept)
+ */
+void TraceBuffer::setEnabled(bool enabled) {
+    TraceBuffer::enabled = enabled;
+}
+
+bool TraceBuffer::isEnabled() {
+    return enabled;
+}
+
+/**
+ * Drop all recorded events
+ */
+void TraceBuffer::clear() {
+    __atomic_store_n(&head, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @return: Events held in the ring
+ */
+uint32_t TraceBuffer::getEventCount() {
+    uint32_t total = getTotalEvents();
+    return total < TRACE_BUFFER_EVENTS ? total : TRACE_BUFFER_EVENTS;
+}
+
+/**
+ * @return: Events recorded since the last clear (including overwritten ones)
+ */
+uint32_t TraceBuffer::getTotalEvents() {
+    return __atomic_load_n(&head, __ATOMIC_RELAXED);
+}
+
+/**
+ * @return: Free-running index of the oldest event held
+ */
+uint32_t TraceBuffer::getFirstIndex() {
+    return getTotalEvents() - getEventCount();
+}
+
+/**
+ * Stream the ring as Chrome trace-event JSON, oldest event first
+ * (recording is paused meanwhile)
+ *
+ * @param out: Destination (ChunkedResponse, ...)
+ */
+void TraceBuffer::writeChromeJson(Print& out) {
+    bool wasEnabled = enabled;
+    enabled = false;
+
+    uint32_t count = getEventCount();
+    uint32_t first = getFirstIndex();
+
+    // Event times are 32-bit; anchor the newest one to the 64-bit clock and
+    // walk the deltas back to the oldest, so the export survives wraps
+    uint64_t firstUs = 0;
+    if (count > 0) {
+        uint32_t nowUs = micros();
+        uint64_t newestUs = (uint64_t)esp_timer_get_time();
+        newestUs -= (uint32_t)(nowUs - ring[(first + count - 1) & (TRACE_BUFFER_EVENTS - 1)].timestampUs);
+        int64_t spanUs = 0;
+        for (uint32_t i = 1; i < count; i++) {
+            spanUs += (int32_t)(ring[(first + i) & (TRACE_BUFFER_EVENTS - 1)].timestampUs -
+                                ring[(first + i - 1) & (TRACE_BUFFER_EVENTS - 1)].timestampUs);
+        }
+        firstUs = newestUs - spanUs;
+    }
+
+    out.print(F("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    out.print(F("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"fish-feeder\"}}"));
+    for (uint8_t track = 1; track <= TRACK_LAST; track++) {
+        out.print(F(",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"));
+        out.print(track);
+        out.print(F(",\"args\":{\"name\":\""));
+        out.print(TRACK_NAMES[track]);
+        out.print(F("\"}}"));
+    }
+
+    uint64_t timestampUs = firstUs;
+    for (uint32_t i = 0; i < count; i++) {
+        const Event& event = ring[(first + i) & (TRACE_BUFFER_EVENTS - 1)];
+        if (i > 0) {
+            timestampUs += (int32_t)(event.timestampUs - ring[(first + i - 1) & (TRACE_BUFFER_EVENTS - 1)].timestampUs);
+        }
+        if (event.id >= EVENT_COUNT) {
+            continue;
+        }
+        const EventInfo& info = EVENT_INFO[event.id];
+
+        out.print(F(",{\"name\":\""));
+        out.print(info.name);
+        out.print(F("\",\"cat\":\""));
+        out.print(info.category);
+        out.print(F("\",\"ph\":\""));
+        out.print(event.phase);
+        out.print(F("\",\"ts\":"));
+        out.print(timestampUs);
+        out.print(F(",\"pid\":1,\"tid\":"));
+        out.print(info.track);
+        if (event.phase == 'i') {
+            out.print(F(",\"s\":\"t\""));
+        }
+        if (event.hasText) {
+            out.print(F(",\"args\":{\"value\":\""));
+            out.print((const char*)(uintptr_t)event.arg);
+            out.print(F("\"}"));
+        } else if (event.arg != 0) {
+            out.print(F(",\"args\":{\"value\":"));
+            out.print(event.arg);
+            out.print('}');
+        }
+        out.print('}');
+    }
+    out.print(F("]}"));
+
+    enabled = wasEnabled;
+}
+
+/**
+ * Print state, event counts and the time window held
+ *
+ * @param out: Destination (Serial, StringBuilder, ...)
+ */
+void TraceBuffer::printStatus(Print& out) {
+    uint32_t count = getEventCount();
+
+    out.println(F("Trace Status:"));
+    out.print(F("  Recording: "));
+    out.println(enabled ? "ON" : "OFF");
+    out.print(F("  Events: "));
+    out.print(count);
+    out.print(F(" in ring ("));
+    out.print(TRACE_BUFFER_EVENTS);
+    out.print(F(" max), "));
+    out.print(getTotalEvents());
+    out.println(F(" recorded"));
+    if (count > 1) {
+        uint32_t first = getFirstIndex();
+        uint32_t spanUs = ring[(first + count - 1) & (TRACE_BUFFER_EVENTS - 1)].timestampUs -
+                          ring[first & (TRACE_BUFFER_EVENTS - 1)].timestampUs;
+        out.print(F("  Window: "));
+        out.print(spanUs / 1000000.0f, 1);
+        out.println(F("s"));
+    }
+    out.print(F("  Fast Tasks: "));
+    out.println(TRACE_FAST_TASKS ? "TRACED" : "NOT TRACED");
+}
@@ -0,0 +1,147 @@
+#ifndef TRACE_BUFFER_H
+#define TRACE_BUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Timeline Trace Buffer
+ *
+ * Fixed ring of begin/end/instant events with microsecond timestamps, for
+ * seeing how the loop's work interleaves (an NTP HTTP fallback blocking
+ * the loop while a touch arrives, a slow NVS commit during a feed, ...).
+ *
+ * Recording is a relaxed atomic index claim, micros() and four stores, so
+ * trace points can stay in release builds. Events go to one track per
+ * subsystem (tasks, web, input, feeding, NVS, WiFi, time).
+ *
+ * Text arguments are stored as pointers, so only pass string literals or
+ * other strings that live forever (registered URIs, state names).
+ *
+ * writeChromeJson() streams the ring as Chrome trace-event JSON, which
+ * Perfetto and chrome://tracing open directly.
+ */
+class TraceBuffer {
+public:
+    /**
+     * Trace points (names and tracks in trace_buffer.cpp)
+     */
+    enum EventId : uint8_t {
+        // Scheduler tasks (begin/end around the callback)
+        TASK_SERIAL,
+        TASK_MOTOR,
+        TASK_RGB_LED,
+        TASK_TOUCH,
+        TASK_FEEDING_MONITOR,
+        TASK_SCHEDULE_MONITOR,
+        TASK_WIFI_MONITOR,
+        TASK_NTP_SYNC,
+        TASK_WIFI_PORTAL,
+        TASK_CPU_GOVERNOR,
+        TASK_INPUT_FLUSH,
+        TASK_SERIES,
+
+        HTTP_REQUEST,           // Begin/end, text = URI
+        TOUCH_EVENT,            // Instant, value = TouchEvent
+        FEED,                   // Begin: value = portions; end: 1 = complete, 0 = cancelled
+        FEED_SEGMENT,           // Instant, value = StepperMotor::MotionPhase entered
+        NVS_COMMIT,             // Begin/end, text = what is written
+        WIFI_STATE,             // Instant, text = new connection state
+        TIME_SYNC,              // Begin/end of an NTP sync attempt
+        TIME_HTTP_FALLBACK,     // Begin/end of the blocking HTTP Date fallback
+
+        EVENT_COUNT
+    };
+
+    /**
+     * One recorded event (12 bytes)
+     */
+    struct Event {
+        uint32_t timestampUs;   // micros(), wraps every ~71 minutes
+        uint32_t arg;           // Value, or a const char* if hasText
+        uint8_t id;             // EventId
+        char phase;             // 'B', 'E' or 'i' (Chrome trace phases)
+        bool hasText;
+        uint8_t reserved;
+    };
+
+    /**
+     * RAII begin/end pair (inactive = records nothing)
+     */
+    class Scope {
+    public:
+        explicit Scope(EventId id, bool active = true) : id(id), active(active) {
+            if (active) begin(id);
+        }
+        ~Scope() {
+            if (active) end(id);
+        }
+    private:
+        EventId id;
+        bool active;
+    };
+
+    static void begin(EventId id, uint32_t value = 0) { record(id, 'B', value, false); }
+    static void begin(EventId id, const char* text) { record(id, 'B', (uint32_t)(uintptr_t)text, true); }
+    static void end(EventId id, uint32_t value = 0) { record(id, 'E', value, false); }
+    static void instant(EventId id, uint32_t value = 0) { record(id, 'i', value, false); }
+    static void instant(EventId id, const char* text) { record(id, 'i', (uint32_t)(uintptr_t)text, true); }
+
+    /**
+     * Start/stop recording (the ring is kept)
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Drop all recorded events
+     */
+    static void clear();
+
+    /**
+     * @return: Events held in the ring
+     */
+    static uint32_t getEventCount();
+
+    /**
+     * @return: Events recorded since the last clear (including overwritten ones)
+     */
+    static uint32_t getTotalEvents();
+
+    /**
+     * Stream the ring as Chrome trace-event JSON, oldest event first
+     * (recording is paused meanwhile)
+     *
+     * @param out: Destination (ChunkedResponse, ...)
+     */
+    static void writeChromeJson(Print& out);
+
+    /**
+     * Print state, event counts and the time window held
+     *
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    static void printStatus(Print& out);
+
+private:
+    static Event ring[TRACE_BUFFER_EVENTS];
+    static uint32_t head;       // Next write position (free running)
+    static volatile bool enabled;
+
+    static inline void record(EventId id, char phase, uint32_t arg, bool hasText) {
+        if (!enabled) {
+            return;
+        }
+        uint32_t index = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+        Event& event = ring[index & (TRACE_BUFFER_EVENTS - 1)];
+        event.timestampUs = micros();
+        event.arg = arg;
+        event.id = id;
+        event.phase = phase;
+        event.hasText = hasText;
+    }
+
+    static uint32_t getFirstIndex();
+};
+
+#endif // TRACE_BUFFER_H
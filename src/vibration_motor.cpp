@@ -4,9 +4,27 @@
 /**
  * VibrationMotor Implementation
  * 
- * Non-blocking vibration motor control using ESP32 PWM (LEDC)
+ * Non-blocking vibration motor control using ESP32 PWM (LEDC).
+ * Patterns are sequenced by an esp_timer one-shot: HapticSequencer keeps
+ * each phase on an absolute deadline, so timer latency does not accumulate.
  */
 
+// Guards pattern state shared between callers and the esp_timer task
+static portMUX_TYPE hapticMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// PATTERN LIBRARY
+// ============================================================================
+
+const VibrationMotor::HapticPattern& VibrationMotor::PATTERN_ACK = HapticSequencer::PATTERN_ACK;
+const VibrationMotor::HapticPattern& VibrationMotor::PATTERN_LONG_PRESS = HapticSequencer::PATTERN_LONG_PRESS;
+const VibrationMotor::HapticPattern& VibrationMotor::PATTERN_ERROR = HapticSequencer::PATTERN_ERROR;
+const VibrationMotor::HapticPattern& VibrationMotor::PATTERN_FEED_DONE = HapticSequencer::PATTERN_FEED_DONE;
+
+// ============================================================================
+// IMPLEMENTATION
+// ============================================================================
+
 VibrationMotor::VibrationMotor(uint8_t pin, uint8_t channel, uint32_t frequency, uint8_t resolution)
     : pwmPin(pin),
       pwmChannel(channel),
@@ -14,9 +32,10 @@ VibrationMotor::VibrationMotor(uint8_t pin, uint8_t channel, uint32_t frequency,
       pwmResolution(resolution),
       isVibrating(false),
       currentIntensity(0),
-      vibrationStartTime(0),
-      vibrationDuration(0),
-      timedVibration(false) {
+      timer(nullptr) {
+    generatedPattern.name = "timed";
+    generatedPattern.segments = &generatedSegment;
+    generatedPattern.segmentCount = 1;
 }
 
 bool VibrationMotor::begin() {
@@ -29,6 +48,20 @@ bool VibrationMotor::begin() {
     // Start with motor off
     ledcWrite(pwmChannel, 0);
     
+    // Create the pattern timer
+    if (!timer) {
+        esp_timer_create_args_t args = {};
+        args.callback = &VibrationMotor::onTimer;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "haptic";
+        
+        if (esp_timer_create(&args, &timer) != ESP_OK) {
+            timer = nullptr;
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -46,57 +79,41 @@ uint32_t VibrationMotor::intensityToDutyCycle(uint8_t intensity) {
 }
 
 void VibrationMotor::startContinuous(uint8_t intensity) {
-    currentIntensity = intensity;
-    timedVibration = false;
-    
-    if (intensity > 0) {
-        isVibrating = true;
-        uint32_t dutyCycle = intensityToDutyCycle(intensity);
-        ledcWrite(pwmChannel, dutyCycle);
-    } else {
+    if (intensity == 0) {
         stop();
+        return;
     }
+    
+    portENTER_CRITICAL(&hapticMux);
+    cancelPattern();
+    currentIntensity = intensity;
+    isVibrating = true;
+    ledcWrite(pwmChannel, intensityToDutyCycle(intensity));
+    portEXIT_CRITICAL(&hapticMux);
 }
 
 void VibrationMotor::startTimed(uint8_t intensity, unsigned long durationMs) {
-    currentIntensity = intensity;
-    vibrationDuration = durationMs;
-    vibrationStartTime = millis();
-    timedVibration = true;
-    
-    if (intensity > 0 && durationMs > 0) {
-        isVibrating = true;
-        uint32_t dutyCycle = intensityToDutyCycle(intensity);
-        ledcWrite(pwmChannel, dutyCycle);
-    } else {
-        stop();
-    }
+    startPulsePattern(intensity, durationMs, 0, 1);
 }
 
 void VibrationMotor::stop() {
+    portENTER_CRITICAL(&hapticMux);
+    cancelPattern();
     isVibrating = false;
-    timedVibration = false;
     currentIntensity = 0;
     ledcWrite(pwmChannel, 0);
-}
-
-void VibrationMotor::updateState() {
-    // Check if timed vibration has completed
-    if (isVibrating && timedVibration) {
-        unsigned long elapsed = millis() - vibrationStartTime;
-        if (elapsed >= vibrationDuration) {
-            stop();
-        }
-    }
+    portEXIT_CRITICAL(&hapticMux);
 }
 
 void VibrationMotor::setIntensity(uint8_t intensity) {
+    portENTER_CRITICAL(&hapticMux);
     currentIntensity = intensity;
     
-    if (isVibrating) {
-        uint32_t dutyCycle = intensityToDutyCycle(intensity);
-        ledcWrite(pwmChannel, dutyCycle);
+    // During a pause the next on phase applies its own intensity
+    if (isVibrating && (!sequencer.isActive() || sequencer.isPhaseOn())) {
+        ledcWrite(pwmChannel, intensityToDutyCycle(intensity));
     }
+    portEXIT_CRITICAL(&hapticMux);
 }
 
 bool VibrationMotor::getIsVibrating() const {
@@ -108,35 +125,152 @@ uint8_t VibrationMotor::getIntensity() const {
 }
 
 unsigned long VibrationMotor::getRemainingTime() const {
-    if (!isVibrating || !timedVibration) {
+    int64_t patternEndUs = sequencer.getPatternEndUs();
+    if (!isVibrating || patternEndUs == 0) {
         return 0;
     }
     
-    unsigned long elapsed = millis() - vibrationStartTime;
-    if (elapsed >= vibrationDuration) {
+    int64_t remainingUs = patternEndUs - esp_timer_get_time();
+    if (remainingUs <= 0) {
         return 0;
     }
     
-    return vibrationDuration - elapsed;
+    return (unsigned long)((remainingUs + 999) / 1000);
 }
 
 void VibrationMotor::startPulsePattern(uint8_t intensity, unsigned long onTimeMs, unsigned long offTimeMs, uint16_t cycles) {
-    // This is a simplified implementation that starts continuous vibration
-    // For full pulse pattern support, implement a more complex state machine
-    // in updateState() with pattern tracking
-    startContinuous(intensity);
+    if (intensity == 0 || onTimeMs == 0) {
+        stop();
+        return;
+    }
+    
+    // Detach the generated pattern from the timer before rewriting it
+    portENTER_CRITICAL(&hapticMux);
+    cancelPattern();
+    portEXIT_CRITICAL(&hapticMux);
+    
+    generatedSegment.intensity = intensity;
+    generatedSegment.onMs = onTimeMs > 0xFFFF ? 0xFFFF : onTimeMs;
+    generatedSegment.offMs = offTimeMs > 0xFFFF ? 0xFFFF : offTimeMs;
+    generatedSegment.repeat = cycles;
+    generatedPattern.name = cycles == 1 ? "timed" : "pulse";
+    
+    play(generatedPattern);
 }
 
-String VibrationMotor::getStatus() const {
-    String status = "Vibration Motor Status:\n";
-    status += "  State: " + String(isVibrating ? "VIBRATING" : "STOPPED") + "\n";
-    status += "  Intensity: " + String(currentIntensity) + "%\n";
-    status += "  Mode: " + String(timedVibration ? "TIMED" : "CONTINUOUS") + "\n";
+void VibrationMotor::play(const HapticPattern& newPattern) {
+    if (!timer || newPattern.segmentCount == 0) {
+        stop();
+        return;
+    }
     
-    if (timedVibration && isVibrating) {
-        unsigned long remaining = getRemainingTime();
-        status += "  Remaining: " + String(remaining) + "ms\n";
+    portENTER_CRITICAL(&hapticMux);
+    cancelPattern();
+    sequencer.start(newPattern, esp_timer_get_time());
+    applyOnPhase();
+    armTimer();
+    portEXIT_CRITICAL(&hapticMux);
+}
+
+bool VibrationMotor::isPlaying(const HapticPattern& candidate) const {
+    return sequencer.getPattern() == &candidate;
+}
+
+const VibrationMotor::HapticPattern* VibrationMotor::findPattern(const String& name) {
+    for (uint8_t i = 0; i < HapticSequencer::PATTERN_LIBRARY_SIZE; i++) {
+        if (name.equalsIgnoreCase(HapticSequencer::PATTERN_LIBRARY[i]->name)) {
+            return HapticSequencer::PATTERN_LIBRARY[i];
+        }
+    }
+    return nullptr;
+}
+
+void VibrationMotor::printPatterns(Print& out) {
+    for (uint8_t i = 0; i < HapticSequencer::PATTERN_LIBRARY_SIZE; i++) {
+        const HapticPattern* p = HapticSequencer::PATTERN_LIBRARY[i];
+        out.print(F("  "));
+        out.print(p->name);
+        out.print(F(":"));
+        for (uint8_t s = 0; s < p->segmentCount; s++) {
+            const HapticSegment& seg = p->segments[s];
+            out.print(F(" "));
+            out.print(seg.repeat);
+            out.print(F("x("));
+            out.print(seg.intensity);
+            out.print(F("% "));
+            out.print(seg.onMs);
+            out.print(F("/"));
+            out.print(seg.offMs);
+            out.print(F("ms)"));
+        }
+        out.println();
+    }
+}
+
+void VibrationMotor::onTimer(void* arg) {
+    static_cast<VibrationMotor*>(arg)->advance();
+}
+
+void VibrationMotor::advance() {
+    portENTER_CRITICAL(&hapticMux);
+    
+    switch (sequencer.advance(esp_timer_get_time())) {
+        case HapticSequencer::EDGE_NONE:
+            break;
+        case HapticSequencer::EDGE_ON:
+            applyOnPhase();
+            armTimer();
+            break;
+        case HapticSequencer::EDGE_OFF:
+            ledcWrite(pwmChannel, 0);
+            armTimer();
+            break;
+        case HapticSequencer::EDGE_DONE:
+            isVibrating = false;
+            currentIntensity = 0;
+            ledcWrite(pwmChannel, 0);
+            break;
     }
     
-    return status;
+    portEXIT_CRITICAL(&hapticMux);
+}
+
+void VibrationMotor::applyOnPhase() {
+    isVibrating = true;
+    currentIntensity = sequencer.getIntensity();
+    ledcWrite(pwmChannel, intensityToDutyCycle(currentIntensity));
+}
+
+void VibrationMotor::armTimer() {
+    esp_timer_start_once(timer, sequencer.getTimerDelayUs(esp_timer_get_time()));
+}
+
+void VibrationMotor::cancelPattern() {
+    if (timer) {
+        esp_timer_stop(timer);  // Not running is fine
+    }
+    sequencer.cancel();
+}
+
+void VibrationMotor::printStatus(Print& out) const {
+    out.println(F("Vibration Motor Status:"));
+    out.print(F("  State: "));
+    out.println(isVibrating ? "VIBRATING" : "STOPPED");
+    out.print(F("  Intensity: "));
+    out.print(currentIntensity);
+    out.println(F("%"));
+    out.print(F("  Mode: "));
+    if (sequencer.isActive()) {
+        out.print(F("PATTERN ("));
+        out.print(sequencer.getPattern()->name);
+        out.println(F(")"));
+    } else {
+        out.println(F("CONTINUOUS"));
+    }
+    
+    if (sequencer.isActive() && isVibrating && sequencer.getPatternEndUs() != 0) {
+        out.print(F("  Remaining: "));
+        out.print(getRemainingTime());
+        out.println(F("ms"));
+    }
 }
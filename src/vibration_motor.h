@@ -2,6 +2,8 @@
 #define VIBRATION_MOTOR_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
+#include "haptic_sequencer.h"
 
 /**
  * VibrationMotor Class
@@ -12,8 +14,11 @@
  * Features:
  * - Non-blocking operation using state machine pattern
  * - PWM intensity control (0-100%)
- * - Timed vibration sequences
- * - Task-based architecture compatible with TaskScheduler
+ * - Haptic patterns of (intensity, on, off, repeat) segments
+ * - Library of named patterns (ack, long-press, error, feed-done)
+ * - Timed vibrations and patterns are driven by an esp_timer one-shot
+ *   scheduled on absolute deadlines (sub-millisecond accuracy, no drift),
+ *   so no polling task is needed
  * 
  * Hardware Setup:
  * - GPIO PWM → 1kΩ resistor → Base NPN 2N2222
@@ -23,6 +28,17 @@
  * - 100nF ceramic capacitor across motor
  */
 class VibrationMotor {
+public:
+    // Pattern types (see HapticSequencer)
+    typedef HapticSequencer::Segment HapticSegment;
+    typedef HapticSequencer::Pattern HapticPattern;
+    
+    // Pattern library (defined in HapticSequencer)
+    static const HapticPattern& PATTERN_ACK;         // Touch acknowledge: short tick
+    static const HapticPattern& PATTERN_LONG_PRESS;  // Long press accepted: extended buzz
+    static const HapticPattern& PATTERN_ERROR;       // Error / cancel: three sharp pulses
+    static const HapticPattern& PATTERN_FEED_DONE;   // Feeding complete: two soft pulses
+    
 private:
     // Pin configuration
     uint8_t pwmPin;
@@ -35,13 +51,43 @@ private:
     // State management
     bool isVibrating;
     uint8_t currentIntensity;  // 0-100%
-    unsigned long vibrationStartTime;
-    unsigned long vibrationDuration;
-    bool timedVibration;
+    
+    // Pattern player (shared with the esp_timer task, guarded by a spinlock)
+    esp_timer_handle_t timer;
+    HapticSequencer sequencer;
+    
+    // Pattern generated by startTimed() / startPulsePattern()
+    HapticSegment generatedSegment;
+    HapticPattern generatedPattern;
     
     // Calculate duty cycle from intensity percentage
     uint32_t intensityToDutyCycle(uint8_t intensity);
     
+    /**
+     * esp_timer callback (esp_timer task context)
+     */
+    static void onTimer(void* arg);
+    
+    /**
+     * Move to the next phase when the current one has ended
+     */
+    void advance();
+    
+    /**
+     * Drive the output for the current on phase (lock held)
+     */
+    void applyOnPhase();
+    
+    /**
+     * Arm the timer for the end of the current phase (lock held)
+     */
+    void armTimer();
+    
+    /**
+     * Stop the pattern timer and reset pattern state (lock held)
+     */
+    void cancelPattern();
+    
 public:
     /**
      * Constructor
@@ -55,7 +101,7 @@ public:
     
     /**
      * Initialize the vibration motor
-     * Sets up PWM channel and configures GPIO
+     * Sets up PWM channel, configures GPIO and creates the pattern timer
      * 
      * @return: true if initialization successful
      */
@@ -71,7 +117,7 @@ public:
     
     /**
      * Start timed vibration at specified intensity
-     * Non-blocking - use updateState() to monitor completion
+     * Non-blocking - stopped by the pattern timer
      * 
      * @param intensity: Vibration strength (0-100%)
      * @param durationMs: Vibration duration in milliseconds
@@ -83,13 +129,6 @@ public:
      */
     void stop();
     
-    /**
-     * Update vibration motor state (non-blocking)
-     * Call this regularly (e.g., in TaskScheduler task)
-     * Handles automatic stop for timed vibrations
-     */
-    void updateState();
-    
     /**
      * Set vibration intensity for current operation
      * 
@@ -112,15 +151,15 @@ public:
     uint8_t getIntensity() const;
     
     /**
-     * Get remaining vibration time for timed operations
+     * Get remaining vibration time for timed operations and patterns
      * 
-     * @return: Remaining milliseconds (0 if not timed or completed)
+     * @return: Remaining milliseconds (0 if not timed, endless or completed)
      */
     unsigned long getRemainingTime() const;
     
     /**
      * Vibration pattern: pulse (on-off cycles)
-     * Non-blocking - call in loop or task
+     * Non-blocking - played by the pattern timer
      * 
      * @param intensity: Vibration strength (0-100%)
      * @param onTimeMs: Time motor is on in each cycle
@@ -130,11 +169,41 @@ public:
     void startPulsePattern(uint8_t intensity, unsigned long onTimeMs, unsigned long offTimeMs, uint16_t cycles = 0);
     
     /**
-     * Get status information for debugging
+     * Play a haptic pattern (replaces the running vibration)
+     * 
+     * @param pattern: Pattern to play (segments must outlive playback)
+     */
+    void play(const HapticPattern& pattern);
+    
+    /**
+     * Check if a pattern is the one currently playing
+     * 
+     * @param pattern: Pattern passed to play()
+     * @return: true while that pattern plays
+     */
+    bool isPlaying(const HapticPattern& pattern) const;
+    
+    /**
+     * Find a library pattern by name (case-insensitive)
+     * 
+     * @param name: Pattern name ("ack", "long-press", "error", "feed-done")
+     * @return: Pattern, or nullptr if unknown
+     */
+    static const HapticPattern* findPattern(const String& name);
+    
+    /**
+     * Print library pattern names
+     * 
+     * @param out: Destination (Serial, StringBuilder, ...)
+     */
+    static void printPatterns(Print& out);
+    
+    /**
+     * Print status information for debugging
      * 
-     * @return: Status string with current state
+     * @param out: Destination (Serial, StringBuilder, ...)
      */
-    String getStatus() const;
+    void printStatus(Print& out) const;
 };
 
 #endif // VIBRATION_MOTOR_H
@@ -0,0 +1,209 @@
+#include "web_rate_limiter.h"
+#include "console_manager.h"
+#include "metrics_registry.h"
+#include "string_builder.h"
+
+/**
+ * WebRateLimiter Implementation
+ *
+ * Buckets count milliseconds of credit: one ms of elapsed time adds one,
+ * a request takes its class interval, and a full bucket holds burst x
+ * interval. Refilling is then exact however often a client polls.
+ */
+
+namespace {
+
+struct RouteLimit {
+    uint32_t burst;
+    uint32_t intervalMs;        // One token per interval
+};
+
+// Indexed by WebRateLimiter::RouteClass
+const RouteLimit ROUTE_LIMITS[WebRateLimiter::ROUTE_CLASS_COUNT] = {
+    { WEB_RATE_READ_BURST,   WEB_RATE_READ_INTERVAL_MS },
+    { WEB_RATE_MUTATE_BURST, WEB_RATE_MUTATE_INTERVAL_MS },
+    { WEB_RATE_FEED_BURST,   WEB_RATE_FEED_INTERVAL_MS }
+};
+
+const char* const ROUTE_CLASS_NAMES[WebRateLimiter::ROUTE_CLASS_COUNT] = { "read", "mutate", "feed" };
+
+MetricsRegistry::Counter rateLimitedMetrics[WebRateLimiter::ROUTE_CLASS_COUNT] = {
+    { "feeder_http_rejected_total", "Web requests rejected by admission control", "reason=\"rate\",class=\"read\"" },
+    { "feeder_http_rejected_total", "Web requests rejected by admission control", "reason=\"rate\",class=\"mutate\"" },
+    { "feeder_http_rejected_total", "Web requests rejected by admission control", "reason=\"rate\",class=\"feed\"" }
+};
+MetricsRegistry::Counter busyRejectedMetric("feeder_http_rejected_total", "Web requests rejected by admission control",
+                                            "reason=\"busy\"");
+MetricsRegistry::Counter handlerTimeMetric("feeder_http_handler_ms_total", "Time spent in admitted web handlers");
+
+inline uint32_t capacityOf(uint8_t routeClass) {
+    return ROUTE_LIMITS[routeClass].burst * ROUTE_LIMITS[routeClass].intervalMs;
+}
+
+} // namespace
+
+/**
+ * Constructor - all buckets start full
+ */
+WebRateLimiter::WebRateLimiter()
+    : clientCount(0),
+      busyBudgetMs(WEB_ADMISSION_BUSY_BURST_MS),
+      busyRefillMs(0),
+      busyRejected(0),
+      replacedClients(0) {
+    memset(clients, 0, sizeof(clients));
+    memset(admitted, 0, sizeof(admitted));
+    memset(rateLimited, 0, sizeof(rateLimited));
+}
+
+/**
+ * Decide whether a request may run, taking a token if it may
+ *
+ * @param clientIp: Remote address (IPv4 as uint32_t)
+ * @param routeClass: Class of the requested endpoint
+ * @param retryAfterS: Set to the seconds until a retry can pass when rejected
+ * @return: ADMIT, REJECT_RATE or REJECT_BUSY
+ */
+WebRateLimiter::Decision WebRateLimiter::admit(uint32_t clientIp, RouteClass routeClass, uint32_t& retryAfterS) {
+    uint32_t now = millis();
+
+    // Client bucket first: a client over its rate is told so even when busy
+    Client& client = findClient(clientIp, now);
+    uint32_t intervalMs = ROUTE_LIMITS[routeClass].intervalMs;
+    if (client.tokens[routeClass] < intervalMs) {
+        rateLimited[routeClass]++;
+        rateLimitedMetrics[routeClass].inc();
+        retryAfterS = (intervalMs - client.tokens[routeClass] + 999) / 1000;
+        return REJECT_RATE;
+    }
+
+    refillBusyBudget(now);
+    if (busyBudgetMs <= 0) {
+        busyRejected++;
+        busyRejectedMetric.inc();
+        // Until the budget is back above zero
+        retryAfterS = ((uint32_t)(-busyBudgetMs) * 1000 / WEB_ADMISSION_BUSY_MS_PER_S) / 1000 + 1;
+        return REJECT_BUSY;
+    }
+
+    client.tokens[routeClass] -= intervalMs;
+    admitted[routeClass]++;
+    return ADMIT;
+}
+
+/**
+ * Charge handler time to the global budget (Scope does this)
+ *
+ * @param elapsedMs: Time the handler ran (charged up to WEB_ADMISSION_BUSY_BURST_MS)
+ */
+void WebRateLimiter::charge(uint32_t elapsedMs) {
+    handlerTimeMetric.inc(elapsedMs);
+
+    // One request costs at most a full burst: a long stream (/api/trace,
+    // CSV series, chunked pages) spends most of its wall time waiting for
+    // the client to take the data, and must not lock out every client
+    if (elapsedMs > WEB_ADMISSION_BUSY_BURST_MS) {
+        elapsedMs = WEB_ADMISSION_BUSY_BURST_MS;
+    }
+
+    int32_t floorMs = -(int32_t)WEB_ADMISSION_BUSY_BURST_MS;
+    if (elapsedMs > (uint32_t)(busyBudgetMs - floorMs)) {
+        busyBudgetMs = floorMs;
+    } else {
+        busyBudgetMs -= (int32_t)elapsedMs;
+    }
+}
+
+/**
+ * Client entry for ip, refilled to now; replaces the least recently seen
+ * client when the table is full
+ */
+WebRateLimiter::Client& WebRateLimiter::findClient(uint32_t ip, uint32_t now) {
+    Client* oldest = &clients[0];
+    for (uint8_t i = 0; i < clientCount; i++) {
+        if (clients[i].ip == ip) {
+            refill(clients[i], now);
+            return clients[i];
+        }
+        if ((int32_t)(clients[i].lastRefillMs - oldest->lastRefillMs) < 0) {
+            oldest = &clients[i];
+        }
+    }
+
+    Client* client;
+    if (clientCount < WEB_RATE_LIMIT_CLIENTS) {
+        client = &clients[clientCount++];
+    } else {
+        client = oldest;
+        replacedClients++;
+    }
+    client->ip = ip;
+    client->lastRefillMs = now;
+    for (uint8_t routeClass = 0; routeClass < ROUTE_CLASS_COUNT; routeClass++) {
+        client->tokens[routeClass] = capacityOf(routeClass);
+    }
+    return *client;
+}
+
+void WebRateLimiter::refill(Client& client, uint32_t now) {
+    uint32_t elapsedMs = now - client.lastRefillMs;
+    client.lastRefillMs = now;
+    for (uint8_t routeClass = 0; routeClass < ROUTE_CLASS_COUNT; routeClass++) {
+        uint32_t capacity = capacityOf(routeClass);
+        uint32_t& tokens = client.tokens[routeClass];
+        tokens = elapsedMs >= capacity - tokens ? capacity : tokens + elapsedMs;
+    }
+}
+
+void WebRateLimiter::refillBusyBudget(uint32_t now) {
+    if (busyBudgetMs >= (int32_t)WEB_ADMISSION_BUSY_BURST_MS) {
+        busyRefillMs = now;
+        return;
+    }
+    uint32_t elapsedMs = now - busyRefillMs;
+    uint32_t missingMs = (uint32_t)((int32_t)WEB_ADMISSION_BUSY_BURST_MS - busyBudgetMs);
+    // Whole refill in elapsed (also keeps elapsed * rate from overflowing)
+    if (elapsedMs >= missingMs * 1000 / WEB_ADMISSION_BUSY_MS_PER_S) {
+        busyBudgetMs = WEB_ADMISSION_BUSY_BURST_MS;
+        busyRefillMs = now;
+    } else {
+        uint32_t addMs = elapsedMs * WEB_ADMISSION_BUSY_MS_PER_S / 1000;
+        busyBudgetMs += (int32_t)addMs;
+        // Keep the remainder for the next refill
+        busyRefillMs += addMs * 1000 / WEB_ADMISSION_BUSY_MS_PER_S;
+    }
+}
+
+const char* WebRateLimiter::getRouteClassName(RouteClass routeClass) {
+    return routeClass < ROUTE_CLASS_COUNT ? ROUTE_CLASS_NAMES[routeClass] : "?";
+}
+
+/**
+ * Print limits, admitted/rejected counts and the budget state
+ */
+void WebRateLimiter::printStats() const {
+    FixedString<96> line;
+
+    Console::printlnR(F("=== HTTP ADMISSION CONTROL ==="));
+    for (uint8_t routeClass = 0; routeClass < ROUTE_CLASS_COUNT; routeClass++) {
+        line.clear();
+        line.appendFormat("%-6s: burst %lu, 1 per %lu ms - admitted %lu, limited %lu",
+                          ROUTE_CLASS_NAMES[routeClass],
+                          (unsigned long)ROUTE_LIMITS[routeClass].burst,
+                          (unsigned long)ROUTE_LIMITS[routeClass].intervalMs,
+                          (unsigned long)admitted[routeClass],
+                          (unsigned long)rateLimited[routeClass]);
+        Console::printlnR(line.c_str());
+    }
+
+    line.clear();
+    line.appendFormat("Handler budget: %ld of %lu ms (+%lu ms/s), busy rejections: %lu",
+                      (long)busyBudgetMs, (unsigned long)WEB_ADMISSION_BUSY_BURST_MS,
+                      (unsigned long)WEB_ADMISSION_BUSY_MS_PER_S, (unsigned long)busyRejected);
+    Console::printlnR(line.c_str());
+
+    line.clear();
+    line.appendFormat("Clients tracked: %u of %u, replaced: %lu",
+                      (unsigned)clientCount, (unsigned)WEB_RATE_LIMIT_CLIENTS, (unsigned long)replacedClients);
+    Console::printlnR(line.c_str());
+}
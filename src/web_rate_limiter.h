@@ -0,0 +1,113 @@
+#ifndef WEB_RATE_LIMITER_H
+#define WEB_RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * WebRateLimiter Class
+ *
+ * Admission control for the web API, checked by the request wrapper before
+ * any handler work (no module access, no logging, no trace or input
+ * records), so a script hammering an endpoint costs the loop little more
+ * than parsing its request.
+ *
+ * - Per client IP and route class (read/mutate/feed), a token bucket with
+ *   a burst size and a refill interval (WEB_RATE_* in config.h). An empty
+ *   bucket answers 429 with Retry-After.
+ * - Globally, a budget of handler time: every admitted request is charged
+ *   the time its handler ran (at most one burst, so a long stream cannot
+ *   lock out everyone), the budget refills at
+ *   WEB_ADMISSION_BUSY_MS_PER_S. While it is used up every request is
+ *   answered 503, which keeps slow handlers from all clients together
+ *   from starving the motor and touch tasks.
+ *
+ * The web server runs one request at a time on the loop task, so the
+ * handler time budget takes the place of an in-flight limit.
+ *
+ * The client table holds WEB_RATE_LIMIT_CLIENTS addresses; a new client
+ * replaces the one seen longest ago (with full buckets).
+ *
+ * Not thread-safe: use from the web server task only.
+ */
+class WebRateLimiter {
+public:
+    /**
+     * Route classes (set when the endpoint is registered)
+     */
+    enum RouteClass : uint8_t {
+        ROUTE_READ,             // Status, pages, diagnostics
+        ROUTE_MUTATE,           // Settings and schedule changes
+        ROUTE_FEED,             // Starts the motor
+        ROUTE_CLASS_COUNT
+    };
+
+    enum Decision : uint8_t {
+        ADMIT,
+        REJECT_RATE,            // Client's bucket empty: 429
+        REJECT_BUSY             // Handler time budget used up: 503
+    };
+
+    /**
+     * RAII guard that charges the handler time of an admitted request
+     */
+    class Scope {
+    public:
+        explicit Scope(WebRateLimiter& limiter) : limiter(limiter), startMs(millis()) {}
+        ~Scope() { limiter.charge(millis() - startMs); }
+    private:
+        WebRateLimiter& limiter;
+        uint32_t startMs;
+    };
+
+    /**
+     * Constructor - all buckets start full
+     */
+    WebRateLimiter();
+
+    /**
+     * Decide whether a request may run, taking a token if it may
+     *
+     * @param clientIp: Remote address (IPv4 as uint32_t)
+     * @param routeClass: Class of the requested endpoint
+     * @param retryAfterS: Set to the seconds until a retry can pass when rejected
+     * @return: ADMIT, REJECT_RATE or REJECT_BUSY
+     */
+    Decision admit(uint32_t clientIp, RouteClass routeClass, uint32_t& retryAfterS);
+
+    /**
+     * Charge handler time to the global budget (Scope does this)
+     *
+     * @param elapsedMs: Time the handler ran (charged up to WEB_ADMISSION_BUSY_BURST_MS)
+     */
+    void charge(uint32_t elapsedMs);
+
+    /**
+     * Print limits, admitted/rejected counts and the budget state
+     */
+    void printStats() const;
+
+    static const char* getRouteClassName(RouteClass routeClass);
+
+private:
+    struct Client {
+        uint32_t ip;
+        uint32_t lastRefillMs;      // Also "last seen" for replacement
+        uint32_t tokens[ROUTE_CLASS_COUNT];     // Milliseconds of credit
+    };
+
+    Client clients[WEB_RATE_LIMIT_CLIENTS];
+    uint8_t clientCount;
+    int32_t busyBudgetMs;           // Negative after a handler overran it
+    uint32_t busyRefillMs;
+    uint32_t admitted[ROUTE_CLASS_COUNT];
+    uint32_t rateLimited[ROUTE_CLASS_COUNT];
+    uint32_t busyRejected;
+    uint32_t replacedClients;
+
+    Client& findClient(uint32_t ip, uint32_t now);
+    void refill(Client& client, uint32_t now);
+    void refillBusyBudget(uint32_t now);
+};
+
+#endif // WEB_RATE_LIMITER_H
@@ -3,15 +3,36 @@
 #include "feeding_schedule.h"
 #include "feeding_controller.h"
 #include "console_manager.h"
-#include "rgb_led.h"
+#include "led_status_compositor.h"
+#include "runtime_config.h"
+#include "cpu_governor.h"
+#include "sampling_profiler.h"
+#include "trace_buffer.h"
+#include "feed_latency.h"
+#include "input_recorder.h"
+#include "metrics_registry.h"
+#include "series_store.h"
+#include "loop_watchdog.h"
+#include "rtc_module.h"
+#include "time_zone.h"
 #include "config.h"
 #include <RTClib.h>
 
 // Define static constexpr array for reconnection intervals
 constexpr unsigned long WiFiController::RECONNECTION_INTERVALS[];
 
+// Connection and web server metrics (/metrics)
+static MetricsRegistry::Gauge wifiConnected("feeder_wifi_connected", "1 while associated with an access point",
+                                            nullptr, []() -> int32_t { return WiFi.status() == WL_CONNECTED ? 1 : 0; });
+static MetricsRegistry::Gauge wifiRssi("feeder_wifi_rssi_dbm", "Signal strength of the current access point (0 if not connected)",
+                                       nullptr, []() -> int32_t { return WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0; });
+static MetricsRegistry::Counter wifiConnectionLosses("feeder_wifi_connection_losses_total", "WiFi connections lost");
+static MetricsRegistry::Counter wifiReconnectAttempts("feeder_wifi_reconnect_attempts_total",
+                                                      "Automatic WiFi reconnection attempts");
+static MetricsRegistry::Counter httpRequests("feeder_http_requests_total", "Web requests handled");
+
 // External functions from main.cpp for centralized feeding operations
-extern bool startFeeding(uint8_t portions, bool recordInSchedule);
+extern bool startFeeding(uint8_t portions, bool recordInSchedule, const FeedLatencyTracker::Trigger& trigger);
 extern bool cancelFeeding();
 extern uint8_t getTouchLongPressPortions();
 void setTouchLongPressPortions(uint8_t portions);
@@ -26,8 +47,9 @@ WiFiController::WiFiController()
       configPortalActive(false), lastConnectionCheck(0), wasConnectedBefore(false),
       portalStartRequested(false), portalAPName(""), portalStartTime(0), shutdownRequested(false),
       connectionState(WIFI_IDLE), connectionStateTime(0), connectionAttempts(0),
+      recordedWiFiStatus(WL_NO_SHIELD),
       pendingSSID(""), pendingPassword(""), pendingSaveCredentials(false),
-      modules(nullptr), rgbLed(nullptr), 
+      modules(nullptr), ledStatus(nullptr), 
       errorStateStartTime(0), inErrorState(false), reconnectionAttempts(0) {
 }
 
@@ -43,6 +65,9 @@ bool WiFiController::begin() {
         return false;
     }
     
+    // Reserve web request scratch memory once, before the heap gets busy
+    requestArena.begin(WEB_REQUEST_ARENA_SIZE);
+    
     // Set WiFi hostname BEFORE initializing (prevents default ESP32_XXXXXX name)
     WiFi.setHostname(WIFI_PORTAL_AP_NAME);
     Console::printR(F("WiFi hostname set to: "));
@@ -89,8 +114,8 @@ bool WiFiController::begin() {
             Console::printlnR(F("Reconnection schedule: 0s, 0s, 5s, 10s, 30s, 60s..."));
             
             // Set LED to red blinking (error state)
-            if (rgbLed) {
-                rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
+            if (ledStatus) {
+                ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
             }
         }
     }
@@ -109,11 +134,11 @@ void WiFiController::setModuleManager(ModuleManager* moduleManager) {
 }
 
 /**
- * Set reference to RGB LED for status indication
+ * Set LED status compositor for status indication (WiFi layer)
  */
-void WiFiController::setRGBLed(RGBLed* led) {
-    rgbLed = led;
-    Console::printlnR(F("WiFiController: RGB LED reference configured"));
+void WiFiController::setLedStatus(LedStatusCompositor* compositor) {
+    ledStatus = compositor;
+    Console::printlnR(F("WiFiController: LED status compositor configured"));
 }
 
 /**
@@ -142,15 +167,15 @@ void WiFiController::registerAllEndpoints() {
     Console::printlnR("=== REGISTERING CORE ENDPOINTS ===");
     
     // 1. Test endpoints (always working)
-    wifiManager.server->on("/api/test", HTTP_GET, [this]() {
+    onRequest("/api/test", HTTP_GET, [this]() {
         wifiManager.server->send(200, "application/json", "{\"status\":\"ok\",\"message\":\"API endpoint working\"}");
     });
     Console::printlnR("✓ Registered: /api/test");
     
-    wifiManager.server->on("/api/feed-test", HTTP_GET, [this]() {
+    onRequest("/api/feed-test", HTTP_GET, [this]() {
         if (modules && modules->getFeedingController() && modules->getFeedingController()->isReady()) {
             // Use centralized feeding method
-            if (startFeeding(2, true)) {
+            if (startFeeding(2, true, FeedLatencyTracker::Trigger::now(FeedLatencyTracker::SOURCE_WEB))) {
                 wifiManager.server->send(200, "application/json", "{\"success\":true,\"message\":\"Test feeding started (2 portions)\"}");
             } else {
                 wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to start test feeding\"}");
@@ -158,23 +183,22 @@ void WiFiController::registerAllEndpoints() {
         } else {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Feeding controller not ready\"}");
         }
-    });
+    }, WebRateLimiter::ROUTE_FEED);
     Console::printlnR("✓ Registered: /api/feed-test");
     
-    wifiManager.server->on("/callback-check", HTTP_GET, [this]() {
+    onRequest("/callback-check", HTTP_GET, [this]() {
         wifiManager.server->send(200, "text/plain", "Callback endpoint working!");
     });
     Console::printlnR("✓ Registered: /callback-check");
     
     // 2. Custom page
-    wifiManager.server->on("/custom", HTTP_GET, [this]() {
-        String html = generateScheduleManagementPage();
-        wifiManager.server->send(200, "text/html; charset=utf-8", html);
+    onRequest("/custom", HTTP_GET, [this]() {
+        sendScheduleManagementPage();
     });
     Console::printlnR("✓ Registered: /custom");
     
     // 3. Close portal endpoint
-    wifiManager.server->on("/close", HTTP_GET, [this]() {
+    onRequest("/close", HTTP_GET, [this]() {
         wifiManager.server->send(200, "text/html", "<h1>Portal Closed</h1><p>WiFi portal has been closed.</p>");
         Console::printlnR("Portal close requested via /close endpoint");
         // Note: Actual portal closing logic should be implemented here
@@ -182,18 +206,20 @@ void WiFiController::registerAllEndpoints() {
     Console::printlnR("✓ Registered: /close");
     
     // 4. Motor direction endpoint
-    wifiManager.server->on("/api/motor-direction", HTTP_GET, [this]() {
+    onRequest("/api/motor-direction", HTTP_GET, [this]() {
         if (modules && modules->getStepperMotor() && modules->getStepperMotor()->isReady()) {
             bool isClockwise = modules->getStepperMotor()->getMotorDirection();
-            String json = "{\"success\":true,\"direction\":\"" + String(isClockwise ? "CW" : "CCW") + "\",\"description\":\"" + String(isClockwise ? "Clockwise" : "Counter-clockwise") + "\"}";
-            wifiManager.server->send(200, "application/json", json);
+            StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+            json.appendFormat("{\"success\":true,\"direction\":\"%s\",\"description\":\"%s\"}",
+                              isClockwise ? "CW" : "CCW", isClockwise ? "Clockwise" : "Counter-clockwise");
+            sendJson(200, json);
         } else {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Motor not ready\"}");
         }
     });
     Console::printlnR("✓ Registered: /api/motor-direction (GET)");
     
-    wifiManager.server->on("/api/motor-direction/set", HTTP_GET, [this]() {
+    onRequest("/api/motor-direction/set", HTTP_GET, [this]() {
         if (!modules || !modules->getStepperMotor() || !modules->getStepperMotor()->isReady()) {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Motor not ready\"}");
             return;
@@ -204,75 +230,333 @@ void WiFiController::registerAllEndpoints() {
             return;
         }
         
-        String direction = wifiManager.server->arg("direction");
+        StringBuilder& direction = requestArena.createBuilder(24);
+        direction.append(requestArg("direction"));
         direction.toUpperCase();
         
-        if (direction == "CW" || direction == "CLOCKWISE") {
-            modules->getStepperMotor()->setMotorDirection(true);
+        if (direction.equals("CW") || direction.equals("CLOCKWISE")) {
+            modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_MOTOR_CLOCKWISE, true);
             wifiManager.server->send(200, "application/json", "{\"success\":true,\"direction\":\"CW\",\"message\":\"Motor direction set to CLOCKWISE\"}");
-        } else if (direction == "CCW" || direction == "COUNTERCLOCKWISE" || direction == "COUNTER-CLOCKWISE") {
-            modules->getStepperMotor()->setMotorDirection(false);
+        } else if (direction.equals("CCW") || direction.equals("COUNTERCLOCKWISE") || direction.equals("COUNTER-CLOCKWISE")) {
+            modules->getRuntimeConfig()->setBool(RuntimeConfig::CONFIG_MOTOR_CLOCKWISE, false);
             wifiManager.server->send(200, "application/json", "{\"success\":true,\"direction\":\"CCW\",\"message\":\"Motor direction set to COUNTER-CLOCKWISE\"}");
         } else {
             wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Invalid direction. Use 'CW' or 'CCW'\"}");
         }
-    });
+    }, WebRateLimiter::ROUTE_MUTATE);
     Console::printlnR("✓ Registered: /api/motor-direction/set (GET)");
     
     // 5. Touch sensor long press portions endpoints
-    wifiManager.server->on("/api/touch-portions", HTTP_GET, [this]() {
+    onRequest("/api/touch-portions", HTTP_GET, [this]() {
         uint8_t portions = getTouchLongPressPortions();
-        String json = "{\"success\":true,\"portions\":" + String(portions) + ",\"min\":" + String(MIN_FOOD_PORTIONS) + ",\"max\":" + String(MAX_FOOD_PORTIONS) + "}";
-        wifiManager.server->send(200, "application/json", json);
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+        json.appendFormat("{\"success\":true,\"portions\":%u,\"min\":%u,\"max\":%u}",
+                          portions, MIN_FOOD_PORTIONS, MAX_FOOD_PORTIONS);
+        sendJson(200, json);
     });
     Console::printlnR("✓ Registered: /api/touch-portions (GET)");
     
-    wifiManager.server->on("/api/touch-portions/set", HTTP_GET, [this]() {
+    onRequest("/api/touch-portions/set", HTTP_GET, [this]() {
         if (!wifiManager.server->hasArg("portions")) {
             wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Missing 'portions' parameter. Use: /api/touch-portions/set?portions=X\"}");
             return;
         }
         
-        String portionsStr = wifiManager.server->arg("portions");
-        uint8_t portions = portionsStr.toInt();
+        uint8_t portions = requestArgInt("portions");
         
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
         if (portions < MIN_FOOD_PORTIONS || portions > MAX_FOOD_PORTIONS) {
-            String json = "{\"success\":false,\"message\":\"Invalid portions. Must be between " + String(MIN_FOOD_PORTIONS) + " and " + String(MAX_FOOD_PORTIONS) + "\"}";
-            wifiManager.server->send(400, "application/json", json);
+            json.appendFormat("{\"success\":false,\"message\":\"Invalid portions. Must be between %u and %u\"}",
+                              MIN_FOOD_PORTIONS, MAX_FOOD_PORTIONS);
+            sendJson(400, json);
             return;
         }
         
         setTouchLongPressPortions(portions);
-        String json = "{\"success\":true,\"portions\":" + String(portions) + ",\"message\":\"Touch long press portions updated\"}";
-        wifiManager.server->send(200, "application/json", json);
-    });
+        json.appendFormat("{\"success\":true,\"portions\":%u,\"message\":\"Touch long press portions updated\"}", portions);
+        sendJson(200, json);
+    }, WebRateLimiter::ROUTE_MUTATE);
     Console::printlnR("✓ Registered: /api/touch-portions/set (GET)");
     
     // 6. Touch sensor enabled/disabled endpoints
-    wifiManager.server->on("/api/touch-enabled", HTTP_GET, [this]() {
+    onRequest("/api/touch-enabled", HTTP_GET, [this]() {
         bool enabled = getTouchSensorEnabled();
-        String json = "{\"success\":true,\"enabled\":" + String(enabled ? "true" : "false") + "}";
-        wifiManager.server->send(200, "application/json", json);
+        wifiManager.server->send(200, "application/json", enabled ? "{\"success\":true,\"enabled\":true}" : "{\"success\":true,\"enabled\":false}");
     });
     Console::printlnR("✓ Registered: /api/touch-enabled (GET)");
     
-    wifiManager.server->on("/api/touch-enabled/set", HTTP_GET, [this]() {
+    onRequest("/api/touch-enabled/set", HTTP_GET, [this]() {
         if (!wifiManager.server->hasArg("enabled")) {
             wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Missing 'enabled' parameter. Use: /api/touch-enabled/set?enabled=true or false\"}");
             return;
         }
         
-        String enabledStr = wifiManager.server->arg("enabled");
-        bool enabled = (enabledStr == "true" || enabledStr == "1");
+        const char* enabledStr = requestArg("enabled");
+        bool enabled = (strcmp(enabledStr, "true") == 0 || strcmp(enabledStr, "1") == 0);
         
         setTouchSensorEnabled(enabled);
         
-        String json = "{\"success\":true,\"enabled\":" + String(enabled ? "true" : "false") + ",\"message\":\"Touch sensor " + String(enabled ? "enabled" : "disabled") + "\"}";
-        wifiManager.server->send(200, "application/json", json);
-    });
+        wifiManager.server->send(200, "application/json", enabled
+            ? "{\"success\":true,\"enabled\":true,\"message\":\"Touch sensor enabled\"}"
+            : "{\"success\":true,\"enabled\":false,\"message\":\"Touch sensor disabled\"}");
+    }, WebRateLimiter::ROUTE_MUTATE);
     Console::printlnR("✓ Registered: /api/touch-enabled/set (GET)");
     
-    // 7. Schedule API endpoints (the critical ones)
+    // 7. Runtime configuration registry endpoints
+    onRequest("/api/config", HTTP_GET, [this]() {
+        if (!modules || !modules->hasRuntimeConfig()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Runtime configuration not available\"}");
+            return;
+        }
+        
+        RuntimeConfig* config = modules->getRuntimeConfig();
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_CONFIG_CAPACITY);
+        json.append("{\"success\":true,\"settings\":[");
+        for (uint8_t i = 0; i < RuntimeConfig::CONFIG_COUNT; i++) {
+            RuntimeConfig::Id id = (RuntimeConfig::Id)i;
+            const RuntimeConfig::Entry& entry = RuntimeConfig::getEntry(id);
+            bool isBool = entry.type == RuntimeConfig::TYPE_BOOL;
+            if (i > 0) json.append(',');
+            json.appendFormat("{\"name\":\"%s\",\"type\":\"%s\"", entry.name, isBool ? "bool" : "int");
+            if (isBool) {
+                json.appendFormat(",\"value\":%s,\"default\":%s",
+                                  config->getBool(id) ? "true" : "false",
+                                  entry.defaultValue ? "true" : "false");
+            } else {
+                json.appendFormat(",\"value\":%lu,\"default\":%lu,\"min\":%lu,\"max\":%lu",
+                                  (unsigned long)config->getInt(id), (unsigned long)entry.defaultValue,
+                                  (unsigned long)entry.minValue, (unsigned long)entry.maxValue);
+            }
+            json.appendFormat(",\"unit\":\"%s\",\"persistent\":%s}", entry.unit, entry.persistent ? "true" : "false");
+        }
+        json.append("]}");
+        sendJson(200, json);
+    });
+    Console::printlnR("✓ Registered: /api/config (GET)");
+    
+    onRequest("/api/config/set", HTTP_GET, [this]() {
+        if (!modules || !modules->hasRuntimeConfig()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Runtime configuration not available\"}");
+            return;
+        }
+        
+        if (!wifiManager.server->hasArg("name") || !wifiManager.server->hasArg("value")) {
+            wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Missing parameters. Use: /api/config/set?name=X&value=Y\"}");
+            return;
+        }
+        
+        RuntimeConfig* config = modules->getRuntimeConfig();
+        RuntimeConfig::Id id;
+        if (!config->findByName(requestArg("name"), id)) {
+            wifiManager.server->send(404, "application/json", "{\"success\":false,\"message\":\"Unknown setting\"}");
+            return;
+        }
+        
+        const RuntimeConfig::Entry& entry = RuntimeConfig::getEntry(id);
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+        if (!config->setFromString(id, requestArg("value"))) {
+            if (entry.type == RuntimeConfig::TYPE_BOOL) {
+                json.append("{\"success\":false,\"message\":\"Value must be true or false\"}");
+            } else {
+                json.appendFormat("{\"success\":false,\"message\":\"Value must be between %lu and %lu\"}",
+                                  (unsigned long)entry.minValue, (unsigned long)entry.maxValue);
+            }
+            sendJson(400, json);
+            return;
+        }
+        
+        json.appendFormat("{\"success\":true,\"name\":\"%s\",\"value\":", entry.name);
+        if (entry.type == RuntimeConfig::TYPE_BOOL) {
+            json.append(config->getBool(id) ? "true" : "false");
+        } else {
+            json.append((unsigned long)config->getInt(id));
+        }
+        json.appendFormat(",\"persistent\":%s}", entry.persistent ? "true" : "false");
+        sendJson(200, json);
+    }, WebRateLimiter::ROUTE_MUTATE);
+    Console::printlnR("✓ Registered: /api/config/set (GET)");
+    
+    // 8. Memory telemetry (heap and request arena)
+    onRequest("/api/memory", HTTP_GET, [this]() {
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY * 2);
+        json.appendFormat("{\"heap\":{\"free\":%lu,\"minFree\":%lu,\"largestFreeBlock\":%lu}",
+                          (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+                          (unsigned long)ESP.getMaxAllocHeap());
+        json.appendFormat(",\"arena\":{\"size\":%u,\"highWaterMark\":%u,\"peakRequestBytes\":%u,\"fallbacks\":%lu,\"fallbackBytes\":%lu,\"requests\":%lu}",
+                          (unsigned)requestArena.getSize(), (unsigned)requestArena.getHighWaterMark(),
+                          (unsigned)requestArena.getPeakRequestBytes(),
+                          (unsigned long)requestArena.getFallbackCount(), (unsigned long)requestArena.getFallbackBytes(),
+                          (unsigned long)requestArena.getRequestCount());
+        json.appendFormat(",\"stringOverflows\":%lu}", (unsigned long)StringBuilder::getOverflowCount());
+        sendJson(200, json);
+    });
+    Console::printlnR("✓ Registered: /api/memory (GET)");
+    
+    // Power telemetry (CPU frequency scaling, estimated energy saved)
+    onRequest("/api/power", HTTP_GET, [this]() {
+        if (!modules || !modules->hasCpuGovernor()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"CPU governor not available\"}");
+            return;
+        }
+        const CpuGovernor* governor = modules->getCpuGovernor();
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY * 2);
+        json.appendFormat("{\"scaling\":%s,\"cpuMhz\":%lu,\"idleMhz\":%lu,\"boostMhz\":%lu",
+                          governor->isEnabled() ? "true" : "false", (unsigned long)governor->getFrequencyMhz(),
+                          (unsigned long)CPU_IDLE_FREQ_MHZ, (unsigned long)CPU_BOOST_FREQ_MHZ);
+        json.appendFormat(",\"secondsAt\":{\"80\":%lu,\"160\":%lu,\"240\":%lu}",
+                          (unsigned long)governor->getTimeAtSeconds(80), (unsigned long)governor->getTimeAtSeconds(160),
+                          (unsigned long)governor->getTimeAtSeconds(240));
+        json.appendFormat(",\"switches\":%lu,\"boosts\":%lu,\"energySavedMwh\":%.1f}",
+                          (unsigned long)governor->getSwitchCount(), (unsigned long)governor->getBoostCount(),
+                          governor->getEnergySavedMwh());
+        sendJson(200, json);
+    });
+    Console::printlnR("✓ Registered: /api/power (GET)");
+    
+    // Sampling profiler dump (binary, see tools/profile_symbolize.py)
+    onRequest("/api/profile", HTTP_GET, [this]() {
+        if (!modules || !modules->hasSamplingProfiler()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Profiler not available\"}");
+            return;
+        }
+        const SamplingProfiler* profiler = modules->getSamplingProfiler();
+        if (profiler->isRunning()) {
+            wifiManager.server->send(409, "application/json", "{\"success\":false,\"message\":\"Profiler running - send PROFILE SAMPLE STOP first\"}");
+            return;
+        }
+        wifiManager.server->sendHeader("Content-Disposition", "attachment; filename=profile.bin");
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "application/octet-stream");
+        profiler->writeDump(body);
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/profile (GET)");
+    
+    // Timeline trace (Chrome trace-event JSON, open in ui.perfetto.dev)
+    onRequest("/api/trace", HTTP_GET, [this]() {
+        wifiManager.server->sendHeader("Content-Disposition", "attachment; filename=trace.json");
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "application/json");
+        TraceBuffer::writeChromeJson(body);
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/trace (GET)");
+    
+    // Recorded inputs (binary, decode/replay with tools/input_replay.py)
+    onRequest("/api/inputs", HTTP_GET, [this]() {
+        wifiManager.server->sendHeader("Content-Disposition", "attachment; filename=inputs.bin");
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "application/octet-stream");
+        InputRecorder::writeDump(body);
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/inputs (GET)");
+    
+    // Prometheus scrape target (every MetricsRegistry metric)
+    onRequest("/metrics", HTTP_GET, [this]() {
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "text/plain; version=0.0.4; charset=utf-8");
+        MetricsRegistry::writePrometheus(body);
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /metrics (GET)");
+    
+    // Metrics: feed trigger latency histograms with alert state
+    onRequest("/api/metrics", HTTP_GET, [this]() {
+        if (!modules || !modules->hasFeedLatencyTracker()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Metrics not available\"}");
+            return;
+        }
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "application/json");
+        body.print(F("{\"feedLatency\":"));
+        modules->getFeedLatencyTracker()->writeJson(body);
+        body.print('}');
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/metrics (GET)");
+    
+    // History: ?tier=minute|hour|day (default minute), &format=csv for CSV
+    onRequest("/api/series", HTTP_GET, [this]() {
+        if (!modules || !modules->hasSeriesStore() || !modules->getSeriesStore()->isReady()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"History not available\"}");
+            return;
+        }
+        const char* tierName = requestArg("tier");
+        SeriesStore::Tier tier = *tierName ? SeriesStore::findTier(tierName) : SeriesStore::TIER_MINUTE;
+        if (tier == SeriesStore::TIER_COUNT) {
+            wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"tier must be minute, hour or day\"}");
+            return;
+        }
+        bool csv = strcmp(requestArg("format"), "csv") == 0;
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        if (csv) {
+            body.begin(200, "text/csv");
+            modules->getSeriesStore()->writeCsv(body, tier);
+        } else {
+            body.begin(200, "application/octet-stream");
+            modules->getSeriesStore()->writeBinary(body, tier);
+        }
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/series (GET)");
+    
+    // Loop stalls: budget, blocking call statistics, sites and recent stalls
+    onRequest("/api/stalls", HTTP_GET, [this]() {
+        ChunkedResponse body(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+        body.begin(200, "application/json");
+        LoopWatchdog::writeJson(body);
+        body.end();
+    });
+    Console::printlnR("✓ Registered: /api/stalls (GET)");
+    
+    // 9. Time zone endpoints (RTC keeps UTC, local time from a POSIX TZ string)
+    onRequest("/api/timezone", HTTP_GET, [this]() {
+        if (!modules || !modules->hasRTCModule()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"RTC not available\"}");
+            return;
+        }
+        
+        RTCModule* rtc = modules->getRTCModule();
+        TimeZone& zone = rtc->getTimezone();
+        uint32_t utc = rtc->nowUtc();
+        DateTime local(zone.toLocal(utc));
+        
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY * 2);
+        json.append("{\"success\":true,\"tz\":\"").appendJsonEscaped(zone.getPosix());
+        json.append("\",\"abbreviation\":\"").appendJsonEscaped(zone.getAbbreviation(utc));
+        json.appendFormat("\",\"offset\":%ld,\"dst\":%s,\"utc\":%lu,\"local\":\"%02u/%02u/%u %02u:%02u:%02u\"}",
+                          (long)zone.getOffset(utc), zone.isDst(utc) ? "true" : "false", (unsigned long)utc,
+                          local.day(), local.month(), local.year(),
+                          local.hour(), local.minute(), local.second());
+        sendJson(200, json);
+    });
+    Console::printlnR("✓ Registered: /api/timezone (GET)");
+    
+    onRequest("/api/timezone/set", HTTP_GET, [this]() {
+        if (!modules || !modules->hasRTCModule()) {
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"RTC not available\"}");
+            return;
+        }
+        
+        if (!wifiManager.server->hasArg("tz")) {
+            wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Missing 'tz' parameter. Use: /api/timezone/set?tz=POSIX TZ string\"}");
+            return;
+        }
+        
+        const char* posix = requestArg("tz");
+        if (!modules->getRTCModule()->setTimezone(posix)) {
+            wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Invalid POSIX TZ string (e.g. CET-1CEST,M3.5.0,M10.5.0/3)\"}");
+            return;
+        }
+        
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+        json.append("{\"success\":true,\"tz\":\"").appendJsonEscaped(posix).append("\"}");
+        sendJson(200, json);
+    }, WebRateLimiter::ROUTE_MUTATE);
+    Console::printlnR("✓ Registered: /api/timezone/set (GET)");
+    
+    // 10. Schedule API endpoints (the critical ones)
     Console::printlnR("=== REGISTERING SCHEDULE API ENDPOINTS ===");
     setupScheduleAPIEndpoints();
     
@@ -285,7 +569,11 @@ void WiFiController::registerAllEndpoints() {
 void WiFiController::scanNetworks() {
     Console::printlnR(F("Scanning WiFi networks..."));
     
-    int networkCount = WiFi.scanNetworks();
+    int networkCount;
+    {
+        LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_WIFI_SCAN);
+        networkCount = WiFi.scanNetworks();
+    }
     
     if (networkCount == 0) {
         Console::printlnR(F("No networks found"));
@@ -335,8 +623,8 @@ bool WiFiController::connectToNetwork(const String& ssid, const String& password
     Console::printlnR(ssid);
     
     // 🚨 CRITICAL: Set LED to BLUE STATIC immediately when starting connection attempt
-    if (rgbLed) {
-        rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_CONNECTING);
+    if (ledStatus) {
+        ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_CONNECTING);
     }
     
     if (isConnected && currentSSID == ssid) {
@@ -347,14 +635,14 @@ bool WiFiController::connectToNetwork(const String& ssid, const String& password
     // Disconnect from current network if connected
     if (isConnected) {
         WiFi.disconnect();
-        connectionState = WIFI_DISCONNECTING;
+        setConnectionState(WIFI_DISCONNECTING);
         connectionStateTime = millis();
         return false; // Connection in progress, will be checked later
     }
     
     lastConnectionAttempt = millis();
     WiFi.begin(ssid.c_str(), password.c_str());
-    connectionState = WIFI_CONNECTING;
+    setConnectionState(WIFI_CONNECTING);
     connectionStateTime = millis();
     connectionAttempts = 0;
     
@@ -468,7 +756,7 @@ void WiFiController::clearAllSavedNetworks() {
  * Check if WiFi is connected
  */
 bool WiFiController::isWiFiConnected() {
-    return WiFi.status() == WL_CONNECTED;
+    return readWiFiStatus() == WL_CONNECTED;
 }
 
 /**
@@ -656,14 +944,15 @@ void WiFiController::checkConnectionStatus() {
         // Connection lost - start portal if configured
         if (wasConnectedBefore && !currentlyConnected && !configPortalActive) {
             Console::printlnR(F("WiFi connection lost!"));
+            wifiConnectionLosses.inc();
             isConnected = false;
             
             // Mark error state if not already marked
             if (!inErrorState) {
                 inErrorState = true;
                 errorStateStartTime = millis();
-                if (rgbLed) {
-                    rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
+                if (ledStatus) {
+                    ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
                 }
             }
             
@@ -697,6 +986,27 @@ void WiFiController::checkConnectionStatus() {
     handleErrorStateReconnection();
 }
 
+/**
+ * Change the connection state machine state (traced)
+ */
+void WiFiController::setConnectionState(WiFiConnectionState state) {
+    static const char* const STATE_NAMES[] = { "idle", "disconnecting", "connecting", "connected", "failed" };
+    connectionState = state;
+    TraceBuffer::instant(TraceBuffer::WIFI_STATE, STATE_NAMES[state]);
+}
+
+/**
+ * Read WiFi.status(), recording changes for input replay
+ */
+wl_status_t WiFiController::readWiFiStatus() {
+    wl_status_t status = WiFi.status();
+    if (status != recordedWiFiStatus && InputRecorder::isEnabled()) {
+        InputRecorder::recordByte(InputRecorder::TYPE_WIFI_STATUS, (uint8_t)status);
+        recordedWiFiStatus = status;
+    }
+    return status;
+}
+
 /**
  * Process non-blocking WiFi connection state machine
  * This method should be called regularly (e.g., every 500ms) to handle connection state
@@ -711,7 +1021,7 @@ void WiFiController::processConnectionState() {
             // Wait 1 second after disconnect before connecting
             if (millis() - connectionStateTime >= 1000) {
                 WiFi.begin(pendingSSID.c_str(), pendingPassword.c_str());
-                connectionState = WIFI_CONNECTING;
+                setConnectionState(WIFI_CONNECTING);
                 connectionStateTime = millis();
                 connectionAttempts = 0;
             }
@@ -722,7 +1032,7 @@ void WiFiController::processConnectionState() {
             if (millis() - connectionStateTime >= CONNECTION_CHECK_INTERVAL) {
                 connectionAttempts++;
                 
-                wl_status_t status = WiFi.status();
+                wl_status_t status = readWiFiStatus();
                 
                 if (status == WL_CONNECTED) {
                     // Connection successful
@@ -738,9 +1048,9 @@ void WiFiController::processConnectionState() {
                     printNetworkDetails();
                     configureDNSServers();
                     
-                    // 🚨 SUCCESS: Set LED to GREEN (ready state)
-                    if (rgbLed) {
-                        rgbLed->setDeviceStatus(RGBLed::STATUS_READY);
+                    // 🚨 SUCCESS: Clear WiFi layer (LED back to ready unless something else is shown)
+                    if (ledStatus) {
+                        ledStatus->pop(LedStatusCompositor::LAYER_WIFI);
                     }
                     
                     // Clear error state on successful connection
@@ -751,7 +1061,7 @@ void WiFiController::processConnectionState() {
                         Console::printlnR(F("✓ Error state cleared after successful connection"));
                     }
                     
-                    connectionState = WIFI_CONNECTED;
+                    setConnectionState(WIFI_CONNECTED);
                 }
                 // 🚨 CRITICAL: Detect authentication failure IMMEDIATELY
                 else if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL || 
@@ -784,8 +1094,8 @@ void WiFiController::processConnectionState() {
                     Console::printlnR(String(status));
                     
                     // 🚨 ERROR: Set LED to RED BLINKING IMMEDIATELY
-                    if (rgbLed) {
-                        rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
+                    if (ledStatus) {
+                        ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
                     }
                     
                     // Mark error state start time for reconnection strategy
@@ -795,7 +1105,7 @@ void WiFiController::processConnectionState() {
                         Console::printlnR(F("Error state timer started (30s reset countdown)"));
                     }
                     
-                    connectionState = WIFI_FAILED;
+                    setConnectionState(WIFI_FAILED);
                 } else {
                     // Still trying to connect
                     Console::printR(F("."));
@@ -807,7 +1117,7 @@ void WiFiController::processConnectionState() {
         case WIFI_CONNECTED:
         case WIFI_FAILED:
             // Reset to idle state after completion
-            connectionState = WIFI_IDLE;
+            setConnectionState(WIFI_IDLE);
             break;
     }
 }
@@ -873,9 +1183,9 @@ bool WiFiController::tryAutoConnect() {
         Console::printlnR(currentSSID);
         printNetworkDetails();
         
-        // 🚨 SUCCESS: Set LED to GREEN only if truly connected
-        if (rgbLed && WiFi.status() == WL_CONNECTED) {
-            rgbLed->setDeviceStatus(RGBLed::STATUS_READY);
+        // 🚨 SUCCESS: Clear WiFi layer only if truly connected
+        if (ledStatus && readWiFiStatus() == WL_CONNECTED) {
+            ledStatus->pop(LedStatusCompositor::LAYER_WIFI);
         }
         
         // Clear error state on successful connection
@@ -902,8 +1212,8 @@ bool WiFiController::tryAutoConnect() {
     if (count == 0) {
         Console::printlnR(F("No custom saved networks found"));
         // 🚨 ERROR: Set LED to RED BLINKING (no networks configured)
-        if (rgbLed) {
-            rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
+        if (ledStatus) {
+            ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
         }
         return false;
     }
@@ -931,14 +1241,14 @@ bool WiFiController::tryAutoConnect() {
             int attempts = 0;
             const int maxAttempts = 20; // 10 seconds timeout
             
-            while (WiFi.status() != WL_CONNECTED && attempts < maxAttempts) {
+            while (readWiFiStatus() != WL_CONNECTED && attempts < maxAttempts) {
                 delay(500);
                 Console::printR(F("."));
                 attempts++;
             }
             Console::printlnR(F(""));
             
-            if (WiFi.status() == WL_CONNECTED) {
+            if (readWiFiStatus() == WL_CONNECTED) {
                 isConnected = true;
                 wasConnectedBefore = true;
                 currentSSID = savedSSID;
@@ -948,9 +1258,9 @@ bool WiFiController::tryAutoConnect() {
                 Console::printlnR(savedSSID);
                 printNetworkDetails();
                 
-                // 🚨 SUCCESS: Set LED to GREEN only if truly connected
-                if (rgbLed && WiFi.status() == WL_CONNECTED) {
-                    rgbLed->setDeviceStatus(RGBLed::STATUS_READY);
+                // 🚨 SUCCESS: Clear WiFi layer only if truly connected
+                if (ledStatus && readWiFiStatus() == WL_CONNECTED) {
+                    ledStatus->pop(LedStatusCompositor::LAYER_WIFI);
                 }
                 
                 return true;
@@ -963,8 +1273,8 @@ bool WiFiController::tryAutoConnect() {
     
     Console::printlnR(F("Could not connect to any saved network"));
     // 🚨 ERROR: Set LED to RED BLINKING (connection failed)
-    if (rgbLed) {
-        rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR);
+    if (ledStatus) {
+        ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR);
     }
     return false;
 }
@@ -1002,7 +1312,7 @@ void WiFiController::stopConfigPortal() {
         WiFi.softAPdisconnect(true);
         
         // Switch back to STA mode only if connected to WiFi
-        if (WiFi.status() == WL_CONNECTED) {
+        if (readWiFiStatus() == WL_CONNECTED) {
             WiFi.mode(WIFI_STA);
             Console::printlnR(F("✓ Switched to Station mode - WiFi connection maintained"));
         } else {
@@ -1156,6 +1466,7 @@ bool WiFiController::testInternetConnection() {
         return false;
     }
     
+    LoopWatchdog::Blocker blocking(LoopWatchdog::BLOCKING_INTERNET_TEST);
     Console::printlnR(F("Testing internet connectivity..."));
     Console::printlnR(F("Making HTTP request to google.com"));
     
@@ -1286,15 +1597,14 @@ void WiFiController::startAlwaysOnPortal() {
         // Register endpoints directly after starting portal as backup
         Console::printlnR("=== REGISTERING ENDPOINTS DIRECTLY ===");
         if (wifiManager.server) {
-            wifiManager.server->on("/api/test", HTTP_GET, [this]() {
+            onRequest("/api/test", HTTP_GET, [this]() {
                 Console::printlnR("=== DIRECT API TEST ENDPOINT CALLED ===");
                 wifiManager.server->send(200, "application/json", "{\"status\":\"Direct API working\"}");
             });
             
-            wifiManager.server->on("/custom", HTTP_GET, [this]() {
+            onRequest("/custom", HTTP_GET, [this]() {
                 Console::printlnR("=== DIRECT CUSTOM PAGE REQUEST ===");
-                String html = generateScheduleManagementPage();
-                wifiManager.server->send(200, "text/html; charset=utf-8", html);
+                sendScheduleManagementPage();
             });
             
             // NOTE: Schedule API endpoints will be registered later via registerAllEndpoints()
@@ -1425,7 +1735,7 @@ void WiFiController::processConfigPortal() {
         wifiManager.process();
         
         // Check for new WiFi connection
-        if (WiFi.status() == WL_CONNECTED && currentSSID != WiFi.SSID()) {
+        if (readWiFiStatus() == WL_CONNECTED && currentSSID != WiFi.SSID()) {
             // New connection established
             isConnected = true;
             wasConnectedBefore = true;
@@ -1439,7 +1749,7 @@ void WiFiController::processConfigPortal() {
         }
         
         // Check for connection loss
-        if (isConnected && WiFi.status() != WL_CONNECTED) {
+        if (isConnected && readWiFiStatus() != WL_CONNECTED) {
             Console::printlnR(F("WiFi connection lost - portal remains active"));
             isConnected = false;
             currentSSID = "";
@@ -1457,9 +1767,9 @@ void WiFiController::processConfigPortal() {
 /**
  * Generate complete Feeding Schedule Management Interface
  */
-String WiFiController::generateScheduleManagementPage() {
-    Console::printlnR("=== GENERATING SCHEDULE MANAGEMENT PAGE ===");
-    String html = "<!DOCTYPE html><html><head>";
+void WiFiController::renderScheduleManagementPage(ChunkedResponse& html) {
+    Console::printlnR(F("=== GENERATING SCHEDULE MANAGEMENT PAGE ==="));
+    html += "<!DOCTYPE html><html><head>";
     html += "<meta charset='UTF-8'>";
     html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
     html += "<meta http-equiv='Cache-Control' content='no-cache, no-store, must-revalidate'>";
@@ -1536,6 +1846,12 @@ String WiFiController::generateScheduleManagementPage() {
     html += ".back-link { display: inline-block; margin-top: 30px; padding: 15px 30px; background: #95a5a6; color: white; border-radius: 8px; text-decoration: none; font-weight: 600; }";
     html += ".back-link:hover { background: #7f8c8d; }";
     
+    // History charts
+    html += ".history-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(320px, 1fr)); gap: 20px; }";
+    html += ".history-card { background: white; border-radius: 10px; padding: 15px; box-shadow: 0 5px 15px rgba(0,0,0,0.08); }";
+    html += ".history-card h4 { color: #2c3e50; margin-bottom: 10px; }";
+    html += ".history-card canvas { width: 100%; height: 160px; }";
+    
     // Toggle switch CSS
     html += ".switch { position: relative; display: inline-block; width: 50px; height: 24px; }";
     html += ".switch input { opacity: 0; width: 0; height: 0; }";
@@ -1573,7 +1889,9 @@ String WiFiController::generateScheduleManagementPage() {
     html += "<h3>&#128246; WiFi Status</h3>";
     if (isConnected) {
         html += "<div class='status-value status-enabled'>&#10003; Connected</div>";
-        html += "<div class='status-time'>Network: " + currentSSID + "</div>";
+        html += "<div class='status-time'>Network: ";
+        html += currentSSID;
+        html += "</div>";
     } else {
         html += "<div class='status-value status-disabled'>&#9888; Disconnected</div>";
         html += "<div class='status-time'>Configure connection</div>";
@@ -1606,9 +1924,13 @@ String WiFiController::generateScheduleManagementPage() {
     html += "<label for='portionSelect' style='font-weight: 600; color: #2c3e50;'>Portions:</label>";
     html += "<select id='portionSelect' class='form-control' style='width: 120px;'>";
     for (int i = 1; i <= 20; i++) {
-        html += "<option value='" + String(i) + "'";
+        html += "<option value='";
+        html.print(i);
+        html += "'";
         if (i == 1) html += " selected"; // Default to 1 portions
-        html += ">" + String(i) + "</option>";
+        html += ">";
+        html.print(i);
+        html += "</option>";
     }
     html += "</select>";
     html += "<button class='btn btn-primary' onclick='feedNowFromSelect()'>&#127860; Feed Now</button>";
@@ -1670,7 +1992,11 @@ String WiFiController::generateScheduleManagementPage() {
     html += "<label for='touchPortions'>Touch Sensor Long Press Portions</label>";
     html += "<select id='touchPortions' class='form-control' onchange='setTouchPortions()' style='width: 200px;'>";
     for (int i = 1; i <= 10; i++) {
-        html += "<option value='" + String(i) + "'>" + String(i) + " portion" + String(i > 1 ? "s" : "") + "</option>";
+        html += "<option value='";
+        html.print(i);
+        html += "'>";
+        html.print(i);
+        html += i > 1 ? " portions</option>" : " portion</option>";
     }
     html += "</select>";
     html += "<div id='touchPortionsStatus' style='margin-top: 8px; font-size: 0.9em; color: #7f8c8d;'>Current: 2 portions</div>";
@@ -1689,6 +2015,29 @@ String WiFiController::generateScheduleManagementPage() {
     html += "</div>";
     html += "</div>";
     
+    // Device history (rendered client-side from /api/series)
+    html += "<div class='section'>";
+    html += "<h2>&#128200; Device History</h2>";
+    html += "<div style='display: flex; gap: 15px; align-items: center; margin-bottom: 20px; flex-wrap: wrap;'>";
+    html += "<select id='historyTier' class='form-control' style='width: 260px;' onchange='loadHistory()'>";
+    for (uint8_t i = 0; i < SeriesStore::TIER_COUNT; i++) {
+        const SeriesStore::TierInfo& tier = SeriesStore::getTierInfo((SeriesStore::Tier)i);
+        uint32_t spanHours = tier.slots * tier.slotSeconds / 3600;
+        html += "<option value='";
+        html += tier.name;
+        html += "'>Per ";
+        html += tier.name;
+        html += " - last ";
+        html.print(spanHours >= 48 ? spanHours / 24 : spanHours);
+        html += spanHours >= 48 ? " days</option>" : " hours</option>";
+    }
+    html += "</select>";
+    html += "<button class='btn btn-success btn-small' onclick='loadHistory()'>Refresh</button>";
+    html += "<a id='historyCsv' class='btn btn-primary btn-small' href='/api/series?format=csv'>Download CSV</a>";
+    html += "</div>";
+    html += "<div id='historyCharts' class='history-grid'>Loading...</div>";
+    html += "</div>";
+    
     html += "</div>"; // End content
     
     // Back link
@@ -2077,12 +2426,96 @@ String WiFiController::generateScheduleManagementPage() {
     html += "}";
     
     // Initialize on page load
+    // History charts: min/max band and average line per series
+    html += "const HISTORY_SERIES = [";
+    for (uint8_t i = 0; i < SeriesStore::SERIES_COUNT; i++) {
+        const SeriesStore::SeriesInfo& series = SeriesStore::getSeriesInfo((SeriesStore::Series)i);
+        html += "{label:'";
+        html += series.label;
+        html += "',unit:'";
+        html += series.unit;
+        html += "',decimals:";
+        html.print(series.decimals);
+        html += "},";
+    }
+    html += "];";
+    html += "function loadHistory() {";
+    html += "  const tier = document.getElementById('historyTier').value;";
+    html += "  document.getElementById('historyCsv').href = '/api/series?format=csv&tier=' + tier;";
+    html += "  const xhr = new XMLHttpRequest();";
+    html += "  xhr.open('GET', '/api/series?tier=' + tier, true);";
+    html += "  xhr.responseType = 'arraybuffer';";
+    html += "  xhr.onload = function() {";
+    html += "    const box = document.getElementById('historyCharts');";
+    html += "    if(xhr.status !== 200) { box.textContent = 'History not available'; return; }";
+    html += "    const buf = xhr.response, view = new DataView(buf);";
+    html += "    const count = view.getUint8(6), fields = view.getUint8(7);";
+    html += "    const slotSeconds = view.getUint32(8, true), newest = view.getUint32(12, true), slots = view.getUint16(16, true);";
+    html += "    let offset = 20 + count * 8;";
+    html += "    box.innerHTML = '';";
+    html += "    for(let s = 0; s < count && s < HISTORY_SERIES.length; s++) {";
+    html += "      const scale = view.getFloat32(20 + s * 8, true), kind = view.getUint8(24 + s * 8);";
+    html += "      drawHistory(box, HISTORY_SERIES[s], new Int16Array(buf, offset, slots * fields), fields, scale, kind,";
+    html += "                  newest - (slots - 1) * slotSeconds, slotSeconds, slots);";
+    html += "      offset += slots * fields * 2;";
+    html += "    }";
+    html += "  };";
+    html += "  xhr.send();";
+    html += "}";
+    html += "function drawHistory(box, info, values, fields, scale, kind, first, slotSeconds, slots) {";
+    html += "  const card = document.createElement('div');";
+    html += "  const title = document.createElement('h4');";
+    html += "  const canvas = document.createElement('canvas');";
+    html += "  card.className = 'history-card';";
+    html += "  canvas.width = 600; canvas.height = 160;";
+    html += "  card.appendChild(title); card.appendChild(canvas); box.appendChild(card);";
+    // Count series keep the slot total in the avg field and draw no band
+    html += "  const avgField = fields > 1 ? 1 : 0;";
+    html += "  const lowField = kind === 1 ? avgField : 0, highField = kind === 1 ? avgField : fields - 1;";
+    html += "  let low = Infinity, high = -Infinity, last = null;";
+    html += "  for(let i = 0; i < slots; i++) {";
+    html += "    if(values[i * fields + avgField] === -32768) continue;";
+    html += "    low = Math.min(low, values[i * fields + lowField]);";
+    html += "    high = Math.max(high, values[i * fields + highField]);";
+    html += "    last = values[i * fields + avgField];";
+    html += "  }";
+    html += "  title.textContent = info.label + (last === null ? ': no data' : ': ' + (last * scale).toFixed(info.decimals) + ' ' + info.unit);";
+    html += "  if(last === null) return;";
+    html += "  if(high === low) { high += 1; low -= 1; }";
+    html += "  const ctx = canvas.getContext('2d'), w = canvas.width, h = canvas.height - 18;";
+    html += "  const x = function(i) { return i * w / slots; };";
+    html += "  const y = function(v) { return 4 + (high - v) * (h - 8) / (high - low); };";
+    html += "  ctx.fillStyle = 'rgba(52,152,219,0.25)';";
+    html += "  ctx.strokeStyle = '#2980b9';";
+    html += "  ctx.beginPath();";
+    html += "  let pen = false;";
+    html += "  for(let i = 0; i < slots; i++) {";
+    html += "    const base = i * fields, v = values[base + avgField];";
+    html += "    if(v === -32768) { pen = false; continue; }";
+    html += "    if(highField !== lowField) ctx.fillRect(x(i), y(values[base + highField]), Math.max(1, w / slots), y(values[base + lowField]) - y(values[base + highField]) + 1);";
+    html += "    if(pen) ctx.lineTo(x(i), y(v)); else ctx.moveTo(x(i), y(v));";
+    // Isolated values (NTP offset between syncs) get a mark, a line needs two
+    html += "    if(!pen && (i + 1 >= slots || values[base + fields + avgField] === -32768)) ctx.rect(x(i) - 1, y(v) - 1, 2, 2);";
+    html += "    pen = true;";
+    html += "  }";
+    html += "  ctx.stroke();";
+    html += "  ctx.fillStyle = '#7f8c8d';";
+    html += "  ctx.font = '11px sans-serif';";
+    html += "  ctx.fillText((high * scale).toFixed(info.decimals), 2, 12);";
+    html += "  ctx.fillText((low * scale).toFixed(info.decimals), 2, h);";
+    html += "  const time = function(i) { return new Date((first + i * slotSeconds) * 1000).toLocaleString(); };";
+    html += "  ctx.fillText(time(0), 2, canvas.height - 3);";
+    html += "  ctx.textAlign = 'right';";
+    html += "  ctx.fillText(time(slots - 1), w - 2, canvas.height - 3);";
+    html += "}";
+    
     html += "window.onload = function() {";
     html += "  loadSchedules();";
     html += "  loadStatus();";
     html += "  loadMotorDirection();";
     html += "  loadTouchPortions();";
     html += "  loadTouchEnabled();";
+    html += "  loadHistory();";
     html += "  updateClock();";
     html += "  setInterval(updateClock, 1000);";
     html += "  window.addEventListener('beforeunload', function(e) {";
@@ -2096,9 +2529,186 @@ String WiFiController::generateScheduleManagementPage() {
     
     html += "</script>";
     html += "</body></html>";
+}
+
+/**
+ * Stream the schedule management page
+ * Rendered through a chunk buffer in the request arena instead of one
+ * page-sized String
+ */
+void WiFiController::sendScheduleManagementPage() {
+    ChunkedResponse html(*wifiManager.server, requestArena.allocateText(WEB_RESPONSE_CHUNK_SIZE), WEB_RESPONSE_CHUNK_SIZE);
+    html.begin(200, "text/html; charset=utf-8");
+    renderScheduleManagementPage(html);
+    html.end();
+    
+    FixedString<64> line;
+    line.appendFormat("=== SCHEDULE MANAGEMENT PAGE SENT (%u bytes) ===", (unsigned)html.getBytesWritten());
+    Console::printlnR(line.c_str());
+}
+
+/**
+ * Register a web handler that runs inside a request arena scope
+ * Everything the handler takes from requestArena is released when it returns
+ * Page rendering and JSON building run with the CPU boosted (CpuGovernor)
+ * Requests over the client's rate or the handler time budget are rejected
+ * before any of that (WebRateLimiter)
+ *
+ * @param uri: Endpoint path
+ * @param method: HTTP method
+ * @param handler: Request handler
+ * @param routeClass: Rate limit class (read, mutate, feed)
+ */
+void WiFiController::onRequest(const char* uri, HTTPMethod method, WebServer::THandlerFunction handler,
+                               WebRateLimiter::RouteClass routeClass) {
+    wifiManager.server->on(uri, method, [this, uri, handler, routeClass]() {
+        if (!admitRequest(routeClass)) {
+            return;
+        }
+        WebRateLimiter::Scope admission(rateLimiter);
+        TraceBuffer::begin(TraceBuffer::HTTP_REQUEST, uri);
+        LoopWatchdog::Scope watchdog(LoopWatchdog::CALLBACK_HTTP, uri);
+        httpRequests.inc();
+        if (InputRecorder::isEnabled()) {
+            recordRequest();
+        }
+        if (modules && modules->hasCpuGovernor()) {
+            modules->getCpuGovernor()->boost();
+        }
+        {
+            RequestArena::Scope scope(requestArena);
+            handler();
+        }
+        TraceBuffer::end(TraceBuffer::HTTP_REQUEST);
+    });
+}
+
+/**
+ * Admission control for the current request
+ * Rejections are answered here, without modules, logging or trace records
+ *
+ * @param routeClass: Rate limit class of the endpoint
+ * @return: true if the handler may run
+ */
+bool WiFiController::admitRequest(WebRateLimiter::RouteClass routeClass) {
+    WebServer& server = *wifiManager.server;
+    uint32_t retryAfterS = 0;
+    WebRateLimiter::Decision decision = rateLimiter.admit((uint32_t)server.client().remoteIP(), routeClass, retryAfterS);
+    if (decision == WebRateLimiter::ADMIT) {
+        return true;
+    }
     
-    Console::printlnR("=== SCHEDULE MANAGEMENT PAGE GENERATED (" + String(html.length()) + " bytes) ===");
-    return html;
+    FixedString<12> retryAfter;
+    retryAfter.append((unsigned long)retryAfterS);
+    server.sendHeader("Retry-After", retryAfter.c_str());
+    if (decision == WebRateLimiter::REJECT_RATE) {
+        server.send(429, "application/json", "{\"success\":false,\"message\":\"Too many requests\"}");
+    } else {
+        server.send(503, "application/json", "{\"success\":false,\"message\":\"Busy - retry later\"}");
+    }
+    return false;
+}
+
+/**
+ * Record the current request as "METHOD /uri?name=value&..." for input
+ * replay (names and values URL-encoded, POST bodies arrive as "plain")
+ */
+void WiFiController::recordRequest() {
+    WebServer& server = *wifiManager.server;
+    
+    FixedString<INPUT_RECORDER_MAX_PAYLOAD> line;
+    switch (server.method()) {
+        case HTTP_GET:     line.append("GET"); break;
+        case HTTP_POST:    line.append("POST"); break;
+        case HTTP_PUT:     line.append("PUT"); break;
+        case HTTP_PATCH:   line.append("PATCH"); break;
+        case HTTP_DELETE:  line.append("DELETE"); break;
+        case HTTP_HEAD:    line.append("HEAD"); break;
+        case HTTP_OPTIONS: line.append("OPTIONS"); break;
+        default:           line.append("OTHER"); break;
+    }
+    line.append(' ');
+    line.append(server.uri().c_str());
+    for (int i = 0; i < server.args(); i++) {
+        line.append(i == 0 ? '?' : '&');
+        appendUrlEncoded(line, server.argName(i).c_str());
+        line.append('=');
+        appendUrlEncoded(line, server.arg(i).c_str());
+    }
+    InputRecorder::recordText(InputRecorder::TYPE_HTTP_REQUEST, line.c_str());
+}
+
+/**
+ * Append text with everything but unreserved characters percent-encoded
+ */
+void WiFiController::appendUrlEncoded(StringBuilder& out, const char* text) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    for (; *text; text++) {
+        char c = *text;
+        if (isalnum((unsigned char)c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out.append(c);
+        } else {
+            out.append('%');
+            out.append(HEX_DIGITS[(uint8_t)c >> 4]);
+            out.append(HEX_DIGITS[(uint8_t)c & 0x0F]);
+        }
+    }
+}
+
+/**
+ * Get a request argument as text valid for the rest of the request
+ *
+ * @param name: Argument name
+ * @return: Arena copy of the value ("" if missing)
+ */
+const char* WiFiController::requestArg(const char* name) {
+    if (!wifiManager.server->hasArg(name)) {
+        return "";
+    }
+    return requestArena.copy(wifiManager.server->arg(name).c_str());
+}
+
+/**
+ * Get a request argument as a number
+ *
+ * @param name: Argument name
+ * @return: Parsed value (0 if missing or not a number)
+ */
+long WiFiController::requestArgInt(const char* name) {
+    return strtol(requestArg(name), nullptr, 10);
+}
+
+/**
+ * Get the web request arena (telemetry)
+ */
+const RequestArena& WiFiController::getRequestArena() const {
+    return requestArena;
+}
+
+/**
+ * Get the web API admission control (telemetry)
+ */
+const WebRateLimiter& WiFiController::getRateLimiter() const {
+    return rateLimiter;
+}
+
+/**
+ * Send a JSON response from a fixed buffer
+ * The body is sent without copying it into a String; a truncated body
+ * would be invalid JSON, so an overflow is reported as HTTP 500 instead
+ *
+ * @param code: HTTP status code for a complete body
+ * @param json: Response body
+ */
+void WiFiController::sendJson(int code, const StringBuilder& json) {
+    if (json.overflowed()) {
+        FixedString<64> line;
+        line.appendFormat("API: Response exceeded buffer capacity (%u bytes)", (unsigned)json.capacity());
+        Console::printlnR(line.c_str());
+        wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Response too large\"}");
+        return;
+    }
+    wifiManager.server->send_P(code, "application/json", json.c_str(), json.length());
 }
 
 /**
@@ -2120,183 +2730,157 @@ void WiFiController::setupScheduleAPIEndpoints() {
     Console::printlnR("FeedingSchedule available - setting up endpoints...");
     
     // Get schedule status (last feeding, next feeding, etc.)
-    wifiManager.server->on("/api/status", HTTP_GET, [this]() {
-        Console::printlnR("API: Status request received");
-        String json = "{";
+    onRequest("/api/status", HTTP_GET, [this]() {
+        Console::printlnR(F("API: Status request received"));
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_STATUS_CAPACITY);
         
         // CRITICAL: Verify modules pointer before use
         if (modules && modules->getFeedingSchedule()) {
-            // Get last feeding time
-            DateTime lastFeeding = modules->getFeedingSchedule()->getLastCompletedFeeding();
-            json += "\"lastFeeding\":\"";
+            FeedingSchedule* schedule = modules->getFeedingSchedule();
+            
+            // Get last feeding time (DD/MM/YYYY HH:MM with leading zeros)
+            DateTime lastFeeding = schedule->getLastCompletedFeeding();
+            json.append("{\"lastFeeding\":\"");
             if (lastFeeding.year() == 2000) {
-                json += "Never";
+                json.append("Never");
             } else {
-                // Format: DD/MM/YYYY HH:MM with leading zeros
-                if (lastFeeding.day() < 10) json += "0";
-                json += String(lastFeeding.day()) + "/";
-                if (lastFeeding.month() < 10) json += "0";
-                json += String(lastFeeding.month()) + "/" + String(lastFeeding.year());
-                json += " ";
-                if (lastFeeding.hour() < 10) json += "0";
-                json += String(lastFeeding.hour()) + ":";
-                if (lastFeeding.minute() < 10) json += "0";
-                json += String(lastFeeding.minute());
+                json.appendFormat("%02u/%02u/%u %02u:%02u",
+                                  lastFeeding.day(), lastFeeding.month(), lastFeeding.year(),
+                                  lastFeeding.hour(), lastFeeding.minute());
             }
-            json += "\",";
             
             // Get next feeding time
-            DateTime nextFeeding = modules->getFeedingSchedule()->getNextScheduledTime();
-            json += "\"nextFeeding\":\"";
+            DateTime nextFeeding = schedule->getNextScheduledTime();
+            json.append("\",\"nextFeeding\":\"");
             if (nextFeeding.year() == 2000 || nextFeeding.year() >= 2099) {
-                json += "No active schedules";
+                json.append("No active schedules");
             } else {
-                // Format: DD/MM/YYYY HH:MM with leading zeros
-                if (nextFeeding.day() < 10) json += "0";
-                json += String(nextFeeding.day()) + "/";
-                if (nextFeeding.month() < 10) json += "0";
-                json += String(nextFeeding.month()) + "/" + String(nextFeeding.year());
-                json += " ";
-                if (nextFeeding.hour() < 10) json += "0";
-                json += String(nextFeeding.hour()) + ":";
-                if (nextFeeding.minute() < 10) json += "0";
-                json += String(nextFeeding.minute());
+                json.appendFormat("%02u/%02u/%u %02u:%02u",
+                                  nextFeeding.day(), nextFeeding.month(), nextFeeding.year(),
+                                  nextFeeding.hour(), nextFeeding.minute());
             }
-            json += "\",";
             
-            json += "\"scheduleEnabled\":";
-            json += modules->getFeedingSchedule()->isScheduleEnabled() ? "true" : "false";
-            json += ",\"scheduleCount\":";
-            json += String(modules->getFeedingSchedule()->getScheduleCount());
-            json += ",\"tolerance\":";
-            json += String(modules->getFeedingSchedule()->getTolerance());
-            json += ",\"recovery\":";
-            json += String(modules->getFeedingSchedule()->getMaxRecoveryHours());
+            json.appendFormat("\",\"scheduleEnabled\":%s,\"scheduleCount\":%u,\"tolerance\":%u,\"recovery\":%u}",
+                              schedule->isScheduleEnabled() ? "true" : "false",
+                              schedule->getScheduleCount(),
+                              schedule->getTolerance(),
+                              schedule->getMaxRecoveryHours());
         } else {
-            json += "\"lastFeeding\":\"System offline\"";
-            json += ",\"nextFeeding\":\"System offline\"";
-            json += ",\"scheduleEnabled\":false";
-            json += ",\"scheduleCount\":0";
-            json += ",\"tolerance\":30";
-            json += ",\"recovery\":12";
+            json.append("{\"lastFeeding\":\"System offline\"");
+            json.append(",\"nextFeeding\":\"System offline\"");
+            json.append(",\"scheduleEnabled\":false");
+            json.append(",\"scheduleCount\":0");
+            json.append(",\"tolerance\":30");
+            json.append(",\"recovery\":12}");
         }
         
-        json += "}";
-        Console::printlnR("API: Status response sent - " + json.substring(0, 100) + (json.length() > 100 ? "..." : ""));
-        wifiManager.server->send(200, "application/json", json);
+        Console::printR(F("API: Status response sent - "));
+        Console::printlnR(json.c_str());
+        sendJson(200, json);
     });
     
     // Get all schedules
-    wifiManager.server->on("/api/schedules", HTTP_GET, [this]() {
-        Console::printlnR("API: Schedules request received");
-        String json = "[";
+    onRequest("/api/schedules", HTTP_GET, [this]() {
+        Console::printlnR(F("API: Schedules request received"));
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SCHEDULES_CAPACITY);
+        json.append('[');
         
-        if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->getScheduleCount() > 0) {
-            for (uint8_t i = 0; i < modules->getFeedingSchedule()->getScheduleCount(); i++) {
-                ScheduledFeeding schedule = modules->getFeedingSchedule()->getSchedule(i);
+        uint8_t count = 0;
+        if (modules && modules->getFeedingSchedule()) {
+            FeedingSchedule* feedingSchedule = modules->getFeedingSchedule();
+            count = feedingSchedule->getScheduleCount();
+            for (uint8_t i = 0; i < count; i++) {
+                ScheduledFeeding schedule = feedingSchedule->getSchedule(i);
                 
-                if (i > 0) json += ",";
-                json += "{";
-                json += "\"index\":" + String(i) + ",";
-                json += "\"hour\":" + String(schedule.hour) + ",";
-                json += "\"minute\":" + String(schedule.minute) + ",";
-                json += "\"second\":" + String(schedule.second) + ",";
-                json += "\"portions\":" + String(schedule.portions) + ",";
-                json += "\"enabled\":" + String(schedule.enabled ? "true" : "false") + ",";
-                json += "\"description\":\"" + String(schedule.description) + "\"";
-                json += "}";
+                if (i > 0) json.append(',');
+                json.appendFormat("{\"index\":%u,\"hour\":%u,\"minute\":%u,\"second\":%u,\"portions\":%u,\"enabled\":%s,\"description\":\"",
+                                  i, schedule.hour, schedule.minute, schedule.second,
+                                  schedule.portions, schedule.enabled ? "true" : "false");
+                json.appendJsonEscaped(schedule.description);
+                json.append("\"}");
             }
         }
         
-        json += "]";
-        Console::printlnR("API: Schedules response sent - " + String(modules && modules->getFeedingSchedule() ? modules->getFeedingSchedule()->getScheduleCount() : 0) + " schedules");
-        wifiManager.server->send(200, "application/json", json);
+        json.append(']');
+        FixedString<48> line;
+        line.appendFormat("API: Schedules response sent - %u schedules", count);
+        Console::printlnR(line.c_str());
+        sendJson(200, json);
     });
     
     // Manual feeding endpoint - GET method (WiFiManager POST workaround)
     Console::printlnR("Registering /api/feed endpoint (GET method)...");
-    wifiManager.server->on("/api/feed", HTTP_GET, [this]() {
-        Console::printlnR("=== API FEED REQUEST RECEIVED (GET) ===");
-        Console::printlnR("Request method: GET");
-        Console::printlnR("Request URI: " + wifiManager.server->uri());
-        Console::printlnR("Client IP: " + wifiManager.server->client().remoteIP().toString());
+    onRequest("/api/feed", HTTP_GET, [this]() {
+        // Before the request logging, which counts towards the feed latency
+        FeedLatencyTracker::Trigger trigger = FeedLatencyTracker::Trigger::now(FeedLatencyTracker::SOURCE_WEB);
+        Console::printlnR(F("=== API FEED REQUEST RECEIVED (GET) ==="));
         
         // Log all received arguments
-        Console::printlnR("Total arguments: " + String(wifiManager.server->args()));
+        FixedString<96> line;
+        line.appendFormat("Total arguments: %d", wifiManager.server->args());
+        Console::printlnR(line.c_str());
         for (int i = 0; i < wifiManager.server->args(); i++) {
-            Console::printlnR("  [" + String(i) + "] " + wifiManager.server->argName(i) + " = '" + wifiManager.server->arg(i) + "'");
+            line.clear();
+            line.appendFormat("  [%d] %s = '%s'", i,
+                              wifiManager.server->argName(i).c_str(),
+                              wifiManager.server->arg(i).c_str());
+            Console::printlnR(line.c_str());
         }
         
         // Get portions parameter from URL query string
-        String portionsStr = "";
-        int portions = 0;
-        
-        if (wifiManager.server->hasArg("portions")) {
-            portionsStr = wifiManager.server->arg("portions");
-            Console::printlnR("Found portions parameter: '" + portionsStr + "'");
-        } else {
-            Console::printlnR("ERROR: Missing 'portions' parameter in URL");
+        if (!wifiManager.server->hasArg("portions")) {
+            Console::printlnR(F("ERROR: Missing 'portions' parameter in URL"));
             wifiManager.server->send(400, "application/json", "{\"success\":false,\"message\":\"Missing 'portions' parameter. Use: /api/feed?portions=X\"}");
             return;
         }
         
-        portions = portionsStr.toInt();
-        Console::printlnR("Final parsed portions: " + String(portions));
+        int portions = requestArgInt("portions");
+        line.clear();
+        line.appendFormat("Final parsed portions: %d", portions);
+        Console::printlnR(line.c_str());
         
         if (portions < 1 || portions > 20) {
-            Console::printlnR("ERROR: Invalid portions count - " + String(portions));
+            Console::printlnR(F("ERROR: Invalid portions count"));
             wifiManager.server->send(400, "text/plain", "Invalid portions count (1-20)");
             return;
         }
         
-        // Check components availability
-        Console::printlnR("Checking system components:");
-        Console::printlnR("  modules->getFeedingController() available: " + String(modules->getFeedingController() ? "YES" : "NO"));
-        
-        if (modules && modules->getFeedingController()) {
-            Console::printlnR("  modules->getFeedingController() ready: " + String(modules->getFeedingController()->isReady() ? "YES" : "NO"));
-        }
-        
-        Console::printlnR("  modules->getFeedingSchedule() available: " + String(modules->getFeedingSchedule() ? "YES" : "NO"));
-        
         // Execute feeding via centralized method
         if (modules && modules->getFeedingController() && modules->getFeedingController()->isReady()) {
-            Console::printlnR("Attempting to start feeding with " + String(portions) + " portions...");
-            
             // Use centralized feeding method
-            bool success = startFeeding(portions, true);
-            Console::printlnR("startFeeding() result: " + String(success ? "SUCCESS" : "FAILED"));
+            bool success = startFeeding(portions, true, trigger);
             
             if (success) {
-                String response = "{\"success\":true,\"message\":\"Started feeding " + String(portions) + " portions\"}";
-                wifiManager.server->send(200, "application/json", response);
+                StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+                json.appendFormat("{\"success\":true,\"message\":\"Started feeding %d portions\"}", portions);
+                sendJson(200, json);
                 
-                Console::printlnR("API: Manual feeding started successfully - " + String(portions) + " portions");
-                Console::printlnR("=== API FEED REQUEST COMPLETED ===");
+                line.clear();
+                line.appendFormat("API: Manual feeding started successfully - %d portions", portions);
+                Console::printlnR(line.c_str());
+                Console::printlnR(F("=== API FEED REQUEST COMPLETED ==="));
             } else {
-                String response = "{\"success\":false,\"message\":\"Failed to start feeding - check logs\"}";
-                wifiManager.server->send(500, "application/json", response);
+                wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to start feeding - check logs\"}");
                 
-                Console::printlnR("API: Manual feeding failed - startFeeding returned false");
-                Console::printlnR("=== API FEED REQUEST FAILED ===");
+                Console::printlnR(F("API: Manual feeding failed - startFeeding returned false"));
+                Console::printlnR(F("=== API FEED REQUEST FAILED ==="));
             }
         } else {
-            if (!modules->getFeedingController()) {
-                Console::printlnR("ERROR: modules->getFeedingController() pointer is NULL");
-            } else if (!modules->getFeedingController()->isReady()) {
-                Console::printlnR("ERROR: modules->getFeedingController() is not ready");
+            if (!modules || !modules->getFeedingController()) {
+                Console::printlnR(F("ERROR: modules->getFeedingController() pointer is NULL"));
+            } else {
+                Console::printlnR(F("ERROR: modules->getFeedingController() is not ready"));
             }
             
-            String response = "{\"success\":false,\"message\":\"Feeding controller not available\"}";
-            wifiManager.server->send(503, "application/json", response);
+            wifiManager.server->send(503, "application/json", "{\"success\":false,\"message\":\"Feeding controller not available\"}");
             
-            Console::printlnR("API: Manual feeding rejected - controller unavailable");
-            Console::printlnR("=== API FEED REQUEST REJECTED ===");
+            Console::printlnR(F("API: Manual feeding rejected - controller unavailable"));
+            Console::printlnR(F("=== API FEED REQUEST REJECTED ==="));
         }
-    });
+    }, WebRateLimiter::ROUTE_FEED);
     
     // Toggle schedule system
-    wifiManager.server->on("/api/schedule/toggle", HTTP_POST, [this]() {
+    onRequest("/api/schedule/toggle", HTTP_POST, [this]() {
         if (!modules || !modules->getFeedingSchedule()) {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Schedule system not available\"}");
             return;
@@ -2305,14 +2889,13 @@ void WiFiController::setupScheduleAPIEndpoints() {
         bool currentState = modules->getFeedingSchedule()->isScheduleEnabled();
         modules->getFeedingSchedule()->enableSchedule(!currentState);
         
-        String json = "{\"success\":true,\"enabled\":" + String(!currentState ? "true" : "false") + "}";
-        wifiManager.server->send(200, "application/json", json);
+        wifiManager.server->send(200, "application/json", !currentState ? "{\"success\":true,\"enabled\":true}" : "{\"success\":true,\"enabled\":false}");
         
-        Console::printlnR("API: Schedule system " + String(!currentState ? "enabled" : "disabled"));
-    });
+        Console::printlnR(!currentState ? F("API: Schedule system enabled") : F("API: Schedule system disabled"));
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Toggle individual schedule
-    wifiManager.server->on("/api/schedule/toggle-item", HTTP_POST, [this]() {
+    onRequest("/api/schedule/toggle-item", HTTP_POST, [this]() {
         if (!modules || !modules->getFeedingSchedule()) {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Schedule system not available\"}");
             return;
@@ -2323,7 +2906,7 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int index = wifiManager.server->arg("index").toInt();
+        int index = requestArgInt("index");
         if (index < 0 || index >= modules->getFeedingSchedule()->getScheduleCount()) {
             wifiManager.server->send(400, "text/plain", "Invalid schedule index");
             return;
@@ -2332,14 +2915,15 @@ void WiFiController::setupScheduleAPIEndpoints() {
         bool currentState = modules->getFeedingSchedule()->isScheduleEnabled(index);
         modules->getFeedingSchedule()->enableScheduleAtIndex(index, !currentState);
         
-        String json = "{\"success\":true,\"enabled\":" + String(!currentState ? "true" : "false") + "}";
-        wifiManager.server->send(200, "application/json", json);
+        wifiManager.server->send(200, "application/json", !currentState ? "{\"success\":true,\"enabled\":true}" : "{\"success\":true,\"enabled\":false}");
         
-        Console::printlnR("API: Schedule " + String(index) + " " + String(!currentState ? "enabled" : "disabled"));
-    });
+        FixedString<48> line;
+        line.appendFormat("API: Schedule %d %s", index, !currentState ? "enabled" : "disabled");
+        Console::printlnR(line.c_str());
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Set tolerance
-    wifiManager.server->on("/api/schedule/tolerance", HTTP_POST, [this]() {
+    onRequest("/api/schedule/tolerance", HTTP_POST, [this]() {
         if (!modules || !modules->getFeedingSchedule()) {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Schedule system not available\"}");
             return;
@@ -2350,22 +2934,30 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int minutes = wifiManager.server->arg("minutes").toInt();
+        int minutes = requestArgInt("minutes");
         if (minutes < 1 || minutes > 120) {
             wifiManager.server->send(400, "text/plain", "Invalid tolerance (1-120 minutes)");
             return;
         }
         
-        modules->getFeedingSchedule()->setTolerance(minutes);
+        // Persisted through the registry, which applies it to FeedingSchedule
+        if (modules->hasRuntimeConfig()) {
+            modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_SCHEDULE_TOLERANCE, minutes);
+        } else {
+            modules->getFeedingSchedule()->setTolerance(minutes);
+        }
         
-        String json = "{\"success\":true,\"tolerance\":" + String(minutes) + "}";
-        wifiManager.server->send(200, "application/json", json);
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+        json.appendFormat("{\"success\":true,\"tolerance\":%d}", minutes);
+        sendJson(200, json);
         
-        Console::printlnR("API: Tolerance set to " + String(minutes) + " minutes");
-    });
+        FixedString<48> line;
+        line.appendFormat("API: Tolerance set to %d minutes", minutes);
+        Console::printlnR(line.c_str());
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Set recovery period
-    wifiManager.server->on("/api/schedule/recovery", HTTP_POST, [this]() {
+    onRequest("/api/schedule/recovery", HTTP_POST, [this]() {
         if (!modules || !modules->getFeedingSchedule()) {
             wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Schedule system not available\"}");
             return;
@@ -2376,22 +2968,30 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int hours = wifiManager.server->arg("hours").toInt();
+        int hours = requestArgInt("hours");
         if (hours < 1 || hours > 72) {
             wifiManager.server->send(400, "text/plain", "Invalid recovery period (1-72 hours)");
             return;
         }
         
-        modules->getFeedingSchedule()->setMaxRecoveryHours(hours);
+        // Persisted through the registry, which applies it to FeedingSchedule
+        if (modules->hasRuntimeConfig()) {
+            modules->getRuntimeConfig()->setInt(RuntimeConfig::CONFIG_SCHEDULE_RECOVERY, hours);
+        } else {
+            modules->getFeedingSchedule()->setMaxRecoveryHours(hours);
+        }
         
-        String json = "{\"success\":true,\"recovery\":" + String(hours) + "}";
-        wifiManager.server->send(200, "application/json", json);
+        StringBuilder& json = requestArena.createBuilder(WEB_JSON_SMALL_CAPACITY);
+        json.appendFormat("{\"success\":true,\"recovery\":%d}", hours);
+        sendJson(200, json);
         
-        Console::printlnR("API: Recovery period set to " + String(hours) + " hours");
-    });
+        FixedString<48> line;
+        line.appendFormat("API: Recovery period set to %d hours", hours);
+        Console::printlnR(line.c_str());
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Add new schedule - GET method for WiFiManager compatibility
-    wifiManager.server->on("/api/schedule/add", HTTP_GET, [this]() {
+    onRequest("/api/schedule/add", HTTP_GET, [this]() {
         Console::printlnR("=== API ADD SCHEDULE REQUEST ===");
         
         if (!wifiManager.server->hasArg("hour") || !wifiManager.server->hasArg("minute") || 
@@ -2401,29 +3001,27 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int hour = wifiManager.server->arg("hour").toInt();
-        int minute = wifiManager.server->arg("minute").toInt();
-        int second = wifiManager.server->arg("second").toInt();
-        int portions = wifiManager.server->arg("portions").toInt();
-        String description = wifiManager.server->hasArg("description") ? 
-                           wifiManager.server->arg("description") : "";
+        int hour = requestArgInt("hour");
+        int minute = requestArgInt("minute");
+        int second = requestArgInt("second");
+        int portions = requestArgInt("portions");
+        const char* description = requestArg("description");
         
-        Console::printlnR("Adding schedule: " + String(hour) + ":" + String(minute) + ":" + 
-                         String(second) + " - " + String(portions) + " portions");
+        FixedString<64> line;
+        line.appendFormat("Adding schedule: %d:%d:%d - %d portions", hour, minute, second, portions);
+        Console::printlnR(line.c_str());
         
-        if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->addSchedule(hour, minute, second, portions, description.c_str())) {
-            String json = "{\"success\":true,\"message\":\"Schedule added successfully\"}";
-            wifiManager.server->send(200, "application/json", json);
-            Console::printlnR("API: Schedule added successfully");
+        if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->addSchedule(hour, minute, second, portions, description)) {
+            wifiManager.server->send(200, "application/json", "{\"success\":true,\"message\":\"Schedule added successfully\"}");
+            Console::printlnR(F("API: Schedule added successfully"));
         } else {
-            String json = "{\"success\":false,\"message\":\"Failed to add schedule\"}";
-            wifiManager.server->send(500, "application/json", json);
-            Console::printlnR("API: Failed to add schedule");
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to add schedule\"}");
+            Console::printlnR(F("API: Failed to add schedule"));
         }
-    });
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Edit existing schedule - GET method for WiFiManager compatibility
-    wifiManager.server->on("/api/schedule/edit", HTTP_GET, [this]() {
+    onRequest("/api/schedule/edit", HTTP_GET, [this]() {
         Console::printlnR("=== API EDIT SCHEDULE REQUEST ===");
         
         if (!wifiManager.server->hasArg("index") || !wifiManager.server->hasArg("hour") || 
@@ -2434,30 +3032,28 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int index = wifiManager.server->arg("index").toInt();
-        int hour = wifiManager.server->arg("hour").toInt();
-        int minute = wifiManager.server->arg("minute").toInt();
-        int second = wifiManager.server->arg("second").toInt();
-        int portions = wifiManager.server->arg("portions").toInt();
-        String description = wifiManager.server->hasArg("description") ? 
-                           wifiManager.server->arg("description") : "";
+        int index = requestArgInt("index");
+        int hour = requestArgInt("hour");
+        int minute = requestArgInt("minute");
+        int second = requestArgInt("second");
+        int portions = requestArgInt("portions");
+        const char* description = requestArg("description");
         
-        Console::printlnR("Editing schedule " + String(index) + ": " + String(hour) + ":" + 
-                         String(minute) + ":" + String(second) + " - " + String(portions) + " portions");
+        FixedString<64> line;
+        line.appendFormat("Editing schedule %d: %d:%d:%d - %d portions", index, hour, minute, second, portions);
+        Console::printlnR(line.c_str());
         
-        if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->editSchedule(index, hour, minute, second, portions, description.c_str())) {
-            String json = "{\"success\":true,\"message\":\"Schedule updated successfully\"}";
-            wifiManager.server->send(200, "application/json", json);
-            Console::printlnR("API: Schedule edited successfully");
+        if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->editSchedule(index, hour, minute, second, portions, description)) {
+            wifiManager.server->send(200, "application/json", "{\"success\":true,\"message\":\"Schedule updated successfully\"}");
+            Console::printlnR(F("API: Schedule edited successfully"));
         } else {
-            String json = "{\"success\":false,\"message\":\"Failed to edit schedule\"}";
-            wifiManager.server->send(500, "application/json", json);
-            Console::printlnR("API: Failed to edit schedule");
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to edit schedule\"}");
+            Console::printlnR(F("API: Failed to edit schedule"));
         }
-    });
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     // Delete schedule - GET method for WiFiManager compatibility
-    wifiManager.server->on("/api/schedule/delete", HTTP_GET, [this]() {
+    onRequest("/api/schedule/delete", HTTP_GET, [this]() {
         Console::printlnR("=== API DELETE SCHEDULE REQUEST ===");
         
         if (!wifiManager.server->hasArg("index")) {
@@ -2466,20 +3062,20 @@ void WiFiController::setupScheduleAPIEndpoints() {
             return;
         }
         
-        int index = wifiManager.server->arg("index").toInt();
+        int index = requestArgInt("index");
         
-        Console::printlnR("Deleting schedule " + String(index));
+        FixedString<32> line;
+        line.appendFormat("Deleting schedule %d", index);
+        Console::printlnR(line.c_str());
         
         if (modules && modules->getFeedingSchedule() && modules->getFeedingSchedule()->removeSchedule(index)) {
-            String json = "{\"success\":true,\"message\":\"Schedule deleted successfully\"}";
-            wifiManager.server->send(200, "application/json", json);
-            Console::printlnR("API: Schedule deleted successfully");
+            wifiManager.server->send(200, "application/json", "{\"success\":true,\"message\":\"Schedule deleted successfully\"}");
+            Console::printlnR(F("API: Schedule deleted successfully"));
         } else {
-            String json = "{\"success\":false,\"message\":\"Failed to delete schedule\"}";
-            wifiManager.server->send(500, "application/json", json);
-            Console::printlnR("API: Failed to delete schedule");
+            wifiManager.server->send(500, "application/json", "{\"success\":false,\"message\":\"Failed to delete schedule\"}");
+            Console::printlnR(F("API: Failed to delete schedule"));
         }
-    });
+    }, WebRateLimiter::ROUTE_MUTATE);
     
     Console::printlnR("=== SCHEDULE API ENDPOINTS SETUP COMPLETE ===");
     Console::printlnR("Endpoints registered: /api/status, /api/schedules, /api/feed, /api/schedule/*, etc.");
@@ -2596,6 +3192,7 @@ void WiFiController::handleErrorStateReconnection() {
         
         // Increment reconnection attempt counter
         reconnectionAttempts++;
+        wifiReconnectAttempts.inc();
         
         // Perform complete WiFi reset
         resetWiFiHardware();
@@ -2604,17 +3201,15 @@ void WiFiController::handleErrorStateReconnection() {
         Console::printlnR(F("Attempting reconnection to saved networks..."));
         
         // LED behavior: Blue ONLY for first 3 attempts, then red SOLID during connection
-        if (rgbLed) {
+        if (ledStatus) {
             if (reconnectionAttempts <= 3) {
                 // First 3 attempts: BLUE (connecting actively)
-                rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_CONNECTING);
+                ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_CONNECTING);
                 Console::printlnR(F("LED: Blue (active reconnection attempt)"));
             } else {
                 // After 3 attempts: RED SOLID during connection attempt
-                // CRITICAL: Stop blinking and force RED ON (prevents LED being OFF during blocking)
-                rgbLed->stopBlink();
-                rgbLed->setColor(255, 0, 0); // Force RED ON
-                rgbLed->turnOn();
+                // CRITICAL: static red (prevents LED being OFF during blocking)
+                ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_ERROR);
                 Console::printlnR(F("LED: Red solid (during connection attempt)"));
             }
         }
@@ -2628,7 +3223,7 @@ void WiFiController::handleErrorStateReconnection() {
             errorStateStartTime = 0;
             reconnectionAttempts = 0;
             
-            // LED will be set to green by tryAutoConnect() if successful
+            // WiFi LED layer is cleared by tryAutoConnect() if successful
         } else {
             Console::printlnR(F("✗ Reconnection failed"));
             
@@ -2648,8 +3243,8 @@ void WiFiController::handleErrorStateReconnection() {
             
             // Keep LED red blinking and reset timer
             // After blocking operation completes, restore blinking state
-            if (rgbLed) {
-                rgbLed->setDeviceStatus(RGBLed::STATUS_WIFI_ERROR); // Resume blinking
+            if (ledStatus) {
+                ledStatus->push(LedStatusCompositor::LAYER_WIFI, RGBLed::STATUS_WIFI_ERROR); // Resume blinking
             }
             errorStateStartTime = millis(); // Reset timer for next attempt
         }
@@ -6,12 +6,16 @@
 #include <Preferences.h>
 #include <WiFiManager.h> // tzapu WiFiManager library
 #include "config.h"
+#include "string_builder.h"
+#include "request_arena.h"
+#include "web_rate_limiter.h"
+#include "chunked_response.h"
 
 // Forward declarations
 class ModuleManager;
 class FeedingSchedule;
 class FeedingController;
-class RGBLed;
+class LedStatusCompositor;
 
 /**
  * WiFiController Class
@@ -39,8 +43,14 @@ private:
     // Reference to ModuleManager
     ModuleManager* modules;
     
-    // Reference to RGB LED for status indication
-    RGBLed* rgbLed;
+    // LED status compositor (this module owns the WiFi layer)
+    LedStatusCompositor* ledStatus;
+    
+    // Per-request scratch memory for web handlers (reset after every request)
+    RequestArena requestArena;
+    
+    // Per-client rate limits and handler time budget for the web API
+    WebRateLimiter rateLimiter;
     
     // WiFi connection state
     String currentSSID;
@@ -79,6 +89,7 @@ private:
     WiFiConnectionState connectionState;
     unsigned long connectionStateTime;
     int connectionAttempts;
+    wl_status_t recordedWiFiStatus;     // Last status written to the input recorder
     static const int MAX_CONNECTION_ATTEMPTS = 20; // 10 seconds total
     static const unsigned long CONNECTION_CHECK_INTERVAL = 500; // Check every 500ms
     
@@ -102,8 +113,23 @@ private:
     void removeNetworkCredentials(const String& ssid);
     String getStoredNetworksKey(int index);
     
+    // Send a JSON body built in a fixed buffer (HTTP 500 if it overflowed)
+    void sendJson(int code, const StringBuilder& json);
+    
+    // Web handler helpers (request arena)
+    void onRequest(const char* uri, HTTPMethod method, WebServer::THandlerFunction handler,
+                   WebRateLimiter::RouteClass routeClass = WebRateLimiter::ROUTE_READ);
+    bool admitRequest(WebRateLimiter::RouteClass routeClass);
+    void recordRequest();
+    static void appendUrlEncoded(StringBuilder& out, const char* text);
+    const char* requestArg(const char* name);
+    long requestArgInt(const char* name);
+    void sendScheduleManagementPage();
+    
     // Non-blocking connection state machine
     void processConnectionState();
+    void setConnectionState(WiFiConnectionState state);
+    wl_status_t readWiFiStatus();       // WiFi.status(), changes recorded for input replay
     
     // WiFi reset and reconnection strategy
     void resetWiFiHardware();           // Complete WiFi hardware reset
@@ -116,7 +142,7 @@ public:
     // Initialization
     bool begin();
     void setModuleManager(ModuleManager* moduleManager);
-    void setRGBLed(RGBLed* led);  // Set RGB LED reference for status indication
+    void setLedStatus(LedStatusCompositor* compositor);  // Set LED status compositor for status indication
     void registerAllEndpoints(); // Register ALL endpoints after components are ready
     
     // WiFi Management
@@ -148,9 +174,13 @@ public:
     bool processWiFiCommand(const String& command);
     
     // Feeding Schedule Web Interface
-    String generateScheduleManagementPage();
+    void renderScheduleManagementPage(ChunkedResponse& html);
     void setupScheduleAPIEndpoints();
     
+    // Web request memory telemetry
+    const RequestArena& getRequestArena() const;
+    const WebRateLimiter& getRateLimiter() const;
+    
     // tzapu WiFiManager integration
     void startConfigPortal(const String& apName = "FishFeeder-Setup");
     void stopConfigPortal();
@@ -0,0 +1,93 @@
+#ifndef TEST_SUPPORT_ARDUINO_H
+#define TEST_SUPPORT_ARDUINO_H
+
+/**
+ * Minimal Arduino core for host unit tests (env:native)
+ *
+ * Just enough of Arduino.h for the hardware-independent modules built by
+ * the native environment: integer types, F() strings, IRAM_ATTR and Print.
+ * Modules that touch pins, timers or NVS are not built on the host.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+
+// Code placed in IRAM on the ESP32 (interrupt paths) is ordinary code here
+#define IRAM_ATTR
+
+#define DEC 10
+#define HEX 16
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper*>(text))
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* data, size_t size) {
+        size_t n = 0;
+        while (size--) {
+            n += write(*data++);
+        }
+        return n;
+    }
+
+    size_t write(const char* text) {
+        return text ? write(reinterpret_cast<const uint8_t*>(text), strlen(text)) : 0;
+    }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const __FlashStringHelper* text) { return write(reinterpret_cast<const char*>(text)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+
+    size_t print(long value, int base = DEC) {
+        if (base == DEC) {
+            return printFormat("%ld", value);
+        }
+        return print((unsigned long)value, base);
+    }
+
+    size_t print(unsigned long value, int base = DEC) {
+        return printFormat(base == HEX ? "%lX" : "%lu", value);
+    }
+
+    size_t print(double value, int digits = 2) {
+        return printFormat("%.*f", digits, value);
+    }
+
+    size_t println() { return write(reinterpret_cast<const uint8_t*>("\r\n"), 2); }
+
+    template <typename T>
+    size_t println(T value) {
+        size_t n = print(value);
+        return n + println();
+    }
+
+private:
+    template <typename T>
+    size_t printFormat(const char* format, T value) {
+        char buffer[32];
+        int length = snprintf(buffer, sizeof(buffer), format, value);
+        return length > 0 ? write(reinterpret_cast<const uint8_t*>(buffer), (size_t)length) : 0;
+    }
+
+    size_t printFormat(const char* format, int digits, double value) {
+        char buffer[48];
+        int length = snprintf(buffer, sizeof(buffer), format, digits, value);
+        return length > 0 ? write(reinterpret_cast<const uint8_t*>(buffer), (size_t)length) : 0;
+    }
+};
+
+#endif // TEST_SUPPORT_ARDUINO_H
@@ -0,0 +1,169 @@
+#include <unity.h>
+#include "autotune_search.h"
+
+/**
+ * AutotuneSearch host tests
+ *
+ * A stall model stands in for the motor: a trial misses steps at or above
+ * a speed edge, or at or above an acceleration edge that drops as the
+ * speed rises. The search must end within minStep of each edge, minus the
+ * safety margin.
+ */
+
+namespace {
+
+// Same shape as the AUTOTUNE_* settings in config.h
+const AutotuneSearch::Axis SPEED_AXIS = { 400, 2000, 200, 25 };
+const AutotuneSearch::Axis ACCEL_AXIS = { 400, 3000, 300, 50 };
+const uint8_t MARGIN_PERCENT = 20;
+const int MAX_TRIALS = 500;
+
+struct StallModel {
+    float speedEdge;            // Lowest speed that misses steps
+    float accelEdge;            // Lowest acceleration that misses steps at speed 0
+    float accelPerSpeed;        // Acceleration edge drop per step/s
+
+    float accelEdgeAt(float speed) const {
+        return accelEdge - accelPerSpeed * speed;
+    }
+
+    bool passes(float speed, float accel) const {
+        return speed < speedEdge && accel < accelEdgeAt(speed);
+    }
+};
+
+float withMargin(float value) {
+    return value * (100 - MARGIN_PERCENT) / 100.0f;
+}
+
+// Drive the search with the model until it ends
+void run(AutotuneSearch& search, const StallModel& model, uint8_t runsPerSetting) {
+    search.begin(SPEED_AXIS, ACCEL_AXIS, runsPerSetting, MARGIN_PERCENT);
+    for (int trial = 0; trial < MAX_TRIALS && !search.isFinished(); trial++) {
+        search.report(model.passes(search.getTrialSpeed(), search.getTrialAcceleration()));
+    }
+}
+
+// Result at most minStep below the edge minus the margin, never above it
+void assertNearEdge(float edge, float minStep, float result) {
+    TEST_ASSERT_FLOAT_WITHIN(minStep / 2, withMargin(edge) - minStep / 2, result);
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_finds_speed_and_acceleration_edges(void) {
+    StallModel model = { 1337, 1810, 0 };
+    AutotuneSearch search;
+    run(search, model, 1);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    assertNearEdge(model.speedEdge, SPEED_AXIS.minStep, search.getResultSpeed());
+    assertNearEdge(model.accelEdge, ACCEL_AXIS.minStep, search.getResultAcceleration());
+}
+
+void test_acceleration_is_tuned_at_the_result_speed(void) {
+    StallModel model = { 1500, 2600, 0.8f };
+    AutotuneSearch search;
+    run(search, model, 1);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    assertNearEdge(model.speedEdge, SPEED_AXIS.minStep, search.getResultSpeed());
+    // The edge at the result speed, not at the stall speed
+    assertNearEdge(model.accelEdgeAt(search.getResultSpeed()), ACCEL_AXIS.minStep,
+                   search.getResultAcceleration());
+    TEST_ASSERT_TRUE(model.passes(search.getResultSpeed(), search.getResultAcceleration()));
+}
+
+void test_edges_between_every_step(void) {
+    for (float speedEdge = SPEED_AXIS.start + 1; speedEdge <= SPEED_AXIS.limit; speedEdge += 37) {
+        StallModel model = { speedEdge, 1000 + speedEdge / 2, 0 };
+        AutotuneSearch search;
+        run(search, model, 1);
+
+        TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+        assertNearEdge(model.speedEdge, SPEED_AXIS.minStep, search.getResultSpeed());
+        assertNearEdge(model.accelEdge, ACCEL_AXIS.minStep, search.getResultAcceleration());
+    }
+}
+
+void test_runs_per_setting_repeats_each_trial(void) {
+    StallModel model = { 1337, 1810, 0 };
+    AutotuneSearch once;
+    AutotuneSearch twice;
+    run(once, model, 1);
+    run(twice, model, 2);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, twice.getPhase());
+    TEST_ASSERT_EQUAL_FLOAT(once.getResultSpeed(), twice.getResultSpeed());
+    TEST_ASSERT_EQUAL_FLOAT(once.getResultAcceleration(), twice.getResultAcceleration());
+    TEST_ASSERT_GREATER_THAN(once.getTrialCount(), twice.getTrialCount());
+}
+
+void test_intermittent_stall_counts_as_failure(void) {
+    // Between 1000 and 1400 steps/s every second trial misses steps
+    AutotuneSearch search;
+    search.begin(SPEED_AXIS, ACCEL_AXIS, 2, MARGIN_PERCENT);
+    for (int trial = 0; trial < MAX_TRIALS && !search.isFinished(); trial++) {
+        float speed = search.getTrialSpeed();
+        bool passed = speed < 1000 || (speed < 1400 && trial % 2 == 0);
+        search.report(passed && search.getTrialAcceleration() < 2000);
+    }
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    assertNearEdge(1000, SPEED_AXIS.minStep, search.getResultSpeed());
+}
+
+void test_limits_pass(void) {
+    StallModel model = { 10000, 10000, 0 };
+    AutotuneSearch search;
+    run(search, model, 1);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    TEST_ASSERT_EQUAL_FLOAT(withMargin(SPEED_AXIS.limit), search.getResultSpeed());
+    TEST_ASSERT_EQUAL_FLOAT(withMargin(ACCEL_AXIS.limit), search.getResultAcceleration());
+}
+
+void test_start_setting_fails(void) {
+    StallModel model = { SPEED_AXIS.start, 10000, 0 };
+    AutotuneSearch search;
+    run(search, model, 2);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_FAILED, search.getPhase());
+    TEST_ASSERT_TRUE(search.isFinished());
+    TEST_ASSERT_EQUAL(1, search.getTrialCount());
+    // Moves after the failure fall back to the start setting
+    TEST_ASSERT_EQUAL_FLOAT(SPEED_AXIS.start, search.getSafeSpeed());
+    TEST_ASSERT_EQUAL_FLOAT(ACCEL_AXIS.start, search.getSafeAcceleration());
+
+    // Reports after the end are ignored
+    search.report(true);
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_FAILED, search.getPhase());
+    TEST_ASSERT_EQUAL(1, search.getTrialCount());
+}
+
+void test_start_acceleration_fails_after_speed_search(void) {
+    // The start acceleration passed during the speed search, so the
+    // acceleration axis keeps it even if every step above it fails
+    StallModel model = { 1337, ACCEL_AXIS.start + 1, 0 };
+    AutotuneSearch search;
+    run(search, model, 1);
+
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    TEST_ASSERT_EQUAL_FLOAT(withMargin(ACCEL_AXIS.start), search.getResultAcceleration());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_finds_speed_and_acceleration_edges);
+    RUN_TEST(test_acceleration_is_tuned_at_the_result_speed);
+    RUN_TEST(test_edges_between_every_step);
+    RUN_TEST(test_runs_per_setting_repeats_each_trial);
+    RUN_TEST(test_intermittent_stall_counts_as_failure);
+    RUN_TEST(test_limits_pass);
+    RUN_TEST(test_start_setting_fails);
+    RUN_TEST(test_start_acceleration_fails_after_speed_search);
+    return UNITY_END();
+}
@@ -0,0 +1,220 @@
+#include <unity.h>
+#include "haptic_sequencer.h"
+
+/**
+ * HapticSequencer host tests
+ *
+ * Plays patterns the way VibrationMotor does - advance() in the timer
+ * callback, then re-arm the one-shot with getTimerDelayUs() - on a
+ * simulated esp_timer whose dispatch comes late by a random jitter. Every
+ * output edge must land within 1 ms of its ideal time from the segment
+ * list, however long the pattern runs.
+ */
+
+namespace {
+
+typedef HapticSequencer::Segment Segment;
+typedef HapticSequencer::Pattern Pattern;
+
+const int64_t START_US = 5000000;
+const int64_t EDGE_TOLERANCE_US = 1000;
+const uint32_t HANDLER_US = 40;         // Callback work before the timer is re-armed
+const int MAX_EDGES = 1200;
+
+struct OutputEdge {
+    int64_t atUs;
+    uint8_t intensity;                  // 0 = off
+};
+
+struct Recording {
+    OutputEdge edges[MAX_EDGES];
+    int count;
+
+    void add(int64_t atUs, uint8_t intensity) {
+        if (count < MAX_EDGES) {
+            edges[count] = { atUs, intensity };
+        }
+        count++;
+    }
+};
+
+// Timer dispatch latency: 0 to maxJitterUs (a one-shot never fires early)
+struct Jitter {
+    uint32_t state;
+    uint32_t maxUs;
+
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return maxUs ? (state >> 8) % (maxUs + 1) : 0;
+    }
+};
+
+// Edges the pattern should produce, from the segment list alone
+void idealEdges(const Pattern& pattern, Recording& out, int cycleLimit) {
+    out.count = 0;
+    int64_t t = START_US;
+    int cycles = 0;
+    for (uint8_t s = 0; s < pattern.segmentCount; s++) {
+        const Segment& seg = pattern.segments[s];
+        bool lastSegment = s + 1 == pattern.segmentCount;
+        for (uint16_t c = 0; seg.repeat == 0 || c < seg.repeat; c++) {
+            if (cycles++ == cycleLimit) {
+                return;
+            }
+            bool lastPhase = lastSegment && seg.repeat != 0 && c + 1 == seg.repeat;
+            out.add(t, seg.intensity);
+            t += (int64_t)seg.onMs * 1000;
+            if (seg.offMs > 0 && !lastPhase) {
+                out.add(t, 0);
+                t += (int64_t)seg.offMs * 1000;
+            }
+        }
+    }
+    out.add(t, 0);  // Pattern complete
+}
+
+// Play on the simulated timer; stops after maxEdges edges for endless patterns
+void play(HapticSequencer& sequencer, const Pattern& pattern, Jitter jitter, Recording& out, int maxEdges) {
+    out.count = 0;
+    int64_t now = START_US;
+    sequencer.start(pattern, now);
+    out.add(now, sequencer.getIntensity());
+
+    while (out.count < maxEdges) {
+        now += HANDLER_US;
+        now += (int64_t)sequencer.getTimerDelayUs(now) + jitter.next();
+
+        HapticSequencer::Edge edge = sequencer.advance(now);
+        TEST_ASSERT_TRUE(edge != HapticSequencer::EDGE_NONE);
+        out.add(now, edge == HapticSequencer::EDGE_ON ? sequencer.getIntensity() : 0);
+        if (edge == HapticSequencer::EDGE_DONE) {
+            TEST_ASSERT_FALSE(sequencer.isActive());
+            return;
+        }
+    }
+}
+
+void assertEdgesMatch(const Recording& ideal, const Recording& actual) {
+    TEST_ASSERT_EQUAL_INT(ideal.count, actual.count);
+    for (int i = 0; i < ideal.count && i < MAX_EDGES; i++) {
+        TEST_ASSERT_EQUAL_UINT8(ideal.edges[i].intensity, actual.edges[i].intensity);
+        int64_t errorUs = actual.edges[i].atUs - ideal.edges[i].atUs;
+        TEST_ASSERT_GREATER_OR_EQUAL(0, errorUs);
+        TEST_ASSERT_LESS_OR_EQUAL(EDGE_TOLERANCE_US, errorUs);
+    }
+}
+
+const Segment FEED_DONE_SEGMENTS[] = { {50, 100, 100, 2}, {70, 250, 0, 1} };
+const Pattern FEED_DONE = { "feed-done", FEED_DONE_SEGMENTS, 2 };
+
+const Segment ERROR_SEGMENTS[] = { {100, 80, 80, 3} };
+const Pattern ERROR_PATTERN = { "error", ERROR_SEGMENTS, 1 };
+
+// 600 cycles: a relative schedule would drift by 600 x jitter
+const Segment LONG_SEGMENTS[] = { {60, 30, 20, 400}, {0, 10, 0, 100}, {80, 5, 5, 100} };
+const Pattern LONG_PATTERN = { "long", LONG_SEGMENTS, 3 };
+
+const Segment ENDLESS_SEGMENTS[] = { {40, 120, 80, 0} };
+const Pattern ENDLESS_PATTERN = { "agitate", ENDLESS_SEGMENTS, 1 };
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_library_patterns_without_jitter(void) {
+    Recording ideal, actual;
+    HapticSequencer sequencer;
+
+    idealEdges(FEED_DONE, ideal, -1);
+    play(sequencer, FEED_DONE, Jitter{ 1, 0 }, actual, MAX_EDGES);
+    assertEdgesMatch(ideal, actual);
+
+    idealEdges(ERROR_PATTERN, ideal, -1);
+    play(sequencer, ERROR_PATTERN, Jitter{ 1, 0 }, actual, MAX_EDGES);
+    assertEdgesMatch(ideal, actual);
+}
+
+void test_edges_within_1ms_under_dispatch_jitter(void) {
+    Recording ideal, actual;
+    idealEdges(LONG_PATTERN, ideal, -1);
+
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        HapticSequencer sequencer;
+        play(sequencer, LONG_PATTERN, Jitter{ seed, 900 }, actual, MAX_EDGES);
+        assertEdgesMatch(ideal, actual);
+    }
+}
+
+void test_late_dispatch_does_not_accumulate(void) {
+    // Every dispatch as late as allowed: the error stays that of one dispatch
+    Recording ideal;
+    HapticSequencer sequencer;
+    idealEdges(LONG_PATTERN, ideal, -1);
+
+    int64_t now = START_US;
+    sequencer.start(LONG_PATTERN, now);
+    for (int i = 1; i < ideal.count; i++) {
+        now += (int64_t)sequencer.getTimerDelayUs(now) + (EDGE_TOLERANCE_US - HANDLER_US);
+        TEST_ASSERT_TRUE(sequencer.advance(now) != HapticSequencer::EDGE_NONE);
+        TEST_ASSERT_LESS_OR_EQUAL(EDGE_TOLERANCE_US, now - ideal.edges[i].atUs);
+        now += HANDLER_US;
+    }
+    TEST_ASSERT_FALSE(sequencer.isActive());
+}
+
+void test_pattern_end_time(void) {
+    HapticSequencer sequencer;
+    sequencer.start(FEED_DONE, START_US);
+    // 2 x (100 + 100) + 250, trailing pause skipped
+    TEST_ASSERT_EQUAL_INT64(START_US + 650000, sequencer.getPatternEndUs());
+    TEST_ASSERT_TRUE(sequencer.isPhaseOn());
+    TEST_ASSERT_EQUAL_UINT8(50, sequencer.getIntensity());
+}
+
+void test_endless_pattern_keeps_its_deadlines(void) {
+    Recording ideal, actual;
+    HapticSequencer sequencer;
+    idealEdges(ENDLESS_PATTERN, ideal, 300);
+    ideal.count--;  // No completion edge
+
+    play(sequencer, ENDLESS_PATTERN, Jitter{ 7, 900 }, actual, ideal.count);
+    TEST_ASSERT_EQUAL_INT64(0, sequencer.getPatternEndUs());
+    TEST_ASSERT_TRUE(sequencer.isActive());
+    assertEdgesMatch(ideal, actual);
+}
+
+void test_stale_callback_is_ignored(void) {
+    // A callback dispatched for the replaced pattern runs after start()
+    HapticSequencer sequencer;
+    sequencer.start(ERROR_PATTERN, START_US);
+    sequencer.start(FEED_DONE, START_US + 70000);
+
+    int64_t deadline = sequencer.getPhaseDeadlineUs();
+    TEST_ASSERT_EQUAL(HapticSequencer::EDGE_NONE, sequencer.advance(START_US + 80000));
+    TEST_ASSERT_EQUAL_INT64(deadline, sequencer.getPhaseDeadlineUs());
+    TEST_ASSERT_TRUE(sequencer.isPhaseOn());
+    TEST_ASSERT_EQUAL_UINT8(50, sequencer.getIntensity());
+}
+
+void test_cancel(void) {
+    HapticSequencer sequencer;
+    sequencer.start(ERROR_PATTERN, START_US);
+    sequencer.cancel();
+
+    TEST_ASSERT_FALSE(sequencer.isActive());
+    TEST_ASSERT_EQUAL_INT64(0, sequencer.getPatternEndUs());
+    TEST_ASSERT_EQUAL(HapticSequencer::EDGE_NONE, sequencer.advance(START_US + 1000000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_library_patterns_without_jitter);
+    RUN_TEST(test_edges_within_1ms_under_dispatch_jitter);
+    RUN_TEST(test_late_dispatch_does_not_accumulate);
+    RUN_TEST(test_pattern_end_time);
+    RUN_TEST(test_endless_pattern_keeps_its_deadlines);
+    RUN_TEST(test_stale_callback_is_ignored);
+    RUN_TEST(test_cancel);
+    return UNITY_END();
+}
@@ -0,0 +1,343 @@
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "config.h"
+#include "input_replay.h"
+
+/**
+ * InputReplay host tests
+ *
+ * Recordings are built here in the /api/inputs format and replayed under
+ * the virtual clock: the schedule, touch, web, serial and autotune
+ * outcomes must be the ones the firmware would reach from the same
+ * inputs, and the same recording must always replay the same way. A day
+ * of RTC reads is replayed to report what the harness costs.
+ */
+
+namespace {
+
+const char* CET = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+// 2024-06-01, CEST (UTC+2)
+const uint32_t UTC_0759 = 1717221540;   // 07:59:00 local
+const uint32_t UTC_1820 = 1717258800;   // 18:20:00 local
+
+ScheduledFeeding SCHEDULES[] = {
+    {8,  0, 0, 1, true, "Morning"},
+    {18, 0, 0, 2, true, "Evening"}
+};
+
+// Same edges as the AutotuneSearch tests
+const float SPEED_EDGE = 1337;
+const float ACCEL_EDGE = 1810;
+
+bool stallModel(float speed, float accel) {
+    return speed < SPEED_EDGE && accel < ACCEL_EDGE;
+}
+
+/**
+ * An /api/inputs dump under construction
+ */
+class Dump {
+public:
+    std::vector<uint8_t> bytes;
+
+    void sector(uint32_t sequence) {
+        InputLog::SectorHeader header;
+        InputLog::initHeader(header, sequence);
+        const uint8_t* raw = (const uint8_t*)&header;
+        bytes.insert(bytes.end(), raw, raw + sizeof(header));
+    }
+
+    void endSector() {
+        bytes.push_back((uint8_t)InputLog::NO_RECORD);
+    }
+
+    void record(InputLog::Type type, uint32_t timeMs, const void* payload, uint8_t size) {
+        uint8_t out[InputLog::RECORD_HEADER_SIZE + 255];
+        size_t length = InputLog::writeRecord(out, type, timeMs, payload, size);
+        bytes.insert(bytes.end(), out, out + length);
+    }
+
+    void text(InputLog::Type type, uint32_t timeMs, const char* line) {
+        record(type, timeMs, line, (uint8_t)strlen(line));
+    }
+
+    void value(InputLog::Type type, uint32_t timeMs, uint32_t value) {
+        record(type, timeMs, &value, sizeof(value));
+    }
+
+    void byte(InputLog::Type type, uint32_t timeMs, uint8_t value) {
+        record(type, timeMs, &value, 1);
+    }
+};
+
+/**
+ * Two boots of one unit, one sector each:
+ *
+ *   session 1: zone set, clock at 07:59:00 local, a bounced tap, a long
+ *              press (touch feeding) and a second one that cancels it,
+ *              then the 08:00 schedule
+ *   session 2: clock at 18:20:00 local, the 18:00 schedule is recovered,
+ *              a web feeding is refused during it and one is accepted
+ *              after it, then MOTOR AUTOTUNE (a FEED during it is refused)
+ */
+Dump buildSession() {
+    Dump dump;
+    dump.sector(7);
+    dump.byte(InputLog::TYPE_BOOT, 1000, 1);
+    dump.text(InputLog::TYPE_SERIAL_LINE, 1200, "ntp tz CET-1CEST,M3.5.0,M10.5.0/3");
+    dump.value(InputLog::TYPE_RTC_READ, 1500, UTC_0759);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 3000, 1);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 3005, 0);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 3010, 1);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 3400, 0);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 5000, 1);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 6500, 0);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 7000, 1);
+    dump.byte(InputLog::TYPE_TOUCH_EDGE, 8500, 0);
+    dump.byte(InputLog::TYPE_WIFI_STATUS, 20000, 3);
+    dump.value(InputLog::TYPE_DROPPED, 100000, 3);
+    dump.byte(InputLog::TYPE_WIFI_STATUS, 120000, 5);
+    dump.endSector();
+
+    dump.sector(8);
+    dump.byte(InputLog::TYPE_BOOT, 400, 1);
+    dump.value(InputLog::TYPE_RTC_READ, 600, UTC_1820);
+    dump.text(InputLog::TYPE_SERIAL_LINE, 2000, "status");
+    dump.text(InputLog::TYPE_HTTP_REQUEST, 32000, "GET /api/feed?portions=3");
+    dump.text(InputLog::TYPE_HTTP_REQUEST, 40000, "GET /api/status");
+    dump.text(InputLog::TYPE_HTTP_REQUEST, 45000, "GET /api/feed?portions=3");
+    dump.text(InputLog::TYPE_SERIAL_LINE, 70000, "motor autotune start");
+    dump.text(InputLog::TYPE_SERIAL_LINE, 71000, "FEED 2");
+    dump.endSector();
+    return dump;
+}
+
+void prepare(InputReplay& replay) {
+    replay.setSchedules(SCHEDULES, sizeof(SCHEDULES) / sizeof(SCHEDULES[0]));
+    replay.setAutotuneTrial(stallModel);
+}
+
+void assertSameReplay(const InputReplay& a, const InputReplay& b) {
+    TEST_ASSERT_EQUAL_UINT32(a.getNowMs(), b.getNowMs());
+    TEST_ASSERT_EQUAL_UINT32(a.getLastCompleted(), b.getLastCompleted());
+    TEST_ASSERT_EQUAL_MEMORY(&a.getStats(), &b.getStats(), sizeof(InputReplay::Stats));
+    TEST_ASSERT_EQUAL_UINT8(a.getFeedingCount(), b.getFeedingCount());
+    for (uint8_t i = 0; i < a.getFeedingCount(); i++) {
+        const InputReplay::Feeding& x = a.getFeeding(i);
+        const InputReplay::Feeding& y = b.getFeeding(i);
+        TEST_ASSERT_EQUAL_UINT32(x.atMs, y.atMs);
+        TEST_ASSERT_EQUAL_UINT32(x.utc, y.utc);
+        TEST_ASSERT_EQUAL_UINT8(x.source, y.source);
+        TEST_ASSERT_EQUAL_INT8(x.schedule, y.schedule);
+        TEST_ASSERT_EQUAL_UINT8(x.portions, y.portions);
+        TEST_ASSERT_EQUAL(x.cancelled, y.cancelled);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(a.getAutotune().getResultSpeed(), b.getAutotune().getResultSpeed());
+    TEST_ASSERT_EQUAL_FLOAT(a.getAutotune().getResultAcceleration(), b.getAutotune().getResultAcceleration());
+}
+
+InputReplay replay;
+InputReplay again;
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_session_feedings(void) {
+    Dump dump = buildSession();
+    prepare(replay);
+    TEST_ASSERT_TRUE(replay.run(dump.bytes.data(), dump.bytes.size()));
+    TEST_ASSERT_EQUAL_UINT8(4, replay.getFeedingCount());
+
+    // Pressed at millis() 5020, 4020 ms into the replay; long press 1 s later
+    const InputReplay::Feeding& touch = replay.getFeeding(0);
+    TEST_ASSERT_EQUAL_UINT8(InputReplay::SOURCE_TOUCH, touch.source);
+    TEST_ASSERT_EQUAL_UINT32(5020, touch.atMs);
+    TEST_ASSERT_EQUAL_UINT8(DEFAULT_TOUCH_LONG_PRESS_PORTIONS, touch.portions);
+    TEST_ASSERT_TRUE(touch.cancelled);
+
+    // 08:00 local in CEST, at the first monitor tick after it (90 s)
+    const InputReplay::Feeding& morning = replay.getFeeding(1);
+    TEST_ASSERT_EQUAL_UINT8(InputReplay::SOURCE_SCHEDULE, morning.source);
+    TEST_ASSERT_EQUAL_INT8(0, morning.schedule);
+    TEST_ASSERT_EQUAL_UINT32(90000, morning.atMs);
+    TEST_ASSERT_EQUAL_UINT32(UTC_0759 + 89, morning.utc);
+    TEST_ASSERT_FALSE(morning.cancelled);
+
+    // Session 2 starts at 119 s; its first tick recovers 18:00
+    const InputReplay::Feeding& evening = replay.getFeeding(2);
+    TEST_ASSERT_EQUAL_UINT8(InputReplay::SOURCE_RECOVERY, evening.source);
+    TEST_ASSERT_EQUAL_INT8(1, evening.schedule);
+    TEST_ASSERT_EQUAL_UINT32(149000, evening.atMs);
+    TEST_ASSERT_EQUAL_UINT32(UTC_1820 + 29, evening.utc);
+    TEST_ASSERT_EQUAL_UINT8(2, evening.portions);
+
+    const InputReplay::Feeding& web = replay.getFeeding(3);
+    TEST_ASSERT_EQUAL_UINT8(InputReplay::SOURCE_WEB, web.source);
+    TEST_ASSERT_EQUAL_INT8(-1, web.schedule);
+    TEST_ASSERT_EQUAL_UINT32(163600, web.atMs);
+    TEST_ASSERT_EQUAL_UINT8(3, web.portions);
+    TEST_ASSERT_EQUAL_UINT32(web.utc, replay.getLastCompleted());
+
+    const InputReplay::Stats& stats = replay.getStats();
+    TEST_ASSERT_EQUAL_UINT32(22, stats.records);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.boots);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.serialLines);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.httpRequests);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.ignoredInputs);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.wifiChanges);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.droppedRecords);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.rejectedFeedings);
+}
+
+void test_touch_and_haptics(void) {
+    Dump dump = buildSession();
+    prepare(replay);
+    replay.run(dump.bytes.data(), dump.bytes.size());
+
+    // The bounced tap is one press
+    const InputReplay::Stats& stats = replay.getStats();
+    TEST_ASSERT_EQUAL_UINT16(3, stats.touchPresses);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.longPresses);
+
+    // 3 acks, long press, error on cancel, feed-done after 3 feedings
+    TEST_ASSERT_EQUAL_UINT16(8, stats.hapticPatterns);
+    uint32_t expectedMs = 3 * 50 + 200 + 3 * 80 + 3 * (100 + 100 + 250);
+    TEST_ASSERT_EQUAL_UINT32(expectedMs, stats.vibrationMs);
+}
+
+void test_autotune_runs_to_the_edges(void) {
+    Dump dump = buildSession();
+    prepare(replay);
+    replay.run(dump.bytes.data(), dump.bytes.size());
+
+    const AutotuneSearch& search = replay.getAutotune();
+    TEST_ASSERT_EQUAL(AutotuneSearch::PHASE_DONE, search.getPhase());
+    TEST_ASSERT_EQUAL_UINT16(search.getTrialCount(), replay.getStats().autotuneTrials);
+
+    // Within minStep below the edge minus the margin
+    float margin = (100 - AUTOTUNE_MARGIN_PERCENT) / 100.0f;
+    TEST_ASSERT_FLOAT_WITHIN(AUTOTUNE_MIN_SPEED_STEP / 2.0f, SPEED_EDGE * margin - AUTOTUNE_MIN_SPEED_STEP / 2.0f,
+                             search.getResultSpeed());
+    TEST_ASSERT_FLOAT_WITHIN(AUTOTUNE_MIN_ACCEL_STEP / 2.0f, ACCEL_EDGE * margin - AUTOTUNE_MIN_ACCEL_STEP / 2.0f,
+                             search.getResultAcceleration());
+
+    // Trials take motor time: the replay ends well after the last record
+    TEST_ASSERT_TRUE(replay.getNowMs() > 189000 + search.getTrialCount() * 1000UL);
+}
+
+void test_schedule_follows_the_time_zone(void) {
+    // The same session without its zone: 08:00 UTC is two hours away
+    Dump dump;
+    dump.sector(1);
+    dump.byte(InputLog::TYPE_BOOT, 1000, 1);
+    dump.value(InputLog::TYPE_RTC_READ, 1500, UTC_0759);
+    dump.byte(InputLog::TYPE_WIFI_STATUS, 120000, 3);
+    dump.endSector();
+
+    InputReplay utc;
+    utc.setSchedules(SCHEDULES, 2);
+    TEST_ASSERT_TRUE(utc.run(dump.bytes.data(), dump.bytes.size()));
+    TEST_ASSERT_EQUAL_UINT8(0, utc.getFeedingCount());
+
+    // Zone from a URL-encoded web request
+    InputReplay web;
+    web.setSchedules(SCHEDULES, 2);
+    Dump encoded;
+    encoded.sector(1);
+    encoded.byte(InputLog::TYPE_BOOT, 1000, 1);
+    encoded.text(InputLog::TYPE_HTTP_REQUEST, 1200, "GET /api/timezone/set?tz=CET-1CEST%2CM3.5.0%2CM10.5.0%2F3");
+    encoded.value(InputLog::TYPE_RTC_READ, 1500, UTC_0759);
+    encoded.byte(InputLog::TYPE_WIFI_STATUS, 120000, 3);
+    encoded.endSector();
+    TEST_ASSERT_TRUE(web.run(encoded.bytes.data(), encoded.bytes.size()));
+    TEST_ASSERT_EQUAL_STRING(CET, web.getTimezone().getPosix());
+    TEST_ASSERT_EQUAL_UINT8(1, web.getFeedingCount());
+    TEST_ASSERT_EQUAL_UINT32(UTC_0759 + 89, web.getFeeding(0).utc);
+}
+
+void test_damaged_dump(void) {
+    Dump dump = buildSession();
+    prepare(replay);
+
+    // Truncated in the middle of the last record
+    TEST_ASSERT_FALSE(replay.run(dump.bytes.data(), dump.bytes.size() - 4));
+    TEST_ASSERT_EQUAL_UINT32(21, replay.getStats().records);
+
+    // Bad magic in the second sector: session 1 still replays
+    size_t second = 0;
+    for (size_t i = 1; i + 4 <= dump.bytes.size(); i++) {
+        if (memcmp(&dump.bytes[i], "FFIR", 4) == 0) second = i;
+    }
+    dump.bytes[second] = 'X';
+    TEST_ASSERT_FALSE(replay.run(dump.bytes.data(), dump.bytes.size()));
+    TEST_ASSERT_EQUAL_UINT16(1, replay.getStats().boots);
+    TEST_ASSERT_EQUAL_UINT8(2, replay.getFeedingCount());
+}
+
+void test_replay_is_deterministic(void) {
+    Dump dump = buildSession();
+    prepare(replay);
+    prepare(again);
+    replay.run(dump.bytes.data(), dump.bytes.size());
+    again.run(dump.bytes.data(), dump.bytes.size());
+    assertSameReplay(replay, again);
+
+    // Running the same object again starts from power-on
+    again.run(dump.bytes.data(), dump.bytes.size());
+    assertSameReplay(replay, again);
+}
+
+void test_day_replay_time(void) {
+    // One RTC read per second for a day, a tap every hour
+    Dump dump;
+    dump.sector(1);
+    dump.byte(InputLog::TYPE_BOOT, 0, 1);
+    for (uint32_t second = 1; second <= 86400; second++) {
+        uint32_t timeMs = second * 1000;
+        dump.value(InputLog::TYPE_RTC_READ, timeMs, UTC_0759 - 8 * 3600 + second);
+        if (second % 3600 == 0) {
+            dump.byte(InputLog::TYPE_TOUCH_EDGE, timeMs + 100, 1);
+            dump.byte(InputLog::TYPE_TOUCH_EDGE, timeMs + 300, 0);
+        }
+    }
+    dump.endSector();
+
+    InputReplay day;
+    day.setSchedules(DEFAULT_FEEDING_SCHEDULE, DEFAULT_SCHEDULE_COUNT);
+    day.getTimezone().set(CET);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(day.run(dump.bytes.data(), dump.bytes.size()));
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+    long long elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(finish - begin).count();
+
+    // Every default schedule once, on time
+    TEST_ASSERT_EQUAL_UINT8(DEFAULT_SCHEDULE_COUNT, day.getFeedingCount());
+    for (uint8_t i = 0; i < day.getFeedingCount(); i++) {
+        TEST_ASSERT_EQUAL_UINT8(InputReplay::SOURCE_SCHEDULE, day.getFeeding(i).source);
+        TEST_ASSERT_EQUAL_INT8(i, day.getFeeding(i).schedule);
+    }
+    TEST_ASSERT_EQUAL_UINT16(24, day.getStats().touchPresses);
+
+    printf("Day replay: %lu records, %u feedings, %lld us (%.0fx real time)\n",
+           (unsigned long)day.getStats().records, (unsigned)day.getFeedingCount(),
+           elapsedUs, 86400e6 / (elapsedUs > 0 ? elapsedUs : 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_session_feedings);
+    RUN_TEST(test_touch_and_haptics);
+    RUN_TEST(test_autotune_runs_to_the_edges);
+    RUN_TEST(test_schedule_follows_the_time_zone);
+    RUN_TEST(test_damaged_dump);
+    RUN_TEST(test_replay_is_deterministic);
+    RUN_TEST(test_day_replay_time);
+    return UNITY_END();
+}
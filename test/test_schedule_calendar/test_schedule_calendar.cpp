@@ -0,0 +1,215 @@
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "schedule_calendar.h"
+#include "time_zone.h"
+
+/**
+ * ScheduleCalendar host tests and per-tick benchmark
+ *
+ * Checks next/missed feeding times at month and year ends and on both DST
+ * change days, then replays a full year of schedule monitor ticks (every
+ * FEEDING_SCHEDULE_MONITOR_INTERVAL) through the same calls
+ * FeedingSchedule::processSchedules() makes: every schedule must fire
+ * exactly once per local day, and the average cost per tick is printed.
+ */
+
+namespace {
+
+const char* const US_EASTERN = "EST5EDT,M3.2.0,M11.1.0";
+const uint16_t TOLERANCE_MINUTES = 30;
+const uint16_t RECOVERY_HOURS = 24;
+
+// Local midnights (local epoch seconds) and UTC instants checked with glibc
+const uint32_t JAN_31_2024 = 1706659200;
+const uint32_t DEC_31_2024 = 1735603200;
+const uint32_t MAR_10_2024 = 1710028800;    // US spring forward (07:00 UTC)
+const uint32_t NOV_03_2024 = 1730592000;    // US fall back (06:00 UTC)
+
+ScheduledFeeding schedule(uint8_t hour, uint8_t minute, bool enabled = true) {
+    ScheduledFeeding entry = {};
+    entry.hour = hour;
+    entry.minute = minute;
+    entry.portions = 1;
+    entry.enabled = enabled;
+    return entry;
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_next_feeding_across_month_and_year_end(void) {
+    ScheduleCalendar calendar;
+    ScheduledFeeding schedules[] = { schedule(8, 0), schedule(18, 30), schedule(12, 0, false) };
+    uint32_t next = 0;
+
+    // 2024-01-31 23:00 UTC -> 2024-02-01 08:00
+    TEST_ASSERT_EQUAL_INT(0, calendar.findNext(schedules, 3, JAN_31_2024 + 23 * 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(JAN_31_2024 + 86400 + 8 * 3600, next);
+
+    // 2024-12-31 19:00 -> 2025-01-01 08:00
+    TEST_ASSERT_EQUAL_INT(0, calendar.findNext(schedules, 3, DEC_31_2024 + 19 * 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(DEC_31_2024 + 86400 + 8 * 3600, next);
+
+    // Exactly at a schedule: that one is past, the next is later today
+    TEST_ASSERT_EQUAL_INT(1, calendar.findNext(schedules, 3, DEC_31_2024 + 8 * 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(DEC_31_2024 + 18 * 3600 + 1800, next);
+
+    // Nothing enabled
+    schedules[0].enabled = false;
+    schedules[1].enabled = false;
+    TEST_ASSERT_EQUAL_INT(-1, calendar.findNext(schedules, 3, DEC_31_2024, next));
+    TEST_ASSERT_EQUAL_UINT32(0, next);
+}
+
+void test_spring_forward_day(void) {
+    TimeZone zone;
+    zone.set(US_EASTERN);
+    ScheduleCalendar calendar;
+    calendar.setTimezone(&zone);
+    ScheduledFeeding schedules[] = { schedule(2, 30), schedule(8, 0) };
+    uint32_t next = 0;
+
+    // Saturday 20:00 EST: 02:30 does not exist on Sunday, it fires at 03:30 EDT
+    TEST_ASSERT_EQUAL_INT(0, calendar.findNext(schedules, 2, 1710032400 - 5 * 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(1710055800, next);
+
+    // After it: 08:00 EDT = 12:00 UTC
+    TEST_ASSERT_EQUAL_INT(1, calendar.findNext(schedules, 2, 1710055800, next));
+    TEST_ASSERT_EQUAL_UINT32(MAR_10_2024 + 8 * 3600 + 4 * 3600, next);
+
+    // The day is 23 hours long
+    calendar.refreshAnchor(MAR_10_2024 + 5 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(MAR_10_2024, calendar.getMidnightAnchor());
+    calendar.refreshAnchor(MAR_10_2024 + 86400 + 4 * 3600 - 1);
+    TEST_ASSERT_EQUAL_UINT32(MAR_10_2024, calendar.getMidnightAnchor());
+    calendar.refreshAnchor(MAR_10_2024 + 86400 + 4 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(MAR_10_2024 + 86400, calendar.getMidnightAnchor());
+}
+
+void test_fall_back_day(void) {
+    TimeZone zone;
+    zone.set(US_EASTERN);
+    ScheduleCalendar calendar;
+    calendar.setTimezone(&zone);
+    ScheduledFeeding schedules[] = { schedule(1, 30), schedule(8, 0) };
+    uint32_t next = 0;
+
+    // 01:30 happens twice; the feeding is at the first (05:30 UTC, EDT)
+    TEST_ASSERT_EQUAL_INT(0, calendar.findNext(schedules, 2, NOV_03_2024 + 4 * 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(1730611800, next);
+
+    // During the second 01:30 it is not due again today
+    TEST_ASSERT_EQUAL_INT(1, calendar.findNext(schedules, 2, 1730611800 + 3600, next));
+    TEST_ASSERT_EQUAL_UINT32(NOV_03_2024 + 8 * 3600 + 5 * 3600, next);
+
+    // The day is 25 hours long
+    calendar.refreshAnchor(NOV_03_2024 + 4 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(NOV_03_2024, calendar.getMidnightAnchor());
+    calendar.refreshAnchor(NOV_03_2024 + 86400 + 5 * 3600 - 1);
+    TEST_ASSERT_EQUAL_UINT32(NOV_03_2024, calendar.getMidnightAnchor());
+    calendar.refreshAnchor(NOV_03_2024 + 86400 + 5 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(NOV_03_2024 + 86400, calendar.getMidnightAnchor());
+}
+
+void test_anchor_follows_zone_change(void) {
+    TimeZone zone;
+    zone.set("<+00>0");
+    ScheduleCalendar calendar;
+    calendar.setTimezone(&zone);
+
+    // 2024-12-31 23:00 UTC is still Dec 31 in UTC, already Jan 1 in CET
+    calendar.refreshAnchor(DEC_31_2024 + 23 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(DEC_31_2024, calendar.getMidnightAnchor());
+
+    zone.set("CET-1CEST,M3.5.0,M10.5.0/3");
+    calendar.refreshAnchor(DEC_31_2024 + 23 * 3600);
+    TEST_ASSERT_EQUAL_UINT32(DEC_31_2024 + 86400, calendar.getMidnightAnchor());
+}
+
+void test_missed_feeding(void) {
+    TimeZone zone;
+    zone.set(US_EASTERN);
+    ScheduleCalendar calendar;
+    calendar.setTimezone(&zone);
+    ScheduledFeeding schedules[] = { schedule(8, 0), schedule(23, 50) };
+    uint32_t missed = 0;
+
+    // Power back at 00:10: yesterday's 23:50 is 20 minutes late
+    uint32_t lateFeeding = DEC_31_2024 + 23 * 3600 + 50 * 60 + 5 * 3600;
+    uint32_t now = lateFeeding + 20 * 60;
+    TEST_ASSERT_EQUAL_INT(1, calendar.findMissed(schedules, 2, now, 0, TOLERANCE_MINUTES, RECOVERY_HOURS, missed));
+    TEST_ASSERT_EQUAL_UINT32(lateFeeding, missed);
+
+    // Already fed, too late, or still inside the first minute
+    TEST_ASSERT_EQUAL_INT(-1, calendar.findMissed(schedules, 2, now, lateFeeding, TOLERANCE_MINUTES, RECOVERY_HOURS, missed));
+    TEST_ASSERT_EQUAL_INT(-1, calendar.findMissed(schedules, 2, lateFeeding + 31 * 60, 0, TOLERANCE_MINUTES, RECOVERY_HOURS, missed));
+    TEST_ASSERT_EQUAL_INT(-1, calendar.findMissed(schedules, 2, lateFeeding + 60, 0, TOLERANCE_MINUTES, RECOVERY_HOURS, missed));
+
+    // Outside the recovery window
+    TEST_ASSERT_EQUAL_INT(-1, calendar.findMissed(schedules, 2, now, 0, 600, 0, missed));
+}
+
+void test_year_of_ticks(void) {
+    TimeZone zone;
+    zone.set(US_EASTERN);
+    ScheduleCalendar calendar;
+    calendar.setTimezone(&zone);
+
+    // A full schedule table, including times in both DST transition hours
+    ScheduledFeeding schedules[MAX_SCHEDULED_FEEDINGS];
+    const uint8_t hours[] = { 1, 2, 6, 8, 10, 12, 14, 17, 20, 23 };
+    for (uint8_t i = 0; i < MAX_SCHEDULED_FEEDINGS; i++) {
+        schedules[i] = schedule(hours[i % sizeof(hours)], 30);
+    }
+
+    const uint32_t tickSeconds = FEEDING_SCHEDULE_MONITOR_INTERVAL / 1000;
+    const uint32_t days = 366;
+    uint32_t start = 1704085200;    // 2024-01-01 00:00 EST
+    uint32_t end = start + days * 86400 + 3600;
+    uint32_t fired[MAX_SCHEDULED_FEEDINGS] = {};
+    uint32_t lastCompleted = start;     // Yesterday's 23:30 was fed
+    uint32_t next = 0;
+    uint32_t missedCount = 0;
+    uint32_t ticks = 0;
+    int8_t nextIndex = calendar.findNext(schedules, MAX_SCHEDULED_FEEDINGS, start, next);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (uint32_t now = start; now < end; now += tickSeconds, ticks++) {
+        // Same order as FeedingSchedule::processSchedules()
+        calendar.refreshAnchor(now);
+        uint32_t missedEpoch = 0;
+        if (calendar.findMissed(schedules, MAX_SCHEDULED_FEEDINGS, now, lastCompleted,
+                                TOLERANCE_MINUTES, RECOVERY_HOURS, missedEpoch) >= 0) {
+            missedCount++;
+        }
+        if (nextIndex >= 0 && now >= next && now - next <= FEEDING_SCHEDULE_TRIGGER_WINDOW) {
+            fired[nextIndex]++;
+            lastCompleted = now;
+        }
+        nextIndex = calendar.findNext(schedules, MAX_SCHEDULED_FEEDINGS, now, next);
+    }
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+
+    for (uint8_t i = 0; i < MAX_SCHEDULED_FEEDINGS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(days, fired[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, missedCount);
+
+    long long elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - begin).count();
+    printf("Schedule tick (%u schedules, %lu ticks): %lld ns per tick\n",
+           (unsigned)MAX_SCHEDULED_FEEDINGS, (unsigned long)ticks, elapsedNs / (long long)ticks);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_next_feeding_across_month_and_year_end);
+    RUN_TEST(test_spring_forward_day);
+    RUN_TEST(test_fall_back_day);
+    RUN_TEST(test_anchor_follows_zone_change);
+    RUN_TEST(test_missed_feeding);
+    RUN_TEST(test_year_of_ticks);
+    return UNITY_END();
+}
@@ -0,0 +1,211 @@
+#include <unity.h>
+#include <new>
+#include <string>
+#include "string_builder.h"
+
+/**
+ * StringBuilder / FixedString host tests
+ *
+ * The soak test runs the kinds of builds the firmware does per request
+ * (NVRAM keys, time stamps, JSON bodies, command normalization) a million
+ * times each with operator new/delete counted: the builders must not touch
+ * the heap at all, so there is nothing to fragment however long the device
+ * runs, and every pass must produce the same text.
+ */
+
+namespace {
+
+unsigned long allocationCount = 0;
+unsigned long releaseCount = 0;
+
+const unsigned long SOAK_REQUESTS = 1000000;
+
+void buildNvramKey(StringBuilder& out, unsigned index) {
+    out.clear();
+    out.appendFormat("s%u_%s", index, "desc");
+}
+
+void buildTime(StringBuilder& out, unsigned long epoch) {
+    out.clear();
+    unsigned long secondOfDay = epoch % 86400;
+    out.append((unsigned long)(secondOfDay / 3600)).append(':');
+    out.appendPadded(secondOfDay % 3600 / 60, 2).append(':');
+    out.appendPadded(secondOfDay % 60, 2);
+}
+
+void buildStatusJson(StringBuilder& out, unsigned long request) {
+    out.clear();
+    out.append(F("{\"ok\":true,\"feedings\":")).append((long)(request % 7));
+    out.append(",\"desc\":\"").appendJsonEscaped("Morning \"big\" feed\n\t\\ tank 2").append('"');
+    out.appendFormat(",\"uptime\":%lu,\"temp\":%.1f", request % 1000, 24.5);
+    out.print(F(",\"rssi\":"));
+    out.print(-61);
+    out.append('}');
+}
+
+void normalizeCommand(StringBuilder& out, const char* line) {
+    out.clear();
+    out.append(line);
+    out.trim();
+    out.toUpperCase();
+}
+
+} // namespace
+
+// Count every C++ heap allocation made by the test binary
+void* operator new(size_t size) {
+    allocationCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        releaseCount++;
+    }
+    free(p);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_allocation_counter_sees_heap_strings(void) {
+    // Sanity check of the counter itself, with the type the builders replace
+    unsigned long before = allocationCount;
+    std::string text("feeding schedule description");
+    text += " that no longer fits the inline buffer";
+    TEST_ASSERT_TRUE(allocationCount > before);
+}
+
+void test_soak_no_heap_use_and_stable_output(void) {
+    FixedString<15> key;
+    FixedString<24> time;
+    char jsonStorage[160];
+    StringBuilder json(jsonStorage, sizeof(jsonStorage));
+    FixedString<64> command;
+
+    // Reference output of the first request
+    buildNvramKey(key, 3);
+    buildTime(time, 1710028800UL + 45296);
+    buildStatusJson(json, 0);
+    normalizeCommand(command, "  feed 2 \r\n");
+    FixedString<15> keyExpected(key);
+    FixedString<24> timeExpected(time);
+    FixedString<160> jsonExpected(json.c_str());
+    FixedString<64> commandExpected(command);
+
+    TEST_ASSERT_EQUAL_STRING("s3_desc", key.c_str());
+    TEST_ASSERT_EQUAL_STRING("12:34:56", time.c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"ok\":true,\"feedings\":0,\"desc\":\"Morning \\\"big\\\" feed\\n\\t\\\\ tank 2\","
+                             "\"uptime\":0,\"temp\":24.5,\"rssi\":-61}", json.c_str());
+    TEST_ASSERT_EQUAL_STRING("FEED 2", command.c_str());
+
+    uint32_t overflowsBefore = StringBuilder::getOverflowCount();
+    unsigned long allocationsBefore = allocationCount;
+    unsigned long releasesBefore = releaseCount;
+    unsigned long mismatches = 0;
+
+    for (unsigned long request = 0; request < SOAK_REQUESTS; request++) {
+        // Same inputs modulo the request-dependent fields
+        buildNvramKey(key, 3);
+        buildTime(time, 1710028800UL + 45296);
+        buildStatusJson(json, request - request % 7000);
+        normalizeCommand(command, "  feed 2 \r\n");
+
+        mismatches += !key.equals(keyExpected.c_str());
+        mismatches += !time.equals(timeExpected.c_str());
+        mismatches += !json.equals(jsonExpected.c_str());
+        mismatches += !command.equals(commandExpected.c_str());
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+    TEST_ASSERT_EQUAL_UINT32(0, allocationCount - allocationsBefore);
+    TEST_ASSERT_EQUAL_UINT32(0, releaseCount - releasesBefore);
+    TEST_ASSERT_EQUAL_UINT32(overflowsBefore, StringBuilder::getOverflowCount());
+}
+
+void test_overflow_truncates_and_counts_once(void) {
+    uint32_t overflowsBefore = StringBuilder::getOverflowCount();
+    FixedString<8> text;
+
+    text.append("feed").append(" tank").append(" two");
+    TEST_ASSERT_EQUAL_STRING("feed tan", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+    TEST_ASSERT_TRUE(text.overflowed());
+
+    text.append('x');
+    text.appendFormat("%d", 12345);
+    TEST_ASSERT_EQUAL_STRING("feed tan", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(overflowsBefore + 1, StringBuilder::getOverflowCount());
+
+    text.clear();
+    TEST_ASSERT_FALSE(text.overflowed());
+    TEST_ASSERT_TRUE(text.isEmpty());
+    text.appendFormat("s%u_%s", 12u, "description");
+    TEST_ASSERT_EQUAL_STRING("s12_desc", text.c_str());
+    TEST_ASSERT_TRUE(text.overflowed());
+    TEST_ASSERT_EQUAL_UINT32(overflowsBefore + 2, StringBuilder::getOverflowCount());
+}
+
+void test_print_interface(void) {
+    FixedString<48> text;
+    text.print(F("id="));
+    text.print(42);
+    text.print(' ');
+    text.print(4000000000UL);
+    text.print(' ');
+    text.print(255, HEX);
+    text.println();
+    TEST_ASSERT_EQUAL_STRING("id=42 4000000000 FF\r\n", text.c_str());
+}
+
+void test_formatting_helpers(void) {
+    FixedString<32> text;
+    text.appendPadded(7, 2).append('|').appendPadded(123, 2).append('|').appendPadded(0, 3);
+    TEST_ASSERT_EQUAL_STRING("07|123|000", text.c_str());
+
+    text.clear();
+    text.appendJsonEscaped("a\"b\\c\x01");
+    TEST_ASSERT_EQUAL_STRING("a\\\"b\\\\c\\u0001", text.c_str());
+
+    text.clear();
+    text.append(" \t set tz cet \r\n");
+    text.trim();
+    text.toUpperCase();
+    TEST_ASSERT_EQUAL_STRING("SET TZ CET", text.c_str());
+    TEST_ASSERT_TRUE(text.startsWith("SET "));
+    TEST_ASSERT_FALSE(text.startsWith("SET TZ CET "));
+
+    text.clear();
+    text.append("   ");
+    text.trim();
+    TEST_ASSERT_TRUE(text.isEmpty());
+}
+
+void test_fixed_string_copies_own_storage(void) {
+    FixedString<16> original("tank");
+    FixedString<16> copy(original);
+    original.append(" 1");
+    copy.append(" 2");
+    TEST_ASSERT_EQUAL_STRING("tank 1", original.c_str());
+    TEST_ASSERT_EQUAL_STRING("tank 2", copy.c_str());
+
+    copy = original;
+    original.clear();
+    TEST_ASSERT_EQUAL_STRING("tank 1", copy.c_str());
+    TEST_ASSERT_EQUAL_UINT32(16, copy.capacity());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_allocation_counter_sees_heap_strings);
+    RUN_TEST(test_soak_no_heap_use_and_stable_output);
+    RUN_TEST(test_overflow_truncates_and_counts_once);
+    RUN_TEST(test_print_interface);
+    RUN_TEST(test_formatting_helpers);
+    RUN_TEST(test_fixed_string_copies_own_storage);
+    return UNITY_END();
+}
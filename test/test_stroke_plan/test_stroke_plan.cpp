@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "config.h"
+#include "stroke_plan.h"
+
+/**
+ * StrokePlan host tests and dispense profile benchmark
+ *
+ * Walks the same plan the RMT interrupt plays: every stroke plan must end
+ * with the net rotation asked for, with forward strokes no longer than
+ * strokeSteps and full-length reverse strokes. The benchmark reports the
+ * move time of one portion for every DISPENSE_PROFILES entry at the
+ * default speed and acceleration, and what estimateDuration() costs.
+ */
+
+namespace {
+
+const int BENCH_ITERATIONS = 2000;
+
+struct Walk {
+    long netSteps;
+    uint32_t durationUs;
+    uint16_t strokes;
+    uint32_t longestForward;
+    uint32_t shortestReverse;
+    uint32_t longestReverse;
+};
+
+// Walk a plan stroke by stroke, the way StepperWaveform::nextHalfItem() does
+Walk walk(long steps, uint16_t strokeSteps, uint16_t reverseSteps) {
+    StrokePlan plan;
+    plan.begin(StrokePlan::makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION), steps, strokeSteps, reverseSteps);
+
+    Walk result = { 0, 0, 0, 0, 0xFFFFFFFFUL, 0 };
+    do {
+        uint32_t length = plan.ramp.remaining;
+        result.strokes++;
+        if (plan.reversing) {
+            if (length < result.shortestReverse) result.shortestReverse = length;
+            if (length > result.longestReverse) result.longestReverse = length;
+        } else if (length > result.longestForward) {
+            result.longestForward = length;
+        }
+        while (plan.ramp.remaining > 0) {
+            result.durationUs += plan.nextStepInterval();
+            result.netSteps += plan.direction;
+        }
+    } while (plan.nextStroke());
+    return result;
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_single_stroke_follows_trapezoid(void) {
+    // 10 revolutions: cruise time plus one v/a for the two ramps
+    long steps = 10L * STEPS_PER_REVOLUTION;
+    double idealUs = (steps / DEFAULT_MAX_SPEED + DEFAULT_MAX_SPEED / DEFAULT_ACCELERATION) * 1e6;
+    uint32_t durationUs = StrokePlan::estimateDuration(steps, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    TEST_ASSERT_UINT32_WITHIN((uint32_t)(idealUs * 0.02), (uint32_t)idealUs, durationUs);
+
+    // Direction does not change the timing
+    TEST_ASSERT_EQUAL_UINT32(durationUs, StrokePlan::estimateDuration(-steps, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION));
+    TEST_ASSERT_EQUAL_UINT32(durationUs, walk(steps, 0, 0).durationUs);
+}
+
+void test_invalid_stroke_plan_is_single_stroke(void) {
+    uint32_t single = StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    TEST_ASSERT_EQUAL_UINT32(single, StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION, 64, 0));
+    TEST_ASSERT_EQUAL_UINT32(single, StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION, 64, 64));
+    TEST_ASSERT_EQUAL_UINT32(single, StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION, 64, 96));
+    TEST_ASSERT_EQUAL_UINT16(1, walk(STEPS_PER_PORTION, 64, 64).strokes);
+}
+
+void test_profiles_keep_net_rotation(void) {
+    for (uint8_t p = 0; p < DISPENSE_PROFILE_COUNT; p++) {
+        const DispenseProfile& profile = DISPENSE_PROFILES[p];
+        for (int portions = MIN_FOOD_PORTIONS; portions <= MAX_FOOD_PORTIONS; portions++) {
+            long steps = portionsToSteps(portions);
+            for (int sign = -1; sign <= 1; sign += 2) {
+                Walk result = walk(sign * steps, profile.strokeSteps, profile.reverseSteps);
+                TEST_ASSERT_EQUAL_INT32_MESSAGE(sign * steps, result.netSteps, profile.name);
+
+                if (profile.strokeSteps == 0) {
+                    TEST_ASSERT_EQUAL_UINT16_MESSAGE(1, result.strokes, profile.name);
+                    continue;
+                }
+                // Forward, reverse, forward, ... ending on a forward stroke
+                TEST_ASSERT_EQUAL_UINT16_MESSAGE(1, result.strokes % 2, profile.name);
+                TEST_ASSERT_TRUE_MESSAGE(result.longestForward <= profile.strokeSteps, profile.name);
+                if (result.strokes > 1) {
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(profile.reverseSteps, result.shortestReverse, profile.name);
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(profile.reverseSteps, result.longestReverse, profile.name);
+                }
+            }
+        }
+    }
+}
+
+void test_profile_time_per_portion(void) {
+    uint32_t directUs = StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+
+    printf("Dispense profiles, %d steps per portion at %.0f steps/s, %.0f steps/s2:\n",
+           STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+
+    for (uint8_t p = 0; p < DISPENSE_PROFILE_COUNT; p++) {
+        const DispenseProfile& profile = DISPENSE_PROFILES[p];
+        uint32_t durationUs = 0;
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            durationUs = StrokePlan::estimateDuration(STEPS_PER_PORTION, DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION,
+                                                      profile.strokeSteps, profile.reverseSteps);
+        }
+        std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+        long long elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - begin).count();
+
+        Walk result = walk(STEPS_PER_PORTION, profile.strokeSteps, profile.reverseSteps);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(result.durationUs, durationUs, profile.name);
+        if (profile.strokeSteps != 0) {
+            TEST_ASSERT_TRUE_MESSAGE(durationUs > directUs, profile.name);
+        }
+
+        printf("  %-9s +%u/-%u: %u strokes, %lu ms per portion (%.2fx direct), estimate %lld ns\n",
+               profile.name, (unsigned)profile.strokeSteps, (unsigned)profile.reverseSteps,
+               (unsigned)result.strokes, (unsigned long)((durationUs + 500) / 1000),
+               (double)durationUs / directUs, elapsedNs / BENCH_ITERATIONS);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_stroke_follows_trapezoid);
+    RUN_TEST(test_invalid_stroke_plan_is_single_stroke);
+    RUN_TEST(test_profiles_keep_net_rotation);
+    RUN_TEST(test_profile_time_per_portion);
+    return UNITY_END();
+}
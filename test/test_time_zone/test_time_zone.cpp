@@ -0,0 +1,251 @@
+#include <unity.h>
+#include "time_zone.h"
+#include "string_builder.h"
+
+/**
+ * TimeZone host tests
+ *
+ * Transition instants below were taken from glibc (TZ=<string>, localtime)
+ * for the same POSIX strings, so the table built by TimeZone is checked
+ * against an independent implementation: M, J and n rules, negative and
+ * beyond-24h /time, DST across the new year, and the local -> UTC
+ * resolution of the repeated and skipped hours.
+ */
+
+namespace {
+
+struct Transition {
+    uint32_t utc;               // First second of the new offset
+    int32_t offset;             // Offset from then on (seconds east of UTC)
+};
+
+// 2024-01-01 00:00:00 UTC
+const uint32_t YEAR_2024 = 1704067200;
+
+void assertTransitions(const char* posix, const Transition* expected, int count) {
+    TimeZone zone;
+    TEST_ASSERT_TRUE_MESSAGE(zone.set(posix), posix);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(expected[i].offset, zone.getOffset(expected[i].utc), posix);
+        TEST_ASSERT_NOT_EQUAL_MESSAGE(expected[i].offset, zone.getOffset(expected[i].utc - 1), posix);
+    }
+}
+
+// Every hour of 2024 maps back to itself, except the second pass through
+// the repeated hour (which resolves to the first)
+void assertRoundTrip(const char* posix) {
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.set(posix));
+    for (uint32_t utc = YEAR_2024; utc < YEAR_2024 + 366 * 86400; utc += 900) {
+        uint32_t local = zone.toLocal(utc);
+        uint32_t back = zone.toUtc(local);
+        if (back != utc) {
+            // Same wall clock reading an hour earlier, in the other offset
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(utc - 3600, back, posix);
+            TEST_ASSERT_TRUE(zone.isDst(back));
+            TEST_ASSERT_FALSE(zone.isDst(utc));
+        }
+    }
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_month_week_day_rules(void) {
+    const Transition eastern[] = {
+        { 1710054000, -4 * 3600 },  // 2024-03-10 07:00 UTC
+        { 1730613600, -5 * 3600 },  // 2024-11-03 06:00 UTC
+        { 1741503600, -4 * 3600 },
+        { 1762063200, -5 * 3600 },
+    };
+    assertTransitions("EST5EDT,M3.2.0,M11.1.0", eastern, 4);
+
+    // Last Sunday (week 5), end at 03:00 daylight time
+    const Transition central[] = {
+        { 1711846800, 2 * 3600 },   // 2024-03-31 01:00 UTC
+        { 1729990800, 1 * 3600 },   // 2024-10-27 01:00 UTC
+        { 1743296400, 2 * 3600 },
+        { 1761440400, 1 * 3600 },
+    };
+    assertTransitions("CET-1CEST,M3.5.0,M10.5.0/3", central, 4);
+}
+
+void test_dst_across_new_year(void) {
+    const Transition sydney[] = {
+        { 1712419200, 10 * 3600 },  // 2024-04-06 16:00 UTC
+        { 1728144000, 11 * 3600 },  // 2024-10-05 16:00 UTC
+        { 1743868800, 10 * 3600 },
+        { 1759593600, 11 * 3600 },
+    };
+    assertTransitions("AEST-10AEDT,M10.1.0,M4.1.0/3", sydney, 4);
+
+    TimeZone zone;
+    zone.set("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    TEST_ASSERT_TRUE(zone.isDst(YEAR_2024));
+    TEST_ASSERT_EQUAL_STRING("AEDT", zone.getAbbreviation(YEAR_2024));
+    TEST_ASSERT_EQUAL_STRING("AEST", zone.getAbbreviation(1712419200));
+}
+
+void test_julian_rules(void) {
+    // Jn never counts Feb 29: J60 is March 1 in leap and common years
+    const Transition julian[] = {
+        { 1709269200, -2 * 3600 },  // 2024-03-01 05:00 UTC
+        { 1730001600, -3 * 3600 },  // 2024-10-27 04:00 UTC
+        { 1740805200, -2 * 3600 },  // 2025-03-01 05:00 UTC
+        { 1761537600, -3 * 3600 },
+    };
+    assertTransitions("XST3XDT,J60,J300", julian, 4);
+}
+
+void test_zero_based_day_rules(void) {
+    // n counts Feb 29: day 59 is Feb 29 in 2024, March 1 in 2025
+    const Transition zeroBased[] = {
+        { 1709182800, -2 * 3600 },  // 2024-02-29 05:00 UTC
+        { 1729915200, -3 * 3600 },  // 2024-10-26 04:00 UTC
+        { 1740805200, -2 * 3600 },  // 2025-03-01 05:00 UTC
+        { 1761537600, -3 * 3600 },  // 2025-10-27 04:00 UTC
+    };
+    assertTransitions("XST3XDT,59,299", zeroBased, 4);
+}
+
+void test_negative_rule_time(void) {
+    // Greenland: -1:00 on Sunday is 23:00 on Saturday
+    const Transition nuuk[] = {
+        { 1711846800, -1 * 3600 },  // 2024-03-31 01:00 UTC
+        { 1729990800, -2 * 3600 },  // 2024-10-27 01:00 UTC
+        { 1743296400, -1 * 3600 },
+        { 1761440400, -2 * 3600 },
+    };
+    assertTransitions("<-02>2<-01>,M3.5.0/-1,M10.5.0/0", nuuk, 4);
+}
+
+void test_rule_time_beyond_24h(void) {
+    // Israel: 26:00 on the Thursday is 02:00 on Friday
+    const Transition israel[] = {
+        { 1711670400, 3 * 3600 },   // 2024-03-29 00:00 UTC
+        { 1729983600, 2 * 3600 },   // 2024-10-26 23:00 UTC
+        { 1743120000, 3 * 3600 },
+        { 1761433200, 2 * 3600 },
+    };
+    assertTransitions("IST-2IDT,M3.4.4/26,M10.5.0", israel, 4);
+}
+
+void test_repeated_hour_resolves_to_first_occurrence(void) {
+    TimeZone zone;
+    zone.set("EST5EDT,M3.2.0,M11.1.0");
+
+    // 2024-11-03 01:30 local happens at 05:30 UTC (EDT) and 06:30 UTC (EST)
+    uint32_t local = 1730592000 + 5400;
+    TEST_ASSERT_EQUAL_UINT32(1730611800, zone.toUtc(local));
+    TEST_ASSERT_EQUAL_UINT32(local, zone.toLocal(1730611800));
+    TEST_ASSERT_EQUAL_UINT32(local, zone.toLocal(1730611800 + 3600));
+
+    // Just outside the repeated hour
+    TEST_ASSERT_EQUAL_UINT32(1730592000 + 3599 + 4 * 3600, zone.toUtc(1730592000 + 3599));
+    TEST_ASSERT_EQUAL_UINT32(1730592000 + 7200 + 5 * 3600, zone.toUtc(1730592000 + 7200));
+
+    // 2024-10-27 02:30 local in Central Europe: first at 00:30 UTC (CEST)
+    zone.set("CET-1CEST,M3.5.0,M10.5.0/3");
+    TEST_ASSERT_EQUAL_UINT32(1729989000, zone.toUtc(1729987200 + 9000));
+}
+
+void test_skipped_hour_maps_past_the_jump(void) {
+    TimeZone zone;
+    zone.set("EST5EDT,M3.2.0,M11.1.0");
+
+    // 2024-03-10 02:30 local does not exist: read as 03:30 EDT (07:30 UTC)
+    uint32_t midnight = 1710028800;
+    TEST_ASSERT_EQUAL_UINT32(1710055800, zone.toUtc(midnight + 9000));
+    TEST_ASSERT_EQUAL_UINT32(midnight + 3 * 3600 + 1800, zone.toLocal(1710055800));
+
+    // Either side of the gap
+    TEST_ASSERT_EQUAL_UINT32(1710054000 - 1, zone.toUtc(midnight + 7200 - 1));
+    TEST_ASSERT_EQUAL_UINT32(1710054000, zone.toUtc(midnight + 3 * 3600));
+}
+
+void test_round_trip(void) {
+    assertRoundTrip("EST5EDT,M3.2.0,M11.1.0");
+    assertRoundTrip("CET-1CEST,M3.5.0,M10.5.0/3");
+    assertRoundTrip("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    assertRoundTrip("IST-2IDT,M3.4.4/26,M10.5.0");
+    assertRoundTrip("<-02>2<-01>,M3.5.0/-1,M10.5.0/0");
+}
+
+void test_table_rebuilt_outside_its_range(void) {
+    TimeZone zone;
+    zone.set("EST5EDT,M3.2.0,M11.1.0");
+    TEST_ASSERT_EQUAL_INT32(-5 * 3600, zone.getOffset(YEAR_2024));
+
+    // 2099-03-08 07:00 UTC, then back to 1990-11-04 06:00 UTC
+    TEST_ASSERT_EQUAL_INT32(-4 * 3600, zone.getOffset(4076636400u));
+    TEST_ASSERT_EQUAL_INT32(-5 * 3600, zone.getOffset(4076636400u - 1));
+    TEST_ASSERT_EQUAL_INT32(-5 * 3600, zone.getOffset(657698400));
+    TEST_ASSERT_EQUAL_INT32(-4 * 3600, zone.getOffset(657698400 - 1));
+    TEST_ASSERT_EQUAL_INT32(-4 * 3600, zone.getOffset(1710054000));
+}
+
+void test_zone_without_dst(void) {
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.set("<-03>3"));
+    TEST_ASSERT_FALSE(zone.hasDst());
+    TEST_ASSERT_EQUAL_STRING("-03", zone.getAbbreviation(YEAR_2024));
+    TEST_ASSERT_EQUAL_INT32(-3 * 3600, zone.getOffset(YEAR_2024 + 200 * 86400));
+    TEST_ASSERT_EQUAL_UINT32(YEAR_2024 + 3 * 3600, zone.toUtc(YEAR_2024));
+}
+
+void test_invalid_strings_leave_zone_unchanged(void) {
+    const char* invalid[] = {
+        "",
+        "EST",
+        "EST5EDT,M3.2.0",
+        "EST5EDT,M13.2.0,M11.1.0",
+        "EST5EDT,M3.6.0,M11.1.0",
+        "EST5EDT,M3.2.7,M11.1.0",
+        "XST3XDT,J0,J300",
+        "XST3XDT,59,366",
+        "EST5EDT,M3.2.0/168,M11.1.0",
+        "EST5EDT,M3.2.0,M11.1.0x",
+    };
+
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.set("CET-1CEST,M3.5.0,M10.5.0/3"));
+    uint16_t generation = zone.getGeneration();
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_FALSE_MESSAGE(TimeZone::isValid(invalid[i]), invalid[i]);
+        TEST_ASSERT_FALSE_MESSAGE(zone.set(invalid[i]), invalid[i]);
+    }
+    TEST_ASSERT_EQUAL_STRING("CET-1CEST,M3.5.0,M10.5.0/3", zone.getPosix());
+    TEST_ASSERT_EQUAL_UINT16(generation, zone.getGeneration());
+    TEST_ASSERT_EQUAL_INT32(2 * 3600, zone.getOffset(1711846800));
+}
+
+void test_print_info(void) {
+    TimeZone zone;
+    zone.set("EST5EDT,M3.2.0,M11.1.0");
+    zone.getOffset(1710054000);
+
+    FixedString<2048> text;
+    zone.printInfo(text);
+    TEST_ASSERT_NOT_NULL(strstr(text.c_str(), "2024-03-10 07:00 -> "));
+    TEST_ASSERT_NOT_NULL(strstr(text.c_str(), "2024-11-03 06:00 -> "));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_month_week_day_rules);
+    RUN_TEST(test_dst_across_new_year);
+    RUN_TEST(test_julian_rules);
+    RUN_TEST(test_zero_based_day_rules);
+    RUN_TEST(test_negative_rule_time);
+    RUN_TEST(test_rule_time_beyond_24h);
+    RUN_TEST(test_repeated_hour_resolves_to_first_occurrence);
+    RUN_TEST(test_skipped_hour_maps_past_the_jump);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_table_rebuilt_outside_its_range);
+    RUN_TEST(test_zone_without_dst);
+    RUN_TEST(test_invalid_strings_leave_zone_unchanged);
+    RUN_TEST(test_print_info);
+    return UNITY_END();
+}
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+"""
+Decode an input recording from the feeder and replay it against a bench unit.
+
+The recording is the binary /api/inputs response (INPUT ON on the unit,
+reproduce the problem, then fetch it):
+  curl -o inputs.bin http://<feeder>/api/inputs
+
+Usage:
+  tools/input_replay.py inputs.bin                      (list boot sessions and their inputs)
+  tools/input_replay.py inputs.bin --replay --port /dev/ttyUSB0 --url http://192.168.1.50
+  tools/input_replay.py inputs.bin --replay --session 2 --speed 4 --port /dev/ttyUSB0
+
+Replay sends each input of one session with the original spacing (divided
+by --speed): serial lines and touch edges (as TOUCH INJECT commands) over
+the serial port, HTTP requests to --url. WiFi status changes and RTC
+readings cannot be injected; they are printed in the timeline so the run
+can be lined up with the original. --set-clock sets the bench RTC to the
+first recorded reading before starting (the SET command takes local time,
+pass the recorded unit's UTC offset with --utc-offset).
+
+Start PROFILE SAMPLE or TRACE on the bench unit before replaying to profile
+the exact sequence. Needs pyserial for --port.
+
+Without a unit, InputReplay (src/input_replay.h) replays the same dump on
+the host under a virtual clock through the schedule, time zone, haptic and
+autotune modules; test/test_input_replay shows how to drive it
+(pio test -e native -f test_input_replay).
+"""
+
+import argparse
+import datetime
+import struct
+import sys
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+
+MAGIC = b"FFIR"
+SECTOR_HEADER = struct.Struct("<4sB3xI")
+RECORD_HEADER = struct.Struct("<BBI")
+END = 0xFF
+
+TYPE_BOOT = 1
+TYPE_START = 2
+TYPE_SERIAL_LINE = 3
+TYPE_TOUCH_EDGE = 4
+TYPE_HTTP_REQUEST = 5
+TYPE_WIFI_STATUS = 6
+TYPE_RTC_READ = 7
+TYPE_DROPPED = 8
+
+RESET_REASONS = {
+    0: "unknown", 1: "power-on", 2: "external", 3: "software", 4: "panic",
+    5: "interrupt watchdog", 6: "task watchdog", 7: "watchdog", 8: "deep sleep",
+    9: "brownout", 10: "SDIO",
+}
+
+WIFI_STATUS = {
+    0: "idle", 1: "no SSID", 2: "scan completed", 3: "connected",
+    4: "connect failed", 5: "connection lost", 6: "disconnected", 255: "no shield",
+}
+
+
+class Record(object):
+    def __init__(self, kind, time_ms, payload):
+        self.kind = kind
+        self.time_ms = time_ms
+        self.payload = payload
+
+    def text(self):
+        return self.payload.decode("utf-8", errors="replace")
+
+    def describe(self):
+        if self.kind == TYPE_BOOT:
+            reason = self.payload[0] if self.payload else 0
+            return "boot", "reset reason: " + RESET_REASONS.get(reason, str(reason))
+        if self.kind == TYPE_START:
+            return "start", "recording switched on"
+        if self.kind == TYPE_SERIAL_LINE:
+            return "serial", self.text()
+        if self.kind == TYPE_TOUCH_EDGE:
+            return "touch", "pressed" if self.payload[:1] == b"\x01" else "released"
+        if self.kind == TYPE_HTTP_REQUEST:
+            return "http", self.text()
+        if self.kind == TYPE_WIFI_STATUS:
+            status = self.payload[0] if self.payload else 255
+            return "wifi", WIFI_STATUS.get(status, str(status))
+        if self.kind == TYPE_RTC_READ:
+            (utc,) = struct.unpack("<I", self.payload[:4])
+            stamp = datetime.datetime.utcfromtimestamp(utc).strftime("%Y-%m-%d %H:%M:%S UTC")
+            return "rtc", stamp
+        if self.kind == TYPE_DROPPED:
+            (count,) = struct.unpack("<I", self.payload[:4])
+            return "dropped", "%d records lost (staging buffer full)" % count
+        return "type %d" % self.kind, self.payload.hex()
+
+
+def parse_dump(data):
+    """Records of all sectors in dump order (oldest first)."""
+    records = []
+    offset = 0
+    while offset + SECTOR_HEADER.size <= len(data):
+        magic, version, sequence = SECTOR_HEADER.unpack_from(data, offset)
+        if magic != MAGIC or version != 1:
+            sys.exit("error: bad sector header at offset %d (magic %r, version %d)" % (offset, magic, version))
+        offset += SECTOR_HEADER.size
+        while offset < len(data) and data[offset] != END:
+            if offset + RECORD_HEADER.size > len(data):
+                sys.exit("error: dump truncated at offset %d" % offset)
+            kind, size, time_ms = RECORD_HEADER.unpack_from(data, offset)
+            offset += RECORD_HEADER.size
+            records.append(Record(kind, time_ms, data[offset:offset + size]))
+            offset += size
+        offset += 1
+    return records
+
+
+def split_sessions(records):
+    """One list per boot; records before the first boot record form session 0."""
+    sessions = [[]]
+    for record in records:
+        if record.kind == TYPE_BOOT and sessions[-1]:
+            sessions.append([])
+        sessions[-1].append(record)
+    return [session for session in sessions if session]
+
+
+def seconds_between(first_ms, time_ms):
+    """millis() difference, across its 49-day wrap."""
+    return ((time_ms - first_ms) & 0xFFFFFFFF) / 1000.0
+
+
+def print_session(index, session):
+    first = session[0].time_ms
+    print("Session %d: %d records, %.1f s" % (index, len(session), seconds_between(first, session[-1].time_ms)))
+    for record in session:
+        kind, text = record.describe()
+        print("  %10.3f  %-7s  %s" % (seconds_between(first, record.time_ms), kind, text))
+
+
+def parse_request(text):
+    method, _, target = text.partition(" ")
+    uri, _, query = target.partition("?")
+    args = urllib.parse.parse_qsl(query, keep_blank_values=True)
+    return method, uri, args
+
+
+def send_request(base_url, text):
+    method, uri, args = parse_request(text)
+    url = base_url.rstrip("/") + uri
+    body = None
+    if method in ("POST", "PUT", "PATCH"):
+        plain = [value for name, value in args if name == "plain"]
+        form = [(name, value) for name, value in args if name != "plain"]
+        body = (plain[0] if plain else urllib.parse.urlencode(form)).encode("utf-8")
+    elif args:
+        url += "?" + urllib.parse.urlencode(args)
+
+    request = urllib.request.Request(url, data=body, method=method if method != "OTHER" else "GET")
+    if body is not None:
+        request.add_header("Content-Type", "application/x-www-form-urlencoded")
+    started = time.monotonic()
+    try:
+        with urllib.request.urlopen(request, timeout=30) as response:
+            response.read()
+            status = response.status
+    except urllib.error.HTTPError as error:
+        status = error.code
+    except (urllib.error.URLError, OSError) as error:
+        return "failed: %s" % error
+    return "%d in %.0f ms" % (status, (time.monotonic() - started) * 1000.0)
+
+
+def replay(session, port, base_url, speed, set_clock, utc_offset):
+    def send_line(line):
+        port.write((line + "\n").encode("utf-8"))
+        port.flush()
+
+    if set_clock:
+        readings = [record for record in session if record.kind == TYPE_RTC_READ]
+        if not readings:
+            print("no RTC reading in this session, clock not set")
+        elif port:
+            (utc,) = struct.unpack("<I", readings[0].payload[:4])
+            local = datetime.datetime.utcfromtimestamp(utc + int(utc_offset * 3600))
+            send_line(local.strftime("SET %d/%m/%Y %H:%M:%S"))
+
+    # Recording may have been off for a while before a start record;
+    # the replay continues right away instead of waiting out the gap
+    session_first = session[0].time_ms
+    first = session_first
+    started = time.monotonic()
+    try:
+        for record in session:
+            if record.kind == TYPE_START:
+                first = record.time_ms
+                started = time.monotonic()
+            due = started + seconds_between(first, record.time_ms) / speed
+            delay = due - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+
+            kind, text = record.describe()
+            result = ""
+            if record.kind == TYPE_SERIAL_LINE and port:
+                send_line(record.text())
+            elif record.kind == TYPE_TOUCH_EDGE and port:
+                send_line("TOUCH INJECT " + ("PRESS" if text == "pressed" else "RELEASE"))
+            elif record.kind == TYPE_HTTP_REQUEST and base_url:
+                result = "  -> " + send_request(base_url, record.text())
+            elif record.kind in (TYPE_SERIAL_LINE, TYPE_TOUCH_EDGE, TYPE_HTTP_REQUEST):
+                result = "  (skipped, no %s)" % ("--url" if record.kind == TYPE_HTTP_REQUEST else "--port")
+            else:
+                result = "  (context)"
+            lateness = (time.monotonic() - due) * 1000.0
+            print("  %10.3f  %-7s  %s%s  [+%.0f ms]" % (seconds_between(session_first, record.time_ms),
+                                                      kind, text, result, lateness))
+    finally:
+        if port:
+            send_line("TOUCH INJECT OFF")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("dump", help="binary /api/inputs response")
+    parser.add_argument("--session", type=int, help="boot session to list/replay (default: all / last)")
+    parser.add_argument("--replay", action="store_true", help="replay the session against a bench unit")
+    parser.add_argument("--port", help="bench serial port for serial lines and touch edges")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate")
+    parser.add_argument("--url", help="bench base URL for HTTP requests, e.g. http://192.168.1.50")
+    parser.add_argument("--speed", type=float, default=1.0, help="replay speed factor")
+    parser.add_argument("--set-clock", action="store_true", help="set the bench RTC to the first recorded reading")
+    parser.add_argument("--utc-offset", type=float, default=0.0, help="recorded unit's UTC offset in hours (--set-clock)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        sessions = split_sessions(parse_dump(f.read()))
+    if not sessions:
+        sys.exit("error: no records in " + args.dump)
+    if args.session is not None and not 0 <= args.session < len(sessions):
+        sys.exit("error: session %d not in recording (0-%d)" % (args.session, len(sessions) - 1))
+
+    if not args.replay:
+        indexes = [args.session] if args.session is not None else range(len(sessions))
+        for index in indexes:
+            print_session(index, sessions[index])
+        return
+
+    if args.speed <= 0:
+        sys.exit("error: --speed must be positive")
+    port = None
+    if args.port:
+        import serial
+        # Keep DTR/RTS released, toggling them resets most ESP32 boards
+        port = serial.Serial()
+        port.port = args.port
+        port.baudrate = args.baud
+        port.dtr = False
+        port.rts = False
+        port.open()
+    index = args.session if args.session is not None else len(sessions) - 1
+    print("Replaying session %d (%d records) at %gx" % (index, len(sessions[index]), args.speed))
+    try:
+        replay(sessions[index], port, args.url, args.speed, args.set_clock, args.utc_offset)
+    finally:
+        if port:
+            port.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Symbolize a PROFILE SAMPLE dump and print folded stacks for flame graphs.
+
+The dump comes from the feeder either as the binary /api/profile response
+or as the base64 block printed by PROFILE SAMPLE DUMP (a saved serial log
+works as is, text around the BEGIN/END markers is ignored).
+
+Usage:
+  tools/profile_symbolize.py profile.bin --elf .pio/build/esp32/firmware.elf > profile.folded
+  flamegraph.pl profile.folded > profile.svg     (or open it in speedscope)
+
+Output lines are "caller;function count". Samples whose caller is unknown
+are folded under the function alone. A top-N table of self samples is
+printed to stderr.
+"""
+
+import argparse
+import base64
+import collections
+import glob
+import os
+import shutil
+import struct
+import subprocess
+import sys
+
+MAGIC = b"FFPS"
+HEADER = struct.Struct("<4sBBHII")
+SAMPLE = struct.Struct("<II")
+
+
+def load_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data.startswith(MAGIC):
+        return data
+
+    text = data.decode("utf-8", errors="replace")
+    begin = text.rfind("-----BEGIN PROFILE-----")
+    end = text.find("-----END PROFILE-----", begin)
+    if begin < 0 or end < 0:
+        sys.exit("error: no binary header or BEGIN/END PROFILE block in " + path)
+    body = text[begin + len("-----BEGIN PROFILE-----"):end]
+    return base64.b64decode("".join(body.split()))
+
+
+def parse_dump(data):
+    magic, version, _, rate_hz, count, total = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != 1:
+        sys.exit("error: unsupported dump (magic %r, version %d)" % (magic, version))
+    if len(data) < HEADER.size + count * SAMPLE.size:
+        sys.exit("error: dump truncated (%d of %d samples)" %
+                 ((len(data) - HEADER.size) // SAMPLE.size, count))
+    samples = [SAMPLE.unpack_from(data, HEADER.size + i * SAMPLE.size) for i in range(count)]
+    return rate_hz, total, samples
+
+
+def find_addr2line(explicit):
+    if explicit:
+        return explicit
+    name = "xtensa-esp32-elf-addr2line"
+    found = shutil.which(name)
+    if found:
+        return found
+    pattern = os.path.expanduser("~/.platformio/packages/toolchain-xtensa*/bin/" + name)
+    candidates = sorted(glob.glob(pattern))
+    if candidates:
+        return candidates[-1]
+    sys.exit("error: %s not found, pass --addr2line" % name)
+
+
+def symbolize(addr2line, elf, addresses):
+    """Map each address to "function (file:line)" with one addr2line call."""
+    addresses = sorted(addresses)
+    if not addresses:
+        return {}
+    result = subprocess.run([addr2line, "-f", "-C", "-e", elf] + ["0x%08x" % a for a in addresses],
+                            check=True, stdout=subprocess.PIPE, universal_newlines=True)
+    lines = result.stdout.splitlines()
+    names = {}
+    for i, address in enumerate(addresses):
+        function = lines[2 * i].strip()
+        location = os.path.basename(lines[2 * i + 1].strip())
+        if function == "??":
+            function = "0x%08x" % address
+        names[address] = (function, location)
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("dump", help="binary dump or serial log with a BEGIN/END PROFILE block")
+    parser.add_argument("--elf", required=True, help="firmware ELF matching the running image")
+    parser.add_argument("--addr2line", help="path to xtensa-esp32-elf-addr2line")
+    parser.add_argument("--top", type=int, default=15, help="functions in the stderr summary")
+    parser.add_argument("--lines", action="store_true", help="fold by function and source line")
+    args = parser.parse_args()
+
+    rate_hz, total, samples = parse_dump(load_dump(args.dump))
+    names = symbolize(find_addr2line(args.addr2line), args.elf,
+                      {pc for pc, _ in samples} | {caller for _, caller in samples if caller})
+
+    def frame(address):
+        function, location = names[address]
+        return "%s:%s" % (function, location) if args.lines else function
+
+    folded = collections.Counter()
+    self_samples = collections.Counter()
+    for pc, caller in samples:
+        stack = [frame(caller)] if caller else []
+        stack.append(frame(pc))
+        folded[";".join(stack)] += 1
+        self_samples[names[pc][0]] += 1
+
+    for stack, count in sorted(folded.items()):
+        print("%s %d" % (stack, count))
+
+    sys.stderr.write("%d samples at %d Hz (%d taken, %.1f s)\n" %
+                     (len(samples), rate_hz, total, total / float(rate_hz or 1)))
+    for function, count in self_samples.most_common(args.top):
+        sys.stderr.write("%6.1f%%  %6d  %s\n" % (100.0 * count / len(samples), count, function))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""
+Hammer the feeder's web API and check that feeding keeps its timing.
+
+Runs a number of client threads against one or more endpoints for a while,
+optionally starts a feeding over the serial port in the middle of the run,
+and compares the feed latency statistics (/api/metrics) and loop stalls
+(/api/stalls) from before and after. Admission control answers abusive
+clients with 429/503, so the motor should start and finish the probe
+feeding within the firmware's own alert limits.
+
+Usage:
+  tools/web_load.py http://192.168.1.50 --path /api/status --clients 4 --duration 30
+  tools/web_load.py http://192.168.1.50 --path /api/status --path /api/feed?portions=1 \\
+      --port /dev/ttyUSB0 --feed-at 10 --duration 30
+
+All threads share this machine's address, so they count as one client to
+the per-client buckets; run it from several machines to load the global
+handler time budget instead. Needs pyserial for --port.
+"""
+
+import argparse
+import collections
+import json
+import sys
+import threading
+import time
+import urllib.error
+import urllib.request
+
+
+def request(url, timeout):
+    """(status, retry-after seconds or None) of one GET; status 0 if it failed."""
+    try:
+        with urllib.request.urlopen(url, timeout=timeout) as response:
+            response.read()
+            return response.status, None
+    except urllib.error.HTTPError as error:
+        error.read()
+        retry = error.headers.get("Retry-After")
+        return error.code, int(retry) if retry and retry.isdigit() else None
+    except (urllib.error.URLError, OSError):
+        return 0, None
+
+
+def fetch_json(base_url, path, timeout=10.0, attempts=10):
+    """GET a JSON endpoint, waiting out 429/503 answers."""
+    for _ in range(attempts):
+        try:
+            with urllib.request.urlopen(base_url + path, timeout=timeout) as response:
+                return json.loads(response.read().decode("utf-8"))
+        except urllib.error.HTTPError as error:
+            if error.code not in (429, 503):
+                raise
+            retry = error.headers.get("Retry-After")
+            time.sleep(int(retry) if retry and retry.isdigit() else 1)
+    sys.exit("error: %s kept answering 429/503" % path)
+
+
+class Stats(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.codes = collections.Counter()
+        self.latencies = []
+
+    def add(self, status, seconds):
+        with self.lock:
+            self.codes[status] += 1
+            self.latencies.append(seconds)
+
+
+def client(base_url, paths, stop, stats, interval, timeout):
+    index = 0
+    while not stop.is_set():
+        started = time.monotonic()
+        status, _ = request(base_url + paths[index % len(paths)], timeout)
+        stats.add(status, time.monotonic() - started)
+        index += 1
+        if interval > 0:
+            stop.wait(max(0.0, interval - (time.monotonic() - started)))
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * fraction))] if ordered else 0.0
+
+
+def print_feed_latency(before, after):
+    """Latency of the feedings made during the run, per source; True if any alerted."""
+    alerted = False
+    sources_before = before["feedLatency"]["sources"]
+    for source, stages in after["feedLatency"]["sources"].items():
+        for stage in ("firstStep", "complete"):
+            now, then = stages[stage], sources_before[source][stage]
+            count = now["count"] - then["count"]
+            if count <= 0:
+                continue
+            new_alerts = now["alerts"] - then["alerts"]
+            alerted = alerted or new_alerts > 0
+            print("  %-8s %-9s %d feeding(s), last %d ms, max %d ms, %d over the limit"
+                  % (source, stage, count, now["lastMs"], now["maxMs"], new_alerts))
+    return alerted
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("url", help="feeder base URL, e.g. http://192.168.1.50")
+    parser.add_argument("--path", action="append", help="endpoint to load (repeatable, default /api/status)")
+    parser.add_argument("--clients", type=int, default=4, help="concurrent client threads")
+    parser.add_argument("--duration", type=float, default=30.0, help="run time in seconds")
+    parser.add_argument("--interval", type=float, default=0.0, help="seconds between requests per thread (0 = flat out)")
+    parser.add_argument("--timeout", type=float, default=5.0, help="request timeout in seconds")
+    parser.add_argument("--port", help="serial port for the probe feeding (FEED 1)")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate")
+    parser.add_argument("--feed-at", type=float, help="seconds into the run to send FEED 1 over --port")
+    args = parser.parse_args()
+
+    base_url = args.url.rstrip("/")
+    paths = args.path or ["/api/status"]
+    if args.feed_at is not None and not args.port:
+        sys.exit("error: --feed-at needs --port")
+
+    port = None
+    if args.port:
+        import serial
+        # Keep DTR/RTS released, toggling them resets most ESP32 boards
+        port = serial.Serial()
+        port.port = args.port
+        port.baudrate = args.baud
+        port.dtr = False
+        port.rts = False
+        port.open()
+
+    metrics_before = fetch_json(base_url, "/api/metrics")
+    stalls_before = fetch_json(base_url, "/api/stalls")
+
+    stats = Stats()
+    stop = threading.Event()
+    threads = [threading.Thread(target=client, args=(base_url, paths, stop, stats, args.interval, args.timeout))
+               for _ in range(args.clients)]
+    print("Loading %s with %d client(s) for %g s: %s" % (base_url, args.clients, args.duration, ", ".join(paths)))
+    started = time.monotonic()
+    for thread in threads:
+        thread.start()
+    try:
+        if args.feed_at is not None:
+            stop.wait(args.feed_at)
+            port.write(b"FEED 1\n")
+            port.flush()
+            print("  %6.1f s  FEED 1 sent over %s" % (time.monotonic() - started, args.port))
+        stop.wait(max(0.0, args.duration - (time.monotonic() - started)))
+    finally:
+        stop.set()
+        for thread in threads:
+            thread.join()
+        if port:
+            port.close()
+    elapsed = time.monotonic() - started
+
+    total = sum(stats.codes.values())
+    print("Requests: %d in %.1f s (%.1f/s)" % (total, elapsed, total / elapsed if elapsed else 0.0))
+    for status, count in sorted(stats.codes.items()):
+        print("  %s: %d" % (status if status else "failed", count))
+    print("Response time: median %.0f ms, p95 %.0f ms, max %.0f ms"
+          % (percentile(stats.latencies, 0.5) * 1000, percentile(stats.latencies, 0.95) * 1000,
+             max(stats.latencies or [0.0]) * 1000))
+
+    # Let the probe feeding finish before reading the statistics
+    metrics_after = fetch_json(base_url, "/api/metrics")
+    completed = metrics_before["feedLatency"]["sources"]["serial"]["complete"]["count"]
+    deadline = time.monotonic() + 60
+    while (args.feed_at is not None and time.monotonic() < deadline and
+           metrics_after["feedLatency"]["sources"]["serial"]["complete"]["count"] == completed):
+        time.sleep(2)
+        metrics_after = fetch_json(base_url, "/api/metrics")
+    stalls_after = fetch_json(base_url, "/api/stalls")
+
+    print("Feed latency during the run:")
+    alerted = print_feed_latency(metrics_before, metrics_after)
+    new_stalls = stalls_after["stalls"] - stalls_before["stalls"]
+    print("Loop stalls during the run: %d (budget %d ms, worst pass since reset %d ms)"
+          % (new_stalls, stalls_after["budgetMs"], stalls_after["worstPassMs"]))
+    for stall in stalls_after["recent"][:min(new_stalls, len(stalls_after["recent"]))]:
+        print("  %d ms in %s %s / %s" % (stall["passMs"], stall["callback"], stall["detail"] or "", stall["blocking"]))
+
+    if alerted:
+        sys.exit("FAIL: feed latency over the firmware's alert limit under load")
+    print("OK")
+
+
+if __name__ == "__main__":
+    main()